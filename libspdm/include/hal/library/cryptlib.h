@@ -1707,6 +1707,129 @@ aead_aes_gcm_decrypt (
   OUT  uintn        *data_out_size
   );
 
+/**
+  Allocates and initializes one AES-GCM context for subsequent use.
+
+  The context holds the expanded key, so that the key schedule is done once by aead_aes_gcm_set_key(),
+  instead of once per message.
+
+  @return  Pointer to the AES-GCM context that has been initialized.
+           If the allocations fails, aead_aes_gcm_new() returns NULL.
+
+**/
+void *
+aead_aes_gcm_new (
+  void
+  );
+
+/**
+  Release the specified AES-GCM context.
+
+  @param[in]  aead_context  Pointer to the AES-GCM context to be released.
+
+**/
+void
+aead_aes_gcm_free (
+  IN  void  *aead_context
+  );
+
+/**
+  Set the key of the AES-GCM context for subsequent use.
+
+  key_size must be 16, 24 or 32, otherwise FALSE is returned.
+
+  @param[in, out]  aead_context  Pointer to the AES-GCM context.
+  @param[in]       key           Pointer to the encryption key.
+  @param[in]       key_size       size of the encryption key in bytes.
+
+  @retval TRUE   The key is set successfully.
+  @retval FALSE  The key is set unsuccessfully.
+
+**/
+boolean
+aead_aes_gcm_set_key (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *key,
+  IN      uintn        key_size
+  );
+
+/**
+  Performs AEAD AES-GCM authenticated encryption on a data buffer and additional authenticated data (AAD),
+  with the key in the AES-GCM context.
+
+  iv_size must be 12, otherwise FALSE is returned.
+  tag_size must be 12, 13, 14, 15, 16, otherwise FALSE is returned.
+
+  @param[in, out]  aead_context  Pointer to the AES-GCM context with the key set.
+  @param[in]   iv          Pointer to the IV value.
+  @param[in]   iv_size      size of the IV value in bytes.
+  @param[in]   a_data       Pointer to the additional authenticated data (AAD).
+  @param[in]   a_data_size   size of the additional authenticated data (AAD) in bytes.
+  @param[in]   data_in      Pointer to the input data buffer to be encrypted.
+  @param[in]   data_in_size  size of the input data buffer in bytes.
+  @param[out]  tag_out      Pointer to a buffer that receives the authentication tag output.
+  @param[in]   tag_size     size of the authentication tag in bytes.
+  @param[out]  data_out     Pointer to a buffer that receives the encryption output.
+  @param[out]  data_out_size size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD AES-GCM authenticated encryption succeeded.
+  @retval FALSE  AEAD AES-GCM authenticated encryption failed.
+
+**/
+boolean
+aead_aes_gcm_encrypt_with_context (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *iv,
+  IN      uintn        iv_size,
+  IN      const uint8  *a_data,
+  IN      uintn        a_data_size,
+  IN      const uint8  *data_in,
+  IN      uintn        data_in_size,
+  OUT     uint8        *tag_out,
+  IN      uintn        tag_size,
+  OUT     uint8        *data_out,
+  OUT     uintn        *data_out_size
+  );
+
+/**
+  Performs AEAD AES-GCM authenticated decryption on a data buffer and additional authenticated data (AAD),
+  with the key in the AES-GCM context.
+
+  iv_size must be 12, otherwise FALSE is returned.
+  tag_size must be 12, 13, 14, 15, 16, otherwise FALSE is returned.
+  If additional authenticated data verification fails, FALSE is returned.
+
+  @param[in, out]  aead_context  Pointer to the AES-GCM context with the key set.
+  @param[in]   iv          Pointer to the IV value.
+  @param[in]   iv_size      size of the IV value in bytes.
+  @param[in]   a_data       Pointer to the additional authenticated data (AAD).
+  @param[in]   a_data_size   size of the additional authenticated data (AAD) in bytes.
+  @param[in]   data_in      Pointer to the input data buffer to be decrypted.
+  @param[in]   data_in_size  size of the input data buffer in bytes.
+  @param[in]   tag         Pointer to a buffer that contains the authentication tag.
+  @param[in]   tag_size     size of the authentication tag in bytes.
+  @param[out]  data_out     Pointer to a buffer that receives the decryption output.
+  @param[out]  data_out_size size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD AES-GCM authenticated decryption succeeded.
+  @retval FALSE  AEAD AES-GCM authenticated decryption failed.
+
+**/
+boolean
+aead_aes_gcm_decrypt_with_context (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *iv,
+  IN      uintn        iv_size,
+  IN      const uint8  *a_data,
+  IN      uintn        a_data_size,
+  IN      const uint8  *data_in,
+  IN      uintn        data_in_size,
+  IN      const uint8  *tag,
+  IN      uintn        tag_size,
+  OUT     uint8        *data_out,
+  OUT     uintn        *data_out_size
+  );
+
 /**
   Performs AEAD ChaCha20Poly1305 authenticated encryption on a data buffer and additional authenticated data (AAD).
 
@@ -2806,6 +2929,46 @@ x509_compare_date_time (
   IN    void   *date_time2
   );
 
+/**
+  Check whether the current time is within the validity period of a certificate.
+
+  The current time is checked the same way as x509_verify_cert checks it, so that
+  a cached verification result expires together with the certificate.
+  If x509_verify_cert does not check the time, then return TRUE.
+
+  @param[in]      from         notBefore Pointer to date_time object.
+  @param[in]      to           notAfter Pointer to date_time object.
+
+  @retval  TRUE   The current time is within the validity period, or the time is not checked.
+  @retval  FALSE  The certificate is expired or not yet valid.
+**/
+boolean
+x509_check_current_date_time (
+  IN    void   *from,
+  IN    void   *to
+  );
+
+/**
+  Copy a date_time object.
+
+  A date_time object may point into its own buffer, so it is copied with this function instead of copy_mem.
+
+  @param[in]      date_time           Pointer to the date_time object.
+  @param[in]      date_time_size      date_time object size.
+  @param[out]     new_date_time       Pointer to the buffer of the copy.
+  @param[in,out]  new_date_time_size  On input, the size of the buffer. On output, the date_time object size.
+
+  @retval  TRUE   The date_time object is copied.
+  @retval  FALSE  The buffer is too small.
+**/
+boolean
+x509_copy_date_time (
+  IN     void   *date_time,
+  IN     uintn  date_time_size,
+     OUT void   *new_date_time,
+  IN OUT uintn  *new_date_time_size
+  );
+
 /**
   Retrieve the key usage from one X.509 certificate.
 
@@ -78,6 +78,28 @@ zero_mem (
   IN uintn  length
   );
 
+/**
+  Fills a target buffer with zeros, and returns the target buffer.
+
+  Unlike zero_mem(), the stores are guaranteed not to be removed by the compiler,
+  even if the buffer is not accessed afterwards.
+  It must be used to clear secret data, such as keys and shared secrets.
+
+  If length > 0 and buffer is NULL, then ASSERT().
+  If length is greater than (MAX_ADDRESS - buffer + 1), then ASSERT().
+
+  @param  buffer      The pointer to the target buffer to fill with zeros.
+  @param  length      The number of bytes in buffer to fill with zeros.
+
+  @return buffer.
+
+**/
+void *
+secure_zero_mem (
+  OUT void  *buffer,
+  IN uintn  length
+  );
+
 /**
   Compares the contents of two buffers.
 
@@ -107,4 +129,31 @@ compare_mem (
   IN uintn       length
   );
 
+/**
+  Compares the contents of two buffers in constant time.
+
+  This function compares length bytes of source_buffer to length bytes of destination_buffer.
+  The execution time only depends on length, not on the contents of the buffers.
+  It must be used to compare secret data, such as HMAC or verify data.
+
+  If length > 0 and destination_buffer is NULL, then ASSERT().
+  If length > 0 and source_buffer is NULL, then ASSERT().
+  If length is greater than (MAX_ADDRESS - destination_buffer + 1), then ASSERT().
+  If length is greater than (MAX_ADDRESS - source_buffer + 1), then ASSERT().
+
+  @param  destination_buffer The pointer to the destination buffer to compare.
+  @param  source_buffer      The pointer to the source buffer to compare.
+  @param  length            The number of bytes to compare.
+
+  @return 0                 All length bytes of the two buffers are identical.
+  @retval 1                 The two buffers are different.
+
+**/
+intn
+const_compare_mem (
+  IN const void  *destination_buffer,
+  IN const void  *source_buffer,
+  IN uintn       length
+  );
+
 #endif
@@ -66,6 +66,12 @@ typedef enum {
   SPDM_DATA_CAPABILITY_FLAGS,
   SPDM_DATA_CAPABILITY_CT_EXPONENT,
   //
+  // The size in bytes of the largest SPDM message sent or received by the local device in one transfer.
+  // The default size is MAX_SPDM_FRAGMENT_LENGTH.
+  // The certificate chain is moved in portions which fit in it, up to MAX_SPDM_CERT_CHAIN_BLOCK_LEN.
+  //
+  SPDM_DATA_CAPABILITY_DATA_TRANSFER_SIZE,
+  //
   // SPDM algorithm setting
   //
   SPDM_DATA_MEASUREMENT_SPEC,
@@ -125,6 +131,69 @@ typedef enum {
   SPDM_DATA_PQC_LOCAL_USED_PUBLIC_KEY,
   SPDM_DATA_PQC_PEER_USED_PUBLIC_KEY,
 
+  //
+  // Ephemeral key pool for KEY_EXCHANGE (requester only)
+  // The pool is disabled if the depth is 0.
+  // Every key in the pool is used once only.
+  //
+  SPDM_DATA_KEY_POOL_DEPTH,
+  SPDM_DATA_KEY_POOL_LOW_WATERMARK,
+  SPDM_DATA_KEY_POOL_HIGH_WATERMARK,
+
+  //
+  // Worker threads to run independent crypto operations in parallel,
+  // such as the classical and the PQC half of a signature.
+  // The crypto operations are run one after another if the count is 0.
+  //
+  SPDM_DATA_WORKER_THREAD_COUNT,
+
+  //
+  // The limit in bytes of the memory allocated for the large buffers of the context,
+  // such as the transcripts and the certificate chain. There is no limit if it is 0.
+  // The large buffers are allocated on demand, and they are released after use.
+  //
+  SPDM_DATA_ARENA_MAX_SIZE,
+
+  //
+  // The count of sessions in the session table. The default count is MAX_SPDM_SESSION_COUNT.
+  // It can be set only if no session is in use.
+  //
+  SPDM_DATA_MAX_SESSION_COUNT,
+
+  //
+  // Defer the expensive requests, such as CHALLENGE, signed GET_MEASUREMENTS and KEY_EXCHANGE,
+  // to the worker pool (responder only). The responder returns ResponseNotReady at once,
+  // and it returns the response to RESPOND_IF_READY after the job is done.
+  // It requires a non-zero SPDM_DATA_WORKER_THREAD_COUNT.
+  //
+  SPDM_DATA_DEFERRED_RESPONSE,
+
+  //
+  // Cache the measurement blocks and the measurement summary hashes (responder only).
+  // The cache is valid until SPDM_DATA_MEASUREMENT_GENERATION is changed.
+  //
+  SPDM_DATA_MEASUREMENT_CACHE,
+
+  //
+  // The generation of the device measurement. The platform changes it once the measurement
+  // is changed, such as a firmware update, so that the measurement cache is not used.
+  //
+  SPDM_DATA_MEASUREMENT_GENERATION,
+
+  //
+  // Cache the peer certificate chains verified by GET_CERTIFICATE (requester only).
+  // GET_CERTIFICATE returns the cached certificate chain without any message
+  // if GET_DIGESTS returns the digest of it in the same connection.
+  //
+  SPDM_DATA_PEER_CERT_CHAIN_CACHE,
+
+  //
+  // The count of fragments sent in FRAGMENT_REQUEST before the ACK, up to MAX_SPDM_FRAGMENT_WINDOW_SIZE.
+  // The requester proposes it in the BEGIN fragment, and the responder accepts the smaller one of both.
+  // 0 or 1 means the ACK of every fragment. It requires a transport that keeps the order of the messages.
+  //
+  SPDM_DATA_FRAGMENT_WINDOW_SIZE,
+
   //
   // MAX
   //
@@ -315,6 +384,18 @@ spdm_init_context (
   IN     void                      *spdm_context
   );
 
+/**
+  Free the resources held by an SPDM context.
+
+  It must be called before the memory of the spdm_context is freed.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+*/
+void
+spdm_deinit_context (
+  IN     void                      *spdm_context
+  );
+
 /**
   Return the size in bytes of the SPDM context.
 
@@ -774,15 +855,28 @@ spdm_free_session_id (
   IN     uint32                    session_id
   );
 
+#define MAX_SPDM_TH_SEGMENT_COUNT  5
+
+//
+// TH data, as segments referring to A, hash(Ct), K, hash(CM) and F.
+//
+typedef struct {
+  uintn                  segment_count;
+  spdm_data_segment_t    segment[MAX_SPDM_TH_SEGMENT_COUNT];
+  uint8                  cert_chain_hash[MAX_HASH_SIZE];
+  uint8                  mut_cert_chain_hash[MAX_HASH_SIZE];
+} spdm_th_segments_t;
+
 /*
   This function calculates current TH data with message A and message K.
 
+  The TH data is returned as segments which refer to the transcript, instead of being copied into one buffer.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  session_info                  The SPDM session ID.
   @param  cert_chain_data                Certitiface chain data without spdm_cert_chain_t header.
   @param  cert_chain_data_size            size in bytes of the certitiface chain data.
-  @param  th_data_buffer_size             size in bytes of the th_data_buffer
-  @param  th_data_buffer                 The buffer to store the th_data_buffer
+  @param  th_curr                       The segments of the TH data.
 
   @retval RETURN_SUCCESS  current TH data is calculated.
 */
@@ -792,21 +886,21 @@ spdm_calculate_th_for_exchange (
   IN     void                      *spdm_session_info,
   IN     uint8                     *cert_chain_data, OPTIONAL
   IN     uintn                     cert_chain_data_size, OPTIONAL
-  IN OUT uintn                     *th_data_buffer_size,
-     OUT void                      *th_data_buffer
+     OUT spdm_th_segments_t        *th_curr
   );
 
 /*
   This function calculates current TH data with message A, message K and message F.
 
+  The TH data is returned as segments which refer to the transcript, instead of being copied into one buffer.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  session_info                  The SPDM session ID.
   @param  cert_chain_data                Certitiface chain data without spdm_cert_chain_t header.
   @param  cert_chain_data_size            size in bytes of the certitiface chain data.
   @param  mut_cert_chain_data             Certitiface chain data without spdm_cert_chain_t header in mutual authentication.
   @param  mut_cert_chain_data_size         size in bytes of the certitiface chain data in mutual authentication.
-  @param  th_data_buffer_size             size in bytes of the th_data_buffer
-  @param  th_data_buffer                 The buffer to store the th_data_buffer
+  @param  th_curr                       The segments of the TH data.
 
   @retval RETURN_SUCCESS  current TH data is calculated.
 */
@@ -818,8 +912,55 @@ spdm_calculate_th_for_finish (
   IN     uintn                     cert_chain_data_size, OPTIONAL
   IN     uint8                     *mut_cert_chain_data, OPTIONAL
   IN     uintn                     mut_cert_chain_data_size, OPTIONAL
-  IN OUT uintn                     *th_data_buffer_size,
-     OUT void                      *th_data_buffer
+     OUT spdm_th_segments_t        *th_curr
+  );
+
+/*
+  This function calculates current TH hash with message A and message K.
+
+  The running hash of the session transcript only absorbs the data appended since the last TH checkpoint.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The SPDM session ID.
+  @param  cert_chain_data                Certitiface chain data without spdm_cert_chain_t header.
+  @param  cert_chain_data_size            size in bytes of the certitiface chain data.
+  @param  th_hash                       The buffer to store the TH hash
+
+  @retval TRUE  current TH hash is calculated.
+*/
+boolean
+spdm_calculate_th_hash_for_exchange (
+  IN     void                      *spdm_context,
+  IN     void                      *spdm_session_info,
+  IN     uint8                     *cert_chain_data, OPTIONAL
+  IN     uintn                     cert_chain_data_size, OPTIONAL
+     OUT uint8                     *th_hash
+  );
+
+/*
+  This function calculates current TH hash with message A, message K and message F.
+
+  The running hash of the session transcript only absorbs the data appended since the last TH checkpoint.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The SPDM session ID.
+  @param  cert_chain_data                Certitiface chain data without spdm_cert_chain_t header.
+  @param  cert_chain_data_size            size in bytes of the certitiface chain data.
+  @param  mut_cert_chain_data             Certitiface chain data without spdm_cert_chain_t header in mutual authentication.
+  @param  mut_cert_chain_data_size         size in bytes of the certitiface chain data in mutual authentication.
+  @param  th_hash                       The buffer to store the TH hash
+
+  @retval TRUE  current TH hash is calculated.
+*/
+boolean
+spdm_calculate_th_hash_for_finish (
+  IN     void                      *spdm_context,
+  IN     void                      *spdm_session_info,
+  IN     uint8                     *cert_chain_data, OPTIONAL
+  IN     uintn                     cert_chain_data_size, OPTIONAL
+  IN     uint8                     *mut_cert_chain_data, OPTIONAL
+  IN     uintn                     mut_cert_chain_data_size, OPTIONAL
+     OUT uint8                     *th_hash
   );
 
 /*
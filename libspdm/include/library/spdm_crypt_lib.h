@@ -23,6 +23,51 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MAX_HASH_SIZE       64
 #define MAX_AEAD_KEY_SIZE   32
 #define MAX_AEAD_IV_SIZE    12
+#define MAX_HASH_CONTEXT_SIZE  0x100
+
+//
+// One piece of a message which is processed as the concatenation of all pieces.
+//
+typedef struct {
+  const void  *data;
+  uintn       size;
+} spdm_data_segment_t;
+
+//
+// One output of a HKDF expand batch. All items of a batch share the same PRK.
+//
+typedef struct {
+  const uint8  *info;
+  uintn        info_size;
+  uint8        *out;
+  uintn        out_size;
+} spdm_hkdf_expand_item_t;
+
+//
+// The state of a certificate chain verification which proceeds while the chain is being received.
+// The offsets are relative to the certificate chain buffer including spdm_cert_chain_t header,
+// because the buffer may be moved when it grows.
+//
+typedef struct {
+  uint32       bash_hash_algo;
+  uintn        cert_count;
+  uintn        next_cert_offset;
+  uintn        last_cert_offset;
+  uintn        last_cert_size;
+} spdm_cert_chain_verify_context_t;
+
+//
+// One link of a certificate chain. The certificate is signed by the issuer certificate.
+// The root certificate is its own issuer.
+// bash_hash_algo is used to identify the link in the verified certificate link cache.
+//
+typedef struct {
+  uint32       bash_hash_algo;
+  const uint8  *cert;
+  uintn        cert_size;
+  const uint8  *issuer_cert;
+  uintn        issuer_cert_size;
+} spdm_cert_chain_link_t;
 
 /**
   Computes the hash of a input data buffer.
@@ -44,6 +89,70 @@ boolean
   OUT  uint8       *hash_value
   );
 
+/**
+  Initializes user-supplied memory as hash context for subsequent use.
+
+  @param  hash_context                  Pointer to hash context being initialized.
+
+  @retval TRUE   hash context initialization succeeded.
+  @retval FALSE  hash context initialization failed.
+**/
+typedef
+boolean
+(*hash_init_func) (
+  OUT  void  *hash_context
+  );
+
+/**
+  Makes a copy of an existing hash context.
+
+  @param  hash_context                  Pointer to hash context being copied.
+  @param  new_hash_context              Pointer to new hash context.
+
+  @retval TRUE   hash context copy succeeded.
+  @retval FALSE  hash context copy failed.
+**/
+typedef
+boolean
+(*hash_duplicate_func) (
+  IN   const void  *hash_context,
+  OUT  void        *new_hash_context
+  );
+
+/**
+  Digests the input data and updates hash context.
+
+  @param  hash_context                  Pointer to the hash context.
+  @param  data                         Pointer to the buffer containing the data to be hashed.
+  @param  data_size                     size of data buffer in bytes.
+
+  @retval TRUE   hash data digest succeeded.
+  @retval FALSE  hash data digest failed.
+**/
+typedef
+boolean
+(*hash_update_func) (
+  IN OUT  void        *hash_context,
+  IN      const void  *data,
+  IN      uintn       data_size
+  );
+
+/**
+  Completes computation of the hash digest value.
+
+  @param  hash_context                  Pointer to the hash context.
+  @param  hash_value                    Pointer to a buffer that receives the hash value.
+
+  @retval TRUE   hash digest computation succeeded.
+  @retval FALSE  hash digest computation failed.
+**/
+typedef
+boolean
+(*hash_final_func) (
+  IN OUT  void   *hash_context,
+  OUT     uint8  *hash_value
+  );
+
 /**
   Computes the HMAC of a input data buffer.
 
@@ -68,6 +177,98 @@ boolean
   OUT  uint8        *hmac_value
   );
 
+/**
+  Allocates and initializes one HMAC context for subsequent use.
+
+  @return  Pointer to the HMAC context that has been initialized.
+           If the allocations fails, hmac_new() returns NULL.
+**/
+typedef
+void *
+(*hmac_new_func) (
+  void
+  );
+
+/**
+  Release the specified HMAC context.
+
+  @param  hmac_ctx                   Pointer to the HMAC context to be released.
+**/
+typedef
+void
+(*hmac_free_func) (
+  IN  void  *hmac_ctx
+  );
+
+/**
+  Set user-supplied key for subsequent use. It must be done before any
+  calling to hmac_update().
+
+  @param  hmac_ctx                    Pointer to HMAC context.
+  @param  key                        Pointer to the user-supplied key.
+  @param  key_size                    key size in bytes.
+
+  @retval TRUE   The key is set successfully.
+  @retval FALSE  The key is set unsuccessfully.
+**/
+typedef
+boolean
+(*hmac_set_key_func) (
+  OUT  void         *hmac_ctx,
+  IN   const uint8  *key,
+  IN   uintn        key_size
+  );
+
+/**
+  Makes a copy of an existing HMAC context.
+
+  @param  hmac_ctx                    Pointer to HMAC context being copied.
+  @param  new_hmac_ctx                Pointer to new HMAC context.
+
+  @retval TRUE   HMAC context copy succeeded.
+  @retval FALSE  HMAC context copy failed.
+**/
+typedef
+boolean
+(*hmac_duplicate_func) (
+  IN   const void  *hmac_ctx,
+  OUT  void        *new_hmac_ctx
+  );
+
+/**
+  Digests the input data and updates HMAC context.
+
+  @param  hmac_ctx                    Pointer to the HMAC context.
+  @param  data                       Pointer to the buffer containing the data to be digested.
+  @param  data_size                   size of data buffer in bytes.
+
+  @retval TRUE   HMAC data digest succeeded.
+  @retval FALSE  HMAC data digest failed.
+**/
+typedef
+boolean
+(*hmac_update_func) (
+  IN OUT  void        *hmac_ctx,
+  IN      const void  *data,
+  IN      uintn       data_size
+  );
+
+/**
+  Completes computation of the HMAC digest value.
+
+  @param  hmac_ctx                    Pointer to the HMAC context.
+  @param  hmac_value                  Pointer to a buffer that receives the HMAC digest value.
+
+  @retval TRUE   HMAC digest computation succeeded.
+  @retval FALSE  HMAC digest computation failed.
+**/
+typedef
+boolean
+(*hmac_final_func) (
+  IN OUT  void   *hmac_ctx,
+  OUT     uint8  *hmac_value
+  );
+
 /**
   Derive HMAC-based Expand key Derivation Function (HKDF) Expand.
 
@@ -377,6 +578,99 @@ spdm_hash_all (
   OUT  uint8                        *hash_value
   );
 
+/**
+  Initializes user-supplied memory as hash context, based upon the negotiated hash algorithm.
+
+  The hash_context buffer must be at least MAX_HASH_CONTEXT_SIZE bytes.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hash_context                  Pointer to hash context being initialized.
+
+  @retval TRUE   hash context initialization succeeded.
+  @retval FALSE  hash context initialization failed.
+**/
+boolean
+spdm_hash_init (
+  IN   uint32                       bash_hash_algo,
+  OUT  void                         *hash_context
+  );
+
+/**
+  Makes a copy of an existing hash context, based upon the negotiated hash algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hash_context                  Pointer to hash context being copied.
+  @param  new_hash_context              Pointer to new hash context.
+
+  @retval TRUE   hash context copy succeeded.
+  @retval FALSE  hash context copy failed.
+**/
+boolean
+spdm_hash_duplicate (
+  IN   uint32                       bash_hash_algo,
+  IN   const void                   *hash_context,
+  OUT  void                         *new_hash_context
+  );
+
+/**
+  Digests the input data and updates hash context, based upon the negotiated hash algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hash_context                  Pointer to the hash context.
+  @param  data                         Pointer to the buffer containing the data to be hashed.
+  @param  data_size                     size of data buffer in bytes.
+
+  @retval TRUE   hash data digest succeeded.
+  @retval FALSE  hash data digest failed.
+**/
+boolean
+spdm_hash_update (
+  IN      uint32                       bash_hash_algo,
+  IN OUT  void                         *hash_context,
+  IN      const void                   *data,
+  IN      uintn                        data_size
+  );
+
+/**
+  Completes computation of the hash digest value, based upon the negotiated hash algorithm.
+
+  After this function has been called, the hash context cannot be used again.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hash_context                  Pointer to the hash context.
+  @param  hash_value                    Pointer to a buffer that receives the hash value.
+
+  @retval TRUE   hash digest computation succeeded.
+  @retval FALSE  hash digest computation failed.
+**/
+boolean
+spdm_hash_final (
+  IN      uint32                       bash_hash_algo,
+  IN OUT  void                         *hash_context,
+  OUT     uint8                        *hash_value
+  );
+
+/**
+  Computes the hash of a message given as a list of segments, based upon the negotiated hash algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  segment                       Pointer to the segments of the data to be hashed.
+  @param  segment_count                  number of segments.
+  @param  hash_value                    Pointer to a buffer that receives the hash value.
+
+  @retval TRUE   hash computation succeeded.
+  @retval FALSE  hash computation failed.
+**/
+boolean
+spdm_hash_all_segments (
+  IN   uint32                       bash_hash_algo,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  OUT  uint8                        *hash_value
+  );
+
 /**
   This function returns the SPDM measurement hash algorithm size.
 
@@ -436,6 +730,128 @@ spdm_hmac_all (
   OUT  uint8                        *hmac_value
   );
 
+/**
+  Allocates and initializes one HMAC context, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+
+  @return  Pointer to the HMAC context that has been initialized.
+           If the allocations fails, spdm_hmac_new() returns NULL.
+**/
+void *
+spdm_hmac_new (
+  IN   uint32                       bash_hash_algo
+  );
+
+/**
+  Release the specified HMAC context, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to the HMAC context to be released.
+**/
+void
+spdm_hmac_free (
+  IN   uint32                       bash_hash_algo,
+  IN   void                         *hmac_ctx
+  );
+
+/**
+  Set user-supplied key for subsequent use, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to HMAC context.
+  @param  key                          Pointer to the user-supplied key.
+  @param  key_size                      key size in bytes.
+
+  @retval TRUE   The key is set successfully.
+  @retval FALSE  The key is set unsuccessfully.
+**/
+boolean
+spdm_hmac_set_key (
+  IN   uint32                       bash_hash_algo,
+  OUT  void                         *hmac_ctx,
+  IN   const uint8                  *key,
+  IN   uintn                        key_size
+  );
+
+/**
+  Makes a copy of an existing HMAC context, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to HMAC context being copied.
+  @param  new_hmac_ctx                  Pointer to new HMAC context.
+
+  @retval TRUE   HMAC context copy succeeded.
+  @retval FALSE  HMAC context copy failed.
+**/
+boolean
+spdm_hmac_duplicate (
+  IN   uint32                       bash_hash_algo,
+  IN   const void                   *hmac_ctx,
+  OUT  void                         *new_hmac_ctx
+  );
+
+/**
+  Digests the input data and updates HMAC context, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to the HMAC context.
+  @param  data                         Pointer to the buffer containing the data to be digested.
+  @param  data_size                     size of data buffer in bytes.
+
+  @retval TRUE   HMAC data digest succeeded.
+  @retval FALSE  HMAC data digest failed.
+**/
+boolean
+spdm_hmac_update (
+  IN      uint32                       bash_hash_algo,
+  IN OUT  void                         *hmac_ctx,
+  IN      const void                   *data,
+  IN      uintn                        data_size
+  );
+
+/**
+  Completes computation of the HMAC digest value, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to the HMAC context.
+  @param  hmac_value                    Pointer to a buffer that receives the HMAC digest value.
+
+  @retval TRUE   HMAC digest computation succeeded.
+  @retval FALSE  HMAC digest computation failed.
+**/
+boolean
+spdm_hmac_final (
+  IN      uint32                       bash_hash_algo,
+  IN OUT  void                         *hmac_ctx,
+  OUT     uint8                        *hmac_value
+  );
+
+/**
+  Computes the HMAC of a message given as a list of segments, based upon the negotiated HMAC algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  segment                       Pointer to the segments of the data to be HMACed.
+  @param  segment_count                  number of segments.
+  @param  key                          Pointer to the user-supplied key.
+  @param  key_size                      key size in bytes.
+  @param  hmac_value                    Pointer to a buffer that receives the HMAC value.
+
+  @retval TRUE   HMAC computation succeeded.
+  @retval FALSE  HMAC computation failed.
+**/
+boolean
+spdm_hmac_all_segments (
+  IN   uint32                       bash_hash_algo,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  IN   const uint8                  *key,
+  IN   uintn                        key_size,
+  OUT  uint8                        *hmac_value
+  );
+
 /**
   Derive HMAC-based Expand key Derivation Function (HKDF) Expand, based upon the negotiated HKDF algorithm.
 
@@ -461,6 +877,31 @@ spdm_hkdf_expand (
   IN   uintn                        out_size
   );
 
+/**
+  Derive a batch of HMAC-based Expand key Derivation Function (HKDF) Expand outputs from one PRK,
+  based upon the negotiated HKDF algorithm.
+
+  One HMAC context is keyed with the PRK once, and each HMAC block of each output starts from a copy of it.
+  The result is the same as calling spdm_hkdf_expand for each item.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  prk                          Pointer to the user-supplied key.
+  @param  prk_size                      key size in bytes.
+  @param  item                         Pointer to the info and output buffer of each output.
+  @param  item_count                    number of items.
+
+  @retval TRUE   Hkdf generated successfully.
+  @retval FALSE  Hkdf generation failed.
+**/
+boolean
+spdm_hkdf_expand_batch (
+  IN   uint32                       bash_hash_algo,
+  IN   const uint8                  *prk,
+  IN   uintn                        prk_size,
+  IN   const spdm_hkdf_expand_item_t *item,
+  IN   uintn                        item_count
+  );
+
 /**
   This function returns the SPDM asymmetric algorithm size.
 
@@ -533,6 +974,34 @@ spdm_asym_verify (
   IN   uintn                        sig_size
   );
 
+/**
+  Verifies the asymmetric signature of a message given as a list of segments,
+  based upon negotiated asymmetric algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  base_asym_algo                 SPDM base_asym_algo
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  context                      Pointer to asymmetric context for signature verification.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to asymmetric signature to be verified.
+  @param  sig_size                      size of signature in bytes.
+
+  @retval  TRUE   Valid asymmetric signature.
+  @retval  FALSE  Invalid asymmetric signature or invalid asymmetric context.
+**/
+boolean
+spdm_asym_verify_segments (
+  IN   uint32                       base_asym_algo,
+  IN   uint32                       bash_hash_algo,
+  IN   void                         *context,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  IN   const uint8                  *signature,
+  IN   uintn                        sig_size
+  );
+
 /**
   Retrieve the Private key from the password-protected PEM key data.
 
@@ -585,6 +1054,37 @@ spdm_asym_sign (
   IN OUT  uintn                        *sig_size
   );
 
+/**
+  Carries out the signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+  If the signature buffer is too small to hold the contents of signature, FALSE
+  is returned and sig_size is set to the required buffer size to obtain the signature.
+
+  @param  base_asym_algo                 SPDM base_asym_algo
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  context                      Pointer to asymmetric context for signature generation.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_asym_sign_segments (
+  IN      uint32                       base_asym_algo,
+  IN      uint32                       bash_hash_algo,
+  IN      void                         *context,
+  IN      const spdm_data_segment_t    *segment,
+  IN      uintn                        segment_count,
+  OUT     uint8                        *signature,
+  IN OUT  uintn                        *sig_size
+  );
+
 /**
   This function returns the SPDM requester asymmetric algorithm size.
 
@@ -657,6 +1157,34 @@ spdm_req_asym_verify (
   IN   uintn                        sig_size
   );
 
+/**
+  Verifies the asymmetric signature of a message given as a list of segments,
+  based upon negotiated requester asymmetric algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  req_base_asym_alg               SPDM req_base_asym_alg
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  context                      Pointer to asymmetric context for signature verification.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to asymmetric signature to be verified.
+  @param  sig_size                      size of signature in bytes.
+
+  @retval  TRUE   Valid asymmetric signature.
+  @retval  FALSE  Invalid asymmetric signature or invalid asymmetric context.
+**/
+boolean
+spdm_req_asym_verify_segments (
+  IN   uint16                       req_base_asym_alg,
+  IN   uint32                       bash_hash_algo,
+  IN   void                         *context,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  IN   const uint8                  *signature,
+  IN   uintn                        sig_size
+  );
+
 /**
   Retrieve the Private key from the password-protected PEM key data.
 
@@ -709,6 +1237,37 @@ spdm_req_asym_sign (
   IN OUT  uintn                        *sig_size
   );
 
+/**
+  Carries out the signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+  If the signature buffer is too small to hold the contents of signature, FALSE
+  is returned and sig_size is set to the required buffer size to obtain the signature.
+
+  @param  req_base_asym_alg               SPDM req_base_asym_alg
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  context                      Pointer to asymmetric context for signature generation.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_req_asym_sign_segments (
+  IN      uint16                       req_base_asym_alg,
+  IN      uint32                       bash_hash_algo,
+  IN      void                         *context,
+  IN      const spdm_data_segment_t    *segment,
+  IN      uintn                        segment_count,
+  OUT     uint8                        *signature,
+  IN OUT  uintn                        *sig_size
+  );
+
 /**
   This function returns the SPDM DHE algorithm key size.
 
@@ -927,6 +1486,125 @@ spdm_aead_decryption (
   OUT  uintn*                       data_out_size
   );
 
+/**
+  Allocates and initializes one AEAD context for subsequent use, based upon negotiated AEAD algorithm.
+
+  The AEAD context keeps the expanded key, so that the key schedule is not repeated for every message.
+  NULL is returned if the AEAD algorithm has no context support. The caller should use
+  spdm_aead_encryption and spdm_aead_decryption with the key instead.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+
+  @return  Pointer to the AEAD context that has been initialized.
+**/
+void *
+spdm_aead_new (
+  IN   uint16                       aead_cipher_suite
+  );
+
+/**
+  Release the AEAD context, based upon negotiated AEAD algorithm.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+  @param  aead_context                   Pointer to the AEAD context to be released.
+**/
+void
+spdm_aead_free (
+  IN   uint16                       aead_cipher_suite,
+  IN   void                         *aead_context
+  );
+
+/**
+  Set the key of the AEAD context, based upon negotiated AEAD algorithm.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+  @param  aead_context                   Pointer to the AEAD context.
+  @param  key                          Pointer to the encryption key.
+  @param  key_size                      size of the encryption key in bytes.
+
+  @retval TRUE   The key is set successfully.
+  @retval FALSE  The key is set unsuccessfully.
+**/
+boolean
+spdm_aead_set_key (
+  IN   uint16                       aead_cipher_suite,
+  IN   void                         *aead_context,
+  IN   const uint8*                 key,
+  IN   uintn                        key_size
+  );
+
+/**
+  Performs AEAD authenticated encryption on a data buffer and additional authenticated data (AAD),
+  with the key in the AEAD context, based upon negotiated AEAD algorithm.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+  @param  aead_context                   Pointer to the AEAD context with the key set.
+  @param  iv                           Pointer to the IV value.
+  @param  iv_size                       size of the IV value in bytes.
+  @param  a_data                        Pointer to the additional authenticated data (AAD).
+  @param  a_data_size                    size of the additional authenticated data (AAD) in bytes.
+  @param  data_in                       Pointer to the input data buffer to be encrypted.
+  @param  data_in_size                   size of the input data buffer in bytes.
+  @param  tag_out                       Pointer to a buffer that receives the authentication tag output.
+  @param  tag_size                      size of the authentication tag in bytes.
+  @param  data_out                      Pointer to a buffer that receives the encryption output.
+  @param  data_out_size                  size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD authenticated encryption succeeded.
+  @retval FALSE  AEAD authenticated encryption failed.
+**/
+boolean
+spdm_aead_encryption_with_context (
+  IN   uint16                       aead_cipher_suite,
+  IN   void                         *aead_context,
+  IN   const uint8*                 iv,
+  IN   uintn                        iv_size,
+  IN   const uint8*                 a_data,
+  IN   uintn                        a_data_size,
+  IN   const uint8*                 data_in,
+  IN   uintn                        data_in_size,
+  OUT  uint8*                       tag_out,
+  IN   uintn                        tag_size,
+  OUT  uint8*                       data_out,
+  OUT  uintn*                       data_out_size
+  );
+
+/**
+  Performs AEAD authenticated decryption on a data buffer and additional authenticated data (AAD),
+  with the key in the AEAD context, based upon negotiated AEAD algorithm.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+  @param  aead_context                   Pointer to the AEAD context with the key set.
+  @param  iv                           Pointer to the IV value.
+  @param  iv_size                       size of the IV value in bytes.
+  @param  a_data                        Pointer to the additional authenticated data (AAD).
+  @param  a_data_size                    size of the additional authenticated data (AAD) in bytes.
+  @param  data_in                       Pointer to the input data buffer to be decrypted.
+  @param  data_in_size                   size of the input data buffer in bytes.
+  @param  tag                          Pointer to a buffer that contains the authentication tag.
+  @param  tag_size                      size of the authentication tag in bytes.
+  @param  data_out                      Pointer to a buffer that receives the decryption output.
+  @param  data_out_size                  size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD authenticated decryption succeeded.
+  @retval FALSE  AEAD authenticated decryption failed.
+**/
+boolean
+spdm_aead_decryption_with_context (
+  IN   uint16                       aead_cipher_suite,
+  IN   void                         *aead_context,
+  IN   const uint8*                 iv,
+  IN   uintn                        iv_size,
+  IN   const uint8*                 a_data,
+  IN   uintn                        a_data_size,
+  IN   const uint8*                 data_in,
+  IN   uintn                        data_in_size,
+  IN   const uint8*                 tag,
+  IN   uintn                        tag_size,
+  OUT  uint8*                       data_out,
+  OUT  uintn*                       data_out_size
+  );
+
 /**
   Generates a random byte stream of the specified size.
 
@@ -940,6 +1618,25 @@ spdm_get_random_number (
   OUT uint8                     *rand
   );
 
+/**
+  Check the X509 DataTime is within a valid range.
+
+  @param  from                         notBefore Pointer to date_time object.
+  @param  from_size                     notBefore date_time object size.
+  @param  to                           notAfter Pointer to date_time object.
+  @param  to_size                       notAfter date_time object size.
+
+  @retval  TRUE   verification pass.
+  @retval  FALSE  verification fail.
+**/
+boolean
+spdm_x509_date_time_check (
+  IN uint8 *from,
+  IN uintn from_size,
+  IN uint8 *to,
+  IN uintn to_size
+  );
+
 /**
   Certificate Check for SPDM leaf cert.
 
@@ -1061,4 +1758,153 @@ spdm_verify_certificate_chain_buffer (
   IN uintn                        cert_chain_buffer_size
   );
 
+/**
+  This function initializes the verification of a certificate chain buffer which is received portion by portion.
+
+  @param  verify_context                 The certificate chain verification context.
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+**/
+void
+spdm_cert_chain_verify_init (
+  OUT spdm_cert_chain_verify_context_t  *verify_context,
+  IN  uint32                            bash_hash_algo
+  );
+
+/**
+  This function checks whether a certificate link is in the verified certificate link cache.
+
+  The validity period of the certificate is checked on every hit.
+  An entry whose certificate is expired or not yet valid is dropped.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo of the certificate hashes.
+  @param  issuer_cert_hash               The hash of the issuer certificate.
+  @param  cert_hash                      The hash of the certificate.
+
+  @retval TRUE  the link is verified before, and the certificate is still valid.
+  @retval FALSE the link is not in the cache.
+**/
+boolean
+spdm_cert_link_cache_find (
+  IN uint32                       bash_hash_algo,
+  IN const uint8                  *issuer_cert_hash,
+  IN const uint8                  *cert_hash
+  );
+
+/**
+  This function adds a verified certificate link to the verified certificate link cache.
+
+  The validity period of the certificate is kept with the link.
+  An invalid entry is used first, otherwise the least recently used entry is replaced.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo of the certificate hashes.
+  @param  issuer_cert_hash               The hash of the issuer certificate.
+  @param  cert_hash                      The hash of the certificate.
+  @param  cert                           The DER-encoded certificate.
+  @param  cert_size                      size in bytes of the certificate.
+**/
+void
+spdm_cert_link_cache_add (
+  IN uint32                       bash_hash_algo,
+  IN const uint8                  *issuer_cert_hash,
+  IN const uint8                  *cert_hash,
+  IN const uint8                  *cert,
+  IN uintn                        cert_size
+  );
+
+/**
+  This function invalidates the verified certificate link cache.
+
+  It should be called when the trust of a certificate is revoked,
+  so that the links of the certificate are verified again.
+**/
+void
+spdm_clear_cert_link_cache (
+  void
+  );
+
+/**
+  This function verifies one link of a certificate chain.
+
+  A link found in the verified certificate link cache is not verified again,
+  as long as the certificate is still in its validity period.
+  The cache is shared by all SPDM contexts of the process.
+
+  @param  link                           The link of the certificate chain.
+
+  @retval TRUE  the certificate is issued by the issuer certificate.
+  @retval FALSE the certificate is invalid, or it is not issued by the issuer certificate.
+**/
+boolean
+spdm_verify_cert_chain_link (
+  IN const spdm_cert_chain_link_t  *link
+  );
+
+/**
+  This function gets the links of the certificates which are completely received in the certificate chain buffer,
+  and not returned or verified by the previous calls, so that the links can be verified in parallel.
+
+  The root certificate is verified with the root hash in the certificate chain buffer.
+  The returned links are treated as verified by the verification context,
+  so the caller must verify each of them with spdm_verify_cert_chain_link.
+
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              The received part of the certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the received part of the certificate chain buffer.
+  @param  link                           The buffer to store the links.
+  @param  link_count                     On input, the count of the links the buffer can hold.
+                                       On output, the count of the links returned.
+
+  @retval TRUE  the links are returned.
+  @retval FALSE the root certificate does not match the root hash.
+**/
+boolean
+spdm_cert_chain_verify_get_links (
+  IN OUT spdm_cert_chain_verify_context_t  *verify_context,
+  IN     void                              *cert_chain_buffer,
+  IN     uintn                             cert_chain_buffer_size,
+     OUT spdm_cert_chain_link_t            *link,
+  IN OUT uintn                             *link_count
+  );
+
+/**
+  This function verifies the certificates which are completely received in the certificate chain buffer,
+  and not verified by the previous calls.
+
+  The root certificate is verified with the root hash in the certificate chain buffer, and
+  each certificate is verified with the preceding certificate.
+
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              The received part of the certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the received part of the certificate chain buffer.
+
+  @retval TRUE  the received certificates pass the verification.
+  @retval FALSE a received certificate fails the verification.
+**/
+boolean
+spdm_cert_chain_verify_update (
+  IN OUT spdm_cert_chain_verify_context_t  *verify_context,
+  IN     void                              *cert_chain_buffer,
+  IN     uintn                             cert_chain_buffer_size
+  );
+
+/**
+  This function completes the verification of the certificate chain buffer.
+
+  The certificates which are not verified by spdm_cert_chain_verify_update are verified,
+  then the leaf certificate is checked.
+
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              The certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certificate chain buffer.
+
+  @retval TRUE  certificate chain buffer integrity verification pass.
+  @retval FALSE certificate chain buffer integrity verification fail.
+**/
+boolean
+spdm_cert_chain_verify_final (
+  IN OUT spdm_cert_chain_verify_context_t  *verify_context,
+  IN     void                              *cert_chain_buffer,
+  IN     uintn                             cert_chain_buffer_size
+  );
+
 #endif
\ No newline at end of file
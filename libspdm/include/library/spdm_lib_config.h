@@ -16,10 +16,25 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MAX_SPDM_PSK_HINT_LENGTH          16
 
 #define MAX_SPDM_MEASUREMENT_BLOCK_COUNT  8
+
+//
+// The count of the measurement hash algorithms whose measurements are cached by the responder.
+//
+#define MAX_SPDM_MEASUREMENT_CACHE_ENTRY_COUNT  2
+
+//
+// The count of the verified peer certificate chains cached by the requester.
+//
+#define MAX_SPDM_PEER_CERT_CHAIN_CACHE_ENTRY_COUNT  4
+
+//
+// The default count of sessions in the session table.
+// It can be changed with SPDM_DATA_MAX_SESSION_COUNT at runtime.
+//
 #define MAX_SPDM_SESSION_COUNT            4
+
 #define MAX_SPDM_CERT_CHAIN_SIZE          0x20000
 #define MAX_SPDM_MEASUREMENT_RECORD_SIZE  0x1000
-#define MAX_SPDM_CERT_CHAIN_BLOCK_LEN     1024
 
 #define MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE 0x20000
 #define MAX_SPDM_MESSAGE_BUFFER_SIZE       0x2000
@@ -31,6 +46,54 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define MAX_SPDM_FRAGMENT_LENGTH  0x1000
 
+//
+// The max count of fragments sent in FRAGMENT_REQUEST before the ACK.
+// It is limited by the 4-bit window field of the BEGIN fragment.
+//
+#define MAX_SPDM_FRAGMENT_WINDOW_SIZE     15
+
+//
+// The max length of a portion of the certificate chain in one CERTIFICATE response.
+// It is sized so that the CERTIFICATE response (the header and the portion) is not larger than
+// MAX_SPDM_FRAGMENT_LENGTH, the largest message sent without fragmentation.
+// At runtime, the portion is also limited by SPDM_DATA_CAPABILITY_DATA_TRANSFER_SIZE.
+// A peer with a smaller limit returns shorter portions, and the requester follows the remainder length.
+//
+#define MAX_SPDM_CERT_CHAIN_BLOCK_LEN     (MAX_SPDM_FRAGMENT_LENGTH - sizeof(spdm_certificate_response_t))
+
+#define MAX_SPDM_KEY_POOL_DEPTH   8
+
+//
+// The count of the verified certificate links cached by the process.
+// A link of a root or intermediate certificate shared by many peers is verified once.
+//
+#define MAX_SPDM_CERT_LINK_CACHE_ENTRY_COUNT  32
+
+#define MAX_SPDM_WORKER_THREAD_COUNT  4
+#define MAX_SPDM_WORKER_JOB_COUNT     8
+
+//
+// The RDTExponent of the ResponseNotReady error of a deferred request.
+// The responder waits 2^RDTExponent microseconds for the job, and the RDTExponent grows
+// up to the max value every time the requester asks too early.
+// The requester sends RESPOND_IF_READY up to MAX_SPDM_RESPOND_IF_READY_RETRY_TIMES times.
+//
+#define SPDM_DEFERRED_RESPONSE_RD_EXPONENT      12
+#define SPDM_DEFERRED_RESPONSE_MAX_RD_EXPONENT  20
+#define SPDM_DEFERRED_RESPONSE_RD_TM            2
+#define MAX_SPDM_RESPOND_IF_READY_RETRY_TIMES   64
+
+//
+// The size in bytes of the stack of a requester flow started by the asynchronous API.
+// The stack is allocated when the flow is started, and it is freed when the flow is done.
+// The large request and response buffers of the flow are allocated from the arena, not from the stack.
+// The signature and key exchange functions of the crypto library also run on this stack.
+// Increase it if the crypto library needs more, such as a reference implementation of a PQC algorithm.
+//
+#ifndef SPDM_ASYNC_FIBER_STACK_SIZE
+#define SPDM_ASYNC_FIBER_STACK_SIZE             0x20000
+#endif
+
 
 //
 // Crypto Configuation
@@ -50,4 +113,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define OPENSPDM_SHA384_SUPPORT      1
 #define OPENSPDM_SHA512_SUPPORT      1
 
+//
+// Derive the secrets of a key schedule stage from one keyed HMAC context per PRK,
+// instead of one HKDF call per secret. Set to 0 if the crypto library has no efficient HMAC context copy.
+//
+#ifndef OPENSPDM_HKDF_EXPAND_BATCH_SUPPORT
+#define OPENSPDM_HKDF_EXPAND_BATCH_SUPPORT       1
+#endif
+
 #endif
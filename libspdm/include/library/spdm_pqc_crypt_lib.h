@@ -173,6 +173,32 @@ spdm_pqc_sig_verify (
   IN  uintn        sig_size
   );
 
+/**
+  Verifies the PQC signature of a message given as a list of segments,
+  based upon negotiated PQC SIG algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  pqc_sig_algo                   SPDM pqc_sig_algo
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to PQC SIG signature to be verified.
+  @param  sig_size                      Size of signature in bytes.
+
+  @retval  TRUE   Valid PQC SIG signature.
+  @retval  FALSE  Invalid PQC SIG signature or invalid PQC SIG context.
+**/
+boolean
+spdm_pqc_sig_verify_segments (
+  IN  pqc_algo_t     pqc_sig_algo,
+  IN  void         *context,
+  IN  const spdm_data_segment_t  *segment,
+  IN  uintn        segment_count,
+  IN  const uint8  *signature,
+  IN  uintn        sig_size
+  );
+
 /**
   Retrieve the Private Key from the raw data.
 
@@ -221,6 +247,33 @@ spdm_pqc_sig_sign (
   IN OUT  uintn        *sig_size
   );
 
+/**
+  Carries out the signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  pqc_sig_algo                   SPDM pqc_sig_algo
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_pqc_sig_sign_segments (
+  IN      pqc_algo_t     pqc_sig_algo,
+  IN      void         *context,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  );
+
 /**
   This function returns the SPDM requester PQC SIG algorithm size.
 
@@ -303,6 +356,32 @@ spdm_pqc_req_sig_verify (
   IN  uintn        sig_size
   );
 
+/**
+  Verifies the PQC SIG signature of a message given as a list of segments,
+  based upon negotiated requester PQC SIG algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  pqc_req_sig_algo                SPDM pqc_req_sig_algo
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to PQC SIG signature to be verified.
+  @param  sig_size                      Size of signature in bytes.
+
+  @retval  TRUE   Valid PQC SIG signature.
+  @retval  FALSE  Invalid PQC SIG signature or invalid PQC SIG context.
+**/
+boolean
+spdm_pqc_req_sig_verify_segments (
+  IN  pqc_algo_t     pqc_req_sig_algo,
+  IN  void         *context,
+  IN  const spdm_data_segment_t  *segment,
+  IN  uintn        segment_count,
+  IN  const uint8  *signature,
+  IN  uintn        sig_size
+  );
+
 /**
   Retrieve the Private Key from the raw data.
 
@@ -351,6 +430,33 @@ spdm_pqc_req_sig_sign (
   IN OUT  uintn        *sig_size
   );
 
+/**
+  Carries out the signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  pqc_req_sig_algo                SPDM pqc_req_sig_algo
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_pqc_req_sig_sign_segments (
+  IN      pqc_algo_t     pqc_req_sig_algo,
+  IN      void         *context,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  );
+
 /**
   This function returns the SPDM PQC KEM algorithm key size.
 
@@ -571,6 +677,31 @@ spdm_hybrid_sig_sign (
   IN OUT  uintn        *sig_size
   );
 
+/**
+  Carries out the hybrid signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_hybrid_sig_sign_segments (
+  IN      void         *context,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  );
+
 /**
   Verifies the PQC signature,
   based upon negotiated PQC SIG algorithm.
@@ -593,6 +724,29 @@ spdm_hybrid_sig_verify (
   IN  uintn        sig_size
   );
 
+/**
+  Verifies the hybrid signature of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to PQC SIG signature to be verified.
+  @param  sig_size                      Size of signature in bytes.
+
+  @retval  TRUE   Valid PQC SIG signature.
+  @retval  FALSE  Invalid PQC SIG signature or invalid PQC SIG context.
+**/
+boolean
+spdm_hybrid_sig_verify_segments (
+  IN  void         *context,
+  IN  const spdm_data_segment_t  *segment,
+  IN  uintn        segment_count,
+  IN  const uint8  *signature,
+  IN  uintn        sig_size
+  );
+
 /**
   Release the specified PQC SIG context,
   based upon negotiated PQC SIG algorithm.
@@ -145,7 +145,8 @@ spdm_get_certificate (
 
   @param  spdm_context                  A pointer to the SPDM context.
   @param  slot_id                      The number of slot for the certificate chain.
-  @param  length                       MAX_SPDM_CERT_CHAIN_BLOCK_LEN.
+  @param  length                       The portion length of each GET_CERTIFICATE request,
+                                       limited by SPDM_DATA_CAPABILITY_DATA_TRANSFER_SIZE.
   @param  cert_chain_size                On input, indicate the size in bytes of the destination buffer to store the digest buffer.
                                        On output, indicate the size in bytes of the certificate chain.
   @param  cert_chain                    A pointer to a destination buffer to store the certificate chain.
@@ -468,4 +469,334 @@ spdm_generate_encap_extended_error_response (
      OUT void                 *spdm_response
   );
 
+//
+// The asynchronous API runs a requester flow step by step, so that one thread can drive
+// the flows of many devices, each with its own SPDM context.
+//
+// A flow is started by spdm_async_xxx with the same parameters as the synchronous function.
+// The output buffers must be valid until the flow is done.
+// The device IO functions are not called. The caller drives the flow according to the state:
+//   SPDM_ASYNC_STATE_SEND    - get the transport layer request with spdm_async_get_request_message,
+//                              and send it to the device.
+//   SPDM_ASYNC_STATE_RECEIVE - receive the transport layer response from the device,
+//                              and feed it with spdm_async_feed_response_message.
+//   SPDM_ASYNC_STATE_WAIT    - wait spdm_async_get_wait_time microseconds, then call spdm_async_poll.
+//   SPDM_ASYNC_STATE_DONE    - get the result with spdm_async_poll.
+// The flow of one SPDM context must be driven by one thread at a time.
+//
+typedef enum {
+  SPDM_ASYNC_STATE_IDLE,
+  SPDM_ASYNC_STATE_SEND,
+  SPDM_ASYNC_STATE_RECEIVE,
+  SPDM_ASYNC_STATE_WAIT,
+  SPDM_ASYNC_STATE_DONE,
+} spdm_async_state_t;
+
+/**
+  This function starts the flow of spdm_init_connection.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  get_version_only               If the requester sends GET_VERSION only or not.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_init_connection (
+  IN     void                 *spdm_context,
+  IN     boolean              get_version_only
+  );
+
+/**
+  This function starts the flow of spdm_get_digest.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  slot_mask                     The slots which deploy the CertificateChain.
+  @param  total_digest_buffer            A pointer to a destination buffer to store the digest buffer.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_get_digest (
+  IN     void                 *spdm_context,
+     OUT uint8                *slot_mask,
+     OUT void                 *total_digest_buffer
+  );
+
+/**
+  This function starts the flow of spdm_get_certificate.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  slot_id                      The number of slot for the certificate chain.
+  @param  cert_chain_size                On input, indicate the size in bytes of the destination buffer to store the digest buffer.
+                                       On output, indicate the size in bytes of the certificate chain.
+  @param  cert_chain                    A pointer to a destination buffer to store the certificate chain.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_get_certificate (
+  IN     void                 *spdm_context,
+  IN     uint8                slot_id,
+  IN OUT uintn                *cert_chain_size,
+     OUT void                 *cert_chain
+  );
+
+/**
+  This function starts the flow of spdm_challenge.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  slot_id                      The number of slot for the challenge.
+  @param  measurement_hash_type          The type of the measurement hash.
+  @param  measurement_hash              A pointer to a destination buffer to store the measurement hash.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_challenge (
+  IN     void                 *spdm_context,
+  IN     uint8                slot_id,
+  IN     uint8                measurement_hash_type,
+     OUT void                 *measurement_hash
+  );
+
+/**
+  This function starts the flow of spdm_get_measurement.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    Indicates if it is a secured message protected via SPDM session.
+                                       If session_id is NULL, it is a normal message.
+                                       If session_id is NOT NULL, it is a secured message.
+  @param  request_attribute             The request attribute of the request message.
+  @param  measurement_operation         The measurement operation of the request message.
+  @param  slot_id                      The number of slot for the certificate chain.
+  @param  number_of_blocks               The number of blocks of the measurement record.
+  @param  measurement_record_length      On input, indicate the size in bytes of the destination buffer to store the measurement record.
+                                       On output, indicate the size in bytes of the measurement record.
+  @param  measurement_record            A pointer to a destination buffer to store the measurement record.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_get_measurement (
+  IN     void                 *spdm_context,
+  IN     uint32               *session_id,
+  IN     uint8                request_attribute,
+  IN     uint8                measurement_operation,
+  IN     uint8                slot_id,
+     OUT uint8                *number_of_blocks,
+  IN OUT uint32               *measurement_record_length,
+     OUT void                 *measurement_record
+  );
+
+/**
+  This function starts the flow of spdm_start_session.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  use_psk                       FALSE means to use KEY_EXCHANGE/FINISH to start a session.
+                                       TRUE means to use PSK_EXCHANGE/PSK_FINISH to start a session.
+  @param  measurement_hash_type          The type of the measurement hash.
+  @param  slot_id                      The number of slot for the certificate chain.
+  @param  session_id                    The session ID of the session.
+  @param  heartbeat_period              The heartbeat period for the session.
+  @param  measurement_hash              A pointer to a destination buffer to store the measurement hash.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_start_session (
+  IN     void                 *spdm_context,
+  IN     boolean              use_psk,
+  IN     uint8                measurement_hash_type,
+  IN     uint8                slot_id,
+     OUT uint32               *session_id,
+     OUT uint8                *heartbeat_period,
+     OUT void                 *measurement_hash
+  );
+
+/**
+  This function starts the flow of spdm_stop_session.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    The session ID of the session.
+  @param  end_session_attributes         The end session attribute for the session.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_stop_session (
+  IN     void                 *spdm_context,
+  IN     uint32               session_id,
+  IN     uint8                end_session_attributes
+  );
+
+/**
+  This function starts the flow of spdm_send_receive_data.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    Indicates if it is a secured message protected via SPDM session.
+                                       If session_id is NULL, it is a normal message.
+                                       If session_id is NOT NULL, it is a secured message.
+  @param  is_app_message                 Indicates if it is an APP message or SPDM message.
+  @param  request                      A pointer to the request data.
+  @param  request_size                  size in bytes of the request data.
+  @param  response                     A pointer to the response data.
+  @param  response_size                 size in bytes of the response data.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_send_receive_data (
+  IN     void                 *spdm_context,
+  IN     uint32               *session_id,
+  IN     boolean              is_app_message,
+  IN     void                 *request,
+  IN     uintn                request_size,
+     OUT void                 *response,
+  IN OUT uintn                *response_size
+  );
+
+/**
+  This function starts the flow of spdm_heartbeat.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    The session ID of the session.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_heartbeat (
+  IN     void                 *spdm_context,
+  IN     uint32               session_id
+  );
+
+/**
+  This function starts the flow of spdm_key_update.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    The session ID of the session.
+  @param  single_direction              TRUE means the operation is UPDATE_KEY.
+                                       FALSE means the operation is UPDATE_ALL_KEYS.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_key_update (
+  IN     void                 *spdm_context,
+  IN     uint32               session_id,
+  IN     boolean              single_direction
+  );
+
+/**
+  This function returns the state of the flow started by the asynchronous API.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the state of the flow.
+**/
+spdm_async_state_t
+spdm_async_get_state (
+  IN     void                 *spdm_context
+  );
+
+/**
+  This function gets the transport layer request message of the flow in SPDM_ASYNC_STATE_SEND,
+  then runs the flow until the next step, as if the message was sent.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  message_size                  On input, the size in bytes of the message buffer.
+                                       On output, the size in bytes of the message.
+  @param  message                      A pointer to a destination buffer to store the message.
+
+  @retval RETURN_SUCCESS               The message is returned.
+  @retval RETURN_NOT_READY             The flow is not in SPDM_ASYNC_STATE_SEND.
+  @retval RETURN_BUFFER_TOO_SMALL      The buffer is too small to hold the message.
+**/
+return_status
+spdm_async_get_request_message (
+  IN     void                 *spdm_context,
+  IN OUT uintn                *message_size,
+     OUT void                 *message
+  );
+
+/**
+  This function feeds the transport layer response message to the flow in SPDM_ASYNC_STATE_RECEIVE,
+  then runs the flow until the next step.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  message_size                  The size in bytes of the message.
+  @param  message                      A pointer to the message.
+
+  @retval RETURN_SUCCESS               The message is consumed.
+  @retval RETURN_NOT_READY             The flow is not in SPDM_ASYNC_STATE_RECEIVE.
+  @retval RETURN_BUFFER_TOO_SMALL      The message is larger than the receive buffer of the flow.
+**/
+return_status
+spdm_async_feed_response_message (
+  IN     void                 *spdm_context,
+  IN     uintn                message_size,
+  IN     void                 *message
+  );
+
+/**
+  This function returns the time to wait before the flow in SPDM_ASYNC_STATE_WAIT is polled.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the time in microseconds.
+**/
+uint64
+spdm_async_get_wait_time (
+  IN     void                 *spdm_context
+  );
+
+/**
+  This function polls the flow.
+
+  The flow in SPDM_ASYNC_STATE_WAIT is resumed.
+  If the flow is done, the result is returned, and the SPDM context is back to SPDM_ASYNC_STATE_IDLE.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @retval RETURN_NOT_STARTED           No flow is started.
+  @retval RETURN_NOT_READY             The flow is not done.
+  @retval others                       The flow is done. It is the result of the synchronous function.
+**/
+return_status
+spdm_async_poll (
+  IN     void                 *spdm_context
+  );
+
+/**
+  This function cancels the flow, for example, if the device does not respond in time.
+
+  The pending and following device IO of the flow fails with RETURN_DEVICE_ERROR,
+  so that the flow is done at once. The result is got with spdm_async_poll.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_async_cancel (
+  IN     void                 *spdm_context
+  );
+
 #endif
\ No newline at end of file
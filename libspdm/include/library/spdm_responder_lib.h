@@ -103,6 +103,7 @@ spdm_process_request (
                                        either implicit or explicit ownership of the buffer.
 
   @retval RETURN_SUCCESS               The SPDM response is sent successfully.
+  @retval RETURN_NO_RESPONSE           The request is processed, and no response is sent, such as a fragment inside the window.
   @retval RETURN_DEVICE_ERROR          A device error occurs when the SPDM response is sent to the device.
 **/
 return_status
@@ -137,6 +138,7 @@ spdm_build_response (
                                        and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
 
   @retval RETURN_SUCCESS               The SPDM request is set successfully.
+  @retval RETURN_NO_RESPONSE           The SPDM request is processed, and no response is sent, such as a fragment inside the window.
   @retval RETURN_BUFFER_TOO_SMALL      The buffer is too small to hold the data.
   @retval RETURN_DEVICE_ERROR          A device error occurs when communicates with the device.
   @retval RETURN_SECURITY_VIOLATION    Any verification fails.
@@ -155,6 +157,7 @@ spdm_process_message (
   This is the main dispatch function in SPDM responder.
 
   It receives one request message, processes it and sends the response message.
+  No response message is sent for a fragment inside the window of FRAGMENT_REQUEST.
 
   It should be called in a while loop or an timer/interrupt handler.
 
@@ -83,6 +83,19 @@ spdm_secured_message_init_context (
   IN     void                     *spdm_secured_message_context
   );
 
+/**
+  Release the resources held by an SPDM secured message context, such as the AEAD contexts.
+
+  The SPDM secured message context must be initialized by spdm_secured_message_init_context.
+  It may be initialized again by spdm_secured_message_init_context after this function.
+
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+*/
+void
+spdm_secured_message_deinit_context (
+  IN     void                     *spdm_secured_message_context
+  );
+
 /**
   Set use_psk to an SPDM secured message context.
 
@@ -369,6 +382,25 @@ spdm_hmac_all_with_request_finished_key (
   OUT  uint8                        *hmac_value
   );
 
+/**
+  Computes the HMAC of a input data given as a list of segments, with request_finished_key.
+
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+  @param  segment                       Pointer to the segments of the data to be HMACed.
+  @param  segment_count                  number of segments.
+  @param  hash_value                    Pointer to a buffer that receives the HMAC value.
+
+  @retval TRUE   HMAC computation succeeded.
+  @retval FALSE  HMAC computation failed.
+**/
+boolean
+spdm_hmac_all_with_request_finished_key_segments (
+  IN   void                         *spdm_secured_message_context,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  OUT  uint8                        *hmac_value
+  );
+
 /**
   Computes the HMAC of a input data buffer, with response_finished_key.
 
@@ -388,6 +420,25 @@ spdm_hmac_all_with_response_finished_key (
   OUT  uint8                        *hmac_value
   );
 
+/**
+  Computes the HMAC of a input data given as a list of segments, with response_finished_key.
+
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+  @param  segment                       Pointer to the segments of the data to be HMACed.
+  @param  segment_count                  number of segments.
+  @param  hash_value                    Pointer to a buffer that receives the HMAC value.
+
+  @retval TRUE   HMAC computation succeeded.
+  @retval FALSE  HMAC computation failed.
+**/
+boolean
+spdm_hmac_all_with_response_finished_key_segments (
+  IN   void                         *spdm_secured_message_context,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  OUT  uint8                        *hmac_value
+  );
+
 /**
   This function concatenates binary data, which is used as info in HKDF expand later.
 
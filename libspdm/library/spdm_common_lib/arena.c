@@ -0,0 +1,219 @@
+/** @file
+  SPDM common library.
+  It follows the SPDM Specification.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_common_lib_internal.h"
+#include <library/malloclib.h>
+#include <library/threadlib.h>
+
+/**
+  This function returns the size class of a block.
+
+  @param  size                           The size in bytes of the data.
+  @param  block_size                     The size in bytes of the data of a block in the size class.
+
+  @return the size class, or SPDM_ARENA_CLASS_COUNT if the size is too large.
+**/
+uintn
+spdm_arena_get_class (
+  IN     uintn                    size,
+     OUT uintn                    *block_size
+  )
+{
+  uintn  class_index;
+
+  *block_size = SPDM_ARENA_MIN_BLOCK_SIZE;
+  for (class_index = 0; class_index < SPDM_ARENA_CLASS_COUNT; class_index++) {
+    if (size <= *block_size) {
+      return class_index;
+    }
+    *block_size = *block_size * 2;
+  }
+  return SPDM_ARENA_CLASS_COUNT;
+}
+
+/**
+  This function frees the cached blocks of the arena.
+
+  The blocks in use are not freed.
+
+  @param  arena                          The arena.
+**/
+void
+spdm_arena_trim (
+  IN OUT spdm_arena_t             *arena
+  )
+{
+  spdm_arena_block_t  *block;
+  uintn               class_index;
+
+  if (arena->mutex != NULL) {
+    mutex_lock (arena->mutex);
+  }
+  for (class_index = 0; class_index < SPDM_ARENA_CLASS_COUNT; class_index++) {
+    while (arena->free_block[class_index] != NULL) {
+      block = arena->free_block[class_index];
+      arena->free_block[class_index] = block->next;
+      arena->allocated_size -= block->size;
+      free_pool (block);
+    }
+  }
+  if (arena->mutex != NULL) {
+    mutex_unlock (arena->mutex);
+  }
+}
+
+/**
+  This function creates the mutex of the arena, so that the buffers can be allocated and released
+  by more than one thread.
+
+  @param  arena                          The arena.
+
+  @retval TRUE  The arena is protected by the mutex.
+  @retval FALSE The mutex cannot be created.
+**/
+boolean
+spdm_arena_init_lock (
+  IN OUT spdm_arena_t             *arena
+  )
+{
+  if (arena->mutex == NULL) {
+    arena->mutex = mutex_new ();
+  }
+  return (boolean)(arena->mutex != NULL);
+}
+
+/**
+  This function frees the mutex of the arena.
+
+  @param  arena                          The arena.
+**/
+void
+spdm_arena_free_lock (
+  IN OUT spdm_arena_t             *arena
+  )
+{
+  if (arena->mutex != NULL) {
+    mutex_free (arena->mutex);
+    arena->mutex = NULL;
+  }
+}
+
+/**
+  This function allocates a buffer from the arena.
+
+  The size is rounded up to the size class of the block, so that a released block can be
+  reused by a later allocation, such as the transcript of the next connection or session.
+
+  @param  arena                          The arena.
+  @param  size                           The size in bytes of the buffer.
+  @param  buffer_size                    The size in bytes of the allocated buffer. It may be NULL.
+
+  @return the buffer, or NULL if the size is too large or the arena limit is reached.
+**/
+void *
+spdm_arena_allocate (
+  IN OUT spdm_arena_t             *arena,
+  IN     uintn                    size,
+     OUT uintn                    *buffer_size OPTIONAL
+  )
+{
+  spdm_arena_block_t  *block;
+  uintn               class_index;
+  uintn               block_size;
+
+  class_index = spdm_arena_get_class (size, &block_size);
+  if (class_index >= SPDM_ARENA_CLASS_COUNT) {
+    DEBUG ((DEBUG_ERROR, "spdm_arena_allocate - size 0x%x is too large\n", (uint32)size));
+    return NULL;
+  }
+
+  if (arena->mutex != NULL) {
+    mutex_lock (arena->mutex);
+  }
+  block = arena->free_block[class_index];
+  if (block != NULL) {
+    arena->free_block[class_index] = block->next;
+  } else {
+    if ((arena->max_size != 0) && (arena->allocated_size + sizeof(spdm_arena_block_t) + block_size > arena->max_size)) {
+      if (arena->mutex != NULL) {
+        mutex_unlock (arena->mutex);
+      }
+      spdm_arena_trim (arena);
+      if (arena->mutex != NULL) {
+        mutex_lock (arena->mutex);
+      }
+    }
+    if ((arena->max_size != 0) && (arena->allocated_size + sizeof(spdm_arena_block_t) + block_size > arena->max_size)) {
+      DEBUG ((DEBUG_ERROR, "spdm_arena_allocate - arena limit 0x%x is reached\n", (uint32)arena->max_size));
+      block = NULL;
+    } else {
+      block = allocate_pool (sizeof(spdm_arena_block_t) + block_size);
+      if (block != NULL) {
+        block->size = sizeof(spdm_arena_block_t) + block_size;
+        arena->allocated_size += block->size;
+      }
+    }
+  }
+  if (block != NULL) {
+    block->next = NULL;
+    arena->used_size += block->size;
+  }
+  if (arena->mutex != NULL) {
+    mutex_unlock (arena->mutex);
+  }
+  if (block == NULL) {
+    return NULL;
+  }
+
+  if (buffer_size != NULL) {
+    *buffer_size = block_size;
+  }
+  return block + 1;
+}
+
+/**
+  This function releases a buffer to the arena.
+
+  The buffer is zeroed, so that no transcript or certificate data is left in a cached block,
+  or in the memory freed by spdm_arena_trim.
+  The block is cached in the arena to be reused. It is freed by spdm_arena_trim.
+
+  @param  arena                          The arena.
+  @param  buffer                         The buffer returned by spdm_arena_allocate. It may be NULL.
+**/
+void
+spdm_arena_free (
+  IN OUT spdm_arena_t             *arena,
+  IN     void                     *buffer
+  )
+{
+  spdm_arena_block_t  *block;
+  uintn               class_index;
+  uintn               block_size;
+
+  if (buffer == NULL) {
+    return ;
+  }
+  block = (spdm_arena_block_t *)buffer - 1;
+  class_index = spdm_arena_get_class (block->size - sizeof(spdm_arena_block_t), &block_size);
+  ASSERT (class_index < SPDM_ARENA_CLASS_COUNT);
+  zero_mem (buffer, block_size);
+
+  if (arena->mutex != NULL) {
+    mutex_lock (arena->mutex);
+  }
+  ASSERT (arena->used_size >= block->size);
+  arena->used_size -= block->size;
+
+  block->next = arena->free_block[class_index];
+  arena->free_block[class_index] = block;
+  if (arena->mutex != NULL) {
+    mutex_unlock (arena->mutex);
+  }
+}
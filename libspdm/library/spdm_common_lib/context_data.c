@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "spdm_common_lib_internal.h"
+#include <library/threadlib.h>
 
 /**
   Returns if an SPDM data_type requires session info.
@@ -131,6 +132,15 @@ spdm_set_data (
     }
     spdm_context->local_context.capability.ct_exponent = *(uint8 *)data;
     break;
+  case SPDM_DATA_CAPABILITY_DATA_TRANSFER_SIZE:
+    if (data_size != sizeof(uint32)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (*(uint32 *)data <= sizeof(spdm_certificate_response_t)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    spdm_context->local_context.capability.data_transfer_size = *(uint32 *)data;
+    break;
   case SPDM_DATA_MEASUREMENT_SPEC:
     if (data_size != sizeof(uint8)) {
       return RETURN_INVALID_PARAMETER;
@@ -226,10 +236,13 @@ spdm_set_data (
   case SPDM_DATA_PEER_PUBLIC_ROOT_CERT_HASH:
     spdm_context->local_context.peer_root_cert_hash_provision_size = data_size;
     spdm_context->local_context.peer_root_cert_hash_provision = data;
+    spdm_peer_cert_chain_cache_flush (spdm_context);
     break;
   case SPDM_DATA_PEER_PUBLIC_CERT_CHAIN:
     spdm_context->local_context.peer_cert_chain_provision_size = data_size;
     spdm_context->local_context.peer_cert_chain_provision = data;
+    spdm_reset_peer_public_key_context (spdm_context);
+    spdm_peer_cert_chain_cache_flush (spdm_context);
     break;
   case SPDM_DATA_LOCAL_SLOT_COUNT:
     if (data_size != sizeof(uint8)) {
@@ -240,6 +253,7 @@ spdm_set_data (
       return RETURN_INVALID_PARAMETER;
     }
     spdm_context->local_context.slot_count = slot_id;
+    spdm_reset_response_cache (spdm_context);
     break;
   case SPDM_DATA_LOCAL_PUBLIC_CERT_CHAIN:
     slot_id = parameter->additional_data[0];
@@ -248,6 +262,7 @@ spdm_set_data (
     }
     spdm_context->local_context.local_cert_chain_provision_size[slot_id] = data_size;
     spdm_context->local_context.local_cert_chain_provision[slot_id] = data;
+    spdm_reset_response_cache (spdm_context);
     break;
   case SPDM_DATA_LOCAL_USED_CERT_CHAIN_BUFFER:
     if (data_size > MAX_SPDM_CERT_CHAIN_SIZE) {
@@ -257,11 +272,9 @@ spdm_set_data (
     spdm_context->connection_info.local_used_cert_chain_buffer = data;
     break;
   case SPDM_DATA_PEER_USED_CERT_CHAIN_BUFFER:
-    if (data_size > MAX_SPDM_CERT_CHAIN_SIZE) {
+    if (!spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size)) {
       return RETURN_OUT_OF_RESOURCES;
     }
-    spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-    copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
     break;
   case SPDM_DATA_BASIC_MUT_AUTH_REQUESTED:
     if (data_size != sizeof(boolean)) {
@@ -358,6 +371,7 @@ spdm_set_data (
   case SPDM_DATA_PQC_PEER_PUBLIC_KEY:
     spdm_context->local_context.pqc_peer_public_key_provision_size = data_size;
     spdm_context->local_context.pqc_peer_public_key_provision = data;
+    spdm_reset_peer_public_key_context (spdm_context);
     break;
   case SPDM_DATA_PQC_LOCAL_PUBLIC_KEY:
     slot_id = parameter->additional_data[0];
@@ -380,6 +394,119 @@ spdm_set_data (
     }
     spdm_context->connection_info.pqc_peer_used_public_key_size = data_size;
     copy_mem (spdm_context->connection_info.pqc_peer_used_public_key, data, data_size);
+    spdm_reset_peer_public_key_context (spdm_context);
+    break;
+
+  case SPDM_DATA_KEY_POOL_DEPTH:
+    if (data_size != sizeof(uint8)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (*(uint8 *)data > MAX_SPDM_KEY_POOL_DEPTH) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    spdm_key_pool_stop (spdm_context);
+    spdm_context->key_pool.depth = *(uint8 *)data;
+    spdm_context->key_pool.low_watermark = spdm_context->key_pool.depth / 2;
+    spdm_context->key_pool.high_watermark = spdm_context->key_pool.depth;
+    break;
+  case SPDM_DATA_KEY_POOL_LOW_WATERMARK:
+    if (data_size != sizeof(uint8)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (*(uint8 *)data >= spdm_context->key_pool.high_watermark) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    spdm_context->key_pool.low_watermark = *(uint8 *)data;
+    break;
+  case SPDM_DATA_KEY_POOL_HIGH_WATERMARK:
+    if (data_size != sizeof(uint8)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if ((*(uint8 *)data > spdm_context->key_pool.depth) ||
+        (*(uint8 *)data <= spdm_context->key_pool.low_watermark)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    spdm_context->key_pool.high_watermark = *(uint8 *)data;
+    break;
+  case SPDM_DATA_WORKER_THREAD_COUNT:
+    if (data_size != sizeof(uint8)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (*(uint8 *)data > MAX_SPDM_WORKER_THREAD_COUNT) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (spdm_context->deferred_response.in_flight) {
+      return RETURN_ACCESS_DENIED;
+    }
+    spdm_worker_pool_stop (spdm_context);
+    spdm_context->worker_pool.thread_count = *(uint8 *)data;
+    break;
+  case SPDM_DATA_ARENA_MAX_SIZE:
+    if (data_size != sizeof(uint32)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    spdm_context->arena.max_size = *(uint32 *)data;
+    break;
+  case SPDM_DATA_DEFERRED_RESPONSE:
+    if (data_size != sizeof(boolean)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    spdm_context->deferred_response.enabled = *(boolean *)data;
+    break;
+  case SPDM_DATA_MEASUREMENT_CACHE:
+    if (data_size != sizeof(boolean)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (spdm_context->deferred_response.in_flight) {
+      return RETURN_ACCESS_DENIED;
+    }
+    spdm_context->measurement_cache.enabled = *(boolean *)data;
+    if (!spdm_context->measurement_cache.enabled) {
+      spdm_measurement_cache_flush (spdm_context);
+    }
+    break;
+  case SPDM_DATA_MEASUREMENT_GENERATION:
+    if (data_size != sizeof(uint32)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    //
+    // The entries of the old generation are not used, and they are replaced later.
+    //
+    spdm_context->measurement_cache.generation = *(uint32 *)data;
+    break;
+  case SPDM_DATA_PEER_CERT_CHAIN_CACHE:
+    if (data_size != sizeof(boolean)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    spdm_context->peer_cert_chain_cache.enabled = *(boolean *)data;
+    if (!spdm_context->peer_cert_chain_cache.enabled) {
+      spdm_peer_cert_chain_cache_flush (spdm_context);
+    }
+    break;
+  case SPDM_DATA_FRAGMENT_WINDOW_SIZE:
+    if (data_size != sizeof(uint8)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (*(uint8 *)data > MAX_SPDM_FRAGMENT_WINDOW_SIZE) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    spdm_context->fragment_window_size = *(uint8 *)data;
+    break;
+  case SPDM_DATA_MAX_SESSION_COUNT:
+    if (data_size != sizeof(uint32)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if ((*(uint32 *)data == 0) || (*(uint32 *)data > MAX_SPDM_SESSION_TABLE_COUNT)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    if (spdm_context->session_count != 0) {
+      return RETURN_ACCESS_DENIED;
+    }
+    spdm_session_table_free (spdm_context);
+    if (RETURN_ERROR (spdm_session_table_init (spdm_context, *(uint32 *)data))) {
+      spdm_session_table_init (spdm_context, MAX_SPDM_SESSION_COUNT);
+      return RETURN_OUT_OF_RESOURCES;
+    }
     break;
 
   default:
@@ -423,6 +550,7 @@ spdm_get_data (
   void                       *target_data;
   uint32                     session_id;
   spdm_session_info_t          *session_info;
+  uint32                     arena_max_size;
 
   spdm_context = context;
 
@@ -468,6 +596,10 @@ spdm_get_data (
       target_data = &spdm_context->local_context.capability.ct_exponent;
     }
     break;
+  case SPDM_DATA_CAPABILITY_DATA_TRANSFER_SIZE:
+    target_data_size = sizeof(uint32);
+    target_data = &spdm_context->local_context.capability.data_transfer_size;
+    break;
   case SPDM_DATA_MEASUREMENT_SPEC:
     if (parameter->location != SPDM_DATA_LOCATION_CONNECTION) {
       return RETURN_INVALID_PARAMETER;
@@ -570,6 +702,52 @@ spdm_get_data (
     target_data = &spdm_context->connection_info.algorithm.pqc_req_sig_algo;
     break;
 
+  case SPDM_DATA_KEY_POOL_DEPTH:
+    target_data_size = sizeof(uint8);
+    target_data = &spdm_context->key_pool.depth;
+    break;
+  case SPDM_DATA_KEY_POOL_LOW_WATERMARK:
+    target_data_size = sizeof(uint8);
+    target_data = &spdm_context->key_pool.low_watermark;
+    break;
+  case SPDM_DATA_KEY_POOL_HIGH_WATERMARK:
+    target_data_size = sizeof(uint8);
+    target_data = &spdm_context->key_pool.high_watermark;
+    break;
+  case SPDM_DATA_WORKER_THREAD_COUNT:
+    target_data_size = sizeof(uint8);
+    target_data = &spdm_context->worker_pool.thread_count;
+    break;
+  case SPDM_DATA_ARENA_MAX_SIZE:
+    arena_max_size = (uint32)spdm_context->arena.max_size;
+    target_data_size = sizeof(uint32);
+    target_data = &arena_max_size;
+    break;
+  case SPDM_DATA_DEFERRED_RESPONSE:
+    target_data_size = sizeof(boolean);
+    target_data = &spdm_context->deferred_response.enabled;
+    break;
+  case SPDM_DATA_MEASUREMENT_CACHE:
+    target_data_size = sizeof(boolean);
+    target_data = &spdm_context->measurement_cache.enabled;
+    break;
+  case SPDM_DATA_MEASUREMENT_GENERATION:
+    target_data_size = sizeof(uint32);
+    target_data = &spdm_context->measurement_cache.generation;
+    break;
+  case SPDM_DATA_PEER_CERT_CHAIN_CACHE:
+    target_data_size = sizeof(boolean);
+    target_data = &spdm_context->peer_cert_chain_cache.enabled;
+    break;
+  case SPDM_DATA_FRAGMENT_WINDOW_SIZE:
+    target_data_size = sizeof(uint8);
+    target_data = &spdm_context->fragment_window_size;
+    break;
+  case SPDM_DATA_MAX_SESSION_COUNT:
+    target_data_size = sizeof(uint32);
+    target_data = &spdm_context->max_session_count;
+    break;
+
   default:
     return RETURN_UNSUPPORTED;
     break;
@@ -599,6 +777,7 @@ spdm_reset_message_a (
 
   spdm_context = context;
   reset_managed_buffer (&spdm_context->transcript.message_a);
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_m1m2);
 }
 
 /**
@@ -615,6 +794,7 @@ spdm_reset_message_b (
 
   spdm_context = context;
   reset_managed_buffer (&spdm_context->transcript.message_b);
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_m1m2);
 }
 
 /**
@@ -631,6 +811,7 @@ spdm_reset_message_c (
 
   spdm_context = context;
   reset_managed_buffer (&spdm_context->transcript.message_c);
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_m1m2);
 }
 
 /**
@@ -647,6 +828,7 @@ spdm_reset_message_mut_b (
 
   spdm_context = context;
   reset_managed_buffer (&spdm_context->transcript.message_mut_b);
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_mut_m1m2);
 }
 
 /**
@@ -663,6 +845,7 @@ spdm_reset_message_mut_c (
 
   spdm_context = context;
   reset_managed_buffer (&spdm_context->transcript.message_mut_c);
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_mut_m1m2);
 }
 
 /**
@@ -679,6 +862,31 @@ spdm_reset_message_m (
 
   spdm_context = context;
   reset_managed_buffer (&spdm_context->transcript.message_m);
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_l1l2);
+}
+
+/**
+  Reset the running hash of every transcript in SPDM context.
+
+  It must be called when a transcript is shrinked, so that the running hash is restarted from the transcript data.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_reset_transcript_hash (
+  IN     void                                *context
+  )
+{
+  spdm_context_t        *spdm_context;
+  uintn                 index;
+
+  spdm_context = context;
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_m1m2);
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_mut_m1m2);
+  spdm_transcript_hash_reset (&spdm_context->transcript.digest_l1l2);
+  for (index = 0; index < spdm_context->max_session_count; index++) {
+    spdm_transcript_hash_reset (&spdm_context->session_info[index].session_transcript.digest_th);
+  }
 }
 
 /**
@@ -934,6 +1142,31 @@ spdm_is_capabilities_flag_supported (
   }
 }
 
+/**
+  This function returns the max length of a portion of the certificate chain in one CERTIFICATE response.
+
+  The CERTIFICATE response with the portion fits in the data transfer size of the local device,
+  and the portion is not longer than MAX_SPDM_CERT_CHAIN_BLOCK_LEN.
+  The requester asks for this length, and the responder returns the smaller one of it and the requested length.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the max length of a portion of the certificate chain.
+**/
+uint32
+spdm_get_cert_chain_block_len (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  uint32  block_len;
+
+  block_len = (uint32)(spdm_context->local_context.capability.data_transfer_size - sizeof(spdm_certificate_response_t));
+  if (block_len > MAX_SPDM_CERT_CHAIN_BLOCK_LEN) {
+    block_len = MAX_SPDM_CERT_CHAIN_BLOCK_LEN;
+  }
+  return block_len;
+}
+
 /**
   Register SPDM device input/output functions.
 
@@ -1049,21 +1282,19 @@ spdm_init_context (
   )
 {
   spdm_context_t       *spdm_context;
-  void                      *secured_message_context;
-  uintn                     SecuredMessageContextSize;
-  uintn                     index;
 
   spdm_context = context;
   zero_mem (spdm_context, sizeof(spdm_context_t));
   spdm_context->version = spdm_context_struct_VERSION;
   spdm_context->transcript.message_a.max_buffer_size    = MAX_SPDM_MESSAGE_SMALL_BUFFER_SIZE;
-  spdm_context->transcript.message_b.max_buffer_size    = MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE;
+  init_arena_managed_buffer (&spdm_context->transcript.message_b, &spdm_context->arena);
   spdm_context->transcript.message_c.max_buffer_size    = MAX_SPDM_MESSAGE_SMALL_BUFFER_SIZE;
-  spdm_context->transcript.message_mut_b.max_buffer_size = MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE;
+  init_arena_managed_buffer (&spdm_context->transcript.message_mut_b, &spdm_context->arena);
   spdm_context->transcript.message_mut_c.max_buffer_size = MAX_SPDM_MESSAGE_SMALL_BUFFER_SIZE;
-  spdm_context->transcript.message_m.max_buffer_size    = MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE;
+  init_arena_managed_buffer (&spdm_context->transcript.message_m, &spdm_context->arena);
   spdm_context->retry_times                           = MAX_SPDM_REQUEST_RETRY_TIMES;
   spdm_context->response_state                        = SPDM_RESPONSE_STATE_NORMAL;
+  spdm_context->local_context.capability.data_transfer_size = MAX_SPDM_FRAGMENT_LENGTH;
   spdm_context->current_token                         = 0;
   spdm_context->local_context.version.spdm_version_count                   = 2;
   spdm_context->local_context.version.spdm_version[0].major_version        = 1;
@@ -1079,19 +1310,85 @@ spdm_init_context (
   spdm_context->local_context.secured_message_version.spdm_version[0].minor_version        = 1;
   spdm_context->local_context.secured_message_version.spdm_version[0].alpha               = 0;
   spdm_context->local_context.secured_message_version.spdm_version[0].update_version_number = 0;
-  spdm_context->encap_context.certificate_chain_buffer.max_buffer_size = MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE;
+  init_arena_managed_buffer (&spdm_context->encap_context.certificate_chain_buffer, &spdm_context->arena);
 
-  secured_message_context = (void *)((uintn)(spdm_context + 1));
-  SecuredMessageContextSize = spdm_secured_message_get_context_size();
-  for (index = 0; index < MAX_SPDM_SESSION_COUNT; index++) {
-    spdm_context->session_info[index].secured_message_context = (void *)((uintn)secured_message_context + SecuredMessageContextSize * index);
-    spdm_secured_message_init_context (spdm_context->session_info[index].secured_message_context);
-  }
+  //
+  // The secured message context of a session is allocated when the session is used first.
+  //
+  spdm_session_table_init (spdm_context, MAX_SPDM_SESSION_COUNT);
 
   random_seed (NULL, 0);
   return ;
 }
 
+/**
+  Free the resources held by an SPDM context.
+
+  It must be called before the memory of the spdm_context is freed.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+*/
+void
+spdm_deinit_context (
+  IN     void                      *context
+  )
+{
+  spdm_context_t       *spdm_context;
+
+  spdm_context = context;
+  //
+  // Cancel the flow of the asynchronous API, so that it releases its buffers.
+  // The device IO and the retry wait of a cancelled flow return at once without yielding,
+  // so the flow is done in one resume.
+  //
+  if (spdm_context->async.fiber != NULL) {
+    spdm_context->async.cancel = TRUE;
+    spdm_context->async.running = TRUE;
+    if (!fiber_resume (spdm_context->async.fiber)) {
+      ASSERT (FALSE);
+    }
+    spdm_context->async.running = FALSE;
+    fiber_free (spdm_context->async.fiber);
+    spdm_context->async.fiber = NULL;
+  }
+  spdm_key_pool_stop (spdm_context);
+  //
+  // A deferred request is done or dropped after the worker pool is stopped.
+  //
+  spdm_worker_pool_stop (spdm_context);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, NULL, 0);
+  spdm_session_table_free (spdm_context);
+  spdm_session_table_free_lock (spdm_context);
+
+  //
+  // Release the large buffers, and free the memory of the arena.
+  //
+  reset_managed_buffer (&spdm_context->transcript.message_b);
+  reset_managed_buffer (&spdm_context->transcript.message_mut_b);
+  reset_managed_buffer (&spdm_context->transcript.message_m);
+  reset_managed_buffer (&spdm_context->encap_context.certificate_chain_buffer);
+  spdm_arena_free (&spdm_context->arena, spdm_context->last_spdm_fragment_encapsulated_request);
+  spdm_context->last_spdm_fragment_encapsulated_request = NULL;
+  spdm_context->last_spdm_fragment_encapsulated_request_size = 0;
+  spdm_context->last_spdm_fragment_encapsulated_request_window_size = 0;
+  spdm_context->last_spdm_fragment_encapsulated_request_unacked_count = 0;
+  spdm_context->last_spdm_fragment_encapsulated_request_error_code = 0;
+  spdm_arena_free (&spdm_context->arena, spdm_context->last_spdm_fragment_encapsulated_response);
+  spdm_context->last_spdm_fragment_encapsulated_response = NULL;
+  spdm_context->last_spdm_fragment_encapsulated_response_size = 0;
+  spdm_context->last_spdm_fragment_encapsulated_response_sent_size = 0;
+  spdm_arena_free (&spdm_context->arena, spdm_context->deferred_response.request);
+  spdm_arena_free (&spdm_context->arena, spdm_context->deferred_response.response);
+  spdm_context->deferred_response.request = NULL;
+  spdm_context->deferred_response.response = NULL;
+  spdm_context->deferred_response.in_flight = FALSE;
+  spdm_measurement_cache_flush (spdm_context);
+  spdm_peer_cert_chain_cache_flush (spdm_context);
+  spdm_arena_trim (&spdm_context->arena);
+  spdm_arena_free_lock (&spdm_context->arena);
+  ASSERT (spdm_context->arena.used_size == 0);
+}
+
 /**
   Return the size in bytes of the SPDM context.
 
@@ -1102,5 +1399,5 @@ spdm_get_context_size (
   void
   )
 {
-  return sizeof(spdm_context_t) + spdm_secured_message_get_context_size() * MAX_SPDM_SESSION_COUNT;
+  return sizeof(spdm_context_t);
 }
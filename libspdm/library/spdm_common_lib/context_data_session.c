@@ -8,14 +8,320 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "spdm_common_lib_internal.h"
+#include <library/threadlib.h>
 
 /**
-  This function initializes the session info.
+  This function returns the hash bucket index of a session ID.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    The SPDM session ID.
+
+  @return the hash bucket index.
+**/
+uintn
+spdm_session_hash_index (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint32                   session_id
+  )
+{
+  //
+  // Fibonacci hashing, so that both halves of the session ID affect the index.
+  //
+  return (uintn)((uint32)(session_id * 0x9E3779B1) >> (32 - spdm_context->session_hash_bits));
+}
+
+/**
+  This function inserts a session in the free list.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The free session.
+**/
+void
+spdm_session_free_list_insert (
+  IN     spdm_context_t           *spdm_context,
+  IN     spdm_session_info_t      *session_info
+  )
+{
+  session_info->free_prev = NULL;
+  session_info->free_next = spdm_context->session_free_list;
+  if (spdm_context->session_free_list != NULL) {
+    spdm_context->session_free_list->free_prev = session_info;
+  }
+  spdm_context->session_free_list = session_info;
+}
+
+/**
+  This function removes a session from the free list.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The free session.
+**/
+void
+spdm_session_free_list_remove (
+  IN     spdm_context_t           *spdm_context,
+  IN     spdm_session_info_t      *session_info
+  )
+{
+  if (session_info->free_prev != NULL) {
+    session_info->free_prev->free_next = session_info->free_next;
+  } else {
+    ASSERT (spdm_context->session_free_list == session_info);
+    spdm_context->session_free_list = session_info->free_next;
+  }
+  if (session_info->free_next != NULL) {
+    session_info->free_next->free_prev = session_info->free_prev;
+  }
+  session_info->free_prev = NULL;
+  session_info->free_next = NULL;
+}
+
+/**
+  This function inserts a session in the hash bucket of its session ID.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The session in use.
+**/
+void
+spdm_session_hash_insert (
+  IN     spdm_context_t           *spdm_context,
+  IN     spdm_session_info_t      *session_info
+  )
+{
+  uintn  index;
+
+  index = spdm_session_hash_index (spdm_context, session_info->session_id);
+  session_info->hash_next = spdm_context->session_hash[index];
+  spdm_context->session_hash[index] = session_info;
+}
+
+/**
+  This function removes a session from the hash bucket of its session ID.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The session in use.
+**/
+void
+spdm_session_hash_remove (
+  IN     spdm_context_t           *spdm_context,
+  IN     spdm_session_info_t      *session_info
+  )
+{
+  spdm_session_info_t  **link;
+
+  link = &spdm_context->session_hash[spdm_session_hash_index (spdm_context, session_info->session_id)];
+  while (*link != NULL) {
+    if (*link == session_info) {
+      *link = session_info->hash_next;
+      break;
+    }
+    link = &(*link)->hash_next;
+  }
+  session_info->hash_next = NULL;
+}
+
+/**
+  This function finds the session in use with the session ID.
 
   @param  spdm_context                  A pointer to the SPDM context.
   @param  session_id                    The SPDM session ID.
+
+  @return the session info, or NULL if the session ID is not in use.
+**/
+spdm_session_info_t *
+spdm_session_hash_find (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint32                   session_id
+  )
+{
+  spdm_session_info_t  *session_info;
+
+  if (spdm_context->session_hash == NULL) {
+    return NULL;
+  }
+  session_info = spdm_context->session_hash[spdm_session_hash_index (spdm_context, session_id)];
+  for (; session_info != NULL; session_info = session_info->hash_next) {
+    if (session_info->session_id == session_id) {
+      return session_info;
+    }
+  }
+  return NULL;
+}
+
+/**
+  This function allocates the session table of the SPDM context.
+
+  All sessions in the table are free.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  max_session_count             The count of the sessions in the table.
+
+  @retval RETURN_SUCCESS               The session table is allocated.
+  @retval RETURN_OUT_OF_RESOURCES      The session table cannot be allocated.
+**/
+return_status
+spdm_session_table_init (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint32                   max_session_count
+  )
+{
+  spdm_session_info_t  *session_info;
+  spdm_session_info_t  **session_hash;
+  uint8                session_hash_bits;
+  uint32               index;
+
+  ASSERT (spdm_context->session_info == NULL);
+  ASSERT ((max_session_count != 0) && (max_session_count <= MAX_SPDM_SESSION_TABLE_COUNT));
+
+  session_hash_bits = 2;
+  while (((uint32)1 << session_hash_bits) < max_session_count) {
+    session_hash_bits++;
+  }
+
+  session_info = spdm_arena_allocate (&spdm_context->arena, sizeof(spdm_session_info_t) * max_session_count, NULL);
+  session_hash = spdm_arena_allocate (&spdm_context->arena, sizeof(spdm_session_info_t *) << session_hash_bits, NULL);
+  if ((session_info == NULL) || (session_hash == NULL)) {
+    spdm_arena_free (&spdm_context->arena, session_info);
+    spdm_arena_free (&spdm_context->arena, session_hash);
+    return RETURN_OUT_OF_RESOURCES;
+  }
+  zero_mem (session_info, sizeof(spdm_session_info_t) * max_session_count);
+  zero_mem (session_hash, sizeof(spdm_session_info_t *) << session_hash_bits);
+
+  spdm_context->session_info = session_info;
+  spdm_context->max_session_count = max_session_count;
+  spdm_context->session_count = 0;
+  spdm_context->session_hash = session_hash;
+  spdm_context->session_hash_bits = session_hash_bits;
+  spdm_context->session_free_list = NULL;
+
+  //
+  // The sessions with lower index are used first.
+  //
+  for (index = max_session_count; index > 0; index--) {
+    init_arena_managed_buffer (&session_info[index - 1].session_transcript.message_k, &spdm_context->arena);
+    init_arena_managed_buffer (&session_info[index - 1].session_transcript.message_f, &spdm_context->arena);
+    spdm_session_free_list_insert (spdm_context, &session_info[index - 1]);
+  }
+  return RETURN_SUCCESS;
+}
+
+/**
+  This function frees the session table of the SPDM context, and the secured message contexts of the sessions.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_session_table_free (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  spdm_session_info_t  *session_info;
+  uint32               index;
+
+  session_info = spdm_context->session_info;
+  if (session_info == NULL) {
+    return ;
+  }
+  for (index = 0; index < spdm_context->max_session_count; index++) {
+    reset_managed_buffer (&session_info[index].session_transcript.message_k);
+    reset_managed_buffer (&session_info[index].session_transcript.message_f);
+    if (session_info[index].secured_message_context != NULL) {
+      spdm_secured_message_deinit_context (session_info[index].secured_message_context);
+      secure_zero_mem (session_info[index].secured_message_context, spdm_secured_message_get_context_size());
+      spdm_arena_free (&spdm_context->arena, session_info[index].secured_message_context);
+    }
+  }
+  spdm_arena_free (&spdm_context->arena, spdm_context->session_hash);
+  spdm_arena_free (&spdm_context->arena, spdm_context->session_info);
+
+  spdm_context->session_info = NULL;
+  spdm_context->max_session_count = 0;
+  spdm_context->session_count = 0;
+  spdm_context->session_hash = NULL;
+  spdm_context->session_hash_bits = 0;
+  spdm_context->session_free_list = NULL;
+}
+
+/**
+  This function creates the mutex of the session table, so that the session table can be updated by a thread
+  while the sessions are looked up by another thread, such as a KEY_EXCHANGE deferred to the worker pool.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @retval TRUE  The session table is protected by the mutex.
+  @retval FALSE The mutex cannot be created.
+**/
+boolean
+spdm_session_table_init_lock (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  if (spdm_context->session_table_mutex == NULL) {
+    spdm_context->session_table_mutex = mutex_new ();
+  }
+  return (boolean)(spdm_context->session_table_mutex != NULL);
+}
+
+/**
+  This function frees the mutex of the session table.
+
+  @param  spdm_context                  A pointer to the SPDM context.
 **/
 void
+spdm_session_table_free_lock (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  if (spdm_context->session_table_mutex != NULL) {
+    mutex_free (spdm_context->session_table_mutex);
+    spdm_context->session_table_mutex = NULL;
+  }
+}
+
+/**
+  This function locks the session table, if the mutex of the session table is created.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_session_table_lock (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  if (spdm_context->session_table_mutex != NULL) {
+    mutex_lock (spdm_context->session_table_mutex);
+  }
+}
+
+/**
+  This function unlocks the session table, if the mutex of the session table is created.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_session_table_unlock (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  if (spdm_context->session_table_mutex != NULL) {
+    mutex_unlock (spdm_context->session_table_mutex);
+  }
+}
+
+/**
+  This function initializes the session info.
+
+  The session is indexed by the session ID, or it is returned to the free list if the session ID is INVALID_SESSION_ID.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The session info in the session table of the SPDM context.
+  @param  session_id                    The SPDM session ID.
+  @param  use_psk                       Whether the session uses PSK.
+
+  @retval TRUE  The session info is initialized.
+  @retval FALSE The secured message context cannot be allocated.
+**/
+boolean
 spdm_session_info_init (
   IN     spdm_context_t     *spdm_context,
   IN     spdm_session_info_t       *session_info,
@@ -44,7 +350,47 @@ spdm_session_info_init (
     break;
   }
 
+  ASSERT ((session_info >= spdm_context->session_info) &&
+          (session_info < spdm_context->session_info + spdm_context->max_session_count));
+
+  //
+  // Unlink the session from the hash bucket or from the free list.
+  //
+  if (session_info->session_id != INVALID_SESSION_ID) {
+    spdm_session_hash_remove (spdm_context, session_info);
+    spdm_context->session_count--;
+  } else {
+    spdm_session_free_list_remove (spdm_context, session_info);
+  }
+
+  //
+  // Release the transcript buffers to the arena before the session info is cleared.
+  //
+  reset_managed_buffer (&session_info->session_transcript.message_k);
+  reset_managed_buffer (&session_info->session_transcript.message_f);
   zero_mem (session_info, OFFSET_OF(spdm_session_info_t, secured_message_context));
+  init_arena_managed_buffer (&session_info->session_transcript.message_k, &spdm_context->arena);
+  init_arena_managed_buffer (&session_info->session_transcript.message_f, &spdm_context->arena);
+  spdm_transcript_hash_reset (&session_info->session_transcript.digest_th);
+
+  if (session_id == INVALID_SESSION_ID) {
+    if (session_info->secured_message_context != NULL) {
+      spdm_secured_message_deinit_context (session_info->secured_message_context);
+      spdm_secured_message_init_context (session_info->secured_message_context);
+    }
+    spdm_session_free_list_insert (spdm_context, session_info);
+    return TRUE;
+  }
+
+  if (session_info->secured_message_context == NULL) {
+    session_info->secured_message_context = spdm_arena_allocate (&spdm_context->arena, spdm_secured_message_get_context_size(), NULL);
+    if (session_info->secured_message_context == NULL) {
+      spdm_session_free_list_insert (spdm_context, session_info);
+      return FALSE;
+    }
+  } else {
+    spdm_secured_message_deinit_context (session_info->secured_message_context);
+  }
   spdm_secured_message_init_context (session_info->secured_message_context);
   session_info->session_id = session_id;
   session_info->use_psk    = use_psk;
@@ -66,8 +412,10 @@ spdm_session_info_init (
     spdm_context->local_context.psk_hint,
     spdm_context->local_context.psk_hint_size
     );
-  session_info->session_transcript.message_k.max_buffer_size = MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE;
-  session_info->session_transcript.message_f.max_buffer_size = MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE;
+
+  spdm_session_hash_insert (spdm_context, session_info);
+  spdm_context->session_count++;
+  return TRUE;
 }
 
 /**
@@ -86,7 +434,6 @@ spdm_get_session_info_via_session_id (
 {
   spdm_context_t        *spdm_context;
   spdm_session_info_t          *session_info;
-  uintn                      index;
 
   if (session_id == INVALID_SESSION_ID) {
     DEBUG ((DEBUG_ERROR, "spdm_get_session_info_via_session_id - Invalid session_id\n"));
@@ -96,11 +443,9 @@ spdm_get_session_info_via_session_id (
 
   spdm_context = context;
 
-  session_info = spdm_context->session_info;
-  for (index = 0; index < MAX_SPDM_SESSION_COUNT; index++) {
-    if (session_info[index].session_id == session_id) {
-      return &session_info[index];
-    }
+  session_info = spdm_session_hash_find (spdm_context, session_id);
+  if (session_info != NULL) {
+    return session_info;
   }
 
   DEBUG ((DEBUG_ERROR, "spdm_get_session_info_via_session_id - not found session_id\n"));
@@ -170,7 +515,6 @@ spdm_assign_session_id (
 {
   spdm_context_t        *spdm_context;
   spdm_session_info_t          *session_info;
-  uintn                      index;
 
   spdm_context = context;
 
@@ -180,26 +524,28 @@ spdm_assign_session_id (
     return NULL;
   }
 
-  session_info = spdm_context->session_info;
-
-  for (index = 0; index < MAX_SPDM_SESSION_COUNT; index++) {
-    if (session_info[index].session_id == session_id) {
-      DEBUG ((DEBUG_ERROR, "spdm_assign_session_id - Duplicated session_id\n"));
-      ASSERT(FALSE);
-      return NULL;
-    }
+  spdm_session_table_lock (spdm_context);
+  if (spdm_session_hash_find (spdm_context, session_id) != NULL) {
+    spdm_session_table_unlock (spdm_context);
+    DEBUG ((DEBUG_ERROR, "spdm_assign_session_id - Duplicated session_id\n"));
+    ASSERT(FALSE);
+    return NULL;
   }
 
-  for (index = 0; index < MAX_SPDM_SESSION_COUNT; index++) {
-    if (session_info[index].session_id == INVALID_SESSION_ID) {
-      spdm_session_info_init (spdm_context, &session_info[index], session_id, use_psk);
-      spdm_context->latest_session_id = session_id;
-      return &session_info[index];
-    }
+  session_info = spdm_context->session_free_list;
+  if (session_info == NULL) {
+    spdm_session_table_unlock (spdm_context);
+    DEBUG ((DEBUG_ERROR, "spdm_assign_session_id - MAX session_id\n"));
+    return NULL;
   }
-
-  DEBUG ((DEBUG_ERROR, "spdm_assign_session_id - MAX session_id\n"));
-  return NULL;
+  if (!spdm_session_info_init (spdm_context, session_info, session_id, use_psk)) {
+    spdm_session_table_unlock (spdm_context);
+    DEBUG ((DEBUG_ERROR, "spdm_assign_session_id - out of resources\n"));
+    return NULL;
+  }
+  spdm_context->latest_session_id = session_id;
+  spdm_session_table_unlock (spdm_context);
+  return session_info;
 }
 
 /**
@@ -218,12 +564,14 @@ spdm_allocate_req_session_id (
   spdm_session_info_t          *session_info;
   uintn                      index;
 
-  session_info = spdm_context->session_info;
-  for (index = 0; index < MAX_SPDM_SESSION_COUNT; index++) {
-    if ((session_info[index].session_id & 0xFFFF0000) == (INVALID_SESSION_ID & 0xFFFF0000)) {
-      req_session_id = (uint16)(0xFFFF - index);
-      return req_session_id;
-    }
+  //
+  // The half of session ID is derived from the index of the free session that is assigned next.
+  //
+  session_info = spdm_context->session_free_list;
+  if (session_info != NULL) {
+    index = session_info - spdm_context->session_info;
+    req_session_id = (uint16)(0xFFFF - index);
+    return req_session_id;
   }
 
   DEBUG ((DEBUG_ERROR, "spdm_allocate_req_session_id - MAX session_id\n"));
@@ -246,12 +594,14 @@ spdm_allocate_rsp_session_id (
   spdm_session_info_t          *session_info;
   uintn                      index;
 
-  session_info = spdm_context->session_info;
-  for (index = 0; index < MAX_SPDM_SESSION_COUNT; index++) {
-    if ((session_info[index].session_id & 0xFFFF) == (INVALID_SESSION_ID & 0xFFFF)) {
-      rsp_session_id = (uint16)(0xFFFF - index);
-      return rsp_session_id;
-    }
+  //
+  // The half of session ID is derived from the index of the free session that is assigned next.
+  //
+  session_info = spdm_context->session_free_list;
+  if (session_info != NULL) {
+    index = session_info - spdm_context->session_info;
+    rsp_session_id = (uint16)(0xFFFF - index);
+    return rsp_session_id;
   }
 
   DEBUG ((DEBUG_ERROR, "spdm_allocate_rsp_session_id - MAX session_id\n"));
@@ -274,7 +624,6 @@ spdm_free_session_id (
 {
   spdm_context_t        *spdm_context;
   spdm_session_info_t          *session_info;
-  uintn                      index;
 
   spdm_context = context;
 
@@ -284,13 +633,14 @@ spdm_free_session_id (
     return NULL;
   }
 
-  session_info = spdm_context->session_info;
-  for (index = 0; index < MAX_SPDM_SESSION_COUNT; index++) {
-    if (session_info[index].session_id == session_id) {
-      spdm_session_info_init (spdm_context, &session_info[index], INVALID_SESSION_ID, FALSE);
-      return &session_info[index];
-    }
+  spdm_session_table_lock (spdm_context);
+  session_info = spdm_session_hash_find (spdm_context, session_id);
+  if (session_info != NULL) {
+    spdm_session_info_init (spdm_context, session_info, INVALID_SESSION_ID, FALSE);
+    spdm_session_table_unlock (spdm_context);
+    return session_info;
   }
+  spdm_session_table_unlock (spdm_context);
 
   DEBUG ((DEBUG_ERROR, "spdm_free_session_id - MAX session_id\n"));
   ASSERT(FALSE);
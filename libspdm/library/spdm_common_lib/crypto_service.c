@@ -210,13 +210,270 @@ spdm_get_pqc_local_public_key (
   return FALSE;
 }
 
+/**
+  This function returns the peer public key context to verify a classical signature.
+
+  The context is created from the leaf certificate of the peer certificate chain at first use,
+  and it is kept in the connection info until spdm_reset_peer_public_key_context is called.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate if the signature is verified by the requester.
+  @param  context                       The public key context.
+
+  @retval TRUE  The public key context is returned.
+  @retval FALSE The public key context cannot be created.
+**/
+boolean
+spdm_get_peer_asym_public_key_context (
+  IN     spdm_context_t           *spdm_context,
+  IN     boolean                  is_requester,
+     OUT void                     **context
+  )
+{
+  boolean                                   result;
+  uint32                                    base_asym_algo;
+  uint8                                     *cert_chain_data;
+  uintn                                     cert_chain_data_size;
+  uint8                                     *cert_buffer;
+  uintn                                     cert_buffer_size;
+
+  if (is_requester) {
+    base_asym_algo = spdm_context->connection_info.algorithm.base_asym_algo;
+  } else {
+    base_asym_algo = spdm_context->connection_info.algorithm.req_base_asym_alg;
+  }
+
+  if (spdm_context->connection_info.peer_asym_public_key_context != NULL) {
+    if (spdm_context->connection_info.peer_asym_public_key_algo == base_asym_algo) {
+      *context = spdm_context->connection_info.peer_asym_public_key_context;
+      return TRUE;
+    }
+    //
+    // The algorithm is renegotiated.
+    //
+    spdm_asym_free (spdm_context->connection_info.peer_asym_public_key_algo, spdm_context->connection_info.peer_asym_public_key_context);
+    spdm_context->connection_info.peer_asym_public_key_context = NULL;
+  }
+
+  result = spdm_get_peer_cert_chain_data (spdm_context, (void **)&cert_chain_data, &cert_chain_data_size);
+  if (!result) {
+    return FALSE;
+  }
+
+  //
+  // Get leaf cert from cert chain
+  //
+  result = x509_get_cert_from_cert_chain (cert_chain_data, cert_chain_data_size, -1,  &cert_buffer, &cert_buffer_size);
+  if (!result) {
+    return FALSE;
+  }
+
+  if (is_requester) {
+    result = spdm_asym_get_public_key_from_x509 (base_asym_algo, cert_buffer, cert_buffer_size, context);
+  } else {
+    result = spdm_req_asym_get_public_key_from_x509 ((uint16)base_asym_algo, cert_buffer, cert_buffer_size, context);
+  }
+  if (!result) {
+    return FALSE;
+  }
+
+  spdm_context->connection_info.peer_asym_public_key_context = *context;
+  spdm_context->connection_info.peer_asym_public_key_algo = base_asym_algo;
+  return TRUE;
+}
+
+/**
+  This function returns the peer public key context to verify a PQC signature.
+
+  The context is created from the peer PQC public key at first use,
+  and it is kept in the connection info until spdm_reset_peer_public_key_context is called.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate if the signature is verified by the requester.
+  @param  context                       The public key context.
+
+  @retval TRUE  The public key context is returned.
+  @retval FALSE The public key context cannot be created.
+**/
+boolean
+spdm_get_peer_pqc_public_key_context (
+  IN     spdm_context_t           *spdm_context,
+  IN     boolean                  is_requester,
+     OUT void                     **context
+  )
+{
+  boolean                                   result;
+  uint8                                     *pqc_sig_algo;
+  void                                      *pqc_public_key;
+  uintn                                     pqc_public_key_size;
+
+  if (is_requester) {
+    pqc_sig_algo = spdm_context->connection_info.algorithm.pqc_sig_algo;
+  } else {
+    pqc_sig_algo = spdm_context->connection_info.algorithm.pqc_req_sig_algo;
+  }
+
+  if (spdm_context->connection_info.peer_pqc_public_key_context != NULL) {
+    if (compare_mem (spdm_context->connection_info.peer_pqc_public_key_algo, pqc_sig_algo, sizeof(pqc_algo_t)) == 0) {
+      *context = spdm_context->connection_info.peer_pqc_public_key_context;
+      return TRUE;
+    }
+    //
+    // The algorithm is renegotiated.
+    //
+    spdm_pqc_sig_free (spdm_context->connection_info.peer_pqc_public_key_algo, spdm_context->connection_info.peer_pqc_public_key_context);
+    spdm_context->connection_info.peer_pqc_public_key_context = NULL;
+  }
+
+  result = spdm_get_pqc_peer_public_key (spdm_context, &pqc_public_key, &pqc_public_key_size);
+  if (!result) {
+    return FALSE;
+  }
+
+  if (is_requester) {
+    result = spdm_pqc_sig_set_public_key (pqc_sig_algo, pqc_public_key, pqc_public_key_size, context);
+  } else {
+    result = spdm_pqc_req_sig_set_public_key (pqc_sig_algo, pqc_public_key, pqc_public_key_size, context);
+  }
+  if (!result) {
+    return FALSE;
+  }
+
+  spdm_context->connection_info.peer_pqc_public_key_context = *context;
+  copy_mem (spdm_context->connection_info.peer_pqc_public_key_algo, pqc_sig_algo, sizeof(pqc_algo_t));
+  return TRUE;
+}
+
+/**
+  This function returns the peer public key context to verify a hybrid signature.
+
+  The context is created from the leaf certificate of the peer certificate chain at first use,
+  and it is kept in the connection info until spdm_reset_peer_public_key_context is called.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  context                       The public key context.
+
+  @retval TRUE  The public key context is returned.
+  @retval FALSE The public key context cannot be created.
+**/
+boolean
+spdm_get_peer_hybrid_public_key_context (
+  IN     spdm_context_t           *spdm_context,
+     OUT void                     **context
+  )
+{
+  boolean                                   result;
+  uint8                                     *cert_chain_data;
+  uintn                                     cert_chain_data_size;
+  uint8                                     *cert_buffer;
+  uintn                                     cert_buffer_size;
+
+  if (spdm_context->connection_info.peer_hybrid_public_key_context != NULL) {
+    *context = spdm_context->connection_info.peer_hybrid_public_key_context;
+    return TRUE;
+  }
+
+  result = spdm_get_peer_cert_chain_data (spdm_context, (void **)&cert_chain_data, &cert_chain_data_size);
+  if (!result) {
+    return FALSE;
+  }
+
+  //
+  // Get leaf cert from cert chain
+  //
+  result = x509_get_cert_from_cert_chain (cert_chain_data, cert_chain_data_size, -1,  &cert_buffer, &cert_buffer_size);
+  if (!result) {
+    return FALSE;
+  }
+
+  result = spdm_hybrid_get_public_key_from_x509 (cert_buffer, cert_buffer_size, context);
+  if (!result) {
+    return FALSE;
+  }
+
+  spdm_context->connection_info.peer_hybrid_public_key_context = *context;
+  return TRUE;
+}
+
+/**
+  This function frees the cached peer public key contexts.
+
+  It must be called when the peer certificate chain or the peer PQC public key is changed.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_reset_peer_public_key_context (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  if (spdm_context->connection_info.peer_asym_public_key_context != NULL) {
+    spdm_asym_free (spdm_context->connection_info.peer_asym_public_key_algo, spdm_context->connection_info.peer_asym_public_key_context);
+    spdm_context->connection_info.peer_asym_public_key_context = NULL;
+  }
+  if (spdm_context->connection_info.peer_pqc_public_key_context != NULL) {
+    spdm_pqc_sig_free (spdm_context->connection_info.peer_pqc_public_key_algo, spdm_context->connection_info.peer_pqc_public_key_context);
+    spdm_context->connection_info.peer_pqc_public_key_context = NULL;
+  }
+  if (spdm_context->connection_info.peer_hybrid_public_key_context != NULL) {
+    spdm_hybrid_sig_free (spdm_context->connection_info.peer_hybrid_public_key_context);
+    spdm_context->connection_info.peer_hybrid_public_key_context = NULL;
+  }
+}
+
+/**
+  This function sets the peer used certificate chain buffer including spdm_cert_chain_t header.
+
+  The buffer is allocated from the arena, and the previous buffer is released to the arena.
+  The cached peer public key contexts are reset.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  cert_chain_buffer             Certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size        size in bytes of the certificate chain buffer.
+                                        The buffer is released if it is 0.
+
+  @retval TRUE  The peer used certificate chain buffer is set.
+  @retval FALSE The buffer is too large, or it cannot be allocated from the arena.
+**/
+boolean
+spdm_set_peer_used_cert_chain_buffer (
+  IN OUT spdm_context_t           *spdm_context,
+  IN     const void               *cert_chain_buffer,
+  IN     uintn                    cert_chain_buffer_size
+  )
+{
+  uint8  *buffer;
+
+  if (cert_chain_buffer_size > MAX_SPDM_CERT_CHAIN_SIZE) {
+    return FALSE;
+  }
+
+  buffer = NULL;
+  if (cert_chain_buffer_size != 0) {
+    buffer = spdm_arena_allocate (&spdm_context->arena, cert_chain_buffer_size, NULL);
+    if (buffer == NULL) {
+      return FALSE;
+    }
+    copy_mem (buffer, cert_chain_buffer, cert_chain_buffer_size);
+  }
+
+  spdm_arena_free (&spdm_context->arena, spdm_context->connection_info.peer_used_cert_chain_buffer);
+  spdm_context->connection_info.peer_used_cert_chain_buffer = buffer;
+  spdm_context->connection_info.peer_used_cert_chain_buffer_size = cert_chain_buffer_size;
+  spdm_reset_peer_public_key_context (spdm_context);
+  return TRUE;
+}
+
 /*
   This function calculates m1m2.
 
+  The m1m2 is returned as segments which refer to the transcript, instead of being copied into one buffer.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  is_mut                        Indicate if this is from mutual authentication.
-  @param  m1m2_buffer_size               size in bytes of the m1m2
-  @param  m1m2_buffer                   The buffer to store the m1m2
+  @param  m1m2_segment_count             On input, the number of entries in m1m2_segment.
+                                       On output, the number of segments of the m1m2.
+  @param  m1m2_segment                  The segments of the m1m2
 
   @retval RETURN_SUCCESS  m1m2 is calculated.
 */
@@ -224,20 +481,17 @@ boolean
 spdm_calculate_m1m2 (
   IN     void                   *context,
   IN     boolean                is_mut,
-  IN OUT uintn                  *m1m2_buffer_size,
-     OUT void                   *m1m2_buffer
+  IN OUT uintn                  *m1m2_segment_count,
+     OUT spdm_data_segment_t    *m1m2_segment
   )
 {
   spdm_context_t           *spdm_context;
-  return_status                 status;
   uint32                        hash_size;
   uint8                         hash_data[MAX_HASH_SIZE];
-  large_managed_buffer_t          m1m2;
 
   spdm_context = context;
 
-  ASSERT (*m1m2_buffer_size >= MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE);
-  init_managed_buffer (&m1m2, MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE);
+  ASSERT (*m1m2_segment_count >= MAX_SPDM_M1M2_SEGMENT_COUNT);
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
 
@@ -245,20 +499,16 @@ spdm_calculate_m1m2 (
 
     DEBUG((DEBUG_INFO, "message_mut_b data :\n"));
     internal_dump_hex (get_managed_buffer(&spdm_context->transcript.message_mut_b), get_managed_buffer_size(&spdm_context->transcript.message_mut_b));
-    status = append_managed_buffer (&m1m2, get_managed_buffer(&spdm_context->transcript.message_mut_b), get_managed_buffer_size(&spdm_context->transcript.message_mut_b));
-    if (RETURN_ERROR(status)) {
-      return FALSE;
-    }
+    m1m2_segment[0].data = get_managed_buffer(&spdm_context->transcript.message_mut_b);
+    m1m2_segment[0].size = get_managed_buffer_size(&spdm_context->transcript.message_mut_b);
 
     DEBUG((DEBUG_INFO, "message_mut_c data :\n"));
     internal_dump_hex (get_managed_buffer(&spdm_context->transcript.message_mut_c), get_managed_buffer_size(&spdm_context->transcript.message_mut_c));
-    status = append_managed_buffer (&m1m2, get_managed_buffer(&spdm_context->transcript.message_mut_c), get_managed_buffer_size(&spdm_context->transcript.message_mut_c));
-    if (RETURN_ERROR(status)) {
-      return FALSE;
-    }
+    m1m2_segment[1].data = get_managed_buffer(&spdm_context->transcript.message_mut_c);
+    m1m2_segment[1].size = get_managed_buffer_size(&spdm_context->transcript.message_mut_c);
+    *m1m2_segment_count = 2;
 
-    // debug only
-    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, get_managed_buffer(&m1m2), get_managed_buffer_size(&m1m2), hash_data);
+    spdm_calculate_m1m2_hash (spdm_context, is_mut, hash_data);
     DEBUG((DEBUG_INFO, "m1m2 Mut hash - "));
     internal_dump_data (hash_data, hash_size);
     DEBUG((DEBUG_INFO, "\n"));
@@ -267,52 +517,111 @@ spdm_calculate_m1m2 (
 
     DEBUG((DEBUG_INFO, "message_a data :\n"));
     internal_dump_hex (get_managed_buffer(&spdm_context->transcript.message_a), get_managed_buffer_size(&spdm_context->transcript.message_a));
-    status = append_managed_buffer (&m1m2, get_managed_buffer(&spdm_context->transcript.message_a), get_managed_buffer_size(&spdm_context->transcript.message_a));
-    if (RETURN_ERROR(status)) {
-      return FALSE;
-    }
+    m1m2_segment[0].data = get_managed_buffer(&spdm_context->transcript.message_a);
+    m1m2_segment[0].size = get_managed_buffer_size(&spdm_context->transcript.message_a);
 
     DEBUG((DEBUG_INFO, "message_b data :\n"));
     internal_dump_hex (get_managed_buffer(&spdm_context->transcript.message_b), get_managed_buffer_size(&spdm_context->transcript.message_b));
-    status = append_managed_buffer (&m1m2, get_managed_buffer(&spdm_context->transcript.message_b), get_managed_buffer_size(&spdm_context->transcript.message_b));
-    if (RETURN_ERROR(status)) {
-      return FALSE;
-    }
+    m1m2_segment[1].data = get_managed_buffer(&spdm_context->transcript.message_b);
+    m1m2_segment[1].size = get_managed_buffer_size(&spdm_context->transcript.message_b);
 
     DEBUG((DEBUG_INFO, "message_c data :\n"));
     internal_dump_hex (get_managed_buffer(&spdm_context->transcript.message_c), get_managed_buffer_size(&spdm_context->transcript.message_c));
-    status = append_managed_buffer (&m1m2, get_managed_buffer(&spdm_context->transcript.message_c), get_managed_buffer_size(&spdm_context->transcript.message_c));
-    if (RETURN_ERROR(status)) {
-      return FALSE;
-    }
+    m1m2_segment[2].data = get_managed_buffer(&spdm_context->transcript.message_c);
+    m1m2_segment[2].size = get_managed_buffer_size(&spdm_context->transcript.message_c);
+    *m1m2_segment_count = 3;
 
-    // debug only
-    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, get_managed_buffer(&m1m2), get_managed_buffer_size(&m1m2), hash_data);
+    spdm_calculate_m1m2_hash (spdm_context, is_mut, hash_data);
     DEBUG((DEBUG_INFO, "m1m2 hash - "));
     internal_dump_data (hash_data, hash_size);
     DEBUG((DEBUG_INFO, "\n"));
   }
 
-  *m1m2_buffer_size = get_managed_buffer_size(&m1m2);
-  copy_mem (m1m2_buffer, get_managed_buffer(&m1m2), *m1m2_buffer_size);
-
   return TRUE;
 }
 
+/*
+  This function calculates m1m2 hash.
+
+  The running hash of M1M2 only absorbs the data appended since the last calculation.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_mut                        Indicate if this is from mutual authentication.
+  @param  m1m2_hash                     The buffer to store the m1m2 hash
+
+  @retval TRUE  m1m2 hash is calculated.
+*/
+boolean
+spdm_calculate_m1m2_hash (
+  IN     void                   *context,
+  IN     boolean                is_mut,
+     OUT uint8                  *m1m2_hash
+  )
+{
+  spdm_context_t                *spdm_context;
+  spdm_transcript_segment_t     segment[3];
+
+  spdm_context = context;
+
+  zero_mem (segment, sizeof(segment));
+  if (is_mut) {
+    segment[0].data = get_managed_buffer(&spdm_context->transcript.message_mut_b);
+    segment[0].size = get_managed_buffer_size(&spdm_context->transcript.message_mut_b);
+    segment[1].data = get_managed_buffer(&spdm_context->transcript.message_mut_c);
+    segment[1].size = get_managed_buffer_size(&spdm_context->transcript.message_mut_c);
+    return spdm_transcript_hash_calculate (&spdm_context->transcript.digest_mut_m1m2, spdm_context->connection_info.algorithm.bash_hash_algo, segment, 2, m1m2_hash);
+  }
+
+  segment[0].data = get_managed_buffer(&spdm_context->transcript.message_a);
+  segment[0].size = get_managed_buffer_size(&spdm_context->transcript.message_a);
+  segment[1].data = get_managed_buffer(&spdm_context->transcript.message_b);
+  segment[1].size = get_managed_buffer_size(&spdm_context->transcript.message_b);
+  segment[2].data = get_managed_buffer(&spdm_context->transcript.message_c);
+  segment[2].size = get_managed_buffer_size(&spdm_context->transcript.message_c);
+  return spdm_transcript_hash_calculate (&spdm_context->transcript.digest_m1m2, spdm_context->connection_info.algorithm.bash_hash_algo, segment, 3, m1m2_hash);
+}
+
+/*
+  This function calculates l1l2 hash.
+
+  The running hash of L1L2 only absorbs the data appended since the last calculation.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  l1l2_hash                     The buffer to store the l1l2 hash
+
+  @retval TRUE  l1l2 hash is calculated.
+*/
+boolean
+spdm_calculate_l1l2_hash (
+  IN     void                   *context,
+     OUT uint8                  *l1l2_hash
+  )
+{
+  spdm_context_t                *spdm_context;
+  spdm_transcript_segment_t     segment;
+
+  spdm_context = context;
+
+  segment.data = get_managed_buffer(&spdm_context->transcript.message_m);
+  segment.size = get_managed_buffer_size(&spdm_context->transcript.message_m);
+  segment.hash_data = FALSE;
+  return spdm_transcript_hash_calculate (&spdm_context->transcript.digest_l1l2, spdm_context->connection_info.algorithm.bash_hash_algo, &segment, 1, l1l2_hash);
+}
+
 /*
   This function calculates l1l2.
 
+  The l1l2 is returned as a segment which refers to the transcript, instead of being copied into one buffer.
+
   @param  spdm_context                  A pointer to the SPDM context.
-  @param  l1l2_buffer_size               size in bytes of the l1l2
-  @param  l1l2_buffer                   The buffer to store the l1l2
+  @param  l1l2_segment                  The segment of the l1l2
 
   @retval RETURN_SUCCESS  l1l2 is calculated.
 */
 boolean
 spdm_calculate_l1l2 (
   IN     void                   *context,
-  IN OUT uintn                  *l1l2_buffer_size,
-     OUT void                   *l1l2_buffer
+     OUT spdm_data_segment_t    *l1l2_segment
   )
 {
   spdm_context_t           *spdm_context;
@@ -326,20 +635,20 @@ spdm_calculate_l1l2 (
   DEBUG((DEBUG_INFO, "message_m data :\n"));
   internal_dump_hex (get_managed_buffer(&spdm_context->transcript.message_m), get_managed_buffer_size(&spdm_context->transcript.message_m));
 
-  // debug only
-  spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, get_managed_buffer(&spdm_context->transcript.message_m), get_managed_buffer_size(&spdm_context->transcript.message_m), hash_data);
+  spdm_calculate_l1l2_hash (spdm_context, hash_data);
   DEBUG((DEBUG_INFO, "l1l2 hash - "));
   internal_dump_data (hash_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
-  *l1l2_buffer_size = get_managed_buffer_size(&spdm_context->transcript.message_m);
-  copy_mem (l1l2_buffer, get_managed_buffer(&spdm_context->transcript.message_m), *l1l2_buffer_size);
+  l1l2_segment->data = get_managed_buffer(&spdm_context->transcript.message_m);
+  l1l2_segment->size = get_managed_buffer_size(&spdm_context->transcript.message_m);
 
   return TRUE;
 }
 
 /**
   This function generates the certificate chain hash.
+  The hash is cached, and it is generated again only if the certificate chain or the base hash algorithm is changed.
 
   @param  spdm_context                  A pointer to the SPDM context.
   @param  slot_id                    The slot index of the certificate chain.
@@ -355,16 +664,55 @@ spdm_generate_cert_chain_hash (
      OUT uint8                        *hash
   )
 {
+  spdm_cert_chain_hash_cache_t  *cache;
+  uint32                        hash_algo;
+  uintn                         hash_size;
+  boolean                       result;
+
   ASSERT (slot_id < spdm_context->local_context.slot_count);
-  spdm_hash_all (
-    spdm_context->connection_info.algorithm.bash_hash_algo,
-    spdm_context->local_context.local_cert_chain_provision[slot_id],
-    spdm_context->local_context.local_cert_chain_provision_size[slot_id],
-    hash
-    );
+  hash_algo = spdm_context->connection_info.algorithm.bash_hash_algo;
+  hash_size = spdm_get_hash_size (hash_algo);
+  cache = &spdm_context->response_cache.cert_chain_hash[slot_id];
+  if (cache->valid &&
+      (cache->hash_algo == hash_algo) &&
+      (cache->cert_chain == spdm_context->local_context.local_cert_chain_provision[slot_id]) &&
+      (cache->cert_chain_size == spdm_context->local_context.local_cert_chain_provision_size[slot_id])) {
+    copy_mem (hash, cache->hash, hash_size);
+    return TRUE;
+  }
+
+  cache->valid = FALSE;
+  result = spdm_hash_all (
+             hash_algo,
+             spdm_context->local_context.local_cert_chain_provision[slot_id],
+             spdm_context->local_context.local_cert_chain_provision_size[slot_id],
+             hash
+             );
+  if (!result) {
+    return FALSE;
+  }
+
+  cache->hash_algo = hash_algo;
+  cache->cert_chain = spdm_context->local_context.local_cert_chain_provision[slot_id];
+  cache->cert_chain_size = spdm_context->local_context.local_cert_chain_provision_size[slot_id];
+  copy_mem (cache->hash, hash, hash_size);
+  cache->valid = TRUE;
   return TRUE;
 }
 
+/**
+  This function invalidates the cached data of the responses, once the provisioned data is changed.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_reset_response_cache (
+  IN     spdm_context_t          *spdm_context
+  )
+{
+  zero_mem (&spdm_context->response_cache, sizeof(spdm_context->response_cache));
+}
+
 /**
   This function verifies the digest.
 
@@ -387,19 +735,232 @@ spdm_verify_peer_digests (
   uint8                                     *cert_chain_buffer;
   uintn                                     cert_chain_buffer_size;
 
-  cert_chain_buffer = spdm_context->local_context.peer_cert_chain_provision;
-  cert_chain_buffer_size = spdm_context->local_context.peer_cert_chain_provision_size;
-  if ((cert_chain_buffer != NULL) && (cert_chain_buffer_size != 0)) {
-    hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
-    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, cert_chain_buffer, cert_chain_buffer_size, cert_chain_buffer_hash);
+  cert_chain_buffer = spdm_context->local_context.peer_cert_chain_provision;
+  cert_chain_buffer_size = spdm_context->local_context.peer_cert_chain_provision_size;
+  if ((cert_chain_buffer != NULL) && (cert_chain_buffer_size != 0)) {
+    hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
+    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, cert_chain_buffer, cert_chain_buffer_size, cert_chain_buffer_hash);
+
+    if (compare_mem (digest, cert_chain_buffer_hash, hash_size) != 0) {
+      DEBUG((DEBUG_INFO, "!!! verify_peer_digests - FAIL !!!\n"));
+      return FALSE;
+    }
+  }
+
+  DEBUG((DEBUG_INFO, "!!! verify_peer_digests - PASS !!!\n"));
+
+  return TRUE;
+}
+
+/**
+  This function verifies peer certificate chain buffer with the provisioned peer root certificate hash
+  or the provisioned peer certificate chain.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  cert_chain_buffer              Certitiface chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certitiface chain buffer.
+  @param  is_complete                   Indicate if the certificate chain buffer is completely received,
+                                       or only the beginning part is received.
+
+  @retval TRUE  Peer certificate chain buffer verification passed.
+  @retval FALSE Peer certificate chain buffer verification failed.
+**/
+boolean
+spdm_verify_peer_cert_chain_provision (
+  IN spdm_context_t          *spdm_context,
+  IN void                         *cert_chain_buffer,
+  IN uintn                        cert_chain_buffer_size,
+  IN boolean                      is_complete
+  )
+{
+  uint8                                     *cert_chain_data;
+  uintn                                     cert_chain_data_size;
+  uintn                                     hash_size;
+  uint8                                     *RootCertHash;
+  uintn                                     RootCertHashSize;
+
+  RootCertHash = spdm_context->local_context.peer_root_cert_hash_provision;
+  RootCertHashSize = spdm_context->local_context.peer_root_cert_hash_provision_size;
+  cert_chain_data = spdm_context->local_context.peer_cert_chain_provision;
+  cert_chain_data_size = spdm_context->local_context.peer_cert_chain_provision_size;
+
+  if ((RootCertHash != NULL) && (RootCertHashSize != 0)) {
+    hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
+    if (RootCertHashSize != hash_size) {
+      DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL (hash size mismatch) !!!\n"));
+      return FALSE;
+    }
+    //
+    // The root hash is checked as soon as it is received.
+    //
+    if (cert_chain_buffer_size < sizeof(spdm_cert_chain_t) + hash_size) {
+      return !is_complete;
+    }
+    if (compare_mem ((uint8 *)cert_chain_buffer + sizeof(spdm_cert_chain_t), RootCertHash, hash_size) != 0) {
+      DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL (root hash mismatch) !!!\n"));
+      return FALSE;
+    }
+  } else if ((cert_chain_data != NULL) && (cert_chain_data_size != 0)) {
+    if ((cert_chain_data_size < cert_chain_buffer_size) ||
+        (is_complete && (cert_chain_data_size != cert_chain_buffer_size))) {
+      DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL !!!\n"));
+      return FALSE;
+    }
+    if (compare_mem (cert_chain_buffer, cert_chain_data, cert_chain_buffer_size) != 0) {
+      DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL !!!\n"));
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  This function verifies the received part of peer certificate chain buffer including spdm_cert_chain_t header,
+  so that the certificate chain transfer can be stopped at the first certificate which fails the verification.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              The received part of certitiface chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the received part of certitiface chain buffer.
+
+  @retval TRUE  The received part of peer certificate chain buffer verification passed.
+  @retval FALSE The received part of peer certificate chain buffer verification failed.
+**/
+boolean
+spdm_verify_peer_cert_chain_buffer_update (
+  IN spdm_context_t                     *spdm_context,
+  IN spdm_cert_chain_verify_context_t   *verify_context,
+  IN void                               *cert_chain_buffer,
+  IN uintn                              cert_chain_buffer_size
+  )
+{
+  if (!spdm_verify_peer_cert_chain_provision (spdm_context, cert_chain_buffer, cert_chain_buffer_size, FALSE)) {
+    return FALSE;
+  }
+  return spdm_cert_chain_verify_update (verify_context, cert_chain_buffer, cert_chain_buffer_size);
+}
+
+typedef struct {
+  spdm_cert_chain_link_t       link;
+  boolean                      result;
+} spdm_verify_link_job_context_t;
+
+/**
+  The job to verify one link of a certificate chain.
+
+  @param  context                       The verify link job context.
+**/
+void
+spdm_verify_cert_chain_link_job (
+  IN void  *context
+  )
+{
+  spdm_verify_link_job_context_t  *job_context;
+
+  job_context = context;
+  job_context->result = spdm_verify_cert_chain_link (&job_context->link);
+}
+
+/**
+  This function verifies the links of peer certificate chain buffer which are not verified yet.
+
+  The links are independent of each other once the chain is split,
+  so they are verified in parallel if the worker pool is enabled.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              Certitiface chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certitiface chain buffer.
+
+  @retval TRUE  The links pass the verification.
+  @retval FALSE A link fails the verification.
+**/
+boolean
+spdm_verify_peer_cert_chain_links (
+  IN spdm_context_t                     *spdm_context,
+  IN spdm_cert_chain_verify_context_t   *verify_context,
+  IN void                               *cert_chain_buffer,
+  IN uintn                              cert_chain_buffer_size
+  )
+{
+  spdm_cert_chain_link_t          link[MAX_SPDM_WORKER_JOB_COUNT];
+  spdm_verify_link_job_context_t  job_context[MAX_SPDM_WORKER_JOB_COUNT];
+  spdm_job_t                      job[MAX_SPDM_WORKER_JOB_COUNT];
+  uintn                           link_count;
+  uintn                           index;
+
+  if (cert_chain_buffer_size > MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE) {
+    return FALSE;
+  }
+
+  //
+  // A chain deeper than the job queue is verified batch by batch.
+  //
+  while (TRUE) {
+    link_count = MAX_SPDM_WORKER_JOB_COUNT;
+    if (!spdm_cert_chain_verify_get_links (verify_context, cert_chain_buffer, cert_chain_buffer_size, link, &link_count)) {
+      return FALSE;
+    }
+    if (link_count == 0) {
+      break;
+    }
+    for (index = 0; index < link_count; index++) {
+      copy_mem (&job_context[index].link, &link[index], sizeof(spdm_cert_chain_link_t));
+      job_context[index].result = FALSE;
+      job[index].func = spdm_verify_cert_chain_link_job;
+      job[index].context = &job_context[index];
+    }
+    spdm_run_jobs (spdm_context, job, link_count);
+    for (index = 0; index < link_count; index++) {
+      if (!job_context[index].result) {
+        DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL (cert chain verify failed at cert %d)!!!\n", verify_context->cert_count - link_count + index));
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  This function completes the verification of peer certificate chain buffer including spdm_cert_chain_t header.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              Certitiface chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certitiface chain buffer.
 
-    if (compare_mem (digest, cert_chain_buffer_hash, hash_size) != 0) {
-      DEBUG((DEBUG_INFO, "!!! verify_peer_digests - FAIL !!!\n"));
+  @retval TRUE  Peer certificate chain buffer verification passed.
+  @retval FALSE Peer certificate chain buffer verification failed.
+**/
+boolean
+spdm_verify_peer_cert_chain_buffer_final (
+  IN spdm_context_t                     *spdm_context,
+  IN spdm_cert_chain_verify_context_t   *verify_context,
+  IN void                               *cert_chain_buffer,
+  IN uintn                              cert_chain_buffer_size
+  )
+{
+  //
+  // Verify the links not verified during the transfer in parallel,
+  // then spdm_cert_chain_verify_final only checks the leaf certificate.
+  //
+  if (spdm_context->worker_pool.thread_count != 0) {
+    if (!spdm_verify_peer_cert_chain_links (spdm_context, verify_context, cert_chain_buffer, cert_chain_buffer_size)) {
       return FALSE;
     }
   }
 
-  DEBUG((DEBUG_INFO, "!!! verify_peer_digests - PASS !!!\n"));
+  if (!spdm_cert_chain_verify_final (verify_context, cert_chain_buffer, cert_chain_buffer_size)) {
+    return FALSE;
+  }
+
+  if (!spdm_verify_peer_cert_chain_provision (spdm_context, cert_chain_buffer, cert_chain_buffer_size, TRUE)) {
+    return FALSE;
+  }
+
+  DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - PASS !!!\n"));
 
   return TRUE;
 }
@@ -421,47 +982,170 @@ spdm_verify_peer_cert_chain_buffer (
   IN uintn                        cert_chain_buffer_size
   )
 {
-  uint8                                     *cert_chain_data;
-  uintn                                     cert_chain_data_size;
-  uintn                                     hash_size;
-  uint8                                     *RootCertHash;
-  uintn                                     RootCertHashSize;
-  boolean                                   result;
+  spdm_cert_chain_verify_context_t          verify_context;
 
-  result = spdm_verify_certificate_chain_buffer (spdm_context->connection_info.algorithm.bash_hash_algo, cert_chain_buffer, cert_chain_buffer_size);
-  if (!result) {
-    return FALSE;
+  spdm_cert_chain_verify_init (&verify_context, spdm_context->connection_info.algorithm.bash_hash_algo);
+  return spdm_verify_peer_cert_chain_buffer_final (spdm_context, &verify_context, cert_chain_buffer, cert_chain_buffer_size);
+}
+
+typedef struct {
+  spdm_context_t               *spdm_context;
+  boolean                      is_requester;
+  const spdm_data_segment_t    *segment;
+  uintn                        segment_count;
+  uint8                        *signature;
+  uintn                        signature_size;
+  boolean                      result;
+} spdm_sign_job_context_t;
+
+/**
+  The job to generate the classical half of a RAW mode signature.
+
+  @param  context                       The sign job context.
+**/
+void
+spdm_asym_sign_job (
+  IN void  *context
+  )
+{
+  spdm_sign_job_context_t  *job_context;
+
+  job_context = context;
+  if (job_context->is_requester) {
+    job_context->result = spdm_requester_data_sign_segments (
+                            job_context->spdm_context->connection_info.algorithm.req_base_asym_alg,
+                            job_context->spdm_context->connection_info.algorithm.bash_hash_algo,
+                            job_context->segment,
+                            job_context->segment_count,
+                            job_context->signature,
+                            &job_context->signature_size
+                            );
+  } else {
+    job_context->result = spdm_responder_data_sign_segments (
+                            job_context->spdm_context->connection_info.algorithm.base_asym_algo,
+                            job_context->spdm_context->connection_info.algorithm.bash_hash_algo,
+                            job_context->segment,
+                            job_context->segment_count,
+                            job_context->signature,
+                            &job_context->signature_size
+                            );
   }
+}
 
-  RootCertHash = spdm_context->local_context.peer_root_cert_hash_provision;
-  RootCertHashSize = spdm_context->local_context.peer_root_cert_hash_provision_size;
-  cert_chain_data = spdm_context->local_context.peer_cert_chain_provision;
-  cert_chain_data_size = spdm_context->local_context.peer_cert_chain_provision_size;
+/**
+  The job to generate the PQC half of a RAW mode signature.
 
-  if ((RootCertHash != NULL) && (RootCertHashSize != 0)) {
-    hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
-    if (RootCertHashSize != hash_size) {
-      DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL (hash size mismatch) !!!\n"));
-      return FALSE;
-    }
-    if (compare_mem ((uint8 *)cert_chain_buffer + sizeof(spdm_cert_chain_t), RootCertHash, hash_size) != 0) {
-      DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL (root hash mismatch) !!!\n"));
-      return FALSE;
-    }
-  } else if ((cert_chain_data != NULL) && (cert_chain_data_size != 0)) {
-    if (cert_chain_data_size != cert_chain_buffer_size) {
-      DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL !!!\n"));
-      return FALSE;
-    }
-    if (compare_mem (cert_chain_buffer, cert_chain_data, cert_chain_buffer_size) != 0) {
-      DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - FAIL !!!\n"));
-      return FALSE;
-    }
+  @param  context                       The sign job context.
+**/
+void
+spdm_pqc_sig_sign_job (
+  IN void  *context
+  )
+{
+  spdm_sign_job_context_t  *job_context;
+
+  job_context = context;
+  if (job_context->is_requester) {
+    job_context->result = spdm_pqc_requester_data_sign_segments (
+                            job_context->spdm_context->connection_info.algorithm.pqc_req_sig_algo,
+                            job_context->segment,
+                            job_context->segment_count,
+                            job_context->signature,
+                            &job_context->signature_size
+                            );
+  } else {
+    job_context->result = spdm_pqc_responder_data_sign_segments (
+                            job_context->spdm_context->connection_info.algorithm.pqc_sig_algo,
+                            job_context->segment,
+                            job_context->segment_count,
+                            job_context->signature,
+                            &job_context->signature_size
+                            );
   }
+}
 
-  DEBUG((DEBUG_INFO, "!!! verify_peer_cert_chain_buffer - PASS !!!\n"));
+/**
+  This function generates a RAW mode signature, which is
+  classical signature || 4 bytes PQC signature size || PQC signature.
 
-  return TRUE;
+  The classical signature has a fixed size, so the two halves are written to
+  their own part of the signature buffer, and they are generated in parallel
+  if the worker pool is enabled.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate of the signature generation for a requester or a responder.
+  @param  segment                       The segments of the message to be signed.
+  @param  segment_count                 The count of the segments.
+  @param  need_pqc_sig                  Indicate if the PQC signature is generated.
+  @param  signature                     The buffer to store the signature.
+  @param  asym_signature_size           size in bytes of the classical signature.
+  @param  pqc_signature_size            size in bytes of the PQC signature.
+
+  @retval TRUE  The signature is generated.
+  @retval FALSE The signature is not generated.
+**/
+boolean
+spdm_generate_raw_mode_signature (
+  IN     spdm_context_t               *spdm_context,
+  IN     boolean                      is_requester,
+  IN     const spdm_data_segment_t    *segment,
+  IN     uintn                        segment_count,
+  IN     boolean                      need_pqc_sig,
+     OUT uint8                        *signature,
+     OUT uintn                        *asym_signature_size,
+     OUT uintn                        *pqc_signature_size
+  )
+{
+  spdm_sign_job_context_t  job_context[2];
+  spdm_job_t               job[2];
+  uintn                    job_count;
+  uint32                   *pqc_sigature_length_ptr;
+
+  zero_mem (job_context, sizeof(job_context));
+
+  job_context[0].spdm_context = spdm_context;
+  job_context[0].is_requester = is_requester;
+  job_context[0].segment = segment;
+  job_context[0].segment_count = segment_count;
+  job_context[0].signature = signature;
+  if (is_requester) {
+    job_context[0].signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg);
+  } else {
+    job_context[0].signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo);
+  }
+  job[0].func = spdm_asym_sign_job;
+  job[0].context = &job_context[0];
+  job_count = 1;
+
+  pqc_sigature_length_ptr = (uint32 *)(signature + job_context[0].signature_size);
+
+  job_context[1].spdm_context = spdm_context;
+  job_context[1].is_requester = is_requester;
+  job_context[1].segment = segment;
+  job_context[1].segment_count = segment_count;
+  job_context[1].signature = (uint8 *)(pqc_sigature_length_ptr + 1);
+  if (is_requester) {
+    job_context[1].signature_size = spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
+  } else {
+    job_context[1].signature_size = spdm_get_pqc_sig_signature_size (spdm_context->connection_info.algorithm.pqc_sig_algo);
+  }
+  if (need_pqc_sig) {
+    job[1].func = spdm_pqc_sig_sign_job;
+    job[1].context = &job_context[1];
+    job_count = 2;
+  } else {
+    job_context[1].result = TRUE;
+  }
+
+  spdm_run_jobs (spdm_context, job, job_count);
+
+  if (!job_context[0].result) {
+    return FALSE;
+  }
+  *pqc_sigature_length_ptr = (uint32)job_context[1].signature_size;
+  *asym_signature_size = job_context[0].signature_size;
+  *pqc_signature_size = job_context[1].signature_size;
+  return job_context[1].result;
 }
 
 /**
@@ -484,57 +1168,39 @@ spdm_generate_challenge_auth_signature (
   boolean                       result;
   uintn                         asym_signature_size;
   uintn                         pqc_signature_size;
-  uint8                         m1m2_buffer[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                         m1m2_buffer_size;
-  uint32                        *pqc_sigature_length_ptr;
+  spdm_data_segment_t             m1m2_segment[MAX_SPDM_M1M2_SEGMENT_COUNT];
+  uintn                         m1m2_segment_count;
   boolean                       need_pqc_sig;
 
-  m1m2_buffer_size = sizeof(m1m2_buffer);
-  result = spdm_calculate_m1m2 (spdm_context, is_requester, &m1m2_buffer_size, &m1m2_buffer);
+  m1m2_segment_count = ARRAY_SIZE(m1m2_segment);
+  result = spdm_calculate_m1m2 (spdm_context, is_requester, &m1m2_segment_count, m1m2_segment);
   if (!result) {
     return FALSE;
   }
 
   if (is_requester) {
     if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
-      asym_signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg);
-      result = spdm_requester_data_sign (
-                spdm_context->connection_info.algorithm.req_base_asym_alg,
-                spdm_context->connection_info.algorithm.bash_hash_algo,
-                m1m2_buffer,
-                m1m2_buffer_size,
+      need_pqc_sig = !spdm_pqc_algo_is_zero (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
+      result = spdm_generate_raw_mode_signature (
+                spdm_context,
+                TRUE,
+                m1m2_segment,
+                m1m2_segment_count,
+                need_pqc_sig,
                 signature,
-                &asym_signature_size
+                &asym_signature_size,
+                &pqc_signature_size
                 );
-      if (!result) {
-        return FALSE;
-      }
-
-      pqc_sigature_length_ptr = (uint32 *)(signature + asym_signature_size);
-      pqc_signature_size = spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
-      need_pqc_sig = !spdm_pqc_algo_is_zero (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
-      if (need_pqc_sig) {
-        result = spdm_pqc_requester_data_sign (
-                  spdm_context->connection_info.algorithm.pqc_req_sig_algo,
-                  m1m2_buffer,
-                  m1m2_buffer_size,
-                  (uint8 *)(pqc_sigature_length_ptr + 1),
-                  &pqc_signature_size
-                  );
-      } else {
-        result = TRUE;
-      }
-      *pqc_sigature_length_ptr = (uint32)pqc_signature_size;
     } else {
       asym_signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg) +
                             PQC_SIG_SIGNATURE_LENGTH_SIZE +
                             spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
-      result = spdm_hybrid_requester_data_sign (
+      result = spdm_hybrid_requester_data_sign_segments (
                 spdm_context->connection_info.algorithm.req_base_asym_alg,
                 spdm_context->connection_info.algorithm.bash_hash_algo,
                 spdm_context->connection_info.algorithm.pqc_req_sig_algo,
-                m1m2_buffer,
-                m1m2_buffer_size,
+                m1m2_segment,
+                m1m2_segment_count,
                 signature,
                 &asym_signature_size
                 );
@@ -544,44 +1210,27 @@ spdm_generate_challenge_auth_signature (
     }
   } else {
     if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
-      asym_signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo);
-      result = spdm_responder_data_sign (
-                spdm_context->connection_info.algorithm.base_asym_algo,
-                spdm_context->connection_info.algorithm.bash_hash_algo,
-                m1m2_buffer,
-                m1m2_buffer_size,
+      need_pqc_sig = !spdm_pqc_algo_is_zero (spdm_context->connection_info.algorithm.pqc_sig_algo);
+      result = spdm_generate_raw_mode_signature (
+                spdm_context,
+                FALSE,
+                m1m2_segment,
+                m1m2_segment_count,
+                need_pqc_sig,
                 signature,
-                &asym_signature_size
+                &asym_signature_size,
+                &pqc_signature_size
                 );
-      if (!result) {
-        return FALSE;
-      }
-
-      pqc_sigature_length_ptr = (uint32 *)(signature + asym_signature_size);
-      pqc_signature_size = spdm_get_pqc_sig_signature_size (spdm_context->connection_info.algorithm.pqc_sig_algo);
-      need_pqc_sig = !spdm_pqc_algo_is_zero (spdm_context->connection_info.algorithm.pqc_sig_algo);
-      if (need_pqc_sig) {
-        result = spdm_pqc_responder_data_sign (
-                  spdm_context->connection_info.algorithm.pqc_sig_algo,
-                  m1m2_buffer,
-                  m1m2_buffer_size,
-                  (uint8 *)(pqc_sigature_length_ptr + 1),
-                  &pqc_signature_size
-                  );
-      } else {
-        result = TRUE;
-      }
-      *pqc_sigature_length_ptr = (uint32)pqc_signature_size;
     } else {
       asym_signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo) +
                             PQC_SIG_SIGNATURE_LENGTH_SIZE +
                             spdm_get_pqc_sig_signature_size (spdm_context->connection_info.algorithm.pqc_sig_algo);
-      result = spdm_hybrid_responder_data_sign (
+      result = spdm_hybrid_responder_data_sign_segments (
                 spdm_context->connection_info.algorithm.base_asym_algo,
                 spdm_context->connection_info.algorithm.bash_hash_algo,
                 spdm_context->connection_info.algorithm.pqc_sig_algo,
-                m1m2_buffer,
-                m1m2_buffer_size,
+                m1m2_segment,
+                m1m2_segment_count,
                 signature,
                 &asym_signature_size
                 );
@@ -638,6 +1287,167 @@ spdm_verify_certificate_chain_hash (
   return TRUE;
 }
 
+typedef struct {
+  spdm_context_t               *spdm_context;
+  boolean                      is_requester;
+  void                         *context;
+  const spdm_data_segment_t    *segment;
+  uintn                        segment_count;
+  const uint8                  *signature;
+  uintn                        signature_size;
+  boolean                      result;
+} spdm_verify_job_context_t;
+
+/**
+  The job to verify the classical half of a RAW mode signature.
+
+  @param  context                       The verify job context.
+**/
+void
+spdm_asym_verify_job (
+  IN void  *context
+  )
+{
+  spdm_verify_job_context_t  *job_context;
+
+  job_context = context;
+  if (job_context->is_requester) {
+    job_context->result = spdm_asym_verify_segments (
+                            job_context->spdm_context->connection_info.algorithm.base_asym_algo,
+                            job_context->spdm_context->connection_info.algorithm.bash_hash_algo,
+                            job_context->context,
+                            job_context->segment,
+                            job_context->segment_count,
+                            job_context->signature,
+                            job_context->signature_size
+                            );
+  } else {
+    job_context->result = spdm_req_asym_verify_segments (
+                            job_context->spdm_context->connection_info.algorithm.req_base_asym_alg,
+                            job_context->spdm_context->connection_info.algorithm.bash_hash_algo,
+                            job_context->context,
+                            job_context->segment,
+                            job_context->segment_count,
+                            job_context->signature,
+                            job_context->signature_size
+                            );
+  }
+}
+
+/**
+  The job to verify the PQC half of a RAW mode signature.
+
+  @param  context                       The verify job context.
+**/
+void
+spdm_pqc_sig_verify_job (
+  IN void  *context
+  )
+{
+  spdm_verify_job_context_t  *job_context;
+
+  job_context = context;
+  if (job_context->is_requester) {
+    job_context->result = spdm_pqc_sig_verify_segments (
+                            job_context->spdm_context->connection_info.algorithm.pqc_sig_algo,
+                            job_context->context,
+                            job_context->segment,
+                            job_context->segment_count,
+                            job_context->signature,
+                            job_context->signature_size
+                            );
+  } else {
+    job_context->result = spdm_pqc_req_sig_verify_segments (
+                            job_context->spdm_context->connection_info.algorithm.pqc_req_sig_algo,
+                            job_context->context,
+                            job_context->segment,
+                            job_context->segment_count,
+                            job_context->signature,
+                            job_context->signature_size
+                            );
+  }
+}
+
+/**
+  This function verifies the classical signature and the PQC signature of a RAW mode signature.
+
+  The two signatures are verified in parallel if the worker pool is enabled.
+  The caller must fail the verification if either result is FALSE.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate of the signature verification for a requester or a responder.
+  @param  segment                       The segments of the signed message.
+  @param  segment_count                 The count of the segments.
+  @param  asym_signature                The classical signature.
+  @param  asym_signature_size           size in bytes of the classical signature.
+  @param  pqc_signature                 The PQC signature, or NULL if no PQC signature is negotiated.
+  @param  pqc_signature_size            size in bytes of the PQC signature.
+  @param  asym_result                   The verification result of the classical signature.
+  @param  pqc_result                    The verification result of the PQC signature.
+
+  @retval TRUE  The signatures are verified. The results are returned.
+  @retval FALSE The peer public key cannot be used.
+**/
+boolean
+spdm_verify_raw_mode_signature (
+  IN  spdm_context_t               *spdm_context,
+  IN  boolean                      is_requester,
+  IN  const spdm_data_segment_t    *segment,
+  IN  uintn                        segment_count,
+  IN  const uint8                  *asym_signature,
+  IN  uintn                        asym_signature_size,
+  IN  const uint8                  *pqc_signature,
+  IN  uintn                        pqc_signature_size,
+  OUT boolean                      *asym_result,
+  OUT boolean                      *pqc_result
+  )
+{
+  spdm_verify_job_context_t  job_context[2];
+  spdm_job_t                 job[2];
+  uintn                      job_count;
+
+  zero_mem (job_context, sizeof(job_context));
+
+  //
+  // The public key contexts are got by the caller, so that the jobs never touch the connection info.
+  //
+  job_context[0].spdm_context = spdm_context;
+  job_context[0].is_requester = is_requester;
+  if (!spdm_get_peer_asym_public_key_context (spdm_context, is_requester, &job_context[0].context)) {
+    return FALSE;
+  }
+  job_context[0].segment = segment;
+  job_context[0].segment_count = segment_count;
+  job_context[0].signature = asym_signature;
+  job_context[0].signature_size = asym_signature_size;
+  job[0].func = spdm_asym_verify_job;
+  job[0].context = &job_context[0];
+  job_count = 1;
+
+  if (pqc_signature != NULL) {
+    job_context[1].spdm_context = spdm_context;
+    job_context[1].is_requester = is_requester;
+    if (!spdm_get_peer_pqc_public_key_context (spdm_context, is_requester, &job_context[1].context)) {
+      return FALSE;
+    }
+    job_context[1].segment = segment;
+    job_context[1].segment_count = segment_count;
+    job_context[1].signature = pqc_signature;
+    job_context[1].signature_size = pqc_signature_size;
+    job[1].func = spdm_pqc_sig_verify_job;
+    job[1].context = &job_context[1];
+    job_count = 2;
+  } else {
+    job_context[1].result = TRUE;
+  }
+
+  spdm_run_jobs (spdm_context, job, job_count);
+
+  *asym_result = job_context[0].result;
+  *pqc_result = job_context[1].result;
+  return TRUE;
+}
+
 /**
   This function verifies the challenge signature based upon m1m2.
 
@@ -661,33 +1471,14 @@ spdm_verify_challenge_auth_signature (
   boolean                                   result2;
   uintn                                     asym_signature_size;
   uintn                                     pqc_signature_size;
-  uint8                                     *cert_buffer;
-  uintn                                     cert_buffer_size;
   void                                      *context;
-  uint8                                     *cert_chain_data;
-  uintn                                     cert_chain_data_size;
-  uint8                                     m1m2_buffer[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                                     m1m2_buffer_size;
-  void                                      *pqc_public_key;
-  uintn                                     pqc_public_key_size;
+  spdm_data_segment_t                         m1m2_segment[MAX_SPDM_M1M2_SEGMENT_COUNT];
+  uintn                                     m1m2_segment_count;
   uint32                                    *pqc_sigature_length_ptr;
   boolean                                   need_pqc_sig;
 
-  m1m2_buffer_size = sizeof(m1m2_buffer);
-  result = spdm_calculate_m1m2 (spdm_context, !is_requester, &m1m2_buffer_size, &m1m2_buffer);
-  if (!result) {
-    return FALSE;
-  }
-
-  result = spdm_get_peer_cert_chain_data (spdm_context, (void **)&cert_chain_data, &cert_chain_data_size);
-  if (!result) {
-    return FALSE;
-  }
-
-  //
-  // Get leaf cert from cert chain
-  //
-  result = x509_get_cert_from_cert_chain (cert_chain_data, cert_chain_data_size, -1,  &cert_buffer, &cert_buffer_size);
+  m1m2_segment_count = ARRAY_SIZE(m1m2_segment);
+  result = spdm_calculate_m1m2 (spdm_context, !is_requester, &m1m2_segment_count, m1m2_segment);
   if (!result) {
     return FALSE;
   }
@@ -700,46 +1491,24 @@ spdm_verify_challenge_auth_signature (
         return FALSE;
       }
 
-      result = spdm_asym_get_public_key_from_x509 (spdm_context->connection_info.algorithm.base_asym_algo, cert_buffer, cert_buffer_size, &context);
-      if (!result) {
-        return FALSE;
-      }
-      result = spdm_asym_verify (
-                spdm_context->connection_info.algorithm.base_asym_algo,
-                spdm_context->connection_info.algorithm.bash_hash_algo,
-                context,
-                m1m2_buffer,
-                m1m2_buffer_size,
-                sign_data,
-                asym_signature_size
-                );
-      spdm_asym_free (spdm_context->connection_info.algorithm.base_asym_algo, context);
-
       pqc_sigature_length_ptr = (uint32 *)((uint8 *)sign_data + asym_signature_size);
       if (*pqc_sigature_length_ptr > pqc_signature_size) {
         return FALSE;
       }
       need_pqc_sig = !spdm_pqc_algo_is_zero (spdm_context->connection_info.algorithm.pqc_sig_algo);
-      if (need_pqc_sig) {
-        result2 = spdm_get_pqc_peer_public_key (spdm_context, &pqc_public_key, &pqc_public_key_size);
-        if (!result2) {
-          return FALSE;
-        }
-        result2 = spdm_pqc_sig_set_public_key (spdm_context->connection_info.algorithm.pqc_sig_algo, pqc_public_key, pqc_public_key_size, &context);
-        if (!result2) {
-          return FALSE;
-        }
-        result2 = spdm_pqc_sig_verify (
-                  spdm_context->connection_info.algorithm.pqc_sig_algo,
-                  context,
-                  m1m2_buffer,
-                  m1m2_buffer_size,
-                  (uint8 *)(pqc_sigature_length_ptr + 1),
-                  *pqc_sigature_length_ptr
-                  );
-        spdm_pqc_sig_free (spdm_context->connection_info.algorithm.pqc_sig_algo, context);
-      } else {
-        result2 = TRUE;
+      if (!spdm_verify_raw_mode_signature (
+             spdm_context,
+             TRUE,
+             m1m2_segment,
+             m1m2_segment_count,
+             sign_data,
+             asym_signature_size,
+             need_pqc_sig ? (uint8 *)(pqc_sigature_length_ptr + 1) : NULL,
+             *pqc_sigature_length_ptr,
+             &result,
+             &result2
+             )) {
+        return FALSE;
       }
     } else {
       asym_signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo) +
@@ -749,19 +1518,18 @@ spdm_verify_challenge_auth_signature (
         return FALSE;
       }
 
-      result = spdm_hybrid_get_public_key_from_x509 (cert_buffer, cert_buffer_size, &context);
+      result = spdm_get_peer_hybrid_public_key_context (spdm_context, &context);
       if (!result) {
         return FALSE;
       }
 
-      result = spdm_hybrid_sig_verify (
+      result = spdm_hybrid_sig_verify_segments (
                 context,
-                m1m2_buffer,
-                m1m2_buffer_size,
+                m1m2_segment,
+                m1m2_segment_count,
                 sign_data,
                 asym_signature_size
                 );
-      spdm_hybrid_sig_free (context);
     }
   } else {
     if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
@@ -771,43 +1539,24 @@ spdm_verify_challenge_auth_signature (
         return FALSE;
       }
 
-      result = spdm_req_asym_get_public_key_from_x509 (spdm_context->connection_info.algorithm.req_base_asym_alg, cert_buffer, cert_buffer_size, &context);
-      if (!result) {
-        return FALSE;
-      }
-
-      result = spdm_req_asym_verify (
-                spdm_context->connection_info.algorithm.req_base_asym_alg,
-                spdm_context->connection_info.algorithm.bash_hash_algo,
-                context,
-                m1m2_buffer,
-                m1m2_buffer_size,
-                sign_data,
-                asym_signature_size
-                );
-      spdm_req_asym_free (spdm_context->connection_info.algorithm.req_base_asym_alg, context);
-
       pqc_sigature_length_ptr = (uint32 *)((uint8 *)sign_data + asym_signature_size);
       if (*pqc_sigature_length_ptr > pqc_signature_size) {
         return FALSE;
       }
       need_pqc_sig = !spdm_pqc_algo_is_zero (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
-      if (need_pqc_sig) {
-        result2 = spdm_pqc_req_sig_set_public_key (spdm_context->connection_info.algorithm.pqc_req_sig_algo, pqc_public_key, pqc_public_key_size, &context);
-        if (!result2) {
-          return FALSE;
-        }
-        result2 = spdm_pqc_req_sig_verify (
-                  spdm_context->connection_info.algorithm.pqc_req_sig_algo,
-                  context,
-                  m1m2_buffer,
-                  m1m2_buffer_size,
-                  (uint8 *)(pqc_sigature_length_ptr + 1),
-                  *pqc_sigature_length_ptr
-                  );
-        spdm_pqc_req_sig_free (spdm_context->connection_info.algorithm.pqc_req_sig_algo, context);
-      } else {
-        result2 = TRUE;
+      if (!spdm_verify_raw_mode_signature (
+             spdm_context,
+             FALSE,
+             m1m2_segment,
+             m1m2_segment_count,
+             sign_data,
+             asym_signature_size,
+             need_pqc_sig ? (uint8 *)(pqc_sigature_length_ptr + 1) : NULL,
+             *pqc_sigature_length_ptr,
+             &result,
+             &result2
+             )) {
+        return FALSE;
       }
     } else {
       asym_signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg) +
@@ -817,19 +1566,18 @@ spdm_verify_challenge_auth_signature (
         return FALSE;
       }
 
-      result = spdm_hybrid_get_public_key_from_x509 (cert_buffer, cert_buffer_size, &context);
+      result = spdm_get_peer_hybrid_public_key_context (spdm_context, &context);
       if (!result) {
         return FALSE;
       }
 
-      result = spdm_hybrid_sig_verify (
+      result = spdm_hybrid_sig_verify_segments (
                 context,
-                m1m2_buffer,
-                m1m2_buffer_size,
+                m1m2_segment,
+                m1m2_segment_count,
                 sign_data,
                 asym_signature_size
                 );
-      spdm_hybrid_sig_free (context);
     }
   }
 
@@ -929,11 +1677,14 @@ spdm_generate_measurement_summary_hash (
 
   case SPDM_CHALLENGE_REQUEST_TCB_COMPONENT_MEASUREMENT_HASH:
   case SPDM_CHALLENGE_REQUEST_ALL_MEASUREMENTS_HASH:
+    if (spdm_measurement_cache_get_summary_hash (spdm_context, measurement_summary_hash_type, measurement_summary_hash)) {
+      break;
+    }
+
     // get all measurement data
     device_measurement_size = sizeof(device_measurement);
-    ret = spdm_measurement_collection (
-            spdm_context->connection_info.algorithm.measurement_spec,
-            spdm_context->connection_info.algorithm.measurement_hash_algo,
+    ret = spdm_collect_measurement (
+            spdm_context,
             &device_measurement_count,
             device_measurement,
             &device_measurement_size
@@ -971,6 +1722,7 @@ spdm_generate_measurement_summary_hash (
       cached_measurment_block = (void *)((uintn)cached_measurment_block + measurment_block_size);
     }
     spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, measurement_data, measurment_data_size, measurement_summary_hash);
+    spdm_measurement_cache_set_summary_hash (spdm_context, measurement_summary_hash_type, measurement_summary_hash);
     break;
   default:
     return FALSE;
@@ -997,50 +1749,34 @@ spdm_generate_measurement_signature (
   uintn                         asym_signature_size;
   uintn                         pqc_signature_size;
   boolean                       result;
-  uint8                         l1l2_buffer[MAX_SPDM_MESSAGE_BUFFER_SIZE];
-  uintn                         l1l2_buffer_size;
-  uint32                        *pqc_sigature_length_ptr;
+  spdm_data_segment_t             l1l2_segment;
 
-  l1l2_buffer_size = sizeof(l1l2_buffer);
-  result = spdm_calculate_l1l2 (spdm_context, &l1l2_buffer_size, l1l2_buffer);
+  result = spdm_calculate_l1l2 (spdm_context, &l1l2_segment);
   if (!result) {
     return FALSE;
   }
 
   if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
-    asym_signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo);
-    result = spdm_responder_data_sign (
-              spdm_context->connection_info.algorithm.base_asym_algo,
-              spdm_context->connection_info.algorithm.bash_hash_algo,
-              l1l2_buffer,
-              l1l2_buffer_size,
+    result = spdm_generate_raw_mode_signature (
+              spdm_context,
+              FALSE,
+              &l1l2_segment,
+              1,
+              TRUE,
               signature,
-              &asym_signature_size
-              );
-    if (!result) {
-      return FALSE;
-    }
-
-    pqc_sigature_length_ptr = (uint32 *)(signature + asym_signature_size);
-    pqc_signature_size = spdm_get_pqc_sig_signature_size (spdm_context->connection_info.algorithm.pqc_sig_algo);
-    result = spdm_pqc_responder_data_sign (
-              spdm_context->connection_info.algorithm.pqc_sig_algo,
-              l1l2_buffer,
-              l1l2_buffer_size,
-              (uint8 *)(pqc_sigature_length_ptr + 1),
+              &asym_signature_size,
               &pqc_signature_size
               );
-    *pqc_sigature_length_ptr = (uint32)pqc_signature_size;
   } else {
     asym_signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo) +
                           PQC_SIG_SIGNATURE_LENGTH_SIZE +
                           spdm_get_pqc_sig_signature_size (spdm_context->connection_info.algorithm.pqc_sig_algo);
-    result = spdm_hybrid_responder_data_sign (
+    result = spdm_hybrid_responder_data_sign_segments (
               spdm_context->connection_info.algorithm.base_asym_algo,
               spdm_context->connection_info.algorithm.bash_hash_algo,
               spdm_context->connection_info.algorithm.pqc_sig_algo,
-              l1l2_buffer,
-              l1l2_buffer_size,
+              &l1l2_segment,
+              1,
               signature,
               &asym_signature_size
               );
@@ -1070,32 +1806,11 @@ spdm_verify_measurement_signature (
   boolean                                   result2;
   uintn                                     asym_signature_size;
   uintn                                     pqc_signature_size;
-  uint8                                     *cert_buffer;
-  uintn                                     cert_buffer_size;
   void                                      *context;
-  uint8                                     *cert_chain_data;
-  uintn                                     cert_chain_data_size;
-  uint8                                     l1l2_buffer[MAX_SPDM_MESSAGE_BUFFER_SIZE];
-  uintn                                     l1l2_buffer_size;
-  void                                      *pqc_public_key;
-  uintn                                     pqc_public_key_size;
+  spdm_data_segment_t                         l1l2_segment;
   uint32                                    *pqc_sigature_length_ptr;
 
-  l1l2_buffer_size = sizeof(l1l2_buffer);
-  result = spdm_calculate_l1l2 (spdm_context, &l1l2_buffer_size, l1l2_buffer);
-  if (!result) {
-    return FALSE;
-  }
-
-  result = spdm_get_peer_cert_chain_data (spdm_context, (void **)&cert_chain_data, &cert_chain_data_size);
-  if (!result) {
-    return FALSE;
-  }
-
-  //
-  // Get leaf cert from cert chain
-  //
-  result = x509_get_cert_from_cert_chain (cert_chain_data, cert_chain_data_size, -1,  &cert_buffer, &cert_buffer_size);
+  result = spdm_calculate_l1l2 (spdm_context, &l1l2_segment);
   if (!result) {
     return FALSE;
   }
@@ -1107,43 +1822,24 @@ spdm_verify_measurement_signature (
       return FALSE;
     }
 
-    result = spdm_asym_get_public_key_from_x509 (spdm_context->connection_info.algorithm.base_asym_algo, cert_buffer, cert_buffer_size, &context);
-    if (!result) {
-      return FALSE;
-    }
-
-    result = spdm_asym_verify (
-              spdm_context->connection_info.algorithm.base_asym_algo,
-              spdm_context->connection_info.algorithm.bash_hash_algo,
-              context,
-              l1l2_buffer,
-              l1l2_buffer_size,
-              sign_data,
-              asym_signature_size
-              );
-    spdm_asym_free (spdm_context->connection_info.algorithm.base_asym_algo, context);
-
     pqc_sigature_length_ptr = (uint32 *)((uint8 *)sign_data + asym_signature_size);
     if (*pqc_sigature_length_ptr > pqc_signature_size) {
       return FALSE;
     }
-    result2 = spdm_get_pqc_peer_public_key (spdm_context, &pqc_public_key, &pqc_public_key_size);
-    if (!result2) {
-      return FALSE;
-    }
-    result2 = spdm_pqc_sig_set_public_key (spdm_context->connection_info.algorithm.pqc_sig_algo, pqc_public_key, pqc_public_key_size, &context);
-    if (!result2) {
+    if (!spdm_verify_raw_mode_signature (
+           spdm_context,
+           TRUE,
+           &l1l2_segment,
+           1,
+           sign_data,
+           asym_signature_size,
+           (uint8 *)(pqc_sigature_length_ptr + 1),
+           *pqc_sigature_length_ptr,
+           &result,
+           &result2
+           )) {
       return FALSE;
     }
-    result2 = spdm_pqc_sig_verify (
-                spdm_context->connection_info.algorithm.pqc_sig_algo,
-                context,
-                l1l2_buffer,
-                l1l2_buffer_size,
-                (uint8 *)(pqc_sigature_length_ptr + 1),
-                *pqc_sigature_length_ptr
-                );
-    spdm_pqc_sig_free (spdm_context->connection_info.algorithm.pqc_sig_algo, context);
   } else {
     asym_signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo) +
                           PQC_SIG_SIGNATURE_LENGTH_SIZE +
@@ -1152,19 +1848,18 @@ spdm_verify_measurement_signature (
       return FALSE;
     }
 
-    result = spdm_hybrid_get_public_key_from_x509 (cert_buffer, cert_buffer_size, &context);
+    result = spdm_get_peer_hybrid_public_key_context (spdm_context, &context);
     if (!result) {
       return FALSE;
     }
 
-    result = spdm_hybrid_sig_verify (
+    result = spdm_hybrid_sig_verify_segments (
               context,
-              l1l2_buffer,
-              l1l2_buffer_size,
+              &l1l2_segment,
+              1,
               sign_data,
               asym_signature_size
               );
-    spdm_hybrid_sig_free (context);
   }
 
   if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
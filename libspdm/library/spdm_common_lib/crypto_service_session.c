@@ -12,12 +12,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 /*
   This function calculates current TH data with message A and message K.
 
+  The TH data is returned as segments which refer to the transcript, instead of being copied into one buffer.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  session_info                  The SPDM session ID.
   @param  cert_chain_data                Certitiface chain data without spdm_cert_chain_t header.
   @param  cert_chain_data_size            size in bytes of the certitiface chain data.
-  @param  th_data_buffer_size             size in bytes of the th_data_buffer
-  @param  th_data_buffer                 The buffer to store the th_data_buffer
+  @param  th_curr                       The segments of the TH data.
 
   @retval RETURN_SUCCESS  current TH data is calculated.
 */
@@ -27,51 +28,40 @@ spdm_calculate_th_for_exchange (
   IN     void                      *spdm_session_info,
   IN     uint8                     *cert_chain_data, OPTIONAL
   IN     uintn                     cert_chain_data_size, OPTIONAL
-  IN OUT uintn                     *th_data_buffer_size,
-     OUT void                      *th_data_buffer
+     OUT spdm_th_segments_t        *th_curr
   )
 {
   spdm_context_t           *spdm_context;
   spdm_session_info_t             *session_info;
-  uint8                         cert_chain_data_hash[MAX_HASH_SIZE];
   uint32                        hash_size;
-  return_status                 status;
-  large_managed_buffer_t          th_curr;
 
   spdm_context = context;
   session_info = spdm_session_info;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
 
-  ASSERT (*th_data_buffer_size >= MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE);
-  init_managed_buffer (&th_curr, MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE);
+  th_curr->segment_count = 0;
 
   DEBUG((DEBUG_INFO, "message_a data :\n"));
   internal_dump_hex (get_managed_buffer(&spdm_context->transcript.message_a), get_managed_buffer_size(&spdm_context->transcript.message_a));
-  status = append_managed_buffer (&th_curr, get_managed_buffer(&spdm_context->transcript.message_a), get_managed_buffer_size(&spdm_context->transcript.message_a));
-  if (RETURN_ERROR(status)) {
-    return FALSE;
-  }
+  th_curr->segment[th_curr->segment_count].data = get_managed_buffer(&spdm_context->transcript.message_a);
+  th_curr->segment[th_curr->segment_count].size = get_managed_buffer_size(&spdm_context->transcript.message_a);
+  th_curr->segment_count++;
 
   if (cert_chain_data != NULL) {
     DEBUG((DEBUG_INFO, "th_message_ct data :\n"));
     internal_dump_hex (cert_chain_data, cert_chain_data_size);
-    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, cert_chain_data, cert_chain_data_size, cert_chain_data_hash);
-    status = append_managed_buffer (&th_curr, cert_chain_data_hash, hash_size);
-    if (RETURN_ERROR(status)) {
-      return FALSE;
-    }
+    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, cert_chain_data, cert_chain_data_size, th_curr->cert_chain_hash);
+    th_curr->segment[th_curr->segment_count].data = th_curr->cert_chain_hash;
+    th_curr->segment[th_curr->segment_count].size = hash_size;
+    th_curr->segment_count++;
   }
 
   DEBUG((DEBUG_INFO, "message_k data :\n"));
   internal_dump_hex (get_managed_buffer(&session_info->session_transcript.message_k), get_managed_buffer_size(&session_info->session_transcript.message_k));
-  status = append_managed_buffer (&th_curr, get_managed_buffer(&session_info->session_transcript.message_k), get_managed_buffer_size(&session_info->session_transcript.message_k));
-  if (RETURN_ERROR(status)) {
-    return FALSE;
-  }
-
-  *th_data_buffer_size = get_managed_buffer_size(&th_curr);
-  copy_mem (th_data_buffer, get_managed_buffer(&th_curr), *th_data_buffer_size);
+  th_curr->segment[th_curr->segment_count].data = get_managed_buffer(&session_info->session_transcript.message_k);
+  th_curr->segment[th_curr->segment_count].size = get_managed_buffer_size(&session_info->session_transcript.message_k);
+  th_curr->segment_count++;
 
   return TRUE;
 }
@@ -79,14 +69,15 @@ spdm_calculate_th_for_exchange (
 /*
   This function calculates current TH data with message A, message K and message F.
 
+  The TH data is returned as segments which refer to the transcript, instead of being copied into one buffer.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  session_info                  The SPDM session ID.
   @param  cert_chain_data                Certitiface chain data without spdm_cert_chain_t header.
   @param  cert_chain_data_size            size in bytes of the certitiface chain data.
   @param  mut_cert_chain_data             Certitiface chain data without spdm_cert_chain_t header in mutual authentication.
   @param  mut_cert_chain_data_size         size in bytes of the certitiface chain data in mutual authentication.
-  @param  th_data_buffer_size             size in bytes of the th_data_buffer
-  @param  th_data_buffer                 The buffer to store the th_data_buffer
+  @param  th_curr                       The segments of the TH data.
 
   @retval RETURN_SUCCESS  current TH data is calculated.
 */
@@ -98,71 +89,136 @@ spdm_calculate_th_for_finish (
   IN     uintn                     cert_chain_data_size, OPTIONAL
   IN     uint8                     *mut_cert_chain_data, OPTIONAL
   IN     uintn                     mut_cert_chain_data_size, OPTIONAL
-  IN OUT uintn                     *th_data_buffer_size,
-     OUT void                      *th_data_buffer
+     OUT spdm_th_segments_t        *th_curr
   )
 {
   spdm_context_t           *spdm_context;
   spdm_session_info_t             *session_info;
-  uint8                         cert_chain_data_hash[MAX_HASH_SIZE];
-  uint8                         MutCertChainDataHash[MAX_HASH_SIZE];
   uint32                        hash_size;
-  return_status                 status;
-  large_managed_buffer_t          th_curr;
+  boolean                       result;
 
   spdm_context = context;
   session_info = spdm_session_info;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
 
-  ASSERT (*th_data_buffer_size >= MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE);
-  init_managed_buffer (&th_curr, MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE);
-
-  DEBUG((DEBUG_INFO, "message_a data :\n"));
-  internal_dump_hex (get_managed_buffer(&spdm_context->transcript.message_a), get_managed_buffer_size(&spdm_context->transcript.message_a));
-  status = append_managed_buffer (&th_curr, get_managed_buffer(&spdm_context->transcript.message_a), get_managed_buffer_size(&spdm_context->transcript.message_a));
-  if (RETURN_ERROR(status)) {
-    return FALSE;
-  }
-
-  if (cert_chain_data != NULL) {
-    DEBUG((DEBUG_INFO, "th_message_ct data :\n"));
-    internal_dump_hex (cert_chain_data, cert_chain_data_size);
-    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, cert_chain_data, cert_chain_data_size, cert_chain_data_hash);
-    status = append_managed_buffer (&th_curr, cert_chain_data_hash, hash_size);
-    if (RETURN_ERROR(status)) {
-      return FALSE;
-    }
-  }
-
-  DEBUG((DEBUG_INFO, "message_k data :\n"));
-  internal_dump_hex (get_managed_buffer(&session_info->session_transcript.message_k), get_managed_buffer_size(&session_info->session_transcript.message_k));
-  status = append_managed_buffer (&th_curr, get_managed_buffer(&session_info->session_transcript.message_k), get_managed_buffer_size(&session_info->session_transcript.message_k));
-  if (RETURN_ERROR(status)) {
+  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, th_curr);
+  if (!result) {
     return FALSE;
   }
 
   if (mut_cert_chain_data != NULL) {
     DEBUG((DEBUG_INFO, "th_message_cm data :\n"));
     internal_dump_hex (mut_cert_chain_data, mut_cert_chain_data_size);
-    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, mut_cert_chain_data, mut_cert_chain_data_size, MutCertChainDataHash);
-    status = append_managed_buffer (&th_curr, MutCertChainDataHash, hash_size);
-    if (RETURN_ERROR(status)) {
-      return FALSE;
-    }
+    spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, mut_cert_chain_data, mut_cert_chain_data_size, th_curr->mut_cert_chain_hash);
+    th_curr->segment[th_curr->segment_count].data = th_curr->mut_cert_chain_hash;
+    th_curr->segment[th_curr->segment_count].size = hash_size;
+    th_curr->segment_count++;
   }
 
   DEBUG((DEBUG_INFO, "message_f data :\n"));
   internal_dump_hex (get_managed_buffer(&session_info->session_transcript.message_f), get_managed_buffer_size(&session_info->session_transcript.message_f));
-  status = append_managed_buffer (&th_curr, get_managed_buffer(&session_info->session_transcript.message_f), get_managed_buffer_size(&session_info->session_transcript.message_f));
-  if (RETURN_ERROR(status)) {
-    return FALSE;
+  th_curr->segment[th_curr->segment_count].data = get_managed_buffer(&session_info->session_transcript.message_f);
+  th_curr->segment[th_curr->segment_count].size = get_managed_buffer_size(&session_info->session_transcript.message_f);
+  th_curr->segment_count++;
+
+  return TRUE;
+}
+
+/*
+  This function calculates current TH hash with message A and message K.
+
+  The running hash of the session transcript only absorbs the data appended since the last TH checkpoint.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The SPDM session ID.
+  @param  cert_chain_data                Certitiface chain data without spdm_cert_chain_t header.
+  @param  cert_chain_data_size            size in bytes of the certitiface chain data.
+  @param  th_hash                       The buffer to store the TH hash
+
+  @retval TRUE  current TH hash is calculated.
+*/
+boolean
+spdm_calculate_th_hash_for_exchange (
+  IN     void                      *context,
+  IN     void                      *spdm_session_info,
+  IN     uint8                     *cert_chain_data, OPTIONAL
+  IN     uintn                     cert_chain_data_size, OPTIONAL
+     OUT uint8                     *th_hash
+  )
+{
+  spdm_context_t                *spdm_context;
+  spdm_session_info_t           *session_info;
+  spdm_transcript_segment_t     segment[3];
+
+  spdm_context = context;
+  session_info = spdm_session_info;
+
+  zero_mem (segment, sizeof(segment));
+  segment[0].data = get_managed_buffer(&spdm_context->transcript.message_a);
+  segment[0].size = get_managed_buffer_size(&spdm_context->transcript.message_a);
+  if (cert_chain_data != NULL) {
+    segment[1].data = cert_chain_data;
+    segment[1].size = cert_chain_data_size;
+    segment[1].hash_data = TRUE;
   }
+  segment[2].data = get_managed_buffer(&session_info->session_transcript.message_k);
+  segment[2].size = get_managed_buffer_size(&session_info->session_transcript.message_k);
 
-  *th_data_buffer_size = get_managed_buffer_size(&th_curr);
-  copy_mem (th_data_buffer, get_managed_buffer(&th_curr), *th_data_buffer_size);
+  return spdm_transcript_hash_calculate (&session_info->session_transcript.digest_th, spdm_context->connection_info.algorithm.bash_hash_algo, segment, ARRAY_SIZE(segment), th_hash);
+}
 
-  return TRUE;
+/*
+  This function calculates current TH hash with message A, message K and message F.
+
+  The running hash of the session transcript only absorbs the data appended since the last TH checkpoint.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The SPDM session ID.
+  @param  cert_chain_data                Certitiface chain data without spdm_cert_chain_t header.
+  @param  cert_chain_data_size            size in bytes of the certitiface chain data.
+  @param  mut_cert_chain_data             Certitiface chain data without spdm_cert_chain_t header in mutual authentication.
+  @param  mut_cert_chain_data_size         size in bytes of the certitiface chain data in mutual authentication.
+  @param  th_hash                       The buffer to store the TH hash
+
+  @retval TRUE  current TH hash is calculated.
+*/
+boolean
+spdm_calculate_th_hash_for_finish (
+  IN     void                      *context,
+  IN     void                      *spdm_session_info,
+  IN     uint8                     *cert_chain_data, OPTIONAL
+  IN     uintn                     cert_chain_data_size, OPTIONAL
+  IN     uint8                     *mut_cert_chain_data, OPTIONAL
+  IN     uintn                     mut_cert_chain_data_size, OPTIONAL
+     OUT uint8                     *th_hash
+  )
+{
+  spdm_context_t                *spdm_context;
+  spdm_session_info_t           *session_info;
+  spdm_transcript_segment_t     segment[MAX_SPDM_TRANSCRIPT_SEGMENT_COUNT];
+
+  spdm_context = context;
+  session_info = spdm_session_info;
+
+  zero_mem (segment, sizeof(segment));
+  segment[0].data = get_managed_buffer(&spdm_context->transcript.message_a);
+  segment[0].size = get_managed_buffer_size(&spdm_context->transcript.message_a);
+  if (cert_chain_data != NULL) {
+    segment[1].data = cert_chain_data;
+    segment[1].size = cert_chain_data_size;
+    segment[1].hash_data = TRUE;
+  }
+  segment[2].data = get_managed_buffer(&session_info->session_transcript.message_k);
+  segment[2].size = get_managed_buffer_size(&session_info->session_transcript.message_k);
+  if (mut_cert_chain_data != NULL) {
+    segment[3].data = mut_cert_chain_data;
+    segment[3].size = mut_cert_chain_data_size;
+    segment[3].hash_data = TRUE;
+  }
+  segment[4].data = get_managed_buffer(&session_info->session_transcript.message_f);
+  segment[4].size = get_managed_buffer_size(&session_info->session_transcript.message_f);
+  return spdm_transcript_hash_calculate (&session_info->session_transcript.digest_th, spdm_context->connection_info.algorithm.bash_hash_algo, segment, ARRAY_SIZE(segment), th_hash);
 }
 
 /**
@@ -189,8 +245,7 @@ spdm_generate_key_exchange_rsp_signature (
   uintn                         asym_signature_size;
   uintn                         pqc_signature_size;
   uint32                        hash_size;
-  uint8                         th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                         th_curr_data_size;
+  spdm_th_segments_t               th_curr;
   uint32                        *pqc_sigature_length_ptr;
   boolean                       need_pqc_sig;
 
@@ -205,49 +260,36 @@ spdm_generate_key_exchange_rsp_signature (
     return FALSE;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  // debug only
-  spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, th_curr_data, th_curr_data_size, hash_data);
+  result = spdm_calculate_th_hash_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, hash_data);
+  if (!result) {
+    return FALSE;
+  }
   DEBUG((DEBUG_INFO, "th_curr hash - "));
   internal_dump_data (hash_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
   if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
-    result = spdm_responder_data_sign (
-              spdm_context->connection_info.algorithm.base_asym_algo,
-              spdm_context->connection_info.algorithm.bash_hash_algo,
-              th_curr_data,
-              th_curr_data_size,
+    result = spdm_generate_raw_mode_signature (
+              spdm_context,
+              FALSE,
+              th_curr.segment,
+              th_curr.segment_count,
+              need_pqc_sig,
               signature,
-              &asym_signature_size
+              &asym_signature_size,
+              &pqc_signature_size
               );
     if (result) {
       DEBUG((DEBUG_INFO, "signature (classical) - "));
       internal_dump_data (signature, asym_signature_size);
       DEBUG((DEBUG_INFO, "\n"));
-    } else {
-      return FALSE;
-    }
 
-    pqc_sigature_length_ptr = (uint32 *)(signature + asym_signature_size);
-    if (need_pqc_sig) {
-      result = spdm_pqc_responder_data_sign (
-                spdm_context->connection_info.algorithm.pqc_sig_algo,
-                th_curr_data,
-                th_curr_data_size,
-                (uint8 *)(pqc_sigature_length_ptr + 1),
-                &pqc_signature_size
-                );
-    } else {
-      result = TRUE;
-    }
-    *pqc_sigature_length_ptr = (uint32)pqc_signature_size;
-    if (result) {
+      pqc_sigature_length_ptr = (uint32 *)(signature + asym_signature_size);
       DEBUG((DEBUG_INFO, "signature (PQC) - "));
       internal_dump_data ((uint8 *)(pqc_sigature_length_ptr + 1), pqc_signature_size);
       DEBUG((DEBUG_INFO, "\n"));
@@ -256,12 +298,12 @@ spdm_generate_key_exchange_rsp_signature (
     asym_signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo) +
                           PQC_SIG_SIGNATURE_LENGTH_SIZE +
                           spdm_get_pqc_sig_signature_size (spdm_context->connection_info.algorithm.pqc_sig_algo);
-    result = spdm_hybrid_responder_data_sign (
+    result = spdm_hybrid_responder_data_sign_segments (
               spdm_context->connection_info.algorithm.base_asym_algo,
               spdm_context->connection_info.algorithm.bash_hash_algo,
               spdm_context->connection_info.algorithm.pqc_sig_algo,
-              th_curr_data,
-              th_curr_data_size,
+              th_curr.segment,
+              th_curr.segment_count,
               signature,
               &asym_signature_size
               );
@@ -298,8 +340,7 @@ spdm_generate_key_exchange_rsp_hmac (
   uint8                         *cert_chain_data;
   uintn                         cert_chain_data_size;
   uint32                        hash_size;
-  uint8                         th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                         th_curr_data_size;
+  spdm_th_segments_t               th_curr;
   boolean                       result;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
@@ -309,13 +350,12 @@ spdm_generate_key_exchange_rsp_hmac (
     return FALSE;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_response_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, hmac_data);
+  spdm_hmac_all_with_response_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
@@ -352,13 +392,8 @@ spdm_verify_key_exchange_rsp_signature (
   uintn                                     pqc_signature_size;
   uint8                                     *cert_chain_data;
   uintn                                     cert_chain_data_size;
-  uint8                                     *cert_buffer;
-  uintn                                     cert_buffer_size;
   void                                      *context;
-  uint8                                     th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                                     th_curr_data_size;
-  void                                      *pqc_public_key;
-  uintn                                     pqc_public_key_size;
+  spdm_th_segments_t                           th_curr;
   uint32                                    *pqc_sigature_length_ptr;
   boolean                                   need_pqc_sig;
 
@@ -376,14 +411,15 @@ spdm_verify_key_exchange_rsp_signature (
     return FALSE;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  // debug only
-  spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, th_curr_data, th_curr_data_size, hash_data);
+  result = spdm_calculate_th_hash_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, hash_data);
+  if (!result) {
+    return FALSE;
+  }
   DEBUG((DEBUG_INFO, "th_curr hash - "));
   internal_dump_data (hash_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
@@ -402,74 +438,42 @@ spdm_verify_key_exchange_rsp_signature (
     DEBUG((DEBUG_INFO, "\n"));
   }
 
-  //
-  // Get leaf cert from cert chain
-  //
-  result = x509_get_cert_from_cert_chain (cert_chain_data, cert_chain_data_size, -1,  &cert_buffer, &cert_buffer_size);
-  if (!result) {
-    return FALSE;
-  }
-
   if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
-    result = spdm_asym_get_public_key_from_x509 (spdm_context->connection_info.algorithm.base_asym_algo, cert_buffer, cert_buffer_size, &context);
-    if (!result) {
-      return FALSE;
-    }
-
-    result = spdm_asym_verify (
-              spdm_context->connection_info.algorithm.base_asym_algo,
-              spdm_context->connection_info.algorithm.bash_hash_algo,
-              context,
-              th_curr_data,
-              th_curr_data_size,
-              sign_data,
-              asym_signature_size
-              );
-    spdm_asym_free (spdm_context->connection_info.algorithm.base_asym_algo, context);
-    
     pqc_sigature_length_ptr = (uint32 *)((uint8 *)sign_data + asym_signature_size);
     if (*pqc_sigature_length_ptr > pqc_signature_size) {
       return FALSE;
     }
-    if (need_pqc_sig) {
-      result2 = spdm_get_pqc_peer_public_key (spdm_context, &pqc_public_key, &pqc_public_key_size);
-      if (!result2) {
-        return FALSE;
-      }
-      result2 = spdm_pqc_sig_set_public_key (spdm_context->connection_info.algorithm.pqc_sig_algo, pqc_public_key, pqc_public_key_size, &context);
-      if (!result2) {
-        return FALSE;
-      }
-      result2 = spdm_pqc_sig_verify (
-                spdm_context->connection_info.algorithm.pqc_sig_algo,
-                context,
-                th_curr_data,
-                th_curr_data_size,
-                (uint8 *)(pqc_sigature_length_ptr + 1),
-                *pqc_sigature_length_ptr
-                );
-      spdm_pqc_sig_free (spdm_context->connection_info.algorithm.pqc_sig_algo, context);
-    } else {
-      result2 = TRUE;
+    if (!spdm_verify_raw_mode_signature (
+           spdm_context,
+           TRUE,
+           th_curr.segment,
+           th_curr.segment_count,
+           sign_data,
+           asym_signature_size,
+           need_pqc_sig ? (uint8 *)(pqc_sigature_length_ptr + 1) : NULL,
+           *pqc_sigature_length_ptr,
+           &result,
+           &result2
+           )) {
+      return FALSE;
     }
   } else {
     asym_signature_size = spdm_get_asym_signature_size (spdm_context->connection_info.algorithm.base_asym_algo) +
                           PQC_SIG_SIGNATURE_LENGTH_SIZE +
                           spdm_get_pqc_sig_signature_size (spdm_context->connection_info.algorithm.pqc_sig_algo);
 
-    result = spdm_hybrid_get_public_key_from_x509 (cert_buffer, cert_buffer_size, &context);
+    result = spdm_get_peer_hybrid_public_key_context (spdm_context, &context);
     if (!result) {
       return FALSE;
     }
 
-    result = spdm_hybrid_sig_verify (
+    result = spdm_hybrid_sig_verify_segments (
               context,
-              th_curr_data,
-              th_curr_data_size,
+              th_curr.segment,
+              th_curr.segment_count,
               sign_data,
               asym_signature_size
               );
-    spdm_hybrid_sig_free (context);
   }
 
   if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
@@ -518,8 +522,7 @@ spdm_verify_key_exchange_rsp_hmac (
   uint8                                     *cert_chain_data;
   uintn                                     cert_chain_data_size;
   boolean                                   result;
-  uint8                                     th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                                     th_curr_data_size;
+  spdm_th_segments_t                           th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
   ASSERT(hash_size == hmac_data_size);
@@ -529,18 +532,17 @@ spdm_verify_key_exchange_rsp_hmac (
     return FALSE;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_response_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, calc_hmac_data);
+  spdm_hmac_all_with_response_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, calc_hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (calc_hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
-  if (compare_mem (calc_hmac_data, hmac_data, hash_size) != 0) {
+  if (const_compare_mem (calc_hmac_data, hmac_data, hash_size) != 0) {
     DEBUG((DEBUG_INFO, "!!! verify_key_exchange_hmac - FAIL !!!\n"));
     return FALSE;
   }
@@ -575,8 +577,7 @@ spdm_generate_finish_req_signature (
   uintn                         asym_signature_size;
   uintn                         pqc_signature_size;
   uint32                        hash_size;
-  uint8                         th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                         th_curr_data_size;
+  spdm_th_segments_t               th_curr;
   uint32                        *pqc_sigature_length_ptr;
 
   asym_signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg);
@@ -593,46 +594,36 @@ spdm_generate_finish_req_signature (
     return FALSE;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  // debug only
-  spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, th_curr_data, th_curr_data_size, hash_data);
+  result = spdm_calculate_th_hash_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, hash_data);
+  if (!result) {
+    return FALSE;
+  }
   DEBUG((DEBUG_INFO, "th_curr hash - "));
   internal_dump_data (hash_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
   if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
-    result = spdm_requester_data_sign (
-              spdm_context->connection_info.algorithm.req_base_asym_alg,
-              spdm_context->connection_info.algorithm.bash_hash_algo,
-              th_curr_data,
-              th_curr_data_size,
+    result = spdm_generate_raw_mode_signature (
+              spdm_context,
+              TRUE,
+              th_curr.segment,
+              th_curr.segment_count,
+              TRUE,
               signature,
-              &asym_signature_size
+              &asym_signature_size,
+              &pqc_signature_size
               );
     if (result) {
       DEBUG((DEBUG_INFO, "signature (classical) - "));
       internal_dump_data (signature, asym_signature_size);
       DEBUG((DEBUG_INFO, "\n"));
-    } else {
-      return FALSE;
-    }
 
-    pqc_sigature_length_ptr = (uint32 *)(signature + asym_signature_size);
-    pqc_signature_size = spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
-    result = spdm_pqc_requester_data_sign (
-              spdm_context->connection_info.algorithm.pqc_req_sig_algo,
-              th_curr_data,
-              th_curr_data_size,
-              (uint8 *)(pqc_sigature_length_ptr + 1),
-              &pqc_signature_size
-              );
-    *pqc_sigature_length_ptr = (uint32)pqc_signature_size;
-    if (result) {
+      pqc_sigature_length_ptr = (uint32 *)(signature + asym_signature_size);
       DEBUG((DEBUG_INFO, "signature (PQC) - "));
       internal_dump_data ((uint8 *)(pqc_sigature_length_ptr + 1), pqc_signature_size);
       DEBUG((DEBUG_INFO, "\n"));
@@ -641,12 +632,12 @@ spdm_generate_finish_req_signature (
     asym_signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg) +
                           PQC_SIG_SIGNATURE_LENGTH_SIZE +
                           spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
-    result = spdm_hybrid_requester_data_sign (
+    result = spdm_hybrid_requester_data_sign_segments (
               spdm_context->connection_info.algorithm.req_base_asym_alg,
               spdm_context->connection_info.algorithm.bash_hash_algo,
               spdm_context->connection_info.algorithm.pqc_req_sig_algo,
-              th_curr_data,
-              th_curr_data_size,
+              th_curr.segment,
+              th_curr.segment_count,
               signature,
               &asym_signature_size
               );
@@ -686,8 +677,7 @@ spdm_generate_finish_req_hmac (
   uint8                                     *mut_cert_chain_data;
   uintn                                     mut_cert_chain_data_size;
   boolean                                   result;
-  uint8                                     th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                                     th_curr_data_size;
+  spdm_th_segments_t                           th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
 
@@ -706,13 +696,12 @@ spdm_generate_finish_req_hmac (
     mut_cert_chain_data_size = 0;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_request_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, calc_hmac_data);
+  spdm_hmac_all_with_request_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, calc_hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (calc_hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
@@ -751,13 +740,8 @@ spdm_verify_finish_req_signature (
   uintn                                     cert_chain_data_size;
   uint8                                     *mut_cert_chain_data;
   uintn                                     mut_cert_chain_data_size;
-  uint8                                     *mut_cert_buffer;
-  uintn                                     mut_cert_buffer_size;
   void                                      *context;
-  uint8                                     th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                                     th_curr_data_size;
-  void                                      *pqc_public_key;
-  uintn                                     pqc_public_key_size;
+  spdm_th_segments_t                           th_curr;
   uint32                                    *pqc_sigature_length_ptr;
 
   asym_signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg);
@@ -777,14 +761,15 @@ spdm_verify_finish_req_signature (
     return FALSE;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  // debug only
-  spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, th_curr_data, th_curr_data_size, hash_data);
+  result = spdm_calculate_th_hash_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, hash_data);
+  if (!result) {
+    return FALSE;
+  }
   DEBUG((DEBUG_INFO, "th_curr hash - "));
   internal_dump_data (hash_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
@@ -803,69 +788,54 @@ spdm_verify_finish_req_signature (
     DEBUG((DEBUG_INFO, "\n"));
   }
 
-  //
-  // Get leaf cert from cert chain
-  //
-  result = x509_get_cert_from_cert_chain (mut_cert_chain_data, mut_cert_chain_data_size, -1,  &mut_cert_buffer, &mut_cert_buffer_size);
-  if (!result) {
-    return FALSE;
-  }
-
   if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
-    result = spdm_req_asym_get_public_key_from_x509 (spdm_context->connection_info.algorithm.req_base_asym_alg, mut_cert_buffer, mut_cert_buffer_size, &context);
+    result = spdm_get_peer_asym_public_key_context (spdm_context, FALSE, &context);
     if (!result) {
       return FALSE;
     }
 
-    result = spdm_req_asym_verify (
+    result = spdm_req_asym_verify_segments (
               spdm_context->connection_info.algorithm.req_base_asym_alg,
               spdm_context->connection_info.algorithm.bash_hash_algo,
               context,
-              th_curr_data,
-              th_curr_data_size,
+              th_curr.segment,
+              th_curr.segment_count,
               sign_data,
               asym_signature_size
               );
-    spdm_req_asym_free (spdm_context->connection_info.algorithm.req_base_asym_alg, context);
 
     pqc_sigature_length_ptr = (uint32 *)((uint8 *)sign_data + asym_signature_size);
     if (*pqc_sigature_length_ptr > pqc_signature_size) {
       return FALSE;
     }
-    result2 = spdm_get_pqc_peer_public_key (spdm_context, &pqc_public_key, &pqc_public_key_size);
+    result2 = spdm_get_peer_pqc_public_key_context (spdm_context, FALSE, &context);
     if (!result2) {
       return FALSE;
     }
-    result2 = spdm_pqc_req_sig_set_public_key (spdm_context->connection_info.algorithm.pqc_req_sig_algo, pqc_public_key, pqc_public_key_size, &context);
-    if (!result2) {
-      return FALSE;
-    }
-    result2 = spdm_pqc_req_sig_verify (
+    result2 = spdm_pqc_req_sig_verify_segments (
                 spdm_context->connection_info.algorithm.pqc_req_sig_algo,
                 context,
-                th_curr_data,
-                th_curr_data_size,
+                th_curr.segment,
+                th_curr.segment_count,
                 (uint8 *)(pqc_sigature_length_ptr + 1),
                 *pqc_sigature_length_ptr
                 );
-    spdm_pqc_req_sig_free (spdm_context->connection_info.algorithm.pqc_req_sig_algo, context);
   } else {
     asym_signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg) +
                           PQC_SIG_SIGNATURE_LENGTH_SIZE +
                           spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
-    result = spdm_hybrid_get_public_key_from_x509 (mut_cert_buffer, mut_cert_buffer_size, &context);
+    result = spdm_get_peer_hybrid_public_key_context (spdm_context, &context);
     if (!result) {
       return FALSE;
     }
 
-    result = spdm_hybrid_sig_verify (
+    result = spdm_hybrid_sig_verify_segments (
               context,
-              th_curr_data,
-              th_curr_data_size,
+              th_curr.segment,
+              th_curr.segment_count,
               sign_data,
               asym_signature_size
               );
-    spdm_hybrid_sig_free (context);
   }
 
   if (spdm_context->local_context.pqc_public_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
@@ -916,8 +886,7 @@ spdm_verify_finish_req_hmac (
   uintn                         mut_cert_chain_data_size;
   uintn                         hash_size;
   boolean                       result;
-  uint8                         th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                         th_curr_data_size;
+  spdm_th_segments_t               th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
   ASSERT (hmac_size == hash_size);
@@ -937,18 +906,17 @@ spdm_verify_finish_req_hmac (
     mut_cert_chain_data_size = 0;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_request_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, hmac_data);
+  spdm_hmac_all_with_request_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
-  if (compare_mem(hmac, hmac_data, hash_size) != 0) {
+  if (const_compare_mem (hmac, hmac_data, hash_size) != 0) {
     DEBUG((DEBUG_INFO, "!!! verify_finish_req_hmac - FAIL !!!\n"));
     return FALSE;
   }
@@ -980,8 +948,7 @@ spdm_generate_finish_rsp_hmac (
   uintn                         mut_cert_chain_data_size;
   uint32                        hash_size;
   boolean                       result;
-  uint8                         th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                         th_curr_data_size;
+  spdm_th_segments_t               th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
 
@@ -1000,13 +967,12 @@ spdm_generate_finish_rsp_hmac (
     mut_cert_chain_data_size = 0;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_response_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, hmac_data);
+  spdm_hmac_all_with_response_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
@@ -1042,8 +1008,7 @@ spdm_verify_finish_rsp_hmac (
   uint8                                     *mut_cert_chain_data;
   uintn                                     mut_cert_chain_data_size;
   boolean                                   result;
-  uint8                                     th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                                     th_curr_data_size;
+  spdm_th_segments_t                           th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
   ASSERT(hash_size == hmac_data_size);
@@ -1063,18 +1028,17 @@ spdm_verify_finish_rsp_hmac (
     mut_cert_chain_data_size = 0;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_response_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, calc_hmac_data);
+  spdm_hmac_all_with_response_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, calc_hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (calc_hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
-  if (compare_mem (calc_hmac_data, hmac_data, hash_size) != 0) {
+  if (const_compare_mem (calc_hmac_data, hmac_data, hash_size) != 0) {
     DEBUG((DEBUG_INFO, "!!! verify_finish_rsp_hmac - FAIL !!!\n"));
     return FALSE;
   }
@@ -1103,18 +1067,16 @@ spdm_generate_psk_exchange_rsp_hmac (
   uint8                         hmac_data[MAX_HASH_SIZE];
   uint32                        hash_size;
   boolean                       result;
-  uint8                         th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                         th_curr_data_size;
+  spdm_th_segments_t               th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_exchange (spdm_context, session_info, NULL, 0, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_exchange (spdm_context, session_info, NULL, 0, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_response_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, hmac_data);
+  spdm_hmac_all_with_response_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
@@ -1146,24 +1108,22 @@ spdm_verify_psk_exchange_rsp_hmac (
   uintn                                     hash_size;
   uint8                                     calc_hmac_data[MAX_HASH_SIZE];
   boolean                                   result;
-  uint8                                     th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                                     th_curr_data_size;
+  spdm_th_segments_t                           th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
   ASSERT(hash_size == hmac_data_size);
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_exchange (spdm_context, session_info, NULL, 0, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_exchange (spdm_context, session_info, NULL, 0, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_response_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, calc_hmac_data);
+  spdm_hmac_all_with_response_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, calc_hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (calc_hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
-  if (compare_mem (calc_hmac_data, hmac_data, hash_size) != 0) {
+  if (const_compare_mem (calc_hmac_data, hmac_data, hash_size) != 0) {
     DEBUG((DEBUG_INFO, "!!! verify_psk_exchange_rsp_hmac - FAIL !!!\n"));
     return FALSE;
   }
@@ -1192,18 +1152,16 @@ spdm_generate_psk_exchange_req_hmac (
   uintn                                     hash_size;
   uint8                                     calc_hmac_data[MAX_HASH_SIZE];
   boolean                                   result;
-  uint8                                     th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                                     th_curr_data_size;
+  spdm_th_segments_t                           th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, NULL, 0, NULL, 0, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, NULL, 0, NULL, 0, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_request_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, calc_hmac_data);
+  spdm_hmac_all_with_request_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, calc_hmac_data);
   DEBUG((DEBUG_INFO, "th_curr hmac - "));
   internal_dump_data (calc_hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
@@ -1235,24 +1193,22 @@ spdm_verify_psk_finish_req_hmac (
   uint8                         hmac_data[MAX_HASH_SIZE];
   uint32                        hash_size;
   boolean                       result;
-  uint8                         th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                         th_curr_data_size;
+  spdm_th_segments_t               th_curr;
 
   hash_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
   ASSERT (hmac_size == hash_size);
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, NULL, 0, NULL, 0, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, NULL, 0, NULL, 0, &th_curr);
   if (!result) {
     return FALSE;
   }
 
-  spdm_hmac_all_with_request_finished_key (session_info->secured_message_context, th_curr_data, th_curr_data_size, hmac_data);
+  spdm_hmac_all_with_request_finished_key_segments (session_info->secured_message_context, th_curr.segment, th_curr.segment_count, hmac_data);
   DEBUG((DEBUG_INFO, "Calc th_curr hmac - "));
   internal_dump_data (hmac_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
-  if (compare_mem(hmac, hmac_data, hash_size) != 0) {
+  if (const_compare_mem (hmac, hmac_data, hash_size) != 0) {
     DEBUG((DEBUG_INFO, "!!! verify_psk_finish_req_hmac - FAIL !!!\n"));
     return FALSE;
   }
@@ -1284,8 +1240,6 @@ spdm_calculate_th1_hash (
   uintn                          cert_chain_data_size;
   spdm_session_info_t              *session_info;
   boolean                        result;
-  uint8                          th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                          th_curr_data_size;
 
   spdm_context = context;
 
@@ -1309,13 +1263,10 @@ spdm_calculate_th1_hash (
     cert_chain_data_size = 0;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_hash_for_exchange (spdm_context, session_info, cert_chain_data, cert_chain_data_size, th1_hash_data);
   if (!result) {
     return RETURN_SECURITY_VIOLATION;
   }
-
-  spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, th_curr_data, th_curr_data_size, th1_hash_data);
   DEBUG((DEBUG_INFO, "th1 hash - "));
   internal_dump_data (th1_hash_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
@@ -1349,8 +1300,6 @@ spdm_calculate_th2_hash (
   uintn                          mut_cert_chain_data_size;
   spdm_session_info_t              *session_info;
   boolean                        result;
-  uint8                          th_curr_data[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
-  uintn                          th_curr_data_size;
 
   spdm_context = context;
 
@@ -1389,16 +1338,187 @@ spdm_calculate_th2_hash (
     mut_cert_chain_data_size = 0;
   }
 
-  th_curr_data_size = sizeof(th_curr_data);
-  result = spdm_calculate_th_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, &th_curr_data_size, th_curr_data);
+  result = spdm_calculate_th_hash_for_finish (spdm_context, session_info, cert_chain_data, cert_chain_data_size, mut_cert_chain_data, mut_cert_chain_data_size, th2_hash_data);
   if (!result) {
     return RETURN_SECURITY_VIOLATION;
   }
-
-  spdm_hash_all (spdm_context->connection_info.algorithm.bash_hash_algo, th_curr_data, th_curr_data_size, th2_hash_data);
   DEBUG((DEBUG_INFO, "th2 hash - "));
   internal_dump_data (th2_hash_data, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
   return RETURN_SUCCESS;
 }
+
+typedef struct {
+  spdm_context_t   *spdm_context;
+  boolean          is_requester;
+  void             *context;
+  const uint8      *peer_data;
+  uintn            peer_data_size;
+  uint8            *cipher_text;
+  uintn            cipher_text_size;
+  uint8            shared_secret[MAX_DHE_KEY_SIZE];
+  uintn            shared_secret_size;
+  boolean          result;
+} spdm_key_exchange_job_context_t;
+
+/**
+  The job to compute the DHE shared secret.
+
+  @param  context                       The key exchange job context.
+**/
+void
+spdm_dhe_compute_key_job (
+  IN void  *context
+  )
+{
+  spdm_key_exchange_job_context_t  *job_context;
+
+  job_context = context;
+  job_context->shared_secret_size = sizeof(job_context->shared_secret);
+  job_context->result = spdm_dhe_compute_key (
+                          job_context->spdm_context->connection_info.algorithm.dhe_named_group,
+                          job_context->context,
+                          job_context->peer_data,
+                          job_context->peer_data_size,
+                          job_context->shared_secret,
+                          &job_context->shared_secret_size
+                          );
+}
+
+/**
+  The job to compute the PQC KEM shared secret.
+  The responder encapsulates the shared secret with the peer public key,
+  and the requester decapsulates the shared secret from the cipher text.
+
+  @param  context                       The key exchange job context.
+**/
+void
+spdm_pqc_kem_compute_key_job (
+  IN void  *context
+  )
+{
+  spdm_key_exchange_job_context_t  *job_context;
+
+  job_context = context;
+  job_context->shared_secret_size = MAX_PQC_KEM_SHARED_KEY_SIZE;
+  if (job_context->is_requester) {
+    job_context->result = spdm_pqc_kem_decap (
+                            job_context->spdm_context->connection_info.algorithm.pqc_kem_algo,
+                            job_context->context,
+                            job_context->shared_secret,
+                            &job_context->shared_secret_size,
+                            (uint8 *)job_context->peer_data,
+                            job_context->peer_data_size
+                            );
+  } else {
+    job_context->result = spdm_pqc_kem_encap (
+                            job_context->spdm_context->connection_info.algorithm.pqc_kem_algo,
+                            job_context->context,
+                            job_context->peer_data,
+                            job_context->peer_data_size,
+                            job_context->shared_secret,
+                            &job_context->shared_secret_size,
+                            job_context->cipher_text,
+                            &job_context->cipher_text_size
+                            );
+  }
+}
+
+/**
+  This function computes the DHE shared secret and the PQC KEM shared secret of a KEY_EXCHANGE,
+  and imports them to the secured message context.
+
+  The two shared secrets are computed in parallel if the worker pool is enabled.
+  They are always imported in the fixed order, DHE shared secret first, then PQC KEM shared secret.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate of the key exchange for a requester or a responder.
+  @param  spdm_secured_message_context  A pointer to the SPDM secured message context.
+  @param  dhe_context                   The DHE context with the generated key.
+  @param  peer_dhe_public_key           The peer DHE public key.
+  @param  peer_dhe_public_key_size      size in bytes of the peer DHE public key.
+  @param  pqc_kem_context               The PQC KEM context, or NULL if no PQC KEM is negotiated.
+  @param  pqc_kem_data                  The peer PQC KEM public key for the responder,
+                                        or the PQC KEM cipher text for the requester.
+  @param  pqc_kem_data_size             size in bytes of the pqc_kem_data.
+  @param  pqc_kem_cipher_text           The buffer to receive the PQC KEM cipher text for the responder.
+                                        It is ignored for the requester.
+  @param  pqc_kem_cipher_text_size      On input, size in bytes of the pqc_kem_cipher_text buffer.
+                                        On output, size in bytes of the PQC KEM cipher text.
+                                        It is ignored for the requester.
+
+  @retval TRUE  The shared secrets are computed and imported.
+  @retval FALSE The shared secrets cannot be computed.
+**/
+boolean
+spdm_compute_key_exchange_shared_secret (
+  IN     spdm_context_t           *spdm_context,
+  IN     boolean                  is_requester,
+  IN OUT void                     *spdm_secured_message_context,
+  IN OUT void                     *dhe_context,
+  IN     const uint8              *peer_dhe_public_key,
+  IN     uintn                    peer_dhe_public_key_size,
+  IN OUT void                     *pqc_kem_context,
+  IN     const uint8              *pqc_kem_data,
+  IN     uintn                    pqc_kem_data_size,
+     OUT uint8                    *pqc_kem_cipher_text,
+  IN OUT uintn                    *pqc_kem_cipher_text_size
+  )
+{
+  spdm_key_exchange_job_context_t  job_context[2];
+  spdm_job_t                       job[2];
+  uintn                            job_count;
+  boolean                          result;
+  return_status                    status;
+
+  zero_mem (job_context, sizeof(job_context));
+
+  job_context[0].spdm_context = spdm_context;
+  job_context[0].is_requester = is_requester;
+  job_context[0].context = dhe_context;
+  job_context[0].peer_data = peer_dhe_public_key;
+  job_context[0].peer_data_size = peer_dhe_public_key_size;
+  job[0].func = spdm_dhe_compute_key_job;
+  job[0].context = &job_context[0];
+  job_count = 1;
+
+  if (pqc_kem_context != NULL) {
+    job_context[1].spdm_context = spdm_context;
+    job_context[1].is_requester = is_requester;
+    job_context[1].context = pqc_kem_context;
+    job_context[1].peer_data = pqc_kem_data;
+    job_context[1].peer_data_size = pqc_kem_data_size;
+    if (!is_requester) {
+      job_context[1].cipher_text = pqc_kem_cipher_text;
+      job_context[1].cipher_text_size = *pqc_kem_cipher_text_size;
+    }
+    job[1].func = spdm_pqc_kem_compute_key_job;
+    job[1].context = &job_context[1];
+    job_count = 2;
+  } else {
+    job_context[1].result = TRUE;
+  }
+
+  spdm_run_jobs (spdm_context, job, job_count);
+
+  result = (boolean)(job_context[0].result && job_context[1].result);
+  if (result) {
+    status = spdm_secured_message_import_dhe_secret (spdm_secured_message_context, job_context[0].shared_secret, job_context[0].shared_secret_size);
+    if (RETURN_ERROR(status)) {
+      result = FALSE;
+    }
+  }
+  if (result && (pqc_kem_context != NULL)) {
+    status = spdm_secured_message_import_pqc_shared_secret (spdm_secured_message_context, job_context[1].shared_secret, job_context[1].shared_secret_size);
+    if (RETURN_ERROR(status)) {
+      result = FALSE;
+    }
+    if (!is_requester) {
+      *pqc_kem_cipher_text_size = job_context[1].cipher_text_size;
+    }
+  }
+
+  secure_zero_mem (job_context, sizeof(job_context));
+  return result;
+}
@@ -0,0 +1,305 @@
+/** @file
+  SPDM common library.
+  It follows the SPDM Specification.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_common_lib_internal.h"
+#include <library/threadlib.h>
+
+/**
+  This function generates an ephemeral key pair.
+
+  @param  dhe_named_group                SPDM dhe_named_group
+  @param  pqc_kem_algo                   SPDM pqc_kem_algo
+  @param  ephemeral_key                  The generated ephemeral key.
+
+  @retval TRUE  The ephemeral key is generated.
+  @retval FALSE The ephemeral key cannot be generated.
+**/
+boolean
+spdm_key_pool_generate_key (
+  IN     uint16                   dhe_named_group,
+  IN     pqc_algo_t               pqc_kem_algo,
+     OUT spdm_ephemeral_key_t     *ephemeral_key
+  )
+{
+  boolean  result;
+
+  zero_mem (ephemeral_key, sizeof(spdm_ephemeral_key_t));
+
+  ephemeral_key->dhe_context = spdm_secured_message_dhe_new (dhe_named_group);
+  if (ephemeral_key->dhe_context == NULL) {
+    return FALSE;
+  }
+  ephemeral_key->dhe_public_key_size = spdm_get_dhe_pub_key_size (dhe_named_group);
+  result = spdm_secured_message_dhe_generate_key (dhe_named_group, ephemeral_key->dhe_context, ephemeral_key->dhe_public_key, &ephemeral_key->dhe_public_key_size);
+  if (!result) {
+    spdm_secured_message_dhe_free (dhe_named_group, ephemeral_key->dhe_context);
+    return FALSE;
+  }
+
+  if (!spdm_pqc_algo_is_zero (pqc_kem_algo)) {
+    ephemeral_key->pqc_kem_context = spdm_secured_message_pqc_kem_new (pqc_kem_algo);
+    if (ephemeral_key->pqc_kem_context == NULL) {
+      spdm_secured_message_dhe_free (dhe_named_group, ephemeral_key->dhe_context);
+      return FALSE;
+    }
+    result = spdm_secured_message_pqc_kem_generate_key (pqc_kem_algo, ephemeral_key->pqc_kem_context);
+    if (!result) {
+      spdm_secured_message_pqc_kem_free (pqc_kem_algo, ephemeral_key->pqc_kem_context);
+      spdm_secured_message_dhe_free (dhe_named_group, ephemeral_key->dhe_context);
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  This function frees an ephemeral key pair.
+
+  @param  dhe_named_group                SPDM dhe_named_group
+  @param  pqc_kem_algo                   SPDM pqc_kem_algo
+  @param  ephemeral_key                  The ephemeral key to be freed.
+**/
+void
+spdm_key_pool_free_key (
+  IN     uint16                   dhe_named_group,
+  IN     pqc_algo_t               pqc_kem_algo,
+  IN OUT spdm_ephemeral_key_t     *ephemeral_key
+  )
+{
+  if (ephemeral_key->dhe_context != NULL) {
+    spdm_secured_message_dhe_free (dhe_named_group, ephemeral_key->dhe_context);
+  }
+  if (ephemeral_key->pqc_kem_context != NULL) {
+    spdm_secured_message_pqc_kem_free (pqc_kem_algo, ephemeral_key->pqc_kem_context);
+  }
+  zero_mem (ephemeral_key, sizeof(spdm_ephemeral_key_t));
+}
+
+/**
+  This function frees all keys in the pool.
+  The caller must hold the pool mutex, if the worker thread is running.
+
+  @param  key_pool                       The ephemeral key pool.
+**/
+void
+spdm_key_pool_flush (
+  IN OUT spdm_key_pool_t          *key_pool
+  )
+{
+  while (key_pool->key_count > 0) {
+    key_pool->key_count--;
+    spdm_key_pool_free_key (key_pool->dhe_named_group, key_pool->pqc_kem_algo, &key_pool->key[key_pool->key_count]);
+  }
+}
+
+/**
+  The worker thread of the ephemeral key pool.
+
+  The key is generated without holding the mutex, so that KEY_EXCHANGE is never blocked by key generation.
+
+  @param  context                        The ephemeral key pool.
+**/
+void
+spdm_key_pool_worker (
+  IN     void                     *context
+  )
+{
+  spdm_key_pool_t       *key_pool;
+  uint16                dhe_named_group;
+  pqc_algo_t            pqc_kem_algo;
+  spdm_ephemeral_key_t  ephemeral_key;
+  boolean               result;
+
+  key_pool = context;
+
+  mutex_lock (key_pool->mutex);
+  while (!key_pool->stop) {
+    if (!key_pool->refilling || (key_pool->key_count >= key_pool->high_watermark)) {
+      key_pool->refilling = FALSE;
+      cond_wait (key_pool->cond, key_pool->mutex);
+      continue;
+    }
+    dhe_named_group = key_pool->dhe_named_group;
+    copy_mem (pqc_kem_algo, key_pool->pqc_kem_algo, sizeof(pqc_algo_t));
+    mutex_unlock (key_pool->mutex);
+
+    result = spdm_key_pool_generate_key (dhe_named_group, pqc_kem_algo, &ephemeral_key);
+
+    mutex_lock (key_pool->mutex);
+    if (!result) {
+      DEBUG((DEBUG_INFO, "!!! key_pool - generate key fail !!!\n"));
+      key_pool->refilling = FALSE;
+      continue;
+    }
+    //
+    // Drop the key if the algorithms are changed while the key is generated.
+    //
+    if (key_pool->stop ||
+        (key_pool->key_count >= key_pool->depth) ||
+        (key_pool->dhe_named_group != dhe_named_group) ||
+        (compare_mem (key_pool->pqc_kem_algo, pqc_kem_algo, sizeof(pqc_algo_t)) != 0)) {
+      spdm_key_pool_free_key (dhe_named_group, pqc_kem_algo, &ephemeral_key);
+      continue;
+    }
+    copy_mem (&key_pool->key[key_pool->key_count], &ephemeral_key, sizeof(spdm_ephemeral_key_t));
+    key_pool->key_count++;
+    zero_mem (&ephemeral_key, sizeof(spdm_ephemeral_key_t));
+  }
+  mutex_unlock (key_pool->mutex);
+}
+
+/**
+  This function starts the worker thread of the ephemeral key pool, or wakes it up,
+  to fill the pool with keys of the negotiated DHE and PQC KEM algorithms.
+
+  The keys of other algorithms in the pool are freed.
+  This function does nothing if the pool is disabled.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_key_pool_start (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  spdm_key_pool_t  *key_pool;
+  uint16           dhe_named_group;
+  pqc_algo_t       *pqc_kem_algo;
+
+  key_pool = &spdm_context->key_pool;
+  if (key_pool->depth == 0) {
+    return ;
+  }
+  dhe_named_group = spdm_context->connection_info.algorithm.dhe_named_group;
+  pqc_kem_algo = &spdm_context->connection_info.algorithm.pqc_kem_algo;
+  if (dhe_named_group == 0) {
+    return ;
+  }
+
+  if (key_pool->thread == NULL) {
+    key_pool->mutex = mutex_new ();
+    key_pool->cond = cond_new ();
+    if ((key_pool->mutex == NULL) || (key_pool->cond == NULL)) {
+      spdm_key_pool_stop (spdm_context);
+      return ;
+    }
+    key_pool->stop = FALSE;
+    key_pool->refilling = FALSE;
+    key_pool->dhe_named_group = dhe_named_group;
+    copy_mem (key_pool->pqc_kem_algo, *pqc_kem_algo, sizeof(pqc_algo_t));
+    key_pool->thread = thread_create (spdm_key_pool_worker, key_pool);
+    if (key_pool->thread == NULL) {
+      spdm_key_pool_stop (spdm_context);
+      return ;
+    }
+  }
+
+  mutex_lock (key_pool->mutex);
+  if ((key_pool->dhe_named_group != dhe_named_group) ||
+      (compare_mem (key_pool->pqc_kem_algo, *pqc_kem_algo, sizeof(pqc_algo_t)) != 0)) {
+    spdm_key_pool_flush (key_pool);
+    key_pool->dhe_named_group = dhe_named_group;
+    copy_mem (key_pool->pqc_kem_algo, *pqc_kem_algo, sizeof(pqc_algo_t));
+  }
+  if (key_pool->key_count < key_pool->high_watermark) {
+    key_pool->refilling = TRUE;
+    cond_signal (key_pool->cond);
+  }
+  mutex_unlock (key_pool->mutex);
+}
+
+/**
+  This function stops the worker thread of the ephemeral key pool and frees all keys in the pool.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_key_pool_stop (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  spdm_key_pool_t  *key_pool;
+
+  key_pool = &spdm_context->key_pool;
+  if (key_pool->thread != NULL) {
+    mutex_lock (key_pool->mutex);
+    key_pool->stop = TRUE;
+    cond_broadcast (key_pool->cond);
+    mutex_unlock (key_pool->mutex);
+    thread_join (key_pool->thread);
+    key_pool->thread = NULL;
+  }
+  spdm_key_pool_flush (key_pool);
+  if (key_pool->cond != NULL) {
+    cond_free (key_pool->cond);
+    key_pool->cond = NULL;
+  }
+  if (key_pool->mutex != NULL) {
+    mutex_free (key_pool->mutex);
+    key_pool->mutex = NULL;
+  }
+  key_pool->stop = FALSE;
+  key_pool->refilling = FALSE;
+  key_pool->dhe_named_group = 0;
+  zero_mem (key_pool->pqc_kem_algo, sizeof(pqc_algo_t));
+}
+
+/**
+  This function removes one ephemeral key of the negotiated DHE and PQC KEM algorithms from the pool.
+
+  The caller owns the returned DHE and PQC KEM contexts and must free them after use.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  ephemeral_key                 The ephemeral key removed from the pool.
+
+  @retval TRUE  An ephemeral key is returned.
+  @retval FALSE The pool is disabled or empty. The caller must generate the key.
+**/
+boolean
+spdm_key_pool_acquire (
+  IN     spdm_context_t           *spdm_context,
+     OUT spdm_ephemeral_key_t     *ephemeral_key
+  )
+{
+  spdm_key_pool_t  *key_pool;
+  boolean          result;
+  boolean          need_refill;
+
+  key_pool = &spdm_context->key_pool;
+  if (key_pool->depth == 0) {
+    return FALSE;
+  }
+  if (key_pool->thread == NULL) {
+    spdm_key_pool_start (spdm_context);
+    return FALSE;
+  }
+
+  result = FALSE;
+  mutex_lock (key_pool->mutex);
+  if ((key_pool->key_count > 0) &&
+      (key_pool->dhe_named_group == spdm_context->connection_info.algorithm.dhe_named_group) &&
+      (compare_mem (key_pool->pqc_kem_algo, spdm_context->connection_info.algorithm.pqc_kem_algo, sizeof(pqc_algo_t)) == 0)) {
+    key_pool->key_count--;
+    copy_mem (ephemeral_key, &key_pool->key[key_pool->key_count], sizeof(spdm_ephemeral_key_t));
+    zero_mem (&key_pool->key[key_pool->key_count], sizeof(spdm_ephemeral_key_t));
+    result = TRUE;
+  }
+  need_refill = (boolean)(key_pool->key_count <= key_pool->low_watermark);
+  mutex_unlock (key_pool->mutex);
+
+  //
+  // Refill the pool, or switch it to the negotiated algorithms.
+  //
+  if (!result || need_refill) {
+    spdm_key_pool_start (spdm_context);
+  }
+
+  return result;
+}
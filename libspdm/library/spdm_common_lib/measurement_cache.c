@@ -0,0 +1,247 @@
+/** @file
+  SPDM common library.
+  It follows the SPDM Specification.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_common_lib_internal.h"
+
+/**
+  This function invalidates a measurement cache entry, and releases its buffer to the arena.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  entry                         The measurement cache entry.
+**/
+void
+spdm_measurement_cache_entry_free (
+  IN     spdm_context_t                 *spdm_context,
+  IN OUT spdm_measurement_cache_entry_t *entry
+  )
+{
+  spdm_arena_free (&spdm_context->arena, entry->device_measurement);
+  zero_mem (entry, sizeof(spdm_measurement_cache_entry_t));
+}
+
+/**
+  This function finds the measurement cache entry of the negotiated measurement specification
+  and measurement hash algorithm.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the entry, or NULL if the cache is disabled or the measurement is not cached.
+**/
+spdm_measurement_cache_entry_t *
+spdm_measurement_cache_find (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  spdm_measurement_cache_t        *cache;
+  spdm_measurement_cache_entry_t  *entry;
+  uintn                           index;
+
+  cache = &spdm_context->measurement_cache;
+  if (!cache->enabled) {
+    return NULL;
+  }
+  for (index = 0; index < MAX_SPDM_MEASUREMENT_CACHE_ENTRY_COUNT; index++) {
+    entry = &cache->entry[index];
+    if (entry->valid &&
+        (entry->generation == cache->generation) &&
+        (entry->measurement_spec == spdm_context->connection_info.algorithm.measurement_spec) &&
+        (entry->measurement_hash_algo == spdm_context->connection_info.algorithm.measurement_hash_algo)) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+/**
+  This function collects the device measurement with the negotiated measurement specification
+  and measurement hash algorithm.
+
+  The measurement is returned from the measurement cache if it is enabled and valid,
+  otherwise it is collected by spdm_measurement_collection and it is cached.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  device_measurement_count       The count of the device measurement block.
+  @param  device_measurement            A pointer to a destination buffer to store the concatenation of all device measurement blocks.
+  @param  device_measurement_size        On input, indicates the size in bytes of the destination buffer.
+                                       On output, indicates the size in bytes of all device measurement blocks in the buffer.
+
+  @retval TRUE  the device measurement is returned.
+  @retval FALSE the device measurement collection fail.
+**/
+boolean
+spdm_collect_measurement (
+  IN     spdm_context_t           *spdm_context,
+     OUT uint8                    *device_measurement_count,
+     OUT void                     *device_measurement,
+  IN OUT uintn                    *device_measurement_size
+  )
+{
+  spdm_measurement_cache_t        *cache;
+  spdm_measurement_cache_entry_t  *entry;
+  uintn                           index;
+  boolean                         ret;
+
+  cache = &spdm_context->measurement_cache;
+  entry = spdm_measurement_cache_find (spdm_context);
+  if (entry != NULL) {
+    if (*device_measurement_size < entry->device_measurement_size) {
+      return FALSE;
+    }
+    *device_measurement_count = entry->device_measurement_count;
+    *device_measurement_size = entry->device_measurement_size;
+    copy_mem (device_measurement, entry->device_measurement, entry->device_measurement_size);
+    return TRUE;
+  }
+
+  ret = spdm_measurement_collection (
+          spdm_context->connection_info.algorithm.measurement_spec,
+          spdm_context->connection_info.algorithm.measurement_hash_algo,
+          device_measurement_count,
+          device_measurement,
+          device_measurement_size
+          );
+  if (!ret || !cache->enabled) {
+    return ret;
+  }
+
+  //
+  // Replace an invalid entry, or the entries one after another.
+  //
+  entry = NULL;
+  for (index = 0; index < MAX_SPDM_MEASUREMENT_CACHE_ENTRY_COUNT; index++) {
+    if (!cache->entry[index].valid || (cache->entry[index].generation != cache->generation)) {
+      entry = &cache->entry[index];
+      break;
+    }
+  }
+  if (entry == NULL) {
+    entry = &cache->entry[cache->next_entry];
+    cache->next_entry = (uint8)((cache->next_entry + 1) % MAX_SPDM_MEASUREMENT_CACHE_ENTRY_COUNT);
+  }
+  spdm_measurement_cache_entry_free (spdm_context, entry);
+
+  entry->device_measurement = spdm_arena_allocate (&spdm_context->arena, *device_measurement_size, NULL);
+  if (entry->device_measurement == NULL) {
+    return TRUE;
+  }
+  copy_mem (entry->device_measurement, device_measurement, *device_measurement_size);
+  entry->device_measurement_size = *device_measurement_size;
+  entry->device_measurement_count = *device_measurement_count;
+  entry->measurement_spec = spdm_context->connection_info.algorithm.measurement_spec;
+  entry->measurement_hash_algo = spdm_context->connection_info.algorithm.measurement_hash_algo;
+  entry->generation = cache->generation;
+  entry->valid = TRUE;
+  return TRUE;
+}
+
+/**
+  This function gets the measurement summary hash from the measurement cache.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  measurement_summary_hash_type   The type of the measurement summary hash, TCB or ALL.
+  @param  measurement_summary_hash       The buffer to store the measurement summary hash.
+
+  @retval TRUE  The measurement summary hash is returned.
+  @retval FALSE The measurement summary hash is not cached.
+**/
+boolean
+spdm_measurement_cache_get_summary_hash (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint8                    measurement_summary_hash_type,
+     OUT uint8                    *measurement_summary_hash
+  )
+{
+  spdm_measurement_cache_entry_t  *entry;
+  uint32                          hash_algo;
+
+  entry = spdm_measurement_cache_find (spdm_context);
+  hash_algo = spdm_context->connection_info.algorithm.bash_hash_algo;
+  if ((entry == NULL) || (entry->summary_hash_algo != hash_algo)) {
+    return FALSE;
+  }
+
+  switch (measurement_summary_hash_type) {
+  case SPDM_CHALLENGE_REQUEST_TCB_COMPONENT_MEASUREMENT_HASH:
+    if (!entry->tcb_summary_hash_valid) {
+      return FALSE;
+    }
+    copy_mem (measurement_summary_hash, entry->tcb_summary_hash, spdm_get_hash_size (hash_algo));
+    return TRUE;
+  case SPDM_CHALLENGE_REQUEST_ALL_MEASUREMENTS_HASH:
+    if (!entry->all_summary_hash_valid) {
+      return FALSE;
+    }
+    copy_mem (measurement_summary_hash, entry->all_summary_hash, spdm_get_hash_size (hash_algo));
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+
+/**
+  This function saves the measurement summary hash to the measurement cache.
+
+  The hash is saved only if the measurement of the negotiated algorithms is cached.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  measurement_summary_hash_type   The type of the measurement summary hash, TCB or ALL.
+  @param  measurement_summary_hash       The measurement summary hash.
+**/
+void
+spdm_measurement_cache_set_summary_hash (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint8                    measurement_summary_hash_type,
+  IN     uint8                    *measurement_summary_hash
+  )
+{
+  spdm_measurement_cache_entry_t  *entry;
+  uint32                          hash_algo;
+
+  entry = spdm_measurement_cache_find (spdm_context);
+  if (entry == NULL) {
+    return ;
+  }
+  hash_algo = spdm_context->connection_info.algorithm.bash_hash_algo;
+  if (entry->summary_hash_algo != hash_algo) {
+    entry->summary_hash_algo = hash_algo;
+    entry->tcb_summary_hash_valid = FALSE;
+    entry->all_summary_hash_valid = FALSE;
+  }
+
+  switch (measurement_summary_hash_type) {
+  case SPDM_CHALLENGE_REQUEST_TCB_COMPONENT_MEASUREMENT_HASH:
+    copy_mem (entry->tcb_summary_hash, measurement_summary_hash, spdm_get_hash_size (hash_algo));
+    entry->tcb_summary_hash_valid = TRUE;
+    break;
+  case SPDM_CHALLENGE_REQUEST_ALL_MEASUREMENTS_HASH:
+    copy_mem (entry->all_summary_hash, measurement_summary_hash, spdm_get_hash_size (hash_algo));
+    entry->all_summary_hash_valid = TRUE;
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+  This function invalidates the measurement cache, and releases the buffers to the arena.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_measurement_cache_flush (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  uintn  index;
+
+  for (index = 0; index < MAX_SPDM_MEASUREMENT_CACHE_ENTRY_COUNT; index++) {
+    spdm_measurement_cache_entry_free (spdm_context, &spdm_context->measurement_cache.entry[index]);
+  }
+  spdm_context->measurement_cache.next_entry = 0;
+}
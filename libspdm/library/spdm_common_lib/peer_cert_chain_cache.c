@@ -0,0 +1,169 @@
+/** @file
+  SPDM common library.
+  It follows the SPDM Specification.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_common_lib_internal.h"
+
+/**
+  This function invalidates a peer certificate chain cache entry, and releases its buffer to the arena.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  entry                         The peer certificate chain cache entry.
+**/
+void
+spdm_peer_cert_chain_cache_entry_free (
+  IN     spdm_context_t                     *spdm_context,
+  IN OUT spdm_peer_cert_chain_cache_entry_t *entry
+  )
+{
+  spdm_arena_free (&spdm_context->arena, entry->cert_chain);
+  zero_mem (entry, sizeof(spdm_peer_cert_chain_cache_entry_t));
+}
+
+/**
+  This function finds the cached peer certificate chain whose digest is returned by GET_DIGESTS
+  in the current connection.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  slot_id                       The number of slot for the certificate chain.
+
+  @return the cache entry, or NULL if the certificate chain of the slot is not cached.
+**/
+spdm_peer_cert_chain_cache_entry_t *
+spdm_peer_cert_chain_cache_find (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint8                    slot_id
+  )
+{
+  spdm_peer_cert_chain_cache_t        *cache;
+  spdm_peer_cert_chain_cache_entry_t  *entry;
+  uint32                              hash_algo;
+  uintn                               hash_size;
+  uint8                               *digest;
+  uintn                               index;
+
+  cache = &spdm_context->peer_cert_chain_cache;
+  if (!cache->enabled) {
+    return NULL;
+  }
+  //
+  // The digests are valid only after GET_DIGESTS in the current connection.
+  //
+  if (spdm_context->connection_info.connection_state != SPDM_CONNECTION_STATE_AFTER_DIGESTS) {
+    return NULL;
+  }
+  if ((slot_id >= MAX_SPDM_SLOT_COUNT) ||
+      ((spdm_context->connection_info.peer_digest_slot_mask & (1 << slot_id)) == 0)) {
+    return NULL;
+  }
+
+  hash_algo = spdm_context->connection_info.algorithm.bash_hash_algo;
+  hash_size = spdm_get_hash_size (hash_algo);
+  //
+  // The digests are in the order of the slot mask.
+  //
+  digest = spdm_context->connection_info.peer_digest;
+  for (index = 0; index < slot_id; index++) {
+    if ((spdm_context->connection_info.peer_digest_slot_mask & (1 << index)) != 0) {
+      digest += hash_size;
+    }
+  }
+
+  for (index = 0; index < MAX_SPDM_PEER_CERT_CHAIN_CACHE_ENTRY_COUNT; index++) {
+    entry = &cache->entry[index];
+    if (entry->valid &&
+        (entry->hash_algo == hash_algo) &&
+        (compare_mem (entry->digest, digest, hash_size) == 0)) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+/**
+  This function adds a verified peer certificate chain to the cache.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  cert_chain                    The certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_size               size in bytes of the certificate chain buffer.
+**/
+void
+spdm_peer_cert_chain_cache_add (
+  IN     spdm_context_t           *spdm_context,
+  IN     void                     *cert_chain,
+  IN     uintn                    cert_chain_size
+  )
+{
+  spdm_peer_cert_chain_cache_t        *cache;
+  spdm_peer_cert_chain_cache_entry_t  *entry;
+  uint32                              hash_algo;
+  uint8                               digest[MAX_HASH_SIZE];
+  uintn                               index;
+
+  cache = &spdm_context->peer_cert_chain_cache;
+  if (!cache->enabled) {
+    return ;
+  }
+
+  hash_algo = spdm_context->connection_info.algorithm.bash_hash_algo;
+  spdm_hash_all (hash_algo, cert_chain, cert_chain_size, digest);
+
+  //
+  // Replace the entry of the same certificate chain, an invalid entry, or the entries one after another.
+  //
+  entry = NULL;
+  for (index = 0; index < MAX_SPDM_PEER_CERT_CHAIN_CACHE_ENTRY_COUNT; index++) {
+    if (cache->entry[index].valid &&
+        (cache->entry[index].hash_algo == hash_algo) &&
+        (compare_mem (cache->entry[index].digest, digest, spdm_get_hash_size (hash_algo)) == 0)) {
+      entry = &cache->entry[index];
+      break;
+    }
+  }
+  if (entry == NULL) {
+    for (index = 0; index < MAX_SPDM_PEER_CERT_CHAIN_CACHE_ENTRY_COUNT; index++) {
+      if (!cache->entry[index].valid) {
+        entry = &cache->entry[index];
+        break;
+      }
+    }
+  }
+  if (entry == NULL) {
+    entry = &cache->entry[cache->next_entry];
+    cache->next_entry = (uint8)((cache->next_entry + 1) % MAX_SPDM_PEER_CERT_CHAIN_CACHE_ENTRY_COUNT);
+  }
+  spdm_peer_cert_chain_cache_entry_free (spdm_context, entry);
+
+  entry->cert_chain = spdm_arena_allocate (&spdm_context->arena, cert_chain_size, NULL);
+  if (entry->cert_chain == NULL) {
+    return ;
+  }
+  copy_mem (entry->cert_chain, cert_chain, cert_chain_size);
+  entry->cert_chain_size = cert_chain_size;
+  entry->hash_algo = hash_algo;
+  copy_mem (entry->digest, digest, spdm_get_hash_size (hash_algo));
+  entry->valid = TRUE;
+}
+
+/**
+  This function invalidates the peer certificate chain cache, and releases the buffers to the arena.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_peer_cert_chain_cache_flush (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  uintn  index;
+
+  for (index = 0; index < MAX_SPDM_PEER_CERT_CHAIN_CACHE_ENTRY_COUNT; index++) {
+    spdm_peer_cert_chain_cache_entry_free (spdm_context, &spdm_context->peer_cert_chain_cache.entry[index]);
+  }
+  spdm_context->peer_cert_chain_cache.next_entry = 0;
+}
@@ -16,6 +16,29 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define INVALID_SESSION_ID  0
 
+//
+// The window of FRAGMENT_REQUEST is a libspdm extension. It uses bits that are reserved in SPDM 1.1,
+// so both sides must enable SPDM_DATA_FRAGMENT_WINDOW_SIZE before it is used.
+//
+// Windowed Fragment Request (window=2):
+//    SPDM_FRAGMENT_REQUEST (BEGIN, Window=2, Seq=0)
+//         SPDM_FRAGMENT_REQUEST_ACK (Window=2, Seq=0)
+//    SPDM_FRAGMENT_REQUEST (Seq=1)
+//    SPDM_FRAGMENT_REQUEST (Seq=2)
+//         SPDM_FRAGMENT_REQUEST_ACK (Seq=2)
+//    SPDM_FRAGMENT_REQUEST (Seq=3)
+//    SPDM_FRAGMENT_REQUEST (END, Seq=4)
+//         SPDM_RESPONSE
+//
+// The requester proposes its window in the upper bits of the BEGIN fragment attributes,
+// and the responder returns the accepted window in param1 of the ACK of the BEGIN fragment.
+// 0 in either of them means every fragment is acknowledged.
+// The responder does not respond inside the window. The first error in the window is returned
+// instead of the ACK at the end of the window, and the fragment state is reset.
+//
+#define SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_MASK    0xF0
+#define SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_SHIFT   4
+
 typedef struct {
   uint8                spdm_version_count;
   spdm_version_number_t  spdm_version[MAX_SPDM_VERSION_COUNT];
@@ -24,6 +47,7 @@ typedef struct {
 typedef struct {
   uint8                ct_exponent;
   uint32               flags;
+  uint32               data_transfer_size;
 } spdm_device_capability_t;
 
 typedef struct {
@@ -110,11 +134,16 @@ typedef struct {
   spdm_device_algorithm_t           algorithm;
   spdm_device_version_t             secured_message_version;
   //
-  // Peer CertificateChain
+  // Peer CertificateChain, allocated from the arena by spdm_set_peer_used_cert_chain_buffer.
   //
-  uint8                           peer_used_cert_chain_buffer[MAX_SPDM_CERT_CHAIN_SIZE];
+  uint8                           *peer_used_cert_chain_buffer;
   uintn                           peer_used_cert_chain_buffer_size;
   //
+  // Peer certificate chain digests returned by GET_DIGESTS, in the order of the slot mask
+  //
+  uint8                           peer_digest_slot_mask;
+  uint8                           peer_digest[MAX_HASH_SIZE * MAX_SPDM_SLOT_COUNT];
+  //
   // Local Used CertificateChain (for responder, or requester in mut auth)
   //
   uint8                           *local_used_cert_chain_buffer;
@@ -129,27 +158,111 @@ typedef struct {
   //
   uint8                           *pqc_local_used_public_key;
   uintn                           pqc_local_used_public_key_size;
+  //
+  // Peer public key contexts for signature verification.
+  // They are created from the peer certificate chain or the peer PQC pubkey at first use,
+  // and freed when the peer certificate chain or PQC pubkey is changed.
+  //
+  void                            *peer_asym_public_key_context;
+  uint32                          peer_asym_public_key_algo;
+  void                            *peer_pqc_public_key_context;
+  pqc_algo_t                      peer_pqc_public_key_algo;
+  void                            *peer_hybrid_public_key_context;
 } spdm_connection_info_t;
 
+//
+// The per-context arena for the large buffers.
+// The blocks are allocated on demand in power-of-2 sizes. A released block is cached in the free list
+// of its size class, and it is reused by the next connection or session.
+//
+#define SPDM_ARENA_MIN_BLOCK_SIZE  0x400
+#define SPDM_ARENA_CLASS_COUNT     16
+
+typedef struct _spdm_arena_block_t {
+  struct _spdm_arena_block_t      *next;
+  uintn                           size;
+//uint8                           buffer[size - sizeof(spdm_arena_block_t)];
+} spdm_arena_block_t;
+
+typedef struct {
+  //
+  // The limit of the memory allocated by the arena. There is no limit if it is 0.
+  //
+  uintn                           max_size;
+  //
+  // The memory allocated by the arena, and the memory of the blocks in use.
+  //
+  uintn                           allocated_size;
+  uintn                           used_size;
+  spdm_arena_block_t              *free_block[SPDM_ARENA_CLASS_COUNT];
+  //
+  // The mutex is created only if the buffers are allocated by more than one thread,
+  // such as a request deferred to the worker pool.
+  //
+  void                            *mutex;
+} spdm_arena_t;
 
 typedef struct {
-  uintn   max_buffer_size;
-  uintn   buffer_size;
+  uintn          max_buffer_size;
+  uintn          buffer_size;
+  spdm_arena_t   *arena;
 //uint8   buffer[max_buffer_size];
 } managed_buffer_t;
 
 typedef struct {
-  uintn   max_buffer_size;
-  uintn   buffer_size;
-  uint8   buffer[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
+  uintn          max_buffer_size;
+  uintn          buffer_size;
+  spdm_arena_t   *arena;
+  uint8          buffer[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
 } large_managed_buffer_t;
 
 typedef struct {
-  uintn   max_buffer_size;
-  uintn   buffer_size;
-  uint8   buffer[MAX_SPDM_MESSAGE_SMALL_BUFFER_SIZE];
+  uintn          max_buffer_size;
+  uintn          buffer_size;
+  spdm_arena_t   *arena;
+  uint8          buffer[MAX_SPDM_MESSAGE_SMALL_BUFFER_SIZE];
 } small_managed_buffer_t;
 
+//
+// A large managed buffer whose data is allocated from the arena on demand.
+// The data grows with the appended messages, and it is released to the arena on reset.
+//
+typedef struct {
+  uintn          max_buffer_size;
+  uintn          buffer_size;
+  spdm_arena_t   *arena;
+  uint8          *buffer;
+  uintn          capacity;
+} arena_managed_buffer_t;
+
+#define MAX_SPDM_TRANSCRIPT_SEGMENT_COUNT  5
+#define MAX_SPDM_M1M2_SEGMENT_COUNT        3
+
+//
+// One piece of a transcript, in the order it is concatenated.
+// If hash_data is TRUE, hash(data) is concatenated instead of data, e.g. for a certificate chain.
+//
+typedef struct {
+  const void   *data;
+  uintn        size;
+  boolean      hash_data;
+} spdm_transcript_segment_t;
+
+//
+// Running hash of a transcript.
+//
+// hash_context holds the digest state of every byte already consumed from each segment,
+// so that a checkpoint only hashes the bytes appended since the previous one, then forks
+// the state with spdm_hash_duplicate() to finalize. The state is restarted from the
+// managed buffers if a segment no longer extends what was consumed.
+//
+typedef struct {
+  boolean  valid;
+  uint32   bash_hash_algo;
+  uintn    consumed_size[MAX_SPDM_TRANSCRIPT_SEGMENT_COUNT];
+  uint8    hash_context[MAX_HASH_CONTEXT_SIZE];
+} spdm_transcript_hash_t;
+
 typedef struct {
   //
   // signature = Sign(SK, hash(M1))
@@ -165,9 +278,9 @@ typedef struct {
   // MutC = Concatenate (CHALLENGE, CHALLENGE_AUTH\signature)
   //
   small_managed_buffer_t            message_a;
-  large_managed_buffer_t            message_b;
+  arena_managed_buffer_t            message_b;
   small_managed_buffer_t            message_c;
-  large_managed_buffer_t            message_mut_b;
+  arena_managed_buffer_t            message_mut_b;
   small_managed_buffer_t            message_mut_c;
   //
   // signature = Sign(SK, hash(L1))
@@ -176,7 +289,13 @@ typedef struct {
   // L1/L2 = Concatenate (M)
   // M = Concatenate (GET_MEASUREMENT, MEASUREMENT\signature)
   //
-  large_managed_buffer_t            message_m;
+  arena_managed_buffer_t            message_m;
+  //
+  // Running hash of M1M2 (A, B, C), mut M1M2 (MutB, MutC) and L1L2 (M).
+  //
+  spdm_transcript_hash_t            digest_m1m2;
+  spdm_transcript_hash_t            digest_mut_m1m2;
+  spdm_transcript_hash_t            digest_l1l2;
 } spdm_transcript_t;
 
 typedef struct {
@@ -211,8 +330,8 @@ typedef struct {
   // CM = mutual certificate chain *
   // F  = Concatenate (FINISH request, FINISH response)
   //
-  large_managed_buffer_t            message_k;
-  large_managed_buffer_t            message_f;
+  arena_managed_buffer_t            message_k;
+  arena_managed_buffer_t            message_f;
   //
   // TH for PSK_EXCHANGE response HMAC: Concatenate (A, K)
   // K  = Concatenate (PSK_EXCHANGE request, PSK_EXCHANGE response\verify_data)
@@ -232,15 +351,35 @@ typedef struct {
   // K  = Concatenate (PSK_EXCHANGE request, PSK_EXCHANGE response)
   // F  = Concatenate (PSK_FINISH request, PSK_FINISH response)
   //
+  //
+  // Running hash of TH (A, Ct, K, CM, F).
+  //
+  spdm_transcript_hash_t            digest_th;
 } spdm_session_transcript_t;
 
-typedef struct {
+//
+// The session table count is limited by the 16-bit half of session ID.
+//
+#define MAX_SPDM_SESSION_TABLE_COUNT  0xFFFF
+
+typedef struct _spdm_session_info_t {
   uint32                               session_id;
   boolean                              use_psk;
   uint8                                mut_auth_requested;
   uint8                                end_session_attributes;
   spdm_session_transcript_t              session_transcript;
+  //
+  // The fields below are kept by spdm_session_info_init.
+  // The secured message context is allocated from the arena when the session is used first.
+  //
   void                                 *secured_message_context;
+  //
+  // A session in use is linked in the hash bucket of its session_id.
+  // A free session is linked in the free list.
+  //
+  struct _spdm_session_info_t          *hash_next;
+  struct _spdm_session_info_t          *free_prev;
+  struct _spdm_session_info_t          *free_next;
 } spdm_session_info_t;
 
 #define MAX_ENCAP_REQUEST_OP_CODE_SEQUENCE_COUNT 3
@@ -255,9 +394,216 @@ typedef struct {
   uint8                                req_slot_id;
   spdm_message_header_t                  last_encap_request_header;
   uintn                                last_encap_request_size;
-  large_managed_buffer_t                 certificate_chain_buffer;
+  arena_managed_buffer_t                 certificate_chain_buffer;
 } spdm_encap_context_t;
 
+//
+// A single-use ephemeral key pair generated ahead of KEY_EXCHANGE.
+//
+typedef struct {
+  void                                 *dhe_context;
+  uint8                                dhe_public_key[MAX_DHE_KEY_SIZE];
+  uintn                                dhe_public_key_size;
+  void                                 *pqc_kem_context;
+} spdm_ephemeral_key_t;
+
+//
+// The ephemeral key pool is refilled by a worker thread.
+// A key is removed from the pool when it is acquired, and it is never returned,
+// so that each key pair is used by one KEY_EXCHANGE only.
+//
+// There is one pool per SPDM context, not one per (dhe_named_group, pqc_kem_algo): a context
+// negotiates one DHE group and one PQC KEM per connection, so all keys in the pool are of the
+// negotiated pair. The pool is flushed and refilled if a new connection negotiates another pair.
+//
+typedef struct {
+  //
+  // Configuration. The pool is disabled if depth is 0.
+  // The worker starts refilling when key_count drops to low_watermark,
+  // and stops when key_count reaches high_watermark.
+  //
+  uint8                                depth;
+  uint8                                low_watermark;
+  uint8                                high_watermark;
+  //
+  // The algorithms of the keys in the pool.
+  //
+  uint16                               dhe_named_group;
+  pqc_algo_t                           pqc_kem_algo;
+  spdm_ephemeral_key_t                 key[MAX_SPDM_KEY_POOL_DEPTH];
+  uint8                                key_count;
+  boolean                              refilling;
+  boolean                              stop;
+  void                                 *mutex;
+  void                                 *cond;
+  void                                 *thread;
+} spdm_key_pool_t;
+
+//
+// A job run by the worker pool.
+//
+typedef
+void
+(*spdm_job_func_t) (
+  IN void  *context
+  );
+
+//
+// The status of a job. A job is set to QUEUED every time it is queued, so a status left
+// by a previous run of the same job is never seen as the completion of the new run.
+// A queued job that is dropped by spdm_worker_pool_stop() is set to DROPPED. Its func is not run.
+//
+#define SPDM_JOB_STATUS_IDLE     0
+#define SPDM_JOB_STATUS_QUEUED   1
+#define SPDM_JOB_STATUS_RUNNING  2
+#define SPDM_JOB_STATUS_DONE     3
+#define SPDM_JOB_STATUS_DROPPED  4
+
+typedef struct {
+  spdm_job_func_t                      func;
+  void                                 *context;
+  uint8                                status;
+} spdm_job_t;
+
+//
+// The worker pool runs independent crypto operations of one request in parallel.
+// The pool is disabled if thread_count is 0.
+//
+typedef struct {
+  uint8                                thread_count;
+  void                                 *thread[MAX_SPDM_WORKER_THREAD_COUNT];
+  uint8                                running_thread_count;
+  spdm_job_t                           *job[MAX_SPDM_WORKER_JOB_COUNT];
+  uint8                                job_head;
+  uint8                                job_count;
+  boolean                              stop;
+  void                                 *mutex;
+  void                                 *job_cond;
+  void                                 *done_cond;
+} spdm_worker_pool_t;
+
+//
+// A request deferred to the worker pool (responder only).
+// The job owns the SPDM context until it is done. No handler is run in the meantime:
+// RESPOND_IF_READY gets ERROR(ResponseNotReady), and any other request gets ERROR(Busy).
+// The job works on its own copy of the request, and its result is published by the mutex of the worker pool.
+//
+typedef struct {
+  boolean                              enabled;
+  boolean                              in_flight;
+  uint8                                request_code;
+  uintn                                get_response_func;
+  spdm_job_t                           job;
+  //
+  // The request and the response buffers are allocated from the arena.
+  //
+  uint8                                *request;
+  uintn                                request_size;
+  uint8                                *response;
+  uintn                                response_size;
+  return_status                        status;
+} spdm_deferred_response_t;
+
+//
+// The measurement cache (responder only).
+// An entry keeps the measurement blocks collected for one measurement hash algorithm,
+// and the TCB and ALL measurement summary hashes with one base hash algorithm.
+// The entries are valid until the platform changes the measurement generation.
+//
+typedef struct {
+  boolean                              valid;
+  uint32                               generation;
+  uint8                                measurement_spec;
+  uint32                               measurement_hash_algo;
+  uint8                                device_measurement_count;
+  uintn                                device_measurement_size;
+  //
+  // The measurement blocks are allocated from the arena.
+  //
+  uint8                                *device_measurement;
+  uint32                               summary_hash_algo;
+  boolean                              tcb_summary_hash_valid;
+  boolean                              all_summary_hash_valid;
+  uint8                                tcb_summary_hash[MAX_HASH_SIZE];
+  uint8                                all_summary_hash[MAX_HASH_SIZE];
+} spdm_measurement_cache_entry_t;
+
+typedef struct {
+  boolean                              enabled;
+  uint32                               generation;
+  uint8                                next_entry;
+  spdm_measurement_cache_entry_t       entry[MAX_SPDM_MEASUREMENT_CACHE_ENTRY_COUNT];
+} spdm_measurement_cache_t;
+
+//
+// The hash of the local certificate chain of a slot, for DIGESTS and CHALLENGE_AUTH.
+// It is valid for the certificate chain buffer and the base hash algorithm it is generated with,
+// until the local certificate chains are changed by spdm_set_data.
+//
+typedef struct {
+  boolean                              valid;
+  uint32                               hash_algo;
+  void                                 *cert_chain;
+  uintn                                cert_chain_size;
+  uint8                                hash[MAX_HASH_SIZE];
+} spdm_cert_chain_hash_cache_t;
+
+typedef struct {
+  spdm_cert_chain_hash_cache_t         cert_chain_hash[MAX_SPDM_SLOT_COUNT];
+} spdm_response_cache_t;
+
+//
+// The peer certificate chains verified by the requester, keyed by the certificate chain digest.
+// GET_CERTIFICATE and the certificate chain verification are skipped
+// if GET_DIGESTS returns the digest of a cached certificate chain.
+// The cache is flushed when the peer root certificate hash or the peer certificate chain is provisioned.
+//
+typedef struct {
+  boolean                              valid;
+  uint32                               hash_algo;
+  uint8                                digest[MAX_HASH_SIZE];
+  //
+  // The certificate chain is allocated from the arena.
+  //
+  uint8                                *cert_chain;
+  uintn                                cert_chain_size;
+} spdm_peer_cert_chain_cache_entry_t;
+
+typedef struct {
+  boolean                              enabled;
+  uint8                                next_entry;
+  spdm_peer_cert_chain_cache_entry_t   entry[MAX_SPDM_PEER_CERT_CHAIN_CACHE_ENTRY_COUNT];
+} spdm_peer_cert_chain_cache_t;
+
+//
+// The requester flow driven by the asynchronous API (requester only).
+// The flow runs on a fiber. It is suspended when it sends or receives a message,
+// or when it waits before a retry, and it is resumed by the caller of the asynchronous API.
+//
+#define MAX_SPDM_ASYNC_ARG_COUNT  8
+
+typedef struct {
+  void                                 *fiber;
+  boolean                              running;
+  boolean                              cancel;
+  uint8                                state;
+  uintn                                flow_func;
+  uintn                                arg[MAX_SPDM_ASYNC_ARG_COUNT];
+  return_status                        status;
+  //
+  // The device IO functions registered by the caller. They are restored after the flow is done.
+  //
+  spdm_device_send_message_func        send_message;
+  spdm_device_receive_message_func     receive_message;
+  //
+  // The message to be sent, or the buffer of the message to be received.
+  //
+  void                                 *message;
+  uintn                                message_size;
+  uintn                                *receive_message_size;
+  uint64                               wait_time;
+} spdm_async_context_t;
+
 #define spdm_context_struct_VERSION 0x1
 
 typedef struct {
@@ -318,7 +664,21 @@ typedef struct {
   spdm_connection_info_t            connection_info;
   spdm_transcript_t                 transcript;
 
-  spdm_session_info_t               session_info[MAX_SPDM_SESSION_COUNT];
+  //
+  // The session table with max_session_count sessions, allocated from the arena.
+  // The sessions in use are indexed by session_id in session_hash with (1 << session_hash_bits) buckets.
+  //
+  spdm_session_info_t               *session_info;
+  uint32                            max_session_count;
+  uint32                            session_count;
+  spdm_session_info_t               **session_hash;
+  uint8                             session_hash_bits;
+  spdm_session_info_t               *session_free_list;
+  //
+  // The mutex is created only if the session table is updated by a thread other than the dispatch,
+  // such as a KEY_EXCHANGE deferred to the worker pool.
+  //
+  void                              *session_table_mutex;
   //
   // Cache lastest session ID for HANDSHAKE_IN_THE_CLEAR
   //
@@ -339,12 +699,63 @@ typedef struct {
   //
   uint8                           retry_times;
 
+  //
+  // Pre-generated ephemeral keys for KEY_EXCHANGE (requester only)
+  //
+  spdm_key_pool_t                   key_pool;
+
+  //
+  // Worker threads for parallel crypto operations
+  //
+  spdm_worker_pool_t                worker_pool;
+
+  //
+  // The request that is processed by the worker pool (responder only)
+  //
+  spdm_deferred_response_t          deferred_response;
+
+  //
+  // The cached measurements (responder only)
+  //
+  spdm_measurement_cache_t          measurement_cache;
+
+  //
+  // The cached data of the responses that depend on the provisioned data only
+  //
+  spdm_response_cache_t             response_cache;
+
+  //
+  // The verified peer certificate chains (requester only)
+  //
+  spdm_peer_cert_chain_cache_t      peer_cert_chain_cache;
+
+  //
+  // The flow started by the asynchronous API (requester only)
+  //
+  spdm_async_context_t              async;
+
+  //
+  // The large buffers are allocated from the arena on demand.
+  //
+  spdm_arena_t                      arena;
+
   //
   // fragment handling
+  // The buffers are allocated from the arena with MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE,
+  // and they are released after the last fragment is received or sent.
   //
-  uint8                           last_spdm_fragment_encapsulated_request[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
+  uint8                           fragment_window_size;
+  uint8                           *last_spdm_fragment_encapsulated_request;
   uintn                           last_spdm_fragment_encapsulated_request_size;
-  uint8                           last_spdm_fragment_encapsulated_response[MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE];
+  //
+  // The window accepted in the BEGIN fragment, the fragments received since the last ACK,
+  // and the first error in the window, which is returned at the end of the window.
+  //
+  uint8                           last_spdm_fragment_encapsulated_request_window_size;
+  uint8                           last_spdm_fragment_encapsulated_request_unacked_count;
+  uint8                           last_spdm_fragment_encapsulated_request_error_code;
+  uint32                          last_spdm_fragment_encapsulated_request_sequence_id;
+  uint8                           *last_spdm_fragment_encapsulated_response;
   uintn                           last_spdm_fragment_encapsulated_response_size;
   uintn                           last_spdm_fragment_encapsulated_response_sent_size;
 } spdm_context_t;
@@ -421,7 +832,7 @@ shrink_managed_buffer (
   Reset the managed buffer.
   The buffer_size is reset to 0.
   The max_buffer_size is unchanged.
-  The buffer is not freed.
+  The buffer is not freed, except that the buffer of an arena managed buffer is released to the arena.
 
   @param  managed_buffer_t                The managed buffer to be shrinked.
 **/
@@ -466,13 +877,557 @@ init_managed_buffer (
   IN uintn               max_buffer_size
   );
 
+/**
+  Init the arena managed buffer.
+
+  The max_buffer_size is MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE.
+  The data is allocated from the arena when it is appended.
+
+  @param  managed_buffer_t                The arena managed buffer.
+  @param  arena                          The arena.
+**/
+void
+init_arena_managed_buffer (
+  IN OUT arena_managed_buffer_t  *managed_buffer_t,
+  IN     spdm_arena_t            *arena
+  );
+
+/**
+  This function allocates a buffer from the arena.
+
+  The size is rounded up to the size class of the block, so that a released block can be
+  reused by a later allocation, such as the transcript of the next connection or session.
+
+  @param  arena                          The arena.
+  @param  size                           The size in bytes of the buffer.
+  @param  buffer_size                    The size in bytes of the allocated buffer. It may be NULL.
+
+  @return the buffer, or NULL if the size is too large or the arena limit is reached.
+**/
+void *
+spdm_arena_allocate (
+  IN OUT spdm_arena_t             *arena,
+  IN     uintn                    size,
+     OUT uintn                    *buffer_size OPTIONAL
+  );
+
+/**
+  This function releases a buffer to the arena.
+
+  The block is cached in the arena to be reused. It is freed by spdm_arena_trim.
+
+  @param  arena                          The arena.
+  @param  buffer                         The buffer returned by spdm_arena_allocate. It may be NULL.
+**/
+void
+spdm_arena_free (
+  IN OUT spdm_arena_t             *arena,
+  IN     void                     *buffer
+  );
+
+/**
+  This function frees the cached blocks of the arena.
+
+  The blocks in use are not freed.
+
+  @param  arena                          The arena.
+**/
+void
+spdm_arena_trim (
+  IN OUT spdm_arena_t             *arena
+  );
+
+/**
+  This function creates the mutex of the arena, so that the buffers can be allocated and released
+  by more than one thread.
+
+  @param  arena                          The arena.
+
+  @retval TRUE  The arena is protected by the mutex.
+  @retval FALSE The mutex cannot be created.
+**/
+boolean
+spdm_arena_init_lock (
+  IN OUT spdm_arena_t             *arena
+  );
+
+/**
+  This function frees the mutex of the arena.
+
+  @param  arena                          The arena.
+**/
+void
+spdm_arena_free_lock (
+  IN OUT spdm_arena_t             *arena
+  );
+
+/**
+  Reset the running hash of a transcript.
+
+  The next spdm_transcript_hash_calculate() restarts from the transcript data.
+
+  @param  transcript_hash                The running hash of the transcript.
+**/
+void
+spdm_transcript_hash_reset (
+  IN OUT spdm_transcript_hash_t   *transcript_hash
+  );
+
+/**
+  Calculate the hash of a transcript at a checkpoint.
+
+  Only the bytes of each segment not yet consumed by the running hash are hashed. The running
+  hash is then duplicated and finalized, so it can continue to absorb later transcript data.
+
+  @param  transcript_hash                The running hash of the transcript.
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  segment                       The transcript segments, in concatenation order.
+  @param  segment_count                  The number of transcript segments.
+  @param  hash_value                    Pointer to a buffer that receives the hash value.
+
+  @retval TRUE   transcript hash is calculated.
+  @retval FALSE  transcript hash is not calculated.
+**/
+boolean
+spdm_transcript_hash_calculate (
+  IN OUT spdm_transcript_hash_t          *transcript_hash,
+  IN     uint32                          bash_hash_algo,
+  IN     const spdm_transcript_segment_t *segment,
+  IN     uintn                           segment_count,
+     OUT uint8                           *hash_value
+  );
+
+/**
+  This function returns the peer public key context to verify a classical signature.
+
+  The context is created from the leaf certificate of the peer certificate chain at first use,
+  and it is kept in the connection info until spdm_reset_peer_public_key_context is called.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate if the signature is verified by the requester.
+  @param  context                       The public key context.
+
+  @retval TRUE  The public key context is returned.
+  @retval FALSE The public key context cannot be created.
+**/
+boolean
+spdm_get_peer_asym_public_key_context (
+  IN     spdm_context_t           *spdm_context,
+  IN     boolean                  is_requester,
+     OUT void                     **context
+  );
+
+/**
+  This function returns the peer public key context to verify a PQC signature.
+
+  The context is created from the peer PQC public key at first use,
+  and it is kept in the connection info until spdm_reset_peer_public_key_context is called.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate if the signature is verified by the requester.
+  @param  context                       The public key context.
+
+  @retval TRUE  The public key context is returned.
+  @retval FALSE The public key context cannot be created.
+**/
+boolean
+spdm_get_peer_pqc_public_key_context (
+  IN     spdm_context_t           *spdm_context,
+  IN     boolean                  is_requester,
+     OUT void                     **context
+  );
+
+/**
+  This function returns the peer public key context to verify a hybrid signature.
+
+  The context is created from the leaf certificate of the peer certificate chain at first use,
+  and it is kept in the connection info until spdm_reset_peer_public_key_context is called.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  context                       The public key context.
+
+  @retval TRUE  The public key context is returned.
+  @retval FALSE The public key context cannot be created.
+**/
+boolean
+spdm_get_peer_hybrid_public_key_context (
+  IN     spdm_context_t           *spdm_context,
+     OUT void                     **context
+  );
+
+/**
+  This function generates a RAW mode signature, which is
+  classical signature || 4 bytes PQC signature size || PQC signature.
+
+  The two halves are generated in parallel if the worker pool is enabled.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate of the signature generation for a requester or a responder.
+  @param  segment                       The segments of the message to be signed.
+  @param  segment_count                 The count of the segments.
+  @param  need_pqc_sig                  Indicate if the PQC signature is generated.
+  @param  signature                     The buffer to store the signature.
+  @param  asym_signature_size           size in bytes of the classical signature.
+  @param  pqc_signature_size            size in bytes of the PQC signature.
+
+  @retval TRUE  The signature is generated.
+  @retval FALSE The signature is not generated.
+**/
+boolean
+spdm_generate_raw_mode_signature (
+  IN     spdm_context_t               *spdm_context,
+  IN     boolean                      is_requester,
+  IN     const spdm_data_segment_t    *segment,
+  IN     uintn                        segment_count,
+  IN     boolean                      need_pqc_sig,
+     OUT uint8                        *signature,
+     OUT uintn                        *asym_signature_size,
+     OUT uintn                        *pqc_signature_size
+  );
+
+/**
+  This function verifies the classical signature and the PQC signature of a RAW mode signature.
+
+  The two signatures are verified in parallel if the worker pool is enabled.
+  The caller must fail the verification if either result is FALSE.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate of the signature verification for a requester or a responder.
+  @param  segment                       The segments of the signed message.
+  @param  segment_count                 The count of the segments.
+  @param  asym_signature                The classical signature.
+  @param  asym_signature_size           size in bytes of the classical signature.
+  @param  pqc_signature                 The PQC signature, or NULL if no PQC signature is negotiated.
+  @param  pqc_signature_size            size in bytes of the PQC signature.
+  @param  asym_result                   The verification result of the classical signature.
+  @param  pqc_result                    The verification result of the PQC signature.
+
+  @retval TRUE  The signatures are verified. The results are returned.
+  @retval FALSE The peer public key cannot be used.
+**/
+boolean
+spdm_verify_raw_mode_signature (
+  IN  spdm_context_t               *spdm_context,
+  IN  boolean                      is_requester,
+  IN  const spdm_data_segment_t    *segment,
+  IN  uintn                        segment_count,
+  IN  const uint8                  *asym_signature,
+  IN  uintn                        asym_signature_size,
+  IN  const uint8                  *pqc_signature,
+  IN  uintn                        pqc_signature_size,
+  OUT boolean                      *asym_result,
+  OUT boolean                      *pqc_result
+  );
+
+/**
+  This function computes the DHE shared secret and the PQC KEM shared secret of a KEY_EXCHANGE,
+  and imports them to the secured message context.
+
+  The two shared secrets are computed in parallel if the worker pool is enabled.
+  They are always imported in the fixed order, DHE shared secret first, then PQC KEM shared secret.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_requester                  Indicate of the key exchange for a requester or a responder.
+  @param  spdm_secured_message_context  A pointer to the SPDM secured message context.
+  @param  dhe_context                   The DHE context with the generated key.
+  @param  peer_dhe_public_key           The peer DHE public key.
+  @param  peer_dhe_public_key_size      size in bytes of the peer DHE public key.
+  @param  pqc_kem_context               The PQC KEM context, or NULL if no PQC KEM is negotiated.
+  @param  pqc_kem_data                  The peer PQC KEM public key for the responder,
+                                        or the PQC KEM cipher text for the requester.
+  @param  pqc_kem_data_size             size in bytes of the pqc_kem_data.
+  @param  pqc_kem_cipher_text           The buffer to receive the PQC KEM cipher text for the responder.
+                                        It is ignored for the requester.
+  @param  pqc_kem_cipher_text_size      On input, size in bytes of the pqc_kem_cipher_text buffer.
+                                        On output, size in bytes of the PQC KEM cipher text.
+                                        It is ignored for the requester.
+
+  @retval TRUE  The shared secrets are computed and imported.
+  @retval FALSE The shared secrets cannot be computed.
+**/
+boolean
+spdm_compute_key_exchange_shared_secret (
+  IN     spdm_context_t           *spdm_context,
+  IN     boolean                  is_requester,
+  IN OUT void                     *spdm_secured_message_context,
+  IN OUT void                     *dhe_context,
+  IN     const uint8              *peer_dhe_public_key,
+  IN     uintn                    peer_dhe_public_key_size,
+  IN OUT void                     *pqc_kem_context,
+  IN     const uint8              *pqc_kem_data,
+  IN     uintn                    pqc_kem_data_size,
+     OUT uint8                    *pqc_kem_cipher_text,
+  IN OUT uintn                    *pqc_kem_cipher_text_size
+  );
+
+/**
+  This function frees the cached peer public key contexts.
+
+  It must be called when the peer certificate chain or the peer PQC public key is changed.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_reset_peer_public_key_context (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function sets the peer used certificate chain buffer including spdm_cert_chain_t header.
+
+  The buffer is allocated from the arena, and the previous buffer is released to the arena.
+  The cached peer public key contexts are reset.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  cert_chain_buffer             Certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size        size in bytes of the certificate chain buffer.
+                                        The buffer is released if it is 0.
+
+  @retval TRUE  The peer used certificate chain buffer is set.
+  @retval FALSE The buffer is too large, or it cannot be allocated from the arena.
+**/
+boolean
+spdm_set_peer_used_cert_chain_buffer (
+  IN OUT spdm_context_t           *spdm_context,
+  IN     const void               *cert_chain_buffer,
+  IN     uintn                    cert_chain_buffer_size
+  );
+
+/**
+  This function starts the worker thread of the ephemeral key pool, or wakes it up,
+  to fill the pool with keys of the negotiated DHE and PQC KEM algorithms.
+
+  The keys of other algorithms in the pool are freed.
+  This function does nothing if the pool is disabled.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_key_pool_start (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function stops the worker thread of the ephemeral key pool and frees all keys in the pool.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_key_pool_stop (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function removes one ephemeral key of the negotiated DHE and PQC KEM algorithms from the pool.
+
+  The caller owns the returned DHE and PQC KEM contexts and must free them after use.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  ephemeral_key                 The ephemeral key removed from the pool.
+
+  @retval TRUE  An ephemeral key is returned.
+  @retval FALSE The pool is disabled or empty. The caller must generate the key.
+**/
+boolean
+spdm_key_pool_acquire (
+  IN     spdm_context_t           *spdm_context,
+     OUT spdm_ephemeral_key_t     *ephemeral_key
+  );
+
+/**
+  This function runs the jobs and returns when all jobs are done.
+
+  The first job is run by the caller. The other jobs are run by the worker pool if it is enabled,
+  otherwise they are run by the caller one after another.
+  The caller runs the queued jobs while it waits, so that a job run by the worker pool
+  may call spdm_run_jobs itself. A job dropped by spdm_worker_pool_stop is also run by the caller,
+  so that a job run by the worker pool completes while the worker pool is stopped.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  job                           The jobs to be run.
+  @param  job_count                     The count of the jobs.
+**/
+void
+spdm_run_jobs (
+  IN     spdm_context_t           *spdm_context,
+  IN OUT spdm_job_t               *job,
+  IN     uintn                    job_count
+  );
+
+/**
+  This function stops the threads of the worker pool.
+
+  The running jobs are completed. The jobs that are not started are dropped and set to SPDM_JOB_STATUS_DROPPED.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_worker_pool_stop (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function queues a job to the worker pool and returns at once.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  job                           The job to be run. It must be valid until the job is done.
+
+  @retval TRUE  The job is queued. Use spdm_worker_pool_is_job_done to check the job.
+  @retval FALSE The worker pool is disabled or the queue is full. The job is not run.
+**/
+boolean
+spdm_worker_pool_submit (
+  IN     spdm_context_t           *spdm_context,
+  IN OUT spdm_job_t               *job
+  );
+
+/**
+  This function checks whether a job queued by spdm_worker_pool_submit is done.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  job                           The job queued by spdm_worker_pool_submit.
+
+  @retval TRUE  The job is done or dropped. job->status tells which one.
+  @retval FALSE The job is queued or running.
+**/
+boolean
+spdm_worker_pool_is_job_done (
+  IN     spdm_context_t           *spdm_context,
+  IN     spdm_job_t               *job
+  );
+
+/**
+  This function collects the device measurement with the negotiated measurement specification
+  and measurement hash algorithm.
+
+  The measurement is returned from the measurement cache if it is enabled and valid,
+  otherwise it is collected by spdm_measurement_collection and it is cached.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  device_measurement_count       The count of the device measurement block.
+  @param  device_measurement            A pointer to a destination buffer to store the concatenation of all device measurement blocks.
+  @param  device_measurement_size        On input, indicates the size in bytes of the destination buffer.
+                                       On output, indicates the size in bytes of all device measurement blocks in the buffer.
+
+  @retval TRUE  the device measurement is returned.
+  @retval FALSE the device measurement collection fail.
+**/
+boolean
+spdm_collect_measurement (
+  IN     spdm_context_t           *spdm_context,
+     OUT uint8                    *device_measurement_count,
+     OUT void                     *device_measurement,
+  IN OUT uintn                    *device_measurement_size
+  );
+
+/**
+  This function gets the measurement summary hash from the measurement cache.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  measurement_summary_hash_type   The type of the measurement summary hash, TCB or ALL.
+  @param  measurement_summary_hash       The buffer to store the measurement summary hash.
+
+  @retval TRUE  The measurement summary hash is returned.
+  @retval FALSE The measurement summary hash is not cached.
+**/
+boolean
+spdm_measurement_cache_get_summary_hash (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint8                    measurement_summary_hash_type,
+     OUT uint8                    *measurement_summary_hash
+  );
+
+/**
+  This function saves the measurement summary hash to the measurement cache.
+
+  The hash is saved only if the measurement of the negotiated algorithms is cached.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  measurement_summary_hash_type   The type of the measurement summary hash, TCB or ALL.
+  @param  measurement_summary_hash       The measurement summary hash.
+**/
+void
+spdm_measurement_cache_set_summary_hash (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint8                    measurement_summary_hash_type,
+  IN     uint8                    *measurement_summary_hash
+  );
+
+/**
+  This function invalidates the measurement cache, and releases the buffers to the arena.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_measurement_cache_flush (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function finds the cached peer certificate chain whose digest is returned by GET_DIGESTS
+  in the current connection.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  slot_id                       The number of slot for the certificate chain.
+
+  @return the cache entry, or NULL if the certificate chain of the slot is not cached.
+**/
+spdm_peer_cert_chain_cache_entry_t *
+spdm_peer_cert_chain_cache_find (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint8                    slot_id
+  );
+
+/**
+  This function adds a verified peer certificate chain to the cache.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  cert_chain                    The certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_size               size in bytes of the certificate chain buffer.
+**/
+void
+spdm_peer_cert_chain_cache_add (
+  IN     spdm_context_t           *spdm_context,
+  IN     void                     *cert_chain,
+  IN     uintn                    cert_chain_size
+  );
+
+/**
+  This function invalidates the peer certificate chain cache, and releases the buffers to the arena.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_peer_cert_chain_cache_flush (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  Reset the running hash of every transcript in SPDM context.
+
+  It must be called when a transcript is shrinked, so that the running hash is restarted from the transcript data.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_reset_transcript_hash (
+  IN     void                                *spdm_context
+  );
+
 /**
   This function initializes the session info.
 
+  The session is indexed by the session ID, or it is returned to the free list if the session ID is INVALID_SESSION_ID.
+
   @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_info                  The session info in the session table of the SPDM context.
   @param  session_id                    The SPDM session ID.
+  @param  use_psk                       Whether the session uses PSK.
+
+  @retval TRUE  The session info is initialized.
+  @retval FALSE The secured message context cannot be allocated.
 **/
-void
+boolean
 spdm_session_info_init (
   IN     spdm_context_t     *spdm_context,
   IN     spdm_session_info_t       *session_info,
@@ -480,6 +1435,91 @@ spdm_session_info_init (
   IN     boolean                 use_psk
   );
 
+/**
+  This function allocates the session table of the SPDM context.
+
+  All sessions in the table are free.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  max_session_count             The count of the sessions in the table.
+
+  @retval RETURN_SUCCESS               The session table is allocated.
+  @retval RETURN_OUT_OF_RESOURCES      The session table cannot be allocated.
+**/
+return_status
+spdm_session_table_init (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint32                   max_session_count
+  );
+
+/**
+  This function frees the session table of the SPDM context, and the secured message contexts of the sessions.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_session_table_free (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function creates the mutex of the session table, so that the session table can be updated by a thread
+  while the sessions are looked up by another thread, such as a KEY_EXCHANGE deferred to the worker pool.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @retval TRUE  The session table is protected by the mutex.
+  @retval FALSE The mutex cannot be created.
+**/
+boolean
+spdm_session_table_init_lock (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function frees the mutex of the session table.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_session_table_free_lock (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function locks the session table, if the mutex of the session table is created.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_session_table_lock (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function unlocks the session table, if the mutex of the session table is created.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_session_table_unlock (
+  IN     spdm_context_t           *spdm_context
+  );
+
+/**
+  This function returns the hash bucket index of a session ID.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    The SPDM session ID.
+
+  @return the hash bucket index.
+**/
+uintn
+spdm_session_hash_index (
+  IN     spdm_context_t           *spdm_context,
+  IN     uint32                   session_id
+  );
+
 /**
   This function allocates half of session ID for a requester.
 
@@ -538,13 +1578,32 @@ spdm_is_capabilities_flag_supported (
   IN     uint32                    responder_capabilities_flag
   );
 
+/**
+  This function returns the max length of a portion of the certificate chain in one CERTIFICATE response.
+
+  The CERTIFICATE response with the portion fits in the data transfer size of the local device,
+  and the portion is not longer than MAX_SPDM_CERT_CHAIN_BLOCK_LEN.
+  The requester asks for this length, and the responder returns the smaller one of it and the requested length.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the max length of a portion of the certificate chain.
+**/
+uint32
+spdm_get_cert_chain_block_len (
+  IN     spdm_context_t       *spdm_context
+  );
+
 /*
   This function calculates m1m2.
 
+  The m1m2 is returned as segments which refer to the transcript, instead of being copied into one buffer.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  is_mut                        Indicate if this is from mutual authentication.
-  @param  m1m2_buffer_size               size in bytes of the m1m2
-  @param  m1m2_buffer                   The buffer to store the m1m2
+  @param  m1m2_segment_count             On input, the number of entries in m1m2_segment.
+                                       On output, the number of segments of the m1m2.
+  @param  m1m2_segment                  The segments of the m1m2
 
   @retval RETURN_SUCCESS  m1m2 is calculated.
 */
@@ -552,28 +1611,59 @@ boolean
 spdm_calculate_m1m2 (
   IN     void                   *context,
   IN     boolean                is_mut,
-  IN OUT uintn                  *m1m2_buffer_size,
-     OUT void                   *m1m2_buffer
+  IN OUT uintn                  *m1m2_segment_count,
+     OUT spdm_data_segment_t    *m1m2_segment
   );
 
 /*
   This function calculates l1l2.
 
+  The l1l2 is returned as a segment which refers to the transcript, instead of being copied into one buffer.
+
   @param  spdm_context                  A pointer to the SPDM context.
-  @param  l1l2_buffer_size               size in bytes of the l1l2
-  @param  l1l2_buffer                   The buffer to store the l1l2
+  @param  l1l2_segment                  The segment of the l1l2
 
   @retval RETURN_SUCCESS  l1l2 is calculated.
 */
 boolean
 spdm_calculate_l1l2 (
   IN     void                   *context,
-  IN OUT uintn                  *l1l2_buffer_size,
-     OUT void                   *l1l2_buffer
+     OUT spdm_data_segment_t    *l1l2_segment
+  );
+
+/*
+  This function calculates m1m2 hash.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  is_mut                        Indicate if this is from mutual authentication.
+  @param  m1m2_hash                     The buffer to store the m1m2 hash
+
+  @retval TRUE  m1m2 hash is calculated.
+*/
+boolean
+spdm_calculate_m1m2_hash (
+  IN     void                   *context,
+  IN     boolean                is_mut,
+     OUT uint8                  *m1m2_hash
+  );
+
+/*
+  This function calculates l1l2 hash.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  l1l2_hash                     The buffer to store the l1l2 hash
+
+  @retval TRUE  l1l2 hash is calculated.
+*/
+boolean
+spdm_calculate_l1l2_hash (
+  IN     void                   *context,
+     OUT uint8                  *l1l2_hash
   );
 
 /**
   This function generates the certificate chain hash.
+  The hash is cached, and it is generated again only if the certificate chain or the base hash algorithm is changed.
 
   @param  spdm_context                  A pointer to the SPDM context.
   @param  slot_id                    The slot index of the certificate chain.
@@ -589,6 +1679,16 @@ spdm_generate_cert_chain_hash (
      OUT uint8                        *hash
   );
 
+/**
+  This function invalidates the cached data of the responses, once the provisioned data is changed.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_reset_response_cache (
+  IN     spdm_context_t          *spdm_context
+  );
+
 /**
   This function verifies the digest.
 
@@ -606,6 +1706,88 @@ spdm_verify_peer_digests (
   IN uintn                        digest_size
   );
 
+/**
+  This function verifies peer certificate chain buffer with the provisioned peer root certificate hash
+  or the provisioned peer certificate chain.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  cert_chain_buffer              Certitiface chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certitiface chain buffer.
+  @param  is_complete                   Indicate if the certificate chain buffer is completely received,
+                                       or only the beginning part is received.
+
+  @retval TRUE  Peer certificate chain buffer verification passed.
+  @retval FALSE Peer certificate chain buffer verification failed.
+**/
+boolean
+spdm_verify_peer_cert_chain_provision (
+  IN spdm_context_t          *spdm_context,
+  IN void                         *cert_chain_buffer,
+  IN uintn                        cert_chain_buffer_size,
+  IN boolean                      is_complete
+  );
+
+/**
+  This function verifies the received part of peer certificate chain buffer including spdm_cert_chain_t header,
+  so that the certificate chain transfer can be stopped at the first certificate which fails the verification.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              The received part of certitiface chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the received part of certitiface chain buffer.
+
+  @retval TRUE  The received part of peer certificate chain buffer verification passed.
+  @retval FALSE The received part of peer certificate chain buffer verification failed.
+**/
+boolean
+spdm_verify_peer_cert_chain_buffer_update (
+  IN spdm_context_t                     *spdm_context,
+  IN spdm_cert_chain_verify_context_t   *verify_context,
+  IN void                               *cert_chain_buffer,
+  IN uintn                              cert_chain_buffer_size
+  );
+
+/**
+  This function verifies the links of peer certificate chain buffer which are not verified yet.
+
+  The links are independent of each other once the chain is split,
+  so they are verified in parallel if the worker pool is enabled.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              Certitiface chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certitiface chain buffer.
+
+  @retval TRUE  The links pass the verification.
+  @retval FALSE A link fails the verification.
+**/
+boolean
+spdm_verify_peer_cert_chain_links (
+  IN spdm_context_t                     *spdm_context,
+  IN spdm_cert_chain_verify_context_t   *verify_context,
+  IN void                               *cert_chain_buffer,
+  IN uintn                              cert_chain_buffer_size
+  );
+
+/**
+  This function completes the verification of peer certificate chain buffer including spdm_cert_chain_t header.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              Certitiface chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certitiface chain buffer.
+
+  @retval TRUE  Peer certificate chain buffer verification passed.
+  @retval FALSE Peer certificate chain buffer verification failed.
+**/
+boolean
+spdm_verify_peer_cert_chain_buffer_final (
+  IN spdm_context_t                     *spdm_context,
+  IN spdm_cert_chain_verify_context_t   *verify_context,
+  IN void                               *cert_chain_buffer,
+  IN uintn                              cert_chain_buffer_size
+  );
+
 /**
   This function verifies peer certificate chain buffer including spdm_cert_chain_t header.
 
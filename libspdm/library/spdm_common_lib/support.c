@@ -130,7 +130,10 @@ append_managed_buffer (
   IN uintn               buffer_size
   )
 {
-  managed_buffer_t  *managed_buffer;
+  managed_buffer_t        *managed_buffer;
+  arena_managed_buffer_t  *arena_buffer;
+  uint8                   *new_buffer;
+  uintn                   new_capacity;
 
   managed_buffer = m_buffer;
 
@@ -153,6 +156,27 @@ append_managed_buffer (
   }
   ASSERT (buffer_size <= managed_buffer->max_buffer_size - managed_buffer->buffer_size);
 
+  if (managed_buffer->arena != NULL) {
+    //
+    // Grow the arena managed buffer to the next size class.
+    //
+    arena_buffer = m_buffer;
+    if (buffer_size > arena_buffer->capacity - arena_buffer->buffer_size) {
+      new_buffer = spdm_arena_allocate (arena_buffer->arena, arena_buffer->buffer_size + buffer_size, &new_capacity);
+      if (new_buffer == NULL) {
+        DEBUG ((DEBUG_ERROR, "append_managed_buffer 0x%x fail, out of arena\n", (uint32)buffer_size));
+        return RETURN_OUT_OF_RESOURCES;
+      }
+      copy_mem (new_buffer, arena_buffer->buffer, arena_buffer->buffer_size);
+      spdm_arena_free (arena_buffer->arena, arena_buffer->buffer);
+      arena_buffer->buffer = new_buffer;
+      arena_buffer->capacity = new_capacity;
+    }
+    copy_mem (arena_buffer->buffer + arena_buffer->buffer_size, buffer, buffer_size);
+    arena_buffer->buffer_size += buffer_size;
+    return RETURN_SUCCESS;
+  }
+
   copy_mem ((uint8 *)(managed_buffer + 1) + managed_buffer->buffer_size, buffer, buffer_size);
   managed_buffer->buffer_size += buffer_size;
   return RETURN_SUCCESS;
@@ -197,7 +221,7 @@ shrink_managed_buffer (
   Reset the managed buffer.
   The buffer_size is reset to 0.
   The max_buffer_size is unchanged.
-  The buffer is not freed.
+  The buffer is not freed, except that the buffer of an arena managed buffer is released to the arena.
 
   @param  managed_buffer_t                The managed buffer to be shrinked.
 **/
@@ -206,13 +230,21 @@ reset_managed_buffer (
   IN OUT void            *m_buffer
   )
 {
-  managed_buffer_t  *managed_buffer;
+  managed_buffer_t        *managed_buffer;
+  arena_managed_buffer_t  *arena_buffer;
 
   managed_buffer = m_buffer;
 
   ASSERT ((managed_buffer->max_buffer_size == MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE) ||
           (managed_buffer->max_buffer_size == MAX_SPDM_MESSAGE_SMALL_BUFFER_SIZE));
   managed_buffer->buffer_size = 0;
+  if (managed_buffer->arena != NULL) {
+    arena_buffer = m_buffer;
+    spdm_arena_free (arena_buffer->arena, arena_buffer->buffer);
+    arena_buffer->buffer = NULL;
+    arena_buffer->capacity = 0;
+    return ;
+  }
   zero_mem (managed_buffer + 1, managed_buffer->max_buffer_size);
 }
 
@@ -255,6 +287,9 @@ get_managed_buffer (
 
   ASSERT ((managed_buffer->max_buffer_size == MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE) ||
           (managed_buffer->max_buffer_size == MAX_SPDM_MESSAGE_SMALL_BUFFER_SIZE));
+  if (managed_buffer->arena != NULL) {
+    return ((arena_managed_buffer_t *)managed_buffer)->buffer;
+  }
   return (managed_buffer + 1);
 }
 
@@ -278,5 +313,180 @@ init_managed_buffer (
           (max_buffer_size == MAX_SPDM_MESSAGE_SMALL_BUFFER_SIZE));
 
   managed_buffer->max_buffer_size = max_buffer_size;
+  managed_buffer->arena = NULL;
   reset_managed_buffer (m_buffer);
+}
+
+/**
+  Init the arena managed buffer.
+
+  The max_buffer_size is MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE.
+  The data is allocated from the arena when it is appended.
+
+  @param  managed_buffer_t                The arena managed buffer.
+  @param  arena                          The arena.
+**/
+void
+init_arena_managed_buffer (
+  IN OUT arena_managed_buffer_t  *managed_buffer,
+  IN     spdm_arena_t            *arena
+  )
+{
+  ASSERT (arena != NULL);
+
+  managed_buffer->max_buffer_size = MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE;
+  managed_buffer->buffer_size = 0;
+  managed_buffer->arena = arena;
+  managed_buffer->buffer = NULL;
+  managed_buffer->capacity = 0;
+}
+
+/**
+  Reset the running hash of a transcript.
+
+  The next spdm_transcript_hash_calculate() restarts from the transcript data.
+
+  @param  transcript_hash                The running hash of the transcript.
+**/
+void
+spdm_transcript_hash_reset (
+  IN OUT spdm_transcript_hash_t   *transcript_hash
+  )
+{
+  transcript_hash->valid = FALSE;
+  zero_mem (transcript_hash->consumed_size, sizeof(transcript_hash->consumed_size));
+}
+
+/**
+  Check whether the consumed sizes of the running hash are a prefix of the transcript segment sizes.
+
+  Only sizes are compared, not bytes: the consumed bytes are not retained. This relies on every
+  managed buffer shrink or reset going through spdm_reset_transcript_hash() or a reset_message_*()
+  function, which invalidates the running hash, so a buffer that is at least as long as what was
+  consumed always extends the consumed bytes.
+
+  @param  transcript_hash                The running hash of the transcript.
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  segment                       The transcript segments, in concatenation order.
+  @param  segment_count                  The number of transcript segments.
+
+  @retval TRUE   the running hash can absorb the rest of the segments.
+  @retval FALSE  the running hash must be restarted.
+**/
+static
+boolean
+spdm_transcript_hash_is_size_prefix (
+  IN spdm_transcript_hash_t          *transcript_hash,
+  IN uint32                          bash_hash_algo,
+  IN const spdm_transcript_segment_t *segment,
+  IN uintn                           segment_count
+  )
+{
+  uintn    index;
+  boolean  tail_started;
+
+  if (!transcript_hash->valid || (transcript_hash->bash_hash_algo != bash_hash_algo)) {
+    return FALSE;
+  }
+
+  //
+  // Walk backwards: once a segment is (partially) consumed, every earlier segment must be fully consumed.
+  //
+  tail_started = FALSE;
+  for (index = MAX_SPDM_TRANSCRIPT_SEGMENT_COUNT; index > 0; index--) {
+    if (index > segment_count) {
+      if (transcript_hash->consumed_size[index - 1] != 0) {
+        return FALSE;
+      }
+      continue;
+    }
+    if (transcript_hash->consumed_size[index - 1] > segment[index - 1].size) {
+      return FALSE;
+    }
+    if (tail_started && (transcript_hash->consumed_size[index - 1] != segment[index - 1].size)) {
+      return FALSE;
+    }
+    if (transcript_hash->consumed_size[index - 1] != 0) {
+      tail_started = TRUE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+  Calculate the hash of a transcript at a checkpoint.
+
+  Only the bytes of each segment not yet consumed by the running hash are hashed. The running
+  hash is then duplicated and finalized, so it can continue to absorb later transcript data.
+
+  @param  transcript_hash                The running hash of the transcript.
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  segment                       The transcript segments, in concatenation order.
+  @param  segment_count                  The number of transcript segments.
+  @param  hash_value                    Pointer to a buffer that receives the hash value.
+
+  @retval TRUE   transcript hash is calculated.
+  @retval FALSE  transcript hash is not calculated.
+**/
+boolean
+spdm_transcript_hash_calculate (
+  IN OUT spdm_transcript_hash_t          *transcript_hash,
+  IN     uint32                          bash_hash_algo,
+  IN     const spdm_transcript_segment_t *segment,
+  IN     uintn                           segment_count,
+     OUT uint8                           *hash_value
+  )
+{
+  uintn    index;
+  uintn    consumed_size;
+  uint8    segment_hash[MAX_HASH_SIZE];
+  uint8    hash_context[MAX_HASH_CONTEXT_SIZE];
+  boolean  result;
+
+  ASSERT (segment_count <= MAX_SPDM_TRANSCRIPT_SEGMENT_COUNT);
+  if (segment_count > MAX_SPDM_TRANSCRIPT_SEGMENT_COUNT) {
+    return FALSE;
+  }
+
+  if (!spdm_transcript_hash_is_size_prefix (transcript_hash, bash_hash_algo, segment, segment_count)) {
+    spdm_transcript_hash_reset (transcript_hash);
+    result = spdm_hash_init (bash_hash_algo, transcript_hash->hash_context);
+    if (!result) {
+      return FALSE;
+    }
+    transcript_hash->bash_hash_algo = bash_hash_algo;
+    transcript_hash->valid = TRUE;
+  }
+
+  for (index = 0; index < segment_count; index++) {
+    consumed_size = transcript_hash->consumed_size[index];
+    if (consumed_size == segment[index].size) {
+      continue;
+    }
+    if (segment[index].hash_data) {
+      //
+      // A hashed segment is absorbed at once, when it is first reached.
+      //
+      ASSERT (consumed_size == 0);
+      result = spdm_hash_all (bash_hash_algo, segment[index].data, segment[index].size, segment_hash);
+      if (result) {
+        result = spdm_hash_update (bash_hash_algo, transcript_hash->hash_context, segment_hash, spdm_get_hash_size (bash_hash_algo));
+      }
+    } else {
+      result = spdm_hash_update (bash_hash_algo, transcript_hash->hash_context, (const uint8 *)segment[index].data + consumed_size, segment[index].size - consumed_size);
+    }
+    if (!result) {
+      spdm_transcript_hash_reset (transcript_hash);
+      return FALSE;
+    }
+    transcript_hash->consumed_size[index] = segment[index].size;
+  }
+
+  result = spdm_hash_duplicate (bash_hash_algo, transcript_hash->hash_context, hash_context);
+  if (!result) {
+    return FALSE;
+  }
+  result = spdm_hash_final (bash_hash_algo, hash_context, hash_value);
+  zero_mem (hash_context, sizeof(hash_context));
+  return result;
 }
\ No newline at end of file
@@ -0,0 +1,322 @@
+/** @file
+  SPDM common library.
+  It follows the SPDM Specification.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_common_lib_internal.h"
+#include <library/threadlib.h>
+
+/**
+  This function removes the first job from the queue and runs it.
+  The caller must hold the mutex of the worker pool. The mutex is released while the job runs.
+
+  @param  worker_pool                    The worker pool.
+**/
+void
+spdm_worker_pool_run_next_job (
+  IN OUT spdm_worker_pool_t       *worker_pool
+  )
+{
+  spdm_job_t          *job;
+
+  ASSERT (worker_pool->job_count != 0);
+  job = worker_pool->job[worker_pool->job_head];
+  worker_pool->job_head = (worker_pool->job_head + 1) % MAX_SPDM_WORKER_JOB_COUNT;
+  worker_pool->job_count--;
+  job->status = SPDM_JOB_STATUS_RUNNING;
+  mutex_unlock (worker_pool->mutex);
+
+  job->func (job->context);
+
+  mutex_lock (worker_pool->mutex);
+  job->status = SPDM_JOB_STATUS_DONE;
+  cond_broadcast (worker_pool->done_cond);
+}
+
+/**
+  The worker thread of the worker pool.
+
+  @param  context                        The worker pool.
+**/
+void
+spdm_worker_pool_worker (
+  IN     void                     *context
+  )
+{
+  spdm_worker_pool_t  *worker_pool;
+
+  worker_pool = context;
+
+  mutex_lock (worker_pool->mutex);
+  while (!worker_pool->stop) {
+    if (worker_pool->job_count == 0) {
+      cond_wait (worker_pool->job_cond, worker_pool->mutex);
+      continue;
+    }
+    spdm_worker_pool_run_next_job (worker_pool);
+  }
+  mutex_unlock (worker_pool->mutex);
+}
+
+/**
+  This function starts the threads of the worker pool.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @retval TRUE  The worker pool is running.
+  @retval FALSE The worker pool is disabled or cannot be started.
+**/
+boolean
+spdm_worker_pool_start (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  spdm_worker_pool_t  *worker_pool;
+  uintn               index;
+
+  worker_pool = &spdm_context->worker_pool;
+  if (worker_pool->thread_count == 0) {
+    return FALSE;
+  }
+  if (worker_pool->running_thread_count != 0) {
+    return TRUE;
+  }
+
+  worker_pool->mutex = mutex_new ();
+  worker_pool->job_cond = cond_new ();
+  worker_pool->done_cond = cond_new ();
+  if ((worker_pool->mutex == NULL) || (worker_pool->job_cond == NULL) || (worker_pool->done_cond == NULL)) {
+    spdm_worker_pool_stop (spdm_context);
+    return FALSE;
+  }
+  worker_pool->stop = FALSE;
+  worker_pool->job_head = 0;
+  worker_pool->job_count = 0;
+  for (index = 0; index < worker_pool->thread_count; index++) {
+    worker_pool->thread[index] = thread_create (spdm_worker_pool_worker, worker_pool);
+    if (worker_pool->thread[index] == NULL) {
+      break;
+    }
+    worker_pool->running_thread_count++;
+  }
+  if (worker_pool->running_thread_count == 0) {
+    spdm_worker_pool_stop (spdm_context);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+  This function stops the threads of the worker pool.
+
+  The running jobs are completed. The jobs that are not started are dropped and set to SPDM_JOB_STATUS_DROPPED,
+  so that spdm_worker_pool_is_job_done reports them.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_worker_pool_stop (
+  IN     spdm_context_t           *spdm_context
+  )
+{
+  spdm_worker_pool_t  *worker_pool;
+  uintn               index;
+
+  worker_pool = &spdm_context->worker_pool;
+  if (worker_pool->running_thread_count != 0) {
+    mutex_lock (worker_pool->mutex);
+    worker_pool->stop = TRUE;
+    while (worker_pool->job_count != 0) {
+      worker_pool->job[worker_pool->job_head]->status = SPDM_JOB_STATUS_DROPPED;
+      worker_pool->job_head = (worker_pool->job_head + 1) % MAX_SPDM_WORKER_JOB_COUNT;
+      worker_pool->job_count--;
+    }
+    cond_broadcast (worker_pool->job_cond);
+    cond_broadcast (worker_pool->done_cond);
+    mutex_unlock (worker_pool->mutex);
+    for (index = 0; index < worker_pool->running_thread_count; index++) {
+      thread_join (worker_pool->thread[index]);
+      worker_pool->thread[index] = NULL;
+    }
+    worker_pool->running_thread_count = 0;
+  }
+  if (worker_pool->done_cond != NULL) {
+    cond_free (worker_pool->done_cond);
+    worker_pool->done_cond = NULL;
+  }
+  if (worker_pool->job_cond != NULL) {
+    cond_free (worker_pool->job_cond);
+    worker_pool->job_cond = NULL;
+  }
+  if (worker_pool->mutex != NULL) {
+    mutex_free (worker_pool->mutex);
+    worker_pool->mutex = NULL;
+  }
+  worker_pool->stop = FALSE;
+  worker_pool->job_head = 0;
+  worker_pool->job_count = 0;
+}
+
+/**
+  This function runs the jobs and returns when all jobs are done.
+
+  The first job is run by the caller. The other jobs are run by the worker pool if it is enabled,
+  otherwise they are run by the caller one after another.
+  The caller runs the queued jobs while it waits, so that a job run by the worker pool
+  may call spdm_run_jobs itself. A job dropped by spdm_worker_pool_stop is also run by the caller,
+  so that a job run by the worker pool completes while the worker pool is stopped.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  job                           The jobs to be run.
+  @param  job_count                     The count of the jobs.
+**/
+void
+spdm_run_jobs (
+  IN     spdm_context_t           *spdm_context,
+  IN OUT spdm_job_t               *job,
+  IN     uintn                    job_count
+  )
+{
+  spdm_worker_pool_t  *worker_pool;
+  uintn               index;
+  boolean             started;
+
+  for (index = 0; index < job_count; index++) {
+    job[index].status = SPDM_JOB_STATUS_QUEUED;
+  }
+
+  worker_pool = &spdm_context->worker_pool;
+  started = (boolean)((job_count > 1) && spdm_worker_pool_start (spdm_context));
+  if (started) {
+    mutex_lock (worker_pool->mutex);
+    for (index = 1; index < job_count; index++) {
+      //
+      // No job is queued once the worker pool is being stopped.
+      //
+      if (worker_pool->stop || (worker_pool->job_count >= MAX_SPDM_WORKER_JOB_COUNT)) {
+        break;
+      }
+      worker_pool->job[(worker_pool->job_head + worker_pool->job_count) % MAX_SPDM_WORKER_JOB_COUNT] = &job[index];
+      worker_pool->job_count++;
+    }
+    cond_broadcast (worker_pool->job_cond);
+    mutex_unlock (worker_pool->mutex);
+    //
+    // The jobs that are not queued are run by the caller.
+    //
+    for (; index < job_count; index++) {
+      job[index].status = SPDM_JOB_STATUS_RUNNING;
+      job[index].func (job[index].context);
+      job[index].status = SPDM_JOB_STATUS_DONE;
+    }
+  }
+
+  job[0].status = SPDM_JOB_STATUS_RUNNING;
+  job[0].func (job[0].context);
+  job[0].status = SPDM_JOB_STATUS_DONE;
+
+  if (started) {
+    mutex_lock (worker_pool->mutex);
+    for (index = 1; index < job_count; index++) {
+      while (job[index].status != SPDM_JOB_STATUS_DONE) {
+        //
+        // The job is dropped by spdm_worker_pool_stop before it is started. No worker thread will run it.
+        //
+        if (job[index].status == SPDM_JOB_STATUS_DROPPED) {
+          job[index].status = SPDM_JOB_STATUS_RUNNING;
+          mutex_unlock (worker_pool->mutex);
+          job[index].func (job[index].context);
+          mutex_lock (worker_pool->mutex);
+          job[index].status = SPDM_JOB_STATUS_DONE;
+          continue;
+        }
+        //
+        // Help the worker pool instead of waiting. All worker threads may be busy,
+        // for example, one of them runs a deferred request that calls this function.
+        //
+        if (worker_pool->job_count != 0) {
+          spdm_worker_pool_run_next_job (worker_pool);
+          continue;
+        }
+        cond_wait (worker_pool->done_cond, worker_pool->mutex);
+      }
+    }
+    mutex_unlock (worker_pool->mutex);
+  } else {
+    for (index = 1; index < job_count; index++) {
+      job[index].status = SPDM_JOB_STATUS_RUNNING;
+      job[index].func (job[index].context);
+      job[index].status = SPDM_JOB_STATUS_DONE;
+    }
+  }
+}
+
+/**
+  This function queues a job to the worker pool and returns at once.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  job                           The job to be run. It must be valid until the job is done.
+
+  @retval TRUE  The job is queued. Use spdm_worker_pool_is_job_done to check the job.
+  @retval FALSE The worker pool is disabled or the queue is full. The job is not run.
+**/
+boolean
+spdm_worker_pool_submit (
+  IN     spdm_context_t           *spdm_context,
+  IN OUT spdm_job_t               *job
+  )
+{
+  spdm_worker_pool_t  *worker_pool;
+  boolean             result;
+
+  job->status = SPDM_JOB_STATUS_IDLE;
+  if (!spdm_worker_pool_start (spdm_context)) {
+    return FALSE;
+  }
+
+  worker_pool = &spdm_context->worker_pool;
+  result = FALSE;
+  mutex_lock (worker_pool->mutex);
+  if (worker_pool->job_count < MAX_SPDM_WORKER_JOB_COUNT) {
+    job->status = SPDM_JOB_STATUS_QUEUED;
+    worker_pool->job[(worker_pool->job_head + worker_pool->job_count) % MAX_SPDM_WORKER_JOB_COUNT] = job;
+    worker_pool->job_count++;
+    cond_signal (worker_pool->job_cond);
+    result = TRUE;
+  }
+  mutex_unlock (worker_pool->mutex);
+  return result;
+}
+
+/**
+  This function checks whether a job queued by spdm_worker_pool_submit is done.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  job                           The job queued by spdm_worker_pool_submit.
+
+  @retval TRUE  The job is done or dropped. job->status tells which one.
+  @retval FALSE The job is queued or running.
+**/
+boolean
+spdm_worker_pool_is_job_done (
+  IN     spdm_context_t           *spdm_context,
+  IN     spdm_job_t               *job
+  )
+{
+  spdm_worker_pool_t  *worker_pool;
+  uint8               status;
+
+  worker_pool = &spdm_context->worker_pool;
+  if (worker_pool->running_thread_count == 0) {
+    status = job->status;
+  } else {
+    mutex_lock (worker_pool->mutex);
+    status = job->status;
+    mutex_unlock (worker_pool->mutex);
+  }
+  return (boolean)((status == SPDM_JOB_STATUS_DONE) || (status == SPDM_JOB_STATUS_DROPPED));
+}
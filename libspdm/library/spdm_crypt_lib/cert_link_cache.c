@@ -0,0 +1,212 @@
+/** @file
+  SPDM common library.
+  It follows the SPDM Specification.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <library/spdm_crypt_lib.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//
+// The verified certificate link cache keeps the links which passed x509_verify_cert,
+// so that a root or intermediate certificate shared by many peers is verified once,
+// instead of once per peer and per connection.
+//
+// A link is identified by the hash of the issuer certificate and the hash of the certificate,
+// so a link is found only if both certificates are exactly the same.
+// The cache is shared by all SPDM contexts of the process.
+//
+// x509_verify_cert checks the validity period of the certificate with some crypto libraries,
+// so the validity period is kept with the link and checked again on every hit.
+// The validity period is got before the lock is taken, and copied into the entry with x509_copy_date_time,
+// because a date_time object may point into its own buffer.
+//
+// The least recently used entry is replaced, so that the links of the roots and intermediates
+// shared by many peers stay in the cache while the leaf links of each peer come and go.
+//
+#define SPDM_CERT_LINK_CACHE_DATE_TIME_SIZE  64
+
+typedef struct {
+  boolean     valid;
+  uint32      bash_hash_algo;
+  uint8       issuer_cert_hash[MAX_HASH_SIZE];
+  uint8       cert_hash[MAX_HASH_SIZE];
+  uint8       not_before[SPDM_CERT_LINK_CACHE_DATE_TIME_SIZE];
+  uintn       not_before_size;
+  uint8       not_after[SPDM_CERT_LINK_CACHE_DATE_TIME_SIZE];
+  uintn       not_after_size;
+  uint64      last_use;
+} spdm_cert_link_cache_entry_t;
+
+static spdm_cert_link_cache_entry_t  m_cert_link_cache[MAX_SPDM_CERT_LINK_CACHE_ENTRY_COUNT];
+static uint64                        m_cert_link_cache_use_count;
+
+#if defined(_MSC_VER)
+static volatile long   m_cert_link_cache_lock;
+#else
+static volatile uintn  m_cert_link_cache_lock;
+#endif
+
+static
+void
+cert_link_cache_lock (
+  void
+  )
+{
+#if defined(_MSC_VER)
+  while (_InterlockedExchange (&m_cert_link_cache_lock, 1) != 0) {
+  }
+#else
+  while (__sync_lock_test_and_set (&m_cert_link_cache_lock, 1) != 0) {
+  }
+#endif
+}
+
+static
+void
+cert_link_cache_unlock (
+  void
+  )
+{
+#if defined(_MSC_VER)
+  _InterlockedExchange (&m_cert_link_cache_lock, 0);
+#else
+  __sync_lock_release (&m_cert_link_cache_lock);
+#endif
+}
+
+/**
+  This function checks whether a certificate link is in the verified certificate link cache.
+
+  The validity period of the certificate is checked on every hit.
+  An entry whose certificate is expired or not yet valid is dropped.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo of the certificate hashes.
+  @param  issuer_cert_hash               The hash of the issuer certificate.
+  @param  cert_hash                      The hash of the certificate.
+
+  @retval TRUE  the link is verified before, and the certificate is still valid.
+  @retval FALSE the link is not in the cache.
+**/
+boolean
+spdm_cert_link_cache_find (
+  IN uint32                       bash_hash_algo,
+  IN const uint8                  *issuer_cert_hash,
+  IN const uint8                  *cert_hash
+  )
+{
+  spdm_cert_link_cache_entry_t  *entry;
+  uintn                         hash_size;
+  uintn                         index;
+  boolean                       found;
+
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  found = FALSE;
+  cert_link_cache_lock ();
+  for (index = 0; index < MAX_SPDM_CERT_LINK_CACHE_ENTRY_COUNT; index++) {
+    entry = &m_cert_link_cache[index];
+    if (entry->valid &&
+        (entry->bash_hash_algo == bash_hash_algo) &&
+        (compare_mem (entry->cert_hash, cert_hash, hash_size) == 0) &&
+        (compare_mem (entry->issuer_cert_hash, issuer_cert_hash, hash_size) == 0)) {
+      if (spdm_x509_date_time_check (entry->not_before, entry->not_before_size, entry->not_after, entry->not_after_size) &&
+          x509_check_current_date_time (entry->not_before, entry->not_after)) {
+        m_cert_link_cache_use_count++;
+        entry->last_use = m_cert_link_cache_use_count;
+        found = TRUE;
+      } else {
+        entry->valid = FALSE;
+      }
+      break;
+    }
+  }
+  cert_link_cache_unlock ();
+  return found;
+}
+
+/**
+  This function adds a verified certificate link to the verified certificate link cache.
+
+  The validity period of the certificate is kept with the link.
+  An invalid entry is used first, otherwise the least recently used entry is replaced.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo of the certificate hashes.
+  @param  issuer_cert_hash               The hash of the issuer certificate.
+  @param  cert_hash                      The hash of the certificate.
+  @param  cert                           The DER-encoded certificate.
+  @param  cert_size                      size in bytes of the certificate.
+**/
+void
+spdm_cert_link_cache_add (
+  IN uint32                       bash_hash_algo,
+  IN const uint8                  *issuer_cert_hash,
+  IN const uint8                  *cert_hash,
+  IN const uint8                  *cert,
+  IN uintn                        cert_size
+  )
+{
+  spdm_cert_link_cache_entry_t  *entry;
+  uintn                         hash_size;
+  uintn                         index;
+  uint8                         not_before[SPDM_CERT_LINK_CACHE_DATE_TIME_SIZE];
+  uintn                         not_before_size;
+  uint8                         not_after[SPDM_CERT_LINK_CACHE_DATE_TIME_SIZE];
+  uintn                         not_after_size;
+
+  //
+  // A link whose validity cannot be got is not cached.
+  //
+  not_before_size = sizeof(not_before);
+  not_after_size = sizeof(not_after);
+  if (!x509_get_validity (cert, cert_size, not_before, &not_before_size, not_after, &not_after_size)) {
+    return ;
+  }
+
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  cert_link_cache_lock ();
+  entry = NULL;
+  for (index = 0; index < MAX_SPDM_CERT_LINK_CACHE_ENTRY_COUNT; index++) {
+    if (!m_cert_link_cache[index].valid) {
+      entry = &m_cert_link_cache[index];
+      break;
+    }
+    if ((entry == NULL) || (m_cert_link_cache[index].last_use < entry->last_use)) {
+      entry = &m_cert_link_cache[index];
+    }
+  }
+  zero_mem (entry, sizeof(spdm_cert_link_cache_entry_t));
+  entry->not_before_size = sizeof(entry->not_before);
+  entry->not_after_size = sizeof(entry->not_after);
+  if (x509_copy_date_time (not_before, not_before_size, entry->not_before, &entry->not_before_size) &&
+      x509_copy_date_time (not_after, not_after_size, entry->not_after, &entry->not_after_size)) {
+    entry->bash_hash_algo = bash_hash_algo;
+    copy_mem (entry->issuer_cert_hash, issuer_cert_hash, hash_size);
+    copy_mem (entry->cert_hash, cert_hash, hash_size);
+    m_cert_link_cache_use_count++;
+    entry->last_use = m_cert_link_cache_use_count;
+    entry->valid = TRUE;
+  }
+  cert_link_cache_unlock ();
+}
+
+/**
+  This function invalidates the verified certificate link cache.
+
+  It should be called when the trust of a certificate is revoked,
+  so that the links of the certificate are verified again.
+**/
+void
+spdm_clear_cert_link_cache (
+  void
+  )
+{
+  cert_link_cache_lock ();
+  zero_mem (m_cert_link_cache, sizeof(m_cert_link_cache));
+  m_cert_link_cache_use_count = 0;
+  cert_link_cache_unlock ();
+}
@@ -137,6 +137,333 @@ spdm_hash_all (
   return hash_function (data, data_size, hash_value);
 }
 
+/**
+  Return hash init function, based upon the negotiated hash algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return hash init function
+**/
+static
+hash_init_func
+get_spdm_hash_init_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return sha256_init;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return sha384_init;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return sha512_init;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Initializes user-supplied memory as hash context, based upon the negotiated hash algorithm.
+
+  The hash_context buffer must be at least MAX_HASH_CONTEXT_SIZE bytes.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hash_context                  Pointer to hash context being initialized.
+
+  @retval TRUE   hash context initialization succeeded.
+  @retval FALSE  hash context initialization failed.
+**/
+boolean
+spdm_hash_init (
+  IN   uint32                       bash_hash_algo,
+  OUT  void                         *hash_context
+  )
+{
+  hash_init_func   hash_function;
+  hash_function = get_spdm_hash_init_func (bash_hash_algo);
+  if (hash_function == NULL) {
+    return FALSE;
+  }
+  return hash_function (hash_context);
+}
+
+/**
+  Return hash duplicate function, based upon the negotiated hash algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return hash duplicate function
+**/
+static
+hash_duplicate_func
+get_spdm_hash_duplicate_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return sha256_duplicate;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return sha384_duplicate;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return sha512_duplicate;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Makes a copy of an existing hash context, based upon the negotiated hash algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hash_context                  Pointer to hash context being copied.
+  @param  new_hash_context              Pointer to new hash context.
+
+  @retval TRUE   hash context copy succeeded.
+  @retval FALSE  hash context copy failed.
+**/
+boolean
+spdm_hash_duplicate (
+  IN   uint32                       bash_hash_algo,
+  IN   const void                   *hash_context,
+  OUT  void                         *new_hash_context
+  )
+{
+  hash_duplicate_func   hash_function;
+  hash_function = get_spdm_hash_duplicate_func (bash_hash_algo);
+  if (hash_function == NULL) {
+    return FALSE;
+  }
+  return hash_function (hash_context, new_hash_context);
+}
+
+/**
+  Return hash update function, based upon the negotiated hash algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return hash update function
+**/
+static
+hash_update_func
+get_spdm_hash_update_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return sha256_update;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return sha384_update;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return sha512_update;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Digests the input data and updates hash context, based upon the negotiated hash algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hash_context                  Pointer to the hash context.
+  @param  data                         Pointer to the buffer containing the data to be hashed.
+  @param  data_size                     size of data buffer in bytes.
+
+  @retval TRUE   hash data digest succeeded.
+  @retval FALSE  hash data digest failed.
+**/
+boolean
+spdm_hash_update (
+  IN      uint32                       bash_hash_algo,
+  IN OUT  void                         *hash_context,
+  IN      const void                   *data,
+  IN      uintn                        data_size
+  )
+{
+  hash_update_func   hash_function;
+  hash_function = get_spdm_hash_update_func (bash_hash_algo);
+  if (hash_function == NULL) {
+    return FALSE;
+  }
+  return hash_function (hash_context, data, data_size);
+}
+
+/**
+  Return hash final function, based upon the negotiated hash algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return hash final function
+**/
+static
+hash_final_func
+get_spdm_hash_final_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return sha256_final;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return sha384_final;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return sha512_final;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Completes computation of the hash digest value, based upon the negotiated hash algorithm.
+
+  After this function has been called, the hash context cannot be used again.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hash_context                  Pointer to the hash context.
+  @param  hash_value                    Pointer to a buffer that receives the hash value.
+
+  @retval TRUE   hash digest computation succeeded.
+  @retval FALSE  hash digest computation failed.
+**/
+boolean
+spdm_hash_final (
+  IN      uint32                       bash_hash_algo,
+  IN OUT  void                         *hash_context,
+  OUT     uint8                        *hash_value
+  )
+{
+  hash_final_func   hash_function;
+  hash_function = get_spdm_hash_final_func (bash_hash_algo);
+  if (hash_function == NULL) {
+    return FALSE;
+  }
+  return hash_function (hash_context, hash_value);
+}
+
+/**
+  Computes the hash of a message given as a list of segments, based upon the negotiated hash algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  segment                       Pointer to the segments of the data to be hashed.
+  @param  segment_count                  number of segments.
+  @param  hash_value                    Pointer to a buffer that receives the hash value.
+
+  @retval TRUE   hash computation succeeded.
+  @retval FALSE  hash computation failed.
+**/
+boolean
+spdm_hash_all_segments (
+  IN   uint32                       bash_hash_algo,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  OUT  uint8                        *hash_value
+  )
+{
+  uint8     hash_context[MAX_HASH_CONTEXT_SIZE];
+  uintn     index;
+  boolean   result;
+
+  if (segment_count == 1) {
+    return spdm_hash_all (bash_hash_algo, segment[0].data, segment[0].size, hash_value);
+  }
+
+  result = spdm_hash_init (bash_hash_algo, hash_context);
+  for (index = 0; result && (index < segment_count); index++) {
+    if (segment[index].size == 0) {
+      continue;
+    }
+    result = spdm_hash_update (bash_hash_algo, hash_context, segment[index].data, segment[index].size);
+  }
+  if (result) {
+    result = spdm_hash_final (bash_hash_algo, hash_context, hash_value);
+  }
+  zero_mem (hash_context, sizeof(hash_context));
+  return result;
+}
+
 /**
   This function returns the SPDM measurement hash algorithm size.
 
@@ -279,41 +606,501 @@ get_spdm_hmac_func (
     ASSERT (FALSE);
     break;
   }
-  ASSERT (FALSE);
-  return NULL;
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Computes the HMAC of a input data buffer, based upon the negotiated HMAC algorithm.
+
+  This function performs the HMAC of a given data buffer, and return the hash value.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  data                         Pointer to the buffer containing the data to be HMACed.
+  @param  data_size                     size of data buffer in bytes.
+  @param  key                          Pointer to the user-supplied key.
+  @param  key_size                      key size in bytes.
+  @param  hash_value                    Pointer to a buffer that receives the HMAC value.
+
+  @retval TRUE   HMAC computation succeeded.
+  @retval FALSE  HMAC computation failed.
+**/
+boolean
+spdm_hmac_all (
+  IN   uint32                       bash_hash_algo,
+  IN   const void                   *data,
+  IN   uintn                        data_size,
+  IN   const uint8                  *key,
+  IN   uintn                        key_size,
+  OUT  uint8                        *hmac_value
+  )
+{
+  hmac_all_func   hmac_function;
+  hmac_function = get_spdm_hmac_func (bash_hash_algo);
+  if (hmac_function == NULL) {
+    return FALSE;
+  }
+  return hmac_function (data, data_size, key, key_size, hmac_value);
+}
+
+/**
+  Return HMAC new function, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return HMAC new function
+**/
+hmac_new_func
+get_spdm_hmac_new_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return hmac_sha256_new;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return hmac_sha384_new;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return hmac_sha512_new;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Allocates and initializes one HMAC context, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+
+  @return  Pointer to the HMAC context that has been initialized.
+           If the allocations fails, spdm_hmac_new() returns NULL.
+**/
+void *
+spdm_hmac_new (
+  IN   uint32                       bash_hash_algo
+  )
+{
+  hmac_new_func   hmac_function;
+  hmac_function = get_spdm_hmac_new_func (bash_hash_algo);
+  if (hmac_function == NULL) {
+    return NULL;
+  }
+  return hmac_function ();
+}
+
+/**
+  Return HMAC free function, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return HMAC free function
+**/
+hmac_free_func
+get_spdm_hmac_free_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return hmac_sha256_free;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return hmac_sha384_free;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return hmac_sha512_free;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Release the specified HMAC context, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to the HMAC context to be released.
+**/
+void
+spdm_hmac_free (
+  IN   uint32                       bash_hash_algo,
+  IN   void                         *hmac_ctx
+  )
+{
+  hmac_free_func   hmac_function;
+  hmac_function = get_spdm_hmac_free_func (bash_hash_algo);
+  if (hmac_function == NULL) {
+    return;
+  }
+  hmac_function (hmac_ctx);
+}
+
+/**
+  Return HMAC set key function, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return HMAC set key function
+**/
+hmac_set_key_func
+get_spdm_hmac_set_key_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return hmac_sha256_set_key;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return hmac_sha384_set_key;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return hmac_sha512_set_key;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Set user-supplied key for subsequent use, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to HMAC context.
+  @param  key                          Pointer to the user-supplied key.
+  @param  key_size                      key size in bytes.
+
+  @retval TRUE   The key is set successfully.
+  @retval FALSE  The key is set unsuccessfully.
+**/
+boolean
+spdm_hmac_set_key (
+  IN   uint32                       bash_hash_algo,
+  OUT  void                         *hmac_ctx,
+  IN   const uint8                  *key,
+  IN   uintn                        key_size
+  )
+{
+  hmac_set_key_func   hmac_function;
+  hmac_function = get_spdm_hmac_set_key_func (bash_hash_algo);
+  if (hmac_function == NULL) {
+    return FALSE;
+  }
+  return hmac_function (hmac_ctx, key, key_size);
+}
+
+/**
+  Return HMAC duplicate function, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return HMAC duplicate function
+**/
+hmac_duplicate_func
+get_spdm_hmac_duplicate_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return hmac_sha256_duplicate;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return hmac_sha384_duplicate;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return hmac_sha512_duplicate;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Makes a copy of an existing HMAC context, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to HMAC context being copied.
+  @param  new_hmac_ctx                  Pointer to new HMAC context.
+
+  @retval TRUE   HMAC context copy succeeded.
+  @retval FALSE  HMAC context copy failed.
+**/
+boolean
+spdm_hmac_duplicate (
+  IN   uint32                       bash_hash_algo,
+  IN   const void                   *hmac_ctx,
+  OUT  void                         *new_hmac_ctx
+  )
+{
+  hmac_duplicate_func   hmac_function;
+  hmac_function = get_spdm_hmac_duplicate_func (bash_hash_algo);
+  if (hmac_function == NULL) {
+    return FALSE;
+  }
+  return hmac_function (hmac_ctx, new_hmac_ctx);
+}
+
+/**
+  Return HMAC update function, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return HMAC update function
+**/
+hmac_update_func
+get_spdm_hmac_update_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return hmac_sha256_update;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return hmac_sha384_update;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return hmac_sha512_update;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Digests the input data and updates HMAC context, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to the HMAC context.
+  @param  data                         Pointer to the buffer containing the data to be digested.
+  @param  data_size                     size of data buffer in bytes.
+
+  @retval TRUE   HMAC data digest succeeded.
+  @retval FALSE  HMAC data digest failed.
+**/
+boolean
+spdm_hmac_update (
+  IN      uint32                       bash_hash_algo,
+  IN OUT  void                         *hmac_ctx,
+  IN      const void                   *data,
+  IN      uintn                        data_size
+  )
+{
+  hmac_update_func   hmac_function;
+  hmac_function = get_spdm_hmac_update_func (bash_hash_algo);
+  if (hmac_function == NULL) {
+    return FALSE;
+  }
+  return hmac_function (hmac_ctx, data, data_size);
+}
+
+/**
+  Return HMAC final function, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                  SPDM bash_hash_algo
+
+  @return HMAC final function
+**/
+hmac_final_func
+get_spdm_hmac_final_func (
+  IN      uint32       bash_hash_algo
+  )
+{
+  switch (bash_hash_algo) {
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256:
+#if OPENSPDM_SHA256_SUPPORT == 1
+    return hmac_sha256_final;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384:
+#if OPENSPDM_SHA384_SUPPORT == 1
+    return hmac_sha384_final;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512:
+#if OPENSPDM_SHA512_SUPPORT == 1
+    return hmac_sha512_final;
+#else
+    ASSERT (FALSE);
+    break;
+#endif
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_256:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_384:
+  case SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA3_512:
+    ASSERT (FALSE);
+    break;
+  }
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Completes computation of the HMAC digest value, based upon the negotiated HMAC algorithm.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  hmac_ctx                      Pointer to the HMAC context.
+  @param  hmac_value                    Pointer to a buffer that receives the HMAC digest value.
+
+  @retval TRUE   HMAC digest computation succeeded.
+  @retval FALSE  HMAC digest computation failed.
+**/
+boolean
+spdm_hmac_final (
+  IN      uint32                       bash_hash_algo,
+  IN OUT  void                         *hmac_ctx,
+  OUT     uint8                        *hmac_value
+  )
+{
+  hmac_final_func   hmac_function;
+  hmac_function = get_spdm_hmac_final_func (bash_hash_algo);
+  if (hmac_function == NULL) {
+    return FALSE;
+  }
+  return hmac_function (hmac_ctx, hmac_value);
 }
 
 /**
-  Computes the HMAC of a input data buffer, based upon the negotiated HMAC algorithm.
+  Computes the HMAC of a message given as a list of segments, based upon the negotiated HMAC algorithm.
 
-  This function performs the HMAC of a given data buffer, and return the hash value.
+  The segments are processed as if they were concatenated into one buffer.
 
   @param  bash_hash_algo                 SPDM bash_hash_algo
-  @param  data                         Pointer to the buffer containing the data to be HMACed.
-  @param  data_size                     size of data buffer in bytes.
+  @param  segment                       Pointer to the segments of the data to be HMACed.
+  @param  segment_count                  number of segments.
   @param  key                          Pointer to the user-supplied key.
   @param  key_size                      key size in bytes.
-  @param  hash_value                    Pointer to a buffer that receives the HMAC value.
+  @param  hmac_value                    Pointer to a buffer that receives the HMAC value.
 
   @retval TRUE   HMAC computation succeeded.
   @retval FALSE  HMAC computation failed.
 **/
 boolean
-spdm_hmac_all (
+spdm_hmac_all_segments (
   IN   uint32                       bash_hash_algo,
-  IN   const void                   *data,
-  IN   uintn                        data_size,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
   IN   const uint8                  *key,
   IN   uintn                        key_size,
   OUT  uint8                        *hmac_value
   )
 {
-  hmac_all_func   hmac_function;
-  hmac_function = get_spdm_hmac_func (bash_hash_algo);
-  if (hmac_function == NULL) {
+  void      *hmac_ctx;
+  uintn     index;
+  boolean   result;
+
+  if (segment_count == 1) {
+    return spdm_hmac_all (bash_hash_algo, segment[0].data, segment[0].size, key, key_size, hmac_value);
+  }
+
+  hmac_ctx = spdm_hmac_new (bash_hash_algo);
+  if (hmac_ctx == NULL) {
     return FALSE;
   }
-  return hmac_function (data, data_size, key, key_size, hmac_value);
+  result = spdm_hmac_set_key (bash_hash_algo, hmac_ctx, key, key_size);
+  for (index = 0; result && (index < segment_count); index++) {
+    if (segment[index].size == 0) {
+      continue;
+    }
+    result = spdm_hmac_update (bash_hash_algo, hmac_ctx, segment[index].data, segment[index].size);
+  }
+  if (result) {
+    result = spdm_hmac_final (bash_hash_algo, hmac_ctx, hmac_value);
+  }
+  spdm_hmac_free (bash_hash_algo, hmac_ctx);
+  return result;
 }
 
 /**
@@ -393,6 +1180,115 @@ spdm_hkdf_expand (
   return hkdf_expand_function (prk, prk_size, info, info_size, out, out_size);
 }
 
+/**
+  Derive a batch of HMAC-based Expand key Derivation Function (HKDF) Expand outputs from one PRK,
+  based upon the negotiated HKDF algorithm.
+
+  One HMAC context is keyed with the PRK once, and each HMAC block of each output starts from a copy of it.
+  The result is the same as calling spdm_hkdf_expand for each item.
+
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  prk                          Pointer to the user-supplied key.
+  @param  prk_size                      key size in bytes.
+  @param  item                         Pointer to the info and output buffer of each output.
+  @param  item_count                    number of items.
+
+  @retval TRUE   Hkdf generated successfully.
+  @retval FALSE  Hkdf generation failed.
+**/
+boolean
+spdm_hkdf_expand_batch (
+  IN   uint32                       bash_hash_algo,
+  IN   const uint8                  *prk,
+  IN   uintn                        prk_size,
+  IN   const spdm_hkdf_expand_item_t *item,
+  IN   uintn                        item_count
+  )
+{
+#if OPENSPDM_HKDF_EXPAND_BATCH_SUPPORT == 1
+  void      *prk_hmac_ctx;
+  void      *hmac_ctx;
+  uint8     block[MAX_HASH_SIZE];
+  uintn     hash_size;
+  uintn     index;
+  uintn     offset;
+  uintn     copy_size;
+  uint8     counter;
+  boolean   result;
+
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  if ((hash_size == 0) || (hash_size > MAX_HASH_SIZE)) {
+    return FALSE;
+  }
+  for (index = 0; index < item_count; index++) {
+    if (item[index].out_size > hash_size * 255) {
+      return FALSE;
+    }
+  }
+
+  prk_hmac_ctx = spdm_hmac_new (bash_hash_algo);
+  hmac_ctx = spdm_hmac_new (bash_hash_algo);
+  if ((prk_hmac_ctx == NULL) || (hmac_ctx == NULL)) {
+    if (prk_hmac_ctx != NULL) {
+      spdm_hmac_free (bash_hash_algo, prk_hmac_ctx);
+    }
+    if (hmac_ctx != NULL) {
+      spdm_hmac_free (bash_hash_algo, hmac_ctx);
+    }
+    return FALSE;
+  }
+  //
+  // Both contexts are keyed, because some backends can only copy into a context of the same HMAC algorithm.
+  //
+  result = spdm_hmac_set_key (bash_hash_algo, prk_hmac_ctx, prk, prk_size) &&
+           spdm_hmac_set_key (bash_hash_algo, hmac_ctx, prk, prk_size);
+
+  //
+  // T(N) = HMAC(PRK, T(N-1) | info | N), T(0) is empty (RFC 5869).
+  //
+  for (index = 0; result && (index < item_count); index++) {
+    counter = 0;
+    for (offset = 0; result && (offset < item[index].out_size); offset += copy_size) {
+      counter++;
+      result = spdm_hmac_duplicate (bash_hash_algo, prk_hmac_ctx, hmac_ctx);
+      if (result && (counter > 1)) {
+        result = spdm_hmac_update (bash_hash_algo, hmac_ctx, block, hash_size);
+      }
+      if (result) {
+        result = spdm_hmac_update (bash_hash_algo, hmac_ctx, item[index].info, item[index].info_size);
+      }
+      if (result) {
+        result = spdm_hmac_update (bash_hash_algo, hmac_ctx, &counter, sizeof(counter));
+      }
+      if (result) {
+        result = spdm_hmac_final (bash_hash_algo, hmac_ctx, block);
+      }
+      copy_size = item[index].out_size - offset;
+      if (copy_size > hash_size) {
+        copy_size = hash_size;
+      }
+      if (result) {
+        copy_mem (item[index].out + offset, block, copy_size);
+      }
+    }
+  }
+
+  secure_zero_mem (block, sizeof(block));
+  spdm_hmac_free (bash_hash_algo, hmac_ctx);
+  spdm_hmac_free (bash_hash_algo, prk_hmac_ctx);
+  return result;
+#else
+  uintn     index;
+
+  for (index = 0; index < item_count; index++) {
+    if (!spdm_hkdf_expand (bash_hash_algo, prk, prk_size, item[index].info, item[index].info_size, item[index].out, item[index].out_size)) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+#endif
+}
+
 /**
   This function returns the SPDM asymmetric algorithm size.
 
@@ -680,6 +1576,65 @@ spdm_asym_verify (
   }
 }
 
+/**
+  Verifies the asymmetric signature of a message given as a list of segments,
+  based upon negotiated asymmetric algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  base_asym_algo                 SPDM base_asym_algo
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  context                      Pointer to asymmetric context for signature verification.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to asymmetric signature to be verified.
+  @param  sig_size                      size of signature in bytes.
+
+  @retval  TRUE   Valid asymmetric signature.
+  @retval  FALSE  Invalid asymmetric signature or invalid asymmetric context.
+**/
+boolean
+spdm_asym_verify_segments (
+  IN   uint32                       base_asym_algo,
+  IN   uint32                       bash_hash_algo,
+  IN   void                         *context,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  IN   const uint8                  *signature,
+  IN   uintn                        sig_size
+  )
+{
+  asym_verify_func   verify_function;
+  uint8         message_hash[MAX_HASH_SIZE];
+  uintn         hash_size;
+  boolean       result;
+  uintn         hash_nid;
+
+  if (segment_count == 1) {
+    return spdm_asym_verify (base_asym_algo, bash_hash_algo, context, segment[0].data, segment[0].size, signature, sig_size);
+  }
+
+  //
+  // Only the message hash can be computed from segments. A raw message must be contiguous.
+  //
+  if (!spdm_asym_func_need_hash (base_asym_algo)) {
+    ASSERT (FALSE);
+    return FALSE;
+  }
+
+  hash_nid = get_spdm_hash_nid (bash_hash_algo);
+  verify_function = get_spdm_asym_verify (base_asym_algo);
+  if (verify_function == NULL) {
+    return FALSE;
+  }
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  result = spdm_hash_all_segments (bash_hash_algo, segment, segment_count, message_hash);
+  if (!result) {
+    return FALSE;
+  }
+  return verify_function (context, hash_nid, message_hash, hash_size, signature, sig_size);
+}
+
 /**
   Return asymmetric GET_PRIVATE_KEY_FROM_PEM function, based upon the asymmetric algorithm.
 
@@ -850,6 +1805,68 @@ spdm_asym_sign (
   }
 }
 
+/**
+  Carries out the signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+  If the signature buffer is too small to hold the contents of signature, FALSE
+  is returned and sig_size is set to the required buffer size to obtain the signature.
+
+  @param  base_asym_algo                 SPDM base_asym_algo
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  context                      Pointer to asymmetric context for signature generation.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_asym_sign_segments (
+  IN      uint32                       base_asym_algo,
+  IN      uint32                       bash_hash_algo,
+  IN      void                         *context,
+  IN      const spdm_data_segment_t    *segment,
+  IN      uintn                        segment_count,
+  OUT     uint8                        *signature,
+  IN OUT  uintn                        *sig_size
+  )
+{
+  asym_sign_func     asym_sign;
+  uint8         message_hash[MAX_HASH_SIZE];
+  uintn         hash_size;
+  boolean       result;
+  uintn         hash_nid;
+
+  if (segment_count == 1) {
+    return spdm_asym_sign (base_asym_algo, bash_hash_algo, context, segment[0].data, segment[0].size, signature, sig_size);
+  }
+
+  //
+  // Only the message hash can be computed from segments. A raw message must be contiguous.
+  //
+  if (!spdm_asym_func_need_hash (base_asym_algo)) {
+    ASSERT (FALSE);
+    return FALSE;
+  }
+
+  hash_nid = get_spdm_hash_nid (bash_hash_algo);
+  asym_sign = get_spdm_asym_sign (base_asym_algo);
+  if (asym_sign == NULL) {
+    return FALSE;
+  }
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  result = spdm_hash_all_segments (bash_hash_algo, segment, segment_count, message_hash);
+  if (!result) {
+    return FALSE;
+  }
+  return asym_sign (context, hash_nid, message_hash, hash_size, signature, sig_size);
+}
+
 /**
   This function returns the SPDM requester asymmetric algorithm size.
 
@@ -1028,6 +2045,65 @@ spdm_req_asym_verify (
   }
 }
 
+/**
+  Verifies the asymmetric signature of a message given as a list of segments,
+  based upon negotiated requester asymmetric algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  req_base_asym_alg               SPDM req_base_asym_alg
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  context                      Pointer to asymmetric context for signature verification.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to asymmetric signature to be verified.
+  @param  sig_size                      size of signature in bytes.
+
+  @retval  TRUE   Valid asymmetric signature.
+  @retval  FALSE  Invalid asymmetric signature or invalid asymmetric context.
+**/
+boolean
+spdm_req_asym_verify_segments (
+  IN   uint16                       req_base_asym_alg,
+  IN   uint32                       bash_hash_algo,
+  IN   void                         *context,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  IN   const uint8                  *signature,
+  IN   uintn                        sig_size
+  )
+{
+  asym_verify_func   verify_function;
+  uint8         message_hash[MAX_HASH_SIZE];
+  uintn         hash_size;
+  boolean       result;
+  uintn         hash_nid;
+
+  if (segment_count == 1) {
+    return spdm_req_asym_verify (req_base_asym_alg, bash_hash_algo, context, segment[0].data, segment[0].size, signature, sig_size);
+  }
+
+  //
+  // Only the message hash can be computed from segments. A raw message must be contiguous.
+  //
+  if (!spdm_req_asym_func_need_hash (req_base_asym_alg)) {
+    ASSERT (FALSE);
+    return FALSE;
+  }
+
+  hash_nid = get_spdm_hash_nid (bash_hash_algo);
+  verify_function = get_spdm_req_asym_verify (req_base_asym_alg);
+  if (verify_function == NULL) {
+    return FALSE;
+  }
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  result = spdm_hash_all_segments (bash_hash_algo, segment, segment_count, message_hash);
+  if (!result) {
+    return FALSE;
+  }
+  return verify_function (context, hash_nid, message_hash, hash_size, signature, sig_size);
+}
+
 /**
   Return asymmetric GET_PRIVATE_KEY_FROM_PEM function, based upon the asymmetric algorithm.
 
@@ -1126,22 +2202,84 @@ spdm_req_asym_sign (
   uintn         hash_nid;
 
   hash_nid = get_spdm_hash_nid (bash_hash_algo);
-  need_hash = spdm_req_asym_func_need_hash (req_base_asym_alg);
-
+  need_hash = spdm_req_asym_func_need_hash (req_base_asym_alg);
+
+  asym_sign = get_spdm_req_asym_sign (req_base_asym_alg);
+  if (asym_sign == NULL) {
+    return FALSE;
+  }
+  if (need_hash) {
+    hash_size = spdm_get_hash_size (bash_hash_algo);
+    result = spdm_hash_all (bash_hash_algo, message, message_size, message_hash);
+    if (!result) {
+      return FALSE;
+    }
+    return asym_sign (context, hash_nid, message_hash, hash_size, signature, sig_size);
+  } else {
+    return asym_sign (context, hash_nid, message, message_size, signature, sig_size);
+  }
+}
+
+/**
+  Carries out the signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+  If the signature buffer is too small to hold the contents of signature, FALSE
+  is returned and sig_size is set to the required buffer size to obtain the signature.
+
+  @param  req_base_asym_alg               SPDM req_base_asym_alg
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+  @param  context                      Pointer to asymmetric context for signature generation.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_req_asym_sign_segments (
+  IN      uint16                       req_base_asym_alg,
+  IN      uint32                       bash_hash_algo,
+  IN      void                         *context,
+  IN      const spdm_data_segment_t    *segment,
+  IN      uintn                        segment_count,
+  OUT     uint8                        *signature,
+  IN OUT  uintn                        *sig_size
+  )
+{
+  asym_sign_func     asym_sign;
+  uint8         message_hash[MAX_HASH_SIZE];
+  uintn         hash_size;
+  boolean       result;
+  uintn         hash_nid;
+
+  if (segment_count == 1) {
+    return spdm_req_asym_sign (req_base_asym_alg, bash_hash_algo, context, segment[0].data, segment[0].size, signature, sig_size);
+  }
+
+  //
+  // Only the message hash can be computed from segments. A raw message must be contiguous.
+  //
+  if (!spdm_req_asym_func_need_hash (req_base_asym_alg)) {
+    ASSERT (FALSE);
+    return FALSE;
+  }
+
+  hash_nid = get_spdm_hash_nid (bash_hash_algo);
   asym_sign = get_spdm_req_asym_sign (req_base_asym_alg);
   if (asym_sign == NULL) {
     return FALSE;
   }
-  if (need_hash) {
-    hash_size = spdm_get_hash_size (bash_hash_algo);
-    result = spdm_hash_all (bash_hash_algo, message, message_size, message_hash);
-    if (!result) {
-      return FALSE;
-    }
-    return asym_sign (context, hash_nid, message_hash, hash_size, signature, sig_size);
-  } else {
-    return asym_sign (context, hash_nid, message, message_size, signature, sig_size);
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  result = spdm_hash_all_segments (bash_hash_algo, segment, segment_count, message_hash);
+  if (!result) {
+    return FALSE;
   }
+  return asym_sign (context, hash_nid, message_hash, hash_size, signature, sig_size);
 }
 
 /**
@@ -1728,6 +2866,189 @@ spdm_aead_decryption (
   return aead_dec_function (key, key_size, iv, iv_size, a_data, a_data_size, data_in, data_in_size, tag, tag_size, data_out, data_out_size);
 }
 
+/**
+  Allocates and initializes one AEAD context for subsequent use, based upon negotiated AEAD algorithm.
+
+  The AEAD context keeps the expanded key, so that the key schedule is not repeated for every message.
+  NULL is returned if the AEAD algorithm has no context support. The caller should use
+  spdm_aead_encryption and spdm_aead_decryption with the key instead.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+
+  @return  Pointer to the AEAD context that has been initialized.
+**/
+void *
+spdm_aead_new (
+  IN   uint16                       aead_cipher_suite
+  )
+{
+  switch (aead_cipher_suite) {
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_128_GCM:
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_256_GCM:
+#if OPENSPDM_AEAD_GCM_SUPPORT == 1
+    return aead_aes_gcm_new ();
+#else
+    break;
+#endif
+  }
+  return NULL;
+}
+
+/**
+  Release the AEAD context, based upon negotiated AEAD algorithm.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+  @param  aead_context                   Pointer to the AEAD context to be released.
+**/
+void
+spdm_aead_free (
+  IN   uint16                       aead_cipher_suite,
+  IN   void                         *aead_context
+  )
+{
+  if (aead_context == NULL) {
+    return ;
+  }
+  switch (aead_cipher_suite) {
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_128_GCM:
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_256_GCM:
+#if OPENSPDM_AEAD_GCM_SUPPORT == 1
+    aead_aes_gcm_free (aead_context);
+    return ;
+#else
+    break;
+#endif
+  }
+  ASSERT (FALSE);
+}
+
+/**
+  Set the key of the AEAD context, based upon negotiated AEAD algorithm.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+  @param  aead_context                   Pointer to the AEAD context.
+  @param  key                          Pointer to the encryption key.
+  @param  key_size                      size of the encryption key in bytes.
+
+  @retval TRUE   The key is set successfully.
+  @retval FALSE  The key is set unsuccessfully.
+**/
+boolean
+spdm_aead_set_key (
+  IN   uint16                       aead_cipher_suite,
+  IN   void                         *aead_context,
+  IN   const uint8                  *key,
+  IN   uintn                        key_size
+  )
+{
+  switch (aead_cipher_suite) {
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_128_GCM:
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_256_GCM:
+#if OPENSPDM_AEAD_GCM_SUPPORT == 1
+    return aead_aes_gcm_set_key (aead_context, key, key_size);
+#else
+    break;
+#endif
+  }
+  return FALSE;
+}
+
+/**
+  Performs AEAD authenticated encryption on a data buffer and additional authenticated data (AAD),
+  with the key in the AEAD context, based upon negotiated AEAD algorithm.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+  @param  aead_context                   Pointer to the AEAD context with the key set.
+  @param  iv                           Pointer to the IV value.
+  @param  iv_size                       size of the IV value in bytes.
+  @param  a_data                        Pointer to the additional authenticated data (AAD).
+  @param  a_data_size                    size of the additional authenticated data (AAD) in bytes.
+  @param  data_in                       Pointer to the input data buffer to be encrypted.
+  @param  data_in_size                   size of the input data buffer in bytes.
+  @param  tag_out                       Pointer to a buffer that receives the authentication tag output.
+  @param  tag_size                      size of the authentication tag in bytes.
+  @param  data_out                      Pointer to a buffer that receives the encryption output.
+  @param  data_out_size                  size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD authenticated encryption succeeded.
+  @retval FALSE  AEAD authenticated encryption failed.
+**/
+boolean
+spdm_aead_encryption_with_context (
+  IN   uint16                       aead_cipher_suite,
+  IN   void                         *aead_context,
+  IN   const uint8                  *iv,
+  IN   uintn                        iv_size,
+  IN   const uint8                  *a_data,
+  IN   uintn                        a_data_size,
+  IN   const uint8                  *data_in,
+  IN   uintn                        data_in_size,
+  OUT  uint8                        *tag_out,
+  IN   uintn                        tag_size,
+  OUT  uint8                        *data_out,
+  OUT  uintn                        *data_out_size
+  )
+{
+  switch (aead_cipher_suite) {
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_128_GCM:
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_256_GCM:
+#if OPENSPDM_AEAD_GCM_SUPPORT == 1
+    return aead_aes_gcm_encrypt_with_context (aead_context, iv, iv_size, a_data, a_data_size, data_in, data_in_size, tag_out, tag_size, data_out, data_out_size);
+#else
+    break;
+#endif
+  }
+  return FALSE;
+}
+
+/**
+  Performs AEAD authenticated decryption on a data buffer and additional authenticated data (AAD),
+  with the key in the AEAD context, based upon negotiated AEAD algorithm.
+
+  @param  aead_cipher_suite              SPDM aead_cipher_suite
+  @param  aead_context                   Pointer to the AEAD context with the key set.
+  @param  iv                           Pointer to the IV value.
+  @param  iv_size                       size of the IV value in bytes.
+  @param  a_data                        Pointer to the additional authenticated data (AAD).
+  @param  a_data_size                    size of the additional authenticated data (AAD) in bytes.
+  @param  data_in                       Pointer to the input data buffer to be decrypted.
+  @param  data_in_size                   size of the input data buffer in bytes.
+  @param  tag                          Pointer to a buffer that contains the authentication tag.
+  @param  tag_size                      size of the authentication tag in bytes.
+  @param  data_out                      Pointer to a buffer that receives the decryption output.
+  @param  data_out_size                  size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD authenticated decryption succeeded.
+  @retval FALSE  AEAD authenticated decryption failed.
+**/
+boolean
+spdm_aead_decryption_with_context (
+  IN   uint16                       aead_cipher_suite,
+  IN   void                         *aead_context,
+  IN   const uint8                  *iv,
+  IN   uintn                        iv_size,
+  IN   const uint8                  *a_data,
+  IN   uintn                        a_data_size,
+  IN   const uint8                  *data_in,
+  IN   uintn                        data_in_size,
+  IN   const uint8                  *tag,
+  IN   uintn                        tag_size,
+  OUT  uint8                        *data_out,
+  OUT  uintn                        *data_out_size
+  )
+{
+  switch (aead_cipher_suite) {
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_128_GCM:
+  case SPDM_ALGORITHMS_AEAD_CIPHER_SUITE_AES_256_GCM:
+#if OPENSPDM_AEAD_GCM_SUPPORT == 1
+    return aead_aes_gcm_decrypt_with_context (aead_context, iv, iv_size, a_data, a_data_size, data_in, data_in_size, tag, tag_size, data_out, data_out_size);
+#else
+    break;
+#endif
+  }
+  return FALSE;
+}
+
 /**
   Generates a random byte stream of the specified size.
 
@@ -1749,7 +3070,6 @@ spdm_get_random_number (
 /**
   Check the X509 DataTime is within a valid range.
 
-  @param  spdm_context                  A pointer to the SPDM context.
   @param  from                         notBefore Pointer to date_time object.
   @param  from_size                     notBefore date_time object size.
   @param  to                           notAfter Pointer to date_time object.
@@ -1758,9 +3078,8 @@ spdm_get_random_number (
   @retval  TRUE   verification pass.
   @retval  FALSE  verification fail.
 **/
-static
 boolean
-internal_spdm_x509_date_time_check (
+spdm_x509_date_time_check (
   IN uint8 *from,
   IN uintn from_size,
   IN uint8 *to,
@@ -1897,7 +3216,7 @@ spdm_x509_certificate_check (
     goto cleanup;
   }
 
-  status = internal_spdm_x509_date_time_check(end_cert_from, end_cert_from_len, end_cert_to, end_cert_to_len);
+  status = spdm_x509_date_time_check(end_cert_from, end_cert_from_len, end_cert_to, end_cert_to_len);
   if (!status) {
     goto cleanup;
   }
@@ -2173,51 +3492,238 @@ spdm_verify_certificate_chain_buffer (
   IN uintn                        cert_chain_buffer_size
   )
 {
-  uint8                                     *cert_chain_data;
-  uintn                                     cert_chain_data_size;
-  uint8                                     *root_cert_buffer;
-  uintn                                     root_cert_buffer_size;
+  spdm_cert_chain_verify_context_t          verify_context;
+
+  spdm_cert_chain_verify_init (&verify_context, bash_hash_algo);
+  return spdm_cert_chain_verify_final (&verify_context, cert_chain_buffer, cert_chain_buffer_size);
+}
+
+/**
+  This function initializes the verification of a certificate chain buffer which is received portion by portion.
+
+  @param  verify_context                 The certificate chain verification context.
+  @param  bash_hash_algo                 SPDM bash_hash_algo
+**/
+void
+spdm_cert_chain_verify_init (
+  OUT spdm_cert_chain_verify_context_t  *verify_context,
+  IN  uint32                            bash_hash_algo
+  )
+{
+  zero_mem (verify_context, sizeof(spdm_cert_chain_verify_context_t));
+  verify_context->bash_hash_algo = bash_hash_algo;
+  verify_context->next_cert_offset = sizeof(spdm_cert_chain_t) + spdm_get_hash_size (bash_hash_algo);
+}
+
+/**
+  This function verifies one link of a certificate chain.
+
+  A link found in the verified certificate link cache is not verified again,
+  as long as the certificate is still in its validity period.
+  The cache is shared by all SPDM contexts of the process.
+
+  @param  link                           The link of the certificate chain.
+
+  @retval TRUE  the certificate is issued by the issuer certificate.
+  @retval FALSE the certificate is invalid, or it is not issued by the issuer certificate.
+**/
+boolean
+spdm_verify_cert_chain_link (
+  IN const spdm_cert_chain_link_t  *link
+  )
+{
+  uint8                                     issuer_cert_hash[MAX_HASH_SIZE];
+  uint8                                     cert_hash[MAX_HASH_SIZE];
+  boolean                                   hash_status;
+
+  //
+  // The cache is skipped if the hashes are not available.
+  //
+  hash_status = spdm_hash_all (link->bash_hash_algo, link->cert, link->cert_size, cert_hash);
+  if (hash_status) {
+    if (link->issuer_cert == link->cert) {
+      copy_mem (issuer_cert_hash, cert_hash, sizeof(issuer_cert_hash));
+    } else {
+      hash_status = spdm_hash_all (link->bash_hash_algo, link->issuer_cert, link->issuer_cert_size, issuer_cert_hash);
+    }
+  }
+  if (hash_status && spdm_cert_link_cache_find (link->bash_hash_algo, issuer_cert_hash, cert_hash)) {
+    return TRUE;
+  }
+
+  if (!x509_verify_cert (link->cert, link->cert_size, link->issuer_cert, link->issuer_cert_size)) {
+    return FALSE;
+  }
+
+  if (hash_status) {
+    spdm_cert_link_cache_add (link->bash_hash_algo, issuer_cert_hash, cert_hash, link->cert, link->cert_size);
+  }
+  return TRUE;
+}
+
+/**
+  This function gets the links of the certificates which are completely received in the certificate chain buffer,
+  and not returned or verified by the previous calls, so that the links can be verified in parallel.
+
+  The root certificate is verified with the root hash in the certificate chain buffer.
+  The returned links are treated as verified by the verification context,
+  so the caller must verify each of them with spdm_verify_cert_chain_link.
+
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              The received part of the certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the received part of the certificate chain buffer.
+  @param  link                           The buffer to store the links.
+  @param  link_count                     On input, the count of the links the buffer can hold.
+                                       On output, the count of the links returned.
+
+  @retval TRUE  the links are returned.
+  @retval FALSE the root certificate does not match the root hash.
+**/
+boolean
+spdm_cert_chain_verify_get_links (
+  IN OUT spdm_cert_chain_verify_context_t  *verify_context,
+  IN     void                              *cert_chain_buffer,
+  IN     uintn                             cert_chain_buffer_size,
+     OUT spdm_cert_chain_link_t            *link,
+  IN OUT uintn                             *link_count
+  )
+{
+  uint8                                     *cert_buffer;
+  uintn                                     cert_buffer_size;
+  uint8                                     *ptr;
+  uintn                                     length;
   uintn                                     hash_size;
   uint8                                     calc_root_cert_hash[MAX_HASH_SIZE];
-  uint8                                     *leaf_cert_buffer;
-  uintn                                     leaf_cert_buffer_size;
+  uintn                                     index;
+
+  index = 0;
+  while ((index < *link_count) && (verify_context->next_cert_offset < cert_chain_buffer_size)) {
+    //
+    // Wait for more data if the next certificate is not completely received.
+    //
+    cert_buffer = (uint8 *)cert_chain_buffer + verify_context->next_cert_offset;
+    ptr = cert_buffer;
+    if (!asn1_get_tag (&ptr, (uint8 *)cert_chain_buffer + cert_chain_buffer_size, &length, CRYPTO_ASN1_SEQUENCE | CRYPTO_ASN1_CONSTRUCTED)) {
+      break;
+    }
+    if (length > (uintn)((uint8 *)cert_chain_buffer + cert_chain_buffer_size - ptr)) {
+      break;
+    }
+    cert_buffer_size = (uintn)(ptr - cert_buffer) + length;
+
+    link[index].bash_hash_algo = verify_context->bash_hash_algo;
+    link[index].cert = cert_buffer;
+    link[index].cert_size = cert_buffer_size;
+    if (verify_context->cert_count == 0) {
+      hash_size = spdm_get_hash_size (verify_context->bash_hash_algo);
+      spdm_hash_all (verify_context->bash_hash_algo, cert_buffer, cert_buffer_size, calc_root_cert_hash);
+      if (compare_mem ((uint8 *)cert_chain_buffer + sizeof(spdm_cert_chain_t), calc_root_cert_hash, hash_size) != 0) {
+        DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (cert root hash mismatch) !!!\n"));
+        *link_count = index;
+        return FALSE;
+      }
+      //
+      // The root certificate is self-signed.
+      //
+      link[index].issuer_cert = cert_buffer;
+      link[index].issuer_cert_size = cert_buffer_size;
+    } else {
+      link[index].issuer_cert = (uint8 *)cert_chain_buffer + verify_context->last_cert_offset;
+      link[index].issuer_cert_size = verify_context->last_cert_size;
+    }
 
-  hash_size = spdm_get_hash_size (bash_hash_algo);
+    verify_context->last_cert_offset = verify_context->next_cert_offset;
+    verify_context->last_cert_size = cert_buffer_size;
+    verify_context->next_cert_offset += cert_buffer_size;
+    verify_context->cert_count ++;
+    index ++;
+  }
+
+  *link_count = index;
+  return TRUE;
+}
+
+/**
+  This function verifies the certificates which are completely received in the certificate chain buffer,
+  and not verified by the previous calls.
+
+  The root certificate is verified with the root hash in the certificate chain buffer, and
+  each certificate is verified with the preceding certificate.
+
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              The received part of the certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the received part of the certificate chain buffer.
+
+  @retval TRUE  the received certificates pass the verification.
+  @retval FALSE a received certificate fails the verification.
+**/
+boolean
+spdm_cert_chain_verify_update (
+  IN OUT spdm_cert_chain_verify_context_t  *verify_context,
+  IN     void                              *cert_chain_buffer,
+  IN     uintn                             cert_chain_buffer_size
+  )
+{
+  spdm_cert_chain_link_t                    link;
+  uintn                                     link_count;
 
   if (cert_chain_buffer_size > MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE) {
     DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (buffer too large) !!!\n"));
     return FALSE;
   }
 
-  if (cert_chain_buffer_size <= sizeof(spdm_cert_chain_t) + hash_size) {
-    DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (buffer too small) !!!\n"));
-    return FALSE;
+  while (TRUE) {
+    link_count = 1;
+    if (!spdm_cert_chain_verify_get_links (verify_context, cert_chain_buffer, cert_chain_buffer_size, &link, &link_count)) {
+      return FALSE;
+    }
+    if (link_count == 0) {
+      break;
+    }
+    if (!spdm_verify_cert_chain_link (&link)) {
+      DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (cert chain verify failed at cert %d)!!!\n", verify_context->cert_count - 1));
+      return FALSE;
+    }
   }
 
-  cert_chain_data = (uint8 *)cert_chain_buffer + sizeof(spdm_cert_chain_t) + hash_size;
-  cert_chain_data_size = cert_chain_buffer_size - sizeof(spdm_cert_chain_t) - hash_size;
-  if (!x509_get_cert_from_cert_chain (cert_chain_data, cert_chain_data_size, 0, &root_cert_buffer, &root_cert_buffer_size)) {
-    DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (get root certificate failed)!!!\n"));
-    return FALSE;
-  }
+  return TRUE;
+}
+
+/**
+  This function completes the verification of the certificate chain buffer.
+
+  The certificates which are not verified by spdm_cert_chain_verify_update are verified,
+  then the leaf certificate is checked.
+
+  @param  verify_context                 The certificate chain verification context.
+  @param  cert_chain_buffer              The certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certificate chain buffer.
 
-  spdm_hash_all (bash_hash_algo, root_cert_buffer, root_cert_buffer_size, calc_root_cert_hash);
-  if (compare_mem ((uint8 *)cert_chain_buffer + sizeof(spdm_cert_chain_t), calc_root_cert_hash, hash_size) != 0) {
-    DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (cert root hash mismatch) !!!\n"));
+  @retval TRUE  certificate chain buffer integrity verification pass.
+  @retval FALSE certificate chain buffer integrity verification fail.
+**/
+boolean
+spdm_cert_chain_verify_final (
+  IN OUT spdm_cert_chain_verify_context_t  *verify_context,
+  IN     void                              *cert_chain_buffer,
+  IN     uintn                             cert_chain_buffer_size
+  )
+{
+  if (cert_chain_buffer_size <= sizeof(spdm_cert_chain_t) + spdm_get_hash_size (verify_context->bash_hash_algo)) {
+    DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (buffer too small) !!!\n"));
     return FALSE;
   }
 
-  if (!x509_verify_cert_chain (root_cert_buffer, root_cert_buffer_size, cert_chain_data, cert_chain_data_size)) {
-    DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (cert chain verify failed)!!!\n"));
+  if (!spdm_cert_chain_verify_update (verify_context, cert_chain_buffer, cert_chain_buffer_size)) {
     return FALSE;
   }
 
-  if (!x509_get_cert_from_cert_chain (cert_chain_data, cert_chain_data_size, -1, &leaf_cert_buffer, &leaf_cert_buffer_size)) {
-    DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (get leaf certificate failed)!!!\n"));
+  if (verify_context->cert_count == 0) {
+    DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (get root certificate failed)!!!\n"));
     return FALSE;
   }
 
-  if(!spdm_x509_certificate_check (leaf_cert_buffer, leaf_cert_buffer_size)) {
+  if(!spdm_x509_certificate_check ((uint8 *)cert_chain_buffer + verify_context->last_cert_offset, verify_context->last_cert_size)) {
     DEBUG((DEBUG_INFO, "!!! VerifyCertificateChainBuffer - FAIL (leaf certificate check failed)!!!\n"));
     return FALSE;
   }
@@ -9,6 +9,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <library/spdm_pqc_crypt_lib.h>
 #include <library/pqc_crypt_lib.h>
+#include <library/malloclib.h>
 
 typedef struct {
   uintn nid;
@@ -400,6 +401,72 @@ spdm_pqc_sig_set_public_key (
   return TRUE;
 }
 
+/**
+  Return a contiguous message for a list of segments.
+
+  PQC signature schemes consume the raw message in one shot. A single segment is returned as is,
+  multiple segments are concatenated into a buffer allocated from the pool.
+
+  @param  segment                       Pointer to the segments of the message.
+  @param  segment_count                  number of segments.
+  @param  message                      On output, pointer to the contiguous message.
+  @param  message_size                  On output, size of the message in bytes.
+
+  @retval  TRUE   the contiguous message is returned. Release it with spdm_pqc_release_segments().
+  @retval  FALSE  out of resources.
+**/
+boolean
+spdm_pqc_gather_segments (
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  OUT  const uint8                  **message,
+  OUT  uintn                        *message_size
+  )
+{
+  uintn    index;
+  uintn    offset;
+  uint8    *buffer;
+
+  if (segment_count == 1) {
+    *message = segment[0].data;
+    *message_size = segment[0].size;
+    return TRUE;
+  }
+
+  *message_size = 0;
+  for (index = 0; index < segment_count; index++) {
+    *message_size += segment[index].size;
+  }
+  buffer = allocate_pool (*message_size);
+  if (buffer == NULL) {
+    return FALSE;
+  }
+  offset = 0;
+  for (index = 0; index < segment_count; index++) {
+    copy_mem (buffer + offset, segment[index].data, segment[index].size);
+    offset += segment[index].size;
+  }
+  *message = buffer;
+  return TRUE;
+}
+
+/**
+  Release the contiguous message returned by spdm_pqc_gather_segments().
+
+  @param  segment_count                  number of segments.
+  @param  message                      Pointer to the contiguous message.
+**/
+void
+spdm_pqc_release_segments (
+  IN   uintn                        segment_count,
+  IN   const uint8                  *message
+  )
+{
+  if (segment_count != 1) {
+    free_pool ((void *)message);
+  }
+}
+
 /**
   Release the specified PQC SIG context,
   based upon negotiated PQC SIG algorithm.
@@ -443,6 +510,44 @@ spdm_pqc_sig_verify (
   return pqc_sig_verify (context, message, message_size, signature, sig_size);
 }
 
+/**
+  Verifies the PQC signature of a message given as a list of segments,
+  based upon negotiated PQC SIG algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  pqc_sig_algo                   SPDM pqc_sig_algo
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to PQC SIG signature to be verified.
+  @param  sig_size                      Size of signature in bytes.
+
+  @retval  TRUE   Valid PQC SIG signature.
+  @retval  FALSE  Invalid PQC SIG signature or invalid PQC SIG context.
+**/
+boolean
+spdm_pqc_sig_verify_segments (
+  IN  pqc_algo_t     pqc_sig_algo,
+  IN  void         *context,
+  IN  const spdm_data_segment_t  *segment,
+  IN  uintn        segment_count,
+  IN  const uint8  *signature,
+  IN  uintn        sig_size
+  )
+{
+  const uint8  *message;
+  uintn        message_size;
+  boolean      result;
+
+  if (!spdm_pqc_gather_segments (segment, segment_count, &message, &message_size)) {
+    return FALSE;
+  }
+  result = spdm_pqc_sig_verify (pqc_sig_algo, context, message, message_size, signature, sig_size);
+  spdm_pqc_release_segments (segment_count, message);
+  return result;
+}
+
 /**
   Retrieve the Private Key from the raw data.
 
@@ -513,6 +618,45 @@ spdm_pqc_sig_sign (
   return pqc_sig_sign (context, message, message_size, signature, sig_size);
 }
 
+/**
+  Carries out the signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  pqc_sig_algo                   SPDM pqc_sig_algo
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_pqc_sig_sign_segments (
+  IN      pqc_algo_t     pqc_sig_algo,
+  IN      void         *context,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  const uint8  *message;
+  uintn        message_size;
+  boolean      result;
+
+  if (!spdm_pqc_gather_segments (segment, segment_count, &message, &message_size)) {
+    return FALSE;
+  }
+  result = spdm_pqc_sig_sign (pqc_sig_algo, context, message, message_size, signature, sig_size);
+  spdm_pqc_release_segments (segment_count, message);
+  return result;
+}
+
 /**
   This function returns the SPDM requester PQC SIG algorithm size.
 
@@ -610,6 +754,44 @@ spdm_pqc_req_sig_verify (
   return spdm_pqc_sig_verify (pqc_req_sig_algo, context, message, message_size, signature, sig_size);
 }
 
+/**
+  Verifies the PQC SIG signature of a message given as a list of segments,
+  based upon negotiated requester PQC SIG algorithm.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  pqc_req_sig_algo                SPDM pqc_req_sig_algo
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to PQC SIG signature to be verified.
+  @param  sig_size                      Size of signature in bytes.
+
+  @retval  TRUE   Valid PQC SIG signature.
+  @retval  FALSE  Invalid PQC SIG signature or invalid PQC SIG context.
+**/
+boolean
+spdm_pqc_req_sig_verify_segments (
+  IN  pqc_algo_t     pqc_req_sig_algo,
+  IN  void         *context,
+  IN  const spdm_data_segment_t  *segment,
+  IN  uintn        segment_count,
+  IN  const uint8  *signature,
+  IN  uintn        sig_size
+  )
+{
+  const uint8  *message;
+  uintn        message_size;
+  boolean      result;
+
+  if (!spdm_pqc_gather_segments (segment, segment_count, &message, &message_size)) {
+    return FALSE;
+  }
+  result = spdm_pqc_req_sig_verify (pqc_req_sig_algo, context, message, message_size, signature, sig_size);
+  spdm_pqc_release_segments (segment_count, message);
+  return result;
+}
+
 /**
   Retrieve the Private Key from the raw data.
 
@@ -664,6 +846,45 @@ spdm_pqc_req_sig_sign (
   return spdm_pqc_sig_sign (pqc_req_sig_algo, context, message, message_size, signature, sig_size);
 }
 
+/**
+  Carries out the signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  pqc_req_sig_algo                SPDM pqc_req_sig_algo
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_pqc_req_sig_sign_segments (
+  IN      pqc_algo_t     pqc_req_sig_algo,
+  IN      void         *context,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  const uint8  *message;
+  uintn        message_size;
+  boolean      result;
+
+  if (!spdm_pqc_gather_segments (segment, segment_count, &message, &message_size)) {
+    return FALSE;
+  }
+  result = spdm_pqc_req_sig_sign (pqc_req_sig_algo, context, message, message_size, signature, sig_size);
+  spdm_pqc_release_segments (segment_count, message);
+  return result;
+}
+
 /**
   This function returns the SPDM PQC KEM algorithm key size.
 
@@ -944,6 +1165,43 @@ spdm_hybrid_sig_sign (
   return pqc_hybrid_sign (context, 0, message, message_size, signature, sig_size);
 }
 
+/**
+  Carries out the hybrid signature generation of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to buffer to receive signature.
+  @param  sig_size                      On input, the size of signature buffer in bytes.
+                                       On output, the size of data returned in signature buffer in bytes.
+
+  @retval  TRUE   signature successfully generated.
+  @retval  FALSE  signature generation failed.
+  @retval  FALSE  sig_size is too small.
+**/
+boolean
+spdm_hybrid_sig_sign_segments (
+  IN      void         *context,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  const uint8  *message;
+  uintn        message_size;
+  boolean      result;
+
+  if (!spdm_pqc_gather_segments (segment, segment_count, &message, &message_size)) {
+    return FALSE;
+  }
+  result = spdm_hybrid_sig_sign (context, message, message_size, signature, sig_size);
+  spdm_pqc_release_segments (segment_count, message);
+  return result;
+}
+
 /**
   Verifies the PQC signature,
   based upon negotiated PQC SIG algorithm.
@@ -969,6 +1227,41 @@ spdm_hybrid_sig_verify (
   return pqc_hybrid_verify (context, 0, message, message_size, signature, sig_size);
 }
 
+/**
+  Verifies the hybrid signature of a message given as a list of segments.
+
+  The segments are processed as if they were concatenated into one buffer.
+
+  @param  context                      Pointer to the PQC SIG context.
+  @param  segment                       Pointer to the segments of the message to be checked (before hash).
+  @param  segment_count                  number of segments.
+  @param  signature                    Pointer to PQC SIG signature to be verified.
+  @param  sig_size                      Size of signature in bytes.
+
+  @retval  TRUE   Valid PQC SIG signature.
+  @retval  FALSE  Invalid PQC SIG signature or invalid PQC SIG context.
+**/
+boolean
+spdm_hybrid_sig_verify_segments (
+  IN  void         *context,
+  IN  const spdm_data_segment_t  *segment,
+  IN  uintn        segment_count,
+  IN  const uint8  *signature,
+  IN  uintn        sig_size
+  )
+{
+  const uint8  *message;
+  uintn        message_size;
+  boolean      result;
+
+  if (!spdm_pqc_gather_segments (segment, segment_count, &message, &message_size)) {
+    return FALSE;
+  }
+  result = spdm_hybrid_sig_verify (context, message, message_size, signature, sig_size);
+  spdm_pqc_release_segments (segment_count, message);
+  return result;
+}
+
 /**
   Release the specified PQC SIG context,
   based upon negotiated PQC SIG algorithm.
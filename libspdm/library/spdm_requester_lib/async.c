@@ -0,0 +1,970 @@
+/** @file
+  SPDM common library.
+  It follows the SPDM Specification.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_requester_lib_internal.h"
+#include <library/threadlib.h>
+
+/**
+  The flow started by the asynchronous API. It calls the synchronous function with the saved parameters.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of the synchronous function.
+**/
+typedef
+return_status
+(*spdm_async_flow_func_t) (
+  IN     spdm_context_t       *spdm_context
+  );
+
+/**
+  Send the transport layer request message of the flow.
+
+  The flow is suspended until the message is got by spdm_async_get_request_message.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  message_size                  size in bytes of the message data buffer.
+  @param  message                      A pointer to a source buffer to store the message.
+  @param  timeout                      The timeout. It is handled by the caller of the asynchronous API.
+
+  @retval RETURN_SUCCESS               The message is got by the caller.
+  @retval RETURN_DEVICE_ERROR          The flow is cancelled.
+**/
+return_status
+spdm_async_send_message (
+  IN     void                 *context,
+  IN     uintn                message_size,
+  IN     void                 *message,
+  IN     uint64               timeout
+  )
+{
+  spdm_context_t        *spdm_context;
+  spdm_async_context_t  *async;
+
+  spdm_context = context;
+  async = &spdm_context->async;
+  if (async->cancel) {
+    return RETURN_DEVICE_ERROR;
+  }
+  async->message = message;
+  async->message_size = message_size;
+  async->state = SPDM_ASYNC_STATE_SEND;
+  fiber_yield (async->fiber);
+  async->message = NULL;
+  async->message_size = 0;
+  if (async->cancel) {
+    return RETURN_DEVICE_ERROR;
+  }
+  return RETURN_SUCCESS;
+}
+
+/**
+  Receive the transport layer response message of the flow.
+
+  The flow is suspended until the message is fed by spdm_async_feed_response_message.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  message_size                  size in bytes of the message data buffer.
+  @param  message                      A pointer to a destination buffer to store the message.
+  @param  timeout                      The timeout. It is handled by the caller of the asynchronous API.
+
+  @retval RETURN_SUCCESS               The message is fed by the caller.
+  @retval RETURN_DEVICE_ERROR          The flow is cancelled.
+**/
+return_status
+spdm_async_receive_message (
+  IN     void                 *context,
+  IN OUT uintn                *message_size,
+  IN OUT void                 *message,
+  IN     uint64               timeout
+  )
+{
+  spdm_context_t        *spdm_context;
+  spdm_async_context_t  *async;
+
+  spdm_context = context;
+  async = &spdm_context->async;
+  if (async->cancel) {
+    return RETURN_DEVICE_ERROR;
+  }
+  async->message = message;
+  async->receive_message_size = message_size;
+  async->state = SPDM_ASYNC_STATE_RECEIVE;
+  fiber_yield (async->fiber);
+  async->message = NULL;
+  async->receive_message_size = NULL;
+  if (async->cancel) {
+    return RETURN_DEVICE_ERROR;
+  }
+  return RETURN_SUCCESS;
+}
+
+/**
+  This function waits before the requester retries a request.
+
+  If it is called in a flow of the asynchronous API, the flow is suspended in SPDM_ASYNC_STATE_WAIT,
+  so that the thread can drive other flows in the meantime.
+  Otherwise, the thread sleeps.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  microseconds                  The time to wait in microseconds.
+**/
+void
+spdm_requester_wait (
+  IN     spdm_context_t       *spdm_context,
+  IN     uint64               microseconds
+  )
+{
+  spdm_async_context_t  *async;
+
+  async = &spdm_context->async;
+  if (!async->running) {
+    thread_sleep (microseconds);
+    return ;
+  }
+  if (async->cancel) {
+    return ;
+  }
+  async->wait_time = microseconds;
+  async->state = SPDM_ASYNC_STATE_WAIT;
+  fiber_yield (async->fiber);
+  async->wait_time = 0;
+}
+
+/**
+  The entry point of the fiber of the flow.
+
+  @param  context                       A pointer to the SPDM context.
+**/
+void
+spdm_async_flow_entry (
+  IN     void                 *context
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  spdm_context->async.status = ((spdm_async_flow_func_t)spdm_context->async.flow_func) (spdm_context);
+}
+
+/**
+  This function runs the flow until it is suspended or done.
+
+  The device IO functions of the caller are restored after the flow is done.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_async_resume (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  spdm_async_context_t  *async;
+  boolean               finished;
+
+  async = &spdm_context->async;
+  async->running = TRUE;
+  finished = fiber_resume (async->fiber);
+  async->running = FALSE;
+  if (finished) {
+    fiber_free (async->fiber);
+    async->fiber = NULL;
+    async->state = SPDM_ASYNC_STATE_DONE;
+    spdm_register_device_io_func (spdm_context, async->send_message, async->receive_message);
+  }
+}
+
+/**
+  This function starts a flow, and runs it until it sends the first message.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  flow_func                     The flow to be started. The parameters are in async.arg.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_start (
+  IN     spdm_context_t       *spdm_context,
+  IN     spdm_async_flow_func_t flow_func
+  )
+{
+  spdm_async_context_t  *async;
+
+  async = &spdm_context->async;
+  async->fiber = fiber_new (spdm_async_flow_entry, spdm_context, SPDM_ASYNC_FIBER_STACK_SIZE);
+  if (async->fiber == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+  async->flow_func = (uintn)flow_func;
+  async->cancel = FALSE;
+  async->status = RETURN_NOT_READY;
+  async->send_message = spdm_context->send_message;
+  async->receive_message = spdm_context->receive_message;
+  spdm_register_device_io_func (spdm_context, spdm_async_send_message, spdm_async_receive_message);
+
+  spdm_async_resume (spdm_context);
+  return RETURN_SUCCESS;
+}
+
+/**
+  This function checks whether a new flow can be started, and clears the parameters of the flow.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @retval TRUE  A new flow can be started.
+  @retval FALSE Another flow is not finished, or its result is not got by spdm_async_poll.
+**/
+boolean
+spdm_async_prepare (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  if (spdm_context->async.state != SPDM_ASYNC_STATE_IDLE) {
+    return FALSE;
+  }
+  zero_mem (spdm_context->async.arg, sizeof(spdm_context->async.arg));
+  return TRUE;
+}
+
+/**
+  The flow of spdm_init_connection. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0] is get_version_only.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_init_connection. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_init_connection_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_init_connection (spdm_context, (boolean)spdm_context->async.arg[0]);
+}
+
+/**
+  This function starts the flow of spdm_init_connection.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  get_version_only               If the requester sends GET_VERSION only or not.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_init_connection (
+  IN     void                 *context,
+  IN     boolean              get_version_only
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)get_version_only;
+  return spdm_async_start (spdm_context, spdm_async_init_connection_flow);
+}
+
+/**
+  The flow of spdm_get_digest. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0..1] are slot_mask and total_digest_buffer.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_get_digest. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_get_digest_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_get_digest (
+           spdm_context,
+           (uint8 *)spdm_context->async.arg[0],
+           (void *)spdm_context->async.arg[1]
+           );
+}
+
+/**
+  This function starts the flow of spdm_get_digest.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  slot_mask                     The slots which deploy the CertificateChain.
+  @param  total_digest_buffer            A pointer to a destination buffer to store the digest buffer.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_get_digest (
+  IN     void                 *context,
+     OUT uint8                *slot_mask,
+     OUT void                 *total_digest_buffer
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)slot_mask;
+  spdm_context->async.arg[1] = (uintn)total_digest_buffer;
+  return spdm_async_start (spdm_context, spdm_async_get_digest_flow);
+}
+
+/**
+  The flow of spdm_get_certificate. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0..2] are slot_id, cert_chain_size and cert_chain.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_get_certificate. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_get_certificate_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_get_certificate (
+           spdm_context,
+           (uint8)spdm_context->async.arg[0],
+           (uintn *)spdm_context->async.arg[1],
+           (void *)spdm_context->async.arg[2]
+           );
+}
+
+/**
+  This function starts the flow of spdm_get_certificate.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  slot_id                      The number of slot for the certificate chain.
+  @param  cert_chain_size                On input, indicate the size in bytes of the destination buffer to store the digest buffer.
+                                       On output, indicate the size in bytes of the certificate chain.
+  @param  cert_chain                    A pointer to a destination buffer to store the certificate chain.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_get_certificate (
+  IN     void                 *context,
+  IN     uint8                slot_id,
+  IN OUT uintn                *cert_chain_size,
+     OUT void                 *cert_chain
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)slot_id;
+  spdm_context->async.arg[1] = (uintn)cert_chain_size;
+  spdm_context->async.arg[2] = (uintn)cert_chain;
+  return spdm_async_start (spdm_context, spdm_async_get_certificate_flow);
+}
+
+/**
+  The flow of spdm_challenge. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0..2] are slot_id, measurement_hash_type and measurement_hash.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_challenge. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_challenge_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_challenge (
+           spdm_context,
+           (uint8)spdm_context->async.arg[0],
+           (uint8)spdm_context->async.arg[1],
+           (void *)spdm_context->async.arg[2]
+           );
+}
+
+/**
+  This function starts the flow of spdm_challenge.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  slot_id                      The number of slot for the challenge.
+  @param  measurement_hash_type          The type of the measurement hash.
+  @param  measurement_hash              A pointer to a destination buffer to store the measurement hash.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_challenge (
+  IN     void                 *context,
+  IN     uint8                slot_id,
+  IN     uint8                measurement_hash_type,
+     OUT void                 *measurement_hash
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)slot_id;
+  spdm_context->async.arg[1] = (uintn)measurement_hash_type;
+  spdm_context->async.arg[2] = (uintn)measurement_hash;
+  return spdm_async_start (spdm_context, spdm_async_challenge_flow);
+}
+
+/**
+  The flow of spdm_get_measurement. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0..6] are the parameters of spdm_async_get_measurement, in order.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_get_measurement. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_get_measurement_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_get_measurement (
+           spdm_context,
+           (uint32 *)spdm_context->async.arg[0],
+           (uint8)spdm_context->async.arg[1],
+           (uint8)spdm_context->async.arg[2],
+           (uint8)spdm_context->async.arg[3],
+           (uint8 *)spdm_context->async.arg[4],
+           (uint32 *)spdm_context->async.arg[5],
+           (void *)spdm_context->async.arg[6]
+           );
+}
+
+/**
+  This function starts the flow of spdm_get_measurement.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    Indicates if it is a secured message protected via SPDM session.
+                                       If session_id is NULL, it is a normal message.
+                                       If session_id is NOT NULL, it is a secured message.
+  @param  request_attribute             The request attribute of the request message.
+  @param  measurement_operation         The measurement operation of the request message.
+  @param  slot_id                      The number of slot for the certificate chain.
+  @param  number_of_blocks               The number of blocks of the measurement record.
+  @param  measurement_record_length      On input, indicate the size in bytes of the destination buffer to store the measurement record.
+                                       On output, indicate the size in bytes of the measurement record.
+  @param  measurement_record            A pointer to a destination buffer to store the measurement record.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_get_measurement (
+  IN     void                 *context,
+  IN     uint32               *session_id,
+  IN     uint8                request_attribute,
+  IN     uint8                measurement_operation,
+  IN     uint8                slot_id,
+     OUT uint8                *number_of_blocks,
+  IN OUT uint32               *measurement_record_length,
+     OUT void                 *measurement_record
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)session_id;
+  spdm_context->async.arg[1] = (uintn)request_attribute;
+  spdm_context->async.arg[2] = (uintn)measurement_operation;
+  spdm_context->async.arg[3] = (uintn)slot_id;
+  spdm_context->async.arg[4] = (uintn)number_of_blocks;
+  spdm_context->async.arg[5] = (uintn)measurement_record_length;
+  spdm_context->async.arg[6] = (uintn)measurement_record;
+  return spdm_async_start (spdm_context, spdm_async_get_measurement_flow);
+}
+
+/**
+  The flow of spdm_start_session. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0..5] are the parameters of spdm_async_start_session, in order.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_start_session. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_start_session_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_start_session (
+           spdm_context,
+           (boolean)spdm_context->async.arg[0],
+           (uint8)spdm_context->async.arg[1],
+           (uint8)spdm_context->async.arg[2],
+           (uint32 *)spdm_context->async.arg[3],
+           (uint8 *)spdm_context->async.arg[4],
+           (void *)spdm_context->async.arg[5]
+           );
+}
+
+/**
+  This function starts the flow of spdm_start_session.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  use_psk                       FALSE means to use KEY_EXCHANGE/FINISH to start a session.
+                                       TRUE means to use PSK_EXCHANGE/PSK_FINISH to start a session.
+  @param  measurement_hash_type          The type of the measurement hash.
+  @param  slot_id                      The number of slot for the certificate chain.
+  @param  session_id                    The session ID of the session.
+  @param  heartbeat_period              The heartbeat period for the session.
+  @param  measurement_hash              A pointer to a destination buffer to store the measurement hash.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_start_session (
+  IN     void                 *context,
+  IN     boolean              use_psk,
+  IN     uint8                measurement_hash_type,
+  IN     uint8                slot_id,
+     OUT uint32               *session_id,
+     OUT uint8                *heartbeat_period,
+     OUT void                 *measurement_hash
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)use_psk;
+  spdm_context->async.arg[1] = (uintn)measurement_hash_type;
+  spdm_context->async.arg[2] = (uintn)slot_id;
+  spdm_context->async.arg[3] = (uintn)session_id;
+  spdm_context->async.arg[4] = (uintn)heartbeat_period;
+  spdm_context->async.arg[5] = (uintn)measurement_hash;
+  return spdm_async_start (spdm_context, spdm_async_start_session_flow);
+}
+
+/**
+  The flow of spdm_stop_session. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0..1] are session_id and end_session_attributes.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_stop_session. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_stop_session_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_stop_session (
+           spdm_context,
+           (uint32)spdm_context->async.arg[0],
+           (uint8)spdm_context->async.arg[1]
+           );
+}
+
+/**
+  This function starts the flow of spdm_stop_session.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    The session ID of the session.
+  @param  end_session_attributes         The end session attribute for the session.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_stop_session (
+  IN     void                 *context,
+  IN     uint32               session_id,
+  IN     uint8                end_session_attributes
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)session_id;
+  spdm_context->async.arg[1] = (uintn)end_session_attributes;
+  return spdm_async_start (spdm_context, spdm_async_stop_session_flow);
+}
+
+/**
+  The flow of spdm_send_receive_data. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0..5] are the parameters of spdm_async_send_receive_data, in order.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_send_receive_data. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_send_receive_data_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_send_receive_data (
+           spdm_context,
+           (uint32 *)spdm_context->async.arg[0],
+           (boolean)spdm_context->async.arg[1],
+           (void *)spdm_context->async.arg[2],
+           (uintn)spdm_context->async.arg[3],
+           (void *)spdm_context->async.arg[4],
+           (uintn *)spdm_context->async.arg[5]
+           );
+}
+
+/**
+  This function starts the flow of spdm_send_receive_data.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    Indicates if it is a secured message protected via SPDM session.
+                                       If session_id is NULL, it is a normal message.
+                                       If session_id is NOT NULL, it is a secured message.
+  @param  is_app_message                 Indicates if it is an APP message or SPDM message.
+  @param  request                      A pointer to the request data.
+  @param  request_size                  size in bytes of the request data.
+  @param  response                     A pointer to the response data.
+  @param  response_size                 size in bytes of the response data.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_send_receive_data (
+  IN     void                 *context,
+  IN     uint32               *session_id,
+  IN     boolean              is_app_message,
+  IN     void                 *request,
+  IN     uintn                request_size,
+     OUT void                 *response,
+  IN OUT uintn                *response_size
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)session_id;
+  spdm_context->async.arg[1] = (uintn)is_app_message;
+  spdm_context->async.arg[2] = (uintn)request;
+  spdm_context->async.arg[3] = request_size;
+  spdm_context->async.arg[4] = (uintn)response;
+  spdm_context->async.arg[5] = (uintn)response_size;
+  return spdm_async_start (spdm_context, spdm_async_send_receive_data_flow);
+}
+
+/**
+  The flow of spdm_heartbeat. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0] is session_id.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_heartbeat. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_heartbeat_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_heartbeat (spdm_context, (uint32)spdm_context->async.arg[0]);
+}
+
+/**
+  This function starts the flow of spdm_heartbeat.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    The session ID of the session.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_heartbeat (
+  IN     void                 *context,
+  IN     uint32               session_id
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)session_id;
+  return spdm_async_start (spdm_context, spdm_async_heartbeat_flow);
+}
+
+/**
+  The flow of spdm_key_update. It runs in the fiber created by spdm_async_start.
+
+  The parameters are saved in the SPDM context by the asynchronous API: async.arg[0..1] are session_id and single_direction.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the result of spdm_key_update. It is returned by spdm_async_poll after the flow is done.
+**/
+return_status
+spdm_async_key_update_flow (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return spdm_key_update (
+           spdm_context,
+           (uint32)spdm_context->async.arg[0],
+           (boolean)spdm_context->async.arg[1]
+           );
+}
+
+/**
+  This function starts the flow of spdm_key_update.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  session_id                    The session ID of the session.
+  @param  single_direction              TRUE means the operation is UPDATE_KEY.
+                                       FALSE means the operation is UPDATE_ALL_KEYS.
+
+  @retval RETURN_SUCCESS               The flow is started.
+  @retval RETURN_ALREADY_STARTED       Another flow is not finished.
+  @retval RETURN_OUT_OF_RESOURCES      The flow cannot be created.
+**/
+return_status
+spdm_async_key_update (
+  IN     void                 *context,
+  IN     uint32               session_id,
+  IN     boolean              single_direction
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (!spdm_async_prepare (spdm_context)) {
+    return RETURN_ALREADY_STARTED;
+  }
+  spdm_context->async.arg[0] = (uintn)session_id;
+  spdm_context->async.arg[1] = (uintn)single_direction;
+  return spdm_async_start (spdm_context, spdm_async_key_update_flow);
+}
+
+/**
+  This function returns the state of the flow started by the asynchronous API.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the state of the flow.
+**/
+spdm_async_state_t
+spdm_async_get_state (
+  IN     void                 *context
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  return (spdm_async_state_t)spdm_context->async.state;
+}
+
+/**
+  This function gets the transport layer request message of the flow in SPDM_ASYNC_STATE_SEND,
+  then runs the flow until the next step, as if the message was sent.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  message_size                  On input, the size in bytes of the message buffer.
+                                       On output, the size in bytes of the message.
+  @param  message                      A pointer to a destination buffer to store the message.
+
+  @retval RETURN_SUCCESS               The message is returned.
+  @retval RETURN_NOT_READY             The flow is not in SPDM_ASYNC_STATE_SEND.
+  @retval RETURN_BUFFER_TOO_SMALL      The buffer is too small to hold the message.
+**/
+return_status
+spdm_async_get_request_message (
+  IN     void                 *context,
+  IN OUT uintn                *message_size,
+     OUT void                 *message
+  )
+{
+  spdm_context_t        *spdm_context;
+  spdm_async_context_t  *async;
+
+  spdm_context = context;
+  async = &spdm_context->async;
+  if (async->state != SPDM_ASYNC_STATE_SEND) {
+    return RETURN_NOT_READY;
+  }
+  if (*message_size < async->message_size) {
+    *message_size = async->message_size;
+    return RETURN_BUFFER_TOO_SMALL;
+  }
+  copy_mem (message, async->message, async->message_size);
+  *message_size = async->message_size;
+
+  spdm_async_resume (spdm_context);
+  return RETURN_SUCCESS;
+}
+
+/**
+  This function feeds the transport layer response message to the flow in SPDM_ASYNC_STATE_RECEIVE,
+  then runs the flow until the next step.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  message_size                  The size in bytes of the message.
+  @param  message                      A pointer to the message.
+
+  @retval RETURN_SUCCESS               The message is consumed.
+  @retval RETURN_NOT_READY             The flow is not in SPDM_ASYNC_STATE_RECEIVE.
+  @retval RETURN_BUFFER_TOO_SMALL      The message is larger than the receive buffer of the flow.
+**/
+return_status
+spdm_async_feed_response_message (
+  IN     void                 *context,
+  IN     uintn                message_size,
+  IN     void                 *message
+  )
+{
+  spdm_context_t        *spdm_context;
+  spdm_async_context_t  *async;
+
+  spdm_context = context;
+  async = &spdm_context->async;
+  if (async->state != SPDM_ASYNC_STATE_RECEIVE) {
+    return RETURN_NOT_READY;
+  }
+  if (message_size > *async->receive_message_size) {
+    return RETURN_BUFFER_TOO_SMALL;
+  }
+  copy_mem (async->message, message, message_size);
+  *async->receive_message_size = message_size;
+
+  spdm_async_resume (spdm_context);
+  return RETURN_SUCCESS;
+}
+
+/**
+  This function returns the time to wait before the flow in SPDM_ASYNC_STATE_WAIT is polled.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @return the time in microseconds.
+**/
+uint64
+spdm_async_get_wait_time (
+  IN     void                 *context
+  )
+{
+  spdm_context_t        *spdm_context;
+
+  spdm_context = context;
+  if (spdm_context->async.state != SPDM_ASYNC_STATE_WAIT) {
+    return 0;
+  }
+  return spdm_context->async.wait_time;
+}
+
+/**
+  This function polls the flow.
+
+  The flow in SPDM_ASYNC_STATE_WAIT is resumed.
+  If the flow is done, the result is returned, and the SPDM context is back to SPDM_ASYNC_STATE_IDLE.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @retval RETURN_NOT_STARTED           No flow is started.
+  @retval RETURN_NOT_READY             The flow is not done.
+  @retval others                       The flow is done. It is the result of the synchronous function.
+**/
+return_status
+spdm_async_poll (
+  IN     void                 *context
+  )
+{
+  spdm_context_t        *spdm_context;
+  spdm_async_context_t  *async;
+
+  spdm_context = context;
+  async = &spdm_context->async;
+  if (async->state == SPDM_ASYNC_STATE_WAIT) {
+    spdm_async_resume (spdm_context);
+  }
+  switch (async->state) {
+  case SPDM_ASYNC_STATE_IDLE:
+    return RETURN_NOT_STARTED;
+  case SPDM_ASYNC_STATE_DONE:
+    async->state = SPDM_ASYNC_STATE_IDLE;
+    return async->status;
+  default:
+    return RETURN_NOT_READY;
+  }
+}
+
+/**
+  This function cancels the flow, for example, if the device does not respond in time.
+
+  The pending and following device IO of the flow fails with RETURN_DEVICE_ERROR,
+  so that the flow is done at once. The result is got with spdm_async_poll.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_async_cancel (
+  IN     void                 *context
+  )
+{
+  spdm_context_t        *spdm_context;
+  spdm_async_context_t  *async;
+
+  spdm_context = context;
+  async = &spdm_context->async;
+  if (async->fiber == NULL) {
+    return ;
+  }
+  //
+  // Every suspension point of the flow checks the cancel flag before it yields,
+  // so the cancelled flow runs to the end in one resume.
+  //
+  async->cancel = TRUE;
+  spdm_async_resume (spdm_context);
+  ASSERT (async->fiber == NULL);
+}
@@ -36,6 +36,7 @@ typedef struct {
   @param  slot_id                      The number of slot for the challenge.
   @param  measurement_hash_type          The type of the measurement hash.
   @param  measurement_hash              A pointer to a destination buffer to store the measurement hash.
+  @param  spdm_response                 The buffer of the response. It is allocated from the arena by the caller.
 
   @retval RETURN_SUCCESS               The challenge auth is got successfully.
   @retval RETURN_DEVICE_ERROR          A device error occurs when communicates with the device.
@@ -46,13 +47,13 @@ try_spdm_challenge (
   IN     void                 *context,
   IN     uint8                slot_id,
   IN     uint8                measurement_hash_type,
-     OUT void                 *measurement_hash
+     OUT void                 *measurement_hash,
+  IN OUT spdm_challenge_auth_response_max_t  *spdm_response
   )
 {
   return_status                             status;
   boolean                                   result;
   spdm_challenge_request_t                    spdm_request;
-  spdm_challenge_auth_response_max_t          spdm_response;
   uintn                                     spdm_response_size;
   uint8                                     *ptr;
   void                                      *cert_chain_hash;
@@ -109,42 +110,42 @@ try_spdm_challenge (
     return RETURN_SECURITY_VIOLATION;
   }
 
-  spdm_response_size = sizeof(spdm_response);
-  zero_mem (&spdm_response, sizeof(spdm_response));
-  status = spdm_receive_spdm_fragment_encap_response (spdm_context, NULL, &spdm_response_size, &spdm_response);
+  spdm_response_size = sizeof(spdm_challenge_auth_response_max_t);
+  zero_mem (spdm_response, sizeof(spdm_challenge_auth_response_max_t));
+  status = spdm_receive_spdm_fragment_encap_response (spdm_context, NULL, &spdm_response_size, spdm_response);
   if (RETURN_ERROR(status)) {
     return RETURN_DEVICE_ERROR;
   }
   if (spdm_response_size < sizeof(spdm_message_header_t)) {
     return RETURN_DEVICE_ERROR;
   }
-  if (spdm_response.header.request_response_code == SPDM_ERROR) {
-    status = spdm_handle_error_response_main(spdm_context, NULL, &spdm_context->transcript.message_c, sizeof(spdm_request), &spdm_response_size, &spdm_response, SPDM_CHALLENGE, SPDM_CHALLENGE_AUTH, sizeof(spdm_challenge_auth_response_max_t));
+  if (spdm_response->header.request_response_code == SPDM_ERROR) {
+    status = spdm_handle_error_response_main(spdm_context, NULL, &spdm_context->transcript.message_c, sizeof(spdm_request), &spdm_response_size, spdm_response, SPDM_CHALLENGE, SPDM_CHALLENGE_AUTH, sizeof(spdm_challenge_auth_response_max_t));
     if (RETURN_ERROR(status)) {
       return status;
     }
-  } else if (spdm_response.header.request_response_code != SPDM_CHALLENGE_AUTH) {
+  } else if (spdm_response->header.request_response_code != SPDM_CHALLENGE_AUTH) {
     return RETURN_DEVICE_ERROR;
   }
   if (spdm_response_size < sizeof(spdm_challenge_auth_response_t)) {
     return RETURN_DEVICE_ERROR;
   }
-  if (spdm_response_size > sizeof(spdm_response)) {
+  if (spdm_response_size > sizeof(spdm_challenge_auth_response_max_t)) {
     return RETURN_DEVICE_ERROR;
   }
-  *(uint8 *)&auth_attribute = spdm_response.header.param1;
+  *(uint8 *)&auth_attribute = spdm_response->header.param1;
   if (slot_id == 0xFF) {
     if (auth_attribute.slot_id != 0xF) {
       return RETURN_DEVICE_ERROR;
     }
-    if (spdm_response.header.param2 != 0) {
+    if (spdm_response->header.param2 != 0) {
       return RETURN_DEVICE_ERROR;
     }
   } else {
     if (auth_attribute.slot_id != slot_id) {
       return RETURN_DEVICE_ERROR;
     }
-    if (spdm_response.header.param2 != (1 << slot_id)) {
+    if (spdm_response->header.param2 != (1 << slot_id)) {
       return RETURN_DEVICE_ERROR;
     }
   }
@@ -167,7 +168,7 @@ try_spdm_challenge (
     return RETURN_DEVICE_ERROR;
   }
 
-  ptr = spdm_response.cert_chain_hash;
+  ptr = spdm_response->cert_chain_hash;
 
   cert_chain_hash = ptr;
   ptr += hash_size;
@@ -214,7 +215,7 @@ try_spdm_challenge (
                      sizeof(uint16) +
                      opaque_length +
                      signature_size;
-  status = spdm_append_message_c (spdm_context, &spdm_response, spdm_response_size - signature_size);
+  status = spdm_append_message_c (spdm_context, spdm_response, spdm_response_size - signature_size);
   if (RETURN_ERROR(status)) {
     return RETURN_SECURITY_VIOLATION;
   }
@@ -285,16 +286,27 @@ spdm_challenge (
   spdm_context_t    *spdm_context;
   uintn                   retry;
   return_status           status;
+  spdm_challenge_auth_response_max_t  *spdm_response;
 
   spdm_context = context;
+
+  //
+  // The response is too large for the stack of a flow of the asynchronous API.
+  //
+  spdm_response = spdm_arena_allocate (&spdm_context->arena, sizeof(spdm_challenge_auth_response_max_t), NULL);
+  if (spdm_response == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
   retry = spdm_context->retry_times;
   do {
-    status = try_spdm_challenge(spdm_context, slot_id, measurement_hash_type, measurement_hash);
+    status = try_spdm_challenge(spdm_context, slot_id, measurement_hash_type, measurement_hash, spdm_response);
     if (RETURN_NO_RESPONSE != status) {
-      return status;
+      break;
     }
   } while (retry-- != 0);
 
+  spdm_arena_free (&spdm_context->arena, spdm_response);
   return status;
 }
 
@@ -76,8 +76,8 @@ spdm_get_encap_response_certificate (
 
   Offset = spdm_request->Offset;
   length = spdm_request->length;
-  if (length > MAX_SPDM_CERT_CHAIN_BLOCK_LEN) {
-    length = MAX_SPDM_CERT_CHAIN_BLOCK_LEN;
+  if (length > spdm_get_cert_chain_block_len (spdm_context)) {
+    length = spdm_get_cert_chain_block_len (spdm_context);
   }
   
   if (Offset >= local_cert_chain_size) {
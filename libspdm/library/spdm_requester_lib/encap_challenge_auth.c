@@ -114,7 +114,11 @@ spdm_get_encap_response_challenge_auth (
   }
 
   ptr = (void *)(spdm_response + 1);
-  spdm_generate_cert_chain_hash (spdm_context, slot_id, ptr);
+  result = spdm_generate_cert_chain_hash (spdm_context, slot_id, ptr);
+  if (!result) {
+    spdm_generate_encap_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
+    return RETURN_SUCCESS;
+  }
   ptr += hash_size;
 
   spdm_get_random_number (SPDM_NONCE_SIZE, ptr);
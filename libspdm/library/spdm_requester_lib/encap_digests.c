@@ -42,6 +42,7 @@ spdm_get_encap_response_digest (
   uint8                         *digest;
   spdm_context_t           *spdm_context;
   return_status                 status;
+  boolean                       result;
 
   spdm_context = context;
   spdm_request = request;
@@ -89,7 +90,11 @@ spdm_get_encap_response_digest (
   digest = (void *)(spdm_response + 1);
   for (index = 0; index < spdm_context->local_context.slot_count; index++) {
     spdm_response->header.param2 |= (1 << index);
-    spdm_generate_cert_chain_hash (spdm_context, index, &digest[hash_size * index]);
+    result = spdm_generate_cert_chain_hash (spdm_context, index, &digest[hash_size * index]);
+    if (!result) {
+      spdm_generate_encap_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
+      return RETURN_SUCCESS;
+    }
   }
   //
   // Cache
@@ -173,8 +173,8 @@ spdm_encapsulated_request (
   //
   // Cache
   //
-  reset_managed_buffer (&spdm_context->transcript.message_mut_b);
-  reset_managed_buffer (&spdm_context->transcript.message_mut_c);
+  spdm_reset_message_mut_b (spdm_context);
+  spdm_reset_message_mut_c (spdm_context);
 
   if (session_id == NULL) {
     spdm_context->last_spdm_request_session_id_valid = FALSE;
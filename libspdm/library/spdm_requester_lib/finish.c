@@ -30,6 +30,7 @@ typedef struct {
   @param  spdm_context                  A pointer to the SPDM context.
   @param  session_id                    session_id to the FINISH request.
   @param  req_slot_id_param               req_slot_id_param to the FINISH request.
+  @param  spdm_request                  The buffer of the request. It is allocated from the arena by the caller.
 
   @retval RETURN_SUCCESS               The FINISH is sent and the FINISH_RSP is received.
   @retval RETURN_DEVICE_ERROR          A device error occurs when communicates with the device.
@@ -38,11 +39,11 @@ return_status
 try_spdm_send_receive_finish (
   IN     spdm_context_t  *spdm_context,
   IN     uint32               session_id,
-  IN     uint8                req_slot_id_param
+  IN     uint8                req_slot_id_param,
+  IN OUT spdm_finish_request_mine_t  *spdm_request
   )
 {
   return_status                             status;
-  spdm_finish_request_mine_t                  spdm_request;
   uintn                                     spdm_request_size;
   uintn                                     signature_size;
   uintn                                     hmac_size;
@@ -83,17 +84,17 @@ try_spdm_send_receive_finish (
 
   spdm_context->error_state = SPDM_STATUS_ERROR_DEVICE_NO_CAPABILITIES;
    
-  spdm_request.header.spdm_version = SPDM_MESSAGE_VERSION_11;
-  spdm_request.header.request_response_code = SPDM_FINISH;
+  spdm_request->header.spdm_version = SPDM_MESSAGE_VERSION_11;
+  spdm_request->header.request_response_code = SPDM_FINISH;
   if (session_info->mut_auth_requested) {
-    spdm_request.header.param1 = SPDM_FINISH_REQUEST_ATTRIBUTES_SIGNATURE_INCLUDED;
-    spdm_request.header.param2 = req_slot_id_param;
+    spdm_request->header.param1 = SPDM_FINISH_REQUEST_ATTRIBUTES_SIGNATURE_INCLUDED;
+    spdm_request->header.param2 = req_slot_id_param;
     signature_size = spdm_get_req_asym_signature_size (spdm_context->connection_info.algorithm.req_base_asym_alg) +
                      PQC_SIG_SIGNATURE_LENGTH_SIZE +
                      spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo);
   } else {
-    spdm_request.header.param1 = 0;
-    spdm_request.header.param2 = 0;
+    spdm_request->header.param1 = 0;
+    spdm_request->header.param2 = 0;
     signature_size = 0;
   }
   
@@ -108,9 +109,9 @@ try_spdm_send_receive_finish (
 
   hmac_size = spdm_get_hash_size (spdm_context->connection_info.algorithm.bash_hash_algo);
   spdm_request_size = sizeof(spdm_finish_request_t) + signature_size + hmac_size;
-  ptr = spdm_request.signature;
+  ptr = spdm_request->signature;
   
-  status = spdm_append_message_f (session_info, (uint8 *)&spdm_request, sizeof(spdm_finish_request_t));
+  status = spdm_append_message_f (session_info, (uint8 *)spdm_request, sizeof(spdm_finish_request_t));
   if (RETURN_ERROR(status)) {
     return RETURN_SECURITY_VIOLATION;
   }
@@ -136,7 +137,7 @@ try_spdm_send_receive_finish (
     return RETURN_SECURITY_VIOLATION;
   }
 
-  status = spdm_send_spdm_fragment_encap_request (spdm_context, &session_id, spdm_request_size, &spdm_request);
+  status = spdm_send_spdm_fragment_encap_request (spdm_context, &session_id, spdm_request_size, spdm_request);
   if (RETURN_ERROR(status)) {
     return RETURN_DEVICE_ERROR;
   }
@@ -211,15 +212,25 @@ spdm_send_receive_finish (
 {
   uintn                   retry;
   return_status           status;
+  spdm_finish_request_mine_t  *spdm_request;
+
+  //
+  // The request is too large for the stack of a flow of the asynchronous API.
+  //
+  spdm_request = spdm_arena_allocate (&spdm_context->arena, sizeof(spdm_finish_request_mine_t), NULL);
+  if (spdm_request == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
 
   retry = spdm_context->retry_times;
   do {
-    status = try_spdm_send_receive_finish(spdm_context, session_id, req_slot_id_param);
+    status = try_spdm_send_receive_finish(spdm_context, session_id, req_slot_id_param, spdm_request);
     if (RETURN_NO_RESPONSE != status) {
-      return status;
+      break;
     }
   } while (retry-- != 0);
 
+  spdm_arena_free (&spdm_context->arena, spdm_request);
   return status;
 }
 
@@ -36,6 +36,13 @@ typedef struct {
 /**
   Send an SPDM FRAGMENT request to a device.
 
+  The window size set by SPDM_DATA_FRAGMENT_WINDOW_SIZE is proposed in the BEGIN fragment.
+  After the responder accepts it in the ACK, the following fragments are sent one after another,
+  and a cumulative ACK is received once per window, instead of one ACK per fragment.
+
+  Any response other than the expected ACK fails the request. The responder has reset its
+  fragment state if it returns an ERROR, and the next BEGIN fragment resets it otherwise.
+
   @param  spdm_context                  The SPDM context for the device.
   @param  session_id                    Indicate if the request is a secured message.
                                        If session_id is NULL, it is a normal message.
@@ -65,11 +72,17 @@ spdm_send_spdm_fragment_encap_request (
   return_status               status;
   spdm_fragment_request_ack_t my_response;
   uintn                       my_response_size;
+  uint8                       proposed_window_size;
+  uint8                       window_size;
+  uint8                       unacked_count;
 
   ASSERT (request_size <= (uint32)-1);
 
   request_id = 0x7f;
 
+  proposed_window_size = spdm_context->fragment_window_size;
+  window_size = 1;
+  unacked_count = 0;
   sequence_id = 0;
   offset = 0;
   while (offset < request_size) {
@@ -83,6 +96,7 @@ spdm_send_spdm_fragment_encap_request (
     my_request.header.param1 = 0;
     if (offset == 0) {
       my_request.header.param1 |= SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN;
+      my_request.header.param1 |= (uint8)(proposed_window_size << SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_SHIFT);
     }
     if (offset + length == request_size) {
       my_request.header.param1 |= SPDM_FRAGMENT_REQUEST_ATTRIBUTER_END;
@@ -104,27 +118,52 @@ spdm_send_spdm_fragment_encap_request (
       break;
     }
 
-    my_response_size = sizeof(my_response);
-    zero_mem (&my_response, sizeof(my_response));
-    status = spdm_receive_spdm_response (spdm_context, NULL, &my_response_size, &my_response);
-    if (RETURN_ERROR(status)) {
-      return RETURN_DEVICE_ERROR;
-    }
-    if (my_response_size < sizeof(spdm_message_header_t)) {
-      return RETURN_DEVICE_ERROR;
+    //
+    // The BEGIN fragment is always acknowledged. The other fragments are acknowledged
+    // by one ACK of the last fragment in the window.
+    //
+    if ((my_request.header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) == 0) {
+      unacked_count++;
     }
+    if (((my_request.header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) ||
+        (unacked_count == window_size)) {
+      unacked_count = 0;
+
+      my_response_size = sizeof(my_response);
+      zero_mem (&my_response, sizeof(my_response));
+      status = spdm_receive_spdm_response (spdm_context, NULL, &my_response_size, &my_response);
+      if (RETURN_ERROR(status)) {
+        return RETURN_DEVICE_ERROR;
+      }
+      if (my_response_size < sizeof(spdm_message_header_t)) {
+        return RETURN_DEVICE_ERROR;
+      }
 
-    if (my_response.header.request_response_code != SPDM_FRAGMENT_REQUEST_ACK) {
-      return RETURN_SUCCESS;
-    }
-    if (my_response_size != sizeof(spdm_fragment_request_ack_t)) {
-      return RETURN_DEVICE_ERROR;
-    }
-    if (my_response.header.param2 != my_request.header.param2) {
-      return RETURN_DEVICE_ERROR;
-    }
-    if (my_response.sequence_id != my_request.sequence_id) {
-      return RETURN_DEVICE_ERROR;
+      if (my_response.header.request_response_code != SPDM_FRAGMENT_REQUEST_ACK) {
+        return RETURN_DEVICE_ERROR;
+      }
+      if (my_response_size != sizeof(spdm_fragment_request_ack_t)) {
+        return RETURN_DEVICE_ERROR;
+      }
+      if (my_response.header.param2 != my_request.header.param2) {
+        return RETURN_DEVICE_ERROR;
+      }
+      if (my_response.sequence_id != my_request.sequence_id) {
+        return RETURN_DEVICE_ERROR;
+      }
+
+      if ((my_request.header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) {
+        //
+        // The window is used only if both sides enable it. A responder without the window support
+        // returns 0, and param1 is reserved if no window is proposed.
+        //
+        if ((proposed_window_size != 0) && (my_response.header.param1 != 0)) {
+          if (my_response.header.param1 > proposed_window_size) {
+            return RETURN_DEVICE_ERROR;
+          }
+          window_size = my_response.header.param1;
+        }
+      }
     }
 
     sequence_id ++;
@@ -153,6 +153,7 @@ try_spdm_get_capabilities (
   }
   if (spdm_response.header.request_response_code == SPDM_ERROR) {
     shrink_managed_buffer(&spdm_context->transcript.message_a, spdm_request_size);
+    spdm_reset_transcript_hash (spdm_context);
     status = spdm_handle_simple_error_response(spdm_context, spdm_response.header.param1);
     if (RETURN_ERROR(status)) {
       return status;
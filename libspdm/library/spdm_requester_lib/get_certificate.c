@@ -28,13 +28,18 @@ typedef struct {
 
   This function verify the integrity of the certificate chain.
   root_hash -> Root certificate -> Intermediate certificate -> Leaf certificate.
+  Each certificate is verified as soon as it is received, and the transfer is stopped
+  at the first certificate which fails the verification.
 
   If the peer root certificate hash is deployed,
   this function also verifies the digest with the root hash in the certificate chain.
 
+  If the peer certificate chain cache is enabled and GET_DIGESTS returns the digest of a cached certificate chain,
+  the cached certificate chain is returned without GET_CERTIFICATE and the certificate chain verification.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  slot_id                      The number of slot for the certificate chain.
-  @param  length                       length parameter in the get_certificate message (limited by MAX_SPDM_CERT_CHAIN_BLOCK_LEN).
+  @param  length                       length parameter in the get_certificate message (limited by spdm_get_cert_chain_block_len).
   @param  cert_chain_size                On input, indicate the size in bytes of the destination buffer to store the digest buffer.
                                        On output, indicate the size in bytes of the certificate chain.
   @param  cert_chain                    A pointer to a destination buffer to store the certificate chain.
@@ -57,8 +62,10 @@ try_spdm_get_certificate (
   spdm_get_certificate_request_t              spdm_request;
   spdm_certificate_response_max_t             spdm_response;
   uintn                                     spdm_response_size;
-  large_managed_buffer_t                      certificate_chain_buffer;
+  arena_managed_buffer_t                      certificate_chain_buffer;
   spdm_context_t                       *spdm_context;
+  spdm_peer_cert_chain_cache_entry_t          *cache_entry;
+  spdm_cert_chain_verify_context_t            verify_context;
 
   spdm_context = context;
   if (!spdm_is_capabilities_flag_supported(spdm_context, TRUE, 0, SPDM_GET_CAPABILITIES_RESPONSE_FLAGS_CERT_CAP)) {
@@ -70,13 +77,49 @@ try_spdm_get_certificate (
     return RETURN_UNSUPPORTED;
   }
 
-  init_managed_buffer (&certificate_chain_buffer, MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE);
-  length = MIN(length, MAX_SPDM_CERT_CHAIN_BLOCK_LEN);
+  length = (uint16)MIN(length, spdm_get_cert_chain_block_len (spdm_context));
 
   if (slot_id >= MAX_SPDM_SLOT_COUNT) {
     return RETURN_INVALID_PARAMETER;
   }
 
+  //
+  // The certificate chain of the digest returned by GET_DIGESTS is verified before.
+  //
+  cache_entry = spdm_peer_cert_chain_cache_find (spdm_context, slot_id);
+  if (cache_entry != NULL) {
+    DEBUG((DEBUG_INFO, "Certificate (slot 0x%x) is cached\n", slot_id));
+    if (cert_chain_size != NULL) {
+      if (*cert_chain_size < cache_entry->cert_chain_size) {
+        *cert_chain_size = cache_entry->cert_chain_size;
+        return RETURN_BUFFER_TOO_SMALL;
+      }
+      *cert_chain_size = cache_entry->cert_chain_size;
+      if (cert_chain != NULL) {
+        copy_mem (cert_chain, cache_entry->cert_chain, cache_entry->cert_chain_size);
+      }
+    }
+    //
+    // The peer public key context is kept if the certificate chain is not changed.
+    //
+    if ((spdm_context->connection_info.peer_used_cert_chain_buffer_size != cache_entry->cert_chain_size) ||
+        (compare_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, cache_entry->cert_chain, cache_entry->cert_chain_size) != 0)) {
+      if (!spdm_set_peer_used_cert_chain_buffer (spdm_context, cache_entry->cert_chain, cache_entry->cert_chain_size)) {
+        return RETURN_OUT_OF_RESOURCES;
+      }
+    }
+    spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_AFTER_CERTIFICATE;
+    spdm_context->error_state = SPDM_STATUS_SUCCESS;
+    return RETURN_SUCCESS;
+  }
+
+  //
+  // The certificate chain is collected in a buffer allocated from the arena,
+  // and the buffer is released after the certificate chain is verified and copied.
+  //
+  init_arena_managed_buffer (&certificate_chain_buffer, &spdm_context->arena);
+  spdm_cert_chain_verify_init (&verify_context, spdm_context->connection_info.algorithm.bash_hash_algo);
+
   spdm_context->error_state = SPDM_STATUS_ERROR_DEVICE_NO_CAPABILITIES;
 
   do {
@@ -169,9 +212,21 @@ try_spdm_get_certificate (
     }
     spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_AFTER_CERTIFICATE;
 
+    //
+    // Verify the certificates received so far, and stop the transfer at the first bad certificate.
+    //
+    if (spdm_response.remainder_length != 0) {
+      result = spdm_verify_peer_cert_chain_buffer_update (spdm_context, &verify_context, get_managed_buffer(&certificate_chain_buffer), get_managed_buffer_size(&certificate_chain_buffer));
+      if (!result) {
+        spdm_context->error_state = SPDM_STATUS_ERROR_CERTIFICATE_FAILURE;
+        status = RETURN_SECURITY_VIOLATION;
+        goto done;
+      }
+    }
+
   } while (spdm_response.remainder_length != 0);
 perf_start (PERF_ID_CERT_VERIFICATION);
-  result = spdm_verify_peer_cert_chain_buffer (spdm_context, get_managed_buffer(&certificate_chain_buffer), get_managed_buffer_size(&certificate_chain_buffer));
+  result = spdm_verify_peer_cert_chain_buffer_final (spdm_context, &verify_context, get_managed_buffer(&certificate_chain_buffer), get_managed_buffer_size(&certificate_chain_buffer));
 perf_stop (PERF_ID_CERT_VERIFICATION);
   if (!result) {
     spdm_context->error_state = SPDM_STATUS_ERROR_CERTIFICATE_FAILURE;
@@ -179,15 +234,20 @@ perf_stop (PERF_ID_CERT_VERIFICATION);
     goto done;
   }
   
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = get_managed_buffer_size(&certificate_chain_buffer);
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, get_managed_buffer(&certificate_chain_buffer), get_managed_buffer_size(&certificate_chain_buffer));
+  if (!spdm_set_peer_used_cert_chain_buffer (spdm_context, get_managed_buffer(&certificate_chain_buffer), get_managed_buffer_size(&certificate_chain_buffer))) {
+    spdm_context->error_state = SPDM_STATUS_ERROR_DEVICE_ERROR;
+    status = RETURN_OUT_OF_RESOURCES;
+    goto done;
+  }
+  spdm_peer_cert_chain_cache_add (spdm_context, get_managed_buffer(&certificate_chain_buffer), get_managed_buffer_size(&certificate_chain_buffer));
 
   spdm_context->error_state = SPDM_STATUS_SUCCESS;
 
   if (cert_chain_size != NULL) {
     if (*cert_chain_size < get_managed_buffer_size(&certificate_chain_buffer)) {
       *cert_chain_size = get_managed_buffer_size(&certificate_chain_buffer);
-      return RETURN_BUFFER_TOO_SMALL;
+      status = RETURN_BUFFER_TOO_SMALL;
+      goto done;
     }
     *cert_chain_size = get_managed_buffer_size(&certificate_chain_buffer);
     if (cert_chain != NULL) {
@@ -201,6 +261,7 @@ perf_stop (PERF_ID_CERT_VERIFICATION);
 
   status = RETURN_SUCCESS;
 done:
+  reset_managed_buffer (&certificate_chain_buffer);
   return status;
 }
 
@@ -232,7 +293,7 @@ spdm_get_certificate (
      OUT void                 *cert_chain
   )
 {
-  return spdm_get_certificate_choose_length(context, slot_id, MAX_SPDM_CERT_CHAIN_BLOCK_LEN, cert_chain_size, cert_chain);
+  return spdm_get_certificate_choose_length(context, slot_id, (uint16)spdm_get_cert_chain_block_len (context), cert_chain_size, cert_chain);
 }
 
 /**
@@ -247,7 +308,7 @@ spdm_get_certificate (
 
   @param  spdm_context                  A pointer to the SPDM context.
   @param  slot_id                      The number of slot for the certificate chain.
-  @param  length                       length parameter in the get_certificate message (limited by MAX_SPDM_CERT_CHAIN_BLOCK_LEN).
+  @param  length                       length parameter in the get_certificate message (limited by spdm_get_cert_chain_block_len).
   @param  cert_chain_size                On input, indicate the size in bytes of the destination buffer to store the digest buffer.
                                        On output, indicate the size in bytes of the certificate chain.
   @param  cert_chain                    A pointer to a destination buffer to store the certificate chain.
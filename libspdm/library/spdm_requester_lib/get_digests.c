@@ -150,6 +150,8 @@ try_spdm_get_digest (
   if (total_digest_buffer != NULL) {
     copy_mem (total_digest_buffer, spdm_response.digest, digest_size * digest_count);
   }
+  spdm_context->connection_info.peer_digest_slot_mask = spdm_response.header.param2;
+  copy_mem (spdm_context->connection_info.peer_digest, spdm_response.digest, digest_size * digest_count);
 
   spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_AFTER_DIGESTS;
   return RETURN_SUCCESS;
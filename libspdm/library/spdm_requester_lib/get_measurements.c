@@ -39,6 +39,7 @@ typedef struct {
   @param  measurement_record_length      On input, indicate the size in bytes of the destination buffer to store the measurement record.
                                        On output, indicate the size in bytes of the measurement record.
   @param  measurement_record            A pointer to a destination buffer to store the measurement record.
+  @param  spdm_response                 The buffer of the response. It is allocated from the arena by the caller.
 
   @retval RETURN_SUCCESS               The measurement is got successfully.
   @retval RETURN_DEVICE_ERROR          A device error occurs when communicates with the device.
@@ -53,14 +54,14 @@ try_spdm_get_measurement (
   IN     uint8                slot_id_param,
      OUT uint8                *number_of_blocks,
   IN OUT uint32               *measurement_record_length,
-     OUT void                 *measurement_record
+     OUT void                 *measurement_record,
+  IN OUT spdm_measurements_response_max_t  *spdm_response
   )
 {
   boolean                                   result;
   return_status                             status;
   spdm_get_measurements_request_t             spdm_request;
   uintn                                     spdm_request_size;
-  spdm_measurements_response_max_t            spdm_response;
   uintn                                     spdm_response_size;
   uint32                                    measurement_record_data_length;
   uint8                                     *measurement_record_data;
@@ -158,74 +159,74 @@ try_spdm_get_measurement (
     return RETURN_SECURITY_VIOLATION;
   }
 
-  spdm_response_size = sizeof(spdm_response);
-  zero_mem (&spdm_response, sizeof(spdm_response));
-  status = spdm_receive_spdm_fragment_encap_response (spdm_context, session_id, &spdm_response_size, &spdm_response);
+  spdm_response_size = sizeof(spdm_measurements_response_max_t);
+  zero_mem (spdm_response, sizeof(spdm_measurements_response_max_t));
+  status = spdm_receive_spdm_fragment_encap_response (spdm_context, session_id, &spdm_response_size, spdm_response);
   if (RETURN_ERROR(status)) {
     return RETURN_DEVICE_ERROR;
   }
   if (spdm_response_size < sizeof(spdm_message_header_t)) {
     return RETURN_DEVICE_ERROR;
   }
-  if (spdm_response.header.request_response_code == SPDM_ERROR) {
-    status = spdm_handle_error_response_main(spdm_context, session_id, &spdm_context->transcript.message_m, spdm_request_size, &spdm_response_size, &spdm_response, SPDM_GET_MEASUREMENTS, SPDM_MEASUREMENTS, sizeof(spdm_measurements_response_max_t));
+  if (spdm_response->header.request_response_code == SPDM_ERROR) {
+    status = spdm_handle_error_response_main(spdm_context, session_id, &spdm_context->transcript.message_m, spdm_request_size, &spdm_response_size, spdm_response, SPDM_GET_MEASUREMENTS, SPDM_MEASUREMENTS, sizeof(spdm_measurements_response_max_t));
     if (RETURN_ERROR(status)) {
       return status;
     }
-  } else if (spdm_response.header.request_response_code != SPDM_MEASUREMENTS) {
-    reset_managed_buffer (&spdm_context->transcript.message_m);
+  } else if (spdm_response->header.request_response_code != SPDM_MEASUREMENTS) {
+    spdm_reset_message_m (spdm_context);
     return RETURN_DEVICE_ERROR;
   }
   if (spdm_response_size < sizeof(spdm_measurements_response_t)) {
     return RETURN_DEVICE_ERROR;
   }
-  if (spdm_response_size > sizeof(spdm_response)) {
+  if (spdm_response_size > sizeof(spdm_measurements_response_max_t)) {
     return RETURN_DEVICE_ERROR;
   }
 
   if (measurement_operation == SPDM_GET_MEASUREMENTS_REQUEST_MEASUREMENT_OPERATION_TOTAL_NUMBER_OF_MEASUREMENTS) {
-    if (spdm_response.number_of_blocks != 0) {
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+    if (spdm_response->number_of_blocks != 0) {
+      spdm_reset_message_m (spdm_context);
       return RETURN_DEVICE_ERROR;
     }
   } else if (measurement_operation == SPDM_GET_MEASUREMENTS_REQUEST_MEASUREMENT_OPERATION_ALL_MEASUREMENTS) {
-    if (spdm_response.number_of_blocks == 0) {
+    if (spdm_response->number_of_blocks == 0) {
       return RETURN_DEVICE_ERROR;
     }
   } else {
-    if (spdm_response.number_of_blocks != 1) {
+    if (spdm_response->number_of_blocks != 1) {
       return RETURN_DEVICE_ERROR;
     }
   }
 
-  measurement_record_data_length = spdm_read_uint24 (spdm_response.measurement_record_length);
+  measurement_record_data_length = spdm_read_uint24 (spdm_response->measurement_record_length);
   if (measurement_operation == SPDM_GET_MEASUREMENTS_REQUEST_MEASUREMENT_OPERATION_TOTAL_NUMBER_OF_MEASUREMENTS) {
     if (measurement_record_data_length != 0) {
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+      spdm_reset_message_m (spdm_context);
       return RETURN_DEVICE_ERROR;
     }
   } else {
     if (spdm_response_size < sizeof(spdm_measurements_response_t) + measurement_record_data_length) {
       return RETURN_DEVICE_ERROR;
     }
-    if (measurement_record_data_length >= sizeof(spdm_response.measurement_record)) {
+    if (measurement_record_data_length >= sizeof(spdm_response->measurement_record)) {
       return RETURN_DEVICE_ERROR;
     }
     DEBUG((DEBUG_INFO, "measurement_record_length - 0x%06x\n", measurement_record_data_length));
   }
 
-  measurement_record_data = spdm_response.measurement_record;
+  measurement_record_data = spdm_response->measurement_record;
 
   if (request_attribute == SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE) {
     if (spdm_response_size < sizeof(spdm_measurements_response_t) +
                            measurement_record_data_length +
                            SPDM_NONCE_SIZE +
                            sizeof(uint16)) {
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+      spdm_reset_message_m (spdm_context);
       return RETURN_DEVICE_ERROR;
     }
-    if (spdm_is_version_supported (spdm_context, SPDM_MESSAGE_VERSION_11) && spdm_response.header.param2 != slot_id_param) {
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+    if (spdm_is_version_supported (spdm_context, SPDM_MESSAGE_VERSION_11) && spdm_response->header.param2 != slot_id_param) {
+      spdm_reset_message_m (spdm_context);
       return RETURN_SECURITY_VIOLATION;
     }
     ptr = measurement_record_data + measurement_record_data_length;
@@ -255,9 +256,9 @@ try_spdm_get_measurement (
                        sizeof(uint16) +
                        opaque_length +
                        signature_size;
-    status = spdm_append_message_m (spdm_context, &spdm_response, spdm_response_size - signature_size);
+    status = spdm_append_message_m (spdm_context, spdm_response, spdm_response_size - signature_size);
     if (RETURN_ERROR(status)) {
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+      spdm_reset_message_m (spdm_context);
       return RETURN_SECURITY_VIOLATION;
     }
 
@@ -273,11 +274,11 @@ try_spdm_get_measurement (
     result = spdm_verify_measurement_signature (spdm_context, signature, signature_size);
     if (!result) {
       spdm_context->error_state = SPDM_STATUS_ERROR_MEASUREMENT_AUTH_FAILURE;
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+      spdm_reset_message_m (spdm_context);
       return RETURN_SECURITY_VIOLATION;
     }
 
-    reset_managed_buffer (&spdm_context->transcript.message_m);
+    spdm_reset_message_m (spdm_context);
   } else {
     //
     // nonce is absent if there is not signature
@@ -305,15 +306,15 @@ try_spdm_get_measurement (
                        measurement_record_data_length +
                        sizeof(uint16) +
                        opaque_length;
-    status = spdm_append_message_m (spdm_context, &spdm_response, spdm_response_size);
+    status = spdm_append_message_m (spdm_context, spdm_response, spdm_response_size);
     if (RETURN_ERROR(status)) {
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+      spdm_reset_message_m (spdm_context);
       return RETURN_SECURITY_VIOLATION;
     }
   }
 
   if (measurement_operation == SPDM_GET_MEASUREMENTS_REQUEST_MEASUREMENT_OPERATION_TOTAL_NUMBER_OF_MEASUREMENTS) {
-    *number_of_blocks = spdm_response.header.param1;
+    *number_of_blocks = spdm_response->header.param1;
     if (*number_of_blocks == 0xFF) {
       // the number of block cannot be 0xFF, because index 0xFF will brings confusing.
       return RETURN_DEVICE_ERROR;
@@ -323,7 +324,7 @@ try_spdm_get_measurement (
       return RETURN_DEVICE_ERROR;
     }
   } else {
-    *number_of_blocks = spdm_response.number_of_blocks;
+    *number_of_blocks = spdm_response->number_of_blocks;
     if (*measurement_record_length < measurement_record_data_length) {
       return RETURN_BUFFER_TOO_SMALL;
     }
@@ -377,16 +378,27 @@ spdm_get_measurement (
   spdm_context_t    *spdm_context;
   uintn                   retry;
   return_status           status;
+  spdm_measurements_response_max_t  *spdm_response;
 
   spdm_context = context;
+
+  //
+  // The response is too large for the stack of a flow of the asynchronous API.
+  //
+  spdm_response = spdm_arena_allocate (&spdm_context->arena, sizeof(spdm_measurements_response_max_t), NULL);
+  if (spdm_response == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
   retry = spdm_context->retry_times;
   do {
-    status = try_spdm_get_measurement(spdm_context, session_id, request_attribute, measurement_operation, slot_id_param, number_of_blocks, measurement_record_length, measurement_record);
+    status = try_spdm_get_measurement(spdm_context, session_id, request_attribute, measurement_operation, slot_id_param, number_of_blocks, measurement_record_length, measurement_record, spdm_response);
     if (RETURN_NO_RESPONSE != status) {
-      return status;
+      break;
     }
   } while (retry-- != 0);
 
+  spdm_arena_free (&spdm_context->arena, spdm_response);
   return status;
 }
 
@@ -54,9 +54,9 @@ try_spdm_get_version (
   //
   // Cache data
   //
-  reset_managed_buffer (&spdm_context->transcript.message_a);
-  reset_managed_buffer (&spdm_context->transcript.message_b);
-  reset_managed_buffer (&spdm_context->transcript.message_c);
+  spdm_reset_message_a (spdm_context);
+  spdm_reset_message_b (spdm_context);
+  spdm_reset_message_c (spdm_context);
   status = spdm_append_message_a (spdm_context, &spdm_request, sizeof(spdm_request));
   if (RETURN_ERROR(status)) {
     return RETURN_SECURITY_VIOLATION;
@@ -76,6 +76,7 @@ try_spdm_get_version (
   }
   if (spdm_response.header.request_response_code == SPDM_ERROR) {
     shrink_managed_buffer(&spdm_context->transcript.message_a, sizeof(spdm_request));
+    spdm_reset_transcript_hash (spdm_context);
     status = spdm_handle_simple_error_response(spdm_context, spdm_response.header.param1);
     if (RETURN_ERROR(status)) {
       return status;
@@ -12,6 +12,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 /**
   This function sends RESPOND_IF_READY and receives an expected SPDM response.
 
+  The requester waits 2^RDTExponent microseconds before RESPOND_IF_READY is sent,
+  and it sends RESPOND_IF_READY again if the responder returns ResponseNotReady again.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  response_size                 The size of the response.
                                        On input, it means the size in bytes of response data buffer.
@@ -36,31 +39,75 @@ spdm_requester_respond_if_ready (
   return_status                             status;
   spdm_response_if_ready_request_t             spdm_request;
   spdm_message_header_t                       *spdm_response;
+  spdm_error_data_response_not_ready_t        *extend_error_data;
+  boolean                                     is_fragment_response;
+  uintn                                       retry;
 
   spdm_response = response;
 
-  if (spdm_is_version_supported (spdm_context, SPDM_MESSAGE_VERSION_11)) {
-    spdm_request.header.spdm_version = SPDM_MESSAGE_VERSION_11;
-  } else {
-    spdm_request.header.spdm_version = SPDM_MESSAGE_VERSION_10;
-  }
-  spdm_request.header.request_response_code = SPDM_RESPOND_IF_READY;
-  spdm_request.header.param1 = spdm_context->error_data.request_code;
-  spdm_request.header.param2 = spdm_context->error_data.token;
-  status = spdm_send_spdm_request (spdm_context, session_id, sizeof(spdm_request), &spdm_request);
-  if (RETURN_ERROR(status)) {
-    return RETURN_DEVICE_ERROR;
+  //
+  // The responder sends these responses in FRAGMENT_RESPONSE.
+  //
+  switch (spdm_context->error_data.request_code) {
+  case SPDM_CHALLENGE:
+  case SPDM_GET_MEASUREMENTS:
+  case SPDM_KEY_EXCHANGE:
+    is_fragment_response = TRUE;
+    break;
+  default:
+    is_fragment_response = FALSE;
+    break;
   }
 
-  *response_size = expected_response_size;
-  zero_mem (response, expected_response_size);
-  status = spdm_receive_spdm_response (spdm_context, session_id, response_size, response);
-  if (RETURN_ERROR(status)) {
-    return RETURN_DEVICE_ERROR;
-  }
-  if (*response_size < sizeof(spdm_message_header_t)) {
-    return RETURN_DEVICE_ERROR;
+  for (retry = 0; ; retry++) {
+    spdm_requester_wait (spdm_context, (uint64)1 << MIN (spdm_context->error_data.rd_exponent, SPDM_DEFERRED_RESPONSE_MAX_RD_EXPONENT));
+
+    if (spdm_is_version_supported (spdm_context, SPDM_MESSAGE_VERSION_11)) {
+      spdm_request.header.spdm_version = SPDM_MESSAGE_VERSION_11;
+    } else {
+      spdm_request.header.spdm_version = SPDM_MESSAGE_VERSION_10;
+    }
+    spdm_request.header.request_response_code = SPDM_RESPOND_IF_READY;
+    spdm_request.header.param1 = spdm_context->error_data.request_code;
+    spdm_request.header.param2 = spdm_context->error_data.token;
+    status = spdm_send_spdm_request (spdm_context, session_id, sizeof(spdm_request), &spdm_request);
+    if (RETURN_ERROR(status)) {
+      return RETURN_DEVICE_ERROR;
+    }
+
+    *response_size = expected_response_size;
+    zero_mem (response, expected_response_size);
+    if (is_fragment_response) {
+      status = spdm_receive_spdm_fragment_encap_response (spdm_context, session_id, response_size, response);
+    } else {
+      status = spdm_receive_spdm_response (spdm_context, session_id, response_size, response);
+    }
+    if (RETURN_ERROR(status)) {
+      return RETURN_DEVICE_ERROR;
+    }
+    if (*response_size < sizeof(spdm_message_header_t)) {
+      return RETURN_DEVICE_ERROR;
+    }
+
+    //
+    // The request is still processed by the responder.
+    //
+    if ((spdm_response->request_response_code == SPDM_ERROR) &&
+        (spdm_response->param1 == SPDM_ERROR_CODE_RESPONSE_NOT_READY) &&
+        (*response_size == sizeof(spdm_error_response_t) + sizeof(spdm_error_data_response_not_ready_t)) &&
+        (retry < MAX_SPDM_RESPOND_IF_READY_RETRY_TIMES)) {
+      extend_error_data = (spdm_error_data_response_not_ready_t *)((spdm_error_response_t *)response + 1);
+      if (extend_error_data->request_code != spdm_context->error_data.request_code) {
+        return RETURN_DEVICE_ERROR;
+      }
+      spdm_context->error_data.rd_exponent = extend_error_data->rd_exponent;
+      spdm_context->error_data.token       = extend_error_data->token;
+      spdm_context->error_data.rd_tm        = extend_error_data->rd_tm;
+      continue;
+    }
+    break;
   }
+
   if (spdm_response->request_response_code != expected_response_code) {
     return RETURN_DEVICE_ERROR;
   }
@@ -197,6 +244,7 @@ spdm_handle_error_response_main (
   ASSERT(spdm_response->request_response_code == SPDM_ERROR);
   if (spdm_response->param1 != SPDM_ERROR_CODE_RESPONSE_NOT_READY) {
     shrink_managed_buffer(m_buffer, shrink_buffer_size);
+    spdm_reset_transcript_hash (spdm_context);
     return spdm_handle_simple_error_response(spdm_context, spdm_response->param1);
   } else {
     return spdm_handle_response_not_ready(spdm_context, session_id, response_size, response, original_request_code, expected_response_code, expected_response_size);
@@ -47,6 +47,7 @@ typedef struct {
   @param  session_id                    session_id from the KEY_EXCHANGE_RSP response.
   @param  req_slot_id_param               req_slot_id_param from the KEY_EXCHANGE_RSP response.
   @param  measurement_hash              measurement_hash from the KEY_EXCHANGE_RSP response.
+  @param  spdm_response                 The buffer of the response. It is allocated from the arena by the caller.
 
   @retval RETURN_SUCCESS               The KEY_EXCHANGE is sent and the KEY_EXCHANGE_RSP is received.
   @retval RETURN_DEVICE_ERROR          A device error occurs when communicates with the device.
@@ -59,14 +60,14 @@ try_spdm_send_receive_key_exchange (
      OUT uint32               *session_id,
      OUT uint8                *heartbeat_period,
      OUT uint8                *req_slot_id_param,
-     OUT void                 *measurement_hash
+     OUT void                 *measurement_hash,
+  IN OUT spdm_key_exchange_response_max_t  *spdm_response
   )
 {
   boolean                                   result;
   return_status                             status;
   spdm_key_exchange_request_mine_t            spdm_request;
   uintn                                     spdm_request_size;
-  spdm_key_exchange_response_max_t            spdm_response;
   uintn                                     spdm_response_size;
   uintn                                     dhe_key_size;
   uint32                                    measurement_summary_hash_size;
@@ -86,8 +87,9 @@ try_spdm_send_receive_key_exchange (
   void                                      *pqc_kem_context;
   uintn                                     pqc_kem_public_key_size;
   uintn                                     pqc_kem_cipher_text_size;
-  boolean                                   result2;
   boolean                                   need_pqc_kem;
+  spdm_ephemeral_key_t                      ephemeral_key;
+  boolean                                   key_from_pool;
 
   if (!spdm_is_capabilities_flag_supported(spdm_context, TRUE, SPDM_GET_CAPABILITIES_REQUEST_FLAGS_KEY_EX_CAP, SPDM_GET_CAPABILITIES_RESPONSE_FLAGS_KEY_EX_CAP)) {
     return RETURN_UNSUPPORTED;
@@ -121,8 +123,18 @@ try_spdm_send_receive_key_exchange (
 perf_start (PERF_ID_KEY_EX_KEM_GEN);
   ptr = spdm_request.exchange_data;
   dhe_key_size = spdm_get_dhe_pub_key_size (spdm_context->connection_info.algorithm.dhe_named_group);
-  dhe_context = spdm_secured_message_dhe_new (spdm_context->connection_info.algorithm.dhe_named_group);
-  spdm_secured_message_dhe_generate_key (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context, ptr, &dhe_key_size);
+  //
+  // Use the pre-generated key if it is ready. The key is removed from the pool.
+  //
+  key_from_pool = spdm_key_pool_acquire (spdm_context, &ephemeral_key);
+  if (key_from_pool) {
+    dhe_context = ephemeral_key.dhe_context;
+    ASSERT (ephemeral_key.dhe_public_key_size == dhe_key_size);
+    copy_mem (ptr, ephemeral_key.dhe_public_key, dhe_key_size);
+  } else {
+    dhe_context = spdm_secured_message_dhe_new (spdm_context->connection_info.algorithm.dhe_named_group);
+    spdm_secured_message_dhe_generate_key (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context, ptr, &dhe_key_size);
+  }
   DEBUG((DEBUG_INFO, "ClientKey (0x%x):\n", dhe_key_size));
   internal_dump_hex (ptr, dhe_key_size);
   ptr += dhe_key_size;
@@ -130,8 +142,12 @@ perf_start (PERF_ID_KEY_EX_KEM_GEN);
   pqc_kem_public_key_size = spdm_get_pqc_kem_public_key_size (spdm_context->connection_info.algorithm.pqc_kem_algo);
   need_pqc_kem = !spdm_pqc_algo_is_zero (spdm_context->connection_info.algorithm.pqc_kem_algo);
   if (need_pqc_kem) {
-    pqc_kem_context = spdm_secured_message_pqc_kem_new (spdm_context->connection_info.algorithm.pqc_kem_algo);
-    spdm_secured_message_pqc_kem_generate_key (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
+    if (key_from_pool) {
+      pqc_kem_context = ephemeral_key.pqc_kem_context;
+    } else {
+      pqc_kem_context = spdm_secured_message_pqc_kem_new (spdm_context->connection_info.algorithm.pqc_kem_algo);
+      spdm_secured_message_pqc_kem_generate_key (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
+    }
     spdm_secured_message_pqc_kem_get_public_key (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context, ptr, &pqc_kem_public_key_size);
     DEBUG((DEBUG_INFO, "ClientKey PQC (0x%x):\n", pqc_kem_public_key_size));
     internal_dump_hex (ptr, pqc_kem_public_key_size);
@@ -154,9 +170,9 @@ perf_stop (PERF_ID_KEY_EX_KEM_GEN);
     return RETURN_DEVICE_ERROR;
   }
 
-  spdm_response_size = sizeof(spdm_response);
-  zero_mem (&spdm_response, sizeof(spdm_response));
-  status = spdm_receive_spdm_fragment_encap_response (spdm_context, NULL, &spdm_response_size, &spdm_response);
+  spdm_response_size = sizeof(spdm_key_exchange_response_max_t);
+  zero_mem (spdm_response, sizeof(spdm_key_exchange_response_max_t));
+  status = spdm_receive_spdm_fragment_encap_response (spdm_context, NULL, &spdm_response_size, spdm_response);
   if (RETURN_ERROR(status)) {
     spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context);
     spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
@@ -167,14 +183,14 @@ perf_stop (PERF_ID_KEY_EX_KEM_GEN);
     spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
     return RETURN_DEVICE_ERROR;
   }
-  if (spdm_response.header.request_response_code == SPDM_ERROR) {
-    status = spdm_handle_error_response_main(spdm_context, NULL, NULL, 0, &spdm_response_size, &spdm_response, SPDM_KEY_EXCHANGE, SPDM_KEY_EXCHANGE_RSP, sizeof(spdm_key_exchange_response_max_t));
+  if (spdm_response->header.request_response_code == SPDM_ERROR) {
+    status = spdm_handle_error_response_main(spdm_context, NULL, NULL, 0, &spdm_response_size, spdm_response, SPDM_KEY_EXCHANGE, SPDM_KEY_EXCHANGE_RSP, sizeof(spdm_key_exchange_response_max_t));
     if (RETURN_ERROR(status)) {
       spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context);
       spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
       return status;
     }
-  } else if (spdm_response.header.request_response_code != SPDM_KEY_EXCHANGE_RSP) {
+  } else if (spdm_response->header.request_response_code != SPDM_KEY_EXCHANGE_RSP) {
     spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context);
     spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
     return RETURN_DEVICE_ERROR;
@@ -184,17 +200,17 @@ perf_stop (PERF_ID_KEY_EX_KEM_GEN);
     spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
     return RETURN_DEVICE_ERROR;
   }
-  if (spdm_response_size > sizeof(spdm_response)) {
+  if (spdm_response_size > sizeof(spdm_key_exchange_response_max_t)) {
     spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context);
     spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
     return RETURN_DEVICE_ERROR;
   }
 
   if (heartbeat_period != NULL) {
-    *heartbeat_period = spdm_response.header.param1;
+    *heartbeat_period = spdm_response->header.param1;
   }
-  *req_slot_id_param = spdm_response.req_slot_id_param;
-  if (spdm_response.mut_auth_requested != 0) {
+  *req_slot_id_param = spdm_response->req_slot_id_param;
+  if (spdm_response->mut_auth_requested != 0) {
     if ((*req_slot_id_param != 0xF) && (*req_slot_id_param >= spdm_context->local_context.slot_count)) {
       spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context);
       spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
@@ -207,7 +223,7 @@ perf_stop (PERF_ID_KEY_EX_KEM_GEN);
       return RETURN_DEVICE_ERROR;
     }
   }
-  rsp_session_id = spdm_response.rsp_session_id;
+  rsp_session_id = spdm_response->rsp_session_id;
   *session_id = (req_session_id << 16) | rsp_session_id;
   session_info = spdm_assign_session_id (spdm_context, *session_id, FALSE);
   if (session_info == NULL) {
@@ -252,13 +268,13 @@ perf_stop (PERF_ID_KEY_EX_KEM_GEN);
   }
 
   DEBUG((DEBUG_INFO, "ServerRandomData (0x%x) - ", SPDM_RANDOM_DATA_SIZE));
-  internal_dump_data (spdm_response.random_data, SPDM_RANDOM_DATA_SIZE);
+  internal_dump_data (spdm_response->random_data, SPDM_RANDOM_DATA_SIZE);
   DEBUG((DEBUG_INFO, "\n"));
 
   DEBUG((DEBUG_INFO, "ServerKey (0x%x):\n", dhe_key_size));
-  internal_dump_hex (spdm_response.exchange_data, dhe_key_size);
+  internal_dump_hex (spdm_response->exchange_data, dhe_key_size);
 
-  ptr = spdm_response.exchange_data;
+  ptr = spdm_response->exchange_data;
   ptr += dhe_key_size;
 
   DEBUG((DEBUG_INFO, "ServerKey PQC (0x%x):\n", pqc_kem_cipher_text_size));
@@ -310,7 +326,7 @@ perf_stop (PERF_ID_KEY_EX_KEM_GEN);
                      signature_size +
                      hmac_size;
 
-  status = spdm_append_message_k (session_info, &spdm_response, spdm_response_size - signature_size - hmac_size);
+  status = spdm_append_message_k (session_info, spdm_response, spdm_response_size - signature_size - hmac_size);
   if (RETURN_ERROR(status)) {
     spdm_free_session_id (spdm_context, *session_id);
     spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context);
@@ -345,15 +361,18 @@ perf_stop (PERF_ID_KEY_EX_SIG_VER);
   // Fill data to calc Secret for HMAC verification
   //
 perf_start (PERF_ID_KEY_EX_KEM_DECAP);
-  result = spdm_secured_message_dhe_compute_key (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context, spdm_response.exchange_data, dhe_key_size, session_info->secured_message_context);
+  //
+  // The ECDHE shared secret and the PQC KEM decapsulation are computed in parallel if the worker pool is enabled.
+  //
+  result = spdm_compute_key_exchange_shared_secret (spdm_context, TRUE, session_info->secured_message_context,
+                                                    dhe_context, spdm_response->exchange_data, dhe_key_size,
+                                                    need_pqc_kem ? pqc_kem_context : NULL, &spdm_response->exchange_data[dhe_key_size], pqc_kem_cipher_text_size,
+                                                    NULL, NULL);
   spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context);
   if (need_pqc_kem) {
-    result2 = spdm_secured_message_pqc_kem_decap (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context, &spdm_response.exchange_data[dhe_key_size], pqc_kem_cipher_text_size, session_info->secured_message_context);
     spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
-  } else {
-    result2 = TRUE;
   }
-  if (!result && !result2) {
+  if (!result) {
     spdm_free_session_id (spdm_context, *session_id);
     return RETURN_SECURITY_VIOLATION;
   }
@@ -393,7 +412,7 @@ perf_stop (PERF_ID_KEY_EX_KEM_DECAP);
   if (measurement_hash != NULL) {
     copy_mem (measurement_hash, measurement_summary_hash, measurement_summary_hash_size);
   }
-  session_info->mut_auth_requested = spdm_response.mut_auth_requested;
+  session_info->mut_auth_requested = spdm_response->mut_auth_requested;
 
   spdm_secured_message_set_session_state (session_info->secured_message_context, SPDM_SESSION_STATE_HANDSHAKING);
   spdm_context->error_state = SPDM_STATUS_SUCCESS;
@@ -414,15 +433,25 @@ spdm_send_receive_key_exchange (
 {
   uintn                   retry;
   return_status           status;
+  spdm_key_exchange_response_max_t  *spdm_response;
+
+  //
+  // The response is too large for the stack of a flow of the asynchronous API.
+  //
+  spdm_response = spdm_arena_allocate (&spdm_context->arena, sizeof(spdm_key_exchange_response_max_t), NULL);
+  if (spdm_response == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
 
   retry = spdm_context->retry_times;
   do {
-    status = try_spdm_send_receive_key_exchange(spdm_context, measurement_hash_type, slot_id, session_id, heartbeat_period, req_slot_id_param, measurement_hash);
+    status = try_spdm_send_receive_key_exchange(spdm_context, measurement_hash_type, slot_id, session_id, heartbeat_period, req_slot_id_param, measurement_hash, spdm_response);
     if (RETURN_NO_RESPONSE != status) {
-      return status;
+      break;
     }
   } while (retry-- != 0);
 
+  spdm_arena_free (&spdm_context->arena, spdm_response);
   return status;
 }
 
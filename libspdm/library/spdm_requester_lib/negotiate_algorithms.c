@@ -133,6 +133,7 @@ try_spdm_negotiate_algorithms (
   }
   if (spdm_response.header.request_response_code == SPDM_ERROR) {
     shrink_managed_buffer(&spdm_context->transcript.message_a, spdm_request.length);
+    spdm_reset_transcript_hash (spdm_context);
     status = spdm_handle_simple_error_response(spdm_context, spdm_response.header.param1);
     if (RETURN_ERROR(status)) {
       return status;
@@ -350,6 +351,13 @@ try_spdm_negotiate_algorithms (
   ASSERT (spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo) <= MAX_PQC_SIG_SIGNATURE_SIZE);
 
   spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_NEGOTIATED;
+
+  //
+  // Generate the ephemeral keys for KEY_EXCHANGE in background.
+  //
+  if (spdm_is_capabilities_flag_supported(spdm_context, TRUE, SPDM_GET_CAPABILITIES_REQUEST_FLAGS_KEY_EX_CAP, SPDM_GET_CAPABILITIES_RESPONSE_FLAGS_KEY_EX_CAP)) {
+    spdm_key_pool_start (spdm_context);
+  }
   return RETURN_SUCCESS;
 }
 
@@ -425,4 +425,20 @@ spdm_receive_spdm_fragment_encap_response (
      OUT void                 *response
   );
 
+/**
+  This function waits before the requester retries a request.
+
+  If it is called in a flow of the asynchronous API, the flow is suspended in SPDM_ASYNC_STATE_WAIT,
+  so that the thread can drive other flows in the meantime.
+  Otherwise, the thread sleeps.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  microseconds                  The time to wait in microseconds.
+**/
+void
+spdm_requester_wait (
+  IN     spdm_context_t       *spdm_context,
+  IN     uint64               microseconds
+  );
+
 #endif
@@ -32,6 +32,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
                                        and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
 
   @retval RETURN_SUCCESS               The SPDM request is set successfully.
+  @retval RETURN_NO_RESPONSE           The SPDM request is processed, and no response is sent, such as a fragment inside the window.
   @retval RETURN_BUFFER_TOO_SMALL      The buffer is too small to hold the data.
   @retval RETURN_DEVICE_ERROR          A device error occurs when communicates with the device.
   @retval RETURN_SECURITY_VIOLATION    Any verification fails.
@@ -68,6 +69,7 @@ spdm_process_message (
   This is the main dispatch function in SPDM responder.
 
   It receives one request message, processes it and sends the response message.
+  No response message is sent for a fragment inside the window of FRAGMENT_REQUEST.
 
   It should be called in a while loop or an timer/interrupt handler.
 
@@ -102,6 +104,9 @@ spdm_responder_dispatch_message (
 perf_start (PERF_ID_RESPONDER);
   status = spdm_process_message (spdm_context, &session_id, request, request_size, response, &response_size);
 perf_stop (PERF_ID_RESPONDER);
+  if (status == RETURN_NO_RESPONSE) {
+    return RETURN_SUCCESS;
+  }
   if (RETURN_ERROR(status)) {
     return status;
   }
@@ -0,0 +1,380 @@
+/** @file
+  SPDM common library.
+  It follows the SPDM Specification.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_responder_lib_internal.h"
+
+/**
+  Return ERROR(Busy) to a request that is received while a deferred request is in flight.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer if RETURN_SUCCESS is returned,
+                                       and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The error response is returned.
+**/
+return_status
+spdm_get_response_busy (
+  IN     void                 *context,
+  IN     uintn                request_size,
+  IN     void                 *request,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  )
+{
+  spdm_generate_error_response (context, SPDM_ERROR_CODE_BUSY, 0, response_size, response);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Generate ERROR(ResponseNotReady) again with a larger RDTExponent, because the deferred job is not done.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer.
+  @param  response                     A pointer to the response data.
+**/
+static
+void
+spdm_generate_deferred_response_not_ready (
+  IN     spdm_context_t       *spdm_context,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  )
+{
+  if (spdm_context->error_data.rd_exponent < SPDM_DEFERRED_RESPONSE_MAX_RD_EXPONENT) {
+    spdm_context->error_data.rd_exponent++;
+  }
+  spdm_generate_extended_error_response (spdm_context, SPDM_ERROR_CODE_RESPONSE_NOT_READY, 0, sizeof(spdm_error_data_response_not_ready_t), (uint8*)(void*)&spdm_context->error_data, response_size, response);
+}
+
+/**
+  Check whether a deferred request is queued or running in the worker pool.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @retval TRUE  The job is not done. It owns the SPDM context.
+  @retval FALSE No deferred request is in flight, or its job is done or dropped.
+**/
+boolean
+spdm_is_deferred_response_running (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  return (boolean)(spdm_context->deferred_response.in_flight &&
+                   !spdm_worker_pool_is_job_done (spdm_context, &spdm_context->deferred_response.job));
+}
+
+/**
+  Return the response to a request that is received while a deferred request is running.
+
+  No handler is run, because the job owns the SPDM context.
+  RESPOND_IF_READY of the deferred request gets ERROR(ResponseNotReady) again with a larger RDTExponent.
+  Any other request gets ERROR(Busy).
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The error response is returned.
+**/
+return_status
+spdm_get_response_while_deferred (
+  IN     void                 *context,
+  IN     uintn                request_size,
+  IN     void                 *request,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  )
+{
+  spdm_context_t         *spdm_context;
+  spdm_message_header_t  *spdm_request;
+
+  spdm_context = context;
+  spdm_request = request;
+  if ((request_size == sizeof(spdm_message_header_t)) &&
+      (spdm_request->request_response_code == SPDM_RESPOND_IF_READY) &&
+      (spdm_request->param1 == spdm_context->error_data.request_code) &&
+      (spdm_request->param2 == spdm_context->error_data.token)) {
+    spdm_generate_deferred_response_not_ready (spdm_context, response_size, response);
+    return RETURN_SUCCESS;
+  }
+  return spdm_get_response_busy (spdm_context, request_size, request, response_size, response);
+}
+
+/**
+  The job that processes a deferred request in the worker pool.
+
+  The job works on a copy of the request and writes to its own response buffer.
+  The result is published to the dispatch by the mutex of the worker pool, when the job is set to done.
+
+  @param  context                        A pointer to the SPDM context.
+**/
+void
+spdm_deferred_response_worker (
+  IN     void                     *context
+  )
+{
+  spdm_context_t            *spdm_context;
+  spdm_deferred_response_t  *deferred_response;
+
+  spdm_context = context;
+  deferred_response = &spdm_context->deferred_response;
+  deferred_response->status = ((spdm_get_spdm_response_func)deferred_response->get_response_func) (
+                                spdm_context,
+                                deferred_response->request_size,
+                                deferred_response->request,
+                                &deferred_response->response_size,
+                                deferred_response->response
+                                );
+}
+
+/**
+  Release the buffers of the deferred request, and allow the next request to be deferred.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_release_deferred_response (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  spdm_deferred_response_t  *deferred_response;
+
+  deferred_response = &spdm_context->deferred_response;
+  spdm_arena_free (&spdm_context->arena, deferred_response->request);
+  deferred_response->request = NULL;
+  deferred_response->request_size = 0;
+  spdm_arena_free (&spdm_context->arena, deferred_response->response);
+  deferred_response->response = NULL;
+  deferred_response->response_size = 0;
+  deferred_response->in_flight = FALSE;
+}
+
+/**
+  Check whether the request is expensive enough to be processed by the worker pool.
+
+  The request is deferred if it creates a signature.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+
+  @retval TRUE  The request is deferred.
+  @retval FALSE The request is processed at once.
+**/
+boolean
+spdm_need_defer_response (
+  IN     spdm_context_t       *spdm_context,
+  IN     uintn                request_size,
+  IN     void                 *request
+  )
+{
+  spdm_message_header_t  *spdm_request;
+
+  if (!spdm_context->deferred_response.enabled ||
+      spdm_context->deferred_response.in_flight ||
+      (spdm_context->worker_pool.thread_count == 0) ||
+      (spdm_context->response_state != SPDM_RESPONSE_STATE_NORMAL)) {
+    return FALSE;
+  }
+  if (request_size < sizeof(spdm_message_header_t)) {
+    return FALSE;
+  }
+
+  spdm_request = request;
+  switch (spdm_request->request_response_code) {
+  case SPDM_CHALLENGE:
+  case SPDM_KEY_EXCHANGE:
+    return TRUE;
+  case SPDM_GET_MEASUREMENTS:
+    return (boolean)((spdm_request->param1 & SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE) != 0);
+  default:
+    return FALSE;
+  }
+}
+
+/**
+  Queue the request to the worker pool, and return ERROR(ResponseNotReady).
+
+  The request is processed at once if the job cannot be queued.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer if RETURN_SUCCESS is returned,
+                                       and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The request is deferred, or it is processed and the response is returned.
+  @retval others                       The request cannot be processed.
+**/
+return_status
+spdm_get_response_deferred (
+  IN     void                 *context,
+  IN     uintn                request_size,
+  IN     void                 *request,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  )
+{
+  spdm_context_t            *spdm_context;
+  spdm_deferred_response_t  *deferred_response;
+  spdm_message_header_t     *spdm_request;
+
+  spdm_context = context;
+  deferred_response = &spdm_context->deferred_response;
+  spdm_request = request;
+
+  //
+  // The job and the dispatch loop share the arena, and the session table updated by KEY_EXCHANGE.
+  //
+  if (spdm_arena_init_lock (&spdm_context->arena) && spdm_session_table_init_lock (spdm_context)) {
+    deferred_response->request = spdm_arena_allocate (&spdm_context->arena, request_size, NULL);
+    deferred_response->response = spdm_arena_allocate (&spdm_context->arena, *response_size, NULL);
+  }
+  if ((deferred_response->request != NULL) && (deferred_response->response != NULL)) {
+    copy_mem (deferred_response->request, request, request_size);
+    deferred_response->request_size = request_size;
+    deferred_response->response_size = *response_size;
+    deferred_response->request_code = spdm_request->request_response_code;
+    deferred_response->job.func = spdm_deferred_response_worker;
+    deferred_response->job.context = spdm_context;
+    //
+    // The status is kept if the job is dropped by spdm_worker_pool_stop().
+    //
+    deferred_response->status = RETURN_ABORTED;
+    deferred_response->in_flight = TRUE;
+    if (spdm_worker_pool_submit (spdm_context, &deferred_response->job)) {
+      spdm_context->error_data.rd_exponent = SPDM_DEFERRED_RESPONSE_RD_EXPONENT;
+      spdm_context->error_data.rd_tm = SPDM_DEFERRED_RESPONSE_RD_TM;
+      spdm_context->error_data.request_code = deferred_response->request_code;
+      spdm_context->error_data.token = spdm_context->current_token++;
+      spdm_generate_extended_error_response (spdm_context, SPDM_ERROR_CODE_RESPONSE_NOT_READY, 0, sizeof(spdm_error_data_response_not_ready_t), (uint8*)(void*)&spdm_context->error_data, response_size, response);
+      return RETURN_SUCCESS;
+    }
+  }
+
+  DEBUG((DEBUG_INFO, "spdm_get_response_deferred - process request 0x%x at once\n", spdm_request->request_response_code));
+  spdm_release_deferred_response (spdm_context);
+  return ((spdm_get_spdm_response_func)deferred_response->get_response_func) (spdm_context, request_size, request, response_size, response);
+}
+
+/**
+  Return the GET_SPDM_RESPONSE function to process a request, if the request may be deferred.
+
+  The request is deferred to the worker pool if it is expensive.
+  No handler is run while a deferred request is running, see spdm_get_response_while_deferred().
+  The response of a deferred request is dropped if the requester sends another request after it is done.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  get_response_func             The GET_SPDM_RESPONSE function according to the request code.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+
+  @return GET_SPDM_RESPONSE function to process the request.
+**/
+spdm_get_spdm_response_func
+spdm_get_deferrable_response_func (
+  IN     spdm_context_t               *spdm_context,
+  IN     spdm_get_spdm_response_func  get_response_func,
+  IN     uintn                        request_size,
+  IN     void                         *request
+  )
+{
+  spdm_deferred_response_t  *deferred_response;
+  spdm_message_header_t     *spdm_request;
+
+  deferred_response = &spdm_context->deferred_response;
+  spdm_request = request;
+
+  if (spdm_is_deferred_response_running (spdm_context)) {
+    return spdm_get_response_while_deferred;
+  }
+  if (deferred_response->in_flight && (spdm_request->request_response_code != SPDM_RESPOND_IF_READY)) {
+    DEBUG((DEBUG_INFO, "spdm_get_deferrable_response_func - drop the response of request 0x%x\n", deferred_response->request_code));
+    spdm_release_deferred_response (spdm_context);
+  }
+
+  if (spdm_need_defer_response (spdm_context, request_size, request)) {
+    deferred_response->get_response_func = (uintn)get_response_func;
+    return spdm_get_response_deferred;
+  }
+  return get_response_func;
+}
+
+/**
+  Return the response of the deferred request to RESPOND_IF_READY.
+
+  ERROR(ResponseNotReady) is returned again with a larger RDTExponent if the job is not done.
+  ERROR(Unspecified) is returned if the job is dropped by spdm_worker_pool_stop().
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer if RETURN_SUCCESS is returned,
+                                       and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The response is returned.
+  @retval RETURN_BUFFER_TOO_SMALL      The buffer is too small to hold the data.
+  @retval others                       The deferred request cannot be processed.
+**/
+return_status
+spdm_get_deferred_response (
+  IN     spdm_context_t       *spdm_context,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  )
+{
+  spdm_deferred_response_t  *deferred_response;
+  return_status             status;
+
+  deferred_response = &spdm_context->deferred_response;
+  ASSERT (deferred_response->in_flight);
+
+  if (!spdm_worker_pool_is_job_done (spdm_context, &deferred_response->job)) {
+    spdm_generate_deferred_response_not_ready (spdm_context, response_size, response);
+    return RETURN_SUCCESS;
+  }
+
+  if (deferred_response->job.status == SPDM_JOB_STATUS_DROPPED) {
+    //
+    // The worker pool is stopped before the job runs. The request is not processed.
+    //
+    DEBUG((DEBUG_INFO, "spdm_get_deferred_response - request 0x%x is dropped\n", deferred_response->request_code));
+    spdm_release_deferred_response (spdm_context);
+    spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_UNSPECIFIED, 0, response_size, response);
+    return RETURN_SUCCESS;
+  }
+
+  status = deferred_response->status;
+  if (!RETURN_ERROR(status)) {
+    if (*response_size < deferred_response->response_size) {
+      *response_size = deferred_response->response_size;
+      status = RETURN_BUFFER_TOO_SMALL;
+    } else {
+      copy_mem (response, deferred_response->response, deferred_response->response_size);
+      *response_size = deferred_response->response_size;
+    }
+  }
+  spdm_release_deferred_response (spdm_context);
+  return status;
+}
@@ -54,7 +54,7 @@ spdm_get_encap_request_get_certificate (
   spdm_request->Offset_reserved = 0;
   spdm_request->length_reserved = 0;
   spdm_request->Offset = (uint16)get_managed_buffer_size (&spdm_context->encap_context.certificate_chain_buffer);
-  spdm_request->length = MAX_SPDM_CERT_CHAIN_BLOCK_LEN;
+  spdm_request->length = spdm_get_cert_chain_block_len (spdm_context);
   DEBUG((DEBUG_INFO, "request (Offset 0x%x, size 0x%x):\n", spdm_request->Offset, spdm_request->length));
 
   //
@@ -150,11 +150,19 @@ spdm_process_encap_response_certificate (
   result = spdm_verify_peer_cert_chain_buffer (spdm_context, get_managed_buffer(&spdm_context->encap_context.certificate_chain_buffer), get_managed_buffer_size(&spdm_context->encap_context.certificate_chain_buffer));
   if (!result) {
     spdm_context->encap_context.error_state = SPDM_STATUS_ERROR_CERTIFICATE_FAILURE;
+    reset_managed_buffer (&spdm_context->encap_context.certificate_chain_buffer);
     return RETURN_SECURITY_VIOLATION;
   }
   
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = get_managed_buffer_size(&spdm_context->encap_context.certificate_chain_buffer);
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, get_managed_buffer(&spdm_context->encap_context.certificate_chain_buffer), get_managed_buffer_size(&spdm_context->encap_context.certificate_chain_buffer));
+  result = spdm_set_peer_used_cert_chain_buffer (spdm_context, get_managed_buffer(&spdm_context->encap_context.certificate_chain_buffer), get_managed_buffer_size(&spdm_context->encap_context.certificate_chain_buffer));
+  //
+  // The certificate chain is verified. Release the buffer to the arena.
+  //
+  reset_managed_buffer (&spdm_context->encap_context.certificate_chain_buffer);
+  if (!result) {
+    spdm_context->encap_context.error_state = SPDM_STATUS_ERROR_DEVICE_ERROR;
+    return RETURN_OUT_OF_RESOURCES;
+  }
 
   spdm_context->encap_context.error_state = SPDM_STATUS_SUCCESS;
 
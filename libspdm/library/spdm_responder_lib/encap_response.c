@@ -194,14 +194,14 @@ spdm_init_mut_auth_encap_state (
   spdm_context->encap_context.request_id = 0;
   spdm_context->encap_context.last_encap_request_size = 0;
   zero_mem (&spdm_context->encap_context.last_encap_request_header, sizeof(spdm_context->encap_context.last_encap_request_header));
-  spdm_context->encap_context.certificate_chain_buffer.buffer_size = 0;
+  reset_managed_buffer (&spdm_context->encap_context.certificate_chain_buffer);
   spdm_context->response_state = SPDM_RESPONSE_STATE_PROCESSING_ENCAP;
 
   //
   // Clear Cache
   //
-  reset_managed_buffer (&spdm_context->transcript.message_mut_b);
-  reset_managed_buffer (&spdm_context->transcript.message_mut_c);
+  spdm_reset_message_mut_b (spdm_context);
+  spdm_reset_message_mut_c (spdm_context);
   
   //
   // Possible Sequence:
@@ -243,14 +243,14 @@ spdm_init_basic_mut_auth_encap_state (
   spdm_context->encap_context.request_id = 0;
   spdm_context->encap_context.last_encap_request_size = 0;
   zero_mem (&spdm_context->encap_context.last_encap_request_header, sizeof(spdm_context->encap_context.last_encap_request_header));
-  spdm_context->encap_context.certificate_chain_buffer.buffer_size = 0;
+  reset_managed_buffer (&spdm_context->encap_context.certificate_chain_buffer);
   spdm_context->response_state = SPDM_RESPONSE_STATE_PROCESSING_ENCAP;
 
   //
   // Clear Cache
   //
-  reset_managed_buffer (&spdm_context->transcript.message_mut_b);
-  reset_managed_buffer (&spdm_context->transcript.message_mut_c);
+  spdm_reset_message_mut_b (spdm_context);
+  spdm_reset_message_mut_c (spdm_context);
   
   //
   // Possible Sequence:
@@ -295,11 +295,11 @@ spdm_init_key_update_encap_state (
   spdm_context->encap_context.request_id = 0;
   spdm_context->encap_context.last_encap_request_size = 0;
   zero_mem (&spdm_context->encap_context.last_encap_request_header, sizeof(spdm_context->encap_context.last_encap_request_header));
-  spdm_context->encap_context.certificate_chain_buffer.buffer_size = 0;
+  reset_managed_buffer (&spdm_context->encap_context.certificate_chain_buffer);
   spdm_context->response_state = SPDM_RESPONSE_STATE_PROCESSING_ENCAP;
 
-  reset_managed_buffer (&spdm_context->transcript.message_mut_b);
-  reset_managed_buffer (&spdm_context->transcript.message_mut_c);
+  spdm_reset_message_mut_b (spdm_context);
+  spdm_reset_message_mut_c (spdm_context);
 
   zero_mem (spdm_context->encap_context.request_op_code_sequence, sizeof(spdm_context->encap_context.request_op_code_sequence));
   spdm_context->encap_context.request_op_code_count = 1;
@@ -521,5 +521,6 @@ spdm_handle_encap_error_response_main (
   // Do it here just to align with requester.
   //
   shrink_managed_buffer(m_buffer, shrink_buffer_size);
+  spdm_reset_transcript_hash (spdm_context);
   return RETURN_DEVICE_ERROR;
 }
@@ -9,9 +9,93 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "spdm_responder_lib_internal.h"
 
+/**
+  Release the buffer of the response that is sent in FRAGMENT_RESPONSE.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_release_fragment_encapsulated_response (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  spdm_arena_free (&spdm_context->arena, spdm_context->last_spdm_fragment_encapsulated_response);
+  spdm_context->last_spdm_fragment_encapsulated_response = NULL;
+  spdm_context->last_spdm_fragment_encapsulated_response_size = 0;
+  spdm_context->last_spdm_fragment_encapsulated_response_sent_size = 0;
+}
+
+/**
+  Reset the state of the request that is received in FRAGMENT_REQUEST, and release its buffer.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_reset_fragment_encapsulated_request (
+  IN     spdm_context_t       *spdm_context
+  )
+{
+  spdm_arena_free (&spdm_context->arena, spdm_context->last_spdm_fragment_encapsulated_request);
+  spdm_context->last_spdm_fragment_encapsulated_request = NULL;
+  spdm_context->last_spdm_fragment_encapsulated_request_size = 0;
+  spdm_context->last_spdm_fragment_encapsulated_request_window_size = 0;
+  spdm_context->last_spdm_fragment_encapsulated_request_unacked_count = 0;
+  spdm_context->last_spdm_fragment_encapsulated_request_error_code = 0;
+}
+
+/**
+  Fail the request that is received in FRAGMENT_REQUEST.
+
+  Inside the window, the first error is recorded and no response is returned, because the requester
+  only receives a response at the end of the window. At the end of the window, or for a fragment that
+  is always answered, the first error is returned and the fragment state is reset.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  request                      A pointer to the FRAGMENT_REQUEST.
+  @param  error_code                    The error code of this fragment.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of the ERROR response, or 0 if no response is returned.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The ERROR response is returned.
+  @retval RETURN_NO_RESPONSE           The fragment is inside the window, and no response is returned.
+**/
+static
+return_status
+spdm_fail_fragment_request (
+  IN     spdm_context_t           *spdm_context,
+  IN     spdm_fragment_request_t  *request,
+  IN     uint8                    error_code,
+  IN OUT uintn                    *response_size,
+     OUT void                     *response
+  )
+{
+  if (spdm_context->last_spdm_fragment_encapsulated_request_error_code == 0) {
+    spdm_context->last_spdm_fragment_encapsulated_request_error_code = error_code;
+  }
+
+  if (((request->header.param1 & (SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN | SPDM_FRAGMENT_REQUEST_ATTRIBUTER_END)) == 0) &&
+      (spdm_context->last_spdm_fragment_encapsulated_request_window_size > 1)) {
+    spdm_context->last_spdm_fragment_encapsulated_request_unacked_count++;
+    if (spdm_context->last_spdm_fragment_encapsulated_request_unacked_count < spdm_context->last_spdm_fragment_encapsulated_request_window_size) {
+      *response_size = 0;
+      return RETURN_NO_RESPONSE;
+    }
+  }
+
+  spdm_generate_error_response (spdm_context, spdm_context->last_spdm_fragment_encapsulated_request_error_code, 0, response_size, response);
+  spdm_reset_fragment_encapsulated_request (spdm_context);
+  return RETURN_SUCCESS;
+}
+
 /**
   Process the SPDM FRAGMENT_REQUEST request and return the response.
 
+  The BEGIN fragment and the END fragment are always answered. The other fragments are
+  answered with a cumulative ACK once the window accepted in the BEGIN fragment is full,
+  and no response is returned for the fragments inside the window.
+
   @param  spdm_context                  A pointer to the SPDM context.
   @param  request_size                  size in bytes of the request data.
   @param  request                      A pointer to the request data.
@@ -22,6 +106,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   @param  response                     A pointer to the response data.
 
   @retval RETURN_SUCCESS               The request is processed and the response is returned.
+  @retval RETURN_NO_RESPONSE           The fragment is inside the window, and no response is returned.
   @retval RETURN_BUFFER_TOO_SMALL      The buffer is too small to hold the data.
   @retval RETURN_DEVICE_ERROR          A device error occurs when communicates with the device.
   @retval RETURN_SECURITY_VIOLATION    Any verification fails.
@@ -42,55 +127,83 @@ spdm_get_response_fragment_request (
   return_status                     status;
   spdm_message_header_t             *spdm_request;
   boolean                           need_fragment_response;
+  uint8                             window_size;
 
   spdm_context = context;
   my_request = request;
 
+  if ((my_request->header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) {
+    spdm_reset_fragment_encapsulated_request (spdm_context);
+  } else if (spdm_context->last_spdm_fragment_encapsulated_request_error_code != 0) {
+    //
+    // The rest of the window after an error is dropped.
+    //
+    return spdm_fail_fragment_request (spdm_context, my_request, 0, response_size, response);
+  }
+
   if (request_size < sizeof(spdm_fragment_request_t)) {
-    spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-    return RETURN_SUCCESS;
+    return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_INVALID_REQUEST, response_size, response);
   }
   if (request_size > sizeof(spdm_fragment_request_t) + MAX_SPDM_FRAGMENT_LENGTH) {
-    spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-    return RETURN_SUCCESS;
+    return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_INVALID_REQUEST, response_size, response);
   }
   if (request_size != sizeof(spdm_fragment_request_t) + my_request->length) {
-    spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-    return RETURN_SUCCESS;
+    return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_INVALID_REQUEST, response_size, response);
   }
-  if (my_request->header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) {
+  if ((my_request->header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) {
     if (my_request->offset != 0) {
-      spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-      return RETURN_SUCCESS;
+      return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_INVALID_REQUEST, response_size, response);
+    }
+
+    //
+    // The window is used only if both sides enable it. Otherwise, 0 is returned in the reserved param1 of the ACK.
+    //
+    window_size = (my_request->header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_MASK) >> SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_SHIFT;
+    if (window_size > spdm_context->fragment_window_size) {
+      window_size = spdm_context->fragment_window_size;
+    }
+    spdm_context->last_spdm_fragment_encapsulated_request_window_size = window_size;
+  } else {
+    //
+    // A fragment that does not follow a BEGIN fragment is not expected.
+    //
+    if (spdm_context->last_spdm_fragment_encapsulated_request == NULL) {
+      return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_UNEXPECTED_REQUEST, response_size, response);
+    }
+    //
+    // The ACK is decided by the count of fragments, so the fragments must be in sequence.
+    //
+    if (my_request->sequence_id != spdm_context->last_spdm_fragment_encapsulated_request_sequence_id + 1) {
+      return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_INVALID_REQUEST, response_size, response);
     }
-    spdm_context->last_spdm_fragment_encapsulated_request_size = 0;
   }
 
   if (my_request->offset != spdm_context->last_spdm_fragment_encapsulated_request_size) {
-    spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-    return RETURN_SUCCESS;
+    return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_INVALID_REQUEST, response_size, response);
   }
   if (my_request->length > MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE - my_request->offset) {
-    spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-    return RETURN_SUCCESS;
+    return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_INVALID_REQUEST, response_size, response);
+  }
+  if (spdm_context->last_spdm_fragment_encapsulated_request == NULL) {
+    spdm_context->last_spdm_fragment_encapsulated_request = spdm_arena_allocate (&spdm_context->arena, MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE, NULL);
+    if (spdm_context->last_spdm_fragment_encapsulated_request == NULL) {
+      return spdm_fail_fragment_request (spdm_context, my_request, SPDM_ERROR_CODE_BUSY, response_size, response);
+    }
   }
 
   copy_mem (spdm_context->last_spdm_fragment_encapsulated_request + my_request->offset, my_request + 1, my_request->length);
   spdm_context->last_spdm_fragment_encapsulated_request_size = my_request->offset + my_request->length;
+  spdm_context->last_spdm_fragment_encapsulated_request_sequence_id = my_request->sequence_id;
 
   if (my_request->header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_END) {
     spdm_request = (void *)spdm_context->last_spdm_fragment_encapsulated_request;
     status = RETURN_UNSUPPORTED;
     get_response_func = spdm_get_response_func_via_request_code (spdm_request->request_response_code);
     if (get_response_func != NULL) {
+      get_response_func = spdm_get_deferrable_response_func (spdm_context, get_response_func, spdm_context->last_spdm_fragment_encapsulated_request_size, spdm_context->last_spdm_fragment_encapsulated_request);
       need_fragment_response = spdm_need_fragment_response(spdm_request->request_response_code);
       if (need_fragment_response) {
-        spdm_context->last_spdm_fragment_encapsulated_response_size = sizeof(spdm_context->last_spdm_fragment_encapsulated_response);
-        spdm_context->last_spdm_fragment_encapsulated_response_sent_size = 0;
-        status = get_response_func (spdm_context, spdm_context->last_spdm_fragment_encapsulated_request_size, spdm_context->last_spdm_fragment_encapsulated_request, &spdm_context->last_spdm_fragment_encapsulated_response_size, spdm_context->last_spdm_fragment_encapsulated_response);
-        if (status == RETURN_SUCCESS) {
-          status = spdm_build_fragment_response (spdm_context, response_size, response);
-        }
+        status = spdm_get_fragment_encapsulated_response (spdm_context, get_response_func, spdm_context->last_spdm_fragment_encapsulated_request_size, spdm_context->last_spdm_fragment_encapsulated_request, response_size, response);
       } else {
         status = get_response_func (spdm_context, spdm_context->last_spdm_fragment_encapsulated_request_size, spdm_context->last_spdm_fragment_encapsulated_request, response_size, response);
       }
@@ -99,9 +212,24 @@ spdm_get_response_fragment_request (
       spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_UNSUPPORTED_REQUEST, spdm_request->request_response_code, response_size, response);
     }
 
+    //
+    // The request is processed. Release the buffer to the arena.
+    //
+    spdm_reset_fragment_encapsulated_request (spdm_context);
+
     return RETURN_SUCCESS;
   }
 
+  if (((my_request->header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) == 0) &&
+      (spdm_context->last_spdm_fragment_encapsulated_request_window_size > 1)) {
+    spdm_context->last_spdm_fragment_encapsulated_request_unacked_count++;
+    if (spdm_context->last_spdm_fragment_encapsulated_request_unacked_count < spdm_context->last_spdm_fragment_encapsulated_request_window_size) {
+      *response_size = 0;
+      return RETURN_NO_RESPONSE;
+    }
+    spdm_context->last_spdm_fragment_encapsulated_request_unacked_count = 0;
+  }
+
   ASSERT (*response_size >= sizeof(spdm_fragment_request_ack_t));
   zero_mem (response, *response_size);
   my_response = response;
@@ -110,6 +238,9 @@ spdm_get_response_fragment_request (
   my_response->header.spdm_version = SPDM_MESSAGE_VERSION_11;
   my_response->header.request_response_code = SPDM_FRAGMENT_REQUEST_ACK;
   my_response->header.param1 = 0;
+  if ((my_request->header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) {
+    my_response->header.param1 = spdm_context->last_spdm_fragment_encapsulated_request_window_size;
+  }
   my_response->header.param2 = my_request->header.param2;
   my_response->sequence_id = my_request->sequence_id;
 
@@ -190,6 +321,9 @@ spdm_get_response_fragment_rsp_request (
   *response_size = sizeof(spdm_fragment_response_t) + length;
 
   spdm_context->last_spdm_fragment_encapsulated_response_sent_size = offset + length;
+  if (spdm_context->last_spdm_fragment_encapsulated_response_sent_size == spdm_context->last_spdm_fragment_encapsulated_response_size) {
+    spdm_release_fragment_encapsulated_response (spdm_context);
+  }
 
   return RETURN_SUCCESS;
 }
@@ -261,6 +395,60 @@ spdm_build_fragment_response (
   *response_size = sizeof(spdm_fragment_response_t) + length;
 
   spdm_context->last_spdm_fragment_encapsulated_response_sent_size = offset + length;
+  if (spdm_context->last_spdm_fragment_encapsulated_response_sent_size == spdm_context->last_spdm_fragment_encapsulated_response_size) {
+    spdm_release_fragment_encapsulated_response (spdm_context);
+  }
 
   return RETURN_SUCCESS;
 }
+
+/**
+  Process the request whose response is sent in FRAGMENT_RESPONSE, and build the first FRAGMENT_RESPONSE.
+
+  The full response is kept in a buffer allocated from the arena, and the buffer is released
+  after the last fragment is sent.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  get_response_func             The function to process the request.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer if RETURN_SUCCESS is returned,
+                                       and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The request is processed and the response is returned.
+  @retval RETURN_OUT_OF_RESOURCES      The buffer of the full response cannot be allocated.
+  @retval others                       The request cannot be processed.
+**/
+return_status
+spdm_get_fragment_encapsulated_response (
+  IN     void                         *context,
+  IN     spdm_get_spdm_response_func  get_response_func,
+  IN     uintn                        request_size,
+  IN     void                         *request,
+  IN OUT uintn                        *response_size,
+     OUT void                         *response
+  )
+{
+  spdm_context_t               *spdm_context;
+  return_status                status;
+
+  spdm_context = context;
+
+  if (spdm_context->last_spdm_fragment_encapsulated_response == NULL) {
+    spdm_context->last_spdm_fragment_encapsulated_response = spdm_arena_allocate (&spdm_context->arena, MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE, NULL);
+    if (spdm_context->last_spdm_fragment_encapsulated_response == NULL) {
+      return RETURN_OUT_OF_RESOURCES;
+    }
+  }
+  spdm_context->last_spdm_fragment_encapsulated_response_size = MAX_SPDM_MESSAGE_LARGE_BUFFER_SIZE;
+  spdm_context->last_spdm_fragment_encapsulated_response_sent_size = 0;
+  status = get_response_func (spdm_context, request_size, request, &spdm_context->last_spdm_fragment_encapsulated_response_size, spdm_context->last_spdm_fragment_encapsulated_response);
+  if (status != RETURN_SUCCESS) {
+    spdm_release_fragment_encapsulated_response (spdm_context);
+    return status;
+  }
+  return spdm_build_fragment_response (spdm_context, response_size, response);
+}
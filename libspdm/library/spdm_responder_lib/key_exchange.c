@@ -58,7 +58,6 @@ spdm_get_response_key_exchange (
   void                          *pqc_kem_context;
   uintn                         pqc_kem_public_key_size;
   uintn                         pqc_kem_cipher_text_size;
-  boolean                       result2;
   boolean                       need_pqc_kem;
 
   spdm_context = context;
@@ -205,33 +204,37 @@ perf_start (PERF_ID_KEY_EX_KEM_ENCAP);
   DEBUG((DEBUG_INFO, "Calc peer_key (0x%x):\n", dhe_key_size));
   internal_dump_hex ((uint8 *)request + sizeof(spdm_key_exchange_request_t), dhe_key_size);
 
-  result = spdm_secured_message_dhe_compute_key (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context, (uint8 *)request + sizeof(spdm_key_exchange_request_t), dhe_key_size, session_info->secured_message_context);
+  ptr += dhe_key_size;
+
+  if (need_pqc_kem) {
+    pqc_kem_context = spdm_secured_message_pqc_kem_new (spdm_context->connection_info.algorithm.pqc_kem_algo);
+  } else {
+    pqc_kem_context = NULL;
+  }
+  //
+  // The ECDHE shared secret and the PQC KEM encapsulation are computed in parallel if the worker pool is enabled.
+  //
+  result = spdm_compute_key_exchange_shared_secret (spdm_context, FALSE, session_info->secured_message_context,
+                                                    dhe_context, (uint8 *)request + sizeof(spdm_key_exchange_request_t), dhe_key_size,
+                                                    pqc_kem_context, (uint8 *)request + sizeof(spdm_key_exchange_request_t) + dhe_key_size, pqc_kem_public_key_size,
+                                                    ptr, &pqc_kem_cipher_text_size);
   spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, dhe_context);
+  if (need_pqc_kem) {
+    spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
+  }
   if (!result) {
     spdm_free_session_id (spdm_context, session_id);
     spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
     return RETURN_SUCCESS;
   }
 
-  ptr += dhe_key_size;
-
   if (need_pqc_kem) {
-    pqc_kem_context = spdm_secured_message_pqc_kem_new (spdm_context->connection_info.algorithm.pqc_kem_algo);
-    result2 = spdm_secured_message_pqc_kem_encap (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context,
-                                                  (uint8 *)request + sizeof(spdm_key_exchange_request_t) + dhe_key_size, pqc_kem_public_key_size,
-                                                  ptr, &pqc_kem_cipher_text_size, session_info->secured_message_context);
     DEBUG((DEBUG_INFO, "Calc SelfKey PQC (0x%x):\n", pqc_kem_cipher_text_size));
     internal_dump_hex (ptr, pqc_kem_cipher_text_size);
 
     DEBUG((DEBUG_INFO, "Calc peer_key PQC (0x%x):\n", pqc_kem_public_key_size));
     internal_dump_hex ((uint8 *)request + sizeof(spdm_key_exchange_request_t) + dhe_key_size, pqc_kem_public_key_size);
 
-    spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, pqc_kem_context);
-    if (!result2) {
-      spdm_free_session_id (spdm_context, session_id);
-      spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-      return RETURN_SUCCESS;
-    }
     ptr += pqc_kem_cipher_text_size;
   }
 perf_stop (PERF_ID_KEY_EX_KEM_ENCAP);
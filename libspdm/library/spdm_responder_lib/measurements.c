@@ -197,9 +197,8 @@ spdm_get_response_measurements (
   }
 
   device_measurement_size = sizeof(device_measurement);
-  ret = spdm_measurement_collection (
-          spdm_context->connection_info.algorithm.measurement_spec,
-          spdm_context->connection_info.algorithm.measurement_hash_algo,
+  ret = spdm_collect_measurement (
+          spdm_context,
           &device_measurement_count,
           device_measurement,
           &device_measurement_size
@@ -260,7 +259,7 @@ spdm_get_response_measurements (
         slot_id_param = spdm_request->SlotIDParam;
         if ((slot_id_param != 0xF) && (slot_id_param >= spdm_context->local_context.slot_count)) {
           spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-          reset_managed_buffer (&spdm_context->transcript.message_m);
+          spdm_reset_message_m (spdm_context);
           return RETURN_SUCCESS;
         }
         spdm_response->header.param2 = slot_id_param;
@@ -268,7 +267,7 @@ spdm_get_response_measurements (
       status = spdm_create_measurement_signature (spdm_context, spdm_response, spdm_response_size);
       if (RETURN_ERROR(status)) {
         spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_UNSUPPORTED_REQUEST, SPDM_GET_MEASUREMENTS, response_size, response);
-        reset_managed_buffer (&spdm_context->transcript.message_m);
+        spdm_reset_message_m (spdm_context);
         return RETURN_SUCCESS;
       }
     } else {
@@ -322,7 +321,7 @@ spdm_get_response_measurements (
         slot_id_param = spdm_request->SlotIDParam;
         if ((slot_id_param != 0xF) && (slot_id_param >= spdm_context->local_context.slot_count)) {
           spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-          reset_managed_buffer (&spdm_context->transcript.message_m);
+          spdm_reset_message_m (spdm_context);
           return RETURN_SUCCESS;
         }
         spdm_response->header.param2 = slot_id_param;
@@ -330,7 +329,7 @@ spdm_get_response_measurements (
       status = spdm_create_measurement_signature (spdm_context, spdm_response, spdm_response_size);
       if (RETURN_ERROR(status)) {
         spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_UNSUPPORTED_REQUEST, SPDM_GET_MEASUREMENTS, response_size, response);
-        reset_managed_buffer (&spdm_context->transcript.message_m);
+        spdm_reset_message_m (spdm_context);
         return RETURN_SUCCESS;
       }
     } else {
@@ -391,7 +390,7 @@ spdm_get_response_measurements (
           slot_id_param = spdm_request->SlotIDParam;
           if ((slot_id_param != 0xF) && (slot_id_param >= spdm_context->local_context.slot_count)) {
             spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-            reset_managed_buffer (&spdm_context->transcript.message_m);
+            spdm_reset_message_m (spdm_context);
             return RETURN_SUCCESS;
           }
           spdm_response->header.param2 = slot_id_param;
@@ -399,7 +398,7 @@ spdm_get_response_measurements (
         status = spdm_create_measurement_signature (spdm_context, spdm_response, spdm_response_size);
         if (RETURN_ERROR(status)) {
           spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_UNSUPPORTED_REQUEST, SPDM_GET_MEASUREMENTS, response_size, response);
-          reset_managed_buffer (&spdm_context->transcript.message_m);
+          spdm_reset_message_m (spdm_context);
           return RETURN_SUCCESS;
         }
       } else {
@@ -407,7 +406,7 @@ spdm_get_response_measurements (
       }
     } else {
       spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+      spdm_reset_message_m (spdm_context);
       return RETURN_SUCCESS;
     }
     break;
@@ -416,12 +415,12 @@ spdm_get_response_measurements (
     //
     // Reset
     //
-    reset_managed_buffer (&spdm_context->transcript.message_m);
+    spdm_reset_message_m (spdm_context);
   } else {
     status = spdm_append_message_m (spdm_context, spdm_response, *response_size);
     if (RETURN_ERROR(status)) {
       spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
-      reset_managed_buffer (&spdm_context->transcript.message_m);
+      spdm_reset_message_m (spdm_context);
       return RETURN_SUCCESS;
     }
   }
@@ -53,7 +53,6 @@ spdm_get_response_func_via_request_code (
 {
   uintn                index;
 
-  ASSERT(request_code != SPDM_RESPOND_IF_READY);
   for (index = 0; index < sizeof(mSpdmGetResponseStruct)/sizeof(mSpdmGetResponseStruct[0]); index++) {
     if (request_code == mSpdmGetResponseStruct[index].request_response_code) {
       return mSpdmGetResponseStruct[index].get_response_func;
@@ -76,7 +75,6 @@ spdm_need_fragment_response (
 {
   uintn                index;
 
-  ASSERT(request_code != SPDM_RESPOND_IF_READY);
   for (index = 0; index < sizeof(mSpdmGetResponseStruct)/sizeof(mSpdmGetResponseStruct[0]); index++) {
     if (request_code == mSpdmGetResponseStruct[index].request_response_code) {
       return mSpdmGetResponseStruct[index].need_fragment_response;
@@ -132,6 +130,7 @@ spdm_process_request (
   return_status             status;
   spdm_session_info_t         *session_info;
   uint32                    *message_session_id;
+  boolean                   update_session_id;
 
   spdm_context = context;
 
@@ -145,9 +144,24 @@ spdm_process_request (
   DEBUG((DEBUG_INFO, "SpdmReceiveRequest[.] ...\n"));
 
   message_session_id = NULL;
-  spdm_context->last_spdm_request_session_id_valid = FALSE;
+  //
+  // The deferred request in the worker pool uses the session ID of its own request until the job is done.
+  //
+  update_session_id = (boolean)!spdm_is_deferred_response_running (spdm_context);
+  if (update_session_id) {
+    spdm_context->last_spdm_request_session_id_valid = FALSE;
+  }
   spdm_context->last_spdm_request_size = sizeof(spdm_context->last_spdm_request);
+  //
+  // A deferred KEY_EXCHANGE may update the session table while the session of a secured message is looked up.
+  //
+  spdm_session_table_lock (spdm_context);
   status = spdm_context->transport_decode_message (spdm_context, &message_session_id, is_app_message, TRUE, request_size, request, &spdm_context->last_spdm_request_size, spdm_context->last_spdm_request);
+  session_info = NULL;
+  if (!RETURN_ERROR(status) && (message_session_id != NULL)) {
+    session_info = spdm_get_session_info_via_session_id (spdm_context, *message_session_id);
+  }
+  spdm_session_table_unlock (spdm_context);
   if (RETURN_ERROR(status)) {
     DEBUG((DEBUG_INFO, "transport_decode_message : %p\n", status));
     if (spdm_context->last_spdm_error.error_code != 0) {
@@ -168,12 +182,13 @@ spdm_process_request (
   *session_id = message_session_id;
 
   if (message_session_id != NULL) {
-    session_info = spdm_get_session_info_via_session_id (spdm_context, *message_session_id);
     if (session_info == NULL) {
       return RETURN_UNSUPPORTED;
     }
-    spdm_context->last_spdm_request_session_id = *message_session_id;
-    spdm_context->last_spdm_request_session_id_valid = TRUE;
+    if (update_session_id) {
+      spdm_context->last_spdm_request_session_id = *message_session_id;
+      spdm_context->last_spdm_request_session_id_valid = TRUE;
+    }
   } 
 
   DEBUG((DEBUG_INFO, "SpdmReceiveRequest[%x] (0x%x): \n", (message_session_id != NULL) ? *message_session_id : 0, spdm_context->last_spdm_request_size));
@@ -288,6 +303,7 @@ spdm_set_connection_state (
                                        either implicit or explicit ownership of the buffer.
 
   @retval RETURN_SUCCESS               The SPDM response is sent successfully.
+  @retval RETURN_NO_RESPONSE           The request is processed, and no response is sent, such as a fragment inside the window.
   @retval RETURN_DEVICE_ERROR          A device error occurs when the SPDM response is sent to the device.
 **/
 return_status
@@ -308,6 +324,7 @@ spdm_build_response (
   spdm_message_header_t               *spdm_request;
   spdm_message_header_t               *spdm_response;
   boolean                             need_fragment_response;
+  uint8                               request_code;
 
   spdm_context = context;
 
@@ -335,7 +352,9 @@ spdm_build_response (
     DEBUG((DEBUG_INFO, "SpdmSendResponse[%x] (0x%x): \n", (session_id != NULL) ? *session_id : 0, my_response_size));
     internal_dump_hex (my_response, my_response_size);
 
+    spdm_session_table_lock (spdm_context);
     status = spdm_context->transport_encode_message (spdm_context, session_id, FALSE, FALSE, my_response_size, my_response, response_size, response);
+    spdm_session_table_unlock (spdm_context);
     if (RETURN_ERROR(status)) {
       DEBUG((DEBUG_INFO, "transport_encode_message : %p\n", status));
       return status;
@@ -346,7 +365,9 @@ spdm_build_response (
   }
 
   if (session_id != NULL) {
+    spdm_session_table_lock (spdm_context);
     session_info = spdm_get_session_info_via_session_id (spdm_context, *session_id);
+    spdm_session_table_unlock (spdm_context);
     if (session_info == NULL) {
       ASSERT (FALSE);
       return RETURN_UNSUPPORTED;
@@ -376,26 +397,39 @@ spdm_build_response (
   if (!is_app_message) {
     get_response_func = spdm_get_response_func_via_last_request (spdm_context);
     if (get_response_func != NULL) {
-      need_fragment_response = spdm_need_fragment_response(spdm_request->request_response_code);
+      get_response_func = spdm_get_deferrable_response_func (spdm_context, get_response_func, spdm_context->last_spdm_request_size, spdm_context->last_spdm_request);
+      //
+      // The response to RESPOND_IF_READY is the response to the original request.
+      //
+      request_code = spdm_request->request_response_code;
+      if (request_code == SPDM_RESPOND_IF_READY) {
+        request_code = spdm_request->param1;
+      }
+      need_fragment_response = spdm_need_fragment_response(request_code);
       if (need_fragment_response) {
-        spdm_context->last_spdm_fragment_encapsulated_response_size = sizeof(spdm_context->last_spdm_fragment_encapsulated_response);
-        spdm_context->last_spdm_fragment_encapsulated_response_sent_size = 0;
-        status = get_response_func (spdm_context, spdm_context->last_spdm_request_size, spdm_context->last_spdm_request, &spdm_context->last_spdm_fragment_encapsulated_response_size, spdm_context->last_spdm_fragment_encapsulated_response);
-        if (status == RETURN_SUCCESS) {
-          status = spdm_build_fragment_response (spdm_context, &my_response_size, my_response);
-        }
+        status = spdm_get_fragment_encapsulated_response (spdm_context, get_response_func, spdm_context->last_spdm_request_size, spdm_context->last_spdm_request, &my_response_size, my_response);
       } else {
         status = get_response_func (spdm_context, spdm_context->last_spdm_request_size, spdm_context->last_spdm_request, &my_response_size, my_response);
       }
     }
   }
   if (is_app_message || (get_response_func == NULL)) {
-    if (spdm_context->get_response_func != 0) {
+    if (spdm_is_deferred_response_running (spdm_context)) {
+      //
+      // The deferred job owns the SPDM context until it is done. The APP message handler is not run in the meantime.
+      //
+      status = spdm_get_response_busy (spdm_context, spdm_context->last_spdm_request_size, spdm_context->last_spdm_request, &my_response_size, my_response);
+    } else if (spdm_context->get_response_func != 0) {
       status = ((spdm_get_response_func)spdm_context->get_response_func) (spdm_context, session_id, is_app_message, spdm_context->last_spdm_request_size, spdm_context->last_spdm_request, &my_response_size, my_response);
     } else {
       status = RETURN_NOT_FOUND;
     }
   }
+  if (status == RETURN_NO_RESPONSE) {
+    DEBUG((DEBUG_INFO, "SpdmSendResponse[%x] - no response\n", (session_id != NULL) ? *session_id : 0));
+    *response_size = 0;
+    return RETURN_NO_RESPONSE;
+  }
   if (status != RETURN_SUCCESS) {
     spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_UNSUPPORTED_REQUEST, spdm_request->request_response_code, &my_response_size, my_response);
   }
@@ -403,7 +437,9 @@ spdm_build_response (
   DEBUG((DEBUG_INFO, "SpdmSendResponse[%x] (0x%x): \n", (session_id != NULL) ? *session_id : 0, my_response_size));
   internal_dump_hex (my_response, my_response_size);
 
+  spdm_session_table_lock (spdm_context);
   status = spdm_context->transport_encode_message (spdm_context, session_id, is_app_message, FALSE, my_response_size, my_response, response_size, response);
+  spdm_session_table_unlock (spdm_context);
   if (RETURN_ERROR(status)) {
     DEBUG((DEBUG_INFO, "transport_encode_message : %p\n", status));
     return status;
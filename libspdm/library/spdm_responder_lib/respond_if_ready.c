@@ -66,6 +66,10 @@ spdm_get_response_respond_if_ready (
     return RETURN_SUCCESS;
   }
 
+  if (spdm_context->deferred_response.in_flight) {
+    return spdm_get_deferred_response (spdm_context, response_size, response);
+  }
+
   get_response_func = NULL;
   get_response_func = spdm_get_response_func_via_request_code(spdm_request->param1);
   if (get_response_func == NULL) {
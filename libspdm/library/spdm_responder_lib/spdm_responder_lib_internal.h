@@ -581,6 +581,56 @@ spdm_build_fragment_response (
      OUT void                 *response
   );
 
+/**
+  Process the request whose response is sent in FRAGMENT_RESPONSE, and build the first FRAGMENT_RESPONSE.
+
+  The full response is kept in a buffer allocated from the arena, and the buffer is released
+  after the last fragment is sent.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  get_response_func             The function to process the request.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer if RETURN_SUCCESS is returned,
+                                       and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The request is processed and the response is returned.
+  @retval RETURN_OUT_OF_RESOURCES      The buffer of the full response cannot be allocated.
+  @retval others                       The request cannot be processed.
+**/
+return_status
+spdm_get_fragment_encapsulated_response (
+  IN     void                         *context,
+  IN     spdm_get_spdm_response_func  get_response_func,
+  IN     uintn                        request_size,
+  IN     void                         *request,
+  IN OUT uintn                        *response_size,
+     OUT void                         *response
+  );
+
+/**
+  Release the buffer of the response that is sent in FRAGMENT_RESPONSE.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_release_fragment_encapsulated_response (
+  IN     spdm_context_t       *spdm_context
+  );
+
+/**
+  Reset the state of the request that is received in FRAGMENT_REQUEST, and release its buffer.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_reset_fragment_encapsulated_request (
+  IN     spdm_context_t       *spdm_context
+  );
+
 /**
   Get the SPDM encapsulated GET_DIGESTS request.
 
@@ -765,6 +815,114 @@ spdm_need_fragment_response (
   IN     uint8                    request_code
   );
 
+/**
+  Return ERROR(Busy) to a request that is received while a deferred request is in flight.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer if RETURN_SUCCESS is returned,
+                                       and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The error response is returned.
+**/
+return_status
+spdm_get_response_busy (
+  IN     void                 *context,
+  IN     uintn                request_size,
+  IN     void                 *request,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  );
+
+/**
+  Check whether a deferred request is queued or running in the worker pool.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+
+  @retval TRUE  The job is not done. It owns the SPDM context.
+  @retval FALSE No deferred request is in flight, or its job is done or dropped.
+**/
+boolean
+spdm_is_deferred_response_running (
+  IN     spdm_context_t       *spdm_context
+  );
+
+/**
+  Return the response to a request that is received while a deferred request is running.
+
+  No handler is run, because the job owns the SPDM context.
+  RESPOND_IF_READY of the deferred request gets ERROR(ResponseNotReady) again with a larger RDTExponent.
+  Any other request gets ERROR(Busy).
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The error response is returned.
+**/
+return_status
+spdm_get_response_while_deferred (
+  IN     void                 *context,
+  IN     uintn                request_size,
+  IN     void                 *request,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  );
+
+/**
+  Return the GET_SPDM_RESPONSE function to process a request, if the request may be deferred.
+
+  The request is deferred to the worker pool if it is expensive.
+  No handler is run while a deferred request is running, see spdm_get_response_while_deferred().
+  The response of a deferred request is dropped if the requester sends another request after it is done.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  get_response_func             The GET_SPDM_RESPONSE function according to the request code.
+  @param  request_size                  size in bytes of the request data.
+  @param  request                      A pointer to the request data.
+
+  @return GET_SPDM_RESPONSE function to process the request.
+**/
+spdm_get_spdm_response_func
+spdm_get_deferrable_response_func (
+  IN     spdm_context_t               *spdm_context,
+  IN     spdm_get_spdm_response_func  get_response_func,
+  IN     uintn                        request_size,
+  IN     void                         *request
+  );
+
+/**
+  Return the response of the deferred request to RESPOND_IF_READY.
+
+  ERROR(ResponseNotReady) is returned again with a larger RDTExponent if the job is not done.
+  ERROR(Unspecified) is returned if the job is dropped by spdm_worker_pool_stop().
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  response_size                 size in bytes of the response data.
+                                       On input, it means the size in bytes of response data buffer.
+                                       On output, it means the size in bytes of copied response data buffer if RETURN_SUCCESS is returned,
+                                       and means the size in bytes of desired response data buffer if RETURN_BUFFER_TOO_SMALL is returned.
+  @param  response                     A pointer to the response data.
+
+  @retval RETURN_SUCCESS               The response is returned.
+  @retval RETURN_BUFFER_TOO_SMALL      The buffer is too small to hold the data.
+  @retval others                       The deferred request cannot be processed.
+**/
+return_status
+spdm_get_deferred_response (
+  IN     spdm_context_t       *spdm_context,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  );
+
 /**
   This function initializes the mut_auth encapsulated state.
 
@@ -75,9 +75,9 @@ spdm_get_response_version (
   //
   // Cache
   //
-  reset_managed_buffer (&spdm_context->transcript.message_a);
-  reset_managed_buffer (&spdm_context->transcript.message_b);
-  reset_managed_buffer (&spdm_context->transcript.message_c);
+  spdm_reset_message_a (spdm_context);
+  spdm_reset_message_b (spdm_context);
+  spdm_reset_message_c (spdm_context);
   status = spdm_append_message_a (spdm_context, spdm_request, spdm_request_size);
   if (RETURN_ERROR(status)) {
     spdm_generate_error_response (spdm_context, SPDM_ERROR_CODE_INVALID_REQUEST, 0, response_size, response);
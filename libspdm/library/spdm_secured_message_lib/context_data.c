@@ -37,11 +37,35 @@ spdm_secured_message_init_context (
   spdm_secured_message_context_t           *secured_message_context;
 
   secured_message_context = spdm_secured_message_context;
-  zero_mem (secured_message_context, sizeof(spdm_secured_message_context_t));
+  secure_zero_mem (secured_message_context, sizeof(spdm_secured_message_context_t));
 
   random_seed (NULL, 0);
 }
 
+/**
+  Release the resources held by an SPDM secured message context, such as the AEAD contexts.
+
+  The SPDM secured message context must be initialized by spdm_secured_message_init_context.
+  It may be initialized again by spdm_secured_message_init_context after this function.
+
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+*/
+void
+spdm_secured_message_deinit_context (
+  IN     void                     *spdm_secured_message_context
+  )
+{
+  spdm_secured_message_context_t           *secured_message_context;
+
+  secured_message_context = spdm_secured_message_context;
+  spdm_free_aead_context (secured_message_context, &secured_message_context->handshake_secret.request_handshake_aead_context);
+  spdm_free_aead_context (secured_message_context, &secured_message_context->handshake_secret.response_handshake_aead_context);
+  spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret.request_data_aead_context);
+  spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret.response_data_aead_context);
+  spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret_backup.request_data_aead_context);
+  spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret_backup.response_data_aead_context);
+}
+
 /**
   Set use_psk to an SPDM secured message context.
 
@@ -368,6 +392,17 @@ spdm_secured_message_import_session_keys (
   ptr += secured_message_context->aead_iv_size;
   copy_mem (&secured_message_context->application_secret.response_data_sequence_number, ptr, sizeof(uint64));
   ptr += sizeof(uint64);
+
+  spdm_set_aead_context_key (
+    secured_message_context,
+    &secured_message_context->application_secret.request_data_aead_context,
+    secured_message_context->application_secret.request_data_encryption_key
+    );
+  spdm_set_aead_context_key (
+    secured_message_context,
+    &secured_message_context->application_secret.response_data_aead_context,
+    secured_message_context->application_secret.response_data_encryption_key
+    );
   return RETURN_SUCCESS;
 }
 
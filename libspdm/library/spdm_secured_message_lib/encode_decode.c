@@ -54,6 +54,7 @@ spdm_encode_secured_message (
   spdm_secured_message_cipher_header_t *enc_msg_header;
   boolean                            result;
   uint8                              key[MAX_AEAD_KEY_SIZE];
+  void                               *aead_context;
   uint8                              salt[MAX_AEAD_IV_SIZE];
   uint64                             sequence_number;
   uint64                             sequence_num_in_header;
@@ -78,10 +79,12 @@ spdm_encode_secured_message (
   case SPDM_SESSION_STATE_HANDSHAKING:
     if (is_requester) {
       copy_mem (key, secured_message_context->handshake_secret.request_handshake_encryption_key, secured_message_context->aead_key_size);
+      aead_context = secured_message_context->handshake_secret.request_handshake_aead_context;
       copy_mem (salt, secured_message_context->handshake_secret.request_handshake_salt, secured_message_context->aead_iv_size);
       sequence_number = secured_message_context->handshake_secret.request_handshake_sequence_number;
     } else {
       copy_mem (key, secured_message_context->handshake_secret.response_handshake_encryption_key, secured_message_context->aead_key_size);
+      aead_context = secured_message_context->handshake_secret.response_handshake_aead_context;
       copy_mem (salt, secured_message_context->handshake_secret.response_handshake_salt, secured_message_context->aead_iv_size);
       sequence_number = secured_message_context->handshake_secret.response_handshake_sequence_number;
     }
@@ -89,10 +92,12 @@ spdm_encode_secured_message (
   case SPDM_SESSION_STATE_ESTABLISHED:
     if (is_requester) {
       copy_mem (key, secured_message_context->application_secret.request_data_encryption_key, secured_message_context->aead_key_size);
+      aead_context = secured_message_context->application_secret.request_data_aead_context;
       copy_mem (salt, secured_message_context->application_secret.request_data_salt, secured_message_context->aead_iv_size);
       sequence_number = secured_message_context->application_secret.request_data_sequence_number;
     } else {
       copy_mem (key, secured_message_context->application_secret.response_data_encryption_key, secured_message_context->aead_key_size);
+      aead_context = secured_message_context->application_secret.response_data_aead_context;
       copy_mem (salt, secured_message_context->application_secret.response_data_salt, secured_message_context->aead_iv_size);
       sequence_number = secured_message_context->application_secret.response_data_sequence_number;
     }
@@ -171,21 +176,38 @@ spdm_encode_secured_message (
     dec_msg = (uint8 *)enc_msg_header;
     tag = (uint8 *)record_header1 + record_header_size + cipher_text_size;
 
-    result = spdm_aead_encryption (
-              secured_message_context->aead_cipher_suite,
-              key,
-              aead_key_size,
-              salt,
-              aead_iv_size,
-              (uint8 *)a_data,
-              record_header_size,
-              dec_msg,
-              cipher_text_size,
-              tag,
-              aead_tag_size,
-              enc_msg,
-              &cipher_text_size
-              );
+    if (aead_context != NULL) {
+      result = spdm_aead_encryption_with_context (
+                secured_message_context->aead_cipher_suite,
+                aead_context,
+                salt,
+                aead_iv_size,
+                (uint8 *)a_data,
+                record_header_size,
+                dec_msg,
+                cipher_text_size,
+                tag,
+                aead_tag_size,
+                enc_msg,
+                &cipher_text_size
+                );
+    } else {
+      result = spdm_aead_encryption (
+                secured_message_context->aead_cipher_suite,
+                key,
+                aead_key_size,
+                salt,
+                aead_iv_size,
+                (uint8 *)a_data,
+                record_header_size,
+                dec_msg,
+                cipher_text_size,
+                tag,
+                aead_tag_size,
+                enc_msg,
+                &cipher_text_size
+                );
+    }
     break;
 
   case SPDM_SESSION_TYPE_MAC_ONLY:
@@ -206,21 +228,38 @@ spdm_encode_secured_message (
     a_data = (uint8 *)record_header1;
     tag = (uint8 *)record_header1 + record_header_size + app_message_size;
 
-    result = spdm_aead_encryption (
-              secured_message_context->aead_cipher_suite,
-              key,
-              aead_key_size,
-              salt,
-              aead_iv_size,
-              (uint8 *)a_data,
-              record_header_size + app_message_size,
-              NULL,
-              0,
-              tag,
-              aead_tag_size,
-              NULL,
-              NULL
-              );
+    if (aead_context != NULL) {
+      result = spdm_aead_encryption_with_context (
+                secured_message_context->aead_cipher_suite,
+                aead_context,
+                salt,
+                aead_iv_size,
+                (uint8 *)a_data,
+                record_header_size + app_message_size,
+                NULL,
+                0,
+                tag,
+                aead_tag_size,
+                NULL,
+                NULL
+                );
+    } else {
+      result = spdm_aead_encryption (
+                secured_message_context->aead_cipher_suite,
+                key,
+                aead_key_size,
+                salt,
+                aead_iv_size,
+                (uint8 *)a_data,
+                record_header_size + app_message_size,
+                NULL,
+                0,
+                tag,
+                aead_tag_size,
+                NULL,
+                NULL
+                );
+    }
     break;
 
   default:
@@ -277,6 +316,7 @@ spdm_decode_secured_message (
   spdm_secured_message_cipher_header_t *enc_msg_header;
   boolean                            result;
   uint8                              key[MAX_AEAD_KEY_SIZE];
+  void                               *aead_context;
   uint8                              salt[MAX_AEAD_IV_SIZE];
   uint64                             sequence_number;
   uint64                             sequence_num_in_header;
@@ -308,10 +348,12 @@ spdm_decode_secured_message (
   case SPDM_SESSION_STATE_HANDSHAKING:
     if (is_requester) {
       copy_mem (key, secured_message_context->handshake_secret.request_handshake_encryption_key, secured_message_context->aead_key_size);
+      aead_context = secured_message_context->handshake_secret.request_handshake_aead_context;
       copy_mem (salt, secured_message_context->handshake_secret.request_handshake_salt, secured_message_context->aead_iv_size);
       sequence_number = secured_message_context->handshake_secret.request_handshake_sequence_number;
     } else {
       copy_mem (key, secured_message_context->handshake_secret.response_handshake_encryption_key, secured_message_context->aead_key_size);
+      aead_context = secured_message_context->handshake_secret.response_handshake_aead_context;
       copy_mem (salt, secured_message_context->handshake_secret.response_handshake_salt, secured_message_context->aead_iv_size);
       sequence_number = secured_message_context->handshake_secret.response_handshake_sequence_number;
     }
@@ -319,10 +361,12 @@ spdm_decode_secured_message (
   case SPDM_SESSION_STATE_ESTABLISHED:
     if (is_requester) {
       copy_mem (key, secured_message_context->application_secret.request_data_encryption_key, secured_message_context->aead_key_size);
+      aead_context = secured_message_context->application_secret.request_data_aead_context;
       copy_mem (salt, secured_message_context->application_secret.request_data_salt, secured_message_context->aead_iv_size);
       sequence_number = secured_message_context->application_secret.request_data_sequence_number;
     } else {
       copy_mem (key, secured_message_context->application_secret.response_data_encryption_key, secured_message_context->aead_key_size);
+      aead_context = secured_message_context->application_secret.response_data_aead_context;
       copy_mem (salt, secured_message_context->application_secret.response_data_salt, secured_message_context->aead_iv_size);
       sequence_number = secured_message_context->application_secret.response_data_sequence_number;
     }
@@ -398,21 +442,38 @@ spdm_decode_secured_message (
     dec_msg = (uint8 *)dec_message;
     enc_msg_header = (void *)dec_msg;
     tag = (uint8 *)record_header1 + record_header_size + cipher_text_size;
-    result = spdm_aead_decryption (
-              secured_message_context->aead_cipher_suite,
-              key,
-              aead_key_size,
-              salt,
-              aead_iv_size,
-              (uint8 *)a_data,
-              record_header_size,
-              enc_msg,
-              cipher_text_size,
-              tag,
-              aead_tag_size,
-              dec_msg,
-              &cipher_text_size
-              );
+    if (aead_context != NULL) {
+      result = spdm_aead_decryption_with_context (
+                secured_message_context->aead_cipher_suite,
+                aead_context,
+                salt,
+                aead_iv_size,
+                (uint8 *)a_data,
+                record_header_size,
+                enc_msg,
+                cipher_text_size,
+                tag,
+                aead_tag_size,
+                dec_msg,
+                &cipher_text_size
+                );
+    } else {
+      result = spdm_aead_decryption (
+                secured_message_context->aead_cipher_suite,
+                key,
+                aead_key_size,
+                salt,
+                aead_iv_size,
+                (uint8 *)a_data,
+                record_header_size,
+                enc_msg,
+                cipher_text_size,
+                tag,
+                aead_tag_size,
+                dec_msg,
+                &cipher_text_size
+                );
+    }
     if (!result) {
       spdm_secured_message_set_last_spdm_error_struct (spdm_secured_message_context, &spdm_error);
       return RETURN_SECURITY_VIOLATION;
@@ -457,21 +518,38 @@ spdm_decode_secured_message (
     }
     a_data = (uint8 *)record_header1;
     tag = (uint8 *)record_header1 + record_header_size + record_header2->length - aead_tag_size;
-    result = spdm_aead_decryption (
-              secured_message_context->aead_cipher_suite,
-              key,
-              aead_key_size,
-              salt,
-              aead_iv_size,
-              (uint8 *)a_data,
-              record_header_size + record_header2->length - aead_tag_size,
-              NULL,
-              0,
-              tag,
-              aead_tag_size,
-              NULL,
-              NULL
-              );
+    if (aead_context != NULL) {
+      result = spdm_aead_decryption_with_context (
+                secured_message_context->aead_cipher_suite,
+                aead_context,
+                salt,
+                aead_iv_size,
+                (uint8 *)a_data,
+                record_header_size + record_header2->length - aead_tag_size,
+                NULL,
+                0,
+                tag,
+                aead_tag_size,
+                NULL,
+                NULL
+                );
+    } else {
+      result = spdm_aead_decryption (
+                secured_message_context->aead_cipher_suite,
+                key,
+                aead_key_size,
+                salt,
+                aead_iv_size,
+                (uint8 *)a_data,
+                record_header_size + record_header2->length - aead_tag_size,
+                NULL,
+                0,
+                tag,
+                aead_tag_size,
+                NULL,
+                NULL
+                );
+    }
     if (!result) {
       spdm_secured_message_set_last_spdm_error_struct (spdm_secured_message_context, &spdm_error);
       return RETURN_SECURITY_VIOLATION;
@@ -96,55 +96,89 @@ spdm_bin_concat (
 }
 
 /**
-  This function generates SPDM AEAD key and IV for a session.
+  This function generates SPDM AEAD key and IV, and optionally the FinishedKey, for one direction of a session.
+
+  All outputs are derived from the major secret in one HKDF expand batch.
 
   @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
   @param  major_secret                  The major secret.
+  @param  finished_key                  The buffer to store the finished key. NULL if no finished key is needed.
   @param  key                          The buffer to store the AEAD key.
   @param  iv                           The buffer to store the AEAD IV.
 
   @retval RETURN_SUCCESS  SPDM AEAD key and IV for a session is generated.
 **/
 return_status
-spdm_generate_aead_key_and_iv (
+spdm_generate_traffic_keys (
   IN spdm_secured_message_context_t *secured_message_context,
   IN uint8                        *major_secret,
+  OUT uint8                       *finished_key OPTIONAL,
   OUT uint8                       *key,
   OUT uint8                       *iv
   )
 {
-  return_status   status;
-  boolean         ret_val;
-  uintn           hash_size;
-  uintn           key_length;
-  uintn           iv_length;
-  uint8           bin_str5[128];
-  uintn           bin_str5_size;
-  uint8           bin_str6[128];
-  uintn           bin_str6_size;
+  return_status             status;
+  boolean                   ret_val;
+  uintn                     hash_size;
+  uintn                     key_length;
+  uintn                     iv_length;
+  uint8                     bin_str5[128];
+  uintn                     bin_str5_size;
+  uint8                     bin_str6[128];
+  uintn                     bin_str6_size;
+  uint8                     bin_str7[128];
+  uintn                     bin_str7_size;
+  spdm_hkdf_expand_item_t   item[3];
+  uintn                     item_count;
 
   hash_size = secured_message_context->hash_size;
   key_length = secured_message_context->aead_key_size;
   iv_length = secured_message_context->aead_iv_size;
-  
+
   bin_str5_size = sizeof(bin_str5);
   status = spdm_bin_concat (BIN_STR_5_LABEL, sizeof(BIN_STR_5_LABEL) - 1, NULL, (uint16)key_length, hash_size, bin_str5, &bin_str5_size);
   ASSERT_RETURN_ERROR (status);
   DEBUG((DEBUG_INFO, "bin_str5 (0x%x):\n", bin_str5_size));
   internal_dump_hex (bin_str5, bin_str5_size);
-  ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, major_secret, hash_size, bin_str5, bin_str5_size, key, key_length);
-  ASSERT (ret_val);
-  DEBUG((DEBUG_INFO, "key (0x%x) - ", key_length));
-  internal_dump_data (key, key_length);
-  DEBUG((DEBUG_INFO, "\n"));
-  
+  item[0].info = bin_str5;
+  item[0].info_size = bin_str5_size;
+  item[0].out = key;
+  item[0].out_size = key_length;
+
   bin_str6_size = sizeof(bin_str6);
   status = spdm_bin_concat (BIN_STR_6_LABEL, sizeof(BIN_STR_6_LABEL) - 1, NULL, (uint16)iv_length, hash_size, bin_str6, &bin_str6_size);
   ASSERT_RETURN_ERROR (status);
   DEBUG((DEBUG_INFO, "bin_str6 (0x%x):\n", bin_str6_size));
   internal_dump_hex (bin_str6, bin_str6_size);
-  ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, major_secret, hash_size, bin_str6, bin_str6_size, iv, iv_length);
+  item[1].info = bin_str6;
+  item[1].info_size = bin_str6_size;
+  item[1].out = iv;
+  item[1].out_size = iv_length;
+  item_count = 2;
+
+  if (finished_key != NULL) {
+    bin_str7_size = sizeof(bin_str7);
+    status = spdm_bin_concat (BIN_STR_7_LABEL, sizeof(BIN_STR_7_LABEL) - 1, NULL, (uint16)hash_size, hash_size, bin_str7, &bin_str7_size);
+    ASSERT_RETURN_ERROR (status);
+    DEBUG((DEBUG_INFO, "bin_str7 (0x%x):\n", bin_str7_size));
+    internal_dump_hex (bin_str7, bin_str7_size);
+    item[2].info = bin_str7;
+    item[2].info_size = bin_str7_size;
+    item[2].out = finished_key;
+    item[2].out_size = hash_size;
+    item_count = 3;
+  }
+
+  ret_val = spdm_hkdf_expand_batch (secured_message_context->bash_hash_algo, major_secret, hash_size, item, item_count);
   ASSERT (ret_val);
+  if (finished_key != NULL) {
+    DEBUG((DEBUG_INFO, "FinishedKey (0x%x) - ", hash_size));
+    internal_dump_data (finished_key, hash_size);
+    DEBUG((DEBUG_INFO, "\n"));
+  }
+  DEBUG((DEBUG_INFO, "key (0x%x) - ", key_length));
+  internal_dump_data (key, key_length);
+  DEBUG((DEBUG_INFO, "\n"));
   DEBUG((DEBUG_INFO, "iv (0x%x) - ", iv_length));
   internal_dump_data (iv, iv_length);
   DEBUG((DEBUG_INFO, "\n"));
@@ -153,41 +187,49 @@ spdm_generate_aead_key_and_iv (
 }
 
 /**
-  This function generates SPDM FinishedKey for a session.
+  This function sets the AEAD key to the AEAD context of one direction.
 
-  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
-  @param  handshake_secret              The handshake secret.
-  @param  FinishedKey                  The buffer to store the finished key.
+  The AEAD context is allocated on first use and is reused for later keys.
+  It is left NULL if the AEAD algorithm has no context support, then the AEAD key is used for each message.
 
-  @retval RETURN_SUCCESS  SPDM FinishedKey for a session is generated.
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+  @param  aead_context                  The AEAD context of one direction.
+  @param  key                          The AEAD key.
 **/
-return_status
-spdm_generate_finished_key (
+void
+spdm_set_aead_context_key (
   IN spdm_secured_message_context_t *secured_message_context,
-  IN uint8                        *handshake_secret,
-  OUT uint8                       *FinishedKey
+  IN OUT void                     **aead_context,
+  IN uint8                        *key
   )
 {
-  return_status   status;
-  boolean         ret_val;
-  uintn           hash_size;
-  uint8           bin_str7[128];
-  uintn           bin_str7_size;
-
-  hash_size = secured_message_context->hash_size;
+  if (*aead_context == NULL) {
+    *aead_context = spdm_aead_new (secured_message_context->aead_cipher_suite);
+    if (*aead_context == NULL) {
+      return ;
+    }
+  }
+  if (!spdm_aead_set_key (secured_message_context->aead_cipher_suite, *aead_context, key, secured_message_context->aead_key_size)) {
+    spdm_free_aead_context (secured_message_context, aead_context);
+  }
+}
 
-  bin_str7_size = sizeof(bin_str7);
-  status = spdm_bin_concat (BIN_STR_7_LABEL, sizeof(BIN_STR_7_LABEL) - 1, NULL, (uint16)hash_size, hash_size, bin_str7, &bin_str7_size);
-  ASSERT_RETURN_ERROR (status);
-  DEBUG((DEBUG_INFO, "bin_str7 (0x%x):\n", bin_str7_size));
-  internal_dump_hex (bin_str7, bin_str7_size);
-  ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, handshake_secret, hash_size, bin_str7, bin_str7_size, FinishedKey, hash_size);
-  ASSERT (ret_val);
-  DEBUG((DEBUG_INFO, "FinishedKey (0x%x) - ", hash_size));
-  internal_dump_data (FinishedKey, hash_size);
-  DEBUG((DEBUG_INFO, "\n"));
+/**
+  This function frees the AEAD context of one direction.
 
-  return RETURN_SUCCESS;
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+  @param  aead_context                  The AEAD context of one direction.
+**/
+void
+spdm_free_aead_context (
+  IN spdm_secured_message_context_t *secured_message_context,
+  IN OUT void                     **aead_context
+  )
+{
+  if (*aead_context != NULL) {
+    spdm_aead_free (secured_message_context->aead_cipher_suite, *aead_context);
+    *aead_context = NULL;
+  }
 }
 
 /**
@@ -213,6 +255,7 @@ spdm_generate_session_handshake_key (
   uintn                          bin_str1_size;
   uint8                          bin_str2[128];
   uintn                          bin_str2_size;
+  spdm_hkdf_expand_item_t        item[2];
   spdm_secured_message_context_t   *secured_message_context;
   
   secured_message_context = spdm_secured_message_context;
@@ -246,62 +289,65 @@ spdm_generate_session_handshake_key (
   ASSERT_RETURN_ERROR (status);
   DEBUG((DEBUG_INFO, "bin_str1 (0x%x):\n", bin_str1_size));
   internal_dump_hex (bin_str1, bin_str1_size);
-  if (secured_message_context->use_psk) {
-    ret_val = spdm_psk_handshake_secret_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->psk_hint, secured_message_context->psk_hint_size, bin_str1, bin_str1_size, secured_message_context->handshake_secret.request_handshake_secret, hash_size);
-    if (!ret_val) {
-      return RETURN_UNSUPPORTED;
-    }
-  } else {
-    ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->master_secret.handshake_secret, hash_size, bin_str1, bin_str1_size, secured_message_context->handshake_secret.request_handshake_secret, hash_size);
-  }
-  ASSERT (ret_val);
-  DEBUG((DEBUG_INFO, "request_handshake_secret (0x%x) - ", hash_size));
-  internal_dump_data (secured_message_context->handshake_secret.request_handshake_secret, hash_size);
-  DEBUG((DEBUG_INFO, "\n"));
   bin_str2_size = sizeof(bin_str2);
   status = spdm_bin_concat (BIN_STR_2_LABEL, sizeof(BIN_STR_2_LABEL) - 1, th1_hash_data, (uint16)hash_size, hash_size, bin_str2, &bin_str2_size);
   ASSERT_RETURN_ERROR (status);
   DEBUG((DEBUG_INFO, "bin_str2 (0x%x):\n", bin_str2_size));
   internal_dump_hex (bin_str2, bin_str2_size);
   if (secured_message_context->use_psk) {
+    ret_val = spdm_psk_handshake_secret_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->psk_hint, secured_message_context->psk_hint_size, bin_str1, bin_str1_size, secured_message_context->handshake_secret.request_handshake_secret, hash_size);
+    if (!ret_val) {
+      return RETURN_UNSUPPORTED;
+    }
     ret_val = spdm_psk_handshake_secret_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->psk_hint, secured_message_context->psk_hint_size, bin_str2, bin_str2_size, secured_message_context->handshake_secret.response_handshake_secret, hash_size);
     if (!ret_val) {
       return RETURN_UNSUPPORTED;
     }
   } else {
-    ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->master_secret.handshake_secret, hash_size, bin_str2, bin_str2_size, secured_message_context->handshake_secret.response_handshake_secret, hash_size);
+    item[0].info = bin_str1;
+    item[0].info_size = bin_str1_size;
+    item[0].out = secured_message_context->handshake_secret.request_handshake_secret;
+    item[0].out_size = hash_size;
+    item[1].info = bin_str2;
+    item[1].info_size = bin_str2_size;
+    item[1].out = secured_message_context->handshake_secret.response_handshake_secret;
+    item[1].out_size = hash_size;
+    ret_val = spdm_hkdf_expand_batch (secured_message_context->bash_hash_algo, secured_message_context->master_secret.handshake_secret, hash_size, item, 2);
   }
   ASSERT (ret_val);
+  DEBUG((DEBUG_INFO, "request_handshake_secret (0x%x) - ", hash_size));
+  internal_dump_data (secured_message_context->handshake_secret.request_handshake_secret, hash_size);
+  DEBUG((DEBUG_INFO, "\n"));
   DEBUG((DEBUG_INFO, "response_handshake_secret (0x%x) - ", hash_size));
   internal_dump_data (secured_message_context->handshake_secret.response_handshake_secret, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
-  spdm_generate_finished_key (
-    secured_message_context,
-    secured_message_context->handshake_secret.request_handshake_secret,
-    secured_message_context->handshake_secret.request_finished_key
-    );
-
-  spdm_generate_finished_key (
-    secured_message_context,
-    secured_message_context->handshake_secret.response_handshake_secret,
-    secured_message_context->handshake_secret.response_finished_key
-    );
-
-  spdm_generate_aead_key_and_iv (
+  spdm_generate_traffic_keys (
     secured_message_context,
     secured_message_context->handshake_secret.request_handshake_secret,
+    secured_message_context->handshake_secret.request_finished_key,
     secured_message_context->handshake_secret.request_handshake_encryption_key,
     secured_message_context->handshake_secret.request_handshake_salt
     );
+  spdm_set_aead_context_key (
+    secured_message_context,
+    &secured_message_context->handshake_secret.request_handshake_aead_context,
+    secured_message_context->handshake_secret.request_handshake_encryption_key
+    );
   secured_message_context->handshake_secret.request_handshake_sequence_number = 0;
 
-  spdm_generate_aead_key_and_iv (
+  spdm_generate_traffic_keys (
     secured_message_context,
     secured_message_context->handshake_secret.response_handshake_secret,
+    secured_message_context->handshake_secret.response_finished_key,
     secured_message_context->handshake_secret.response_handshake_encryption_key,
     secured_message_context->handshake_secret.response_handshake_salt
     );
+  spdm_set_aead_context_key (
+    secured_message_context,
+    &secured_message_context->handshake_secret.response_handshake_aead_context,
+    secured_message_context->handshake_secret.response_handshake_encryption_key
+    );
   secured_message_context->handshake_secret.response_handshake_sequence_number = 0;
 
   return RETURN_SUCCESS;
@@ -333,6 +379,7 @@ spdm_generate_session_data_key (
   uintn                          bin_str4_size;
   uint8                          bin_str8[128];
   uintn                          bin_str8_size;
+  spdm_hkdf_expand_item_t        item[3];
   spdm_secured_message_context_t   *secured_message_context;
 
   secured_message_context = spdm_secured_message_context;
@@ -363,68 +410,81 @@ spdm_generate_session_data_key (
   ASSERT_RETURN_ERROR (status);
   DEBUG((DEBUG_INFO, "bin_str3 (0x%x):\n", bin_str3_size));
   internal_dump_hex (bin_str3, bin_str3_size);
-  if (secured_message_context->use_psk) {
-    ret_val = spdm_psk_master_secret_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->psk_hint, secured_message_context->psk_hint_size, bin_str3, bin_str3_size, secured_message_context->application_secret.request_data_secret, hash_size);
-    if (!ret_val) {
-      return RETURN_UNSUPPORTED;
-    }
-  } else {
-    ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->master_secret.master_secret, hash_size, bin_str3, bin_str3_size, secured_message_context->application_secret.request_data_secret, hash_size);
-  }
-  ASSERT (ret_val);
-  DEBUG((DEBUG_INFO, "request_data_secret (0x%x) - ", hash_size));
-  internal_dump_data (secured_message_context->application_secret.request_data_secret, hash_size);
-  DEBUG((DEBUG_INFO, "\n"));
   bin_str4_size = sizeof(bin_str4);
   status = spdm_bin_concat (BIN_STR_4_LABEL, sizeof(BIN_STR_4_LABEL) - 1, th2_hash_data, (uint16)hash_size, hash_size, bin_str4, &bin_str4_size);
   ASSERT_RETURN_ERROR (status);
   DEBUG((DEBUG_INFO, "bin_str4 (0x%x):\n", bin_str4_size));
   internal_dump_hex (bin_str4, bin_str4_size);
-  if (secured_message_context->use_psk) {
-    ret_val = spdm_psk_master_secret_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->psk_hint, secured_message_context->psk_hint_size, bin_str4, bin_str4_size, secured_message_context->application_secret.response_data_secret, hash_size);
-    if (!ret_val) {
-      return RETURN_UNSUPPORTED;
-    }
-  } else {
-    ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->master_secret.master_secret, hash_size, bin_str4, bin_str4_size, secured_message_context->application_secret.response_data_secret, hash_size);
-  }
-  ASSERT (ret_val);
-  DEBUG((DEBUG_INFO, "response_data_secret (0x%x) - ", hash_size));
-  internal_dump_data (secured_message_context->application_secret.response_data_secret, hash_size);
-  DEBUG((DEBUG_INFO, "\n"));
-
   bin_str8_size = sizeof(bin_str8);
   status = spdm_bin_concat (BIN_STR_8_LABEL, sizeof(BIN_STR_8_LABEL) - 1, th2_hash_data, (uint16)hash_size, hash_size, bin_str8, &bin_str8_size);
   ASSERT_RETURN_ERROR (status);
   DEBUG((DEBUG_INFO, "bin_str8 (0x%x):\n", bin_str8_size));
   internal_dump_hex (bin_str8, bin_str8_size);
   if (secured_message_context->use_psk) {
+    ret_val = spdm_psk_master_secret_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->psk_hint, secured_message_context->psk_hint_size, bin_str3, bin_str3_size, secured_message_context->application_secret.request_data_secret, hash_size);
+    if (!ret_val) {
+      return RETURN_UNSUPPORTED;
+    }
+    ret_val = spdm_psk_master_secret_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->psk_hint, secured_message_context->psk_hint_size, bin_str4, bin_str4_size, secured_message_context->application_secret.response_data_secret, hash_size);
+    if (!ret_val) {
+      return RETURN_UNSUPPORTED;
+    }
     ret_val = spdm_psk_master_secret_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->psk_hint, secured_message_context->psk_hint_size, bin_str8, bin_str8_size, secured_message_context->handshake_secret.export_master_secret, hash_size);
     if (!ret_val) {
       return RETURN_UNSUPPORTED;
     }
   } else {
-    ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->master_secret.master_secret, hash_size, bin_str8, bin_str8_size, secured_message_context->handshake_secret.export_master_secret, hash_size);
+    item[0].info = bin_str3;
+    item[0].info_size = bin_str3_size;
+    item[0].out = secured_message_context->application_secret.request_data_secret;
+    item[0].out_size = hash_size;
+    item[1].info = bin_str4;
+    item[1].info_size = bin_str4_size;
+    item[1].out = secured_message_context->application_secret.response_data_secret;
+    item[1].out_size = hash_size;
+    item[2].info = bin_str8;
+    item[2].info_size = bin_str8_size;
+    item[2].out = secured_message_context->handshake_secret.export_master_secret;
+    item[2].out_size = hash_size;
+    ret_val = spdm_hkdf_expand_batch (secured_message_context->bash_hash_algo, secured_message_context->master_secret.master_secret, hash_size, item, 3);
   }
   ASSERT (ret_val);
+  DEBUG((DEBUG_INFO, "request_data_secret (0x%x) - ", hash_size));
+  internal_dump_data (secured_message_context->application_secret.request_data_secret, hash_size);
+  DEBUG((DEBUG_INFO, "\n"));
+  DEBUG((DEBUG_INFO, "response_data_secret (0x%x) - ", hash_size));
+  internal_dump_data (secured_message_context->application_secret.response_data_secret, hash_size);
+  DEBUG((DEBUG_INFO, "\n"));
   DEBUG((DEBUG_INFO, "export_master_secret (0x%x) - ", hash_size));
   internal_dump_data (secured_message_context->handshake_secret.export_master_secret, hash_size);
   DEBUG((DEBUG_INFO, "\n"));
 
-  spdm_generate_aead_key_and_iv (
+  spdm_generate_traffic_keys (
     secured_message_context,
     secured_message_context->application_secret.request_data_secret,
+    NULL,
     secured_message_context->application_secret.request_data_encryption_key,
     secured_message_context->application_secret.request_data_salt
     );
+  spdm_set_aead_context_key (
+    secured_message_context,
+    &secured_message_context->application_secret.request_data_aead_context,
+    secured_message_context->application_secret.request_data_encryption_key
+    );
   secured_message_context->application_secret.request_data_sequence_number = 0;
 
-  spdm_generate_aead_key_and_iv (
+  spdm_generate_traffic_keys (
     secured_message_context,
     secured_message_context->application_secret.response_data_secret,
+    NULL,
     secured_message_context->application_secret.response_data_encryption_key,
     secured_message_context->application_secret.response_data_salt
     );
+  spdm_set_aead_context_key (
+    secured_message_context,
+    &secured_message_context->application_secret.response_data_aead_context,
+    secured_message_context->application_secret.response_data_encryption_key
+    );
   secured_message_context->application_secret.response_data_sequence_number = 0;
 
   return RETURN_SUCCESS;
@@ -466,6 +526,9 @@ spdm_create_update_session_data_key (
     copy_mem (&secured_message_context->application_secret_backup.request_data_encryption_key, &secured_message_context->application_secret.request_data_encryption_key, MAX_AEAD_KEY_SIZE);
     copy_mem (&secured_message_context->application_secret_backup.request_data_salt, &secured_message_context->application_secret.request_data_salt, MAX_AEAD_IV_SIZE);
     secured_message_context->application_secret_backup.request_data_sequence_number = secured_message_context->application_secret.request_data_sequence_number;
+    spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret_backup.request_data_aead_context);
+    secured_message_context->application_secret_backup.request_data_aead_context = secured_message_context->application_secret.request_data_aead_context;
+    secured_message_context->application_secret.request_data_aead_context = NULL;
 
     ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->application_secret.request_data_secret, hash_size, bin_str9, bin_str9_size, secured_message_context->application_secret.request_data_secret, hash_size);
     ASSERT (ret_val);
@@ -473,12 +536,18 @@ spdm_create_update_session_data_key (
     internal_dump_data (secured_message_context->application_secret.request_data_secret, hash_size);
     DEBUG((DEBUG_INFO, "\n"));
 
-    spdm_generate_aead_key_and_iv (
+    spdm_generate_traffic_keys (
       secured_message_context,
       secured_message_context->application_secret.request_data_secret,
+      NULL,
       secured_message_context->application_secret.request_data_encryption_key,
       secured_message_context->application_secret.request_data_salt
       );
+    spdm_set_aead_context_key (
+      secured_message_context,
+      &secured_message_context->application_secret.request_data_aead_context,
+      secured_message_context->application_secret.request_data_encryption_key
+      );
     secured_message_context->application_secret.request_data_sequence_number = 0;
   }
 
@@ -487,6 +556,9 @@ spdm_create_update_session_data_key (
     copy_mem (&secured_message_context->application_secret_backup.response_data_encryption_key, &secured_message_context->application_secret.response_data_encryption_key, MAX_AEAD_KEY_SIZE);
     copy_mem (&secured_message_context->application_secret_backup.response_data_salt, &secured_message_context->application_secret.response_data_salt, MAX_AEAD_IV_SIZE);
     secured_message_context->application_secret_backup.response_data_sequence_number = secured_message_context->application_secret.response_data_sequence_number;
+    spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret_backup.response_data_aead_context);
+    secured_message_context->application_secret_backup.response_data_aead_context = secured_message_context->application_secret.response_data_aead_context;
+    secured_message_context->application_secret.response_data_aead_context = NULL;
 
     ret_val = spdm_hkdf_expand (secured_message_context->bash_hash_algo, secured_message_context->application_secret.response_data_secret, hash_size, bin_str9, bin_str9_size, secured_message_context->application_secret.response_data_secret, hash_size);
     ASSERT (ret_val);
@@ -494,12 +566,18 @@ spdm_create_update_session_data_key (
     internal_dump_data (secured_message_context->application_secret.response_data_secret, hash_size);
     DEBUG((DEBUG_INFO, "\n"));
 
-    spdm_generate_aead_key_and_iv (
+    spdm_generate_traffic_keys (
       secured_message_context,
       secured_message_context->application_secret.response_data_secret,
+      NULL,
       secured_message_context->application_secret.response_data_encryption_key,
       secured_message_context->application_secret.response_data_salt
       );
+    spdm_set_aead_context_key (
+      secured_message_context,
+      &secured_message_context->application_secret.response_data_aead_context,
+      secured_message_context->application_secret.response_data_encryption_key
+      );
     secured_message_context->application_secret.response_data_sequence_number = 0;
   }
   return RETURN_SUCCESS;
@@ -531,26 +609,34 @@ spdm_activate_update_session_data_key (
       copy_mem (&secured_message_context->application_secret.request_data_encryption_key, &secured_message_context->application_secret_backup.request_data_encryption_key, MAX_AEAD_KEY_SIZE);
       copy_mem (&secured_message_context->application_secret.request_data_salt, &secured_message_context->application_secret_backup.request_data_salt, MAX_AEAD_IV_SIZE);
       secured_message_context->application_secret.request_data_sequence_number = secured_message_context->application_secret_backup.request_data_sequence_number;
+      spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret.request_data_aead_context);
+      secured_message_context->application_secret.request_data_aead_context = secured_message_context->application_secret_backup.request_data_aead_context;
+      secured_message_context->application_secret_backup.request_data_aead_context = NULL;
     }
     if ((action & SPDM_KEY_UPDATE_ACTION_RESPONDER) != 0) {
       copy_mem (&secured_message_context->application_secret.response_data_secret, &secured_message_context->application_secret_backup.response_data_secret, MAX_HASH_SIZE);
       copy_mem (&secured_message_context->application_secret.response_data_encryption_key, &secured_message_context->application_secret_backup.response_data_encryption_key, MAX_AEAD_KEY_SIZE);
       copy_mem (&secured_message_context->application_secret.response_data_salt, &secured_message_context->application_secret_backup.response_data_salt, MAX_AEAD_IV_SIZE);
       secured_message_context->application_secret.response_data_sequence_number = secured_message_context->application_secret_backup.response_data_sequence_number;
+      spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret.response_data_aead_context);
+      secured_message_context->application_secret.response_data_aead_context = secured_message_context->application_secret_backup.response_data_aead_context;
+      secured_message_context->application_secret_backup.response_data_aead_context = NULL;
     }
   }
 
   if ((action & SPDM_KEY_UPDATE_ACTION_REQUESTER) != 0) {
-    zero_mem (&secured_message_context->application_secret_backup.request_data_secret, MAX_HASH_SIZE);
-    zero_mem (&secured_message_context->application_secret_backup.request_data_encryption_key, MAX_AEAD_KEY_SIZE);
-    zero_mem (&secured_message_context->application_secret_backup.request_data_salt, MAX_AEAD_IV_SIZE);
+    secure_zero_mem (&secured_message_context->application_secret_backup.request_data_secret, MAX_HASH_SIZE);
+    secure_zero_mem (&secured_message_context->application_secret_backup.request_data_encryption_key, MAX_AEAD_KEY_SIZE);
+    secure_zero_mem (&secured_message_context->application_secret_backup.request_data_salt, MAX_AEAD_IV_SIZE);
     secured_message_context->application_secret_backup.request_data_sequence_number = 0;
+    spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret_backup.request_data_aead_context);
   }
   if ((action & SPDM_KEY_UPDATE_ACTION_RESPONDER) != 0) {
-    zero_mem (&secured_message_context->application_secret_backup.response_data_secret, MAX_HASH_SIZE);
-    zero_mem (&secured_message_context->application_secret_backup.response_data_encryption_key, MAX_AEAD_KEY_SIZE);
-    zero_mem (&secured_message_context->application_secret_backup.response_data_salt, MAX_AEAD_IV_SIZE);
+    secure_zero_mem (&secured_message_context->application_secret_backup.response_data_secret, MAX_HASH_SIZE);
+    secure_zero_mem (&secured_message_context->application_secret_backup.response_data_encryption_key, MAX_AEAD_KEY_SIZE);
+    secure_zero_mem (&secured_message_context->application_secret_backup.response_data_salt, MAX_AEAD_IV_SIZE);
     secured_message_context->application_secret_backup.response_data_sequence_number = 0;
+    spdm_free_aead_context (secured_message_context, &secured_message_context->application_secret_backup.response_data_aead_context);
   }
   return RETURN_SUCCESS;
 }
@@ -587,6 +673,38 @@ spdm_hmac_all_with_request_finished_key (
           );
 }
 
+/**
+  Computes the HMAC of a input data given as a list of segments, with request_finished_key.
+
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+  @param  segment                       Pointer to the segments of the data to be HMACed.
+  @param  segment_count                  number of segments.
+  @param  hash_value                    Pointer to a buffer that receives the HMAC value.
+
+  @retval TRUE   HMAC computation succeeded.
+  @retval FALSE  HMAC computation failed.
+**/
+boolean
+spdm_hmac_all_with_request_finished_key_segments (
+  IN   void                         *spdm_secured_message_context,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  OUT  uint8                        *hmac_value
+  )
+{
+  spdm_secured_message_context_t           *secured_message_context;
+
+  secured_message_context = spdm_secured_message_context;
+  return spdm_hmac_all_segments (
+          secured_message_context->bash_hash_algo,
+          segment,
+          segment_count,
+          secured_message_context->handshake_secret.request_finished_key,
+          secured_message_context->hash_size,
+          hmac_value
+          );
+}
+
 /**
   Computes the HMAC of a input data buffer, with response_finished_key.
 
@@ -618,3 +736,35 @@ spdm_hmac_all_with_response_finished_key (
           hmac_value
           );
 }
+
+/**
+  Computes the HMAC of a input data given as a list of segments, with response_finished_key.
+
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+  @param  segment                       Pointer to the segments of the data to be HMACed.
+  @param  segment_count                  number of segments.
+  @param  hash_value                    Pointer to a buffer that receives the HMAC value.
+
+  @retval TRUE   HMAC computation succeeded.
+  @retval FALSE  HMAC computation failed.
+**/
+boolean
+spdm_hmac_all_with_response_finished_key_segments (
+  IN   void                         *spdm_secured_message_context,
+  IN   const spdm_data_segment_t    *segment,
+  IN   uintn                        segment_count,
+  OUT  uint8                        *hmac_value
+  )
+{
+  spdm_secured_message_context_t           *secured_message_context;
+
+  secured_message_context = spdm_secured_message_context;
+  return spdm_hmac_all_segments (
+          secured_message_context->bash_hash_algo,
+          segment,
+          segment_count,
+          secured_message_context->handshake_secret.response_finished_key,
+          secured_message_context->hash_size,
+          hmac_value
+          );
+}
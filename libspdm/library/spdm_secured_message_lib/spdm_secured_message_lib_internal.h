@@ -30,6 +30,11 @@ typedef struct {
   uint8                response_handshake_encryption_key[MAX_AEAD_KEY_SIZE];
   uint8                response_handshake_salt[MAX_AEAD_IV_SIZE];
   uint64               response_handshake_sequence_number;
+  //
+  // AEAD contexts keyed with the encryption keys. NULL if the AEAD algorithm has no context support.
+  //
+  void                 *request_handshake_aead_context;
+  void                 *response_handshake_aead_context;
 } spdm_session_info_struct_handshake_secret_t;
 
 typedef struct {
@@ -41,6 +46,11 @@ typedef struct {
   uint8                response_data_encryption_key[MAX_AEAD_KEY_SIZE];
   uint8                response_data_salt[MAX_AEAD_IV_SIZE];
   uint64               response_data_sequence_number;
+  //
+  // AEAD contexts keyed with the encryption keys. NULL if the AEAD algorithm has no context support.
+  //
+  void                 *request_data_aead_context;
+  void                 *response_data_aead_context;
 } spdm_session_info_struct_application_secret_t;
 
 typedef struct {
@@ -71,4 +81,33 @@ typedef struct {
   spdm_error_struct_t                    last_spdm_error;
 } spdm_secured_message_context_t;
 
+/**
+  This function sets the AEAD key to the AEAD context of one direction.
+
+  The AEAD context is allocated on first use and is reused for later keys.
+  It is left NULL if the AEAD algorithm has no context support, then the AEAD key is used for each message.
+
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+  @param  aead_context                  The AEAD context of one direction.
+  @param  key                          The AEAD key.
+**/
+void
+spdm_set_aead_context_key (
+  IN spdm_secured_message_context_t *secured_message_context,
+  IN OUT void                     **aead_context,
+  IN uint8                        *key
+  );
+
+/**
+  This function frees the AEAD context of one direction.
+
+  @param  spdm_secured_message_context    A pointer to the SPDM secured message context.
+  @param  aead_context                  The AEAD context of one direction.
+**/
+void
+spdm_free_aead_context (
+  IN spdm_secured_message_context_t *secured_message_context,
+  IN OUT void                     **aead_context
+  );
+
 #endif
\ No newline at end of file
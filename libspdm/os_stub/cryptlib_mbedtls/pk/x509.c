@@ -1635,3 +1635,68 @@ x509_compare_date_time (
     return 1;
   }
 }
+
+/**
+  Check whether the current time is within the validity period of a certificate.
+
+  The current time is checked the same way as x509_verify_cert checks it, so that
+  a cached verification result expires together with the certificate.
+  If x509_verify_cert does not check the time, then return TRUE.
+
+  @param[in]      from         notBefore Pointer to date_time object.
+  @param[in]      to           notAfter Pointer to date_time object.
+
+  @retval  TRUE   The current time is within the validity period, or the time is not checked.
+  @retval  FALSE  The certificate is expired or not yet valid.
+**/
+boolean
+x509_check_current_date_time (
+  IN    void   *from,
+  IN    void   *to
+  )
+{
+  if (from == NULL || to == NULL) {
+    return FALSE;
+  }
+  //
+  // mbedtls_x509_crt_verify_with_profile in x509_verify_cert reports
+  // MBEDTLS_X509_BADCERT_FUTURE and MBEDTLS_X509_BADCERT_EXPIRED in the same way.
+  //
+  if (mbedtls_x509_time_is_future ((mbedtls_x509_time *)from) ||
+      mbedtls_x509_time_is_past ((mbedtls_x509_time *)to)) {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+  Copy a date_time object.
+
+  A date_time object may point into its own buffer, so it is copied with this function instead of copy_mem.
+
+  @param[in]      date_time           Pointer to the date_time object.
+  @param[in]      date_time_size      date_time object size.
+  @param[out]     new_date_time       Pointer to the buffer of the copy.
+  @param[in,out]  new_date_time_size  On input, the size of the buffer. On output, the date_time object size.
+
+  @retval  TRUE   The date_time object is copied.
+  @retval  FALSE  The buffer is too small.
+**/
+boolean
+x509_copy_date_time (
+  IN     void   *date_time,
+  IN     uintn  date_time_size,
+     OUT void   *new_date_time,
+  IN OUT uintn  *new_date_time_size
+  )
+{
+  if (date_time == NULL || new_date_time == NULL || new_date_time_size == NULL) {
+    return FALSE;
+  }
+  if (*new_date_time_size < date_time_size) {
+    return FALSE;
+  }
+  *new_date_time_size = date_time_size;
+  copy_mem (new_date_time, date_time, date_time_size);
+  return TRUE;
+}
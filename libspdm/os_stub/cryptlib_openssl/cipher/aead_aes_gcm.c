@@ -267,3 +267,286 @@ done:
 }
 
 
+
+/**
+  Allocates and initializes one AES-GCM context for subsequent use.
+
+  The context holds the expanded key, so that the key schedule is done once by aead_aes_gcm_set_key(),
+  instead of once per message.
+
+  @return  Pointer to the AES-GCM context that has been initialized.
+           If the allocations fails, aead_aes_gcm_new() returns NULL.
+
+**/
+void *
+aead_aes_gcm_new (
+  void
+  )
+{
+  return (void *)EVP_CIPHER_CTX_new ();
+}
+
+/**
+  Release the specified AES-GCM context.
+
+  @param[in]  aead_context  Pointer to the AES-GCM context to be released.
+
+**/
+void
+aead_aes_gcm_free (
+  IN  void  *aead_context
+  )
+{
+  EVP_CIPHER_CTX_free ((EVP_CIPHER_CTX *)aead_context);
+}
+
+/**
+  Set the key of the AES-GCM context for subsequent use.
+
+  key_size must be 16, 24 or 32, otherwise FALSE is returned.
+
+  @param[in, out]  aead_context  Pointer to the AES-GCM context.
+  @param[in]       key           Pointer to the encryption key.
+  @param[in]       key_size       size of the encryption key in bytes.
+
+  @retval TRUE   The key is set successfully.
+  @retval FALSE  The key is set unsuccessfully.
+
+**/
+boolean
+aead_aes_gcm_set_key (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *key,
+  IN      uintn        key_size
+  )
+{
+  EVP_CIPHER_CTX   *ctx;
+  const EVP_CIPHER *cipher;
+  boolean          ret_value;
+
+  if (aead_context == NULL) {
+    return FALSE;
+  }
+  switch (key_size) {
+  case 16:
+    cipher = EVP_aes_128_gcm();
+    break;
+  case 24:
+    cipher = EVP_aes_192_gcm();
+    break;
+  case 32:
+    cipher = EVP_aes_256_gcm();
+    break;
+  default:
+    return FALSE;
+  }
+
+  ctx = aead_context;
+  ret_value = (boolean) EVP_CipherInit_ex(ctx, cipher, NULL, NULL, NULL, 1);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, 12, NULL);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  //
+  // The IV is set for each message. Only the key schedule is done here.
+  //
+  return (boolean) EVP_CipherInit_ex(ctx, NULL, NULL, key, NULL, -1);
+}
+
+/**
+  Performs AEAD AES-GCM authenticated encryption on a data buffer and additional authenticated data (AAD),
+  with the key in the AES-GCM context.
+
+  iv_size must be 12, otherwise FALSE is returned.
+  tag_size must be 12, 13, 14, 15, 16, otherwise FALSE is returned.
+
+  @param[in, out]  aead_context  Pointer to the AES-GCM context with the key set.
+  @param[in]   iv          Pointer to the IV value.
+  @param[in]   iv_size      size of the IV value in bytes.
+  @param[in]   a_data       Pointer to the additional authenticated data (AAD).
+  @param[in]   a_data_size   size of the additional authenticated data (AAD) in bytes.
+  @param[in]   data_in      Pointer to the input data buffer to be encrypted.
+  @param[in]   data_in_size  size of the input data buffer in bytes.
+  @param[out]  tag_out      Pointer to a buffer that receives the authentication tag output.
+  @param[in]   tag_size     size of the authentication tag in bytes.
+  @param[out]  data_out     Pointer to a buffer that receives the encryption output.
+  @param[out]  data_out_size size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD AES-GCM authenticated encryption succeeded.
+  @retval FALSE  AEAD AES-GCM authenticated encryption failed.
+
+**/
+boolean
+aead_aes_gcm_encrypt_with_context (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *iv,
+  IN      uintn        iv_size,
+  IN      const uint8  *a_data,
+  IN      uintn        a_data_size,
+  IN      const uint8  *data_in,
+  IN      uintn        data_in_size,
+  OUT     uint8        *tag_out,
+  IN      uintn        tag_size,
+  OUT     uint8        *data_out,
+  OUT     uintn        *data_out_size
+  )
+{
+  EVP_CIPHER_CTX   *ctx;
+  int32            temp_out_size;
+  boolean          ret_value;
+
+  if (aead_context == NULL) {
+    return FALSE;
+  }
+  if (data_in_size > INT_MAX) {
+    return FALSE;
+  }
+  if (a_data_size > INT_MAX) {
+    return FALSE;
+  }
+  if (iv_size != 12) {
+    return FALSE;
+  }
+  if ((tag_size != 12) && (tag_size != 13) && (tag_size != 14) && (tag_size != 15) && (tag_size != 16)) {
+    return FALSE;
+  }
+  if (data_out_size != NULL) {
+    if ((*data_out_size > INT_MAX) || (*data_out_size < data_in_size)) {
+      return FALSE;
+    }
+  }
+
+  ctx = aead_context;
+  ret_value = (boolean) EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, 1);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_EncryptUpdate(ctx, NULL, &temp_out_size, a_data, (int32)a_data_size);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_EncryptUpdate(ctx, data_out, &temp_out_size, data_in, (int32)data_in_size);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_EncryptFinal_ex(ctx, data_out, &temp_out_size);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, (int32)tag_size, (void *)tag_out);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  if (data_out_size != NULL) {
+    *data_out_size = data_in_size;
+  }
+
+  return ret_value;
+}
+
+/**
+  Performs AEAD AES-GCM authenticated decryption on a data buffer and additional authenticated data (AAD),
+  with the key in the AES-GCM context.
+
+  iv_size must be 12, otherwise FALSE is returned.
+  tag_size must be 12, 13, 14, 15, 16, otherwise FALSE is returned.
+  If additional authenticated data verification fails, FALSE is returned.
+
+  @param[in, out]  aead_context  Pointer to the AES-GCM context with the key set.
+  @param[in]   iv          Pointer to the IV value.
+  @param[in]   iv_size      size of the IV value in bytes.
+  @param[in]   a_data       Pointer to the additional authenticated data (AAD).
+  @param[in]   a_data_size   size of the additional authenticated data (AAD) in bytes.
+  @param[in]   data_in      Pointer to the input data buffer to be decrypted.
+  @param[in]   data_in_size  size of the input data buffer in bytes.
+  @param[in]   tag         Pointer to a buffer that contains the authentication tag.
+  @param[in]   tag_size     size of the authentication tag in bytes.
+  @param[out]  data_out     Pointer to a buffer that receives the decryption output.
+  @param[out]  data_out_size size of the output data buffer in bytes.
+
+  @retval TRUE   AEAD AES-GCM authenticated decryption succeeded.
+  @retval FALSE  AEAD AES-GCM authenticated decryption failed.
+
+**/
+boolean
+aead_aes_gcm_decrypt_with_context (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *iv,
+  IN      uintn        iv_size,
+  IN      const uint8  *a_data,
+  IN      uintn        a_data_size,
+  IN      const uint8  *data_in,
+  IN      uintn        data_in_size,
+  IN      const uint8  *tag,
+  IN      uintn        tag_size,
+  OUT     uint8        *data_out,
+  OUT     uintn        *data_out_size
+  )
+{
+  EVP_CIPHER_CTX   *ctx;
+  int32            temp_out_size;
+  boolean          ret_value;
+
+  if (aead_context == NULL) {
+    return FALSE;
+  }
+  if (data_in_size > INT_MAX) {
+    return FALSE;
+  }
+  if (a_data_size > INT_MAX) {
+    return FALSE;
+  }
+  if (iv_size != 12) {
+    return FALSE;
+  }
+  if ((tag_size != 12) && (tag_size != 13) && (tag_size != 14) && (tag_size != 15) && (tag_size != 16)) {
+    return FALSE;
+  }
+  if (data_out_size != NULL) {
+    if ((*data_out_size > INT_MAX) || (*data_out_size < data_in_size)) {
+      return FALSE;
+    }
+  }
+
+  ctx = aead_context;
+  ret_value = (boolean) EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, 0);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_DecryptUpdate(ctx, NULL, &temp_out_size, a_data, (int32)a_data_size);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_DecryptUpdate(ctx, data_out, &temp_out_size, data_in, (int32)data_in_size);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, (int32)tag_size, (void *)tag);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  ret_value = (boolean) EVP_DecryptFinal_ex(ctx, data_out, &temp_out_size);
+  if (!ret_value) {
+    return ret_value;
+  }
+
+  if (data_out_size != NULL) {
+    *data_out_size = data_in_size;
+  }
+
+  return ret_value;
+}
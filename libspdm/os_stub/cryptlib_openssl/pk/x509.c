@@ -1298,6 +1298,68 @@ x509_compare_date_time (
   return (intn)ASN1_TIME_compare(date_time1, date_time2);
 }
 
+/**
+  Check whether the current time is within the validity period of a certificate.
+
+  The current time is checked the same way as x509_verify_cert checks it, so that
+  a cached verification result expires together with the certificate.
+  If x509_verify_cert does not check the time, then return TRUE.
+
+  @param[in]      from         notBefore Pointer to date_time object.
+  @param[in]      to           notAfter Pointer to date_time object.
+
+  @retval  TRUE   The current time is within the validity period, or the time is not checked.
+  @retval  FALSE  The certificate is expired or not yet valid.
+**/
+boolean
+x509_check_current_date_time (
+  IN    void   *from,
+  IN    void   *to
+  )
+{
+  //
+  // x509_verify_cert runs with X509_V_FLAG_NO_CHECK_TIME.
+  //
+  return TRUE;
+}
+
+/**
+  Copy a date_time object.
+
+  A date_time object may point into its own buffer, so it is copied with this function instead of copy_mem.
+
+  @param[in]      date_time           Pointer to the date_time object.
+  @param[in]      date_time_size      date_time object size.
+  @param[out]     new_date_time       Pointer to the buffer of the copy.
+  @param[in,out]  new_date_time_size  On input, the size of the buffer. On output, the date_time object size.
+
+  @retval  TRUE   The date_time object is copied.
+  @retval  FALSE  The buffer is too small.
+**/
+boolean
+x509_copy_date_time (
+  IN     void   *date_time,
+  IN     uintn  date_time_size,
+     OUT void   *new_date_time,
+  IN OUT uintn  *new_date_time_size
+  )
+{
+  if (date_time == NULL || new_date_time == NULL || new_date_time_size == NULL ||
+      date_time_size < sizeof (ASN1_TIME)) {
+    return FALSE;
+  }
+  if (*new_date_time_size < date_time_size) {
+    return FALSE;
+  }
+  *new_date_time_size = date_time_size;
+  copy_mem (new_date_time, date_time, date_time_size);
+  //
+  // The data of the ASN1_TIME follows the ASN1_TIME in the same buffer.
+  //
+  ((ASN1_TIME*)new_date_time)->data = (uint8 *)new_date_time + sizeof (ASN1_TIME);
+  return TRUE;
+}
+
 /**
   Retrieve the key usage from one X.509 certificate.
 
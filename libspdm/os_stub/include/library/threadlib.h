@@ -0,0 +1,214 @@
+/** @file
+  Provides thread, mutex, condition variable and fiber services.
+
+  The library is used by the SPDM libraries to move expensive work, such as
+  ephemeral key generation, off the message critical path.
+  The fibers let one thread drive the blocking SPDM flows of many devices.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __THREAD_LIB_H__
+#define __THREAD_LIB_H__
+
+/**
+  Entry point of a thread created by thread_create.
+
+  @param  context                      The context passed to thread_create.
+**/
+typedef
+void
+(*thread_start_func) (
+  IN void  *context
+  );
+
+/**
+  Create a thread and start it.
+
+  @param  start_func                   The entry point of the thread.
+  @param  context                      The context passed to the entry point.
+
+  @return Pointer to the thread handle, or NULL if the thread cannot be created.
+**/
+void *
+thread_create (
+  IN thread_start_func  start_func,
+  IN void               *context
+  );
+
+/**
+  Wait for a thread to exit and release the thread handle.
+
+  @param  thread                       Pointer to the thread handle.
+**/
+void
+thread_join (
+  IN void  *thread
+  );
+
+/**
+  Suspend the calling thread.
+
+  @param  microseconds                 The time to sleep in microseconds.
+**/
+void
+thread_sleep (
+  IN uint64  microseconds
+  );
+
+/**
+  Allocate and initialize a mutex.
+
+  @return Pointer to the mutex, or NULL if the mutex cannot be created.
+**/
+void *
+mutex_new (
+  void
+  );
+
+/**
+  Release a mutex.
+
+  @param  mutex                        Pointer to the mutex.
+**/
+void
+mutex_free (
+  IN void  *mutex
+  );
+
+/**
+  Acquire a mutex.
+
+  @param  mutex                        Pointer to the mutex.
+**/
+void
+mutex_lock (
+  IN void  *mutex
+  );
+
+/**
+  Release an acquired mutex.
+
+  @param  mutex                        Pointer to the mutex.
+**/
+void
+mutex_unlock (
+  IN void  *mutex
+  );
+
+/**
+  Allocate and initialize a condition variable.
+
+  @return Pointer to the condition variable, or NULL if it cannot be created.
+**/
+void *
+cond_new (
+  void
+  );
+
+/**
+  Release a condition variable.
+
+  @param  cond                         Pointer to the condition variable.
+**/
+void
+cond_free (
+  IN void  *cond
+  );
+
+/**
+  Atomically release the mutex and wait for the condition variable to be signaled.
+  The mutex is acquired again before return.
+
+  @param  cond                         Pointer to the condition variable.
+  @param  mutex                        Pointer to the mutex held by the caller.
+**/
+void
+cond_wait (
+  IN void  *cond,
+  IN void  *mutex
+  );
+
+/**
+  Wake up one thread waiting on the condition variable.
+
+  @param  cond                         Pointer to the condition variable.
+**/
+void
+cond_signal (
+  IN void  *cond
+  );
+
+/**
+  Wake up all threads waiting on the condition variable.
+
+  @param  cond                         Pointer to the condition variable.
+**/
+void
+cond_broadcast (
+  IN void  *cond
+  );
+
+/**
+  Entry point of a fiber created by fiber_new.
+
+  @param  context                      The context passed to fiber_new.
+**/
+typedef
+void
+(*fiber_start_func) (
+  IN void  *context
+  );
+
+/**
+  Create a fiber. The fiber does not run until fiber_resume is called.
+
+  @param  start_func                   The entry point of the fiber.
+  @param  context                      The context passed to the entry point.
+  @param  stack_size                   The size in bytes of the stack of the fiber.
+
+  @return Pointer to the fiber, or NULL if the fiber cannot be created.
+**/
+void *
+fiber_new (
+  IN fiber_start_func  start_func,
+  IN void              *context,
+  IN uintn             stack_size
+  );
+
+/**
+  Release a fiber. A fiber that is not finished is abandoned.
+
+  @param  fiber                        Pointer to the fiber.
+**/
+void
+fiber_free (
+  IN void  *fiber
+  );
+
+/**
+  Run a fiber on the calling thread until it calls fiber_yield or its entry point returns.
+
+  @param  fiber                        Pointer to the fiber.
+
+  @retval TRUE   The entry point of the fiber has returned.
+  @retval FALSE  The fiber has yielded.
+**/
+boolean
+fiber_resume (
+  IN void  *fiber
+  );
+
+/**
+  Switch from the running fiber back to the caller of fiber_resume.
+
+  @param  fiber                        Pointer to the running fiber.
+**/
+void
+fiber_yield (
+  IN void  *fiber
+  );
+
+#endif  // __THREAD_LIB_H__
@@ -39,10 +39,36 @@ compare_mem (
 {
   volatile uint8  *PointerDst;
   volatile uint8  *PointerSrc;
+  volatile uintn  *WordDst;
+  volatile uintn  *WordSrc;
   intn            Delta;
 
   PointerDst = (uint8 *)destination_buffer;
   PointerSrc = (uint8 *)source_buffer;
+
+  //
+  // Skip the identical words. The first mismatched byte is found by the byte loop.
+  //
+  if ((((uintn)PointerDst ^ (uintn)PointerSrc) & (sizeof(uintn) - 1)) == 0) {
+    while ((((uintn)PointerDst & (sizeof(uintn) - 1)) != 0) && (length != 0)) {
+      if (*PointerDst != *PointerSrc) {
+        return *PointerDst - *PointerSrc;
+      }
+      PointerDst++;
+      PointerSrc++;
+      length--;
+    }
+    WordDst = (uintn *)PointerDst;
+    WordSrc = (uintn *)PointerSrc;
+    while ((length >= sizeof(uintn)) && (*WordDst == *WordSrc)) {
+      WordDst++;
+      WordSrc++;
+      length -= sizeof(uintn);
+    }
+    PointerDst = (uint8 *)WordDst;
+    PointerSrc = (uint8 *)WordSrc;
+  }
+
   Delta = 0;
   while ((length-- != 0) && (Delta == 0)) {
     Delta = *(PointerDst++) - *(PointerSrc++);
@@ -0,0 +1,50 @@
+/** @file
+  const_compare_mem() implementation.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "base.h"
+
+/**
+  Compares the contents of two buffers in constant time.
+
+  This function compares length bytes of source_buffer to length bytes of destination_buffer.
+  The execution time only depends on length, not on the contents of the buffers.
+  It must be used to compare secret data, such as HMAC or verify data.
+
+  If length > 0 and destination_buffer is NULL, then ASSERT().
+  If length > 0 and source_buffer is NULL, then ASSERT().
+  If length is greater than (MAX_ADDRESS - destination_buffer + 1), then ASSERT().
+  If length is greater than (MAX_ADDRESS - source_buffer + 1), then ASSERT().
+
+  @param  destination_buffer A pointer to the destination buffer to compare.
+  @param  source_buffer      A pointer to the source buffer to compare.
+  @param  length            The number of bytes to compare.
+
+  @return 0                 All length bytes of the two buffers are identical.
+  @retval 1                 The two buffers are different.
+
+**/
+intn
+const_compare_mem (
+  IN const void  *destination_buffer,
+  IN const void  *source_buffer,
+  IN uintn       length
+  )
+{
+  volatile uint8  *PointerDst;
+  volatile uint8  *PointerSrc;
+  uint8           Delta;
+
+  PointerDst = (uint8 *)destination_buffer;
+  PointerSrc = (uint8 *)source_buffer;
+  Delta = 0;
+  while (length-- != 0) {
+    Delta |= *(PointerDst++) ^ *(PointerSrc++);
+  }
+
+  return (intn)((((uint32)Delta) + 0xFF) >> 8);
+}
@@ -34,11 +34,82 @@ copy_mem (
 {
   volatile uint8  *PointerDst;
   volatile uint8  *PointerSrc;
+  volatile uintn  *WordDst;
+  volatile uintn  *WordSrc;
 
   PointerDst = (uint8 *)destination_buffer;
   PointerSrc = (uint8 *)source_buffer;
-  while (length-- != 0) {
-    *(PointerDst++) = *(PointerSrc++);
+  if ((length == 0) || (PointerDst == PointerSrc)) {
+    return destination_buffer;
+  }
+
+  //
+  // The word loops are only used if both buffers can be aligned at the same time.
+  // The accesses are volatile, so that the compiler does not replace the loops with
+  // a call to memcpy(), which may be implemented with copy_mem() itself.
+  //
+  if ((PointerDst < PointerSrc) || (PointerDst >= PointerSrc + length)) {
+    //
+    // Copy forward.
+    //
+    if ((((uintn)PointerDst ^ (uintn)PointerSrc) & (sizeof(uintn) - 1)) == 0) {
+      while ((((uintn)PointerDst & (sizeof(uintn) - 1)) != 0) && (length != 0)) {
+        *(PointerDst++) = *(PointerSrc++);
+        length--;
+      }
+      WordDst = (uintn *)PointerDst;
+      WordSrc = (uintn *)PointerSrc;
+      while (length >= 4 * sizeof(uintn)) {
+        WordDst[0] = WordSrc[0];
+        WordDst[1] = WordSrc[1];
+        WordDst[2] = WordSrc[2];
+        WordDst[3] = WordSrc[3];
+        WordDst += 4;
+        WordSrc += 4;
+        length -= 4 * sizeof(uintn);
+      }
+      while (length >= sizeof(uintn)) {
+        *(WordDst++) = *(WordSrc++);
+        length -= sizeof(uintn);
+      }
+      PointerDst = (uint8 *)WordDst;
+      PointerSrc = (uint8 *)WordSrc;
+    }
+    while (length-- != 0) {
+      *(PointerDst++) = *(PointerSrc++);
+    }
+  } else {
+    //
+    // The destination overlaps the end of the source. Copy backward.
+    //
+    PointerDst += length;
+    PointerSrc += length;
+    if ((((uintn)PointerDst ^ (uintn)PointerSrc) & (sizeof(uintn) - 1)) == 0) {
+      while ((((uintn)PointerDst & (sizeof(uintn) - 1)) != 0) && (length != 0)) {
+        *(--PointerDst) = *(--PointerSrc);
+        length--;
+      }
+      WordDst = (uintn *)PointerDst;
+      WordSrc = (uintn *)PointerSrc;
+      while (length >= 4 * sizeof(uintn)) {
+        WordDst -= 4;
+        WordSrc -= 4;
+        WordDst[3] = WordSrc[3];
+        WordDst[2] = WordSrc[2];
+        WordDst[1] = WordSrc[1];
+        WordDst[0] = WordSrc[0];
+        length -= 4 * sizeof(uintn);
+      }
+      while (length >= sizeof(uintn)) {
+        *(--WordDst) = *(--WordSrc);
+        length -= sizeof(uintn);
+      }
+      PointerDst = (uint8 *)WordDst;
+      PointerSrc = (uint8 *)WordSrc;
+    }
+    while (length-- != 0) {
+      *(--PointerDst) = *(--PointerSrc);
+    }
   }
 
   return destination_buffer;
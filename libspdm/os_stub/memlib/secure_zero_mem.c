@@ -0,0 +1,41 @@
+/** @file
+  secure_zero_mem() implementation.
+
+  Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "base.h"
+
+/**
+  Fills a target buffer with zeros, and returns the target buffer.
+
+  Unlike zero_mem(), the stores are guaranteed not to be removed by the compiler,
+  even if the buffer is not accessed afterwards.
+  It must be used to clear secret data, such as keys and shared secrets.
+
+  If length > 0 and buffer is NULL, then ASSERT().
+  If length is greater than (MAX_ADDRESS - buffer + 1), then ASSERT().
+
+  @param  buffer      The pointer to the target buffer to fill with zeros.
+  @param  length      The number of bytes in buffer to fill with zeros.
+
+  @return buffer.
+
+**/
+void *
+secure_zero_mem (
+  OUT void  *buffer,
+  IN uintn  length
+  )
+{
+  volatile uint8  *Pointer;
+
+  Pointer = (uint8 *)buffer;
+  while (length-- != 0) {
+    *(Pointer++) = 0;
+  }
+
+  return buffer;
+}
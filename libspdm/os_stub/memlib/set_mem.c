@@ -29,8 +29,35 @@ set_mem (
   )
 {
   volatile uint8  *Pointer;
+  volatile uintn  *WordPointer;
+  uintn           WordValue;
 
   Pointer = (uint8 *)buffer;
+  while ((((uintn)Pointer & (sizeof(uintn) - 1)) != 0) && (length != 0)) {
+    *(Pointer++) = value;
+    length--;
+  }
+
+  //
+  // The accesses are volatile, so that the compiler does not replace the loops with
+  // a call to memset(), which may be implemented with set_mem() itself.
+  //
+  WordValue = ((uintn)-1 / 0xFF) * value;
+  WordPointer = (uintn *)Pointer;
+  while (length >= 4 * sizeof(uintn)) {
+    WordPointer[0] = WordValue;
+    WordPointer[1] = WordValue;
+    WordPointer[2] = WordValue;
+    WordPointer[3] = WordValue;
+    WordPointer += 4;
+    length -= 4 * sizeof(uintn);
+  }
+  while (length >= sizeof(uintn)) {
+    *(WordPointer++) = WordValue;
+    length -= sizeof(uintn);
+  }
+
+  Pointer = (uint8 *)WordPointer;
   while (length-- != 0) {
     *(Pointer++) = value;
   }
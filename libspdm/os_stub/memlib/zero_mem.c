@@ -7,6 +7,7 @@
 **/
 
 #include "base.h"
+#include <library/memlib.h>
 
 /**
   Fills a target buffer with zeros, and returns the target buffer.
@@ -28,12 +29,5 @@ zero_mem (
   IN uintn  length
   )
 {
-  volatile uint8  *Pointer;
-
-  Pointer = (uint8 *)buffer;
-  while (length-- != 0) {
-    *(Pointer++) = 0;
-  }
-
-  return buffer;
+  return set_mem (buffer, length, 0);
 }
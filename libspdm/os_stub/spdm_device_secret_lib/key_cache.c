@@ -0,0 +1,399 @@
+/** @file
+  Signing key cache of the SPDM device secret library.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#undef NULL
+#include <base.h>
+#include <library/memlib.h>
+#include "spdm_device_secret_lib_internal.h"
+
+//
+// The signing key cache keeps the parsed private key contexts, so that the key file is
+// read and parsed once, instead of once per signature.
+//
+// Each key may have up to MAX_SIGNING_KEY_CONTEXT_COUNT contexts. A context is used
+// by one signer at a time, so concurrent signers never share a crypto context.
+//
+typedef struct {
+  boolean     valid;
+  uint8       key_type;
+  boolean     is_requester;
+  uint32      base_asym_algo;
+  pqc_algo_t  pqc_sig_algo;
+  void        *context[MAX_SIGNING_KEY_CONTEXT_COUNT];
+  boolean     context_in_use[MAX_SIGNING_KEY_CONTEXT_COUNT];
+} signing_key_cache_entry_t;
+
+signing_key_cache_entry_t  m_signing_key_cache[MAX_SIGNING_KEY_CACHE_ENTRY_COUNT];
+
+//
+// The cache table is protected by a spin lock instead of a threadlib mutex: this library has no
+// init or deinit function to create the mutex, and it is linked into targets without threadlib.
+// The lock is only held to scan and update the table, never across file I/O or key parsing, so
+// a waiter spins for a few hundred instructions at most.
+//
+#if defined(_MSC_VER)
+volatile long   m_signing_key_cache_lock;
+#else
+volatile uintn  m_signing_key_cache_lock;
+#endif
+
+static
+void
+signing_key_cache_lock (
+  void
+  )
+{
+#if defined(_MSC_VER)
+  while (_InterlockedExchange (&m_signing_key_cache_lock, 1) != 0) {
+  }
+#else
+  while (__sync_lock_test_and_set (&m_signing_key_cache_lock, 1) != 0) {
+  }
+#endif
+}
+
+static
+void
+signing_key_cache_unlock (
+  void
+  )
+{
+#if defined(_MSC_VER)
+  _InterlockedExchange (&m_signing_key_cache_lock, 0);
+#else
+  __sync_lock_release (&m_signing_key_cache_lock);
+#endif
+}
+
+/**
+  Read the private key of the signing key and parse it into a context.
+
+  The raw key data is zeroized after it is parsed.
+**/
+static
+boolean
+spdm_load_signing_key (
+  IN  uint8       key_type,
+  IN  boolean     is_requester,
+  IN  uint32      base_asym_algo,
+  IN  pqc_algo_t  pqc_sig_algo,
+  OUT void        **context
+  )
+{
+  void                          *private_key;
+  uintn                         private_key_size;
+  boolean                       result;
+
+  switch (key_type) {
+  case SIGNING_KEY_TYPE_ASYM:
+    if (is_requester) {
+      result = read_requester_private_certificate ((uint16)base_asym_algo, &private_key, &private_key_size);
+    } else {
+      result = read_responder_private_certificate (base_asym_algo, &private_key, &private_key_size);
+    }
+    if (!result) {
+      return FALSE;
+    }
+    if (is_requester) {
+      result = spdm_req_asym_get_private_key_from_pem ((uint16)base_asym_algo, private_key, private_key_size, NULL, context);
+    } else {
+      result = spdm_asym_get_private_key_from_pem (base_asym_algo, private_key, private_key_size, NULL, context);
+    }
+    break;
+  case SIGNING_KEY_TYPE_PQC_SIG:
+    if (is_requester) {
+      result = read_requester_pqc_private_key (pqc_sig_algo, &private_key, &private_key_size);
+    } else {
+      result = read_responder_pqc_private_key (pqc_sig_algo, &private_key, &private_key_size);
+    }
+    if (!result) {
+      return FALSE;
+    }
+    if (is_requester) {
+      result = spdm_pqc_req_sig_set_private_key (pqc_sig_algo, private_key, private_key_size, context);
+    } else {
+      result = spdm_pqc_sig_set_private_key (pqc_sig_algo, private_key, private_key_size, context);
+    }
+    break;
+  case SIGNING_KEY_TYPE_HYBRID:
+    result = read_hybrid_private_certificate (base_asym_algo, pqc_sig_algo, &private_key, &private_key_size, is_requester);
+    if (!result) {
+      return FALSE;
+    }
+    result = spdm_hybrid_get_private_key_from_pem (private_key, private_key_size, NULL, context);
+    break;
+  default:
+    ASSERT (FALSE);
+    return FALSE;
+  }
+
+  zero_mem (private_key, private_key_size);
+  free (private_key);
+
+  return result;
+}
+
+/**
+  Free a signing key context.
+**/
+static
+void
+spdm_free_signing_key (
+  IN  uint8       key_type,
+  IN  boolean     is_requester,
+  IN  uint32      base_asym_algo,
+  IN  pqc_algo_t  pqc_sig_algo,
+  IN  void        *context
+  )
+{
+  switch (key_type) {
+  case SIGNING_KEY_TYPE_ASYM:
+    if (is_requester) {
+      spdm_req_asym_free ((uint16)base_asym_algo, context);
+    } else {
+      spdm_asym_free (base_asym_algo, context);
+    }
+    break;
+  case SIGNING_KEY_TYPE_PQC_SIG:
+    if (is_requester) {
+      spdm_pqc_req_sig_free (pqc_sig_algo, context);
+    } else {
+      spdm_pqc_sig_free (pqc_sig_algo, context);
+    }
+    break;
+  case SIGNING_KEY_TYPE_HYBRID:
+    spdm_hybrid_sig_free (context);
+    break;
+  default:
+    ASSERT (FALSE);
+    break;
+  }
+}
+
+/**
+  Check if the cache entry holds the signing key.
+**/
+static
+boolean
+spdm_signing_key_cache_entry_match (
+  IN  signing_key_cache_entry_t  *entry,
+  IN  uint8       key_type,
+  IN  boolean     is_requester,
+  IN  uint32      base_asym_algo,
+  IN  pqc_algo_t  pqc_sig_algo
+  )
+{
+  if (!entry->valid ||
+      (entry->key_type != key_type) ||
+      (entry->is_requester != is_requester)) {
+    return FALSE;
+  }
+  if ((key_type != SIGNING_KEY_TYPE_PQC_SIG) &&
+      (entry->base_asym_algo != base_asym_algo)) {
+    return FALSE;
+  }
+  if ((key_type != SIGNING_KEY_TYPE_ASYM) &&
+      (compare_mem (entry->pqc_sig_algo, pqc_sig_algo, sizeof(pqc_algo_t)) != 0)) {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+  Acquire a private key context for signing.
+
+  The context is taken from the signing key cache. If no cached context is free,
+  the private key is loaded and the new context is added to the cache.
+  The context must be returned by spdm_release_signing_key.
+
+  @param  key_type                      The type of the signing key (SIGNING_KEY_TYPE_*).
+  @param  is_requester                  Indicate if the key is the requester key.
+  @param  base_asym_algo                 Indicates the traditional signing algorithm. Ignored for PQC key.
+  @param  pqc_sig_algo                   Indicates the PQC signing algorithm. Ignored for traditional key.
+  @param  context                       The private key context.
+
+  @retval TRUE  the private key context is acquired.
+  @retval FALSE the private key cannot be loaded.
+**/
+boolean
+spdm_acquire_signing_key (
+  IN  uint8       key_type,
+  IN  boolean     is_requester,
+  IN  uint32      base_asym_algo,
+  IN  pqc_algo_t  pqc_sig_algo,
+  OUT void        **context
+  )
+{
+  signing_key_cache_entry_t     *entry;
+  signing_key_cache_entry_t     *free_entry;
+  uintn                         index;
+  uintn                         context_index;
+  boolean                       result;
+
+  signing_key_cache_lock ();
+  for (index = 0; index < MAX_SIGNING_KEY_CACHE_ENTRY_COUNT; index++) {
+    entry = &m_signing_key_cache[index];
+    if (!spdm_signing_key_cache_entry_match (entry, key_type, is_requester, base_asym_algo, pqc_sig_algo)) {
+      continue;
+    }
+    for (context_index = 0; context_index < MAX_SIGNING_KEY_CONTEXT_COUNT; context_index++) {
+      if ((entry->context[context_index] != NULL) && !entry->context_in_use[context_index]) {
+        entry->context_in_use[context_index] = TRUE;
+        *context = entry->context[context_index];
+        signing_key_cache_unlock ();
+        return TRUE;
+      }
+    }
+    break;
+  }
+  signing_key_cache_unlock ();
+
+  //
+  // Load the key outside of the lock, because it involves file I/O and parsing.
+  //
+  result = spdm_load_signing_key (key_type, is_requester, base_asym_algo, pqc_sig_algo, context);
+  if (!result) {
+    return FALSE;
+  }
+
+  signing_key_cache_lock ();
+  free_entry = NULL;
+  for (index = 0; index < MAX_SIGNING_KEY_CACHE_ENTRY_COUNT; index++) {
+    entry = &m_signing_key_cache[index];
+    if (!entry->valid) {
+      if (free_entry == NULL) {
+        free_entry = entry;
+      }
+      continue;
+    }
+    if (spdm_signing_key_cache_entry_match (entry, key_type, is_requester, base_asym_algo, pqc_sig_algo)) {
+      free_entry = entry;
+      break;
+    }
+  }
+  if (free_entry != NULL) {
+    entry = free_entry;
+    if (!entry->valid) {
+      zero_mem (entry, sizeof(*entry));
+      entry->valid = TRUE;
+      entry->key_type = key_type;
+      entry->is_requester = is_requester;
+      entry->base_asym_algo = base_asym_algo;
+      if (key_type != SIGNING_KEY_TYPE_ASYM) {
+        copy_mem (entry->pqc_sig_algo, pqc_sig_algo, sizeof(pqc_algo_t));
+      }
+    }
+    for (context_index = 0; context_index < MAX_SIGNING_KEY_CONTEXT_COUNT; context_index++) {
+      if (entry->context[context_index] == NULL) {
+        entry->context[context_index] = *context;
+        entry->context_in_use[context_index] = TRUE;
+        break;
+      }
+    }
+  }
+  signing_key_cache_unlock ();
+
+  //
+  // If the cache is full, the context is not cached and it is freed on release.
+  //
+  return TRUE;
+}
+
+/**
+  Release a private key context acquired by spdm_acquire_signing_key.
+
+  @param  key_type                      The type of the signing key (SIGNING_KEY_TYPE_*).
+  @param  is_requester                  Indicate if the key is the requester key.
+  @param  base_asym_algo                 Indicates the traditional signing algorithm. Ignored for PQC key.
+  @param  pqc_sig_algo                   Indicates the PQC signing algorithm. Ignored for traditional key.
+  @param  context                       The private key context.
+**/
+void
+spdm_release_signing_key (
+  IN  uint8       key_type,
+  IN  boolean     is_requester,
+  IN  uint32      base_asym_algo,
+  IN  pqc_algo_t  pqc_sig_algo,
+  IN  void        *context
+  )
+{
+  signing_key_cache_entry_t     *entry;
+  uintn                         index;
+  uintn                         context_index;
+
+  signing_key_cache_lock ();
+  for (index = 0; index < MAX_SIGNING_KEY_CACHE_ENTRY_COUNT; index++) {
+    entry = &m_signing_key_cache[index];
+    if (!entry->valid) {
+      continue;
+    }
+    for (context_index = 0; context_index < MAX_SIGNING_KEY_CONTEXT_COUNT; context_index++) {
+      if (entry->context[context_index] == context) {
+        ASSERT (entry->context_in_use[context_index]);
+        entry->context_in_use[context_index] = FALSE;
+        signing_key_cache_unlock ();
+        return;
+      }
+    }
+  }
+  signing_key_cache_unlock ();
+
+  spdm_free_signing_key (key_type, is_requester, base_asym_algo, pqc_sig_algo, context);
+}
+
+/**
+  Free all cached signing key contexts.
+
+  The contexts which are in use stay in the cache.
+**/
+void
+spdm_clear_signing_key_cache (
+  void
+  )
+{
+  signing_key_cache_entry_t     *entry;
+  uintn                         index;
+  uintn                         context_index;
+  boolean                       in_use;
+
+  signing_key_cache_lock ();
+  for (index = 0; index < MAX_SIGNING_KEY_CACHE_ENTRY_COUNT; index++) {
+    entry = &m_signing_key_cache[index];
+    if (!entry->valid) {
+      continue;
+    }
+    in_use = FALSE;
+    for (context_index = 0; context_index < MAX_SIGNING_KEY_CONTEXT_COUNT; context_index++) {
+      if (entry->context[context_index] == NULL) {
+        continue;
+      }
+      if (entry->context_in_use[context_index]) {
+        in_use = TRUE;
+        continue;
+      }
+      spdm_free_signing_key (entry->key_type, entry->is_requester, entry->base_asym_algo, entry->pqc_sig_algo, entry->context[context_index]);
+      entry->context[context_index] = NULL;
+    }
+    if (!in_use) {
+      entry->valid = FALSE;
+    }
+  }
+  signing_key_cache_unlock ();
+}
\ No newline at end of file
@@ -170,12 +170,12 @@ spdm_measurement_collection (
 }
 
 /**
-  Sign an SPDM message data.
+  Sign an SPDM message data given as a list of segments.
 
   @param  req_base_asym_alg               Indicates the signing algorithm.
   @param  bash_hash_algo                 Indicates the hash algorithm.
-  @param  message                      A pointer to a message to be signed (before hash).
-  @param  message_size                  The size in bytes of the message to be signed.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
   @param  signature                    A pointer to a destination buffer to store the signature.
   @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
                                        On output, indicates the size in bytes of the signature in the buffer.
@@ -184,40 +184,32 @@ spdm_measurement_collection (
   @retval FALSE signing fail.
 **/
 boolean
-spdm_requester_data_sign (
+spdm_requester_data_sign_segments (
   IN      uint16       req_base_asym_alg,
   IN      uint32       bash_hash_algo,
-  IN      const uint8  *message,
-  IN      uintn        message_size,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
   OUT     uint8        *signature,
   IN OUT  uintn        *sig_size
   )
 {
   void                          *context;
-  void                          *private_pem;
-  uintn                         private_pem_size;
   boolean                       result;
 
-  result = read_requester_private_certificate (req_base_asym_alg, &private_pem, &private_pem_size);
+  result = spdm_acquire_signing_key (SIGNING_KEY_TYPE_ASYM, TRUE, req_base_asym_alg, NULL, &context);
   if (!result) {
     return FALSE;
   }
-
-  result = spdm_req_asym_get_private_key_from_pem (req_base_asym_alg, private_pem, private_pem_size, NULL, &context);
-  if (!result) {
-    return FALSE;
-  }
-  result = spdm_req_asym_sign (
+  result = spdm_req_asym_sign_segments (
              req_base_asym_alg,
              bash_hash_algo,
              context,
-             message,
-             message_size,
+             segment,
+             segment_count,
              signature,
              sig_size
              );
-  spdm_req_asym_free (req_base_asym_alg, context);
-  free (private_pem);
+  spdm_release_signing_key (SIGNING_KEY_TYPE_ASYM, TRUE, req_base_asym_alg, NULL, context);
 
   return result;
 }
@@ -225,7 +217,7 @@ spdm_requester_data_sign (
 /**
   Sign an SPDM message data.
 
-  @param  base_asym_algo                 Indicates the signing algorithm.
+  @param  req_base_asym_alg               Indicates the signing algorithm.
   @param  bash_hash_algo                 Indicates the hash algorithm.
   @param  message                      A pointer to a message to be signed (before hash).
   @param  message_size                  The size in bytes of the message to be signed.
@@ -237,44 +229,98 @@ spdm_requester_data_sign (
   @retval FALSE signing fail.
 **/
 boolean
-spdm_responder_data_sign (
-  IN      uint32       base_asym_algo,
+spdm_requester_data_sign (
+  IN      uint16       req_base_asym_alg,
   IN      uint32       bash_hash_algo,
   IN      const uint8  *message,
   IN      uintn        message_size,
   OUT     uint8        *signature,
   IN OUT  uintn        *sig_size
   )
+{
+  spdm_data_segment_t   segment;
+
+  segment.data = message;
+  segment.size = message_size;
+  return spdm_requester_data_sign_segments (req_base_asym_alg, bash_hash_algo, &segment, 1, signature, sig_size);
+}
+
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  base_asym_algo                 Indicates the signing algorithm.
+  @param  bash_hash_algo                 Indicates the hash algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_responder_data_sign_segments (
+  IN      uint32       base_asym_algo,
+  IN      uint32       bash_hash_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
 {
   void                          *context;
-  void                          *private_pem;
-  uintn                         private_pem_size;
   boolean                       result;
 
-  result = read_responder_private_certificate (base_asym_algo, &private_pem, &private_pem_size);
-  if (!result) {
-    return FALSE;
-  }
-
-  result = spdm_asym_get_private_key_from_pem (base_asym_algo, private_pem, private_pem_size, NULL, &context);
+  result = spdm_acquire_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, &context);
   if (!result) {
     return FALSE;
   }
-  result = spdm_asym_sign (
+  result = spdm_asym_sign_segments (
              base_asym_algo,
              bash_hash_algo,
              context,
-             message,
-             message_size,
+             segment,
+             segment_count,
              signature,
              sig_size
              );
-  spdm_asym_free (base_asym_algo, context);
-  free (private_pem);
+  spdm_release_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, context);
 
   return result;
 }
 
+/**
+  Sign an SPDM message data.
+
+  @param  base_asym_algo                 Indicates the signing algorithm.
+  @param  bash_hash_algo                 Indicates the hash algorithm.
+  @param  message                      A pointer to a message to be signed (before hash).
+  @param  message_size                  The size in bytes of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_responder_data_sign (
+  IN      uint32       base_asym_algo,
+  IN      uint32       bash_hash_algo,
+  IN      const uint8  *message,
+  IN      uintn        message_size,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  spdm_data_segment_t   segment;
+
+  segment.data = message;
+  segment.size = message_size;
+  return spdm_responder_data_sign_segments (base_asym_algo, bash_hash_algo, &segment, 1, signature, sig_size);
+}
+
 uint8  m_my_zero_filled_buffer[64];
 uint8  m_bin_str0[0x11] = {
        0x00, 0x00, // length - to be filled
@@ -459,11 +505,11 @@ read_requester_pqc_private_key (
 }
 
 /**
-  Sign an SPDM message data.
+  Sign an SPDM message data given as a list of segments.
 
   @param  pqc_req_sig_algo               Indicates the signing algorithm.
-  @param  message                      A pointer to a message to be signed (before hash).
-  @param  message_size                  The size in bytes of the message to be signed.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
   @param  signature                    A pointer to a destination buffer to store the signature.
   @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
                                        On output, indicates the size in bytes of the signature in the buffer.
@@ -472,39 +518,30 @@ read_requester_pqc_private_key (
   @retval FALSE signing fail.
 **/
 boolean
-spdm_pqc_requester_data_sign (
+spdm_pqc_requester_data_sign_segments (
   IN      pqc_algo_t   pqc_req_sig_algo,
-  IN      const uint8  *message,
-  IN      uintn        message_size,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
   OUT     uint8        *signature,
   IN OUT  uintn        *sig_size
   )
 {
   void                          *context;
-  void                          *private_key;
-  uintn                         private_key_size;
   boolean                       result;
 
-  result = read_requester_pqc_private_key (pqc_req_sig_algo, &private_key, &private_key_size);
-  if (!result) {
-    return FALSE;
-  }
-
-  result = spdm_pqc_req_sig_set_private_key (pqc_req_sig_algo, private_key, private_key_size, &context);
+  result = spdm_acquire_signing_key (SIGNING_KEY_TYPE_PQC_SIG, TRUE, 0, pqc_req_sig_algo, &context);
   if (!result) {
     return FALSE;
   }
-  result = spdm_pqc_req_sig_sign (
+  result = spdm_pqc_req_sig_sign_segments (
              pqc_req_sig_algo,
              context,
-             message,
-             message_size,
+             segment,
+             segment_count,
              signature,
              sig_size
              );
-  spdm_pqc_req_sig_free (pqc_req_sig_algo, context);
-  zero_mem (private_key, private_key_size);
-  free (private_key);
+  spdm_release_signing_key (SIGNING_KEY_TYPE_PQC_SIG, TRUE, 0, pqc_req_sig_algo, context);
 
   return result;
 }
@@ -512,7 +549,7 @@ spdm_pqc_requester_data_sign (
 /**
   Sign an SPDM message data.
 
-  @param  pqc_sig_algo                 Indicates the signing algorithm.
+  @param  pqc_req_sig_algo               Indicates the signing algorithm.
   @param  message                      A pointer to a message to be signed (before hash).
   @param  message_size                  The size in bytes of the message to be signed.
   @param  signature                    A pointer to a destination buffer to store the signature.
@@ -523,43 +560,92 @@ spdm_pqc_requester_data_sign (
   @retval FALSE signing fail.
 **/
 boolean
-spdm_pqc_responder_data_sign (
-  IN      pqc_algo_t   pqc_sig_algo,
+spdm_pqc_requester_data_sign (
+  IN      pqc_algo_t   pqc_req_sig_algo,
   IN      const uint8  *message,
   IN      uintn        message_size,
   OUT     uint8        *signature,
   IN OUT  uintn        *sig_size
   )
+{
+  spdm_data_segment_t   segment;
+
+  segment.data = message;
+  segment.size = message_size;
+  return spdm_pqc_requester_data_sign_segments (pqc_req_sig_algo, &segment, 1, signature, sig_size);
+}
+
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  pqc_sig_algo                 Indicates the signing algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_pqc_responder_data_sign_segments (
+  IN      pqc_algo_t   pqc_sig_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
 {
   void                          *context;
-  void                          *private_key;
-  uintn                         private_key_size;
   boolean                       result;
 
-  result = read_responder_pqc_private_key (pqc_sig_algo, &private_key, &private_key_size);
+  result = spdm_acquire_signing_key (SIGNING_KEY_TYPE_PQC_SIG, FALSE, 0, pqc_sig_algo, &context);
   if (!result) {
     return FALSE;
   }
-
-  result = spdm_pqc_sig_set_private_key (pqc_sig_algo, private_key, private_key_size, &context);
-  if (!result) {
-    return FALSE;
-  }
-  result = spdm_pqc_sig_sign (
+  result = spdm_pqc_sig_sign_segments (
              pqc_sig_algo,
              context,
-             message,
-             message_size,
+             segment,
+             segment_count,
              signature,
              sig_size
              );
-  spdm_pqc_sig_free (pqc_sig_algo, context);
-  zero_mem (private_key, private_key_size);
-  free (private_key);
+  spdm_release_signing_key (SIGNING_KEY_TYPE_PQC_SIG, FALSE, 0, pqc_sig_algo, context);
 
   return result;
 }
 
+/**
+  Sign an SPDM message data.
+
+  @param  pqc_sig_algo                 Indicates the signing algorithm.
+  @param  message                      A pointer to a message to be signed (before hash).
+  @param  message_size                  The size in bytes of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_pqc_responder_data_sign (
+  IN      pqc_algo_t   pqc_sig_algo,
+  IN      const uint8  *message,
+  IN      uintn        message_size,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  spdm_data_segment_t   segment;
+
+  segment.data = message;
+  segment.size = message_size;
+  return spdm_pqc_responder_data_sign_segments (pqc_sig_algo, &segment, 1, signature, sig_size);
+}
+
 typedef struct {
   uint32  base_asym_algo;
   char8   *tradition_name;
@@ -688,12 +774,12 @@ read_hybrid_requester_private_certificate (
 }
 
 /**
-  Sign an SPDM message data.
+  Sign an SPDM message data given as a list of segments.
 
   @param  base_asym_algo                 Indicates the signing algorithm.
   @param  bash_hash_algo                 Indicates the hash algorithm.
-  @param  message                      A pointer to a message to be signed (before hash).
-  @param  message_size                  The size in bytes of the message to be signed.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
   @param  signature                    A pointer to a destination buffer to store the signature.
   @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
                                        On output, indicates the size in bytes of the signature in the buffer.
@@ -706,40 +792,60 @@ spdm_hybrid_data_sign (
   IN      uint32       base_asym_algo,
   IN      uint32       bash_hash_algo,
   IN      pqc_algo_t  pqc_sig_algo,
-  IN      const uint8  *message,
-  IN      uintn        message_size,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
   OUT     uint8        *signature,
   IN OUT  uintn        *sig_size,
   IN      boolean      is_requester
   )
 {
   void                          *context;
-  void                          *private_pem;
-  uintn                         private_pem_size;
   boolean                       result;
 
-  result = read_hybrid_private_certificate (base_asym_algo, pqc_sig_algo, &private_pem, &private_pem_size, is_requester);
-  if (!result) {
-    return FALSE;
-  }
-
-  result = spdm_hybrid_get_private_key_from_pem (private_pem, private_pem_size, NULL, &context);
+  result = spdm_acquire_signing_key (SIGNING_KEY_TYPE_HYBRID, is_requester, base_asym_algo, pqc_sig_algo, &context);
   if (!result) {
     return FALSE;
   }
-  result = spdm_hybrid_sig_sign (
+  result = spdm_hybrid_sig_sign_segments (
              context,
-             message,
-             message_size,
+             segment,
+             segment_count,
              signature,
              sig_size
              );
-  spdm_hybrid_sig_free (context);
-  free (private_pem);
+  spdm_release_signing_key (SIGNING_KEY_TYPE_HYBRID, is_requester, base_asym_algo, pqc_sig_algo, context);
 
   return result;
 }
 
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  req_base_asym_alg               Indicates the signing algorithm.
+  @param  bash_hash_algo                 Indicates the hash algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_hybrid_requester_data_sign_segments (
+  IN      uint16       req_base_asym_alg,
+  IN      uint32       bash_hash_algo,
+  IN      pqc_algo_t  pqc_sig_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  return spdm_hybrid_data_sign (req_base_asym_alg, bash_hash_algo, pqc_sig_algo, segment, segment_count, signature, sig_size, TRUE);
+}
+
 /**
   Sign an SPDM message data.
 
@@ -765,7 +871,39 @@ spdm_hybrid_requester_data_sign (
   IN OUT  uintn        *sig_size
   )
 {
-  return spdm_hybrid_data_sign (req_base_asym_alg, bash_hash_algo, pqc_sig_algo, message, message_size, signature, sig_size, TRUE);
+  spdm_data_segment_t   segment;
+
+  segment.data = message;
+  segment.size = message_size;
+  return spdm_hybrid_requester_data_sign_segments (req_base_asym_alg, bash_hash_algo, pqc_sig_algo, &segment, 1, signature, sig_size);
+}
+
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  base_asym_algo                 Indicates the signing algorithm.
+  @param  bash_hash_algo                 Indicates the hash algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_hybrid_responder_data_sign_segments (
+  IN      uint32       base_asym_algo,
+  IN      uint32       bash_hash_algo,
+  IN      pqc_algo_t  pqc_sig_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  return spdm_hybrid_data_sign (base_asym_algo, bash_hash_algo, pqc_sig_algo, segment, segment_count, signature, sig_size, FALSE);
 }
 
 /**
@@ -793,6 +931,10 @@ spdm_hybrid_responder_data_sign (
   IN OUT  uintn        *sig_size
   )
 {
-  return spdm_hybrid_data_sign (base_asym_algo, bash_hash_algo, pqc_sig_algo, message, message_size, signature, sig_size, FALSE);
+  spdm_data_segment_t   segment;
+
+  segment.data = message;
+  segment.size = message_size;
+  return spdm_hybrid_responder_data_sign_segments (base_asym_algo, bash_hash_algo, pqc_sig_algo, &segment, 1, signature, sig_size);
 }
 
@@ -24,6 +24,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define TEST_CERT_MAXUINT16_LARGER 3
 #define TEST_CERT_SMALL 4
 
+#define MAX_SIGNING_KEY_CACHE_ENTRY_COUNT  16
+#define MAX_SIGNING_KEY_CONTEXT_COUNT      4
+
+#define SIGNING_KEY_TYPE_ASYM     0
+#define SIGNING_KEY_TYPE_PQC_SIG  1
+#define SIGNING_KEY_TYPE_HYBRID   2
+
 //
 // public cert
 //
@@ -163,6 +170,67 @@ get_hybrid_algo_pqc_name (
   IN  pqc_algo_t  pqc_sig_algo
   );
 
+//
+// private key
+//
+boolean
+read_responder_private_certificate (
+  IN  uint32  base_asym_algo,
+  OUT void    **data,
+  OUT uintn   *size
+  );
+
+boolean
+read_requester_private_certificate (
+  IN  uint16  req_base_asym_alg,
+  OUT void    **data,
+  OUT uintn   *size
+  );
+
+boolean
+read_responder_pqc_private_key (
+  IN  pqc_algo_t  pqc_sig_algo,
+  OUT void    **data,
+  OUT uintn   *size
+  );
+
+boolean
+read_requester_pqc_private_key (
+  IN  pqc_algo_t  pqc_sig_algo,
+  OUT void    **data,
+  OUT uintn   *size
+  );
+
+boolean
+read_hybrid_private_certificate (
+  IN  uint32  base_asym_algo,
+  IN  pqc_algo_t  pqc_sig_algo,
+  OUT void    **data,
+  OUT uintn   *size,
+  IN  boolean is_requester
+  );
+
+//
+// signing key cache
+//
+boolean
+spdm_acquire_signing_key (
+  IN  uint8       key_type,
+  IN  boolean     is_requester,
+  IN  uint32      base_asym_algo,
+  IN  pqc_algo_t  pqc_sig_algo,
+  OUT void        **context
+  );
+
+void
+spdm_release_signing_key (
+  IN  uint8       key_type,
+  IN  boolean     is_requester,
+  IN  uint32      base_asym_algo,
+  IN  pqc_algo_t  pqc_sig_algo,
+  IN  void        *context
+  );
+
 //
 // External
 //
@@ -63,6 +63,33 @@ spdm_requester_data_sign (
   return FALSE;
 }
 
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  req_base_asym_alg               Indicates the signing algorithm.
+  @param  bash_hash_algo                 Indicates the hash algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_requester_data_sign_segments (
+  IN      uint16       req_base_asym_alg,
+  IN      uint32       bash_hash_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  return FALSE;
+}
+
 /**
   Sign an SPDM message data.
 
@@ -90,6 +117,33 @@ spdm_responder_data_sign (
   return FALSE;
 }
 
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  base_asym_algo                 Indicates the signing algorithm.
+  @param  bash_hash_algo                 Indicates the hash algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_responder_data_sign_segments (
+  IN      uint32       base_asym_algo,
+  IN      uint32       bash_hash_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  return FALSE;
+}
+
 /**
   Derive HMAC-based Expand key Derivation Function (HKDF) Expand, based upon the negotiated HKDF algorithm.
 
@@ -171,6 +225,31 @@ spdm_pqc_requester_data_sign (
   return FALSE;
 }
 
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  pqc_req_sig_algo               Indicates the signing algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_pqc_requester_data_sign_segments (
+  IN      pqc_algo_t   pqc_req_sig_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  return FALSE;
+}
+
 /**
   Sign an SPDM message data.
 
@@ -196,6 +275,31 @@ spdm_pqc_responder_data_sign (
   return FALSE;
 }
 
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  pqc_sig_algo                 Indicates the signing algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_pqc_responder_data_sign_segments (
+  IN      pqc_algo_t   pqc_sig_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  return FALSE;
+}
+
 /**
   Sign an SPDM message data.
 
@@ -224,6 +328,34 @@ spdm_hybrid_requester_data_sign (
   return FALSE;
 }
 
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  req_base_asym_alg               Indicates the signing algorithm.
+  @param  bash_hash_algo                 Indicates the hash algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_hybrid_requester_data_sign_segments (
+  IN      uint16       req_base_asym_alg,
+  IN      uint32       bash_hash_algo,
+  IN      pqc_algo_t  pqc_sig_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  return FALSE;
+}
+
 /**
   Sign an SPDM message data.
 
@@ -251,3 +383,44 @@ spdm_hybrid_responder_data_sign (
 {
   return FALSE;
 }
+
+/**
+  Sign an SPDM message data given as a list of segments.
+
+  @param  base_asym_algo                 Indicates the signing algorithm.
+  @param  bash_hash_algo                 Indicates the hash algorithm.
+  @param  segment                       A pointer to the segments of the message to be signed (before hash).
+  @param  segment_count                  The number of segments of the message to be signed.
+  @param  signature                    A pointer to a destination buffer to store the signature.
+  @param  sig_size                      On input, indicates the size in bytes of the destination buffer to store the signature.
+                                       On output, indicates the size in bytes of the signature in the buffer.
+
+  @retval TRUE  signing success.
+  @retval FALSE signing fail.
+**/
+boolean
+spdm_hybrid_responder_data_sign_segments (
+  IN      uint32       base_asym_algo,
+  IN      uint32       bash_hash_algo,
+  IN      pqc_algo_t  pqc_sig_algo,
+  IN      const spdm_data_segment_t  *segment,
+  IN      uintn        segment_count,
+  OUT     uint8        *signature,
+  IN OUT  uintn        *sig_size
+  )
+{
+  return FALSE;
+}
+
+
+/**
+  Free the private key contexts cached by the signing functions.
+
+  The private keys are loaded again on the next signing.
+**/
+void
+spdm_clear_signing_key_cache (
+  void
+  )
+{
+}
\ No newline at end of file
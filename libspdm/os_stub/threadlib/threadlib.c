@@ -0,0 +1,517 @@
+/** @file
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdlib.h>
+#if defined(_MSC_VER)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <ucontext.h>
+#endif
+
+#undef NULL
+#include <base.h>
+#include <library/threadlib.h>
+
+typedef struct {
+#if defined(_MSC_VER)
+  HANDLE             handle;
+#else
+  pthread_t          handle;
+#endif
+  thread_start_func  start_func;
+  void               *context;
+} thread_info_t;
+
+typedef struct {
+#if defined(_MSC_VER)
+  LPVOID             handle;
+  LPVOID             caller;
+#else
+  ucontext_t         context;
+  ucontext_t         caller;
+  void               *stack;
+#endif
+  fiber_start_func   start_func;
+  void               *start_context;
+  boolean            finished;
+} fiber_info_t;
+
+#if defined(_MSC_VER)
+DWORD WINAPI
+thread_entry (
+  IN LPVOID  parameter
+  )
+{
+  thread_info_t  *thread_info;
+
+  thread_info = parameter;
+  thread_info->start_func (thread_info->context);
+  return 0;
+}
+#else
+void *
+thread_entry (
+  IN void  *parameter
+  )
+{
+  thread_info_t  *thread_info;
+
+  thread_info = parameter;
+  thread_info->start_func (thread_info->context);
+  return NULL;
+}
+#endif
+
+/**
+  Create a thread and start it.
+
+  @param  start_func                   The entry point of the thread.
+  @param  context                      The context passed to the entry point.
+
+  @return Pointer to the thread handle, or NULL if the thread cannot be created.
+**/
+void *
+thread_create (
+  IN thread_start_func  start_func,
+  IN void               *context
+  )
+{
+  thread_info_t  *thread_info;
+
+  thread_info = malloc (sizeof(thread_info_t));
+  if (thread_info == NULL) {
+    return NULL;
+  }
+  thread_info->start_func = start_func;
+  thread_info->context = context;
+#if defined(_MSC_VER)
+  thread_info->handle = CreateThread (NULL, 0, thread_entry, thread_info, 0, NULL);
+  if (thread_info->handle == NULL) {
+    free (thread_info);
+    return NULL;
+  }
+#else
+  if (pthread_create (&thread_info->handle, NULL, thread_entry, thread_info) != 0) {
+    free (thread_info);
+    return NULL;
+  }
+#endif
+  return thread_info;
+}
+
+/**
+  Wait for a thread to exit and release the thread handle.
+
+  @param  thread                       Pointer to the thread handle.
+**/
+void
+thread_join (
+  IN void  *thread
+  )
+{
+  thread_info_t  *thread_info;
+
+  thread_info = thread;
+  if (thread_info == NULL) {
+    return ;
+  }
+#if defined(_MSC_VER)
+  WaitForSingleObject (thread_info->handle, INFINITE);
+  CloseHandle (thread_info->handle);
+#else
+  pthread_join (thread_info->handle, NULL);
+#endif
+  free (thread_info);
+}
+
+/**
+  Suspend the calling thread.
+
+  @param  microseconds                 The time to sleep in microseconds.
+**/
+void
+thread_sleep (
+  IN uint64  microseconds
+  )
+{
+#if defined(_MSC_VER)
+  Sleep ((DWORD)((microseconds + 999) / 1000));
+#else
+  struct timespec  time;
+
+  time.tv_sec = (time_t)(microseconds / 1000000);
+  time.tv_nsec = (long)(microseconds % 1000000) * 1000;
+  while ((nanosleep (&time, &time) != 0) && (errno == EINTR)) {
+  }
+#endif
+}
+
+/**
+  Allocate and initialize a mutex.
+
+  @return Pointer to the mutex, or NULL if the mutex cannot be created.
+**/
+void *
+mutex_new (
+  void
+  )
+{
+#if defined(_MSC_VER)
+  CRITICAL_SECTION  *mutex;
+
+  mutex = malloc (sizeof(CRITICAL_SECTION));
+  if (mutex == NULL) {
+    return NULL;
+  }
+  InitializeCriticalSection (mutex);
+#else
+  pthread_mutex_t   *mutex;
+
+  mutex = malloc (sizeof(pthread_mutex_t));
+  if (mutex == NULL) {
+    return NULL;
+  }
+  if (pthread_mutex_init (mutex, NULL) != 0) {
+    free (mutex);
+    return NULL;
+  }
+#endif
+  return mutex;
+}
+
+/**
+  Release a mutex.
+
+  @param  mutex                        Pointer to the mutex.
+**/
+void
+mutex_free (
+  IN void  *mutex
+  )
+{
+  if (mutex == NULL) {
+    return ;
+  }
+#if defined(_MSC_VER)
+  DeleteCriticalSection (mutex);
+#else
+  pthread_mutex_destroy (mutex);
+#endif
+  free (mutex);
+}
+
+/**
+  Acquire a mutex.
+
+  @param  mutex                        Pointer to the mutex.
+**/
+void
+mutex_lock (
+  IN void  *mutex
+  )
+{
+#if defined(_MSC_VER)
+  EnterCriticalSection (mutex);
+#else
+  pthread_mutex_lock (mutex);
+#endif
+}
+
+/**
+  Release an acquired mutex.
+
+  @param  mutex                        Pointer to the mutex.
+**/
+void
+mutex_unlock (
+  IN void  *mutex
+  )
+{
+#if defined(_MSC_VER)
+  LeaveCriticalSection (mutex);
+#else
+  pthread_mutex_unlock (mutex);
+#endif
+}
+
+/**
+  Allocate and initialize a condition variable.
+
+  @return Pointer to the condition variable, or NULL if it cannot be created.
+**/
+void *
+cond_new (
+  void
+  )
+{
+#if defined(_MSC_VER)
+  CONDITION_VARIABLE  *cond;
+
+  cond = malloc (sizeof(CONDITION_VARIABLE));
+  if (cond == NULL) {
+    return NULL;
+  }
+  InitializeConditionVariable (cond);
+#else
+  pthread_cond_t      *cond;
+
+  cond = malloc (sizeof(pthread_cond_t));
+  if (cond == NULL) {
+    return NULL;
+  }
+  if (pthread_cond_init (cond, NULL) != 0) {
+    free (cond);
+    return NULL;
+  }
+#endif
+  return cond;
+}
+
+/**
+  Release a condition variable.
+
+  @param  cond                         Pointer to the condition variable.
+**/
+void
+cond_free (
+  IN void  *cond
+  )
+{
+  if (cond == NULL) {
+    return ;
+  }
+#if !defined(_MSC_VER)
+  pthread_cond_destroy (cond);
+#endif
+  free (cond);
+}
+
+/**
+  Atomically release the mutex and wait for the condition variable to be signaled.
+  The mutex is acquired again before return.
+
+  @param  cond                         Pointer to the condition variable.
+  @param  mutex                        Pointer to the mutex held by the caller.
+**/
+void
+cond_wait (
+  IN void  *cond,
+  IN void  *mutex
+  )
+{
+#if defined(_MSC_VER)
+  SleepConditionVariableCS (cond, mutex, INFINITE);
+#else
+  pthread_cond_wait (cond, mutex);
+#endif
+}
+
+/**
+  Wake up one thread waiting on the condition variable.
+
+  @param  cond                         Pointer to the condition variable.
+**/
+void
+cond_signal (
+  IN void  *cond
+  )
+{
+#if defined(_MSC_VER)
+  WakeConditionVariable (cond);
+#else
+  pthread_cond_signal (cond);
+#endif
+}
+
+/**
+  Wake up all threads waiting on the condition variable.
+
+  @param  cond                         Pointer to the condition variable.
+**/
+void
+cond_broadcast (
+  IN void  *cond
+  )
+{
+#if defined(_MSC_VER)
+  WakeAllConditionVariable (cond);
+#else
+  pthread_cond_broadcast (cond);
+#endif
+}
+
+#if defined(_MSC_VER)
+VOID WINAPI
+fiber_entry (
+  IN LPVOID  parameter
+  )
+{
+  fiber_info_t  *fiber_info;
+
+  fiber_info = parameter;
+  fiber_info->start_func (fiber_info->start_context);
+  fiber_info->finished = TRUE;
+  //
+  // A fiber must not return. It is never resumed again.
+  //
+  SwitchToFiber (fiber_info->caller);
+}
+#else
+void
+fiber_entry (
+  IN unsigned int  parameter_high,
+  IN unsigned int  parameter_low
+  )
+{
+  fiber_info_t  *fiber_info;
+
+  //
+  // makecontext passes int arguments only.
+  //
+  fiber_info = (fiber_info_t *)(((((uintn)parameter_high) << 16) << 16) | (uintn)parameter_low);
+  fiber_info->start_func (fiber_info->start_context);
+  fiber_info->finished = TRUE;
+  //
+  // Return to uc_link, that is the caller of fiber_resume.
+  //
+}
+#endif
+
+/**
+  Create a fiber. The fiber does not run until fiber_resume is called.
+
+  @param  start_func                   The entry point of the fiber.
+  @param  context                      The context passed to the entry point.
+  @param  stack_size                   The size in bytes of the stack of the fiber.
+
+  @return Pointer to the fiber, or NULL if the fiber cannot be created.
+**/
+void *
+fiber_new (
+  IN fiber_start_func  start_func,
+  IN void              *context,
+  IN uintn             stack_size
+  )
+{
+  fiber_info_t  *fiber_info;
+
+  fiber_info = malloc (sizeof(fiber_info_t));
+  if (fiber_info == NULL) {
+    return NULL;
+  }
+  fiber_info->start_func = start_func;
+  fiber_info->start_context = context;
+  fiber_info->finished = FALSE;
+#if defined(_MSC_VER)
+  fiber_info->caller = NULL;
+  fiber_info->handle = CreateFiber (stack_size, fiber_entry, fiber_info);
+  if (fiber_info->handle == NULL) {
+    free (fiber_info);
+    return NULL;
+  }
+#else
+  fiber_info->stack = malloc (stack_size);
+  if (fiber_info->stack == NULL) {
+    free (fiber_info);
+    return NULL;
+  }
+  if (getcontext (&fiber_info->context) != 0) {
+    free (fiber_info->stack);
+    free (fiber_info);
+    return NULL;
+  }
+  fiber_info->context.uc_stack.ss_sp = fiber_info->stack;
+  fiber_info->context.uc_stack.ss_size = stack_size;
+  fiber_info->context.uc_link = &fiber_info->caller;
+  makecontext (
+    &fiber_info->context,
+    (void (*)(void))fiber_entry,
+    2,
+    (unsigned int)((((uintn)fiber_info) >> 16) >> 16),
+    (unsigned int)(uintn)fiber_info
+    );
+#endif
+  return fiber_info;
+}
+
+/**
+  Release a fiber. A fiber that is not finished is abandoned.
+
+  @param  fiber                        Pointer to the fiber.
+**/
+void
+fiber_free (
+  IN void  *fiber
+  )
+{
+  fiber_info_t  *fiber_info;
+
+  fiber_info = fiber;
+  if (fiber_info == NULL) {
+    return ;
+  }
+#if defined(_MSC_VER)
+  DeleteFiber (fiber_info->handle);
+#else
+  free (fiber_info->stack);
+#endif
+  free (fiber_info);
+}
+
+/**
+  Run a fiber on the calling thread until it calls fiber_yield or its entry point returns.
+
+  @param  fiber                        Pointer to the fiber.
+
+  @retval TRUE   The entry point of the fiber has returned.
+  @retval FALSE  The fiber has yielded.
+**/
+boolean
+fiber_resume (
+  IN void  *fiber
+  )
+{
+  fiber_info_t  *fiber_info;
+
+  fiber_info = fiber;
+  if (fiber_info->finished) {
+    return TRUE;
+  }
+#if defined(_MSC_VER)
+  if (!IsThreadAFiber ()) {
+    ConvertThreadToFiber (NULL);
+  }
+  fiber_info->caller = GetCurrentFiber ();
+  SwitchToFiber (fiber_info->handle);
+#else
+  swapcontext (&fiber_info->caller, &fiber_info->context);
+#endif
+  return fiber_info->finished;
+}
+
+/**
+  Switch from the running fiber back to the caller of fiber_resume.
+
+  @param  fiber                        Pointer to the running fiber.
+**/
+void
+fiber_yield (
+  IN void  *fiber
+  )
+{
+  fiber_info_t  *fiber_info;
+
+  fiber_info = fiber;
+#if defined(_MSC_VER)
+  SwitchToFiber (fiber_info->caller);
+#else
+  swapcontext (&fiber_info->context, &fiber_info->caller);
+#endif
+}
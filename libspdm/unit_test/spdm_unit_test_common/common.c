@@ -53,6 +53,7 @@ int spdm_unit_test_group_teardown(void **state)
   spdm_test_context_t       *spdm_test_context;
 
   spdm_test_context = *state;
+  spdm_deinit_context (spdm_test_context->spdm_context);
   free (spdm_test_context->spdm_context);
   spdm_test_context->spdm_context = NULL;
   spdm_test_context->case_id = 0xFFFFFFFF;
@@ -138,6 +138,8 @@ validate_crypt_aead_cipher (
   uintn    OutBufferSize;
   uint8    OutTag[1024];
   uintn    OutTagSize;
+  void     *aead_context;
+  uintn    index;
 
   my_print ("\nCrypto AEAD Testing: ");
 
@@ -206,6 +208,92 @@ validate_crypt_aead_cipher (
 
   my_print ("[Pass]");
 
+  my_print ("\n- AES-GCM context Encryption: ");
+  aead_context = aead_aes_gcm_new ();
+  if (aead_context == NULL) {
+    my_print ("[Fail]");
+    return RETURN_ABORTED;
+  }
+  status = aead_aes_gcm_set_key (aead_context, m_gcm_key, sizeof(m_gcm_key));
+  if (!status) {
+    my_print ("[Fail]");
+    aead_aes_gcm_free (aead_context);
+    return RETURN_ABORTED;
+  }
+  //
+  // The context must give the same result for every message.
+  //
+  for (index = 0; index < 2; index++) {
+    OutBufferSize = sizeof(OutBuffer);
+    status = aead_aes_gcm_encrypt_with_context(
+               aead_context,
+               m_gcm_iv,
+               sizeof(m_gcm_iv),
+               m_gcm_aad,
+               sizeof(m_gcm_aad),
+               m_gcm_pt,
+               sizeof(m_gcm_pt),
+               OutTag,
+               sizeof(m_gcm_tag),
+               OutBuffer,
+               &OutBufferSize
+               );
+    if (!status ||
+        (OutBufferSize != sizeof(m_gcm_ct)) ||
+        (compare_mem(OutBuffer, m_gcm_ct, sizeof(m_gcm_ct)) != 0) ||
+        (compare_mem(OutTag, m_gcm_tag, sizeof(m_gcm_tag)) != 0)) {
+      my_print ("[Fail]");
+      aead_aes_gcm_free (aead_context);
+      return RETURN_ABORTED;
+    }
+  }
+  my_print ("[Pass]");
+
+  my_print ("\n- AES-GCM context Decryption: ");
+  copy_mem (OutTag, m_gcm_tag, sizeof(m_gcm_tag));
+  OutTag[0] ^= 1;
+  OutBufferSize = sizeof(OutBuffer);
+  status = aead_aes_gcm_decrypt_with_context(
+             aead_context,
+             m_gcm_iv,
+             sizeof(m_gcm_iv),
+             m_gcm_aad,
+             sizeof(m_gcm_aad),
+             m_gcm_ct,
+             sizeof(m_gcm_ct),
+             OutTag,
+             sizeof(m_gcm_tag),
+             OutBuffer,
+             &OutBufferSize
+             );
+  if (status) {
+    my_print ("[Fail]");
+    aead_aes_gcm_free (aead_context);
+    return RETURN_ABORTED;
+  }
+  OutBufferSize = sizeof(OutBuffer);
+  status = aead_aes_gcm_decrypt_with_context(
+             aead_context,
+             m_gcm_iv,
+             sizeof(m_gcm_iv),
+             m_gcm_aad,
+             sizeof(m_gcm_aad),
+             m_gcm_ct,
+             sizeof(m_gcm_ct),
+             m_gcm_tag,
+             sizeof(m_gcm_tag),
+             OutBuffer,
+             &OutBufferSize
+             );
+  aead_aes_gcm_free (aead_context);
+  if (!status ||
+      (OutBufferSize != sizeof(m_gcm_pt)) ||
+      (compare_mem(OutBuffer, m_gcm_pt, sizeof(m_gcm_pt)) != 0)) {
+    my_print ("[Fail]");
+    return RETURN_ABORTED;
+  }
+  my_print ("[Pass]");
+
 
   my_print ("\n- ChaCha20Poly1305 Encryption: ");
   OutBufferSize = sizeof(OutBuffer);
@@ -0,0 +1,313 @@
+/** @file
+  Application for memory library validation and performance measurement.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#undef NULL
+
+#include <hal/base.h>
+#include <library/memlib.h>
+
+#define TEST_MEMLIB_MAX_SIZE        (128 * 1024)
+#define TEST_MEMLIB_CHECK_SIZE      80
+#define TEST_MEMLIB_TOTAL_BYTES     (256 * 1024 * 1024)
+
+uint8  m_buffer_a[TEST_MEMLIB_MAX_SIZE + 64];
+uint8  m_buffer_b[TEST_MEMLIB_MAX_SIZE + 64];
+uint8  m_buffer_ref[TEST_MEMLIB_MAX_SIZE + 64];
+
+/**
+  Fill the buffer with a pattern.
+
+  @param  buffer                        The buffer to fill.
+  @param  length                        The size in bytes of the buffer.
+  @param  seed                          The seed of the pattern.
+**/
+void
+fill_pattern (
+  OUT uint8  *buffer,
+  IN  uintn  length,
+  IN  uint8  seed
+  )
+{
+  uintn  index;
+
+  for (index = 0; index < length; index++) {
+    buffer[index] = (uint8)(index * 7 + seed);
+  }
+}
+
+/**
+  Validate copy_mem with all combinations of alignment, size and overlap.
+
+  @retval TRUE  copy_mem works.
+  @retval FALSE copy_mem is broken.
+**/
+boolean
+validate_copy_mem (
+  void
+  )
+{
+  uintn  dst_offset;
+  uintn  src_offset;
+  uintn  length;
+
+  for (dst_offset = 0; dst_offset < 16; dst_offset++) {
+    for (src_offset = 0; src_offset < 16; src_offset++) {
+      for (length = 0; length < TEST_MEMLIB_CHECK_SIZE; length++) {
+        //
+        // No overlap
+        //
+        fill_pattern (m_buffer_a, TEST_MEMLIB_CHECK_SIZE * 2, 1);
+        fill_pattern (m_buffer_b, TEST_MEMLIB_CHECK_SIZE * 2, 2);
+        memcpy (m_buffer_ref, m_buffer_b, TEST_MEMLIB_CHECK_SIZE * 2);
+        memcpy (m_buffer_ref + dst_offset, m_buffer_a + src_offset, length);
+        copy_mem (m_buffer_b + dst_offset, m_buffer_a + src_offset, length);
+        if (memcmp (m_buffer_b, m_buffer_ref, TEST_MEMLIB_CHECK_SIZE * 2) != 0) {
+          printf ("copy_mem - FAIL (dst %d, src %d, length %d)\n", (int)dst_offset, (int)src_offset, (int)length);
+          return FALSE;
+        }
+        //
+        // Overlap in the same buffer
+        //
+        fill_pattern (m_buffer_a, TEST_MEMLIB_CHECK_SIZE * 2, 3);
+        memcpy (m_buffer_ref, m_buffer_a, TEST_MEMLIB_CHECK_SIZE * 2);
+        memmove (m_buffer_ref + dst_offset, m_buffer_ref + src_offset, length);
+        copy_mem (m_buffer_a + dst_offset, m_buffer_a + src_offset, length);
+        if (memcmp (m_buffer_a, m_buffer_ref, TEST_MEMLIB_CHECK_SIZE * 2) != 0) {
+          printf ("copy_mem overlap - FAIL (dst %d, src %d, length %d)\n", (int)dst_offset, (int)src_offset, (int)length);
+          return FALSE;
+        }
+      }
+    }
+  }
+  printf ("copy_mem - PASS\n");
+  return TRUE;
+}
+
+/**
+  Validate set_mem, zero_mem and secure_zero_mem with all combinations of alignment and size.
+
+  @retval TRUE  The functions work.
+  @retval FALSE One function is broken.
+**/
+boolean
+validate_set_mem (
+  void
+  )
+{
+  uintn  offset;
+  uintn  length;
+
+  for (offset = 0; offset < 16; offset++) {
+    for (length = 0; length < TEST_MEMLIB_CHECK_SIZE; length++) {
+      fill_pattern (m_buffer_a, TEST_MEMLIB_CHECK_SIZE * 2, 4);
+      memcpy (m_buffer_ref, m_buffer_a, TEST_MEMLIB_CHECK_SIZE * 2);
+      memset (m_buffer_ref + offset, 0xA5, length);
+      set_mem (m_buffer_a + offset, length, 0xA5);
+      if (memcmp (m_buffer_a, m_buffer_ref, TEST_MEMLIB_CHECK_SIZE * 2) != 0) {
+        printf ("set_mem - FAIL (offset %d, length %d)\n", (int)offset, (int)length);
+        return FALSE;
+      }
+
+      fill_pattern (m_buffer_a, TEST_MEMLIB_CHECK_SIZE * 2, 5);
+      memcpy (m_buffer_ref, m_buffer_a, TEST_MEMLIB_CHECK_SIZE * 2);
+      memset (m_buffer_ref + offset, 0, length);
+      zero_mem (m_buffer_a + offset, length);
+      if (memcmp (m_buffer_a, m_buffer_ref, TEST_MEMLIB_CHECK_SIZE * 2) != 0) {
+        printf ("zero_mem - FAIL (offset %d, length %d)\n", (int)offset, (int)length);
+        return FALSE;
+      }
+
+      fill_pattern (m_buffer_a, TEST_MEMLIB_CHECK_SIZE * 2, 5);
+      secure_zero_mem (m_buffer_a + offset, length);
+      if (memcmp (m_buffer_a, m_buffer_ref, TEST_MEMLIB_CHECK_SIZE * 2) != 0) {
+        printf ("secure_zero_mem - FAIL (offset %d, length %d)\n", (int)offset, (int)length);
+        return FALSE;
+      }
+    }
+  }
+  printf ("set_mem/zero_mem/secure_zero_mem - PASS\n");
+  return TRUE;
+}
+
+/**
+  Validate compare_mem and const_compare_mem with a mismatch at every position.
+
+  @retval TRUE  The functions work.
+  @retval FALSE One function is broken.
+**/
+boolean
+validate_compare_mem (
+  void
+  )
+{
+  uintn  dst_offset;
+  uintn  src_offset;
+  uintn  length;
+  uintn  index;
+  intn   expected;
+  intn   result;
+
+  for (dst_offset = 0; dst_offset < 16; dst_offset++) {
+    for (src_offset = 0; src_offset < 16; src_offset++) {
+      for (length = 1; length < TEST_MEMLIB_CHECK_SIZE; length++) {
+        fill_pattern (m_buffer_a + dst_offset, length, 7);
+        fill_pattern (m_buffer_b + src_offset, length, 7);
+        if ((compare_mem (m_buffer_a + dst_offset, m_buffer_b + src_offset, length) != 0) ||
+            (const_compare_mem (m_buffer_a + dst_offset, m_buffer_b + src_offset, length) != 0)) {
+          printf ("compare_mem equal - FAIL (dst %d, src %d, length %d)\n", (int)dst_offset, (int)src_offset, (int)length);
+          return FALSE;
+        }
+        for (index = 0; index < length; index++) {
+          m_buffer_b[src_offset + index] ^= 0x81;
+          expected = (intn)m_buffer_a[dst_offset + index] - (intn)m_buffer_b[src_offset + index];
+          result = compare_mem (m_buffer_a + dst_offset, m_buffer_b + src_offset, length);
+          if ((result != expected) ||
+              (const_compare_mem (m_buffer_a + dst_offset, m_buffer_b + src_offset, length) != 1)) {
+            printf ("compare_mem - FAIL (dst %d, src %d, length %d, index %d)\n", (int)dst_offset, (int)src_offset, (int)length, (int)index);
+            return FALSE;
+          }
+          m_buffer_b[src_offset + index] ^= 0x81;
+        }
+      }
+    }
+  }
+  printf ("compare_mem/const_compare_mem - PASS\n");
+  return TRUE;
+}
+
+typedef enum {
+  TEST_MEMLIB_COPY_MEM,
+  TEST_MEMLIB_SET_MEM,
+  TEST_MEMLIB_ZERO_MEM,
+  TEST_MEMLIB_SECURE_ZERO_MEM,
+  TEST_MEMLIB_COMPARE_MEM,
+  TEST_MEMLIB_CONST_COMPARE_MEM,
+  TEST_MEMLIB_MAX
+} test_memlib_func_t;
+
+char8 *m_test_memlib_func_str[] = {
+  "copy_mem",
+  "set_mem",
+  "zero_mem",
+  "secure_zero_mem",
+  "compare_mem",
+  "const_compare_mem",
+};
+
+/**
+  Measure the throughput of one memory library function.
+
+  @param  func                          The function to be measured.
+  @param  length                        The size in bytes of each call.
+
+  @return The throughput in MB/s.
+**/
+double
+measure_memlib (
+  IN test_memlib_func_t  func,
+  IN uintn               length
+  )
+{
+  uintn    count;
+  uintn    index;
+  clock_t  start;
+  clock_t  stop;
+  double   seconds;
+  intn     sink;
+
+  count = TEST_MEMLIB_TOTAL_BYTES / length;
+  sink = 0;
+  start = clock ();
+  for (index = 0; index < count; index++) {
+    switch (func) {
+    case TEST_MEMLIB_COPY_MEM:
+      copy_mem (m_buffer_a, m_buffer_b, length);
+      break;
+    case TEST_MEMLIB_SET_MEM:
+      set_mem (m_buffer_a, length, (uint8)index);
+      break;
+    case TEST_MEMLIB_ZERO_MEM:
+      zero_mem (m_buffer_a, length);
+      break;
+    case TEST_MEMLIB_SECURE_ZERO_MEM:
+      secure_zero_mem (m_buffer_a, length);
+      break;
+    case TEST_MEMLIB_COMPARE_MEM:
+      sink += compare_mem (m_buffer_a, m_buffer_b, length);
+      break;
+    case TEST_MEMLIB_CONST_COMPARE_MEM:
+      sink += const_compare_mem (m_buffer_a, m_buffer_b, length);
+      break;
+    default:
+      break;
+    }
+  }
+  stop = clock ();
+  if (sink != 0) {
+    printf ("unexpected compare result\n");
+  }
+
+  seconds = (double)(stop - start) / CLOCKS_PER_SEC;
+  if (seconds <= 0) {
+    return 0;
+  }
+  return ((double)count * length) / seconds / (1024 * 1024);
+}
+
+/**
+  Measure the throughput of the memory library functions for 16B to 128KB buffers.
+**/
+void
+benchmark_memlib (
+  void
+  )
+{
+  uintn  func;
+  uintn  length;
+
+  printf ("\n%-18s", "size (MB/s)");
+  for (func = 0; func < TEST_MEMLIB_MAX; func++) {
+    printf ("%18s", m_test_memlib_func_str[func]);
+  }
+  printf ("\n");
+
+  for (length = 16; length <= TEST_MEMLIB_MAX_SIZE; length *= 2) {
+    //
+    // The buffers are identical, so that compare_mem scans the whole buffer.
+    //
+    fill_pattern (m_buffer_b, length, 8);
+    printf ("%-18d", (int)length);
+    for (func = 0; func < TEST_MEMLIB_MAX; func++) {
+      copy_mem (m_buffer_a, m_buffer_b, length);
+      printf ("%18.1f", measure_memlib ((test_memlib_func_t)func, length));
+    }
+    printf ("\n");
+  }
+}
+
+int main (
+  int argc,
+  char *argv[ ]
+  )
+{
+  printf ("\nMemory Library Testing:\n");
+  printf ("-------------------------------------------- \n");
+
+  if (!validate_copy_mem () ||
+      !validate_set_mem () ||
+      !validate_compare_mem ()) {
+    return 1;
+  }
+
+  benchmark_memlib ();
+  return 0;
+}
@@ -104,3 +104,100 @@ aead_aes_gcm_decrypt (
 }
 
 
+
+/**
+  Allocates and initializes one AES-GCM context for subsequent use.
+
+  The dummy library does not support AES-GCM context, so that the caller uses the one-shot functions.
+
+  @return  NULL.
+
+**/
+void *
+aead_aes_gcm_new (
+  void
+  )
+{
+  return NULL;
+}
+
+/**
+  Release the specified AES-GCM context.
+
+  @param[in]  aead_context  Pointer to the AES-GCM context to be released.
+
+**/
+void
+aead_aes_gcm_free (
+  IN  void  *aead_context
+  )
+{
+}
+
+/**
+  Set the key of the AES-GCM context for subsequent use.
+
+  @param[in, out]  aead_context  Pointer to the AES-GCM context.
+  @param[in]       key           Pointer to the encryption key.
+  @param[in]       key_size       size of the encryption key in bytes.
+
+  @retval FALSE  The key is set unsuccessfully.
+
+**/
+boolean
+aead_aes_gcm_set_key (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *key,
+  IN      uintn        key_size
+  )
+{
+  return FALSE;
+}
+
+/**
+  Performs AEAD AES-GCM authenticated encryption with the key in the AES-GCM context.
+
+  @retval FALSE  AEAD AES-GCM authenticated encryption failed.
+
+**/
+boolean
+aead_aes_gcm_encrypt_with_context (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *iv,
+  IN      uintn        iv_size,
+  IN      const uint8  *a_data,
+  IN      uintn        a_data_size,
+  IN      const uint8  *data_in,
+  IN      uintn        data_in_size,
+  OUT     uint8        *tag_out,
+  IN      uintn        tag_size,
+  OUT     uint8        *data_out,
+  OUT     uintn        *data_out_size
+  )
+{
+  return FALSE;
+}
+
+/**
+  Performs AEAD AES-GCM authenticated decryption with the key in the AES-GCM context.
+
+  @retval FALSE  AEAD AES-GCM authenticated decryption failed.
+
+**/
+boolean
+aead_aes_gcm_decrypt_with_context (
+  IN OUT  void         *aead_context,
+  IN      const uint8  *iv,
+  IN      uintn        iv_size,
+  IN      const uint8  *a_data,
+  IN      uintn        a_data_size,
+  IN      const uint8  *data_in,
+  IN      uintn        data_in_size,
+  IN      const uint8  *tag,
+  IN      uintn        tag_size,
+  OUT     uint8        *data_out,
+  OUT     uintn        *data_out_size
+  )
+{
+  return FALSE;
+}
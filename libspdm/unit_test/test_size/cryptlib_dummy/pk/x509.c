@@ -771,3 +771,51 @@ x509_compare_date_time (
   ASSERT(FALSE);
   return -3;
 }
+
+/**
+  Check whether the current time is within the validity period of a certificate.
+
+  The current time is checked the same way as x509_verify_cert checks it, so that
+  a cached verification result expires together with the certificate.
+  If x509_verify_cert does not check the time, then return TRUE.
+
+  @param[in]      from         notBefore Pointer to date_time object.
+  @param[in]      to           notAfter Pointer to date_time object.
+
+  @retval  TRUE   The current time is within the validity period, or the time is not checked.
+  @retval  FALSE  The certificate is expired or not yet valid.
+**/
+boolean
+x509_check_current_date_time (
+  IN    void   *from,
+  IN    void   *to
+  )
+{
+  ASSERT(FALSE);
+  return FALSE;
+}
+
+/**
+  Copy a date_time object.
+
+  A date_time object may point into its own buffer, so it is copied with this function instead of copy_mem.
+
+  @param[in]      date_time           Pointer to the date_time object.
+  @param[in]      date_time_size      date_time object size.
+  @param[out]     new_date_time       Pointer to the buffer of the copy.
+  @param[in,out]  new_date_time_size  On input, the size of the buffer. On output, the date_time object size.
+
+  @retval  TRUE   The date_time object is copied.
+  @retval  FALSE  The buffer is too small.
+**/
+boolean
+x509_copy_date_time (
+  IN     void   *date_time,
+  IN     uintn  date_time_size,
+     OUT void   *new_date_time,
+  IN OUT uintn  *new_date_time_size
+  )
+{
+  ASSERT(FALSE);
+  return FALSE;
+}
@@ -0,0 +1,130 @@
+/** @file
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <base.h>
+#include <library/threadlib.h>
+
+void *
+thread_create (
+  IN thread_start_func  start_func,
+  IN void               *context
+  )
+{
+  return NULL;
+}
+
+void
+thread_join (
+  IN void  *thread
+  )
+{
+}
+
+void
+thread_sleep (
+  IN uint64  microseconds
+  )
+{
+}
+
+void *
+mutex_new (
+  void
+  )
+{
+  return NULL;
+}
+
+void
+mutex_free (
+  IN void  *mutex
+  )
+{
+}
+
+void
+mutex_lock (
+  IN void  *mutex
+  )
+{
+}
+
+void
+mutex_unlock (
+  IN void  *mutex
+  )
+{
+}
+
+void *
+cond_new (
+  void
+  )
+{
+  return NULL;
+}
+
+void
+cond_free (
+  IN void  *cond
+  )
+{
+}
+
+void
+cond_wait (
+  IN void  *cond,
+  IN void  *mutex
+  )
+{
+}
+
+void
+cond_signal (
+  IN void  *cond
+  )
+{
+}
+
+void
+cond_broadcast (
+  IN void  *cond
+  )
+{
+}
+
+void *
+fiber_new (
+  IN fiber_start_func  start_func,
+  IN void              *context,
+  IN uintn             stack_size
+  )
+{
+  return NULL;
+}
+
+void
+fiber_free (
+  IN void  *fiber
+  )
+{
+}
+
+boolean
+fiber_resume (
+  IN void  *fiber
+  )
+{
+  return TRUE;
+}
+
+void
+fiber_yield (
+  IN void  *fiber
+  )
+{
+}
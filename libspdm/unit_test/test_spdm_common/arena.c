@@ -0,0 +1,105 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+
+#define TEST_ARENA_BUFFER_SIZE  0x600
+
+static uint8  m_arena_zero_buffer[TEST_ARENA_BUFFER_SIZE * 2];
+
+/**
+  Test 1: a buffer is released to the arena and allocated again.
+  Expected Behavior: the cached block is reused, and its data is zeroed.
+**/
+void test_spdm_common_arena_case1(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint8                *buffer;
+  uint8                *new_buffer;
+  uintn                buffer_size;
+  uintn                used_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  used_size = spdm_context->arena.used_size;
+
+  buffer = spdm_arena_allocate (&spdm_context->arena, TEST_ARENA_BUFFER_SIZE, &buffer_size);
+  assert_true(buffer != NULL);
+  assert_true(buffer_size >= TEST_ARENA_BUFFER_SIZE);
+  assert_true(spdm_context->arena.used_size > used_size);
+  set_mem (buffer, buffer_size, 0x5A);
+
+  spdm_arena_free (&spdm_context->arena, buffer);
+  assert_int_equal(spdm_context->arena.used_size, used_size);
+  assert_memory_equal(buffer, m_arena_zero_buffer, buffer_size);
+
+  new_buffer = spdm_arena_allocate (&spdm_context->arena, TEST_ARENA_BUFFER_SIZE, NULL);
+  assert_true(new_buffer == buffer);
+  assert_memory_equal(new_buffer, m_arena_zero_buffer, buffer_size);
+  spdm_arena_free (&spdm_context->arena, new_buffer);
+}
+
+/**
+  Test 2: the peer used certificate chain buffer is set, replaced and released.
+  Expected Behavior: the buffer is allocated from the arena, and the released buffer is zeroed.
+**/
+void test_spdm_common_arena_case2(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint8                cert_chain[TEST_ARENA_BUFFER_SIZE];
+  uint8                *buffer;
+  uintn                used_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  used_size = spdm_context->arena.used_size;
+
+  set_mem (cert_chain, sizeof(cert_chain), 0xA5);
+  assert_true(spdm_set_peer_used_cert_chain_buffer (spdm_context, cert_chain, sizeof(cert_chain)));
+  assert_int_equal(spdm_context->connection_info.peer_used_cert_chain_buffer_size, sizeof(cert_chain));
+  assert_memory_equal(spdm_context->connection_info.peer_used_cert_chain_buffer, cert_chain, sizeof(cert_chain));
+  assert_true(spdm_context->arena.used_size > used_size);
+  buffer = spdm_context->connection_info.peer_used_cert_chain_buffer;
+
+  assert_true(spdm_set_peer_used_cert_chain_buffer (spdm_context, cert_chain, sizeof(cert_chain) / 2));
+  assert_int_equal(spdm_context->connection_info.peer_used_cert_chain_buffer_size, sizeof(cert_chain) / 2);
+  assert_memory_equal(spdm_context->connection_info.peer_used_cert_chain_buffer, cert_chain, sizeof(cert_chain) / 2);
+  assert_memory_equal(buffer, m_arena_zero_buffer, sizeof(cert_chain));
+
+  buffer = spdm_context->connection_info.peer_used_cert_chain_buffer;
+  assert_true(spdm_set_peer_used_cert_chain_buffer (spdm_context, NULL, 0));
+  assert_true(spdm_context->connection_info.peer_used_cert_chain_buffer == NULL);
+  assert_int_equal(spdm_context->connection_info.peer_used_cert_chain_buffer_size, 0);
+  assert_memory_equal(buffer, m_arena_zero_buffer, sizeof(cert_chain) / 2);
+  assert_int_equal(spdm_context->arena.used_size, used_size);
+
+  assert_int_equal(spdm_set_peer_used_cert_chain_buffer (spdm_context, cert_chain, MAX_SPDM_CERT_CHAIN_SIZE + 1), FALSE);
+  assert_int_equal(spdm_context->arena.used_size, used_size);
+}
+
+spdm_test_context_t       m_spdm_common_arena_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_common_arena_test_main(void) {
+  const struct CMUnitTest spdm_common_arena_tests[] = {
+      // Released buffer is zeroed and reused
+      cmocka_unit_test(test_spdm_common_arena_case1),
+      // Peer used certificate chain buffer in the arena
+      cmocka_unit_test(test_spdm_common_arena_case2),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_arena_test_context);
+
+  return cmocka_run_group_tests(spdm_common_arena_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
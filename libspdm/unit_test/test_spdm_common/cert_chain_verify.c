@@ -0,0 +1,280 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+
+#define TEST_CERT_CHAIN_VERIFY_HASH_ALGO  SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256
+
+/**
+  Build a certificate chain buffer including spdm_cert_chain_t header from the certificate chain file.
+
+  @param  cert_chain_buffer              The certificate chain buffer. The caller frees it.
+  @param  cert_chain_buffer_size          size in bytes of the certificate chain buffer.
+  @param  cert_offset                    The offset of the certificate at cert_index in the certificate chain buffer.
+  @param  cert_size                      size in bytes of the certificate at cert_index.
+  @param  cert_index                     The index of the certificate, 0 for the root certificate.
+**/
+static
+void
+test_spdm_common_cert_chain_verify_read_chain (
+  OUT uint8  **cert_chain_buffer,
+  OUT uintn  *cert_chain_buffer_size,
+  OUT uintn  *cert_offset,
+  OUT uintn  *cert_size,
+  IN  int32  cert_index
+  )
+{
+  boolean  status;
+  uint8    *file_buffer;
+  uintn    file_buffer_size;
+  uint8    *root_cert;
+  uintn    root_cert_size;
+  uint8    *cert;
+  uintn    hash_size;
+
+  hash_size = spdm_get_hash_size (TEST_CERT_CHAIN_VERIFY_HASH_ALGO);
+  status = read_input_file ("ecp256/bundle_responder.certchain.der", (void **)&file_buffer, &file_buffer_size);
+  assert_true(status);
+  status = x509_get_cert_from_cert_chain (file_buffer, file_buffer_size, 0, &root_cert, &root_cert_size);
+  assert_true(status);
+  status = x509_get_cert_from_cert_chain (file_buffer, file_buffer_size, cert_index, &cert, cert_size);
+  assert_true(status);
+
+  *cert_chain_buffer_size = sizeof(spdm_cert_chain_t) + hash_size + file_buffer_size;
+  *cert_chain_buffer = malloc (*cert_chain_buffer_size);
+  assert_true(*cert_chain_buffer != NULL);
+  ((spdm_cert_chain_t *)*cert_chain_buffer)->length = (uint16)*cert_chain_buffer_size;
+  ((spdm_cert_chain_t *)*cert_chain_buffer)->reserved = 0;
+  spdm_hash_all (TEST_CERT_CHAIN_VERIFY_HASH_ALGO, root_cert, root_cert_size, *cert_chain_buffer + sizeof(spdm_cert_chain_t));
+  copy_mem (*cert_chain_buffer + sizeof(spdm_cert_chain_t) + hash_size, file_buffer, file_buffer_size);
+  *cert_offset = sizeof(spdm_cert_chain_t) + hash_size + (uintn)(cert - file_buffer);
+
+  free (file_buffer);
+}
+
+/**
+  Verify the certificate chain buffer as the requester does while the chain is received.
+
+  The verified certificate link cache is cleared first, so that every link is really verified.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  thread_count                  The count of worker threads. 0 selects the serial path.
+  @param  cert_chain_buffer              The certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certificate chain buffer.
+  @param  received_size                 size in bytes of the part passed to the update function before the final function.
+                                       0 means the whole chain is verified by the final function.
+  @param  verify_context                 The certificate chain verification context.
+
+  @return the verification result.
+**/
+static
+boolean
+test_spdm_common_cert_chain_verify_run (
+  IN  spdm_context_t                    *spdm_context,
+  IN  uint8                             thread_count,
+  IN  uint8                             *cert_chain_buffer,
+  IN  uintn                             cert_chain_buffer_size,
+  IN  uintn                             received_size,
+  OUT spdm_cert_chain_verify_context_t  *verify_context
+  )
+{
+  return_status  status;
+  boolean        result;
+
+  status = spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, NULL, &thread_count, sizeof(thread_count));
+  assert_int_equal(status, RETURN_SUCCESS);
+  spdm_clear_cert_link_cache ();
+
+  spdm_cert_chain_verify_init (verify_context, TEST_CERT_CHAIN_VERIFY_HASH_ALGO);
+  result = TRUE;
+  if (received_size != 0) {
+    result = spdm_verify_peer_cert_chain_buffer_update (spdm_context, verify_context, cert_chain_buffer, received_size);
+  }
+  if (result) {
+    result = spdm_verify_peer_cert_chain_buffer_final (spdm_context, verify_context, cert_chain_buffer, cert_chain_buffer_size);
+  }
+
+  spdm_worker_pool_stop (spdm_context);
+  spdm_clear_cert_link_cache ();
+  return result;
+}
+
+/**
+  Verify the certificate chain buffer on the serial path and on the worker pool.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  cert_chain_buffer              The certificate chain buffer including spdm_cert_chain_t header.
+  @param  cert_chain_buffer_size          size in bytes of the certificate chain buffer.
+  @param  received_size                 size in bytes of the part passed to the update function before the final function.
+
+  @return the verification result, which is the same on both paths.
+**/
+static
+boolean
+test_spdm_common_cert_chain_verify_compare (
+  IN spdm_context_t  *spdm_context,
+  IN uint8           *cert_chain_buffer,
+  IN uintn           cert_chain_buffer_size,
+  IN uintn           received_size
+  )
+{
+  spdm_cert_chain_verify_context_t  serial_context;
+  spdm_cert_chain_verify_context_t  parallel_context;
+  boolean                           serial_result;
+  boolean                           parallel_result;
+
+  serial_result = test_spdm_common_cert_chain_verify_run (spdm_context, 0, cert_chain_buffer, cert_chain_buffer_size, received_size, &serial_context);
+  parallel_result = test_spdm_common_cert_chain_verify_run (spdm_context, 2, cert_chain_buffer, cert_chain_buffer_size, received_size, &parallel_context);
+  assert_int_equal(serial_result, parallel_result);
+  if (serial_result) {
+    assert_int_equal(serial_context.cert_count, parallel_context.cert_count);
+    assert_int_equal(serial_context.last_cert_offset, parallel_context.last_cert_offset);
+    assert_int_equal(serial_context.last_cert_size, parallel_context.last_cert_size);
+  }
+  return serial_result;
+}
+
+/**
+  Test 1: verify a valid certificate chain.
+  Expected Behavior: the serial path and the worker pool both pass, and verify the same certificates.
+**/
+void test_spdm_common_cert_chain_verify_case1(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint8                *cert_chain_buffer;
+  uintn                cert_chain_buffer_size;
+  uintn                cert_offset;
+  uintn                cert_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  test_spdm_common_cert_chain_verify_read_chain (&cert_chain_buffer, &cert_chain_buffer_size, &cert_offset, &cert_size, 0);
+
+  assert_true(test_spdm_common_cert_chain_verify_compare (spdm_context, cert_chain_buffer, cert_chain_buffer_size, 0));
+
+  free (cert_chain_buffer);
+}
+
+/**
+  Test 2: verify a valid certificate chain, the root certificate is verified during the transfer.
+  Expected Behavior: the serial path and the worker pool both pass, and verify the same certificates.
+**/
+void test_spdm_common_cert_chain_verify_case2(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint8                *cert_chain_buffer;
+  uintn                cert_chain_buffer_size;
+  uintn                cert_offset;
+  uintn                cert_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  test_spdm_common_cert_chain_verify_read_chain (&cert_chain_buffer, &cert_chain_buffer_size, &cert_offset, &cert_size, 1);
+
+  // Stop the transfer in the middle of the intermediate certificate.
+  assert_true(test_spdm_common_cert_chain_verify_compare (spdm_context, cert_chain_buffer, cert_chain_buffer_size, cert_offset + cert_size / 2));
+
+  free (cert_chain_buffer);
+}
+
+/**
+  Test 3: verify a certificate chain whose intermediate certificate has a bad signature.
+  Expected Behavior: the serial path and the worker pool both fail.
+**/
+void test_spdm_common_cert_chain_verify_case3(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint8                *cert_chain_buffer;
+  uintn                cert_chain_buffer_size;
+  uintn                cert_offset;
+  uintn                cert_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  test_spdm_common_cert_chain_verify_read_chain (&cert_chain_buffer, &cert_chain_buffer_size, &cert_offset, &cert_size, 1);
+  cert_chain_buffer[cert_offset + cert_size - 1]++;
+
+  assert_int_equal(test_spdm_common_cert_chain_verify_compare (spdm_context, cert_chain_buffer, cert_chain_buffer_size, 0), FALSE);
+
+  free (cert_chain_buffer);
+}
+
+/**
+  Test 4: verify a certificate chain whose leaf certificate has a bad signature.
+  Expected Behavior: the serial path and the worker pool both fail.
+**/
+void test_spdm_common_cert_chain_verify_case4(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint8                *cert_chain_buffer;
+  uintn                cert_chain_buffer_size;
+  uintn                cert_offset;
+  uintn                cert_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x4;
+  test_spdm_common_cert_chain_verify_read_chain (&cert_chain_buffer, &cert_chain_buffer_size, &cert_offset, &cert_size, -1);
+  cert_chain_buffer[cert_offset + cert_size - 1]++;
+
+  assert_int_equal(test_spdm_common_cert_chain_verify_compare (spdm_context, cert_chain_buffer, cert_chain_buffer_size, 0), FALSE);
+
+  free (cert_chain_buffer);
+}
+
+/**
+  Test 5: verify a certificate chain whose root hash does not match the root certificate.
+  Expected Behavior: the serial path and the worker pool both fail.
+**/
+void test_spdm_common_cert_chain_verify_case5(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint8                *cert_chain_buffer;
+  uintn                cert_chain_buffer_size;
+  uintn                cert_offset;
+  uintn                cert_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x5;
+  test_spdm_common_cert_chain_verify_read_chain (&cert_chain_buffer, &cert_chain_buffer_size, &cert_offset, &cert_size, 0);
+  cert_chain_buffer[sizeof(spdm_cert_chain_t)]++;
+
+  assert_int_equal(test_spdm_common_cert_chain_verify_compare (spdm_context, cert_chain_buffer, cert_chain_buffer_size, 0), FALSE);
+
+  free (cert_chain_buffer);
+}
+
+spdm_test_context_t       m_spdm_common_cert_chain_verify_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_common_cert_chain_verify_test_main(void) {
+  const struct CMUnitTest spdm_common_cert_chain_verify_tests[] = {
+      // Valid chain
+      cmocka_unit_test(test_spdm_common_cert_chain_verify_case1),
+      // Valid chain, partly verified during the transfer
+      cmocka_unit_test(test_spdm_common_cert_chain_verify_case2),
+      // Bad intermediate certificate
+      cmocka_unit_test(test_spdm_common_cert_chain_verify_case3),
+      // Bad leaf certificate
+      cmocka_unit_test(test_spdm_common_cert_chain_verify_case4),
+      // Root hash mismatch
+      cmocka_unit_test(test_spdm_common_cert_chain_verify_case5),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_cert_chain_verify_test_context);
+
+  return cmocka_run_group_tests(spdm_common_cert_chain_verify_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
@@ -0,0 +1,245 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+
+#define TEST_HYBRID_SIGNATURE_MESSAGE_SIZE  0x80
+#define TEST_HYBRID_SIGNATURE_SIZE          (MAX_ASYM_KEY_SIZE + PQC_SIG_SIGNATURE_LENGTH_SIZE + MAX_PQC_SIG_SIGNATURE_SIZE)
+
+static uint8  m_hybrid_signature_message[2][TEST_HYBRID_SIGNATURE_MESSAGE_SIZE];
+static uint8  m_hybrid_signature[2][TEST_HYBRID_SIGNATURE_SIZE];
+
+/**
+  Provision the peer certificate chain and the peer PQC public key of the signer,
+  so that the signature can be verified in the same SPDM context.
+**/
+static
+void
+test_spdm_common_hybrid_signature_setup (
+  IN spdm_context_t  *spdm_context,
+  IN boolean         is_requester,
+  IN uint8           worker_thread_count
+  )
+{
+  return_status  status;
+  void           *data;
+  uintn          data_size;
+  uintn          index;
+
+  for (index = 0; index < TEST_HYBRID_SIGNATURE_MESSAGE_SIZE; index++) {
+    m_hybrid_signature_message[0][index] = (uint8)index;
+    m_hybrid_signature_message[1][index] = (uint8)(0x80 + index);
+  }
+
+  status = spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, NULL, &worker_thread_count, sizeof(worker_thread_count));
+  assert_int_equal(status, RETURN_SUCCESS);
+
+  spdm_context->local_context.pqc_public_key_mode = SPDM_DATA_PUBLIC_KEY_MODE_RAW;
+  spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
+  spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
+  spdm_context->connection_info.algorithm.req_base_asym_alg = m_use_req_asym_algo;
+  zero_mem (spdm_context->connection_info.algorithm.pqc_sig_algo, sizeof(pqc_algo_t));
+  zero_mem (spdm_context->connection_info.algorithm.pqc_req_sig_algo, sizeof(pqc_algo_t));
+  spdm_context->connection_info.algorithm.pqc_sig_algo[SPDM_ALGORITHMS_PQC_DIGITAL_SIGNATURE_ALGO_DILITHIUM_INDEX_BEGIN] = SPDM_ALGORITHMS_PQC_DIGITAL_SIGNATURE_ALGO_DILITHIUM_2;
+  spdm_context->connection_info.algorithm.pqc_req_sig_algo[SPDM_ALGORITHMS_PQC_DIGITAL_SIGNATURE_ALGO_DILITHIUM_INDEX_BEGIN] = SPDM_ALGORITHMS_PQC_DIGITAL_SIGNATURE_ALGO_DILITHIUM_2;
+  spdm_reset_peer_public_key_context (spdm_context);
+
+  if (is_requester) {
+    read_requester_public_certificate_chain (m_use_hash_algo, m_use_req_asym_algo, &data, &data_size, NULL, NULL);
+  } else {
+    read_responder_public_certificate_chain (m_use_hash_algo, m_use_asym_algo, &data, &data_size, NULL, NULL);
+  }
+  spdm_context->local_context.peer_cert_chain_provision = data;
+  spdm_context->local_context.peer_cert_chain_provision_size = data_size;
+
+  if (is_requester) {
+    read_requester_pqc_public_key (spdm_context->connection_info.algorithm.pqc_req_sig_algo, &data, &data_size);
+  } else {
+    read_responder_pqc_public_key (spdm_context->connection_info.algorithm.pqc_sig_algo, &data, &data_size);
+  }
+  spdm_context->local_context.pqc_peer_public_key_provision = data;
+  spdm_context->local_context.pqc_peer_public_key_provision_size = data_size;
+}
+
+static
+void
+test_spdm_common_hybrid_signature_teardown (
+  IN spdm_context_t  *spdm_context
+  )
+{
+  uint8  worker_thread_count;
+
+  spdm_reset_peer_public_key_context (spdm_context);
+  free (spdm_context->local_context.peer_cert_chain_provision);
+  spdm_context->local_context.peer_cert_chain_provision = NULL;
+  spdm_context->local_context.peer_cert_chain_provision_size = 0;
+  free (spdm_context->local_context.pqc_peer_public_key_provision);
+  spdm_context->local_context.pqc_peer_public_key_provision = NULL;
+  spdm_context->local_context.pqc_peer_public_key_provision_size = 0;
+
+  worker_thread_count = 0;
+  spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, NULL, &worker_thread_count, sizeof(worker_thread_count));
+}
+
+/**
+  Sign the message segments as a RAW mode hybrid signature, check the
+  classical signature || 4 bytes PQC signature size || PQC signature layout,
+  and verify both halves.
+
+  @return the total size of the signature.
+**/
+static
+uintn
+test_spdm_common_hybrid_signature_sign_and_verify (
+  IN spdm_context_t  *spdm_context,
+  IN boolean         is_requester,
+  OUT uint8          *signature
+  )
+{
+  spdm_data_segment_t  segment[2];
+  uintn                asym_signature_size;
+  uintn                pqc_signature_size;
+  uint32               pqc_signature_length;
+  boolean              asym_result;
+  boolean              pqc_result;
+
+  segment[0].data = m_hybrid_signature_message[0];
+  segment[0].size = sizeof(m_hybrid_signature_message[0]);
+  segment[1].data = m_hybrid_signature_message[1];
+  segment[1].size = sizeof(m_hybrid_signature_message[1]);
+
+  set_mem (signature, TEST_HYBRID_SIGNATURE_SIZE, 0xCC);
+  asym_signature_size = 0;
+  pqc_signature_size = 0;
+  assert_true(spdm_generate_raw_mode_signature (
+                spdm_context,
+                is_requester,
+                segment,
+                ARRAY_SIZE(segment),
+                TRUE,
+                signature,
+                &asym_signature_size,
+                &pqc_signature_size
+                ));
+
+  if (is_requester) {
+    assert_int_equal(asym_signature_size, spdm_get_req_asym_signature_size (m_use_req_asym_algo));
+    assert_true(pqc_signature_size <= spdm_get_pqc_req_sig_signature_size (spdm_context->connection_info.algorithm.pqc_req_sig_algo));
+  } else {
+    assert_int_equal(asym_signature_size, spdm_get_asym_signature_size (m_use_asym_algo));
+    assert_true(pqc_signature_size <= spdm_get_pqc_sig_signature_size (spdm_context->connection_info.algorithm.pqc_sig_algo));
+  }
+  assert_true(pqc_signature_size != 0);
+  copy_mem (&pqc_signature_length, signature + asym_signature_size, sizeof(pqc_signature_length));
+  assert_int_equal(pqc_signature_length, pqc_signature_size);
+
+  //
+  // The signature is verified by the peer, so the role is reversed.
+  //
+  assert_true(spdm_verify_raw_mode_signature (
+                spdm_context,
+                !is_requester,
+                segment,
+                ARRAY_SIZE(segment),
+                signature,
+                asym_signature_size,
+                signature + asym_signature_size + PQC_SIG_SIGNATURE_LENGTH_SIZE,
+                pqc_signature_size,
+                &asym_result,
+                &pqc_result
+                ));
+  assert_true(asym_result);
+  assert_true(pqc_result);
+
+  return asym_signature_size + PQC_SIG_SIGNATURE_LENGTH_SIZE + pqc_signature_size;
+}
+
+/**
+  Test 1: generate a responder RAW mode hybrid signature without the worker pool.
+  Expected Behavior: the two halves are in the wire layout and both verify.
+**/
+void test_spdm_common_hybrid_signature_case1(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  test_spdm_common_hybrid_signature_setup (spdm_context, FALSE, 0);
+
+  test_spdm_common_hybrid_signature_sign_and_verify (spdm_context, FALSE, m_hybrid_signature[0]);
+
+  test_spdm_common_hybrid_signature_teardown (spdm_context);
+}
+
+/**
+  Test 2: generate a responder RAW mode hybrid signature with the worker pool.
+  Expected Behavior: the layout matches the one generated without the worker pool, and both halves verify.
+**/
+void test_spdm_common_hybrid_signature_case2(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uintn                serial_signature_size;
+  uintn                parallel_signature_size;
+  uintn                asym_signature_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  test_spdm_common_hybrid_signature_setup (spdm_context, FALSE, 0);
+  serial_signature_size = test_spdm_common_hybrid_signature_sign_and_verify (spdm_context, FALSE, m_hybrid_signature[0]);
+  test_spdm_common_hybrid_signature_teardown (spdm_context);
+
+  test_spdm_common_hybrid_signature_setup (spdm_context, FALSE, 2);
+  parallel_signature_size = test_spdm_common_hybrid_signature_sign_and_verify (spdm_context, FALSE, m_hybrid_signature[1]);
+  test_spdm_common_hybrid_signature_teardown (spdm_context);
+
+  assert_int_equal(parallel_signature_size, serial_signature_size);
+  asym_signature_size = spdm_get_asym_signature_size (m_use_asym_algo);
+  assert_memory_equal(m_hybrid_signature[1] + asym_signature_size, m_hybrid_signature[0] + asym_signature_size, PQC_SIG_SIGNATURE_LENGTH_SIZE);
+}
+
+/**
+  Test 3: generate a requester RAW mode hybrid signature with the worker pool.
+  Expected Behavior: the requester algorithms are used for both halves, and both halves verify.
+**/
+void test_spdm_common_hybrid_signature_case3(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  test_spdm_common_hybrid_signature_setup (spdm_context, TRUE, 2);
+
+  test_spdm_common_hybrid_signature_sign_and_verify (spdm_context, TRUE, m_hybrid_signature[0]);
+
+  test_spdm_common_hybrid_signature_teardown (spdm_context);
+}
+
+spdm_test_context_t       m_spdm_common_hybrid_signature_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_common_hybrid_signature_test_main(void) {
+  const struct CMUnitTest spdm_common_hybrid_signature_tests[] = {
+      // Responder signature without the worker pool
+      cmocka_unit_test(test_spdm_common_hybrid_signature_case1),
+      // Responder signature with the worker pool
+      cmocka_unit_test(test_spdm_common_hybrid_signature_case2),
+      // Requester signature with the worker pool
+      cmocka_unit_test(test_spdm_common_hybrid_signature_case3),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_hybrid_signature_test_context);
+
+  return cmocka_run_group_tests(spdm_common_hybrid_signature_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
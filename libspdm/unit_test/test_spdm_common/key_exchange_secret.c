@@ -0,0 +1,320 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+#include <spdm_secured_message_lib_internal.h>
+
+typedef struct {
+  void   *secured_message_context;
+  void   *dhe_context;
+  uint8  dhe_public_key[MAX_DHE_KEY_SIZE];
+  uintn  dhe_public_key_size;
+  void   *pqc_kem_context;
+  uint8  pqc_kem_data[MAX_PQC_KEM_PUBLIC_KEY_SIZE_KYBER];
+  uintn  pqc_kem_data_size;
+} test_key_exchange_secret_party_t;
+
+static test_key_exchange_secret_party_t  m_key_exchange_secret_requester;
+static test_key_exchange_secret_party_t  m_key_exchange_secret_responder;
+
+/**
+  Negotiate the algorithms, and generate the DHE key of both parties and the PQC KEM key of the requester.
+**/
+static
+void
+test_spdm_common_key_exchange_secret_setup (
+  IN spdm_context_t  *spdm_context,
+  IN uint8           worker_thread_count,
+  IN boolean         need_pqc_kem
+  )
+{
+  return_status                     status;
+  test_key_exchange_secret_party_t  *party[2];
+  uintn                             index;
+  boolean                           result;
+
+  status = spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, NULL, &worker_thread_count, sizeof(worker_thread_count));
+  assert_int_equal(status, RETURN_SUCCESS);
+
+  spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
+  spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo;
+  spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
+  spdm_context->connection_info.algorithm.key_schedule = m_use_key_schedule_algo;
+  zero_mem (spdm_context->connection_info.algorithm.pqc_kem_algo, sizeof(pqc_algo_t));
+  if (need_pqc_kem) {
+    spdm_context->connection_info.algorithm.pqc_kem_algo[SPDM_ALGORITHMS_PQC_KEY_ESTABLISHMENT_ALGO_KYBER_INDEX_BEGIN] = SPDM_ALGORITHMS_PQC_KEY_ESTABLISHMENT_ALGO_KYBER_512;
+  }
+
+  party[0] = &m_key_exchange_secret_requester;
+  party[1] = &m_key_exchange_secret_responder;
+  for (index = 0; index < ARRAY_SIZE(party); index++) {
+    zero_mem (party[index], sizeof(test_key_exchange_secret_party_t));
+    party[index]->secured_message_context = malloc (spdm_secured_message_get_context_size ());
+    assert_true(party[index]->secured_message_context != NULL);
+    spdm_secured_message_init_context (party[index]->secured_message_context);
+    spdm_secured_message_set_algorithms (
+      party[index]->secured_message_context,
+      spdm_context->connection_info.algorithm.bash_hash_algo,
+      spdm_context->connection_info.algorithm.dhe_named_group,
+      spdm_context->connection_info.algorithm.aead_cipher_suite,
+      spdm_context->connection_info.algorithm.key_schedule
+      );
+    spdm_secured_message_set_pqc_algorithms (party[index]->secured_message_context, spdm_context->connection_info.algorithm.pqc_kem_algo);
+
+    party[index]->dhe_context = spdm_secured_message_dhe_new (spdm_context->connection_info.algorithm.dhe_named_group);
+    assert_true(party[index]->dhe_context != NULL);
+    party[index]->dhe_public_key_size = spdm_get_dhe_pub_key_size (spdm_context->connection_info.algorithm.dhe_named_group);
+    result = spdm_secured_message_dhe_generate_key (
+               spdm_context->connection_info.algorithm.dhe_named_group,
+               party[index]->dhe_context,
+               party[index]->dhe_public_key,
+               &party[index]->dhe_public_key_size
+               );
+    assert_true(result);
+
+    if (need_pqc_kem) {
+      party[index]->pqc_kem_context = spdm_secured_message_pqc_kem_new (spdm_context->connection_info.algorithm.pqc_kem_algo);
+      assert_true(party[index]->pqc_kem_context != NULL);
+    }
+  }
+
+  //
+  // The requester sends the PQC KEM public key. The responder returns the cipher text.
+  //
+  if (need_pqc_kem) {
+    result = spdm_secured_message_pqc_kem_generate_key (spdm_context->connection_info.algorithm.pqc_kem_algo, m_key_exchange_secret_requester.pqc_kem_context);
+    assert_true(result);
+    m_key_exchange_secret_requester.pqc_kem_data_size = sizeof(m_key_exchange_secret_requester.pqc_kem_data);
+    result = spdm_secured_message_pqc_kem_get_public_key (
+               spdm_context->connection_info.algorithm.pqc_kem_algo,
+               m_key_exchange_secret_requester.pqc_kem_context,
+               m_key_exchange_secret_requester.pqc_kem_data,
+               &m_key_exchange_secret_requester.pqc_kem_data_size
+               );
+    assert_true(result);
+    assert_int_equal(m_key_exchange_secret_requester.pqc_kem_data_size, spdm_get_pqc_kem_public_key_size (spdm_context->connection_info.algorithm.pqc_kem_algo));
+  }
+}
+
+static
+void
+test_spdm_common_key_exchange_secret_teardown (
+  IN spdm_context_t  *spdm_context
+  )
+{
+  test_key_exchange_secret_party_t  *party[2];
+  uintn                             index;
+  uint8                             worker_thread_count;
+
+  party[0] = &m_key_exchange_secret_requester;
+  party[1] = &m_key_exchange_secret_responder;
+  for (index = 0; index < ARRAY_SIZE(party); index++) {
+    spdm_secured_message_dhe_free (spdm_context->connection_info.algorithm.dhe_named_group, party[index]->dhe_context);
+    if (party[index]->pqc_kem_context != NULL) {
+      spdm_secured_message_pqc_kem_free (spdm_context->connection_info.algorithm.pqc_kem_algo, party[index]->pqc_kem_context);
+    }
+    spdm_secured_message_deinit_context (party[index]->secured_message_context);
+    free (party[index]->secured_message_context);
+  }
+
+  worker_thread_count = 0;
+  spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, NULL, &worker_thread_count, sizeof(worker_thread_count));
+}
+
+/**
+  Compute the shared secrets on the responder side, then on the requester side,
+  and check that both parties import the same DHE secret || PQC KEM secret.
+**/
+static
+void
+test_spdm_common_key_exchange_secret_compute (
+  IN spdm_context_t  *spdm_context,
+  IN boolean         need_pqc_kem
+  )
+{
+  spdm_secured_message_context_t  *requester_secured_message_context;
+  spdm_secured_message_context_t  *responder_secured_message_context;
+  uint8                           dhe_secret[MAX_DHE_KEY_SIZE];
+  uintn                           dhe_secret_size;
+  boolean                         result;
+
+  m_key_exchange_secret_responder.pqc_kem_data_size = sizeof(m_key_exchange_secret_responder.pqc_kem_data);
+  result = spdm_compute_key_exchange_shared_secret (
+             spdm_context,
+             FALSE,
+             m_key_exchange_secret_responder.secured_message_context,
+             m_key_exchange_secret_responder.dhe_context,
+             m_key_exchange_secret_requester.dhe_public_key,
+             m_key_exchange_secret_requester.dhe_public_key_size,
+             m_key_exchange_secret_responder.pqc_kem_context,
+             m_key_exchange_secret_requester.pqc_kem_data,
+             m_key_exchange_secret_requester.pqc_kem_data_size,
+             m_key_exchange_secret_responder.pqc_kem_data,
+             &m_key_exchange_secret_responder.pqc_kem_data_size
+             );
+  assert_true(result);
+  if (need_pqc_kem) {
+    assert_int_equal(m_key_exchange_secret_responder.pqc_kem_data_size, spdm_get_pqc_kem_cipher_text_size (spdm_context->connection_info.algorithm.pqc_kem_algo));
+  }
+
+  result = spdm_compute_key_exchange_shared_secret (
+             spdm_context,
+             TRUE,
+             m_key_exchange_secret_requester.secured_message_context,
+             m_key_exchange_secret_requester.dhe_context,
+             m_key_exchange_secret_responder.dhe_public_key,
+             m_key_exchange_secret_responder.dhe_public_key_size,
+             m_key_exchange_secret_requester.pqc_kem_context,
+             m_key_exchange_secret_responder.pqc_kem_data,
+             m_key_exchange_secret_responder.pqc_kem_data_size,
+             NULL,
+             NULL
+             );
+  assert_true(result);
+
+  //
+  // The DHE secret is always imported first, at the beginning of the shared secret.
+  //
+  dhe_secret_size = sizeof(dhe_secret);
+  result = spdm_dhe_compute_key (
+             spdm_context->connection_info.algorithm.dhe_named_group,
+             m_key_exchange_secret_requester.dhe_context,
+             m_key_exchange_secret_responder.dhe_public_key,
+             m_key_exchange_secret_responder.dhe_public_key_size,
+             dhe_secret,
+             &dhe_secret_size
+             );
+  assert_true(result);
+
+  requester_secured_message_context = m_key_exchange_secret_requester.secured_message_context;
+  responder_secured_message_context = m_key_exchange_secret_responder.secured_message_context;
+  assert_int_equal(requester_secured_message_context->dhe_key_size, dhe_secret_size);
+  assert_int_equal(responder_secured_message_context->dhe_key_size, dhe_secret_size);
+  assert_memory_equal(requester_secured_message_context->master_secret.shared_secret, dhe_secret, dhe_secret_size);
+  assert_memory_equal(responder_secured_message_context->master_secret.shared_secret, dhe_secret, dhe_secret_size);
+
+  if (need_pqc_kem) {
+    assert_int_equal(requester_secured_message_context->pqc_shared_secret_size, responder_secured_message_context->pqc_shared_secret_size);
+    assert_true(requester_secured_message_context->pqc_shared_secret_size != 0);
+    assert_memory_equal(requester_secured_message_context->master_secret.shared_secret + dhe_secret_size,
+                        responder_secured_message_context->master_secret.shared_secret + dhe_secret_size,
+                        requester_secured_message_context->pqc_shared_secret_size);
+  }
+}
+
+/**
+  Test 1: compute the hybrid KEY_EXCHANGE shared secrets without the worker pool.
+  Expected Behavior: both parties import DHE secret || PQC KEM secret, and the secrets match.
+**/
+void test_spdm_common_key_exchange_secret_case1(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  test_spdm_common_key_exchange_secret_setup (spdm_context, 0, TRUE);
+
+  test_spdm_common_key_exchange_secret_compute (spdm_context, TRUE);
+
+  test_spdm_common_key_exchange_secret_teardown (spdm_context);
+}
+
+/**
+  Test 2: compute the hybrid KEY_EXCHANGE shared secrets with the worker pool.
+  Expected Behavior: both parties import DHE secret || PQC KEM secret in the fixed order, and the secrets match.
+**/
+void test_spdm_common_key_exchange_secret_case2(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  test_spdm_common_key_exchange_secret_setup (spdm_context, 2, TRUE);
+
+  test_spdm_common_key_exchange_secret_compute (spdm_context, TRUE);
+
+  test_spdm_common_key_exchange_secret_teardown (spdm_context);
+}
+
+/**
+  Test 3: compute the KEY_EXCHANGE shared secret with the worker pool, when no PQC KEM is negotiated.
+  Expected Behavior: only the DHE secret is imported, and it matches on both parties.
+**/
+void test_spdm_common_key_exchange_secret_case3(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  test_spdm_common_key_exchange_secret_setup (spdm_context, 2, FALSE);
+
+  test_spdm_common_key_exchange_secret_compute (spdm_context, FALSE);
+
+  test_spdm_common_key_exchange_secret_teardown (spdm_context);
+}
+
+/**
+  Test 4: the peer DHE public key is invalid, while the PQC KEM encapsulation succeeds.
+  Expected Behavior: the shared secret computation fails with the worker pool.
+**/
+void test_spdm_common_key_exchange_secret_case4(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  boolean              result;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x4;
+  test_spdm_common_key_exchange_secret_setup (spdm_context, 2, TRUE);
+
+  zero_mem (m_key_exchange_secret_requester.dhe_public_key, m_key_exchange_secret_requester.dhe_public_key_size);
+  m_key_exchange_secret_responder.pqc_kem_data_size = sizeof(m_key_exchange_secret_responder.pqc_kem_data);
+  result = spdm_compute_key_exchange_shared_secret (
+             spdm_context,
+             FALSE,
+             m_key_exchange_secret_responder.secured_message_context,
+             m_key_exchange_secret_responder.dhe_context,
+             m_key_exchange_secret_requester.dhe_public_key,
+             m_key_exchange_secret_requester.dhe_public_key_size,
+             m_key_exchange_secret_responder.pqc_kem_context,
+             m_key_exchange_secret_requester.pqc_kem_data,
+             m_key_exchange_secret_requester.pqc_kem_data_size,
+             m_key_exchange_secret_responder.pqc_kem_data,
+             &m_key_exchange_secret_responder.pqc_kem_data_size
+             );
+  assert_int_equal(result, FALSE);
+
+  test_spdm_common_key_exchange_secret_teardown (spdm_context);
+}
+
+spdm_test_context_t       m_spdm_common_key_exchange_secret_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_common_key_exchange_secret_test_main(void) {
+  const struct CMUnitTest spdm_common_key_exchange_secret_tests[] = {
+      // Hybrid shared secrets without the worker pool
+      cmocka_unit_test(test_spdm_common_key_exchange_secret_case1),
+      // Hybrid shared secrets with the worker pool
+      cmocka_unit_test(test_spdm_common_key_exchange_secret_case2),
+      // DHE shared secret only with the worker pool
+      cmocka_unit_test(test_spdm_common_key_exchange_secret_case3),
+      // Invalid peer DHE public key with the worker pool
+      cmocka_unit_test(test_spdm_common_key_exchange_secret_case4),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_key_exchange_secret_test_context);
+
+  return cmocka_run_group_tests(spdm_common_key_exchange_secret_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
@@ -0,0 +1,197 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+#include <library/threadlib.h>
+
+#define TEST_KEY_POOL_WAIT_COUNT  10000
+
+/**
+  Wait until the worker thread has filled the key pool with key_count keys.
+**/
+static
+boolean
+test_spdm_common_key_pool_wait (
+  IN spdm_context_t  *spdm_context,
+  IN uint8           key_count
+  )
+{
+  spdm_key_pool_t  *key_pool;
+  uintn            index;
+  boolean          result;
+
+  key_pool = &spdm_context->key_pool;
+  for (index = 0; index < TEST_KEY_POOL_WAIT_COUNT; index++) {
+    mutex_lock (key_pool->mutex);
+    result = (boolean)(key_pool->key_count == key_count);
+    mutex_unlock (key_pool->mutex);
+    if (result) {
+      return TRUE;
+    }
+    thread_sleep (1000);
+  }
+  return FALSE;
+}
+
+static
+void
+test_spdm_common_key_pool_set_depth (
+  IN spdm_context_t  *spdm_context,
+  IN uint8           depth
+  )
+{
+  return_status    status;
+
+  status = spdm_set_data (spdm_context, SPDM_DATA_KEY_POOL_DEPTH, NULL, &depth, sizeof(depth));
+  assert_int_equal(status, RETURN_SUCCESS);
+}
+
+/**
+  Test 1: the key pool is disabled.
+  Expected Behavior: no worker thread is started and no key is returned.
+**/
+void test_spdm_common_key_pool_case1(void **state) {
+  spdm_test_context_t   *spdm_test_context;
+  spdm_context_t        *spdm_context;
+  spdm_ephemeral_key_t  ephemeral_key;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo;
+  zero_mem (spdm_context->connection_info.algorithm.pqc_kem_algo, sizeof(pqc_algo_t));
+  test_spdm_common_key_pool_set_depth (spdm_context, 0);
+
+  spdm_key_pool_start (spdm_context);
+  assert_true(spdm_context->key_pool.thread == NULL);
+  assert_int_equal(spdm_key_pool_acquire (spdm_context, &ephemeral_key), FALSE);
+  assert_true(spdm_context->key_pool.thread == NULL);
+}
+
+/**
+  Test 2: the key pool is started and a key is acquired.
+  Expected Behavior: the pool is filled up to the high watermark, an acquired key is removed from the pool,
+  and the pool is refilled once it drops to the low watermark.
+**/
+void test_spdm_common_key_pool_case2(void **state) {
+  spdm_test_context_t   *spdm_test_context;
+  spdm_context_t        *spdm_context;
+  spdm_ephemeral_key_t  ephemeral_key;
+  uintn                 index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo;
+  zero_mem (spdm_context->connection_info.algorithm.pqc_kem_algo, sizeof(pqc_algo_t));
+  test_spdm_common_key_pool_set_depth (spdm_context, 4);
+
+  spdm_key_pool_start (spdm_context);
+  assert_true(spdm_context->key_pool.thread != NULL);
+  assert_true(test_spdm_common_key_pool_wait (spdm_context, 4));
+
+  for (index = 0; index < 2; index++) {
+    assert_true(spdm_key_pool_acquire (spdm_context, &ephemeral_key));
+    assert_true(ephemeral_key.dhe_context != NULL);
+    assert_true(ephemeral_key.pqc_kem_context == NULL);
+    spdm_secured_message_dhe_free (m_use_dhe_algo, ephemeral_key.dhe_context);
+  }
+
+  // The second key brought the pool down to the low watermark.
+  assert_true(test_spdm_common_key_pool_wait (spdm_context, 4));
+
+  spdm_key_pool_stop (spdm_context);
+}
+
+/**
+  Test 3: the negotiated DHE group changes.
+  Expected Behavior: no key of the old group is returned, and the pool is refilled with keys of the new group.
+**/
+void test_spdm_common_key_pool_case3(void **state) {
+  spdm_test_context_t   *spdm_test_context;
+  spdm_context_t        *spdm_context;
+  spdm_ephemeral_key_t  ephemeral_key;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo;
+  zero_mem (spdm_context->connection_info.algorithm.pqc_kem_algo, sizeof(pqc_algo_t));
+  test_spdm_common_key_pool_set_depth (spdm_context, 2);
+
+  spdm_key_pool_start (spdm_context);
+  assert_true(test_spdm_common_key_pool_wait (spdm_context, 2));
+
+  spdm_context->connection_info.algorithm.dhe_named_group = SPDM_ALGORITHMS_DHE_NAMED_GROUP_SECP_384_R1;
+  assert_int_equal(spdm_key_pool_acquire (spdm_context, &ephemeral_key), FALSE);
+  assert_int_equal(spdm_context->key_pool.dhe_named_group, SPDM_ALGORITHMS_DHE_NAMED_GROUP_SECP_384_R1);
+  assert_true(test_spdm_common_key_pool_wait (spdm_context, 2));
+
+  assert_true(spdm_key_pool_acquire (spdm_context, &ephemeral_key));
+  spdm_secured_message_dhe_free (SPDM_ALGORITHMS_DHE_NAMED_GROUP_SECP_384_R1, ephemeral_key.dhe_context);
+
+  spdm_key_pool_stop (spdm_context);
+}
+
+/**
+  Test 4: the key pool is stopped.
+  Expected Behavior: the worker thread exits, the keys are freed, and the next acquire restarts the pool.
+**/
+void test_spdm_common_key_pool_case4(void **state) {
+  spdm_test_context_t   *spdm_test_context;
+  spdm_context_t        *spdm_context;
+  spdm_ephemeral_key_t  ephemeral_key;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x4;
+  spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo;
+  zero_mem (spdm_context->connection_info.algorithm.pqc_kem_algo, sizeof(pqc_algo_t));
+  test_spdm_common_key_pool_set_depth (spdm_context, 2);
+
+  spdm_key_pool_start (spdm_context);
+  assert_true(test_spdm_common_key_pool_wait (spdm_context, 2));
+
+  spdm_key_pool_stop (spdm_context);
+  assert_true(spdm_context->key_pool.thread == NULL);
+  assert_true(spdm_context->key_pool.mutex == NULL);
+  assert_int_equal(spdm_context->key_pool.key_count, 0);
+
+  assert_int_equal(spdm_key_pool_acquire (spdm_context, &ephemeral_key), FALSE);
+  assert_true(spdm_context->key_pool.thread != NULL);
+  assert_true(test_spdm_common_key_pool_wait (spdm_context, 2));
+
+  // Setting the depth stops the pool.
+  test_spdm_common_key_pool_set_depth (spdm_context, 0);
+  assert_true(spdm_context->key_pool.thread == NULL);
+  assert_int_equal(spdm_context->key_pool.key_count, 0);
+}
+
+spdm_test_context_t       m_spdm_common_key_pool_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  TRUE,
+};
+
+int spdm_common_key_pool_test_main(void) {
+  const struct CMUnitTest spdm_common_key_pool_tests[] = {
+      // Pool disabled
+      cmocka_unit_test(test_spdm_common_key_pool_case1),
+      // Start, acquire and refill
+      cmocka_unit_test(test_spdm_common_key_pool_case2),
+      // DHE group changes
+      cmocka_unit_test(test_spdm_common_key_pool_case3),
+      // Stop and restart
+      cmocka_unit_test(test_spdm_common_key_pool_case4),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_key_pool_test_context);
+
+  return cmocka_run_group_tests(spdm_common_key_pool_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
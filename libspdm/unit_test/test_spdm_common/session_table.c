@@ -0,0 +1,263 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+
+#define TEST_SESSION_TABLE_COUNT  8
+
+static uint8  m_session_table_message[0x100];
+
+static
+void
+test_spdm_common_session_table_setup (
+  IN spdm_context_t  *spdm_context,
+  IN uint32          max_session_count
+  )
+{
+  return_status  status;
+
+  spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
+  spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo;
+  spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
+  spdm_context->connection_info.algorithm.key_schedule = m_use_key_schedule_algo;
+  status = spdm_set_data (spdm_context, SPDM_DATA_MAX_SESSION_COUNT, NULL, &max_session_count, sizeof(max_session_count));
+  assert_int_equal(status, RETURN_SUCCESS);
+  assert_int_equal(spdm_context->max_session_count, max_session_count);
+  assert_int_equal(spdm_context->session_count, 0);
+}
+
+/**
+  Return a session ID which is different from session_id, but is in the same hash bucket.
+**/
+static
+uint32
+test_spdm_common_session_table_get_colliding_id (
+  IN spdm_context_t  *spdm_context,
+  IN uint32          session_id
+  )
+{
+  uint32  candidate;
+
+  for (candidate = session_id + 1; candidate != INVALID_SESSION_ID; candidate++) {
+    if (spdm_session_hash_index (spdm_context, candidate) == spdm_session_hash_index (spdm_context, session_id)) {
+      return candidate;
+    }
+  }
+  assert_true(FALSE);
+  return INVALID_SESSION_ID;
+}
+
+/**
+  Test 1: sessions are assigned, and two of them are in the same hash bucket.
+  Expected Behavior: every session ID is found with its own session info, and an unknown session ID is not found.
+**/
+void test_spdm_common_session_table_case1(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint32               session_id[4];
+  spdm_session_info_t  *session_info[4];
+  uintn                index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  test_spdm_common_session_table_setup (spdm_context, TEST_SESSION_TABLE_COUNT);
+
+  session_id[0] = 0xFFFFFFFE;
+  session_id[1] = 0xFFFEFFFF;
+  session_id[2] = 0x12345678;
+  session_id[3] = test_spdm_common_session_table_get_colliding_id (spdm_context, session_id[2]);
+  for (index = 0; index < ARRAY_SIZE(session_id); index++) {
+    session_info[index] = spdm_assign_session_id (spdm_context, session_id[index], (boolean)(index & 1));
+    assert_true(session_info[index] != NULL);
+    assert_int_equal(session_info[index]->session_id, session_id[index]);
+    assert_int_equal(session_info[index]->use_psk, (boolean)(index & 1));
+    assert_true(session_info[index]->secured_message_context != NULL);
+  }
+  assert_int_equal(spdm_context->session_count, ARRAY_SIZE(session_id));
+  assert_int_equal(spdm_context->latest_session_id, session_id[3]);
+
+  for (index = 0; index < ARRAY_SIZE(session_id); index++) {
+    assert_true(spdm_get_session_info_via_session_id (spdm_context, session_id[index]) == session_info[index]);
+    assert_true(spdm_get_secured_message_context_via_session_id (spdm_context, session_id[index]) == session_info[index]->secured_message_context);
+  }
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, 0x87654321) == NULL);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, test_spdm_common_session_table_get_colliding_id (spdm_context, session_id[3])) == NULL);
+
+  for (index = 0; index < ARRAY_SIZE(session_id); index++) {
+    spdm_free_session_id (spdm_context, session_id[index]);
+  }
+  assert_int_equal(spdm_context->session_count, 0);
+}
+
+/**
+  Test 2: sessions in the same hash bucket are freed.
+  Expected Behavior: a freed session ID is not found, and the other session IDs are still found.
+**/
+void test_spdm_common_session_table_case2(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  uint32               session_id[3];
+  spdm_session_info_t  *session_info[3];
+  uintn                index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  test_spdm_common_session_table_setup (spdm_context, TEST_SESSION_TABLE_COUNT);
+
+  session_id[0] = 0x10000000;
+  session_id[1] = test_spdm_common_session_table_get_colliding_id (spdm_context, session_id[0]);
+  session_id[2] = test_spdm_common_session_table_get_colliding_id (spdm_context, session_id[1]);
+  for (index = 0; index < ARRAY_SIZE(session_id); index++) {
+    session_info[index] = spdm_assign_session_id (spdm_context, session_id[index], FALSE);
+    assert_true(session_info[index] != NULL);
+  }
+
+  //
+  // The bucket is session_id[2], session_id[1], session_id[0]. Free the session in the middle.
+  //
+  assert_true(spdm_free_session_id (spdm_context, session_id[1]) == session_info[1]);
+  assert_int_equal(spdm_context->session_count, 2);
+  assert_int_equal(session_info[1]->session_id, INVALID_SESSION_ID);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, session_id[1]) == NULL);
+  assert_true(spdm_get_secured_message_context_via_session_id (spdm_context, session_id[1]) == NULL);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, session_id[0]) == session_info[0]);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, session_id[2]) == session_info[2]);
+
+  assert_true(spdm_free_session_id (spdm_context, session_id[2]) == session_info[2]);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, session_id[2]) == NULL);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, session_id[0]) == session_info[0]);
+
+  assert_true(spdm_free_session_id (spdm_context, session_id[0]) == session_info[0]);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, session_id[0]) == NULL);
+  assert_int_equal(spdm_context->session_count, 0);
+}
+
+/**
+  Test 3: a freed session slot is reused by a new session ID.
+  Expected Behavior: the reused session info and its secured message context are zeroed,
+  except the new session ID and use_psk.
+**/
+void test_spdm_common_session_table_case3(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  spdm_session_info_t  *session_info;
+  spdm_session_info_t  *new_session_info;
+  void                 *secured_message_context;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  test_spdm_common_session_table_setup (spdm_context, TEST_SESSION_TABLE_COUNT);
+
+  session_info = spdm_assign_session_id (spdm_context, 0xFFFFFFFE, TRUE);
+  assert_true(session_info != NULL);
+  session_info->mut_auth_requested = SPDM_KEY_EXCHANGE_RESPONSE_MUT_AUTH_REQUESTED;
+  session_info->end_session_attributes = SPDM_END_SESSION_REQUEST_ATTRIBUTES_PRESERVE_NEGOTIATED_STATE_CLEAR;
+  set_mem (m_session_table_message, sizeof(m_session_table_message), 0x5A);
+  assert_int_equal(append_managed_buffer (&session_info->session_transcript.message_k, m_session_table_message, sizeof(m_session_table_message)), RETURN_SUCCESS);
+  assert_int_equal(append_managed_buffer (&session_info->session_transcript.message_f, m_session_table_message, sizeof(m_session_table_message)), RETURN_SUCCESS);
+  secured_message_context = session_info->secured_message_context;
+  spdm_secured_message_set_session_state (secured_message_context, SPDM_SESSION_STATE_ESTABLISHED);
+
+  spdm_free_session_id (spdm_context, 0xFFFFFFFE);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, 0xFFFFFFFE) == NULL);
+
+  //
+  // The freed session is at the head of the free list, so it is assigned next.
+  //
+  new_session_info = spdm_assign_session_id (spdm_context, 0xFFFDFFFD, FALSE);
+  assert_true(new_session_info == session_info);
+  assert_int_equal(new_session_info->session_id, 0xFFFDFFFD);
+  assert_int_equal(new_session_info->use_psk, FALSE);
+  assert_int_equal(new_session_info->mut_auth_requested, 0);
+  assert_int_equal(new_session_info->end_session_attributes, 0);
+  assert_int_equal(get_managed_buffer_size (&new_session_info->session_transcript.message_k), 0);
+  assert_int_equal(get_managed_buffer_size (&new_session_info->session_transcript.message_f), 0);
+  assert_true(new_session_info->session_transcript.message_k.buffer == NULL);
+  assert_true(new_session_info->session_transcript.message_f.buffer == NULL);
+  assert_int_equal(new_session_info->session_transcript.digest_th.valid, FALSE);
+  assert_true(new_session_info->secured_message_context == secured_message_context);
+  assert_int_equal(spdm_secured_message_get_session_state (secured_message_context), SPDM_SESSION_STATE_NOT_STARTED);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, 0xFFFDFFFD) == new_session_info);
+
+  spdm_free_session_id (spdm_context, 0xFFFDFFFD);
+}
+
+/**
+  Test 4: all sessions of the session table are in use.
+  Expected Behavior: no session ID can be assigned until a session is freed, and the table cannot be resized while a session is in use.
+**/
+void test_spdm_common_session_table_case4(void **state) {
+  spdm_test_context_t  *spdm_test_context;
+  spdm_context_t       *spdm_context;
+  spdm_session_info_t  *session_info[2];
+  uint16               rsp_session_id;
+  uint32               max_session_count;
+  return_status        status;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x4;
+  test_spdm_common_session_table_setup (spdm_context, 2);
+
+  rsp_session_id = spdm_allocate_rsp_session_id (spdm_context);
+  session_info[0] = spdm_assign_session_id (spdm_context, ((uint32)0xFFFF << 16) | rsp_session_id, FALSE);
+  assert_true(session_info[0] != NULL);
+  rsp_session_id = spdm_allocate_rsp_session_id (spdm_context);
+  session_info[1] = spdm_assign_session_id (spdm_context, ((uint32)0xFFFF << 16) | rsp_session_id, FALSE);
+  assert_true(session_info[1] != NULL);
+  assert_true(session_info[1] != session_info[0]);
+  assert_int_equal(spdm_context->session_count, 2);
+
+  assert_int_equal(spdm_allocate_rsp_session_id (spdm_context), INVALID_SESSION_ID & 0xFFFF);
+  assert_int_equal(spdm_allocate_req_session_id (spdm_context), (INVALID_SESSION_ID & 0xFFFF0000) >> 16);
+  assert_true(spdm_assign_session_id (spdm_context, 0x11112222, FALSE) == NULL);
+  assert_int_equal(spdm_context->session_count, 2);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, 0x11112222) == NULL);
+
+  max_session_count = TEST_SESSION_TABLE_COUNT;
+  status = spdm_set_data (spdm_context, SPDM_DATA_MAX_SESSION_COUNT, NULL, &max_session_count, sizeof(max_session_count));
+  assert_int_equal(status, RETURN_ACCESS_DENIED);
+  assert_int_equal(spdm_context->max_session_count, 2);
+
+  spdm_free_session_id (spdm_context, session_info[0]->session_id);
+  assert_true(spdm_assign_session_id (spdm_context, 0x11112222, FALSE) == session_info[0]);
+  assert_true(spdm_get_session_info_via_session_id (spdm_context, 0x11112222) == session_info[0]);
+
+  spdm_free_session_id (spdm_context, 0x11112222);
+  spdm_free_session_id (spdm_context, session_info[1]->session_id);
+  assert_int_equal(spdm_context->session_count, 0);
+
+  test_spdm_common_session_table_setup (spdm_context, MAX_SPDM_SESSION_COUNT);
+}
+
+spdm_test_context_t       m_spdm_common_session_table_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_common_session_table_test_main(void) {
+  const struct CMUnitTest spdm_common_session_table_tests[] = {
+      // Session lookup with a shared hash bucket
+      cmocka_unit_test(test_spdm_common_session_table_case1),
+      // Free sessions in a shared hash bucket
+      cmocka_unit_test(test_spdm_common_session_table_case2),
+      // Reused session slot is zeroed
+      cmocka_unit_test(test_spdm_common_session_table_case3),
+      // Session table exhaustion
+      cmocka_unit_test(test_spdm_common_session_table_case4),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_session_table_test_context);
+
+  return cmocka_run_group_tests(spdm_common_session_table_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
@@ -0,0 +1,42 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+
+int spdm_common_transcript_hash_test_main (void);
+int spdm_common_transcript_segment_test_main (void);
+int spdm_common_key_pool_test_main (void);
+int spdm_common_worker_pool_test_main (void);
+int spdm_common_hybrid_signature_test_main (void);
+int spdm_common_key_exchange_secret_test_main (void);
+int spdm_common_arena_test_main (void);
+int spdm_common_session_table_test_main (void);
+int spdm_common_cert_chain_verify_test_main (void);
+
+int main(void) {
+  spdm_common_transcript_hash_test_main ();
+
+  spdm_common_transcript_segment_test_main ();
+
+  spdm_common_key_pool_test_main ();
+
+  spdm_common_worker_pool_test_main ();
+
+  spdm_common_hybrid_signature_test_main ();
+
+  spdm_common_key_exchange_secret_test_main ();
+
+  spdm_common_arena_test_main ();
+
+  spdm_common_session_table_test_main ();
+
+  spdm_common_cert_chain_verify_test_main ();
+  return 0;
+}
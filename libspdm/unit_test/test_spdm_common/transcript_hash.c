@@ -0,0 +1,240 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+
+#define TEST_TRANSCRIPT_A_SIZE     0x60
+#define TEST_TRANSCRIPT_CT_SIZE    0x200
+#define TEST_TRANSCRIPT_K_SIZE     0x80
+
+static uint8  m_transcript_a[TEST_TRANSCRIPT_A_SIZE];
+static uint8  m_transcript_ct[TEST_TRANSCRIPT_CT_SIZE];
+static uint8  m_transcript_k[TEST_TRANSCRIPT_K_SIZE];
+
+/**
+  Hash Concatenate (A[0..a_size], hash(Ct), K[0..k_size]) in one shot, as the transcript was hashed before
+  the running hash was introduced.
+**/
+static
+void
+test_spdm_common_transcript_hash_full (
+  IN  uint32  bash_hash_algo,
+  IN  uintn   a_size,
+  IN  uintn   k_size,
+  OUT uint8   *hash_value
+  )
+{
+  uint8   buffer[TEST_TRANSCRIPT_A_SIZE + MAX_HASH_SIZE + TEST_TRANSCRIPT_K_SIZE];
+  uintn   hash_size;
+  boolean result;
+
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  copy_mem (buffer, m_transcript_a, a_size);
+  result = spdm_hash_all (bash_hash_algo, m_transcript_ct, sizeof(m_transcript_ct), buffer + a_size);
+  assert_true(result);
+  copy_mem (buffer + a_size + hash_size, m_transcript_k, k_size);
+  result = spdm_hash_all (bash_hash_algo, buffer, a_size + hash_size + k_size, hash_value);
+  assert_true(result);
+}
+
+static
+void
+test_spdm_common_transcript_hash_init_segment (
+  OUT spdm_transcript_segment_t  *segment,
+  IN  uintn                      a_size,
+  IN  uintn                      k_size
+  )
+{
+  segment[0].data = m_transcript_a;
+  segment[0].size = a_size;
+  segment[0].hash_data = FALSE;
+  segment[1].data = m_transcript_ct;
+  segment[1].size = sizeof(m_transcript_ct);
+  segment[1].hash_data = TRUE;
+  segment[2].data = m_transcript_k;
+  segment[2].size = k_size;
+  segment[2].hash_data = FALSE;
+}
+
+static
+void
+test_spdm_common_transcript_hash_init_data (
+  void
+  )
+{
+  uintn  index;
+
+  for (index = 0; index < sizeof(m_transcript_a); index++) {
+    m_transcript_a[index] = (uint8)index;
+  }
+  for (index = 0; index < sizeof(m_transcript_ct); index++) {
+    m_transcript_ct[index] = (uint8)(index * 3);
+  }
+  for (index = 0; index < sizeof(m_transcript_k); index++) {
+    m_transcript_k[index] = (uint8)(0xFF - index);
+  }
+}
+
+/**
+  Test 1: the transcript grows between checkpoints.
+  Expected Behavior: every checkpoint of the running hash matches the hash of the whole transcript.
+**/
+void test_spdm_common_transcript_hash_case1(void **state) {
+  spdm_transcript_hash_t     transcript_hash;
+  spdm_transcript_segment_t  segment[3];
+  uint8                      hash_value[MAX_HASH_SIZE];
+  uint8                      expected_hash_value[MAX_HASH_SIZE];
+  uint32                     bash_hash_algo;
+  uintn                      k_size;
+  boolean                    result;
+
+  bash_hash_algo = m_use_hash_algo;
+  test_spdm_common_transcript_hash_init_data ();
+  spdm_transcript_hash_reset (&transcript_hash);
+
+  for (k_size = 0; k_size <= TEST_TRANSCRIPT_K_SIZE; k_size += 0x20) {
+    test_spdm_common_transcript_hash_init_segment (segment, TEST_TRANSCRIPT_A_SIZE, k_size);
+    result = spdm_transcript_hash_calculate (&transcript_hash, bash_hash_algo, segment, 3, hash_value);
+    assert_true(result);
+    test_spdm_common_transcript_hash_full (bash_hash_algo, TEST_TRANSCRIPT_A_SIZE, k_size, expected_hash_value);
+    assert_memory_equal(hash_value, expected_hash_value, spdm_get_hash_size (bash_hash_algo));
+  }
+}
+
+/**
+  Test 2: an earlier segment grows after a later segment was consumed.
+  Expected Behavior: the running hash restarts and still matches the hash of the whole transcript.
+**/
+void test_spdm_common_transcript_hash_case2(void **state) {
+  spdm_transcript_hash_t     transcript_hash;
+  spdm_transcript_segment_t  segment[3];
+  uint8                      hash_value[MAX_HASH_SIZE];
+  uint8                      expected_hash_value[MAX_HASH_SIZE];
+  uint32                     bash_hash_algo;
+  boolean                    result;
+
+  bash_hash_algo = m_use_hash_algo;
+  test_spdm_common_transcript_hash_init_data ();
+  spdm_transcript_hash_reset (&transcript_hash);
+
+  test_spdm_common_transcript_hash_init_segment (segment, TEST_TRANSCRIPT_A_SIZE / 2, TEST_TRANSCRIPT_K_SIZE / 2);
+  result = spdm_transcript_hash_calculate (&transcript_hash, bash_hash_algo, segment, 3, hash_value);
+  assert_true(result);
+
+  test_spdm_common_transcript_hash_init_segment (segment, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE / 2);
+  result = spdm_transcript_hash_calculate (&transcript_hash, bash_hash_algo, segment, 3, hash_value);
+  assert_true(result);
+  test_spdm_common_transcript_hash_full (bash_hash_algo, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE / 2, expected_hash_value);
+  assert_memory_equal(hash_value, expected_hash_value, spdm_get_hash_size (bash_hash_algo));
+}
+
+/**
+  Test 3: the last segment shrinks.
+  Expected Behavior: the running hash restarts and still matches the hash of the whole transcript.
+**/
+void test_spdm_common_transcript_hash_case3(void **state) {
+  spdm_transcript_hash_t     transcript_hash;
+  spdm_transcript_segment_t  segment[3];
+  uint8                      hash_value[MAX_HASH_SIZE];
+  uint8                      expected_hash_value[MAX_HASH_SIZE];
+  uint32                     bash_hash_algo;
+  boolean                    result;
+
+  bash_hash_algo = m_use_hash_algo;
+  test_spdm_common_transcript_hash_init_data ();
+  spdm_transcript_hash_reset (&transcript_hash);
+
+  test_spdm_common_transcript_hash_init_segment (segment, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE);
+  result = spdm_transcript_hash_calculate (&transcript_hash, bash_hash_algo, segment, 3, hash_value);
+  assert_true(result);
+
+  test_spdm_common_transcript_hash_init_segment (segment, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE / 2);
+  result = spdm_transcript_hash_calculate (&transcript_hash, bash_hash_algo, segment, 3, hash_value);
+  assert_true(result);
+  test_spdm_common_transcript_hash_full (bash_hash_algo, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE / 2, expected_hash_value);
+  assert_memory_equal(hash_value, expected_hash_value, spdm_get_hash_size (bash_hash_algo));
+}
+
+/**
+  Test 4: the transcript is rewritten with the same size after spdm_transcript_hash_reset.
+  Expected Behavior: the running hash matches the hash of the new transcript.
+**/
+void test_spdm_common_transcript_hash_case4(void **state) {
+  spdm_transcript_hash_t     transcript_hash;
+  spdm_transcript_segment_t  segment[3];
+  uint8                      hash_value[MAX_HASH_SIZE];
+  uint8                      expected_hash_value[MAX_HASH_SIZE];
+  uint32                     bash_hash_algo;
+  boolean                    result;
+
+  bash_hash_algo = m_use_hash_algo;
+  test_spdm_common_transcript_hash_init_data ();
+  spdm_transcript_hash_reset (&transcript_hash);
+
+  test_spdm_common_transcript_hash_init_segment (segment, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE);
+  result = spdm_transcript_hash_calculate (&transcript_hash, bash_hash_algo, segment, 3, hash_value);
+  assert_true(result);
+
+  set_mem (m_transcript_k, sizeof(m_transcript_k), 0x5A);
+  spdm_transcript_hash_reset (&transcript_hash);
+  result = spdm_transcript_hash_calculate (&transcript_hash, bash_hash_algo, segment, 3, hash_value);
+  assert_true(result);
+  test_spdm_common_transcript_hash_full (bash_hash_algo, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE, expected_hash_value);
+  assert_memory_equal(hash_value, expected_hash_value, spdm_get_hash_size (bash_hash_algo));
+}
+
+/**
+  Test 5: the running hash is used with a different hash algorithm.
+  Expected Behavior: the running hash restarts with the new algorithm.
+**/
+void test_spdm_common_transcript_hash_case5(void **state) {
+  spdm_transcript_hash_t     transcript_hash;
+  spdm_transcript_segment_t  segment[3];
+  uint8                      hash_value[MAX_HASH_SIZE];
+  uint8                      expected_hash_value[MAX_HASH_SIZE];
+  boolean                    result;
+
+  test_spdm_common_transcript_hash_init_data ();
+  spdm_transcript_hash_reset (&transcript_hash);
+
+  test_spdm_common_transcript_hash_init_segment (segment, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE / 2);
+  result = spdm_transcript_hash_calculate (&transcript_hash, SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256, segment, 3, hash_value);
+  assert_true(result);
+
+  test_spdm_common_transcript_hash_init_segment (segment, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE);
+  result = spdm_transcript_hash_calculate (&transcript_hash, SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384, segment, 3, hash_value);
+  assert_true(result);
+  test_spdm_common_transcript_hash_full (SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384, TEST_TRANSCRIPT_A_SIZE, TEST_TRANSCRIPT_K_SIZE, expected_hash_value);
+  assert_memory_equal(hash_value, expected_hash_value, spdm_get_hash_size (SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384));
+}
+
+spdm_test_context_t       m_spdm_common_transcript_hash_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_common_transcript_hash_test_main(void) {
+  const struct CMUnitTest spdm_common_transcript_hash_tests[] = {
+      // Transcript grows between checkpoints
+      cmocka_unit_test(test_spdm_common_transcript_hash_case1),
+      // Earlier segment grows after a later segment was consumed
+      cmocka_unit_test(test_spdm_common_transcript_hash_case2),
+      // Last segment shrinks
+      cmocka_unit_test(test_spdm_common_transcript_hash_case3),
+      // Transcript rewritten with the same size after reset
+      cmocka_unit_test(test_spdm_common_transcript_hash_case4),
+      // Hash algorithm changes
+      cmocka_unit_test(test_spdm_common_transcript_hash_case5),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_transcript_hash_test_context);
+
+  return cmocka_run_group_tests(spdm_common_transcript_hash_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
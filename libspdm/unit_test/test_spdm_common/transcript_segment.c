@@ -0,0 +1,230 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+
+#define TEST_TRANSCRIPT_MESSAGE_SIZE  0x40
+#define TEST_TRANSCRIPT_CERT_SIZE     0x180
+
+static uint8  m_transcript_message[5][TEST_TRANSCRIPT_MESSAGE_SIZE];
+static uint8  m_transcript_cert_chain[TEST_TRANSCRIPT_CERT_SIZE];
+static uint8  m_transcript_mut_cert_chain[TEST_TRANSCRIPT_CERT_SIZE];
+
+static
+void
+test_spdm_common_transcript_segment_init_data (
+  void
+  )
+{
+  uintn  index;
+
+  for (index = 0; index < ARRAY_SIZE(m_transcript_message); index++) {
+    set_mem (m_transcript_message[index], sizeof(m_transcript_message[index]), (uint8)(0x10 + index));
+  }
+  for (index = 0; index < sizeof(m_transcript_cert_chain); index++) {
+    m_transcript_cert_chain[index] = (uint8)index;
+    m_transcript_mut_cert_chain[index] = (uint8)(0xFF - index);
+  }
+}
+
+static
+void
+test_spdm_common_transcript_segment_reset (
+  IN spdm_context_t  *spdm_context
+  )
+{
+  spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
+  reset_managed_buffer (&spdm_context->transcript.message_a);
+  reset_managed_buffer (&spdm_context->transcript.message_b);
+  reset_managed_buffer (&spdm_context->transcript.message_c);
+  reset_managed_buffer (&spdm_context->transcript.message_m);
+  spdm_reset_transcript_hash (spdm_context);
+}
+
+/**
+  Test 1: calculate M1M2 as segments.
+  Expected Behavior: the segments, the running hash and Concatenate (A, B, C) have the same hash.
+**/
+void test_spdm_common_transcript_segment_case1(void **state) {
+  spdm_test_context_t        *spdm_test_context;
+  spdm_context_t             *spdm_context;
+  spdm_data_segment_t        segment[MAX_SPDM_M1M2_SEGMENT_COUNT];
+  uintn                      segment_count;
+  uint8                      buffer[TEST_TRANSCRIPT_MESSAGE_SIZE * 3];
+  uint8                      hash_value[MAX_HASH_SIZE];
+  uint8                      running_hash_value[MAX_HASH_SIZE];
+  uint8                      expected_hash_value[MAX_HASH_SIZE];
+  uintn                      hash_size;
+  boolean                    result;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  test_spdm_common_transcript_segment_init_data ();
+  test_spdm_common_transcript_segment_reset (spdm_context);
+  hash_size = spdm_get_hash_size (m_use_hash_algo);
+
+  spdm_append_message_a (spdm_context, m_transcript_message[0], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  spdm_append_message_b (spdm_context, m_transcript_message[1], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  spdm_append_message_c (spdm_context, m_transcript_message[2], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  copy_mem (buffer, m_transcript_message[0], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  copy_mem (buffer + TEST_TRANSCRIPT_MESSAGE_SIZE, m_transcript_message[1], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  copy_mem (buffer + TEST_TRANSCRIPT_MESSAGE_SIZE * 2, m_transcript_message[2], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  spdm_hash_all (m_use_hash_algo, buffer, sizeof(buffer), expected_hash_value);
+
+  segment_count = ARRAY_SIZE(segment);
+  result = spdm_calculate_m1m2 (spdm_context, FALSE, &segment_count, segment);
+  assert_true(result);
+  assert_int_equal(segment_count, 3);
+  result = spdm_hash_all_segments (m_use_hash_algo, segment, segment_count, hash_value);
+  assert_true(result);
+  assert_memory_equal(hash_value, expected_hash_value, hash_size);
+
+  result = spdm_calculate_m1m2_hash (spdm_context, FALSE, running_hash_value);
+  assert_true(result);
+  assert_memory_equal(running_hash_value, expected_hash_value, hash_size);
+}
+
+/**
+  Test 2: calculate L1L2 as a segment.
+  Expected Behavior: the segment, the running hash and message M have the same hash.
+**/
+void test_spdm_common_transcript_segment_case2(void **state) {
+  spdm_test_context_t        *spdm_test_context;
+  spdm_context_t             *spdm_context;
+  spdm_data_segment_t        segment;
+  uint8                      buffer[TEST_TRANSCRIPT_MESSAGE_SIZE * 2];
+  uint8                      hash_value[MAX_HASH_SIZE];
+  uint8                      running_hash_value[MAX_HASH_SIZE];
+  uint8                      expected_hash_value[MAX_HASH_SIZE];
+  uintn                      hash_size;
+  boolean                    result;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  test_spdm_common_transcript_segment_init_data ();
+  test_spdm_common_transcript_segment_reset (spdm_context);
+  hash_size = spdm_get_hash_size (m_use_hash_algo);
+
+  spdm_append_message_m (spdm_context, m_transcript_message[0], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  spdm_append_message_m (spdm_context, m_transcript_message[1], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  copy_mem (buffer, m_transcript_message[0], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  copy_mem (buffer + TEST_TRANSCRIPT_MESSAGE_SIZE, m_transcript_message[1], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  spdm_hash_all (m_use_hash_algo, buffer, sizeof(buffer), expected_hash_value);
+
+  result = spdm_calculate_l1l2 (spdm_context, &segment);
+  assert_true(result);
+  result = spdm_hash_all_segments (m_use_hash_algo, &segment, 1, hash_value);
+  assert_true(result);
+  assert_memory_equal(hash_value, expected_hash_value, hash_size);
+
+  result = spdm_calculate_l1l2_hash (spdm_context, running_hash_value);
+  assert_true(result);
+  assert_memory_equal(running_hash_value, expected_hash_value, hash_size);
+}
+
+/**
+  Test 3: calculate TH for KEY_EXCHANGE and then for FINISH as segments, with mutual authentication.
+  Expected Behavior: the segments, the running hash and Concatenate (A, hash(Ct), K, hash(CM), F) have the same hash.
+**/
+void test_spdm_common_transcript_segment_case3(void **state) {
+  spdm_test_context_t        *spdm_test_context;
+  spdm_context_t             *spdm_context;
+  spdm_session_info_t        *session_info;
+  spdm_th_segments_t         th_curr;
+  uint8                      buffer[TEST_TRANSCRIPT_MESSAGE_SIZE * 3 + MAX_HASH_SIZE * 2];
+  uintn                      buffer_size;
+  uint8                      hash_value[MAX_HASH_SIZE];
+  uint8                      running_hash_value[MAX_HASH_SIZE];
+  uint8                      expected_hash_value[MAX_HASH_SIZE];
+  uintn                      hash_size;
+  uint32                     session_id;
+  boolean                    result;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  test_spdm_common_transcript_segment_init_data ();
+  test_spdm_common_transcript_segment_reset (spdm_context);
+  hash_size = spdm_get_hash_size (m_use_hash_algo);
+
+  session_id = 0xFFFFFFFF;
+  session_info = spdm_assign_session_id (spdm_context, session_id, FALSE);
+  assert_true(session_info != NULL);
+
+  spdm_append_message_a (spdm_context, m_transcript_message[0], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  spdm_append_message_k (session_info, m_transcript_message[1], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  buffer_size = 0;
+  copy_mem (buffer + buffer_size, m_transcript_message[0], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  buffer_size += TEST_TRANSCRIPT_MESSAGE_SIZE;
+  spdm_hash_all (m_use_hash_algo, m_transcript_cert_chain, sizeof(m_transcript_cert_chain), buffer + buffer_size);
+  buffer_size += hash_size;
+  copy_mem (buffer + buffer_size, m_transcript_message[1], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  buffer_size += TEST_TRANSCRIPT_MESSAGE_SIZE;
+  spdm_hash_all (m_use_hash_algo, buffer, buffer_size, expected_hash_value);
+
+  result = spdm_calculate_th_for_exchange (spdm_context, session_info, m_transcript_cert_chain, sizeof(m_transcript_cert_chain), &th_curr);
+  assert_true(result);
+  assert_int_equal(th_curr.segment_count, 3);
+  result = spdm_hash_all_segments (m_use_hash_algo, th_curr.segment, th_curr.segment_count, hash_value);
+  assert_true(result);
+  assert_memory_equal(hash_value, expected_hash_value, hash_size);
+  result = spdm_calculate_th_hash_for_exchange (spdm_context, session_info, m_transcript_cert_chain, sizeof(m_transcript_cert_chain), running_hash_value);
+  assert_true(result);
+  assert_memory_equal(running_hash_value, expected_hash_value, hash_size);
+
+  //
+  // The KEY_EXCHANGE_RSP verify data is appended before FINISH.
+  //
+  spdm_append_message_k (session_info, m_transcript_message[2], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  spdm_append_message_f (session_info, m_transcript_message[3], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  copy_mem (buffer + buffer_size, m_transcript_message[2], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  buffer_size += TEST_TRANSCRIPT_MESSAGE_SIZE;
+  spdm_hash_all (m_use_hash_algo, m_transcript_mut_cert_chain, sizeof(m_transcript_mut_cert_chain), buffer + buffer_size);
+  buffer_size += hash_size;
+  copy_mem (buffer + buffer_size, m_transcript_message[3], TEST_TRANSCRIPT_MESSAGE_SIZE);
+  buffer_size += TEST_TRANSCRIPT_MESSAGE_SIZE;
+  spdm_hash_all (m_use_hash_algo, buffer, buffer_size, expected_hash_value);
+
+  result = spdm_calculate_th_for_finish (spdm_context, session_info, m_transcript_cert_chain, sizeof(m_transcript_cert_chain),
+             m_transcript_mut_cert_chain, sizeof(m_transcript_mut_cert_chain), &th_curr);
+  assert_true(result);
+  assert_int_equal(th_curr.segment_count, 5);
+  result = spdm_hash_all_segments (m_use_hash_algo, th_curr.segment, th_curr.segment_count, hash_value);
+  assert_true(result);
+  assert_memory_equal(hash_value, expected_hash_value, hash_size);
+  result = spdm_calculate_th_hash_for_finish (spdm_context, session_info, m_transcript_cert_chain, sizeof(m_transcript_cert_chain),
+             m_transcript_mut_cert_chain, sizeof(m_transcript_mut_cert_chain), running_hash_value);
+  assert_true(result);
+  assert_memory_equal(running_hash_value, expected_hash_value, hash_size);
+
+  spdm_free_session_id (spdm_context, session_id);
+}
+
+spdm_test_context_t       m_spdm_common_transcript_segment_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_common_transcript_segment_test_main(void) {
+  const struct CMUnitTest spdm_common_transcript_segment_tests[] = {
+      // M1M2 segments
+      cmocka_unit_test(test_spdm_common_transcript_segment_case1),
+      // L1L2 segment
+      cmocka_unit_test(test_spdm_common_transcript_segment_case2),
+      // TH segments for KEY_EXCHANGE and FINISH
+      cmocka_unit_test(test_spdm_common_transcript_segment_case3),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_transcript_segment_test_context);
+
+  return cmocka_run_group_tests(spdm_common_transcript_segment_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
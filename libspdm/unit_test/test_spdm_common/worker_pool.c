@@ -0,0 +1,346 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_common_lib_internal.h>
+#include <library/threadlib.h>
+
+#define TEST_WORKER_POOL_WAIT_COUNT  10000
+
+typedef struct {
+  spdm_context_t    *spdm_context;
+  volatile boolean  block;
+  volatile boolean  started;
+  volatile uintn    run_count;
+} test_worker_pool_job_context_t;
+
+static
+void
+test_spdm_common_worker_pool_job (
+  IN void  *context
+  )
+{
+  test_worker_pool_job_context_t  *job_context;
+
+  job_context = context;
+  job_context->started = TRUE;
+  while (job_context->block) {
+    thread_sleep (1000);
+  }
+  job_context->run_count++;
+}
+
+/**
+  Unblock the job once spdm_worker_pool_stop has dropped the queued jobs.
+**/
+static
+void
+test_spdm_common_worker_pool_unblock (
+  IN void  *context
+  )
+{
+  test_worker_pool_job_context_t  *job_context;
+  uintn                           index;
+
+  job_context = context;
+  for (index = 0; index < TEST_WORKER_POOL_WAIT_COUNT; index++) {
+    if (*(volatile boolean *)&job_context->spdm_context->worker_pool.stop) {
+      break;
+    }
+    thread_sleep (1000);
+  }
+  job_context->block = FALSE;
+}
+
+typedef struct {
+  spdm_context_t                  *spdm_context;
+  test_worker_pool_job_context_t  sub_job_context[2];
+  spdm_job_t                      sub_job[2];
+} test_worker_pool_nested_job_context_t;
+
+/**
+  A job run by the worker pool that runs its own jobs with spdm_run_jobs,
+  like a deferred request that computes a shared secret or a signature.
+**/
+static
+void
+test_spdm_common_worker_pool_nested_job (
+  IN void  *context
+  )
+{
+  test_worker_pool_nested_job_context_t  *job_context;
+
+  job_context = context;
+  spdm_run_jobs (job_context->spdm_context, job_context->sub_job, ARRAY_SIZE(job_context->sub_job));
+}
+
+static
+void
+test_spdm_common_worker_pool_set_thread_count (
+  IN spdm_context_t  *spdm_context,
+  IN uint8           thread_count
+  )
+{
+  return_status    status;
+
+  status = spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, NULL, &thread_count, sizeof(thread_count));
+  assert_int_equal(status, RETURN_SUCCESS);
+}
+
+static
+boolean
+test_spdm_common_worker_pool_wait (
+  IN spdm_context_t  *spdm_context,
+  IN spdm_job_t      *job
+  )
+{
+  uintn  index;
+
+  for (index = 0; index < TEST_WORKER_POOL_WAIT_COUNT; index++) {
+    if (spdm_worker_pool_is_job_done (spdm_context, job)) {
+      return TRUE;
+    }
+    thread_sleep (1000);
+  }
+  return FALSE;
+}
+
+/**
+  Test 1: the worker pool is disabled.
+  Expected Behavior: a job cannot be submitted, and spdm_run_jobs runs every job in the caller.
+**/
+void test_spdm_common_worker_pool_case1(void **state) {
+  spdm_test_context_t             *spdm_test_context;
+  spdm_context_t                  *spdm_context;
+  test_worker_pool_job_context_t  job_context[4];
+  spdm_job_t                      job[4];
+  uintn                           index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  test_spdm_common_worker_pool_set_thread_count (spdm_context, 0);
+
+  zero_mem (job_context, sizeof(job_context));
+  for (index = 0; index < ARRAY_SIZE(job); index++) {
+    job[index].func = test_spdm_common_worker_pool_job;
+    job[index].context = &job_context[index];
+  }
+
+  assert_int_equal(spdm_worker_pool_submit (spdm_context, &job[0]), FALSE);
+  assert_int_equal(spdm_worker_pool_is_job_done (spdm_context, &job[0]), FALSE);
+  assert_int_equal(job_context[0].run_count, 0);
+
+  spdm_run_jobs (spdm_context, job, ARRAY_SIZE(job));
+  for (index = 0; index < ARRAY_SIZE(job); index++) {
+    assert_int_equal(job[index].status, SPDM_JOB_STATUS_DONE);
+    assert_int_equal(job_context[index].run_count, 1);
+  }
+  assert_int_equal(spdm_context->worker_pool.running_thread_count, 0);
+}
+
+/**
+  Test 2: spdm_run_jobs runs more jobs than the queue holds on the worker pool.
+  Expected Behavior: every job is run once, and the pool keeps running afterwards.
+**/
+void test_spdm_common_worker_pool_case2(void **state) {
+  spdm_test_context_t             *spdm_test_context;
+  spdm_context_t                  *spdm_context;
+  test_worker_pool_job_context_t  job_context[MAX_SPDM_WORKER_JOB_COUNT + 3];
+  spdm_job_t                      job[MAX_SPDM_WORKER_JOB_COUNT + 3];
+  uintn                           index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  test_spdm_common_worker_pool_set_thread_count (spdm_context, 2);
+
+  zero_mem (job_context, sizeof(job_context));
+  for (index = 0; index < ARRAY_SIZE(job); index++) {
+    job[index].func = test_spdm_common_worker_pool_job;
+    job[index].context = &job_context[index];
+  }
+
+  spdm_run_jobs (spdm_context, job, ARRAY_SIZE(job));
+  for (index = 0; index < ARRAY_SIZE(job); index++) {
+    assert_int_equal(job[index].status, SPDM_JOB_STATUS_DONE);
+    assert_int_equal(job_context[index].run_count, 1);
+  }
+  assert_int_equal(spdm_context->worker_pool.running_thread_count, 2);
+
+  spdm_worker_pool_stop (spdm_context);
+  assert_int_equal(spdm_context->worker_pool.running_thread_count, 0);
+}
+
+/**
+  Test 3: a job is submitted again after it is done.
+  Expected Behavior: the job is not reported done before the second run completes.
+**/
+void test_spdm_common_worker_pool_case3(void **state) {
+  spdm_test_context_t             *spdm_test_context;
+  spdm_context_t                  *spdm_context;
+  test_worker_pool_job_context_t  job_context;
+  spdm_job_t                      job;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  test_spdm_common_worker_pool_set_thread_count (spdm_context, 1);
+
+  zero_mem (&job_context, sizeof(job_context));
+  job.func = test_spdm_common_worker_pool_job;
+  job.context = &job_context;
+
+  assert_true(spdm_worker_pool_submit (spdm_context, &job));
+  assert_true(test_spdm_common_worker_pool_wait (spdm_context, &job));
+  assert_int_equal(job.status, SPDM_JOB_STATUS_DONE);
+  assert_int_equal(job_context.run_count, 1);
+
+  job_context.block = TRUE;
+  job_context.started = FALSE;
+  assert_true(spdm_worker_pool_submit (spdm_context, &job));
+  assert_int_equal(spdm_worker_pool_is_job_done (spdm_context, &job), FALSE);
+  job_context.block = FALSE;
+  assert_true(test_spdm_common_worker_pool_wait (spdm_context, &job));
+  assert_int_equal(job.status, SPDM_JOB_STATUS_DONE);
+  assert_int_equal(job_context.run_count, 2);
+
+  spdm_worker_pool_stop (spdm_context);
+}
+
+/**
+  Test 4: the worker pool is stopped while one job runs and another job is queued.
+  Expected Behavior: the running job completes, the queued job is dropped without being run,
+  and both are reported by spdm_worker_pool_is_job_done.
+**/
+void test_spdm_common_worker_pool_case4(void **state) {
+  spdm_test_context_t             *spdm_test_context;
+  spdm_context_t                  *spdm_context;
+  test_worker_pool_job_context_t  job_context[2];
+  spdm_job_t                      job[2];
+  void                            *thread;
+  uintn                           index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x4;
+  test_spdm_common_worker_pool_set_thread_count (spdm_context, 1);
+
+  zero_mem (job_context, sizeof(job_context));
+  for (index = 0; index < ARRAY_SIZE(job); index++) {
+    job_context[index].spdm_context = spdm_context;
+    job[index].func = test_spdm_common_worker_pool_job;
+    job[index].context = &job_context[index];
+  }
+  job_context[0].block = TRUE;
+
+  assert_true(spdm_worker_pool_submit (spdm_context, &job[0]));
+  for (index = 0; index < TEST_WORKER_POOL_WAIT_COUNT; index++) {
+    if (job_context[0].started) {
+      break;
+    }
+    thread_sleep (1000);
+  }
+  assert_true(job_context[0].started);
+  assert_true(spdm_worker_pool_submit (spdm_context, &job[1]));
+  assert_int_equal(job[1].status, SPDM_JOB_STATUS_QUEUED);
+
+  thread = thread_create (test_spdm_common_worker_pool_unblock, &job_context[0]);
+  assert_true(thread != NULL);
+  spdm_worker_pool_stop (spdm_context);
+  thread_join (thread);
+
+  assert_true(spdm_worker_pool_is_job_done (spdm_context, &job[0]));
+  assert_int_equal(job[0].status, SPDM_JOB_STATUS_DONE);
+  assert_int_equal(job_context[0].run_count, 1);
+  assert_true(spdm_worker_pool_is_job_done (spdm_context, &job[1]));
+  assert_int_equal(job[1].status, SPDM_JOB_STATUS_DROPPED);
+  assert_int_equal(job_context[1].run_count, 0);
+}
+
+/**
+  Test 5: the worker pool is stopped while a job run by the worker pool is inside spdm_run_jobs,
+  and its second job is still queued.
+  Expected Behavior: the queued job is dropped and then run by the caller of spdm_run_jobs,
+  and spdm_worker_pool_stop returns after the job run by the worker pool completes.
+**/
+void test_spdm_common_worker_pool_case5(void **state) {
+  spdm_test_context_t                    *spdm_test_context;
+  spdm_context_t                         *spdm_context;
+  test_worker_pool_nested_job_context_t  job_context;
+  spdm_job_t                             job;
+  void                                   *thread;
+  uintn                                  index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x5;
+  test_spdm_common_worker_pool_set_thread_count (spdm_context, 1);
+
+  zero_mem (&job_context, sizeof(job_context));
+  job_context.spdm_context = spdm_context;
+  for (index = 0; index < ARRAY_SIZE(job_context.sub_job); index++) {
+    job_context.sub_job_context[index].spdm_context = spdm_context;
+    job_context.sub_job[index].func = test_spdm_common_worker_pool_job;
+    job_context.sub_job[index].context = &job_context.sub_job_context[index];
+  }
+  //
+  // The only worker thread runs the first job until the worker pool is being stopped,
+  // so the second job stays in the queue.
+  //
+  job_context.sub_job_context[0].block = TRUE;
+  job.func = test_spdm_common_worker_pool_nested_job;
+  job.context = &job_context;
+
+  assert_true(spdm_worker_pool_submit (spdm_context, &job));
+  for (index = 0; index < TEST_WORKER_POOL_WAIT_COUNT; index++) {
+    if (job_context.sub_job_context[0].started) {
+      break;
+    }
+    thread_sleep (1000);
+  }
+  assert_true(job_context.sub_job_context[0].started);
+  assert_int_equal(job_context.sub_job[1].status, SPDM_JOB_STATUS_QUEUED);
+
+  thread = thread_create (test_spdm_common_worker_pool_unblock, &job_context.sub_job_context[0]);
+  assert_true(thread != NULL);
+  spdm_worker_pool_stop (spdm_context);
+  thread_join (thread);
+
+  assert_int_equal(job.status, SPDM_JOB_STATUS_DONE);
+  for (index = 0; index < ARRAY_SIZE(job_context.sub_job); index++) {
+    assert_int_equal(job_context.sub_job[index].status, SPDM_JOB_STATUS_DONE);
+    assert_int_equal(job_context.sub_job_context[index].run_count, 1);
+  }
+  assert_int_equal(spdm_context->worker_pool.running_thread_count, 0);
+}
+
+spdm_test_context_t       m_spdm_common_worker_pool_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_common_worker_pool_test_main(void) {
+  const struct CMUnitTest spdm_common_worker_pool_tests[] = {
+      // Worker pool disabled
+      cmocka_unit_test(test_spdm_common_worker_pool_case1),
+      // spdm_run_jobs with more jobs than the queue
+      cmocka_unit_test(test_spdm_common_worker_pool_case2),
+      // Job submitted again after it is done
+      cmocka_unit_test(test_spdm_common_worker_pool_case3),
+      // Stop with a running job and a queued job
+      cmocka_unit_test(test_spdm_common_worker_pool_case4),
+      // Stop while a job run by the worker pool is inside spdm_run_jobs
+      cmocka_unit_test(test_spdm_common_worker_pool_case5),
+  };
+
+  setup_spdm_test_context (&m_spdm_common_worker_pool_test_context);
+
+  return cmocka_run_group_tests(spdm_common_worker_pool_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
@@ -151,6 +151,337 @@ void test_spdm_crypt_spdm_x509_certificate_check(void **state) {
   free (file_buffer);
 }
 
+void test_spdm_crypt_spdm_hkdf_expand_batch(void **state) {
+  boolean                  status;
+  uint8                    prk[MAX_HASH_SIZE];
+  uint8                    info[3][64];
+  uint8                    expected[3][160];
+  uint8                    out[3][160];
+  uintn                    out_size[3] = {32, 12, 160};
+  spdm_hkdf_expand_item_t  item[3];
+  uint32                   bash_hash_algo[3] = {
+                             SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256,
+                             SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384,
+                             SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512};
+  uintn                    hash_size;
+  uintn                    algo_index;
+  uintn                    index;
+
+  set_mem (prk, sizeof(prk), 0x5A);
+  for (index = 0; index < 3; index++) {
+    set_mem (info[index], sizeof(info[index]), (uint8)(index + 1));
+  }
+
+  for (algo_index = 0; algo_index < 3; algo_index++) {
+    hash_size = spdm_get_hash_size (bash_hash_algo[algo_index]);
+    for (index = 0; index < 3; index++) {
+      status = spdm_hkdf_expand (bash_hash_algo[algo_index], prk, hash_size, info[index], 16 + index, expected[index], out_size[index]);
+      assert_true(status);
+      item[index].info = info[index];
+      item[index].info_size = 16 + index;
+      item[index].out = out[index];
+      item[index].out_size = out_size[index];
+    }
+    status = spdm_hkdf_expand_batch (bash_hash_algo[algo_index], prk, hash_size, item, 3);
+    assert_true(status);
+    for (index = 0; index < 3; index++) {
+      assert_memory_equal(out[index], expected[index], out_size[index]);
+    }
+  }
+}
+
+void test_spdm_crypt_spdm_hash_update(void **state) {
+  boolean                  status;
+  uint8                    data[0x300];
+  uint8                    hash_context[MAX_HASH_CONTEXT_SIZE];
+  uint8                    dup_hash_context[MAX_HASH_CONTEXT_SIZE];
+  uint8                    hash_value[MAX_HASH_SIZE];
+  uint8                    expected_hash_value[MAX_HASH_SIZE];
+  uint32                   bash_hash_algo[3] = {
+                             SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256,
+                             SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_384,
+                             SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_512};
+  uintn                    hash_size;
+  uintn                    algo_index;
+  uintn                    index;
+
+  for (index = 0; index < sizeof(data); index++) {
+    data[index] = (uint8)index;
+  }
+
+  for (algo_index = 0; algo_index < 3; algo_index++) {
+    hash_size = spdm_get_hash_size (bash_hash_algo[algo_index]);
+    status = spdm_hash_init (bash_hash_algo[algo_index], hash_context);
+    assert_true(status);
+    for (index = 0; index < sizeof(data); index += 0x100) {
+      status = spdm_hash_update (bash_hash_algo[algo_index], hash_context, data + index, 0x100);
+      assert_true(status);
+
+      // A duplicated context finalizes the data so far, and leaves the original context usable.
+      status = spdm_hash_duplicate (bash_hash_algo[algo_index], hash_context, dup_hash_context);
+      assert_true(status);
+      status = spdm_hash_final (bash_hash_algo[algo_index], dup_hash_context, hash_value);
+      assert_true(status);
+      status = spdm_hash_all (bash_hash_algo[algo_index], data, index + 0x100, expected_hash_value);
+      assert_true(status);
+      assert_memory_equal(hash_value, expected_hash_value, hash_size);
+    }
+    status = spdm_hash_final (bash_hash_algo[algo_index], hash_context, hash_value);
+    assert_true(status);
+    assert_memory_equal(hash_value, expected_hash_value, hash_size);
+  }
+}
+
+void test_spdm_crypt_spdm_segments(void **state) {
+  boolean                  status;
+  uint8                    data[0x180];
+  spdm_data_segment_t      segment[3];
+  uint8                    key[MAX_HASH_SIZE];
+  uint8                    hash_value[MAX_HASH_SIZE];
+  uint8                    expected_hash_value[MAX_HASH_SIZE];
+  uint8                    *file_buffer;
+  uintn                    file_buffer_size;
+  void                     *private_context;
+  void                     *public_context;
+  uint8                    signature[MAX_ASYM_KEY_SIZE];
+  uintn                    sig_size;
+  uint32                   bash_hash_algo;
+  uint32                   base_asym_algo;
+  uintn                    hash_size;
+  uintn                    index;
+
+  bash_hash_algo = SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256;
+  base_asym_algo = SPDM_ALGORITHMS_BASE_ASYM_ALGO_TPM_ALG_ECDSA_ECC_NIST_P256;
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  for (index = 0; index < sizeof(data); index++) {
+    data[index] = (uint8)index;
+  }
+  set_mem (key, sizeof(key), 0x5A);
+
+  // Uneven segments, including an empty one.
+  segment[0].data = data;
+  segment[0].size = 0x31;
+  segment[1].data = data + 0x31;
+  segment[1].size = 0;
+  segment[2].data = data + 0x31;
+  segment[2].size = sizeof(data) - 0x31;
+
+  status = spdm_hash_all (bash_hash_algo, data, sizeof(data), expected_hash_value);
+  assert_true(status);
+  status = spdm_hash_all_segments (bash_hash_algo, segment, 3, hash_value);
+  assert_true(status);
+  assert_memory_equal(hash_value, expected_hash_value, hash_size);
+
+  status = spdm_hmac_all (bash_hash_algo, data, sizeof(data), key, hash_size, expected_hash_value);
+  assert_true(status);
+  status = spdm_hmac_all_segments (bash_hash_algo, segment, 3, key, hash_size, hash_value);
+  assert_true(status);
+  assert_memory_equal(hash_value, expected_hash_value, hash_size);
+
+  // A signature of the segments is verified on the contiguous message, and vice versa.
+  status = read_input_file ("ecp256/end_responder.key", (void **)&file_buffer, &file_buffer_size);
+  assert_true(status);
+  status = spdm_asym_get_private_key_from_pem (base_asym_algo, file_buffer, file_buffer_size, NULL, &private_context);
+  assert_true(status);
+  free (file_buffer);
+  status = read_input_file ("ecp256/end_responder.cert.der", (void **)&file_buffer, &file_buffer_size);
+  assert_true(status);
+  status = spdm_asym_get_public_key_from_x509 (base_asym_algo, file_buffer, file_buffer_size, &public_context);
+  assert_true(status);
+  free (file_buffer);
+
+  sig_size = sizeof(signature);
+  status = spdm_asym_sign_segments (base_asym_algo, bash_hash_algo, private_context, segment, 3, signature, &sig_size);
+  assert_true(status);
+  status = spdm_asym_verify (base_asym_algo, bash_hash_algo, public_context, data, sizeof(data), signature, sig_size);
+  assert_true(status);
+
+  sig_size = sizeof(signature);
+  status = spdm_asym_sign (base_asym_algo, bash_hash_algo, private_context, data, sizeof(data), signature, &sig_size);
+  assert_true(status);
+  status = spdm_asym_verify_segments (base_asym_algo, bash_hash_algo, public_context, segment, 3, signature, sig_size);
+  assert_true(status);
+
+  spdm_asym_free (base_asym_algo, private_context);
+  spdm_asym_free (base_asym_algo, public_context);
+}
+
+void test_spdm_crypt_spdm_verify_certificate_chain_buffer_link_cache(void **state) {
+  boolean                  status;
+  uint8                    *file_buffer;
+  uintn                    file_buffer_size;
+  uint8                    *cert_chain_buffer;
+  uintn                    cert_chain_buffer_size;
+  uint8                    *root_cert;
+  uintn                    root_cert_size;
+  uint8                    *cert;
+  uintn                    cert_size;
+  uint8                    root_cert_hash[MAX_HASH_SIZE];
+  uint8                    cert_hash[MAX_HASH_SIZE];
+  uint32                   bash_hash_algo;
+  uintn                    hash_size;
+
+  bash_hash_algo = SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256;
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  status = read_input_file ("ecp256/bundle_responder.certchain.der", (void **)&file_buffer, &file_buffer_size);
+  assert_true(status);
+  status = x509_get_cert_from_cert_chain (file_buffer, file_buffer_size, 0, &root_cert, &root_cert_size);
+  assert_true(status);
+  status = x509_get_cert_from_cert_chain (file_buffer, file_buffer_size, 1, &cert, &cert_size);
+  assert_true(status);
+  spdm_hash_all (bash_hash_algo, root_cert, root_cert_size, root_cert_hash);
+  spdm_hash_all (bash_hash_algo, cert, cert_size, cert_hash);
+
+  cert_chain_buffer_size = sizeof(spdm_cert_chain_t) + hash_size + file_buffer_size;
+  cert_chain_buffer = malloc (cert_chain_buffer_size);
+  assert_true(cert_chain_buffer != NULL);
+  ((spdm_cert_chain_t *)cert_chain_buffer)->length = (uint16)cert_chain_buffer_size;
+  ((spdm_cert_chain_t *)cert_chain_buffer)->reserved = 0;
+  copy_mem (cert_chain_buffer + sizeof(spdm_cert_chain_t), root_cert_hash, hash_size);
+  copy_mem (cert_chain_buffer + sizeof(spdm_cert_chain_t) + hash_size, file_buffer, file_buffer_size);
+
+  spdm_clear_cert_link_cache ();
+  assert_int_equal(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, root_cert_hash), FALSE);
+  status = spdm_verify_certificate_chain_buffer (bash_hash_algo, cert_chain_buffer, cert_chain_buffer_size);
+  assert_true(status);
+  // The root and the intermediate links are cached.
+  assert_true(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, root_cert_hash));
+  assert_true(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, cert_hash));
+  status = spdm_verify_certificate_chain_buffer (bash_hash_algo, cert_chain_buffer, cert_chain_buffer_size);
+  assert_true(status);
+
+  // The leaf link is verified even if the other links are cached.
+  cert_chain_buffer[cert_chain_buffer_size - 1]++;
+  status = spdm_verify_certificate_chain_buffer (bash_hash_algo, cert_chain_buffer, cert_chain_buffer_size);
+  assert_int_equal(status, FALSE);
+
+  spdm_clear_cert_link_cache ();
+  assert_int_equal(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, root_cert_hash), FALSE);
+
+  free (cert_chain_buffer);
+  free (file_buffer);
+}
+
+void test_spdm_crypt_spdm_cert_link_cache_replacement(void **state) {
+  boolean                  status;
+  uint8                    *file_buffer;
+  uintn                    file_buffer_size;
+  uint8                    *root_cert;
+  uintn                    root_cert_size;
+  uint8                    root_cert_hash[MAX_HASH_SIZE];
+  uint8                    cert_hash[MAX_HASH_SIZE];
+  uint32                   bash_hash_algo;
+  uintn                    hash_size;
+  uintn                    index;
+  spdm_cert_chain_link_t   link;
+
+  bash_hash_algo = SPDM_ALGORITHMS_BASE_HASH_ALGO_TPM_ALG_SHA_256;
+  hash_size = spdm_get_hash_size (bash_hash_algo);
+  status = read_input_file ("ecp256/bundle_responder.certchain.der", (void **)&file_buffer, &file_buffer_size);
+  assert_true(status);
+  status = x509_get_cert_from_cert_chain (file_buffer, file_buffer_size, 0, &root_cert, &root_cert_size);
+  assert_true(status);
+  spdm_hash_all (bash_hash_algo, root_cert, root_cert_size, root_cert_hash);
+
+  // Fill the cache, then use the first link.
+  spdm_clear_cert_link_cache ();
+  for (index = 0; index < MAX_SPDM_CERT_LINK_CACHE_ENTRY_COUNT; index++) {
+    set_mem (cert_hash, hash_size, (uint8)index);
+    spdm_cert_link_cache_add (bash_hash_algo, root_cert_hash, cert_hash, root_cert, root_cert_size);
+  }
+  set_mem (cert_hash, hash_size, 0);
+  assert_true(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, cert_hash));
+
+  // The least recently used link is replaced, and the used one stays.
+  set_mem (cert_hash, hash_size, 0xFF);
+  spdm_cert_link_cache_add (bash_hash_algo, root_cert_hash, cert_hash, root_cert, root_cert_size);
+  assert_true(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, cert_hash));
+  set_mem (cert_hash, hash_size, 1);
+  assert_int_equal(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, cert_hash), FALSE);
+  set_mem (cert_hash, hash_size, 0);
+  assert_true(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, cert_hash));
+
+  // A link without a validity period is not cached.
+  spdm_clear_cert_link_cache ();
+  spdm_cert_link_cache_add (bash_hash_algo, root_cert_hash, cert_hash, root_cert, 4);
+  assert_int_equal(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, cert_hash), FALSE);
+
+  // A verified link is cached with the validity of the certificate.
+  link.bash_hash_algo = bash_hash_algo;
+  link.cert = root_cert;
+  link.cert_size = root_cert_size;
+  link.issuer_cert = root_cert;
+  link.issuer_cert_size = root_cert_size;
+  assert_true(spdm_verify_cert_chain_link (&link));
+  assert_true(spdm_cert_link_cache_find (bash_hash_algo, root_cert_hash, root_cert_hash));
+
+  spdm_clear_cert_link_cache ();
+  free (file_buffer);
+}
+
+void test_spdm_crypt_spdm_signing_key_cache(void **state) {
+  boolean                  status;
+  void                     *context[MAX_SIGNING_KEY_CONTEXT_COUNT];
+  void                     *uncached_context;
+  void                     *cached_context;
+  uint32                   base_asym_algo;
+  uintn                    index;
+  uintn                    index2;
+
+  base_asym_algo = SPDM_ALGORITHMS_BASE_ASYM_ALGO_TPM_ALG_ECDSA_ECC_NIST_P256;
+  spdm_clear_signing_key_cache ();
+
+  // Miss: the key is loaded and cached.
+  status = spdm_acquire_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, &context[0]);
+  assert_true(status);
+  assert_true(context[0] != NULL);
+  spdm_release_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, context[0]);
+
+  // Hit: the released context is handed out again.
+  status = spdm_acquire_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, &cached_context);
+  assert_true(status);
+  assert_true(cached_context == context[0]);
+
+  // Concurrent signers get their own context, up to MAX_SIGNING_KEY_CONTEXT_COUNT per key.
+  for (index = 1; index < MAX_SIGNING_KEY_CONTEXT_COUNT; index++) {
+    status = spdm_acquire_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, &context[index]);
+    assert_true(status);
+    for (index2 = 0; index2 < index; index2++) {
+      assert_true(context[index] != context[index2]);
+    }
+  }
+
+  // The key is full: the next context is not cached, and it is freed on release.
+  status = spdm_acquire_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, &uncached_context);
+  assert_true(status);
+  for (index = 0; index < MAX_SIGNING_KEY_CONTEXT_COUNT; index++) {
+    assert_true(uncached_context != context[index]);
+  }
+  spdm_release_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, uncached_context);
+
+  for (index = 0; index < MAX_SIGNING_KEY_CONTEXT_COUNT; index++) {
+    spdm_release_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, context[index]);
+  }
+  status = spdm_acquire_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, &cached_context);
+  assert_true(status);
+  for (index = 0; index < MAX_SIGNING_KEY_CONTEXT_COUNT; index++) {
+    if (cached_context == context[index]) {
+      break;
+    }
+  }
+  assert_true(index < MAX_SIGNING_KEY_CONTEXT_COUNT);
+
+  // A context in use stays cached when the cache is cleared, and is still released to the cache.
+  spdm_clear_signing_key_cache ();
+  spdm_release_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, cached_context);
+  status = spdm_acquire_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, &context[0]);
+  assert_true(status);
+  assert_true(context[0] == cached_context);
+  spdm_release_signing_key (SIGNING_KEY_TYPE_ASYM, FALSE, base_asym_algo, NULL, context[0]);
+
+  spdm_clear_signing_key_cache ();
+}
+
 int spdm_crypt_lib_setup(void **state)
 {
   return 0;
@@ -165,7 +496,13 @@ int spdm_crypt_lib_test_main(void) {
   const struct CMUnitTest spdm_crypt_lib_tests[] = {
       cmocka_unit_test(test_spdm_crypt_spdm_get_dmtf_subject_alt_name_from_bytes),
       cmocka_unit_test(test_spdm_crypt_spdm_get_dmtf_subject_alt_name),
-      cmocka_unit_test(test_spdm_crypt_spdm_x509_certificate_check)
+      cmocka_unit_test(test_spdm_crypt_spdm_x509_certificate_check),
+      cmocka_unit_test(test_spdm_crypt_spdm_hkdf_expand_batch),
+      cmocka_unit_test(test_spdm_crypt_spdm_hash_update),
+      cmocka_unit_test(test_spdm_crypt_spdm_segments),
+      cmocka_unit_test(test_spdm_crypt_spdm_verify_certificate_chain_buffer_link_cache),
+      cmocka_unit_test(test_spdm_crypt_spdm_cert_link_cache_replacement),
+      cmocka_unit_test(test_spdm_crypt_spdm_signing_key_cache)
   };
 
   return cmocka_run_group_tests(spdm_crypt_lib_tests, spdm_crypt_lib_setup, spdm_crypt_lib_teardown);
@@ -0,0 +1,195 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_requester_lib_internal.h>
+
+#pragma pack(1)
+typedef struct {
+  spdm_message_header_t  header;
+  uint8                reserved;
+  uint8                version_number_entry_count;
+  spdm_version_number_t  version_number_entry[MAX_SPDM_VERSION_COUNT];
+} spdm_version_response_mine_t;
+#pragma pack()
+
+//
+// The device IO functions must not be called while a flow of the asynchronous API is running.
+//
+return_status
+spdm_requester_async_test_send_message (
+  IN     void                    *spdm_context,
+  IN     uintn                   request_size,
+  IN     void                    *request,
+  IN     uint64                  timeout
+  )
+{
+  return RETURN_DEVICE_ERROR;
+}
+
+return_status
+spdm_requester_async_test_receive_message (
+  IN     void                    *spdm_context,
+  IN OUT uintn                   *response_size,
+  IN OUT void                    *response,
+  IN     uint64                  timeout
+  )
+{
+  return RETURN_DEVICE_ERROR;
+}
+
+/**
+  Test 1: the GET_VERSION flow is driven step by step, and a correct VERSION message is fed.
+  Expected behavior: the flow is done with RETURN_SUCCESS, and the device IO functions are restored.
+**/
+void test_spdm_requester_async_case1(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uint8                request[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  uintn                request_size;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  uintn                response_size;
+  spdm_version_response_mine_t    spdm_response;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+
+  status = spdm_async_init_connection (spdm_context, TRUE);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (spdm_async_get_state (spdm_context), SPDM_ASYNC_STATE_SEND);
+  assert_int_equal (spdm_async_poll (spdm_context), RETURN_NOT_READY);
+
+  request_size = sizeof(request);
+  status = spdm_async_get_request_message (spdm_context, &request_size, request);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (spdm_async_get_state (spdm_context), SPDM_ASYNC_STATE_RECEIVE);
+
+  zero_mem (&spdm_response, sizeof(spdm_response));
+  spdm_response.header.spdm_version = SPDM_MESSAGE_VERSION_10;
+  spdm_response.header.request_response_code = SPDM_VERSION;
+  spdm_response.header.param1 = 0;
+  spdm_response.header.param2 = 0;
+  spdm_response.version_number_entry_count = 2;
+  spdm_response.version_number_entry[0].major_version = 1;
+  spdm_response.version_number_entry[0].minor_version = 0;
+  spdm_response.version_number_entry[1].major_version = 1;
+  spdm_response.version_number_entry[1].minor_version = 1;
+  response_size = sizeof(response);
+  spdm_transport_test_encode_message (spdm_context, NULL, FALSE, FALSE, sizeof(spdm_response), &spdm_response, &response_size, response);
+
+  status = spdm_async_feed_response_message (spdm_context, response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (spdm_async_get_state (spdm_context), SPDM_ASYNC_STATE_DONE);
+
+  status = spdm_async_poll (spdm_context);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (spdm_async_get_state (spdm_context), SPDM_ASYNC_STATE_IDLE);
+  assert_true (spdm_context->send_message == spdm_requester_async_test_send_message);
+  assert_true (spdm_context->receive_message == spdm_requester_async_test_receive_message);
+}
+
+/**
+  Test 2: a second flow is started before the first flow is done.
+  Expected behavior: the second flow is rejected with RETURN_ALREADY_STARTED.
+**/
+void test_spdm_requester_async_case2(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+
+  status = spdm_async_init_connection (spdm_context, TRUE);
+  assert_int_equal (status, RETURN_SUCCESS);
+  status = spdm_async_init_connection (spdm_context, TRUE);
+  assert_int_equal (status, RETURN_ALREADY_STARTED);
+
+  spdm_async_cancel (spdm_context);
+  spdm_async_poll (spdm_context);
+}
+
+/**
+  Test 3: the flow is cancelled while it waits for the response.
+  Expected behavior: the flow is done with RETURN_DEVICE_ERROR.
+**/
+void test_spdm_requester_async_case3(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uint8                request[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  uintn                request_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+
+  status = spdm_async_init_connection (spdm_context, TRUE);
+  assert_int_equal (status, RETURN_SUCCESS);
+  request_size = sizeof(request);
+  status = spdm_async_get_request_message (spdm_context, &request_size, request);
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  spdm_async_cancel (spdm_context);
+  assert_int_equal (spdm_async_get_state (spdm_context), SPDM_ASYNC_STATE_DONE);
+  status = spdm_async_poll (spdm_context);
+  assert_int_equal (status, RETURN_DEVICE_ERROR);
+  assert_int_equal (spdm_async_poll (spdm_context), RETURN_NOT_STARTED);
+}
+
+/**
+  Test 4: the response is fed while the flow is sending the request.
+  Expected behavior: the response is rejected with RETURN_NOT_READY.
+**/
+void test_spdm_requester_async_case4(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x4;
+
+  status = spdm_async_init_connection (spdm_context, TRUE);
+  assert_int_equal (status, RETURN_SUCCESS);
+  zero_mem (response, sizeof(response));
+  status = spdm_async_feed_response_message (spdm_context, sizeof(spdm_message_header_t), response);
+  assert_int_equal (status, RETURN_NOT_READY);
+
+  spdm_async_cancel (spdm_context);
+  spdm_async_poll (spdm_context);
+}
+
+spdm_test_context_t       mSpdmRequesterAsyncTestContext = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  TRUE,
+  spdm_requester_async_test_send_message,
+  spdm_requester_async_test_receive_message,
+};
+
+int spdm_requester_async_test_main(void) {
+  const struct CMUnitTest spdm_requester_async_tests[] = {
+      // Successful response
+      cmocka_unit_test(test_spdm_requester_async_case1),
+      // Flow already started
+      cmocka_unit_test(test_spdm_requester_async_case2),
+      // Cancelled flow
+      cmocka_unit_test(test_spdm_requester_async_case3),
+      // Response fed in a wrong state
+      cmocka_unit_test(test_spdm_requester_async_case4),
+  };
+
+  setup_spdm_test_context (&mSpdmRequesterAsyncTestContext);
+
+  return cmocka_run_group_tests(spdm_requester_async_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
@@ -407,8 +407,7 @@ void test_spdm_requester_challenge_case1(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -438,8 +437,7 @@ void test_spdm_requester_challenge_case2(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -468,8 +466,7 @@ void test_spdm_requester_challenge_case3(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -499,8 +496,7 @@ void test_spdm_requester_challenge_case4(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -530,8 +526,7 @@ void test_spdm_requester_challenge_case5(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -561,8 +556,7 @@ void test_spdm_requester_challenge_case6(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -591,8 +585,7 @@ void test_spdm_requester_challenge_case7(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -623,8 +616,7 @@ void test_spdm_requester_challenge_case8(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -653,8 +645,7 @@ void test_spdm_requester_challenge_case9(void **state) {
   spdm_context->transcript.message_c.buffer_size = 0;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   zero_mem (measurement_hash, sizeof(measurement_hash));
   status = spdm_challenge (spdm_context, 0, SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH, measurement_hash);
@@ -364,8 +364,7 @@ void test_spdm_requester_end_session_case1(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -408,8 +407,7 @@ void test_spdm_requester_end_session_case2(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -458,8 +456,7 @@ void test_spdm_requester_end_session_case3(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -507,8 +504,7 @@ void test_spdm_requester_end_session_case4(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -556,8 +552,7 @@ void test_spdm_requester_end_session_case5(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -605,8 +600,7 @@ void test_spdm_requester_end_session_case6(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -655,8 +649,7 @@ void test_spdm_requester_end_session_case7(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -705,8 +698,7 @@ void test_spdm_requester_end_session_case8(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -754,8 +746,7 @@ void test_spdm_requester_end_session_case9(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -431,8 +431,7 @@ void test_spdm_requester_finish_case1(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -478,8 +477,7 @@ void test_spdm_requester_finish_case2(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -526,8 +524,7 @@ void test_spdm_requester_finish_case3(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -573,8 +570,7 @@ void test_spdm_requester_finish_case4(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -620,8 +616,7 @@ void test_spdm_requester_finish_case5(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -667,8 +662,7 @@ void test_spdm_requester_finish_case6(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -715,8 +709,7 @@ void test_spdm_requester_finish_case7(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -763,8 +756,7 @@ void test_spdm_requester_finish_case8(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -810,8 +802,7 @@ void test_spdm_requester_finish_case9(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
 
   session_id = 0xFFFFFFFF;
   session_info = &spdm_context->session_info[0];
@@ -0,0 +1,247 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_requester_lib_internal.h>
+
+//
+// 4 full fragments and a short END fragment.
+//
+#define TEST_FRAGMENT_REQUEST_SIZE  (MAX_SPDM_FRAGMENT_LENGTH * 4 + 0x10)
+
+static uint8                  m_local_request[TEST_FRAGMENT_REQUEST_SIZE];
+static spdm_fragment_request_t m_last_fragment_request;
+static uintn                  m_fragment_request_count;
+static uintn                  m_fragment_ack_count;
+
+return_status
+spdm_requester_fragment_request_test_send_message (
+  IN     void                    *spdm_context,
+  IN     uintn                   request_size,
+  IN     void                    *request,
+  IN     uint64                  timeout
+  )
+{
+  spdm_test_context_t       *spdm_test_context;
+  uintn                   header_size;
+
+  spdm_test_context = get_spdm_test_context ();
+  header_size = sizeof(test_message_header_t);
+  switch (spdm_test_context->case_id) {
+  case 0x1:
+  case 0x2:
+  case 0x3:
+  case 0x4:
+    if (request_size < header_size + sizeof(spdm_fragment_request_t)) {
+      return RETURN_DEVICE_ERROR;
+    }
+    copy_mem (&m_last_fragment_request, (uint8 *)request + header_size, sizeof(spdm_fragment_request_t));
+    m_fragment_request_count ++;
+    return RETURN_SUCCESS;
+  default:
+    return RETURN_DEVICE_ERROR;
+  }
+}
+
+return_status
+spdm_requester_fragment_request_test_receive_message (
+  IN     void                    *spdm_context,
+  IN OUT uintn                   *response_size,
+  IN OUT void                    *response,
+  IN     uint64                  timeout
+  )
+{
+  spdm_test_context_t          *spdm_test_context;
+  spdm_fragment_request_ack_t  spdm_response;
+  spdm_error_response_t        spdm_error_response;
+
+  spdm_test_context = get_spdm_test_context ();
+  m_fragment_ack_count ++;
+
+  spdm_response.header.spdm_version = SPDM_MESSAGE_VERSION_11;
+  spdm_response.header.request_response_code = SPDM_FRAGMENT_REQUEST_ACK;
+  spdm_response.header.param1 = 0;
+  spdm_response.header.param2 = m_last_fragment_request.header.param2;
+  spdm_response.sequence_id = m_last_fragment_request.sequence_id;
+
+  switch (spdm_test_context->case_id) {
+  case 0x1:
+    //
+    // Accept a window of 2.
+    //
+    if ((m_last_fragment_request.header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) {
+      spdm_response.header.param1 = 2;
+    }
+    break;
+  case 0x2:
+    //
+    // Accept a window of 2, then report an error in the first window at the end of the window.
+    //
+    if ((m_last_fragment_request.header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) {
+      spdm_response.header.param1 = 2;
+    } else {
+      spdm_error_response.header.spdm_version = SPDM_MESSAGE_VERSION_11;
+      spdm_error_response.header.request_response_code = SPDM_ERROR;
+      spdm_error_response.header.param1 = SPDM_ERROR_CODE_INVALID_REQUEST;
+      spdm_error_response.header.param2 = 0;
+      spdm_transport_test_encode_message (spdm_context, NULL, FALSE, FALSE, sizeof(spdm_error_response), &spdm_error_response, response_size, response);
+      return RETURN_SUCCESS;
+    }
+    break;
+  case 0x3:
+    //
+    // A window is returned although no window is proposed.
+    //
+    if ((m_last_fragment_request.header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) {
+      spdm_response.header.param1 = 2;
+    }
+    break;
+  case 0x4:
+    //
+    // Accept a window of 2, then acknowledge a fragment inside the window.
+    //
+    if ((m_last_fragment_request.header.param1 & SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN) != 0) {
+      spdm_response.header.param1 = 2;
+    } else {
+      spdm_response.sequence_id = m_last_fragment_request.sequence_id - 1;
+    }
+    break;
+  default:
+    return RETURN_DEVICE_ERROR;
+  }
+
+  spdm_transport_test_encode_message (spdm_context, NULL, FALSE, FALSE, sizeof(spdm_response), &spdm_response, response_size, response);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Test 1: The window is enabled on both sides, and one ACK is received per window.
+  Expected Behavior: 5 fragments are sent, and only the BEGIN fragment and the end of the first window are acknowledged.
+**/
+void test_spdm_requester_fragment_request_case1(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uint8                window_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  window_size = 2;
+  status = spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, NULL, &window_size, sizeof(window_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+  m_fragment_request_count = 0;
+  m_fragment_ack_count = 0;
+
+  status = spdm_send_spdm_fragment_encap_request (spdm_context, NULL, sizeof(m_local_request), m_local_request);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (m_fragment_request_count, 5);
+  assert_int_equal (m_fragment_ack_count, 2);
+  assert_int_equal (m_last_fragment_request.sequence_id, 4);
+}
+
+/**
+  Test 2: The responder returns an ERROR at the end of the window.
+  Expected Behavior: the request fails, and no more fragments are sent.
+**/
+void test_spdm_requester_fragment_request_case2(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uint8                window_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  window_size = 2;
+  status = spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, NULL, &window_size, sizeof(window_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+  m_fragment_request_count = 0;
+  m_fragment_ack_count = 0;
+
+  status = spdm_send_spdm_fragment_encap_request (spdm_context, NULL, sizeof(m_local_request), m_local_request);
+  assert_int_equal (status, RETURN_DEVICE_ERROR);
+  assert_int_equal (m_fragment_request_count, 3);
+  assert_int_equal (m_fragment_ack_count, 2);
+  assert_int_equal (m_last_fragment_request.sequence_id, 2);
+}
+
+/**
+  Test 3: No window is proposed, and the responder returns a window in the reserved param1.
+  Expected Behavior: the window is not used, and every fragment but the END fragment is acknowledged.
+**/
+void test_spdm_requester_fragment_request_case3(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uint8                window_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  window_size = 0;
+  status = spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, NULL, &window_size, sizeof(window_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+  m_fragment_request_count = 0;
+  m_fragment_ack_count = 0;
+
+  status = spdm_send_spdm_fragment_encap_request (spdm_context, NULL, sizeof(m_local_request), m_local_request);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (m_fragment_request_count, 5);
+  assert_int_equal (m_fragment_ack_count, 4);
+}
+
+/**
+  Test 4: The ACK at the end of the window carries the sequence ID of a fragment inside the window.
+  Expected Behavior: the request fails, and no more fragments are sent.
+**/
+void test_spdm_requester_fragment_request_case4(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uint8                window_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x4;
+  window_size = 2;
+  status = spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, NULL, &window_size, sizeof(window_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+  m_fragment_request_count = 0;
+  m_fragment_ack_count = 0;
+
+  status = spdm_send_spdm_fragment_encap_request (spdm_context, NULL, sizeof(m_local_request), m_local_request);
+  assert_int_equal (status, RETURN_DEVICE_ERROR);
+  assert_int_equal (m_fragment_request_count, 3);
+  assert_int_equal (m_fragment_ack_count, 2);
+}
+
+spdm_test_context_t       m_spdm_requester_fragment_request_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  TRUE,
+  spdm_requester_fragment_request_test_send_message,
+  spdm_requester_fragment_request_test_receive_message,
+};
+
+int spdm_requester_fragment_request_test_main(void) {
+  const struct CMUnitTest spdm_requester_fragment_request_tests[] = {
+      // Windowed fragments with one ACK per window
+      cmocka_unit_test(test_spdm_requester_fragment_request_case1),
+      // ERROR at the end of the window
+      cmocka_unit_test(test_spdm_requester_fragment_request_case2),
+      // Window returned without a proposal
+      cmocka_unit_test(test_spdm_requester_fragment_request_case3),
+      // ACK with the wrong sequence ID at the end of the window
+      cmocka_unit_test(test_spdm_requester_fragment_request_case4),
+  };
+
+  setup_spdm_test_context (&m_spdm_requester_fragment_request_test_context);
+
+  return cmocka_run_group_tests(spdm_requester_fragment_request_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
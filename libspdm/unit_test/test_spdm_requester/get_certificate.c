@@ -55,6 +55,8 @@ spdm_requester_get_certificate_test_send_message (
     return RETURN_SUCCESS;
   case 0xF:
     return RETURN_SUCCESS;
+  case 0x11:
+    return RETURN_SUCCESS;
   default:
     return RETURN_DEVICE_ERROR;
   }
@@ -664,6 +666,71 @@ spdm_requester_get_certificate_test_receive_message (
   }
     return RETURN_SUCCESS;
 
+  case 0x11:
+  {
+      spdm_certificate_response_t    *spdm_response;
+      uint8                         temp_buf[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+      uintn                         temp_buf_size;
+      uint16                        portion_length;
+      uint16                        remainder_length;
+      uint16                        get_cert_length;
+      uintn                         count;
+      static uintn                  calling_index = 0;
+
+      uint8                         *root_cert_buffer;
+      uintn                         root_cert_buffer_size;
+      uint8                         *cert_buffer;
+      uintn                         cert_buffer_size;
+      uintn                         hash_size;
+
+      // this should match the value on the test function
+      get_cert_length = 0x100;
+
+      //
+      // The transfer is stopped before the last portion, so the chain is freed by the test function.
+      //
+      if (m_local_certificate_chain == NULL) {
+        calling_index = 0;
+        read_responder_public_certificate_chain (m_use_hash_algo, m_use_asym_algo, &m_local_certificate_chain, &m_local_certificate_chain_size, NULL, NULL);
+        if (m_local_certificate_chain == NULL) {
+          return RETURN_OUT_OF_RESOURCES;
+        }
+
+        hash_size = spdm_get_hash_size (m_use_hash_algo);
+        cert_buffer = (uint8 *)m_local_certificate_chain + sizeof(spdm_cert_chain_t) + hash_size;
+        cert_buffer_size = m_local_certificate_chain_size - sizeof(spdm_cert_chain_t) - hash_size;
+        if (!x509_get_cert_from_cert_chain (cert_buffer, cert_buffer_size, 0, &root_cert_buffer, &root_cert_buffer_size)) {
+          return RETURN_DEVICE_ERROR;
+        }
+        // tamper root certificate on purpose, so that it does not match the root hash
+        root_cert_buffer[root_cert_buffer_size - 1]++;
+      }
+      count = (m_local_certificate_chain_size + get_cert_length - 1) / get_cert_length;
+      if (calling_index != count - 1) {
+        portion_length = get_cert_length;
+        remainder_length = (uint16)(m_local_certificate_chain_size - get_cert_length * (calling_index + 1));
+      } else {
+        portion_length = (uint16)(m_local_certificate_chain_size - get_cert_length * (count - 1));
+        remainder_length = 0;
+      }
+
+      temp_buf_size = sizeof(spdm_certificate_response_t) + portion_length;
+      spdm_response = (void *)temp_buf;
+
+      spdm_response->header.spdm_version = SPDM_MESSAGE_VERSION_10;
+      spdm_response->header.request_response_code = SPDM_CERTIFICATE;
+      spdm_response->header.param1 = 0;
+      spdm_response->header.param2 = 0;
+      spdm_response->portion_length = portion_length;
+      spdm_response->remainder_length = remainder_length;
+      copy_mem (spdm_response + 1, (uint8 *)m_local_certificate_chain + get_cert_length * calling_index, portion_length);
+
+      spdm_transport_test_encode_message (spdm_context, NULL, FALSE, FALSE, temp_buf_size, temp_buf, response_size, response);
+
+      calling_index++;
+  }
+    return RETURN_SUCCESS;
+
   default:
     return RETURN_DEVICE_ERROR;
   }
@@ -1260,6 +1327,124 @@ void test_spdm_requester_get_certificate_case15(void **state) {
   free(data);
 }
 
+/**
+  Test 16: the digest returned by GET_DIGESTS is the digest of a cached certificate chain
+  Expected Behavior: get the cached certificate chain, with no GET_CERTIFICATE messages sent (checked in transcript.message_b buffer),
+                     and the connection state is SPDM_CONNECTION_STATE_AFTER_CERTIFICATE
+**/
+void test_spdm_requester_get_certificate_case16(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                cert_chain_size;
+  uint8                cert_chain[MAX_SPDM_CERT_CHAIN_SIZE];
+  void                 *data;
+  uintn                data_size;
+  void                 *hash;
+  uintn                hash_size;
+  spdm_data_parameter_t  parameter;
+  boolean              data_bool;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x10;
+  spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_AFTER_DIGESTS;
+  spdm_context->connection_info.capability.flags |= SPDM_GET_CAPABILITIES_RESPONSE_FLAGS_CERT_CAP;
+  read_responder_public_certificate_chain (m_use_hash_algo, m_use_asym_algo, &data, &data_size, &hash, &hash_size);
+  spdm_context->local_context.peer_root_cert_hash_provision_size = hash_size;
+  spdm_context->local_context.peer_root_cert_hash_provision = hash;
+  spdm_context->local_context.peer_cert_chain_provision = NULL;
+  spdm_context->local_context.peer_cert_chain_provision_size = 0;
+  spdm_context->transcript.message_b.buffer_size = 0;
+  spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
+
+  zero_mem (&parameter, sizeof(parameter));
+  parameter.location = SPDM_DATA_LOCATION_LOCAL;
+  data_bool = TRUE;
+  status = spdm_set_data (spdm_context, SPDM_DATA_PEER_CERT_CHAIN_CACHE, &parameter, &data_bool, sizeof(data_bool));
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_peer_cert_chain_cache_add (spdm_context, data, data_size);
+  spdm_context->connection_info.peer_digest_slot_mask = 0x1;
+  spdm_hash_all (m_use_hash_algo, data, data_size, spdm_context->connection_info.peer_digest);
+
+  cert_chain_size = sizeof(cert_chain);
+  zero_mem (cert_chain, sizeof(cert_chain));
+  status = spdm_get_certificate (spdm_context, 0, &cert_chain_size, cert_chain);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (cert_chain_size, data_size);
+  assert_memory_equal (cert_chain, data, data_size);
+  assert_int_equal (spdm_context->transcript.message_b.buffer_size, 0);
+  assert_int_equal (spdm_context->connection_info.connection_state, SPDM_CONNECTION_STATE_AFTER_CERTIFICATE);
+  assert_int_equal (spdm_context->connection_info.peer_used_cert_chain_buffer_size, data_size);
+  assert_memory_equal (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+
+  //
+  // The cache is not used if the digest does not match.
+  //
+  spdm_context->connection_info.peer_digest[0] ^= 0xFF;
+  cert_chain_size = sizeof(cert_chain);
+  status = spdm_get_certificate (spdm_context, 0, &cert_chain_size, cert_chain);
+  assert_int_equal (status, RETURN_DEVICE_ERROR);
+
+  data_bool = FALSE;
+  status = spdm_set_data (spdm_context, SPDM_DATA_PEER_CERT_CHAIN_CACHE, &parameter, &data_bool, sizeof(data_bool));
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_context->connection_info.peer_digest_slot_mask = 0;
+  free(data);
+}
+
+/**
+  Test 17: the root certificate of the retrieved certificate chain is tampered
+  Expected Behavior: get a RETURN_SECURITY_VIOLATION, and the transfer stops at the portion which completes the root certificate (checked in transcript.message_b buffer)
+**/
+void test_spdm_requester_get_certificate_case17(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                cert_chain_size;
+  uint8                cert_chain[MAX_SPDM_CERT_CHAIN_SIZE];
+  void                 *data;
+  uintn                data_size;
+  void                 *hash;
+  uintn                hash_size;
+  uint8                *root_cert_buffer;
+  uintn                root_cert_buffer_size;
+  uintn                count;
+  uint16               get_cert_length;
+
+  // this should match the value on the receive function
+  get_cert_length = 0x100;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x11;
+  // Setting SPDM context as the first steps of the protocol has been accomplished
+  spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_AFTER_DIGESTS;
+  spdm_context->connection_info.capability.flags |= SPDM_GET_CAPABILITIES_RESPONSE_FLAGS_CERT_CAP;
+  read_responder_public_certificate_chain (m_use_hash_algo, m_use_asym_algo, &data, &data_size, &hash, &hash_size);
+  spdm_context->local_context.peer_root_cert_hash_provision_size = 0;
+  spdm_context->local_context.peer_root_cert_hash_provision = NULL;
+  spdm_context->local_context.peer_cert_chain_provision = NULL;
+  spdm_context->local_context.peer_cert_chain_provision_size = 0;
+  spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
+  // Reseting message buffer
+  spdm_context->transcript.message_b.buffer_size = 0;
+  // Calculating expected number of messages received, until the root certificate is complete
+  x509_get_cert_from_cert_chain ((uint8 *)data + sizeof(spdm_cert_chain_t) + hash_size, data_size - sizeof(spdm_cert_chain_t) - hash_size, 0, &root_cert_buffer, &root_cert_buffer_size);
+  count = (sizeof(spdm_cert_chain_t) + hash_size + root_cert_buffer_size + get_cert_length - 1) / get_cert_length;
+  assert_true (count * get_cert_length < data_size);
+
+  cert_chain_size = sizeof(cert_chain);
+  zero_mem (cert_chain, sizeof(cert_chain));
+  status = spdm_get_certificate_choose_length (spdm_context, 0, get_cert_length, &cert_chain_size, cert_chain);
+  assert_int_equal (status, RETURN_SECURITY_VIOLATION);
+  assert_int_equal (spdm_context->transcript.message_b.buffer_size, (sizeof(spdm_get_certificate_request_t) + sizeof(spdm_certificate_response_t) + get_cert_length)*count);
+  free (m_local_certificate_chain);
+  m_local_certificate_chain = NULL;
+  m_local_certificate_chain_size = 0;
+  free(data);
+}
+
 spdm_test_context_t       m_spdm_requester_get_certificate_test_context = {
   SPDM_TEST_CONTEXT_SIGNATURE,
   TRUE,
@@ -1299,6 +1484,10 @@ int spdm_requester_get_certificate_test_main(void) {
       cmocka_unit_test(test_spdm_requester_get_certificate_case14),
       // Sucessful response: get a long certificate chain
       cmocka_unit_test(test_spdm_requester_get_certificate_case15),
+      // Cached certificate chain: no GET_CERTIFICATE message
+      cmocka_unit_test(test_spdm_requester_get_certificate_case16),
+      // Tampered root certificate: the transfer stops early
+      cmocka_unit_test(test_spdm_requester_get_certificate_case17),
   };
 
   setup_spdm_test_context (&m_spdm_requester_get_certificate_test_context);
@@ -12,6 +12,30 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 static uint8                  m_local_certificate_chain[MAX_SPDM_MESSAGE_BUFFER_SIZE];
 
+/**
+  Fill message_b with cached data of the given size.
+
+  message_b is allocated from the arena on demand, so the data must be appended instead of setting the buffer_size.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  size                          The size in bytes of message_b.
+**/
+static void
+spdm_test_fill_message_b (
+  IN     spdm_context_t           *spdm_context,
+  IN     uintn                    size
+  )
+{
+  uintn  fill_size;
+
+  reset_managed_buffer (&spdm_context->transcript.message_b);
+  while (size > 0) {
+    fill_size = MIN (size, sizeof(m_local_certificate_chain));
+    append_managed_buffer (&spdm_context->transcript.message_b, m_local_certificate_chain, fill_size);
+    size -= fill_size;
+  }
+}
+
 return_status
 spdm_requester_get_digests_test_send_message (
   IN     void                    *spdm_context,
@@ -921,7 +945,7 @@ void test_spdm_requester_get_digests_case15(void **state) {
   spdm_context->local_context.peer_cert_chain_provision = m_local_certificate_chain;
   spdm_context->local_context.peer_cert_chain_provision_size = MAX_SPDM_MESSAGE_BUFFER_SIZE;
   set_mem (m_local_certificate_chain, MAX_SPDM_MESSAGE_BUFFER_SIZE, (uint8)(0xFF));
-  spdm_context->transcript.message_b.buffer_size = spdm_context->transcript.message_b.max_buffer_size;
+  spdm_test_fill_message_b (spdm_context, spdm_context->transcript.message_b.max_buffer_size);
 
   zero_mem (total_digest_buffer, sizeof(total_digest_buffer));
   status = spdm_get_digest (spdm_context, &slot_mask, &total_digest_buffer);
@@ -948,7 +972,7 @@ void test_spdm_requester_get_digests_case16(void **state) {
   spdm_context->local_context.peer_cert_chain_provision = m_local_certificate_chain;
   spdm_context->local_context.peer_cert_chain_provision_size = MAX_SPDM_MESSAGE_BUFFER_SIZE;
   set_mem (m_local_certificate_chain, MAX_SPDM_MESSAGE_BUFFER_SIZE, (uint8)(0xFF));
-  spdm_context->transcript.message_b.buffer_size = spdm_context->transcript.message_b.max_buffer_size - (sizeof(spdm_digest_response_t));
+  spdm_test_fill_message_b (spdm_context, spdm_context->transcript.message_b.max_buffer_size - (sizeof(spdm_digest_response_t)));
 
   zero_mem (total_digest_buffer, sizeof(total_digest_buffer));
   status = spdm_get_digest (spdm_context, &slot_mask, &total_digest_buffer);
@@ -1474,8 +1474,7 @@ void test_spdm_requester_get_measurements_case1(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1513,8 +1512,7 @@ void test_spdm_requester_get_measurements_case2(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1552,8 +1550,7 @@ void test_spdm_requester_get_measurements_case3(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1591,8 +1588,7 @@ void test_spdm_requester_get_measurements_case4(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1630,8 +1626,7 @@ void test_spdm_requester_get_measurements_case5(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1669,8 +1664,7 @@ void test_spdm_requester_get_measurements_case6(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1708,8 +1702,7 @@ void test_spdm_requester_get_measurements_case7(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1748,8 +1741,7 @@ void test_spdm_requester_get_measurements_case8(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1786,8 +1778,7 @@ void test_spdm_requester_get_measurements_case9(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1823,8 +1814,7 @@ void test_spdm_requester_get_measurements_case10(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   status = spdm_get_measurement (
@@ -1865,8 +1855,7 @@ void test_spdm_requester_get_measurements_case11(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1907,8 +1896,7 @@ void test_spdm_requester_get_measurements_case12(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1949,8 +1937,7 @@ void test_spdm_requester_get_measurements_case13(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -1991,8 +1978,7 @@ void test_spdm_requester_get_measurements_case14(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2033,8 +2019,7 @@ void test_spdm_requester_get_measurements_case15(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2075,8 +2060,7 @@ void test_spdm_requester_get_measurements_case16(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   for(int i=0; i<sizeof(SlotIDs)/sizeof(SlotIDs[0]); i++) {
@@ -2125,8 +2109,7 @@ void test_spdm_requester_get_measurements_case17(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   for (int i=0; i<3; i++) {
@@ -2174,8 +2157,7 @@ void test_spdm_requester_get_measurements_case18(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2216,8 +2198,7 @@ void test_spdm_requester_get_measurements_case19(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2258,8 +2239,7 @@ void test_spdm_requester_get_measurements_case20(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2300,8 +2280,7 @@ void test_spdm_requester_get_measurements_case21(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2344,8 +2323,7 @@ void test_spdm_requester_get_measurements_case22(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2393,8 +2371,7 @@ void test_spdm_requester_get_measurements_case23(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2435,8 +2412,7 @@ void test_spdm_requester_get_measurements_case24(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2477,8 +2453,7 @@ void test_spdm_requester_get_measurements_case25(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2519,8 +2494,7 @@ void test_spdm_requester_get_measurements_case26(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2561,8 +2535,7 @@ void test_spdm_requester_get_measurements_case27(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2604,8 +2577,7 @@ void test_spdm_requester_get_measurements_case28(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE;
   ExpectedBufferSize = 0;
 
@@ -2647,8 +2619,7 @@ void test_spdm_requester_get_measurements_case29(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2688,8 +2659,7 @@ void test_spdm_requester_get_measurements_case30(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2730,8 +2700,7 @@ void test_spdm_requester_get_measurements_case31(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
@@ -2769,8 +2738,7 @@ void test_spdm_requester_get_measurements_case32(void **state) {
   spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
   spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   request_attribute = 0;
 
   measurement_record_length = sizeof(measurement_record);
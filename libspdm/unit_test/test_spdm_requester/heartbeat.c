@@ -364,8 +364,7 @@ void test_spdm_requester_heartbeat_case1(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -408,8 +407,7 @@ void test_spdm_requester_heartbeat_case2(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -457,8 +455,7 @@ void test_spdm_requester_heartbeat_case3(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -506,8 +503,7 @@ void test_spdm_requester_heartbeat_case4(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -555,8 +551,7 @@ void test_spdm_requester_heartbeat_case5(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -604,8 +599,7 @@ void test_spdm_requester_heartbeat_case6(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -653,8 +647,7 @@ void test_spdm_requester_heartbeat_case7(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -703,8 +696,7 @@ void test_spdm_requester_heartbeat_case8(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
@@ -752,8 +744,7 @@ void test_spdm_requester_heartbeat_case9(void **state) {
   spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
   spdm_context->connection_info.algorithm.dhe_named_group = m_use_dhe_algo; 
   spdm_context->connection_info.algorithm.aead_cipher_suite = m_use_aead_algo;
-  spdm_context->connection_info.peer_used_cert_chain_buffer_size = data_size;
-  copy_mem (spdm_context->connection_info.peer_used_cert_chain_buffer, data, data_size);
+  spdm_set_peer_used_cert_chain_buffer (spdm_context, data, data_size);
   zero_mem (m_local_psk_hint, 32);
   copy_mem (&m_local_psk_hint[0], TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
   spdm_context->local_context.psk_hint_size = sizeof(TEST_PSK_HINT_STRING);
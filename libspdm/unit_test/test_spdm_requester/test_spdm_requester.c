@@ -23,6 +23,8 @@ int spdm_requester_psk_exchange_test_main (void);
 int spdm_requester_psk_finish_test_main (void);
 int spdm_requester_heartbeat_test_main (void);
 int spdm_requester_end_session_test_main (void);
+int spdm_requester_async_test_main (void);
+int spdm_requester_fragment_request_test_main (void);
 
 int main(void) {
   spdm_requester_get_version_test_main();
@@ -50,5 +52,9 @@ int main(void) {
   spdm_requester_heartbeat_test_main();
 
   spdm_requester_end_session_test_main();
+
+  spdm_requester_async_test_main();
+
+  spdm_requester_fragment_request_test_main();
   return 0;
 }
@@ -55,7 +55,8 @@ uintn m_spdm_get_certificate_request3_size = sizeof(m_spdm_get_certificate_reque
 
 /**
   Test 1: request the first MAX_SPDM_CERT_CHAIN_BLOCK_LEN bytes of the certificate chain
-  Expected Behavior: generate a correctly formed Certficate message, including its portion_length and remainder_length fields
+  Expected Behavior: generate a correctly formed Certficate message, including its portion_length and remainder_length fields.
+  The whole certificate chain is returned if it is shorter than MAX_SPDM_CERT_CHAIN_BLOCK_LEN.
 **/
 void test_spdm_responder_certificate_case1(void **state) {
   return_status        status;
@@ -66,6 +67,7 @@ void test_spdm_responder_certificate_case1(void **state) {
   spdm_certificate_response_t *spdm_response;
   void                 *data;
   uintn                data_size;
+  uintn                portion_length;
 
   spdm_test_context = *state;
   spdm_context = spdm_test_context->spdm_context;
@@ -80,12 +82,13 @@ void test_spdm_responder_certificate_case1(void **state) {
   response_size = sizeof(response);
   status = spdm_get_response_certificate (spdm_context, m_spdm_get_certificate_request1_size, &m_spdm_get_certificate_request1, &response_size, response);
   assert_int_equal (status, RETURN_SUCCESS);
-  assert_int_equal (response_size, sizeof(spdm_certificate_response_t) + MAX_SPDM_CERT_CHAIN_BLOCK_LEN);
+  portion_length = MIN (data_size, MAX_SPDM_CERT_CHAIN_BLOCK_LEN);
+  assert_int_equal (response_size, sizeof(spdm_certificate_response_t) + portion_length);
   spdm_response = (void *)response;
   assert_int_equal (spdm_response->header.request_response_code, SPDM_CERTIFICATE);
   assert_int_equal (spdm_response->header.param1, 0);
-  assert_int_equal (spdm_response->portion_length, MAX_SPDM_CERT_CHAIN_BLOCK_LEN);
-  assert_int_equal (spdm_response->remainder_length, data_size - MAX_SPDM_CERT_CHAIN_BLOCK_LEN);
+  assert_int_equal (spdm_response->portion_length, portion_length);
+  assert_int_equal (spdm_response->remainder_length, data_size - portion_length);
   free(data);
 }
 
@@ -694,6 +697,62 @@ void test_spdm_responder_certificate_case12(void **state) {
   free(data);
 }
 
+/**
+  Test 13: request MAX_SPDM_CERT_CHAIN_BLOCK_LEN bytes with a smaller local data transfer size
+  Expected Behavior: generate a correctly formed Certficate message whose portion_length is limited by the data transfer size.
+**/
+void test_spdm_responder_certificate_case13(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                response_size;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_certificate_response_t *spdm_response;
+  void                 *data;
+  uintn                data_size;
+  uintn                portion_length;
+  uint32               data_transfer_size;
+  spdm_data_parameter_t  parameter;
+  spdm_get_certificate_request_t  spdm_request;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0xD;
+  spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_AFTER_DIGESTS;
+  spdm_context->local_context.capability.flags |= SPDM_GET_CAPABILITIES_RESPONSE_FLAGS_CERT_CAP;
+  read_responder_public_certificate_chain (m_use_hash_algo, m_use_asym_algo, &data, &data_size, NULL, NULL);
+  spdm_context->local_context.local_cert_chain_provision[0] = data;
+  spdm_context->local_context.local_cert_chain_provision_size[0] = data_size;
+  spdm_context->local_context.slot_count = 1;
+
+  zero_mem (&parameter, sizeof(parameter));
+  parameter.location = SPDM_DATA_LOCATION_LOCAL;
+  data_transfer_size = sizeof(spdm_certificate_response_t) + 0x100;
+  status = spdm_set_data (spdm_context, SPDM_DATA_CAPABILITY_DATA_TRANSFER_SIZE, &parameter, &data_transfer_size, sizeof(data_transfer_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+  reset_managed_buffer (&spdm_context->transcript.message_b);
+
+  zero_mem (&spdm_request, sizeof(spdm_request));
+  spdm_request.header.spdm_version = SPDM_MESSAGE_VERSION_10;
+  spdm_request.header.request_response_code = SPDM_GET_CERTIFICATE;
+  spdm_request.Offset = 0;
+  spdm_request.length = MAX_SPDM_CERT_CHAIN_BLOCK_LEN;
+
+  response_size = sizeof(response);
+  status = spdm_get_response_certificate (spdm_context, sizeof(spdm_request), &spdm_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  portion_length = MIN (data_size, 0x100);
+  assert_int_equal (response_size, sizeof(spdm_certificate_response_t) + portion_length);
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_CERTIFICATE);
+  assert_int_equal (spdm_response->portion_length, portion_length);
+  assert_int_equal (spdm_response->remainder_length, data_size - portion_length);
+
+  data_transfer_size = MAX_SPDM_FRAGMENT_LENGTH;
+  spdm_set_data (spdm_context, SPDM_DATA_CAPABILITY_DATA_TRANSFER_SIZE, &parameter, &data_transfer_size, sizeof(data_transfer_size));
+  free(data);
+}
+
 
 spdm_test_context_t       m_spdm_responder_certificate_test_context = {
   SPDM_TEST_CONTEXT_SIGNATURE,
@@ -726,6 +785,8 @@ int spdm_responder_certificate_test_main(void) {
     cmocka_unit_test(test_spdm_responder_certificate_case11),
     // Requests byte by byte
     cmocka_unit_test(test_spdm_responder_certificate_case12),
+    // Portion length limited by the data transfer size
+    cmocka_unit_test(test_spdm_responder_certificate_case13),
 
   };
 
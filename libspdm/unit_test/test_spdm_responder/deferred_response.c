@@ -0,0 +1,416 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_responder_lib_internal.h>
+#include <library/threadlib.h>
+
+#define TEST_DEFERRED_RESPONSE_WAIT_COUNT  10000
+
+typedef struct {
+  spdm_context_t    *spdm_context;
+  volatile boolean  block;
+  volatile boolean  started;
+  volatile uintn    run_count;
+} test_deferred_response_context_t;
+
+static test_deferred_response_context_t  m_test_deferred_response_context;
+
+spdm_challenge_request_t    m_spdm_deferred_challenge_request = {
+  {
+    SPDM_MESSAGE_VERSION_11,
+    SPDM_CHALLENGE,
+    0,
+    SPDM_CHALLENGE_REQUEST_NO_MEASUREMENT_SUMMARY_HASH
+  },
+};
+
+spdm_message_header_t    m_spdm_deferred_key_exchange_request = {
+  SPDM_MESSAGE_VERSION_11,
+  SPDM_KEY_EXCHANGE,
+  0,
+  0
+};
+
+spdm_get_digest_request_t    m_spdm_deferred_get_digest_request = {
+  {
+    SPDM_MESSAGE_VERSION_11,
+    SPDM_GET_DIGESTS,
+    0,
+    0
+  },
+};
+
+/**
+  The handler of the deferred request. It runs in the worker pool, and it is blocked until the test releases it.
+**/
+static
+return_status
+test_spdm_responder_deferred_response_handler (
+  IN     void                 *context,
+  IN     uintn                request_size,
+  IN     void                 *request,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  )
+{
+  spdm_message_header_t  *spdm_response;
+
+  m_test_deferred_response_context.started = TRUE;
+  while (m_test_deferred_response_context.block) {
+    thread_sleep (1000);
+  }
+  m_test_deferred_response_context.run_count++;
+
+  spdm_response = response;
+  spdm_response->spdm_version = SPDM_MESSAGE_VERSION_11;
+  spdm_response->request_response_code = SPDM_CHALLENGE_AUTH;
+  spdm_response->param1 = 0;
+  spdm_response->param2 = 0;
+  *response_size = sizeof(spdm_message_header_t);
+  return RETURN_SUCCESS;
+}
+
+/**
+  The handler of the deferred KEY_EXCHANGE. It runs in the worker pool, and it is blocked until the test releases it.
+  The session table is updated by the handler, in the same way as KEY_EXCHANGE.
+**/
+static
+return_status
+test_spdm_responder_deferred_response_key_exchange_handler (
+  IN     void                 *context,
+  IN     uintn                request_size,
+  IN     void                 *request,
+  IN OUT uintn                *response_size,
+     OUT void                 *response
+  )
+{
+  spdm_message_header_t  *spdm_response;
+
+  m_test_deferred_response_context.started = TRUE;
+  while (m_test_deferred_response_context.block) {
+    thread_sleep (1000);
+  }
+  m_test_deferred_response_context.run_count++;
+  if (spdm_assign_session_id (context, 0xFFFEFFFE, FALSE) == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  spdm_response = response;
+  spdm_response->spdm_version = SPDM_MESSAGE_VERSION_11;
+  spdm_response->request_response_code = SPDM_KEY_EXCHANGE_RSP;
+  spdm_response->param1 = 0;
+  spdm_response->param2 = 0;
+  *response_size = sizeof(spdm_message_header_t);
+  return RETURN_SUCCESS;
+}
+
+/**
+  A job that occupies the worker thread until the test releases it.
+**/
+static
+void
+test_spdm_responder_deferred_response_blocking_job (
+  IN void  *context
+  )
+{
+  test_deferred_response_context_t  *job_context;
+
+  job_context = context;
+  job_context->started = TRUE;
+  while (job_context->block) {
+    thread_sleep (1000);
+  }
+  job_context->run_count++;
+}
+
+/**
+  Unblock the job once spdm_worker_pool_stop has dropped the queued jobs.
+**/
+static
+void
+test_spdm_responder_deferred_response_unblock (
+  IN void  *context
+  )
+{
+  test_deferred_response_context_t  *job_context;
+  uintn                             index;
+
+  job_context = context;
+  for (index = 0; index < TEST_DEFERRED_RESPONSE_WAIT_COUNT; index++) {
+    if (*(volatile boolean *)&job_context->spdm_context->worker_pool.stop) {
+      break;
+    }
+    thread_sleep (1000);
+  }
+  job_context->block = FALSE;
+}
+
+static
+void
+test_spdm_responder_deferred_response_setup (
+  IN spdm_context_t  *spdm_context,
+  IN uint8           thread_count
+  )
+{
+  return_status    status;
+  boolean          enabled;
+
+  status = spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, NULL, &thread_count, sizeof(thread_count));
+  assert_int_equal(status, RETURN_SUCCESS);
+  enabled = TRUE;
+  status = spdm_set_data (spdm_context, SPDM_DATA_DEFERRED_RESPONSE, NULL, &enabled, sizeof(enabled));
+  assert_int_equal(status, RETURN_SUCCESS);
+  spdm_context->response_state = SPDM_RESPONSE_STATE_NORMAL;
+  spdm_context->connection_info.version.spdm_version_count = 1;
+  spdm_context->connection_info.version.spdm_version[0].major_version = 1;
+  spdm_context->connection_info.version.spdm_version[0].minor_version = 1;
+
+  zero_mem (&m_test_deferred_response_context, sizeof(m_test_deferred_response_context));
+  m_test_deferred_response_context.spdm_context = spdm_context;
+}
+
+/**
+  Process a request in the same way as the dispatch of the responder.
+**/
+static
+return_status
+test_spdm_responder_deferred_response_process (
+  IN     spdm_context_t               *spdm_context,
+  IN     spdm_get_spdm_response_func  get_response_func,
+  IN     uintn                        request_size,
+  IN     void                         *request,
+  IN OUT uintn                        *response_size,
+     OUT void                         *response
+  )
+{
+  get_response_func = spdm_get_deferrable_response_func (spdm_context, get_response_func, request_size, request);
+  return get_response_func (spdm_context, request_size, request, response_size, response);
+}
+
+/**
+  Test 1: CHALLENGE is deferred, and the response is collected by RESPOND_IF_READY after the job is done.
+  Expected Behavior: ERROR(ResponseNotReady) with a token is returned at once. While the job runs,
+  RESPOND_IF_READY gets ERROR(ResponseNotReady) again with a larger RDTExponent and GET_DIGESTS gets ERROR(Busy).
+  After the job is done, RESPOND_IF_READY gets the response of the handler.
+**/
+void test_spdm_responder_deferred_response_case1(void **state) {
+  return_status                                  status;
+  spdm_test_context_t                            *spdm_test_context;
+  spdm_context_t                                 *spdm_context;
+  uintn                                          response_size;
+  uint8                                          response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_error_response_data_response_not_ready_t  *spdm_not_ready_response;
+  spdm_message_header_t                          *spdm_response;
+  spdm_message_header_t                          respond_if_ready_request;
+  uint8                                          rd_exponent;
+  uintn                                          index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  test_spdm_responder_deferred_response_setup (spdm_context, 1);
+  m_test_deferred_response_context.block = TRUE;
+
+  response_size = sizeof(response);
+  status = test_spdm_responder_deferred_response_process (spdm_context, test_spdm_responder_deferred_response_handler, sizeof(m_spdm_deferred_challenge_request), &m_spdm_deferred_challenge_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_error_response_data_response_not_ready_t));
+  spdm_not_ready_response = (void *)response;
+  assert_int_equal (spdm_not_ready_response->header.request_response_code, SPDM_ERROR);
+  assert_int_equal (spdm_not_ready_response->header.param1, SPDM_ERROR_CODE_RESPONSE_NOT_READY);
+  assert_int_equal (spdm_not_ready_response->extend_error_data.request_code, SPDM_CHALLENGE);
+  assert_true (spdm_context->deferred_response.in_flight);
+  rd_exponent = spdm_not_ready_response->extend_error_data.rd_exponent;
+
+  respond_if_ready_request.spdm_version = SPDM_MESSAGE_VERSION_11;
+  respond_if_ready_request.request_response_code = SPDM_RESPOND_IF_READY;
+  respond_if_ready_request.param1 = SPDM_CHALLENGE;
+  respond_if_ready_request.param2 = spdm_not_ready_response->extend_error_data.token;
+
+  response_size = sizeof(response);
+  status = test_spdm_responder_deferred_response_process (spdm_context, spdm_get_response_respond_if_ready, sizeof(respond_if_ready_request), &respond_if_ready_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_not_ready_response = (void *)response;
+  assert_int_equal (spdm_not_ready_response->header.request_response_code, SPDM_ERROR);
+  assert_int_equal (spdm_not_ready_response->header.param1, SPDM_ERROR_CODE_RESPONSE_NOT_READY);
+  assert_int_equal (spdm_not_ready_response->extend_error_data.rd_exponent, rd_exponent + 1);
+  assert_int_equal (spdm_not_ready_response->extend_error_data.token, respond_if_ready_request.param2);
+
+  response_size = sizeof(response);
+  status = test_spdm_responder_deferred_response_process (spdm_context, spdm_get_response_digests, sizeof(m_spdm_deferred_get_digest_request), &m_spdm_deferred_get_digest_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->request_response_code, SPDM_ERROR);
+  assert_int_equal (spdm_response->param1, SPDM_ERROR_CODE_BUSY);
+  assert_true (spdm_context->deferred_response.in_flight);
+
+  m_test_deferred_response_context.block = FALSE;
+  for (index = 0; index < TEST_DEFERRED_RESPONSE_WAIT_COUNT; index++) {
+    if (!spdm_is_deferred_response_running (spdm_context)) {
+      break;
+    }
+    thread_sleep (1000);
+  }
+  assert_int_equal (spdm_is_deferred_response_running (spdm_context), FALSE);
+  assert_int_equal (m_test_deferred_response_context.run_count, 1);
+
+  response_size = sizeof(response);
+  status = test_spdm_responder_deferred_response_process (spdm_context, spdm_get_response_respond_if_ready, sizeof(respond_if_ready_request), &respond_if_ready_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_message_header_t));
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->request_response_code, SPDM_CHALLENGE_AUTH);
+  assert_int_equal (spdm_context->deferred_response.in_flight, FALSE);
+}
+
+/**
+  Test 2: the worker pool is stopped while the deferred CHALLENGE is queued behind a running job.
+  Expected Behavior: the deferred job is dropped without running the handler, and RESPOND_IF_READY
+  gets ERROR(Unspecified). The deferred request is released.
+**/
+void test_spdm_responder_deferred_response_case2(void **state) {
+  return_status                                  status;
+  spdm_test_context_t                            *spdm_test_context;
+  spdm_context_t                                 *spdm_context;
+  uintn                                          response_size;
+  uint8                                          response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_error_response_data_response_not_ready_t  *spdm_not_ready_response;
+  spdm_message_header_t                          *spdm_response;
+  spdm_message_header_t                          respond_if_ready_request;
+  test_deferred_response_context_t               job_context;
+  spdm_job_t                                     job;
+  void                                           *thread;
+  uintn                                          index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  test_spdm_responder_deferred_response_setup (spdm_context, 1);
+
+  zero_mem (&job_context, sizeof(job_context));
+  job_context.spdm_context = spdm_context;
+  job_context.block = TRUE;
+  job.func = test_spdm_responder_deferred_response_blocking_job;
+  job.context = &job_context;
+  assert_true (spdm_worker_pool_submit (spdm_context, &job));
+  for (index = 0; index < TEST_DEFERRED_RESPONSE_WAIT_COUNT; index++) {
+    if (job_context.started) {
+      break;
+    }
+    thread_sleep (1000);
+  }
+  assert_true (job_context.started);
+
+  response_size = sizeof(response);
+  status = test_spdm_responder_deferred_response_process (spdm_context, test_spdm_responder_deferred_response_handler, sizeof(m_spdm_deferred_challenge_request), &m_spdm_deferred_challenge_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_not_ready_response = (void *)response;
+  assert_int_equal (spdm_not_ready_response->header.param1, SPDM_ERROR_CODE_RESPONSE_NOT_READY);
+  assert_int_equal (spdm_context->deferred_response.job.status, SPDM_JOB_STATUS_QUEUED);
+
+  respond_if_ready_request.spdm_version = SPDM_MESSAGE_VERSION_11;
+  respond_if_ready_request.request_response_code = SPDM_RESPOND_IF_READY;
+  respond_if_ready_request.param1 = SPDM_CHALLENGE;
+  respond_if_ready_request.param2 = spdm_not_ready_response->extend_error_data.token;
+
+  thread = thread_create (test_spdm_responder_deferred_response_unblock, &job_context);
+  assert_true (thread != NULL);
+  spdm_worker_pool_stop (spdm_context);
+  thread_join (thread);
+
+  assert_int_equal (job_context.run_count, 1);
+  assert_int_equal (spdm_context->deferred_response.job.status, SPDM_JOB_STATUS_DROPPED);
+  assert_int_equal (spdm_is_deferred_response_running (spdm_context), FALSE);
+  assert_int_equal (m_test_deferred_response_context.run_count, 0);
+
+  response_size = sizeof(response);
+  status = test_spdm_responder_deferred_response_process (spdm_context, spdm_get_response_respond_if_ready, sizeof(respond_if_ready_request), &respond_if_ready_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_error_response_t));
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->request_response_code, SPDM_ERROR);
+  assert_int_equal (spdm_response->param1, SPDM_ERROR_CODE_UNSPECIFIED);
+  assert_int_equal (spdm_context->deferred_response.in_flight, FALSE);
+  assert_int_equal (m_test_deferred_response_context.run_count, 0);
+}
+
+/**
+  Test 3: the context is deinitialized while the deferred KEY_EXCHANGE is running.
+  Expected Behavior: an established session is found while KEY_EXCHANGE is in flight. spdm_deinit_context
+  waits for the job, which updates the session table, and then releases the deferred request and the arena.
+**/
+void test_spdm_responder_deferred_response_case3(void **state) {
+  return_status                                  status;
+  spdm_test_context_t                            *spdm_test_context;
+  spdm_context_t                                 *spdm_context;
+  uintn                                          response_size;
+  uint8                                          response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_error_response_data_response_not_ready_t  *spdm_not_ready_response;
+  void                                           *thread;
+  uintn                                          index;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  test_spdm_responder_deferred_response_setup (spdm_context, 1);
+  m_test_deferred_response_context.block = TRUE;
+  assert_true (spdm_assign_session_id (spdm_context, 0xFFFFFFFF, FALSE) != NULL);
+
+  response_size = sizeof(response);
+  status = test_spdm_responder_deferred_response_process (spdm_context, test_spdm_responder_deferred_response_key_exchange_handler, sizeof(m_spdm_deferred_key_exchange_request), &m_spdm_deferred_key_exchange_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_not_ready_response = (void *)response;
+  assert_int_equal (spdm_not_ready_response->header.param1, SPDM_ERROR_CODE_RESPONSE_NOT_READY);
+  assert_int_equal (spdm_not_ready_response->extend_error_data.request_code, SPDM_KEY_EXCHANGE);
+  for (index = 0; index < TEST_DEFERRED_RESPONSE_WAIT_COUNT; index++) {
+    if (m_test_deferred_response_context.started) {
+      break;
+    }
+    thread_sleep (1000);
+  }
+  assert_true (m_test_deferred_response_context.started);
+  assert_true (spdm_get_secured_message_context_via_session_id (spdm_context, 0xFFFFFFFF) != NULL);
+
+  thread = thread_create (test_spdm_responder_deferred_response_unblock, &m_test_deferred_response_context);
+  assert_true (thread != NULL);
+  spdm_deinit_context (spdm_context);
+  thread_join (thread);
+
+  assert_int_equal (m_test_deferred_response_context.run_count, 1);
+  assert_int_equal (spdm_context->deferred_response.in_flight, FALSE);
+  assert_true (spdm_context->deferred_response.request == NULL);
+  assert_true (spdm_context->session_info == NULL);
+  assert_true (spdm_context->session_table_mutex == NULL);
+  assert_int_equal (spdm_context->arena.used_size, 0);
+
+  spdm_init_context (spdm_context);
+  spdm_register_device_io_func (spdm_context, spdm_test_context->send_message, spdm_test_context->receive_message);
+  spdm_register_transport_layer_func (spdm_context, spdm_transport_test_encode_message, spdm_transport_test_decode_message);
+}
+
+spdm_test_context_t       m_spdm_responder_deferred_response_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_responder_deferred_response_test_main(void) {
+  const struct CMUnitTest spdm_responder_deferred_response_tests[] = {
+    // ResponseNotReady, then RESPOND_IF_READY
+    cmocka_unit_test(test_spdm_responder_deferred_response_case1),
+    // Worker pool stopped with the deferred job queued
+    cmocka_unit_test(test_spdm_responder_deferred_response_case2),
+    // Context deinitialized with the deferred KEY_EXCHANGE running
+    cmocka_unit_test(test_spdm_responder_deferred_response_case3),
+  };
+
+  setup_spdm_test_context (&m_spdm_responder_deferred_response_test_context);
+
+  return cmocka_run_group_tests(spdm_responder_deferred_response_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
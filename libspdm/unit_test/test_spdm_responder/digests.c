@@ -28,6 +28,30 @@ uintn m_spdm_get_digests_request2_size = MAX_SPDM_MESSAGE_BUFFER_SIZE;
 
 static uint8                  m_local_certificate_chain[MAX_SPDM_MESSAGE_BUFFER_SIZE];
 
+/**
+  Fill message_b with cached data of the given size.
+
+  message_b is allocated from the arena on demand, so the data must be appended instead of setting the buffer_size.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+  @param  size                          The size in bytes of message_b.
+**/
+static void
+spdm_test_fill_message_b (
+  IN     spdm_context_t           *spdm_context,
+  IN     uintn                    size
+  )
+{
+  uintn  fill_size;
+
+  reset_managed_buffer (&spdm_context->transcript.message_b);
+  while (size > 0) {
+    fill_size = MIN (size, sizeof(m_local_certificate_chain));
+    append_managed_buffer (&spdm_context->transcript.message_b, m_local_certificate_chain, fill_size);
+    size -= fill_size;
+  }
+}
+
 /**
   Test 1: receives a valid GET_DIGESTS request message from Requester
   Expected Behavior: produces a valid DIGESTS response message
@@ -260,7 +284,7 @@ void test_spdm_responder_digests_case7(void **state) {
   spdm_context->local_context.slot_count = 1;
 
   response_size = sizeof(response);
-  spdm_context->transcript.message_b.buffer_size = spdm_context->transcript.message_b.max_buffer_size;
+  spdm_test_fill_message_b (spdm_context, spdm_context->transcript.message_b.max_buffer_size);
   status = spdm_get_response_digests (spdm_context, m_spdm_get_digests_request1_size, &m_spdm_get_digests_request1, &response_size, response);
   assert_int_equal (status, RETURN_SUCCESS);
   assert_int_equal (response_size, sizeof(spdm_error_response_t));
@@ -294,7 +318,7 @@ void test_spdm_responder_digests_case8(void **state) {
   spdm_context->local_context.slot_count = 1;
 
   response_size = sizeof(response);
-  spdm_context->transcript.message_b.buffer_size = spdm_context->transcript.message_b.max_buffer_size - sizeof(spdm_get_digest_request_t);
+  spdm_test_fill_message_b (spdm_context, spdm_context->transcript.message_b.max_buffer_size - sizeof(spdm_get_digest_request_t));
   status = spdm_get_response_digests (spdm_context, m_spdm_get_digests_request1_size, &m_spdm_get_digests_request1, &response_size, response);
   assert_int_equal (status, RETURN_SUCCESS);
   assert_int_equal (response_size, sizeof(spdm_error_response_t));
@@ -341,6 +365,72 @@ void test_spdm_responder_digests_case9(void **state) {
   assert_int_equal (spdm_response->header.param2, SPDM_GET_DIGESTS);
 }
 
+/**
+  Test 10: receives GET_DIGESTS request messages from Requester, and the local certificate chain is changed between them
+  Expected Behavior: the certificate chain hash is cached, and the cache is invalidated once the local certificate chain is changed
+**/
+void test_spdm_responder_digests_case10(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                response_size;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  uint8                cached_response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_digest_response_t *spdm_response;
+  spdm_data_parameter_t  parameter;
+  uint8                slot_count;
+  uint8                other_certificate_chain[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  uint32               hash_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0xA;
+  spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_NEGOTIATED;
+  spdm_context->local_context.capability.flags |= SPDM_GET_CAPABILITIES_RESPONSE_FLAGS_CERT_CAP;
+  spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
+  hash_size = spdm_get_hash_size (m_use_hash_algo);
+
+  zero_mem (&parameter, sizeof(parameter));
+  parameter.location = SPDM_DATA_LOCATION_LOCAL;
+  slot_count = 1;
+  status = spdm_set_data (spdm_context, SPDM_DATA_LOCAL_SLOT_COUNT, &parameter, &slot_count, sizeof(slot_count));
+  assert_int_equal (status, RETURN_SUCCESS);
+  set_mem (m_local_certificate_chain, MAX_SPDM_MESSAGE_BUFFER_SIZE, (uint8)(0xFF));
+  status = spdm_set_data (spdm_context, SPDM_DATA_LOCAL_PUBLIC_CERT_CHAIN, &parameter, m_local_certificate_chain, MAX_SPDM_MESSAGE_BUFFER_SIZE);
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  response_size = sizeof(response);
+  spdm_context->transcript.message_b.buffer_size = 0;
+  status = spdm_get_response_digests (spdm_context, m_spdm_get_digests_request1_size, &m_spdm_get_digests_request1, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_digest_response_t) + hash_size);
+  assert_int_equal (spdm_context->response_cache.cert_chain_hash[0].valid, TRUE);
+
+  response_size = sizeof(cached_response);
+  spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_NEGOTIATED;
+  spdm_context->transcript.message_b.buffer_size = 0;
+  status = spdm_get_response_digests (spdm_context, m_spdm_get_digests_request1_size, &m_spdm_get_digests_request1, &response_size, cached_response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_memory_equal (cached_response, response, response_size);
+
+  set_mem (other_certificate_chain, MAX_SPDM_MESSAGE_BUFFER_SIZE, (uint8)(0xEE));
+  status = spdm_set_data (spdm_context, SPDM_DATA_LOCAL_PUBLIC_CERT_CHAIN, &parameter, other_certificate_chain, MAX_SPDM_MESSAGE_BUFFER_SIZE);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (spdm_context->response_cache.cert_chain_hash[0].valid, FALSE);
+
+  response_size = sizeof(cached_response);
+  spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_NEGOTIATED;
+  spdm_context->transcript.message_b.buffer_size = 0;
+  status = spdm_get_response_digests (spdm_context, m_spdm_get_digests_request1_size, &m_spdm_get_digests_request1, &response_size, cached_response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_response = (void *)cached_response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_DIGESTS);
+  assert_memory_not_equal (spdm_response + 1, (spdm_digest_response_t *)response + 1, hash_size);
+
+  spdm_context->local_context.local_cert_chain_provision[0] = NULL;
+  spdm_context->local_context.local_cert_chain_provision_size[0] = 0;
+}
+
 spdm_test_context_t       m_spdm_responder_digests_test_context = {
   SPDM_TEST_CONTEXT_SIGNATURE,
   FALSE,
@@ -366,6 +456,8 @@ int spdm_responder_digests_test_main(void) {
     cmocka_unit_test(test_spdm_responder_digests_case8),
     // No digest to send
     cmocka_unit_test(test_spdm_responder_digests_case9),
+    // Cached certificate chain hash
+    cmocka_unit_test(test_spdm_responder_digests_case10),
   };
 
   setup_spdm_test_context (&m_spdm_responder_digests_test_context);
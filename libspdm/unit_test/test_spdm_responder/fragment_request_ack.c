@@ -0,0 +1,270 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_unit_test.h"
+#include <spdm_responder_lib_internal.h>
+
+#define TEST_FRAGMENT_LENGTH  0x100
+
+static uint8  m_fragment_request[sizeof(spdm_fragment_request_t) + TEST_FRAGMENT_LENGTH];
+
+/**
+  Build a FRAGMENT_REQUEST of TEST_FRAGMENT_LENGTH bytes in m_fragment_request.
+
+  @param  attributes                    The attributes in param1.
+  @param  sequence_id                   The sequence ID of the fragment.
+  @param  offset                        The offset of the fragment in the request.
+
+  @return the size in bytes of the FRAGMENT_REQUEST.
+**/
+uintn
+build_test_fragment_request (
+  IN uint8   attributes,
+  IN uint32  sequence_id,
+  IN uint32  offset
+  )
+{
+  spdm_fragment_request_t  *spdm_request;
+
+  spdm_request = (void *)m_fragment_request;
+  spdm_request->header.spdm_version = SPDM_MESSAGE_VERSION_11;
+  spdm_request->header.request_response_code = SPDM_FRAGMENT_REQUEST;
+  spdm_request->header.param1 = attributes;
+  spdm_request->header.param2 = 0x7f;
+  spdm_request->sequence_id = sequence_id;
+  spdm_request->offset = offset;
+  spdm_request->length = TEST_FRAGMENT_LENGTH;
+  set_mem (spdm_request + 1, TEST_FRAGMENT_LENGTH, (uint8)sequence_id);
+  return sizeof(m_fragment_request);
+}
+
+/**
+  Test 1: The window is enabled on both sides.
+  Expected Behavior: the BEGIN fragment is acknowledged with the accepted window, no response is returned
+  inside the window, and the last fragment of the window is acknowledged.
+**/
+void test_spdm_responder_fragment_request_ack_case1(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                request_size;
+  uintn                response_size;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_fragment_request_ack_t *spdm_response;
+  uint8                window_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x1;
+  window_size = 4;
+  status = spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, NULL, &window_size, sizeof(window_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  request_size = build_test_fragment_request (SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN | (2 << SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_SHIFT), 0, 0);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_fragment_request_ack_t));
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_FRAGMENT_REQUEST_ACK);
+  assert_int_equal (spdm_response->header.param1, 2);
+  assert_int_equal (spdm_response->sequence_id, 0);
+
+  request_size = build_test_fragment_request (0, 1, TEST_FRAGMENT_LENGTH);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_NO_RESPONSE);
+  assert_int_equal (response_size, 0);
+
+  request_size = build_test_fragment_request (0, 2, TEST_FRAGMENT_LENGTH * 2);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_fragment_request_ack_t));
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_FRAGMENT_REQUEST_ACK);
+  assert_int_equal (spdm_response->header.param1, 0);
+  assert_int_equal (spdm_response->sequence_id, 2);
+  assert_int_equal (spdm_context->last_spdm_fragment_encapsulated_request_size, TEST_FRAGMENT_LENGTH * 3);
+
+  spdm_reset_fragment_encapsulated_request (spdm_context);
+}
+
+/**
+  Test 2: A fragment is missing inside the window.
+  Expected Behavior: no response is returned inside the window, the first error is returned at the end of
+  the window, and the fragment state is reset, so that a following fragment is not expected.
+**/
+void test_spdm_responder_fragment_request_ack_case2(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                request_size;
+  uintn                response_size;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_error_response_t *spdm_response;
+  uint8                window_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x2;
+  window_size = 2;
+  status = spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, NULL, &window_size, sizeof(window_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  request_size = build_test_fragment_request (SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN | (2 << SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_SHIFT), 0, 0);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  //
+  // Sequence 1 is lost.
+  //
+  request_size = build_test_fragment_request (0, 2, TEST_FRAGMENT_LENGTH * 2);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_NO_RESPONSE);
+  assert_int_equal (response_size, 0);
+
+  request_size = build_test_fragment_request (0, 3, TEST_FRAGMENT_LENGTH * 3);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_error_response_t));
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_ERROR);
+  assert_int_equal (spdm_response->header.param1, SPDM_ERROR_CODE_INVALID_REQUEST);
+  assert_true (spdm_context->last_spdm_fragment_encapsulated_request == NULL);
+  assert_int_equal (spdm_context->last_spdm_fragment_encapsulated_request_size, 0);
+  assert_int_equal (spdm_context->last_spdm_fragment_encapsulated_request_error_code, 0);
+
+  request_size = build_test_fragment_request (0, 4, TEST_FRAGMENT_LENGTH * 4);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_error_response_t));
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_ERROR);
+  assert_int_equal (spdm_response->header.param1, SPDM_ERROR_CODE_UNEXPECTED_REQUEST);
+}
+
+/**
+  Test 3: A bad fragment is followed by the END fragment inside the window.
+  Expected Behavior: the first error is returned for the END fragment, and the request is not processed.
+**/
+void test_spdm_responder_fragment_request_ack_case3(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                request_size;
+  uintn                response_size;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_error_response_t *spdm_response;
+  uint8                window_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x3;
+  window_size = 4;
+  status = spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, NULL, &window_size, sizeof(window_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  request_size = build_test_fragment_request (SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN | (4 << SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_SHIFT), 0, 0);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  //
+  // The length does not match the size of the fragment.
+  //
+  request_size = build_test_fragment_request (0, 1, TEST_FRAGMENT_LENGTH);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size - 1, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_NO_RESPONSE);
+  assert_int_equal (response_size, 0);
+
+  request_size = build_test_fragment_request (0, 2, TEST_FRAGMENT_LENGTH * 2);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_NO_RESPONSE);
+  assert_int_equal (response_size, 0);
+
+  request_size = build_test_fragment_request (SPDM_FRAGMENT_REQUEST_ATTRIBUTER_END, 3, TEST_FRAGMENT_LENGTH * 3);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_error_response_t));
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_ERROR);
+  assert_int_equal (spdm_response->header.param1, SPDM_ERROR_CODE_INVALID_REQUEST);
+  assert_true (spdm_context->last_spdm_fragment_encapsulated_request == NULL);
+}
+
+/**
+  Test 4: The requester proposes a window, and the window is not enabled in the responder.
+  Expected Behavior: 0 is returned in the ACK of the BEGIN fragment, and every fragment is acknowledged.
+**/
+void test_spdm_responder_fragment_request_ack_case4(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                request_size;
+  uintn                response_size;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_fragment_request_ack_t *spdm_response;
+  uint8                window_size;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x4;
+  window_size = 0;
+  status = spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, NULL, &window_size, sizeof(window_size));
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  request_size = build_test_fragment_request (SPDM_FRAGMENT_REQUEST_ATTRIBUTER_BEGIN | (2 << SPDM_FRAGMENT_REQUEST_ATTRIBUTER_WINDOW_SHIFT), 0, 0);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_FRAGMENT_REQUEST_ACK);
+  assert_int_equal (spdm_response->header.param1, 0);
+
+  request_size = build_test_fragment_request (0, 1, TEST_FRAGMENT_LENGTH);
+  response_size = sizeof(response);
+  status = spdm_get_response_fragment_request (spdm_context, request_size, m_fragment_request, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (response_size, sizeof(spdm_fragment_request_ack_t));
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_FRAGMENT_REQUEST_ACK);
+  assert_int_equal (spdm_response->sequence_id, 1);
+
+  spdm_reset_fragment_encapsulated_request (spdm_context);
+}
+
+spdm_test_context_t       m_spdm_responder_fragment_request_ack_test_context = {
+  SPDM_TEST_CONTEXT_SIGNATURE,
+  FALSE,
+};
+
+int spdm_responder_fragment_request_ack_test_main(void) {
+  const struct CMUnitTest spdm_responder_fragment_request_ack_tests[] = {
+    // Windowed fragments with one ACK per window
+    cmocka_unit_test(test_spdm_responder_fragment_request_ack_case1),
+    // Lost fragment inside the window
+    cmocka_unit_test(test_spdm_responder_fragment_request_ack_case2),
+    // Bad fragment, then END inside the window
+    cmocka_unit_test(test_spdm_responder_fragment_request_ack_case3),
+    // Window not enabled in the responder
+    cmocka_unit_test(test_spdm_responder_fragment_request_ack_case4),
+  };
+
+  setup_spdm_test_context (&m_spdm_responder_fragment_request_ack_test_context);
+
+  return cmocka_run_group_tests(spdm_responder_fragment_request_ack_tests, spdm_unit_test_group_setup, spdm_unit_test_group_teardown);
+}
@@ -1034,6 +1034,76 @@ void test_spdm_responder_measurements_case22(void **state) {
   }
 }
 
+/**
+  Test 23: Successful response to get all measurements without signature, with the measurement cache
+  Expected Behavior: the second response is same as the first one and it is returned from the cache,
+  and the cache is not used after the measurement generation is changed
+**/
+void test_spdm_responder_measurements_case23(void **state) {
+  return_status        status;
+  spdm_test_context_t    *spdm_test_context;
+  spdm_context_t  *spdm_context;
+  uintn                response_size;
+  uint8                response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  uintn                cached_response_size;
+  uint8                cached_response[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+  spdm_measurements_response_t *spdm_response;
+  spdm_data_parameter_t  parameter;
+  boolean              data_bool;
+  uint32               generation;
+
+  spdm_test_context = *state;
+  spdm_context = spdm_test_context->spdm_context;
+  spdm_test_context->case_id = 0x17;
+  spdm_context->connection_info.connection_state = SPDM_CONNECTION_STATE_AUTHENTICATED;
+  spdm_context->local_context.capability.flags |= SPDM_GET_CAPABILITIES_RESPONSE_FLAGS_MEAS_CAP_SIG;
+  spdm_context->connection_info.algorithm.bash_hash_algo = m_use_hash_algo;
+  spdm_context->connection_info.algorithm.base_asym_algo = m_use_asym_algo;
+  spdm_context->connection_info.algorithm.measurement_spec = m_use_measurement_spec;
+  spdm_context->connection_info.algorithm.measurement_hash_algo = m_use_measurement_hash_algo;
+  spdm_context->local_context.opaque_measurement_rsp_size = 0;
+  spdm_context->local_context.opaque_measurement_rsp = NULL;
+
+  zero_mem (&parameter, sizeof(parameter));
+  parameter.location = SPDM_DATA_LOCATION_LOCAL;
+  data_bool = TRUE;
+  status = spdm_set_data (spdm_context, SPDM_DATA_MEASUREMENT_CACHE, &parameter, &data_bool, sizeof(data_bool));
+  assert_int_equal (status, RETURN_SUCCESS);
+
+  spdm_context->transcript.message_m.buffer_size = 0;
+  response_size = sizeof(response);
+  status = spdm_get_response_measurements (spdm_context, m_spdm_get_measurements_request7_size, &m_spdm_get_measurements_request7, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_response = (void *)response;
+  assert_int_equal (spdm_response->header.request_response_code, SPDM_MEASUREMENTS);
+  assert_int_equal (spdm_response->number_of_blocks, MEASUREMENT_BLOCK_NUMBER);
+  assert_int_equal (spdm_context->measurement_cache.entry[0].valid, TRUE);
+  assert_int_equal (spdm_context->measurement_cache.entry[0].device_measurement_count, MEASUREMENT_BLOCK_NUMBER);
+
+  spdm_context->transcript.message_m.buffer_size = 0;
+  cached_response_size = sizeof(cached_response);
+  status = spdm_get_response_measurements (spdm_context, m_spdm_get_measurements_request7_size, &m_spdm_get_measurements_request7, &cached_response_size, cached_response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (cached_response_size, response_size);
+  assert_memory_equal (cached_response, response, response_size);
+  assert_int_equal (spdm_context->measurement_cache.entry[1].valid, FALSE);
+
+  generation = spdm_context->measurement_cache.generation + 1;
+  status = spdm_set_data (spdm_context, SPDM_DATA_MEASUREMENT_GENERATION, &parameter, &generation, sizeof(generation));
+  assert_int_equal (status, RETURN_SUCCESS);
+  spdm_context->transcript.message_m.buffer_size = 0;
+  response_size = sizeof(response);
+  status = spdm_get_response_measurements (spdm_context, m_spdm_get_measurements_request7_size, &m_spdm_get_measurements_request7, &response_size, response);
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (spdm_context->measurement_cache.entry[0].generation, generation);
+
+  data_bool = FALSE;
+  status = spdm_set_data (spdm_context, SPDM_DATA_MEASUREMENT_CACHE, &parameter, &data_bool, sizeof(data_bool));
+  assert_int_equal (status, RETURN_SUCCESS);
+  assert_int_equal (spdm_context->measurement_cache.entry[0].valid, FALSE);
+  spdm_context->transcript.message_m.buffer_size = 0;
+}
+
 spdm_test_context_t       m_spdm_responder_measurements_test_context = {
   SPDM_TEST_CONTEXT_SIGNATURE,
   FALSE,
@@ -1088,6 +1158,8 @@ int spdm_responder_measurements_test_main(void) {
     cmocka_unit_test(test_spdm_responder_measurements_case21),
     // Large number of requests before requiring a signature
     cmocka_unit_test(test_spdm_responder_measurements_case22),
+    // Success Case to get all measurements without signature, with the measurement cache
+    cmocka_unit_test(test_spdm_responder_measurements_case23),
   };
 
   setup_spdm_test_context (&m_spdm_responder_measurements_test_context);
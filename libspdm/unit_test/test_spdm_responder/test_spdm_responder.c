@@ -23,6 +23,7 @@ int spdm_responder_psk_exchange_test_main (void);
 int spdm_responder_psk_finish_test_main (void);
 int spdm_responder_heartbeat_test_main (void);
 int spdm_responder_end_session_test_main (void);
+int spdm_responder_deferred_response_test_main (void);
 
 int main(void) {
   spdm_responder_version_test_main ();
@@ -50,5 +51,9 @@ int main(void) {
   spdm_responder_heartbeat_test_main();
 
   spdm_responder_end_session_test_main();
+
+  spdm_responder_deferred_response_test_main();
+
+  spdm_responder_fragment_request_ack_test_main();
   return 0;
 }
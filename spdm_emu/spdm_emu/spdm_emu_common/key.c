@@ -205,3 +205,5 @@ pqc_algo_t m_use_pqc_kem_algo;
 pqc_algo_t m_use_pqc_req_sig_algo;
 
 spdm_data_public_key_mode_t m_pqc_pub_key_mode = SPDM_DATA_PUBLIC_KEY_MODE_RAW;
+
+uint8   m_worker_thread_count = 0;
@@ -32,6 +32,24 @@ uint32  m_exe_session = (0 |
                        // EXE_SESSION_MEAS |
                        0);
 
+//
+// 0 means the responder serves one connection at a time.
+//
+uint32  m_max_connection_count = 0;
+
+//
+// 0 means every FRAGMENT_REQUEST is acknowledged.
+//
+uint8   m_fragment_window_size = 0;
+
+//
+// The fleet driver attests m_fleet_device_count devices concurrently,
+// m_fleet_round_count times each.
+//
+uint32  m_fleet_device_count = 16;
+uint32  m_fleet_round_count = 10;
+uint32  m_fleet_device_io = FLEET_DEVICE_IO_IN_PROC;
+
 void
 print_usage (
   IN char8* name
@@ -53,6 +71,12 @@ print_usage (
   printf ("   [--pqc_req_sig DILITHIUM_{2,3,5}{_AES*}|FALCON_{512,1024}|SPHINCS_{HARAKA,SHA256,SHAKE256}_{128,192,256}{F,S}_{ROBUST,SIMPLE}\n");
   printf ("   [--pqc_kem BIKE1_{L1,L3}_{CPA,FO}|CLASSIC_MCELIECE_{348864,460896,6688128,6960119,8192128}{F*}|HQC_{128,192,256}|KYBER_{512,768,1024}{_90S*}|SI{DH,KE}_P{434,503,610,751}{_COMPRESSED*}]\n");
   printf ("   [--pqc_pub_key_mode RAW|CERT]\n");
+  printf ("   [--worker_thread <0~4>]\n");
+  printf ("   [--fragment_window <0~%d>]\n", MAX_SPDM_FRAGMENT_WINDOW_SIZE);
+  printf ("   [--max_conn <0~%d>]\n", MAX_SPDM_CONNECTION_COUNT);
+  printf ("   [--fleet_dev <1~%d>]\n", MAX_SPDM_CONNECTION_COUNT);
+  printf ("   [--fleet_round <1~0xFFFF>]\n");
+  printf ("   [--fleet_io IN_PROC|SOCKET]\n");
   printf ("   [--basic_mut_auth NO|BASIC]\n");
   printf ("   [--mut_auth NO|WO_ENCAP|W_ENCAP|DIGESTS]\n");
   printf ("   [--meas_sum NO|TCB|ALL]\n");
@@ -89,6 +113,21 @@ print_usage (
   printf ("           SHA3 is not supported so far.\n");
   printf ("           For pqc CERT mode, only a limited set of hybrid algorithm can be used. Please refer to readme.\n");
   printf ("   [--pqc_pub_key_mode] RAW means separated binary public key. CERT means hybrid X509 certificate. By default, RAW is used.\n");
+  printf ("   [--worker_thread] is the count of worker threads to run the classical and PQC crypto operations in parallel. By default, 0 is used.\n");
+  printf ("           0 means the crypto operations are run one after another.\n");
+  printf ("   [--fragment_window] is the count of fragments sent in FRAGMENT_REQUEST before the ACK. By default, 0 is used.\n");
+  printf ("           0 means every fragment is acknowledged. The requester and the responder use the smaller one of both.\n");
+  printf ("           It is used by spdm_requester_emu and spdm_responder_emu.\n");
+  printf ("   [--max_conn] is the max count of concurrent requester connections of the responder. By default, 0 is used.\n");
+  printf ("           0 means the responder serves one connection at a time with one SPDM context.\n");
+  printf ("           Other value means the responder serves the connections with an event loop, and each connection has its own SPDM context.\n");
+  printf ("           If --worker_thread is not 0, CHALLENGE, signed GET_MEASUREMENTS and KEY_EXCHANGE are processed by the worker threads,\n");
+  printf ("           and the responder returns ResponseNotReady until the response is ready.\n");
+  printf ("   [--fleet_dev] is the count of devices attested concurrently by spdm_fleet_emu. By default, 16 is used.\n");
+  printf ("   [--fleet_round] is the count of attestations of each device by spdm_fleet_emu. By default, 10 is used.\n");
+  printf ("   [--fleet_io] is the device of spdm_fleet_emu. By default, IN_PROC is used.\n");
+  printf ("           IN_PROC means each device is an SPDM responder context in the same process.\n");
+  printf ("           SOCKET means each device is a connection to spdm_responder_emu, which must be started with --max_conn no less than --fleet_dev.\n");
   printf ("   [--basic_mut_auth] is the basic mutual authentication policy. BASIC is used in CHALLENGE_AUTH. By default, NO is used.\n");
   printf ("   [--mut_auth] is the mutual authentication policy. WO_ENCAP, W_ENCAP or DIGESTS is used in KEY_EXCHANGE_RSP. By default, NO is used.\n");
   printf ("   [--meas_sum] is the measurment summary hash type in CHALLENGE_AUTH, KEY_EXCHANGE_RSP and PSK_EXCHANGE_RSP. By default, ALL is used.\n");
@@ -393,11 +432,24 @@ value_string_entry_t  m_slot_count_string_table[] = {
   {0x8, "8"},
 };
 
+value_string_entry_t  m_worker_thread_count_string_table[] = {
+  {0x0, "0"},
+  {0x1, "1"},
+  {0x2, "2"},
+  {0x3, "3"},
+  {0x4, "4"},
+};
+
 value_string_entry_t  m_exe_mode_string_table[] = {
   {EXE_MODE_SHUTDOWN, "SHUTDOWN"},
   {EXE_MODE_CONTINUE, "CONTINUE"},
 };
 
+value_string_entry_t  m_fleet_device_io_string_table[] = {
+  {FLEET_DEVICE_IO_IN_PROC, "IN_PROC"},
+  {FLEET_DEVICE_IO_SOCKET,  "SOCKET"},
+};
+
 value_string_entry_t  m_exe_connection_string_table[] = {
   {EXE_CONNECTION_VERSION_ONLY,    "VER_ONLY"},
   {EXE_CONNECTION_DIGEST,          "DIGEST"},
@@ -532,6 +584,7 @@ process_args (
 {
   uint32  data32;
   char8   *pcap_file_name;
+  char8   *end_ptr;
 
   pcap_file_name = NULL;
 
@@ -865,6 +918,123 @@ process_args (
       }
     }
 
+    if (strcmp (argv[0], "--worker_thread") == 0) {
+      if (argc >= 2) {
+        if (!get_value_from_name (m_worker_thread_count_string_table, ARRAY_SIZE(m_worker_thread_count_string_table), argv[1], &data32)) {
+          printf ("invalid --worker_thread %s\n", argv[1]);
+          print_usage (program_name);
+          exit (0);
+        }
+        m_worker_thread_count = (uint8)data32;
+        printf ("worker_thread - 0x%02x\n", m_worker_thread_count);
+        argc -= 2;
+        argv += 2;
+        continue;
+      } else {
+        printf ("invalid --worker_thread\n");
+        print_usage (program_name);
+        exit (0);
+      }
+    }
+
+    if (strcmp (argv[0], "--fragment_window") == 0) {
+      if (argc >= 2) {
+        data32 = (uint32)strtoul (argv[1], &end_ptr, 0);
+        if ((*argv[1] == '\0') || (*end_ptr != '\0') || (data32 > MAX_SPDM_FRAGMENT_WINDOW_SIZE)) {
+          printf ("invalid --fragment_window %s\n", argv[1]);
+          print_usage (program_name);
+          exit (0);
+        }
+        m_fragment_window_size = (uint8)data32;
+        printf ("fragment_window - 0x%02x\n", m_fragment_window_size);
+        argc -= 2;
+        argv += 2;
+        continue;
+      } else {
+        printf ("invalid --fragment_window\n");
+        print_usage (program_name);
+        exit (0);
+      }
+    }
+
+    if (strcmp (argv[0], "--max_conn") == 0) {
+      if (argc >= 2) {
+        data32 = (uint32)strtoul (argv[1], &end_ptr, 0);
+        if ((*argv[1] == '\0') || (*end_ptr != '\0') || (data32 > MAX_SPDM_CONNECTION_COUNT)) {
+          printf ("invalid --max_conn %s\n", argv[1]);
+          print_usage (program_name);
+          exit (0);
+        }
+        m_max_connection_count = data32;
+        printf ("max_conn - 0x%08x\n", m_max_connection_count);
+        argc -= 2;
+        argv += 2;
+        continue;
+      } else {
+        printf ("invalid --max_conn\n");
+        print_usage (program_name);
+        exit (0);
+      }
+    }
+
+    if (strcmp (argv[0], "--fleet_dev") == 0) {
+      if (argc >= 2) {
+        data32 = (uint32)strtoul (argv[1], &end_ptr, 0);
+        if ((*argv[1] == '\0') || (*end_ptr != '\0') || (data32 == 0) || (data32 > MAX_SPDM_CONNECTION_COUNT)) {
+          printf ("invalid --fleet_dev %s\n", argv[1]);
+          print_usage (program_name);
+          exit (0);
+        }
+        m_fleet_device_count = data32;
+        printf ("fleet_dev - 0x%08x\n", m_fleet_device_count);
+        argc -= 2;
+        argv += 2;
+        continue;
+      } else {
+        printf ("invalid --fleet_dev\n");
+        print_usage (program_name);
+        exit (0);
+      }
+    }
+
+    if (strcmp (argv[0], "--fleet_round") == 0) {
+      if (argc >= 2) {
+        data32 = (uint32)strtoul (argv[1], &end_ptr, 0);
+        if ((*argv[1] == '\0') || (*end_ptr != '\0') || (data32 == 0) || (data32 > 0xFFFF)) {
+          printf ("invalid --fleet_round %s\n", argv[1]);
+          print_usage (program_name);
+          exit (0);
+        }
+        m_fleet_round_count = data32;
+        printf ("fleet_round - 0x%08x\n", m_fleet_round_count);
+        argc -= 2;
+        argv += 2;
+        continue;
+      } else {
+        printf ("invalid --fleet_round\n");
+        print_usage (program_name);
+        exit (0);
+      }
+    }
+
+    if (strcmp (argv[0], "--fleet_io") == 0) {
+      if (argc >= 2) {
+        if (!get_value_from_name (m_fleet_device_io_string_table, ARRAY_SIZE(m_fleet_device_io_string_table), argv[1], &m_fleet_device_io)) {
+          printf ("invalid --fleet_io %s\n", argv[1]);
+          print_usage (program_name);
+          exit (0);
+        }
+        printf ("fleet_io - 0x%08x\n", m_fleet_device_io);
+        argc -= 2;
+        argv += 2;
+        continue;
+      } else {
+        printf ("invalid --fleet_io\n");
+        print_usage (program_name);
+        exit (0);
+      }
+    }
+
     if (strcmp (argv[0], "--basic_mut_auth") == 0) {
       if (argc >= 2) {
         if (!get_value_from_name (m_basic_mut_auth_policy_string_table, ARRAY_SIZE(m_basic_mut_auth_policy_string_table), argv[1], &data32)) {
@@ -70,6 +70,19 @@ extern pqc_algo_t m_support_pqc_kem_algo;
 
 extern spdm_data_public_key_mode_t m_pqc_pub_key_mode;
 
+extern uint8   m_worker_thread_count;
+
+extern uint8   m_fragment_window_size;
+
+#define MAX_SPDM_CONNECTION_COUNT       1024
+extern uint32  m_max_connection_count;
+
+#define FLEET_DEVICE_IO_IN_PROC  0
+#define FLEET_DEVICE_IO_SOCKET   1
+extern uint32  m_fleet_device_count;
+extern uint32  m_fleet_round_count;
+extern uint32  m_fleet_device_io;
+
 extern uint8   m_end_session_attributes;
 
 extern char8 *m_load_state_file_name;
@@ -171,4 +184,27 @@ process_args (
 void
 perf_dump ();
 
+uint64
+readtsc ();
+
+void
+calibration ();
+
+extern uint64 m_freq_mh;
+
+int
+get_security_level (
+  uint16 dhe_algo,
+  pqc_algo_t pqc_kem_algo,
+  uint32 asym_algo,
+  pqc_algo_t pqc_sig_algo);
+
+char *dhe_algo_to_string (uint32 algo);
+
+char *asym_algo_to_string (uint32 algo);
+
+char *pqc_kem_algo_to_string (pqc_algo_t pqc_algo);
+
+char *pqc_sig_algo_to_string (pqc_algo_t pqc_algo);
+
 #endif
@@ -0,0 +1,926 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_fleet_emu.h"
+#include <library/threadlib.h>
+
+#ifdef _MSC_VER
+struct  in_addr m_ip_address = {{{127, 0, 0, 1}}};
+#else
+struct  in_addr m_ip_address = {0x0100007F};
+#endif
+
+extern void *m_server_spdm_context;
+
+void *
+spdm_server_init (
+  void
+  );
+
+boolean
+platform_server (
+  void
+  );
+
+fleet_device_t   *m_fleet_device;
+struct pollfd    *m_fleet_poll_fd;
+fleet_device_t   **m_fleet_poll_device;
+
+//
+// The latency in TSC of each successful attestation.
+//
+uint64           *m_fleet_latency;
+uint32           m_fleet_latency_count;
+uint32           m_fleet_failure_count;
+
+//
+// The CPU time in microseconds of the in-process responders.
+// It is not counted as the CPU time of the requesters.
+//
+uint64           m_fleet_responder_cpu_usec;
+
+/**
+  This function returns the CPU time of the calling thread.
+
+  The requesters and the in-process responders run on the thread of spdm_fleet_emu.
+  The CPU time of the other threads of the process, such as the worker threads, is not included.
+
+  @return the CPU time in microseconds.
+**/
+uint64
+spdm_fleet_get_thread_cpu_usec (
+  void
+  )
+{
+#ifdef _MSC_VER
+  FILETIME  creation_time;
+  FILETIME  exit_time;
+  FILETIME  kernel_time;
+  FILETIME  user_time;
+
+  if (!GetThreadTimes (GetCurrentThread (), &creation_time, &exit_time, &kernel_time, &user_time)) {
+    return 0;
+  }
+  //
+  // FILETIME is in 100 nanoseconds.
+  //
+  return ((((uint64)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime) +
+          (((uint64)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime)) / 10;
+#else
+  struct timespec  time_spec;
+
+  if (clock_gettime (CLOCK_THREAD_CPUTIME_ID, &time_spec) != 0) {
+    return 0;
+  }
+  return (uint64)time_spec.tv_sec * 1000000 + (uint64)time_spec.tv_nsec / 1000;
+#endif
+}
+
+/**
+  This function connects to spdm_responder_emu.
+
+  @param  sock                          The connected socket.
+
+  @retval TRUE  The socket is connected.
+  @retval FALSE The socket cannot be connected.
+**/
+boolean
+spdm_fleet_connect (
+  OUT SOCKET  *sock
+  )
+{
+  SOCKET             client_socket;
+  struct sockaddr_in server_addr;
+  int32              ret_val;
+
+  client_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (client_socket == INVALID_SOCKET) {
+    printf ("Create socket Failed - %x\n",
+#ifdef _MSC_VER
+      WSAGetLastError()
+#else
+      errno
+#endif
+      );
+    return FALSE;
+  }
+
+  server_addr.sin_family = AF_INET;
+  copy_mem (&server_addr.sin_addr.s_addr, &m_ip_address, sizeof(struct in_addr));
+  server_addr.sin_port = htons(DEFAULT_SPDM_PLATFORM_PORT);
+  zero_mem (server_addr.sin_zero, sizeof(server_addr.sin_zero));
+
+  ret_val = connect (client_socket, (struct sockaddr *)&server_addr, sizeof(server_addr));
+  if (ret_val == SOCKET_ERROR) {
+    printf ("Connect Error - %x\n",
+#ifdef _MSC_VER
+      WSAGetLastError()
+#else
+      errno
+#endif
+      );
+    closesocket(client_socket);
+    return FALSE;
+  }
+
+  *sock = client_socket;
+  return TRUE;
+}
+
+/**
+  This function checks whether a step is selected by --exe_conn and --exe_session.
+
+  @param  step                          The step of the attestation.
+
+  @retval TRUE  The step is selected.
+  @retval FALSE The step is skipped.
+**/
+boolean
+spdm_fleet_step_is_selected (
+  IN uint32  step
+  )
+{
+  switch (step) {
+  case FLEET_STEP_DIGEST:
+    return (boolean)((m_exe_connection & EXE_CONNECTION_DIGEST) != 0);
+  case FLEET_STEP_CERT:
+    return (boolean)(((m_exe_connection & EXE_CONNECTION_CERT) != 0) && (m_use_slot_id != 0xFF));
+  case FLEET_STEP_CHAL:
+    return (boolean)((m_exe_connection & EXE_CONNECTION_CHAL) != 0);
+  case FLEET_STEP_MEAS:
+    return (boolean)((m_exe_connection & EXE_CONNECTION_MEAS) != 0);
+  case FLEET_STEP_KEY_EX:
+  case FLEET_STEP_KEY_EX_END:
+    return (boolean)((m_use_version >= SPDM_MESSAGE_VERSION_11) && ((m_exe_session & EXE_SESSION_KEY_EX) != 0));
+  case FLEET_STEP_PSK:
+  case FLEET_STEP_PSK_END:
+    return (boolean)((m_use_version >= SPDM_MESSAGE_VERSION_11) && ((m_exe_session & EXE_SESSION_PSK) != 0));
+  default:
+    return TRUE;
+  }
+}
+
+/**
+  This function moves the device to the next round of attestation.
+
+  @param  device                        The device.
+**/
+void
+spdm_fleet_device_next_round (
+  IN OUT fleet_device_t  *device
+  )
+{
+  device->step = FLEET_STEP_VCA;
+  device->round++;
+  if (device->round >= m_fleet_round_count) {
+    device->finished = TRUE;
+  }
+}
+
+/**
+  This function starts the flow of the current step of the device with the asynchronous API.
+
+  @param  device                        The device.
+
+  @return the status of spdm_async_xxx.
+**/
+return_status
+spdm_fleet_device_start_step (
+  IN OUT fleet_device_t  *device
+  )
+{
+  void  *spdm_context;
+
+  spdm_context = device->spdm_context;
+  switch (device->step) {
+  case FLEET_STEP_VCA:
+    device->start_tsc = readtsc ();
+    return spdm_async_init_connection (spdm_context, (m_exe_connection & EXE_CONNECTION_VERSION_ONLY) != 0);
+  case FLEET_STEP_DIGEST:
+    return spdm_async_get_digest (spdm_context, &device->slot_mask, device->total_digest_buffer);
+  case FLEET_STEP_CERT:
+    device->cert_chain_size = sizeof(device->cert_chain);
+    return spdm_async_get_certificate (spdm_context, m_use_slot_id, &device->cert_chain_size, device->cert_chain);
+  case FLEET_STEP_CHAL:
+    return spdm_async_challenge (spdm_context, m_use_slot_id, m_use_measurement_summary_hash_type, device->measurement_hash);
+  case FLEET_STEP_MEAS:
+    device->measurement_record_length = sizeof(device->measurement_record);
+    return spdm_async_get_measurement (
+             spdm_context,
+             NULL,
+             SPDM_GET_MEASUREMENTS_REQUEST_ATTRIBUTES_GENERATE_SIGNATURE,
+             SPDM_GET_MEASUREMENTS_REQUEST_MEASUREMENT_OPERATION_ALL_MEASUREMENTS,
+             m_use_slot_id & 0xF,
+             &device->number_of_blocks,
+             &device->measurement_record_length,
+             device->measurement_record
+             );
+  case FLEET_STEP_KEY_EX:
+  case FLEET_STEP_PSK:
+    device->heartbeat_period = 0;
+    return spdm_async_start_session (
+             spdm_context,
+             (boolean)(device->step == FLEET_STEP_PSK),
+             m_use_measurement_summary_hash_type,
+             m_use_slot_id,
+             &device->session_id,
+             &device->heartbeat_period,
+             device->measurement_hash
+             );
+  case FLEET_STEP_KEY_EX_END:
+  case FLEET_STEP_PSK_END:
+    //
+    // The session is always ended, even with --exe_session NO_END,
+    // so that the session table is not exhausted by the rounds.
+    //
+    return spdm_async_stop_session (spdm_context, device->session_id, m_end_session_attributes);
+  default:
+    return RETURN_UNSUPPORTED;
+  }
+}
+
+/**
+  This function handles the result of the current step of the device.
+
+  A failed attestation is counted, and the device starts the next round from VCA.
+
+  @param  device                        The device.
+  @param  status                        The result of the flow of the step.
+**/
+void
+spdm_fleet_device_finish_step (
+  IN OUT fleet_device_t  *device,
+  IN     return_status   status
+  )
+{
+  if (RETURN_ERROR(status)) {
+    printf ("device %d step %d - %x\n", device->index, device->step, (uint32)status);
+    m_fleet_failure_count++;
+    spdm_fleet_device_next_round (device);
+    return ;
+  }
+
+  if ((device->step == FLEET_STEP_VCA) && !device->provisioned) {
+    spdm_fleet_client_provision (device->spdm_context);
+    device->provisioned = TRUE;
+  }
+
+  do {
+    device->step++;
+  } while (!spdm_fleet_step_is_selected (device->step));
+
+  if (device->step == FLEET_STEP_DONE) {
+    m_fleet_latency[m_fleet_latency_count] = readtsc () - device->start_tsc;
+    m_fleet_latency_count++;
+    spdm_fleet_device_next_round (device);
+  }
+}
+
+/**
+  This function is called after the flow of the device is run by the asynchronous API.
+
+  The requester perf counter runs while the flow runs, and it is stopped by the
+  requester library before the flow sends or receives a message.
+  It is stopped here if the flow is suspended in SPDM_ASYNC_STATE_WAIT, or is done.
+
+  @param  device                        The device.
+**/
+void
+spdm_fleet_device_suspended (
+  IN OUT fleet_device_t  *device
+  )
+{
+  spdm_async_state_t  state;
+
+  state = spdm_async_get_state (device->spdm_context);
+  if ((state == SPDM_ASYNC_STATE_WAIT) || (state == SPDM_ASYNC_STATE_DONE)) {
+    perf_stop (PERF_ID_REQUESTER);
+  }
+}
+
+/**
+  This function cancels the flow of the device after a device IO error.
+
+  @param  device                        The device.
+**/
+void
+spdm_fleet_device_cancel (
+  IN OUT fleet_device_t  *device
+  )
+{
+  if (spdm_async_get_state (device->spdm_context) == SPDM_ASYNC_STATE_WAIT) {
+    perf_start (PERF_ID_REQUESTER);
+  }
+  spdm_async_cancel (device->spdm_context);
+  spdm_fleet_device_suspended (device);
+}
+
+/**
+  This function receives the response from the device and feeds it to the flow.
+
+  @param  device                        The device.
+
+  @retval TRUE  The response is fed to the flow.
+  @retval FALSE The response cannot be received.
+**/
+boolean
+spdm_fleet_device_receive (
+  IN OUT fleet_device_t  *device
+  )
+{
+  SOCKET         socket;
+  boolean        result;
+  uint32         command;
+  return_status  status;
+
+  if (m_fleet_device_io == FLEET_DEVICE_IO_IN_PROC) {
+    socket = 0;
+  } else {
+    socket = device->socket;
+  }
+  device->message_size = sizeof(device->message);
+  result = receive_platform_data (socket, &command, device->message, &device->message_size);
+  if (!result || (command != SOCKET_SPDM_COMMAND_NORMAL)) {
+    printf ("device %d receive_platform_data Error\n", device->index);
+    return FALSE;
+  }
+
+  status = spdm_async_feed_response_message (device->spdm_context, device->message_size, device->message);
+  if (RETURN_ERROR(status)) {
+    return FALSE;
+  }
+  spdm_fleet_device_suspended (device);
+  return TRUE;
+}
+
+/**
+  This function sends the request of the flow to the device.
+
+  The responder of an in-process device handles the request at once,
+  so its response is fed to the flow at once.
+
+  @param  device                        The device.
+
+  @retval TRUE  The request is sent.
+  @retval FALSE The request cannot be sent.
+**/
+boolean
+spdm_fleet_device_send (
+  IN OUT fleet_device_t  *device
+  )
+{
+  boolean        result;
+  return_status  status;
+  uint64         cpu_start;
+
+  device->message_size = sizeof(device->message);
+  status = spdm_async_get_request_message (device->spdm_context, &device->message_size, device->message);
+  if (RETURN_ERROR(status)) {
+    return FALSE;
+  }
+  spdm_fleet_device_suspended (device);
+
+  if (m_fleet_device_io == FLEET_DEVICE_IO_IN_PROC) {
+    result = send_platform_data (0, SOCKET_SPDM_COMMAND_NORMAL, device->message, device->message_size);
+    if (!result) {
+      return FALSE;
+    }
+    m_server_spdm_context = device->responder_context;
+    cpu_start = spdm_fleet_get_thread_cpu_usec ();
+    platform_server ();
+    m_fleet_responder_cpu_usec += spdm_fleet_get_thread_cpu_usec () - cpu_start;
+    if (spdm_async_get_state (device->spdm_context) != SPDM_ASYNC_STATE_RECEIVE) {
+      return FALSE;
+    }
+    return spdm_fleet_device_receive (device);
+  }
+
+  result = send_platform_data (device->socket, SOCKET_SPDM_COMMAND_NORMAL, device->message, device->message_size);
+  if (!result) {
+    printf ("device %d send_platform_data Error - %x\n", device->index,
+#ifdef _MSC_VER
+      WSAGetLastError()
+#else
+      errno
+#endif
+      );
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+  This function runs the device until it waits for the response, or for the retry time.
+
+  @param  device                        The device.
+  @param  now                           The current TSC.
+  @param  wake_tsc                      The earliest TSC to poll the waiting devices.
+
+  @retval TRUE  The device makes progress.
+  @retval FALSE The device waits.
+**/
+boolean
+spdm_fleet_device_run (
+  IN OUT fleet_device_t  *device,
+  IN     uint64          now,
+  IN OUT uint64          *wake_tsc
+  )
+{
+  return_status  status;
+
+  switch (spdm_async_get_state (device->spdm_context)) {
+  case SPDM_ASYNC_STATE_IDLE:
+    if (device->finished) {
+      return FALSE;
+    }
+    perf_start (PERF_ID_REQUESTER);
+    status = spdm_fleet_device_start_step (device);
+    if (RETURN_ERROR(status)) {
+      perf_stop (PERF_ID_REQUESTER);
+      spdm_fleet_device_finish_step (device, status);
+      return TRUE;
+    }
+    spdm_fleet_device_suspended (device);
+    return TRUE;
+
+  case SPDM_ASYNC_STATE_SEND:
+    if (!spdm_fleet_device_send (device)) {
+      spdm_fleet_device_cancel (device);
+    }
+    return TRUE;
+
+  case SPDM_ASYNC_STATE_WAIT:
+    if (device->wake_tsc == 0) {
+      device->wake_tsc = now + spdm_async_get_wait_time (device->spdm_context) * m_freq_mh;
+    }
+    if (now < device->wake_tsc) {
+      if (device->wake_tsc < *wake_tsc) {
+        *wake_tsc = device->wake_tsc;
+      }
+      return FALSE;
+    }
+    device->wake_tsc = 0;
+    perf_start (PERF_ID_REQUESTER);
+    status = spdm_async_poll (device->spdm_context);
+    if (status != RETURN_NOT_READY) {
+      perf_stop (PERF_ID_REQUESTER);
+      spdm_fleet_device_finish_step (device, status);
+      return TRUE;
+    }
+    spdm_fleet_device_suspended (device);
+    return TRUE;
+
+  case SPDM_ASYNC_STATE_DONE:
+    status = spdm_async_poll (device->spdm_context);
+    spdm_fleet_device_finish_step (device, status);
+    return TRUE;
+
+  case SPDM_ASYNC_STATE_RECEIVE:
+  default:
+    //
+    // The response is received by spdm_fleet_poll_socket.
+    //
+    return FALSE;
+  }
+}
+
+/**
+  This function waits for the responses of the devices connected with socket,
+  and feeds them to the flows.
+
+  @param  timeout                       The timeout in milliseconds. -1 means infinite.
+**/
+void
+spdm_fleet_poll_socket (
+  IN int32  timeout
+  )
+{
+  fleet_device_t  *device;
+  uint32          index;
+  uint32          count;
+  int32           ret_val;
+
+  count = 0;
+  for (index = 0; index < m_fleet_device_count; index++) {
+    device = &m_fleet_device[index];
+    if (spdm_async_get_state (device->spdm_context) != SPDM_ASYNC_STATE_RECEIVE) {
+      continue;
+    }
+    m_fleet_poll_fd[count].fd = device->socket;
+    m_fleet_poll_fd[count].events = POLLIN;
+    m_fleet_poll_fd[count].revents = 0;
+    m_fleet_poll_device[count] = device;
+    count++;
+  }
+  if (count == 0) {
+    if (timeout > 0) {
+      thread_sleep ((uint64)timeout * 1000);
+    }
+    return ;
+  }
+
+  ret_val = poll (m_fleet_poll_fd, count, timeout);
+  if (ret_val <= 0) {
+    return ;
+  }
+  for (index = 0; index < count; index++) {
+    if ((m_fleet_poll_fd[index].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+      continue;
+    }
+    if (!spdm_fleet_device_receive (m_fleet_poll_device[index])) {
+      spdm_fleet_device_cancel (m_fleet_poll_device[index]);
+    }
+  }
+}
+
+/**
+  This function creates the requester and the responder of a device.
+
+  @param  device                        The device.
+  @param  index                         The index of the device.
+
+  @retval TRUE  The device is created.
+  @retval FALSE The device cannot be created.
+**/
+boolean
+spdm_fleet_device_init (
+  OUT fleet_device_t  *device,
+  IN  uint32          index
+  )
+{
+  device->index = index;
+  device->step = FLEET_STEP_VCA;
+  device->spdm_context = spdm_fleet_client_init ();
+  if (device->spdm_context == NULL) {
+    return FALSE;
+  }
+
+  if (m_fleet_device_io == FLEET_DEVICE_IO_IN_PROC) {
+    device->responder_context = spdm_server_init ();
+    if (device->responder_context == NULL) {
+      return FALSE;
+    }
+  } else {
+    if (!spdm_fleet_connect (&device->socket)) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+  This function frees the requester and the responder of a device.
+  The connection to spdm_responder_emu is shut down.
+
+  @param  device                        The device.
+  @param  exe_mode                      EXE_MODE_SHUTDOWN to stop spdm_responder_emu,
+                                        EXE_MODE_CONTINUE to keep it running.
+**/
+void
+spdm_fleet_device_deinit (
+  IN OUT fleet_device_t  *device,
+  IN     uint32          exe_mode
+  )
+{
+  uint32  response;
+  uintn   response_size;
+
+  if (device->socket != INVALID_SOCKET) {
+    if (send_platform_data (device->socket, SOCKET_SPDM_COMMAND_SHUTDOWN - exe_mode, NULL, 0)) {
+      response_size = 0;
+      receive_platform_data (device->socket, &response, NULL, &response_size);
+    }
+    closesocket (device->socket);
+    device->socket = INVALID_SOCKET;
+  }
+  if (device->responder_context != NULL) {
+    spdm_deinit_context (device->responder_context);
+    free (device->responder_context);
+    device->responder_context = NULL;
+  }
+  if (device->spdm_context != NULL) {
+    spdm_deinit_context (device->spdm_context);
+    free (device->spdm_context);
+    device->spdm_context = NULL;
+  }
+}
+
+int
+spdm_fleet_compare_latency (
+  IN const void  *left,
+  IN const void  *right
+  )
+{
+  uint64  left_latency;
+  uint64  right_latency;
+
+  left_latency = *(const uint64 *)left;
+  right_latency = *(const uint64 *)right;
+  if (left_latency < right_latency) {
+    return -1;
+  }
+  if (left_latency > right_latency) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+  This function prints the result in the same table format as perf_dump.
+
+  The CPU time of the requesters does not include the in-process responders.
+  The CPU time of the responders is 0 for FLEET_DEVICE_IO_SOCKET.
+
+  @param  wall_tsc                      The wall time in TSC to attest all devices.
+  @param  cpu_usec                      The CPU time in microseconds of the thread to attest all devices.
+**/
+void
+spdm_fleet_dump (
+  IN uint64   wall_tsc,
+  IN uint64   cpu_usec
+  )
+{
+  uint64  wall_usec;
+  uint64  throughput;
+  uint64  p50;
+  uint64  p99;
+  uint64  requester_cpu_usec;
+  uint64  responder_cpu_usec;
+
+  wall_usec = wall_tsc / m_freq_mh;
+  throughput = 0;
+  p50 = 0;
+  p99 = 0;
+  requester_cpu_usec = 0;
+  responder_cpu_usec = 0;
+  if (m_fleet_latency_count != 0) {
+    qsort (m_fleet_latency, m_fleet_latency_count, sizeof(uint64), spdm_fleet_compare_latency);
+    if (wall_usec != 0) {
+      throughput = (uint64)m_fleet_latency_count * 1000000 / wall_usec;
+    }
+    p50 = m_fleet_latency[m_fleet_latency_count / 2] / m_freq_mh;
+    p99 = m_fleet_latency[(m_fleet_latency_count * 99 - 1) / 100] / m_freq_mh;
+    if (cpu_usec > m_fleet_responder_cpu_usec) {
+      requester_cpu_usec = (cpu_usec - m_fleet_responder_cpu_usec) / m_fleet_latency_count;
+    }
+    responder_cpu_usec = m_fleet_responder_cpu_usec / m_fleet_latency_count;
+  }
+
+  // | Security Level | Configuration (KEM + SIG)
+  printf ("| %d ", get_security_level (m_use_dhe_algo, m_use_pqc_kem_algo, m_use_asym_algo, m_use_pqc_sig_algo));
+  printf ("| %s", dhe_algo_to_string (m_use_dhe_algo));
+  if (!spdm_pqc_algo_is_zero (m_use_pqc_kem_algo)) {
+    printf ("_%s", pqc_kem_algo_to_string (m_use_pqc_kem_algo));
+  }
+  printf (" + %s", asym_algo_to_string (m_use_asym_algo));
+  if (!spdm_pqc_algo_is_zero (m_use_pqc_sig_algo)) {
+    printf ("_%s", pqc_sig_algo_to_string (m_use_pqc_sig_algo));
+  }
+
+  // | Devices | Attestations | Failures | Attestations/sec | p50 latency | p99 latency | Requester CPU/attestation | Responder CPU/attestation |
+#ifdef _MSC_VER
+  printf (" | %d | %d | %d | %I64d | %I64d | %I64d | %I64d | %I64d |\n",
+#else
+  printf (" | %d | %d | %d | %lld | %lld | %lld | %lld | %lld |\n",
+#endif
+    m_fleet_device_count,
+    m_fleet_latency_count,
+    m_fleet_failure_count,
+    throughput,
+    p50,
+    p99,
+    requester_cpu_usec,
+    responder_cpu_usec
+    );
+}
+
+/**
+  This function attests all devices with the configured algorithms, and prints the result.
+
+  @param  exe_mode                      EXE_MODE_SHUTDOWN to stop spdm_responder_emu at the end,
+                                        EXE_MODE_CONTINUE to keep it running.
+
+  @retval TRUE  The devices are attested.
+  @retval FALSE The devices cannot be created.
+**/
+boolean
+platform_fleet_routine (
+  IN uint32  exe_mode
+  )
+{
+  fleet_device_t  *device;
+  uint32          index;
+  uint32          active_count;
+  boolean         progress;
+  uint64          now;
+  uint64          wake_tsc;
+  uint64          wall_start;
+  uint64          cpu_start;
+  int32           timeout;
+  boolean         result;
+
+#ifdef _MSC_VER
+  WSADATA ws;
+  if (WSAStartup(MAKEWORD(2,2), &ws) != 0) {
+    printf ("Init Windows socket Failed - %x\n", WSAGetLastError());
+    return FALSE;
+  }
+#endif
+
+  result = FALSE;
+  m_fleet_latency_count = 0;
+  m_fleet_failure_count = 0;
+  m_fleet_responder_cpu_usec = 0;
+  m_fleet_device = calloc (m_fleet_device_count, sizeof(fleet_device_t));
+  m_fleet_poll_fd = calloc (m_fleet_device_count, sizeof(struct pollfd));
+  m_fleet_poll_device = calloc (m_fleet_device_count, sizeof(fleet_device_t *));
+  m_fleet_latency = calloc ((uintn)m_fleet_device_count * m_fleet_round_count, sizeof(uint64));
+  if ((m_fleet_device == NULL) || (m_fleet_poll_fd == NULL) || (m_fleet_poll_device == NULL) || (m_fleet_latency == NULL)) {
+    goto done;
+  }
+  for (index = 0; index < m_fleet_device_count; index++) {
+    m_fleet_device[index].socket = INVALID_SOCKET;
+  }
+  for (index = 0; index < m_fleet_device_count; index++) {
+    if (!spdm_fleet_device_init (&m_fleet_device[index], index)) {
+      printf ("spdm_fleet_device_init - device %d fail\n", index);
+      goto done;
+    }
+  }
+
+  calibration ();
+
+  cpu_start = spdm_fleet_get_thread_cpu_usec ();
+  wall_start = readtsc ();
+  while (TRUE) {
+    now = readtsc ();
+    wake_tsc = MAX_UINT64;
+    progress = FALSE;
+    active_count = 0;
+    for (index = 0; index < m_fleet_device_count; index++) {
+      device = &m_fleet_device[index];
+      if (device->finished && (spdm_async_get_state (device->spdm_context) == SPDM_ASYNC_STATE_IDLE)) {
+        continue;
+      }
+      active_count++;
+      if (spdm_fleet_device_run (device, now, &wake_tsc)) {
+        progress = TRUE;
+      }
+    }
+    if (active_count == 0) {
+      break;
+    }
+
+    //
+    // Block only if no device makes progress, until a response arrives or a waiting device is due.
+    //
+    timeout = 0;
+    if (!progress) {
+      now = readtsc ();
+      if (wake_tsc == MAX_UINT64) {
+        timeout = -1;
+      } else if (wake_tsc > now) {
+        timeout = (int32)((wake_tsc - now) / m_freq_mh / 1000) + 1;
+      }
+    }
+    if (m_fleet_device_io == FLEET_DEVICE_IO_SOCKET) {
+      spdm_fleet_poll_socket (timeout);
+    } else if (timeout > 0) {
+      thread_sleep ((uint64)timeout * 1000);
+    }
+  }
+
+  spdm_fleet_dump (readtsc () - wall_start, spdm_fleet_get_thread_cpu_usec () - cpu_start);
+  result = TRUE;
+
+done:
+  if (m_fleet_device != NULL) {
+    for (index = 0; index < m_fleet_device_count; index++) {
+      spdm_fleet_device_deinit (&m_fleet_device[index], exe_mode);
+    }
+    free (m_fleet_device);
+    m_fleet_device = NULL;
+  }
+  if (m_fleet_poll_fd != NULL) {
+    free (m_fleet_poll_fd);
+    m_fleet_poll_fd = NULL;
+  }
+  if (m_fleet_poll_device != NULL) {
+    free (m_fleet_poll_device);
+    m_fleet_poll_device = NULL;
+  }
+  if (m_fleet_latency != NULL) {
+    free (m_fleet_latency);
+    m_fleet_latency = NULL;
+  }
+  spdm_fleet_free_provision_data ();
+  return result;
+}
+
+/**
+  This function gets the next PQC algorithm in a set of PQC algorithms.
+
+  An empty set has one algorithm, which is no PQC algorithm.
+
+  @param  pqc_algo_set                  The set of PQC algorithms.
+  @param  bit_index                     On input, the bit to start the search from.
+                                        On output, the bit after the algorithm.
+  @param  pqc_algo                      The algorithm.
+
+  @retval TRUE  The algorithm is got.
+  @retval FALSE There is no more algorithm in the set.
+**/
+boolean
+spdm_fleet_get_next_pqc_algo (
+  IN     pqc_algo_t  pqc_algo_set,
+  IN OUT uint32      *bit_index,
+     OUT pqc_algo_t  pqc_algo
+  )
+{
+  zero_mem (pqc_algo, sizeof(pqc_algo_t));
+  if (spdm_pqc_algo_is_zero (pqc_algo_set)) {
+    if (*bit_index != 0) {
+      return FALSE;
+    }
+    *bit_index = sizeof(pqc_algo_t) * 8;
+    return TRUE;
+  }
+  for (; *bit_index < sizeof(pqc_algo_t) * 8; (*bit_index)++) {
+    if ((pqc_algo_set[*bit_index / 8] & (1 << (*bit_index % 8))) != 0) {
+      pqc_algo[*bit_index / 8] = (uint8)(1 << (*bit_index % 8));
+      (*bit_index)++;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+  This function attests the devices once for each combination of the PQC KEM algorithm
+  and the PQC signature algorithm configured by --pqc_kem and --pqc_sig.
+  It prints one line for each combination.
+
+  Only one PQC KEM algorithm and one PQC signature algorithm are supported by the requester
+  for a combination, so that the combination is negotiated.
+  The in-process responders support the same algorithms.
+**/
+void
+platform_fleet_algo_routine (
+  void
+  )
+{
+  pqc_algo_t  pqc_kem_algo_set;
+  pqc_algo_t  pqc_sig_algo_set;
+  pqc_algo_t  next_pqc_algo;
+  uint32      kem_index;
+  uint32      sig_index;
+  uint32      next_index;
+  uint32      exe_mode;
+
+  copy_mem (pqc_kem_algo_set, m_support_pqc_kem_algo, sizeof(pqc_algo_t));
+  copy_mem (pqc_sig_algo_set, m_support_pqc_sig_algo, sizeof(pqc_algo_t));
+
+  kem_index = 0;
+  while (spdm_fleet_get_next_pqc_algo (pqc_kem_algo_set, &kem_index, m_support_pqc_kem_algo)) {
+    sig_index = 0;
+    while (spdm_fleet_get_next_pqc_algo (pqc_sig_algo_set, &sig_index, m_support_pqc_sig_algo)) {
+      //
+      // spdm_responder_emu is kept running until the last combination is done.
+      //
+      exe_mode = EXE_MODE_CONTINUE;
+      next_index = sig_index;
+      if (!spdm_fleet_get_next_pqc_algo (pqc_sig_algo_set, &next_index, next_pqc_algo)) {
+        next_index = kem_index;
+        if (!spdm_fleet_get_next_pqc_algo (pqc_kem_algo_set, &next_index, next_pqc_algo)) {
+          exe_mode = m_exe_mode;
+        }
+      }
+      if (!platform_fleet_routine (exe_mode)) {
+        printf ("platform_fleet_routine - fail\n");
+      }
+    }
+  }
+
+  copy_mem (m_support_pqc_kem_algo, pqc_kem_algo_set, sizeof(pqc_algo_t));
+  copy_mem (m_support_pqc_sig_algo, pqc_sig_algo_set, sizeof(pqc_algo_t));
+}
+
+int main (
+  int argc,
+  char *argv[ ]
+  )
+{
+  srand((unsigned int)time(NULL));
+
+  process_args ("spdm_fleet_emu", argc, argv);
+
+  platform_fleet_algo_routine ();
+
+  return 0;
+}
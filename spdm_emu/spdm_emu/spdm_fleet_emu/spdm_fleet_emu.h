@@ -0,0 +1,109 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __SPDM_FLEET_EMU_H__
+#define __SPDM_FLEET_EMU_H__
+
+#include <base.h>
+#include <library/memlib.h>
+#include <library/spdm_requester_lib.h>
+#include <library/spdm_responder_lib.h>
+#include <library/spdm_transport_mctp_lib.h>
+#include <library/spdm_transport_pcidoe_lib.h>
+
+#include "os_include.h"
+#include "stdio.h"
+#include "spdm_emu.h"
+
+#ifdef _MSC_VER
+#define poll WSAPoll
+#else
+#include <poll.h>
+#include <time.h>
+#endif
+
+//
+// The steps of one attestation of a device.
+// The steps that are not selected by --exe_conn and --exe_session are skipped.
+//
+#define FLEET_STEP_VCA          0
+#define FLEET_STEP_DIGEST       1
+#define FLEET_STEP_CERT         2
+#define FLEET_STEP_CHAL         3
+#define FLEET_STEP_MEAS         4
+#define FLEET_STEP_KEY_EX       5
+#define FLEET_STEP_KEY_EX_END   6
+#define FLEET_STEP_PSK          7
+#define FLEET_STEP_PSK_END      8
+#define FLEET_STEP_DONE         9
+
+typedef struct {
+  uint32   index;
+  void     *spdm_context;
+  //
+  // FLEET_DEVICE_IO_IN_PROC: the SPDM context of the responder.
+  // FLEET_DEVICE_IO_SOCKET: the connection to spdm_responder_emu.
+  //
+  void     *responder_context;
+  SOCKET   socket;
+
+  boolean  provisioned;
+  boolean  finished;
+  uint32   step;
+  uint32   round;
+  uint64   start_tsc;
+  uint64   wake_tsc;
+
+  uint32   session_id;
+  uint8    heartbeat_period;
+  uint8    slot_mask;
+  uint8    number_of_blocks;
+  uint8    total_digest_buffer[MAX_HASH_SIZE * MAX_SPDM_SLOT_COUNT];
+  uint8    measurement_hash[MAX_HASH_SIZE];
+  uintn    cert_chain_size;
+  uint8    cert_chain[MAX_SPDM_CERT_CHAIN_SIZE];
+  uint32   measurement_record_length;
+  uint8    measurement_record[MAX_SPDM_MEASUREMENT_RECORD_SIZE];
+
+  uintn    message_size;
+  uint8    message[MAX_SPDM_MESSAGE_BUFFER_SIZE];
+} fleet_device_t;
+
+/**
+  This function creates the SPDM context of the requester for a device.
+  The connection is created by the asynchronous API.
+
+  @return the SPDM context, or NULL if the context cannot be created.
+**/
+void *
+spdm_fleet_client_init (
+  void
+  );
+
+/**
+  This function provisions the peer certificate and keys to the SPDM context of the requester,
+  according to the algorithms negotiated by the first connection.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_fleet_client_provision (
+  IN     void                 *spdm_context
+  );
+
+/**
+  This function frees the certificates and keys read for the negotiated algorithms,
+  so that they are read again for the next algorithms.
+**/
+void
+spdm_fleet_free_provision_data (
+  void
+  );
+
+#endif
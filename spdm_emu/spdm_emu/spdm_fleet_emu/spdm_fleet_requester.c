@@ -0,0 +1,325 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_fleet_emu.h"
+
+//
+// The certificates and keys are read once, and shared by the SPDM contexts of all devices.
+//
+boolean  m_fleet_provision_data_ready;
+void     *m_fleet_peer_cert_chain;
+uintn    m_fleet_peer_cert_chain_size;
+void     *m_fleet_peer_root_cert;
+uintn    m_fleet_peer_root_cert_size;
+void     *m_fleet_peer_root_cert_hash;
+uintn    m_fleet_peer_root_cert_hash_size;
+void     *m_fleet_peer_pqc_public_key;
+uintn    m_fleet_peer_pqc_public_key_size;
+void     *m_fleet_local_cert_chain;
+uintn    m_fleet_local_cert_chain_size;
+void     *m_fleet_local_pqc_public_key;
+uintn    m_fleet_local_pqc_public_key_size;
+
+/**
+  The device IO is driven by spdm_fleet_emu with the asynchronous API,
+  so the device IO functions of the SPDM context are never called.
+**/
+return_status
+spdm_fleet_client_device_send_message (
+  IN     void                                   *spdm_context,
+  IN     uintn                                  request_size,
+  IN     void                                   *request,
+  IN     uint64                                 timeout
+  )
+{
+  return RETURN_DEVICE_ERROR;
+}
+
+return_status
+spdm_fleet_client_device_receive_message (
+  IN     void                                   *spdm_context,
+  IN OUT uintn                                  *response_size,
+  IN OUT void                                   *response,
+  IN     uint64                                 timeout
+  )
+{
+  return RETURN_DEVICE_ERROR;
+}
+
+/**
+  This function creates the SPDM context of the requester for a device.
+  The connection is created by the asynchronous API.
+
+  @return the SPDM context, or NULL if the context cannot be created.
+**/
+void *
+spdm_fleet_client_init (
+  void
+  )
+{
+  void                         *spdm_context;
+  spdm_data_parameter_t          parameter;
+  uint8                        data8;
+  uint16                       data16;
+  uint32                       data32;
+  boolean                      data_bool;
+  spdm_version_number_t          spdm_version;
+
+  spdm_context = (void *)malloc (spdm_get_context_size());
+  if (spdm_context == NULL) {
+    return NULL;
+  }
+  spdm_init_context (spdm_context);
+  spdm_register_device_io_func (spdm_context, spdm_fleet_client_device_send_message, spdm_fleet_client_device_receive_message);
+  if (m_use_transport_layer == SOCKET_TRANSPORT_TYPE_MCTP) {
+    spdm_register_transport_layer_func (spdm_context, spdm_transport_mctp_encode_message, spdm_transport_mctp_decode_message);
+  } else if (m_use_transport_layer == SOCKET_TRANSPORT_TYPE_PCI_DOE) {
+    spdm_register_transport_layer_func (spdm_context, spdm_transport_pci_doe_encode_message, spdm_transport_pci_doe_decode_message);
+  } else {
+    free (spdm_context);
+    return NULL;
+  }
+
+  if (m_use_version != SPDM_MESSAGE_VERSION_11) {
+    zero_mem (&parameter, sizeof(parameter));
+    parameter.location = SPDM_DATA_LOCATION_LOCAL;
+    spdm_version.major_version = (m_use_version >> 4) & 0xF;
+    spdm_version.minor_version = m_use_version & 0xF;
+    spdm_version.alpha = 0;
+    spdm_version.update_version_number = 0;
+    spdm_set_data (spdm_context, SPDM_DATA_SPDM_VERSION, &parameter, &spdm_version, sizeof(spdm_version));
+  }
+
+  if (m_use_secured_message_version != SPDM_MESSAGE_VERSION_11) {
+    zero_mem (&parameter, sizeof(parameter));
+    if (m_use_secured_message_version != 0) {
+      parameter.location = SPDM_DATA_LOCATION_LOCAL;
+      spdm_version.major_version = (m_use_secured_message_version >> 4) & 0xF;
+      spdm_version.minor_version = m_use_secured_message_version & 0xF;
+      spdm_version.alpha = 0;
+      spdm_version.update_version_number = 0;
+      spdm_set_data (spdm_context, SPDM_DATA_SECURED_MESSAGE_VERSION, &parameter, &spdm_version, sizeof(spdm_version));
+    } else {
+      spdm_set_data (spdm_context, SPDM_DATA_SECURED_MESSAGE_VERSION, &parameter, NULL, 0);
+    }
+  }
+
+  zero_mem (&parameter, sizeof(parameter));
+  parameter.location = SPDM_DATA_LOCATION_LOCAL;
+
+  data8 = 0;
+  spdm_set_data (spdm_context, SPDM_DATA_CAPABILITY_CT_EXPONENT, &parameter, &data8, sizeof(data8));
+  data32 = m_use_requester_capability_flags;
+  if (m_use_capability_flags != 0) {
+    data32 = m_use_capability_flags;
+  }
+  spdm_set_data (spdm_context, SPDM_DATA_CAPABILITY_FLAGS, &parameter, &data32, sizeof(data32));
+
+  data8 = m_support_measurement_spec;
+  spdm_set_data (spdm_context, SPDM_DATA_MEASUREMENT_SPEC, &parameter, &data8, sizeof(data8));
+  data32 = m_support_asym_algo;
+  spdm_set_data (spdm_context, SPDM_DATA_BASE_ASYM_ALGO, &parameter, &data32, sizeof(data32));
+  data32 = m_support_hash_algo;
+  spdm_set_data (spdm_context, SPDM_DATA_BASE_HASH_ALGO, &parameter, &data32, sizeof(data32));
+  data16 = m_support_dhe_algo;
+  spdm_set_data (spdm_context, SPDM_DATA_DHE_NAME_GROUP, &parameter, &data16, sizeof(data16));
+  data16 = m_support_aead_algo;
+  spdm_set_data (spdm_context, SPDM_DATA_AEAD_CIPHER_SUITE, &parameter, &data16, sizeof(data16));
+  data16 = m_support_req_asym_algo;
+  spdm_set_data (spdm_context, SPDM_DATA_REQ_BASE_ASYM_ALG, &parameter, &data16, sizeof(data16));
+  data16 = m_support_key_schedule_algo;
+  spdm_set_data (spdm_context, SPDM_DATA_KEY_SCHEDULE, &parameter, &data16, sizeof(data16));
+
+  spdm_set_data (spdm_context, SPDM_DATA_PQC_PUBLIC_KEY_MODE, &parameter, &m_pqc_pub_key_mode, sizeof(spdm_data_public_key_mode_t));
+  data8 = m_worker_thread_count;
+  spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, &parameter, &data8, sizeof(data8));
+  //
+  // A device is attested again and again, and its certificate chain is verified only once.
+  //
+  data_bool = TRUE;
+  spdm_set_data (spdm_context, SPDM_DATA_PEER_CERT_CHAIN_CACHE, &parameter, &data_bool, sizeof(data_bool));
+
+  spdm_set_data (spdm_context, SPDM_DATA_PQC_SIG_ALGO, &parameter, &m_support_pqc_sig_algo, sizeof(pqc_algo_t));
+  spdm_set_data (spdm_context, SPDM_DATA_PQC_KEM_ALGO, &parameter, &m_support_pqc_kem_algo, sizeof(pqc_algo_t));
+  spdm_set_data (spdm_context, SPDM_DATA_PQC_REQ_SIG_ALGO, &parameter, &m_support_pqc_req_sig_algo, sizeof(pqc_algo_t));
+
+  return spdm_context;
+}
+
+/**
+  This function reads the certificates and keys for the negotiated algorithms.
+
+  @param  spdm_context                  A pointer to the SPDM context with the negotiated algorithms.
+**/
+void
+spdm_fleet_read_provision_data (
+  IN     void                 *spdm_context
+  )
+{
+  spdm_data_parameter_t          parameter;
+  uintn                        data_size;
+  uint32                       data32;
+  uint16                       data16;
+
+  zero_mem (&parameter, sizeof(parameter));
+  parameter.location = SPDM_DATA_LOCATION_CONNECTION;
+
+  data_size = sizeof(data32);
+  spdm_get_data (spdm_context, SPDM_DATA_MEASUREMENT_HASH_ALGO, &parameter, &data32, &data_size);
+  m_use_measurement_hash_algo = data32;
+  data_size = sizeof(data32);
+  spdm_get_data (spdm_context, SPDM_DATA_BASE_ASYM_ALGO, &parameter, &data32, &data_size);
+  m_use_asym_algo = data32;
+  data_size = sizeof(data32);
+  spdm_get_data (spdm_context, SPDM_DATA_BASE_HASH_ALGO, &parameter, &data32, &data_size);
+  m_use_hash_algo = data32;
+  data_size = sizeof(data16);
+  spdm_get_data (spdm_context, SPDM_DATA_DHE_NAME_GROUP, &parameter, &data16, &data_size);
+  m_use_dhe_algo = data16;
+  data_size = sizeof(data16);
+  spdm_get_data (spdm_context, SPDM_DATA_REQ_BASE_ASYM_ALG, &parameter, &data16, &data_size);
+  m_use_req_asym_algo = data16;
+
+  data_size = sizeof(pqc_algo_t);
+  spdm_get_data (spdm_context, SPDM_DATA_PQC_SIG_ALGO, &parameter, &m_use_pqc_sig_algo, &data_size);
+  data_size = sizeof(pqc_algo_t);
+  spdm_get_data (spdm_context, SPDM_DATA_PQC_KEM_ALGO, &parameter, &m_use_pqc_kem_algo, &data_size);
+  data_size = sizeof(pqc_algo_t);
+  spdm_get_data (spdm_context, SPDM_DATA_PQC_REQ_SIG_ALGO, &parameter, &m_use_pqc_req_sig_algo, &data_size);
+
+  if ((m_use_slot_id == 0xFF) || ((m_use_requester_capability_flags & SPDM_GET_CAPABILITIES_REQUEST_FLAGS_PUB_KEY_ID_CAP) != 0)) {
+    if (m_pqc_pub_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
+      read_responder_public_certificate_chain (m_use_hash_algo, m_use_asym_algo, &m_fleet_peer_cert_chain, &m_fleet_peer_cert_chain_size, NULL, NULL);
+    } else {
+      read_hybrid_responder_public_certificate_chain (m_use_hash_algo, m_use_asym_algo, m_use_pqc_sig_algo, &m_fleet_peer_cert_chain, &m_fleet_peer_cert_chain_size, NULL, NULL);
+    }
+  } else {
+    if (m_pqc_pub_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
+      read_responder_root_public_certificate (m_use_hash_algo, m_use_asym_algo, &m_fleet_peer_root_cert, &m_fleet_peer_root_cert_size, &m_fleet_peer_root_cert_hash, &m_fleet_peer_root_cert_hash_size);
+    } else {
+      read_hybrid_responder_root_public_certificate (m_use_hash_algo, m_use_asym_algo, m_use_pqc_sig_algo, &m_fleet_peer_root_cert, &m_fleet_peer_root_cert_size, &m_fleet_peer_root_cert_hash, &m_fleet_peer_root_cert_hash_size);
+    }
+  }
+
+  if (!spdm_pqc_algo_is_zero (m_use_pqc_sig_algo)) {
+    read_responder_pqc_public_key (m_use_pqc_sig_algo, &m_fleet_peer_pqc_public_key, &m_fleet_peer_pqc_public_key_size);
+  }
+
+  if (m_use_mut_auth != 0 || m_use_basic_mut_auth != 0) {
+    if (m_pqc_pub_key_mode == SPDM_DATA_PUBLIC_KEY_MODE_RAW) {
+      read_requester_public_certificate_chain (m_use_hash_algo, m_use_req_asym_algo, &m_fleet_local_cert_chain, &m_fleet_local_cert_chain_size, NULL, NULL);
+    } else {
+      read_hybrid_requester_public_certificate_chain (m_use_hash_algo, m_use_req_asym_algo, m_use_pqc_req_sig_algo, &m_fleet_local_cert_chain, &m_fleet_local_cert_chain_size, NULL, NULL);
+    }
+    if (!spdm_pqc_algo_is_zero (m_use_pqc_req_sig_algo)) {
+      read_requester_pqc_public_key (m_use_pqc_req_sig_algo, &m_fleet_local_pqc_public_key, &m_fleet_local_pqc_public_key_size);
+    }
+  }
+
+  m_fleet_provision_data_ready = TRUE;
+}
+
+/**
+  This function frees the certificates and keys read for the negotiated algorithms,
+  so that they are read again for the next algorithms.
+**/
+void
+spdm_fleet_free_provision_data (
+  void
+  )
+{
+  if (m_fleet_peer_cert_chain != NULL) {
+    free (m_fleet_peer_cert_chain);
+    m_fleet_peer_cert_chain = NULL;
+    m_fleet_peer_cert_chain_size = 0;
+  }
+  //
+  // The hash of the root certificate is in the buffer of the root certificate.
+  //
+  if (m_fleet_peer_root_cert != NULL) {
+    free (m_fleet_peer_root_cert);
+    m_fleet_peer_root_cert = NULL;
+    m_fleet_peer_root_cert_size = 0;
+    m_fleet_peer_root_cert_hash = NULL;
+    m_fleet_peer_root_cert_hash_size = 0;
+  }
+  if (m_fleet_peer_pqc_public_key != NULL) {
+    free (m_fleet_peer_pqc_public_key);
+    m_fleet_peer_pqc_public_key = NULL;
+    m_fleet_peer_pqc_public_key_size = 0;
+  }
+  if (m_fleet_local_cert_chain != NULL) {
+    free (m_fleet_local_cert_chain);
+    m_fleet_local_cert_chain = NULL;
+    m_fleet_local_cert_chain_size = 0;
+  }
+  if (m_fleet_local_pqc_public_key != NULL) {
+    free (m_fleet_local_pqc_public_key);
+    m_fleet_local_pqc_public_key = NULL;
+    m_fleet_local_pqc_public_key_size = 0;
+  }
+  m_fleet_provision_data_ready = FALSE;
+}
+
+/**
+  This function provisions the peer certificate and keys to the SPDM context of the requester,
+  according to the algorithms negotiated by the first connection.
+
+  @param  spdm_context                  A pointer to the SPDM context.
+**/
+void
+spdm_fleet_client_provision (
+  IN     void                 *spdm_context
+  )
+{
+  spdm_data_parameter_t          parameter;
+  uint8                        data8;
+  uint8                        index;
+  return_status                status;
+
+  if (!m_fleet_provision_data_ready) {
+    spdm_fleet_read_provision_data (spdm_context);
+  }
+
+  zero_mem (&parameter, sizeof(parameter));
+  parameter.location = SPDM_DATA_LOCATION_LOCAL;
+  if (m_fleet_peer_root_cert_hash != NULL) {
+    spdm_set_data (spdm_context, SPDM_DATA_PEER_PUBLIC_ROOT_CERT_HASH, &parameter, m_fleet_peer_root_cert_hash, m_fleet_peer_root_cert_hash_size);
+  } else if (m_fleet_peer_cert_chain != NULL) {
+    spdm_set_data (spdm_context, SPDM_DATA_PEER_PUBLIC_CERT_CHAIN, &parameter, m_fleet_peer_cert_chain, m_fleet_peer_cert_chain_size);
+  }
+
+  if (m_fleet_peer_pqc_public_key != NULL) {
+    parameter.additional_data[0] = 0;
+    spdm_set_data (spdm_context, SPDM_DATA_PQC_PEER_PUBLIC_KEY, &parameter, m_fleet_peer_pqc_public_key, m_fleet_peer_pqc_public_key_size);
+  }
+
+  if (m_fleet_local_cert_chain != NULL) {
+    zero_mem (&parameter, sizeof(parameter));
+    parameter.location = SPDM_DATA_LOCATION_LOCAL;
+    data8 = m_use_slot_count;
+    spdm_set_data (spdm_context, SPDM_DATA_LOCAL_SLOT_COUNT, &parameter, &data8, sizeof(data8));
+
+    for (index = 0; index < m_use_slot_count; index++) {
+      parameter.additional_data[0] = index;
+      spdm_set_data (spdm_context, SPDM_DATA_LOCAL_PUBLIC_CERT_CHAIN, &parameter, m_fleet_local_cert_chain, m_fleet_local_cert_chain_size);
+    }
+  }
+
+  if (m_fleet_local_pqc_public_key != NULL) {
+    zero_mem (&parameter, sizeof(parameter));
+    parameter.location = SPDM_DATA_LOCATION_LOCAL;
+    spdm_set_data (spdm_context, SPDM_DATA_PQC_LOCAL_PUBLIC_KEY, &parameter, m_fleet_local_pqc_public_key, m_fleet_local_pqc_public_key_size);
+  }
+
+  status = spdm_set_data (spdm_context, SPDM_DATA_PSK_HINT, NULL, TEST_PSK_HINT_STRING, sizeof(TEST_PSK_HINT_STRING));
+  if (RETURN_ERROR(status)) {
+    printf ("spdm_set_data - %x\n", (uint32)status);
+  }
+}
@@ -201,6 +201,8 @@ spdm_server_init (
   spdm_set_data (spdm_context, SPDM_DATA_KEY_SCHEDULE, &parameter, &data16, sizeof(data16));
 
   spdm_set_data (spdm_context, SPDM_DATA_PQC_PUBLIC_KEY_MODE, &parameter, &m_pqc_pub_key_mode, sizeof(spdm_data_public_key_mode_t));
+  data8 = m_worker_thread_count;
+  spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, &parameter, &data8, sizeof(data8));
 
   spdm_set_data (spdm_context, SPDM_DATA_PQC_SIG_ALGO, &parameter, &m_support_pqc_sig_algo, sizeof(pqc_algo_t));
   spdm_set_data (spdm_context, SPDM_DATA_PQC_KEM_ALGO, &parameter, &m_support_pqc_kem_algo, sizeof(pqc_algo_t));
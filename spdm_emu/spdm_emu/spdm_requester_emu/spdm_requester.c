@@ -189,6 +189,10 @@ spdm_client_init (
   spdm_set_data (spdm_context, SPDM_DATA_KEY_SCHEDULE, &parameter, &data16, sizeof(data16));
 
   spdm_set_data (spdm_context, SPDM_DATA_PQC_PUBLIC_KEY_MODE, &parameter, &m_pqc_pub_key_mode, sizeof(spdm_data_public_key_mode_t));
+  data8 = m_worker_thread_count;
+  spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, &parameter, &data8, sizeof(data8));
+  data8 = m_fragment_window_size;
+  spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, &parameter, &data8, sizeof(data8));
 
   spdm_set_data (spdm_context, SPDM_DATA_PQC_SIG_ALGO, &parameter, &m_support_pqc_sig_algo, sizeof(pqc_algo_t));
   spdm_set_data (spdm_context, SPDM_DATA_PQC_KEM_ALGO, &parameter, &m_support_pqc_kem_algo, sizeof(pqc_algo_t));
@@ -201,6 +205,7 @@ perf_start (PERF_ID_REQUESTER);
 perf_stop (PERF_ID_REQUESTER);
     if (RETURN_ERROR(status)) {
       printf ("spdm_init_connection - 0x%x\n", (uint32)status);
+      spdm_deinit_context (m_spdm_context);
       free (m_spdm_context);
       m_spdm_context = NULL;
       return NULL;
@@ -231,8 +231,10 @@ done:
             );
 
   if (m_spdm_context != NULL) {
+    spdm_deinit_context (m_spdm_context);
     free (m_spdm_context);
   }
+  spdm_clear_signing_key_cache ();
 
   closesocket (platform_socket);
   
@@ -129,6 +129,7 @@ spdm_server_init (
   uint8                        data8;
   uint16                       data16;
   uint32                       data32;
+  boolean                      data_bool;
   spdm_version_number_t          spdm_version;
 
   m_spdm_context = (void *)malloc (spdm_get_context_size());
@@ -143,6 +144,9 @@ spdm_server_init (
   } else if (m_use_transport_layer == SOCKET_TRANSPORT_TYPE_PCI_DOE) {
     spdm_register_transport_layer_func (spdm_context, spdm_transport_pci_doe_encode_message, spdm_transport_pci_doe_decode_message);
   } else {
+    spdm_deinit_context (spdm_context);
+    free (spdm_context);
+    m_spdm_context = NULL;
     return NULL;
   }
 
@@ -203,6 +207,20 @@ spdm_server_init (
   spdm_set_data (spdm_context, SPDM_DATA_KEY_SCHEDULE, &parameter, &data16, sizeof(data16));
 
   spdm_set_data (spdm_context, SPDM_DATA_PQC_PUBLIC_KEY_MODE, &parameter, &m_pqc_pub_key_mode, sizeof(spdm_data_public_key_mode_t));
+  data8 = m_worker_thread_count;
+  spdm_set_data (spdm_context, SPDM_DATA_WORKER_THREAD_COUNT, &parameter, &data8, sizeof(data8));
+  data8 = m_fragment_window_size;
+  spdm_set_data (spdm_context, SPDM_DATA_FRAGMENT_WINDOW_SIZE, &parameter, &data8, sizeof(data8));
+  //
+  // The connections share one event loop. A signature must not block the other connections.
+  //
+  data_bool = (boolean)((m_max_connection_count != 0) && (m_worker_thread_count != 0));
+  spdm_set_data (spdm_context, SPDM_DATA_DEFERRED_RESPONSE, &parameter, &data_bool, sizeof(data_bool));
+  //
+  // The measurement of the emulated device is not changed, and the generation is always 0.
+  //
+  data_bool = TRUE;
+  spdm_set_data (spdm_context, SPDM_DATA_MEASUREMENT_CACHE, &parameter, &data_bool, sizeof(data_bool));
 
   spdm_set_data (spdm_context, SPDM_DATA_PQC_SIG_ALGO, &parameter, &m_support_pqc_sig_algo, sizeof(pqc_algo_t));
   spdm_set_data (spdm_context, SPDM_DATA_PQC_KEM_ALGO, &parameter, &m_support_pqc_kem_algo, sizeof(pqc_algo_t));
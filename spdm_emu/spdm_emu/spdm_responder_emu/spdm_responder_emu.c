@@ -22,6 +22,11 @@ spdm_server_init (
   void
   );
 
+boolean
+platform_server_epoll_routine (
+  IN  uint16           port_number
+  );
+
 boolean
 create_socket(
   IN  uint16              port_number,
@@ -70,7 +75,10 @@ create_socket(
     return FALSE;
   }
 
-  res = listen(*listen_socket, 3);
+  //
+  // The multi-connection responder may be connected by many requesters at the same time.
+  //
+  res = listen(*listen_socket, (m_max_connection_count != 0) ? SOMAXCONN : 3);
   if(res == SOCKET_ERROR) {
     printf("Listen error.  Error is 0x%x\n",
 #ifdef _MSC_VER
@@ -312,14 +320,30 @@ int main (
 
   process_args ("spdm_responder_emu", argc, argv);
 
-  m_spdm_context = spdm_server_init ();
-  if (m_spdm_context == NULL) {
-    return 0;
+#ifdef _MSC_VER
+  if (m_max_connection_count != 0) {
+    printf ("--max_conn is not supported on this OS\n");
+    m_max_connection_count = 0;
   }
+#endif
+
+  if (m_max_connection_count != 0) {
+    //
+    // Each connection has its own SPDM context.
+    //
+    platform_server_epoll_routine (DEFAULT_SPDM_PLATFORM_PORT);
+  } else {
+    m_spdm_context = spdm_server_init ();
+    if (m_spdm_context == NULL) {
+      return 0;
+    }
 
-  platform_server_routine (DEFAULT_SPDM_PLATFORM_PORT);
+    platform_server_routine (DEFAULT_SPDM_PLATFORM_PORT);
 
-  free (m_spdm_context);
+    spdm_deinit_context (m_spdm_context);
+    free (m_spdm_context);
+  }
+  spdm_clear_signing_key_cache ();
 
   printf ("Server stopped\n");
 
@@ -0,0 +1,725 @@
+/**
+@file
+UEFI OS based application.
+
+Copyright (c) 2020, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "spdm_responder_emu.h"
+
+#ifndef _MSC_VER
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+
+#define SPDM_CONNECTION_BUFFER_SIZE  (sizeof(socket_buffer_header_t) + MAX_SPDM_MESSAGE_BUFFER_SIZE)
+#define MAX_SPDM_EPOLL_EVENT_COUNT   64
+
+//
+// One requester connection of the multi-connection responder.
+//
+// The socket is non-blocking. The received data is framed with socket_buffer_header_t in
+// receive_buffer, and one complete frame is dispatched at a time. The response frame is queued
+// in send_buffer and the next frame is not dispatched until the response is sent.
+//
+typedef struct {
+  SOCKET   socket;
+  void     *spdm_context;
+  uint32   events;
+  boolean  closing;
+  //
+  // The frame being dispatched. It is consumed by spdm_connection_receive_message.
+  //
+  boolean  frame_ready;
+  uint32   command;
+  uint8    *payload;
+  uintn    payload_size;
+  //
+  // The received data. It may hold a partial frame.
+  //
+  uintn    receive_size;
+  uint8    receive_buffer[SPDM_CONNECTION_BUFFER_SIZE];
+  //
+  // The data to be sent.
+  //
+  uintn    send_offset;
+  uintn    send_size;
+  uint8    send_buffer[SPDM_CONNECTION_BUFFER_SIZE];
+} spdm_connection_t;
+
+extern doe_discovery_response_mine_t   m_doe_response;
+
+int                m_epoll_fd = -1;
+SOCKET             m_epoll_listen_socket = INVALID_SOCKET;
+uint32             m_connection_count;
+boolean            m_epoll_shutdown;
+spdm_connection_t  *m_current_connection;
+
+extern void        *m_spdm_context;
+
+void *
+spdm_server_init (
+  void
+  );
+
+boolean
+create_socket(
+  IN  uint16              port_number,
+  IN  SOCKET              *listen_socket
+  );
+
+/**
+  Append a NORMAL message of a connection to the PCAP file.
+
+  @param  data                          The message.
+  @param  size                          The size in bytes of the message.
+**/
+void
+spdm_connection_append_pcap (
+  IN uint8            *data,
+  IN uintn            size
+  )
+{
+  mctp_header_t  mctp_header;
+
+  if (m_use_transport_layer == SOCKET_TRANSPORT_TYPE_MCTP) {
+    //
+    // Append mctp_header_t for PCAP
+    //
+    mctp_header.header_version = 0;
+    mctp_header.destination_id = 0;
+    mctp_header.source_id = 0;
+    mctp_header.message_tag = 0xC0;
+    append_pcap_packet_data (&mctp_header, sizeof(mctp_header), data, size);
+  } else {
+    append_pcap_packet_data (NULL, 0, data, size);
+  }
+}
+
+/**
+  Queue one frame to the send buffer of a connection.
+
+  @param  connection                    The connection.
+  @param  command                       The platform command.
+  @param  send_buffer                   The payload.
+  @param  bytes_to_send                 The size in bytes of the payload.
+
+  @retval TRUE  The frame is queued.
+  @retval FALSE The send buffer is full.
+**/
+boolean
+spdm_connection_queue_frame (
+  IN spdm_connection_t  *connection,
+  IN uint32             command,
+  IN uint8              *send_buffer,
+  IN uintn              bytes_to_send
+  )
+{
+  socket_buffer_header_t *socket_buffer_header;
+
+  if (connection->send_size + sizeof(socket_buffer_header_t) + bytes_to_send > sizeof(connection->send_buffer)) {
+    printf ("Connection %d send buffer is full\n", connection->socket);
+    return FALSE;
+  }
+
+  socket_buffer_header = (void *)(connection->send_buffer + connection->send_size);
+  socket_buffer_header->command = htonl(command);
+  socket_buffer_header->transport_type = htonl(m_use_transport_layer);
+  socket_buffer_header->payload_size = htonl((uint32)bytes_to_send);
+  if (bytes_to_send != 0) {
+    copy_mem ((void *)(socket_buffer_header + 1), send_buffer, bytes_to_send);
+  }
+  connection->send_size += sizeof(socket_buffer_header_t) + bytes_to_send;
+
+  if (command == SOCKET_SPDM_COMMAND_NORMAL) {
+    spdm_connection_append_pcap (send_buffer, bytes_to_send);
+  }
+  return TRUE;
+}
+
+return_status
+spdm_connection_send_message (
+  IN     void                                   *spdm_context,
+  IN     uintn                                  request_size,
+  IN     void                                   *request,
+  IN     uint64                                 timeout
+  )
+{
+  spdm_connection_t  *connection;
+
+  connection = m_current_connection;
+  ASSERT ((connection != NULL) && (connection->spdm_context == spdm_context));
+
+  if (!spdm_connection_queue_frame (connection, SOCKET_SPDM_COMMAND_NORMAL, request, request_size)) {
+    return RETURN_DEVICE_ERROR;
+  }
+  return RETURN_SUCCESS;
+}
+
+return_status
+spdm_connection_receive_message (
+  IN     void                                   *spdm_context,
+  IN OUT uintn                                  *response_size,
+  IN OUT void                                   *response,
+  IN     uint64                                 timeout
+  )
+{
+  spdm_connection_t  *connection;
+
+  connection = m_current_connection;
+  ASSERT ((connection != NULL) && (connection->spdm_context == spdm_context));
+
+  //
+  // The event loop dispatches a message only when a complete frame is received.
+  //
+  if (!connection->frame_ready) {
+    return RETURN_DEVICE_ERROR;
+  }
+  if (connection->command != SOCKET_SPDM_COMMAND_NORMAL) {
+    connection->frame_ready = FALSE;
+    return RETURN_UNSUPPORTED;
+  }
+  if (*response_size < connection->payload_size) {
+    *response_size = connection->payload_size;
+    return RETURN_BUFFER_TOO_SMALL;
+  }
+  connection->frame_ready = FALSE;
+  *response_size = connection->payload_size;
+  copy_mem (response, connection->payload, connection->payload_size);
+
+  spdm_connection_append_pcap (connection->payload, connection->payload_size);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Update the epoll events of a connection.
+
+  The connection does not read more data while a response is pending,
+  so that a slow requester cannot make the responder queue responses.
+
+  @param  connection                    The connection.
+
+  @retval TRUE  The events are updated.
+  @retval FALSE The events cannot be updated.
+**/
+boolean
+spdm_connection_update_events (
+  IN spdm_connection_t  *connection
+  )
+{
+  struct epoll_event  event;
+  uint32              events;
+
+  if (connection->send_offset < connection->send_size) {
+    events = EPOLLOUT;
+  } else {
+    events = EPOLLIN;
+  }
+  if (events == connection->events) {
+    return TRUE;
+  }
+
+  zero_mem (&event, sizeof(event));
+  event.events = events;
+  event.data.ptr = connection;
+  if (epoll_ctl (m_epoll_fd, EPOLL_CTL_MOD, connection->socket, &event) != 0) {
+    printf ("epoll_ctl error - 0x%x\n", errno);
+    return FALSE;
+  }
+  connection->events = events;
+  return TRUE;
+}
+
+/**
+  Send the queued data of a connection until the socket would block.
+
+  @param  connection                    The connection.
+
+  @retval TRUE  The data is sent, or the socket would block.
+  @retval FALSE The connection is broken.
+**/
+boolean
+spdm_connection_flush (
+  IN spdm_connection_t  *connection
+  )
+{
+  ssize_t  result;
+
+  while (connection->send_offset < connection->send_size) {
+    result = send (connection->socket,
+                   (char8 *)(connection->send_buffer + connection->send_offset),
+                   connection->send_size - connection->send_offset,
+                   MSG_NOSIGNAL);
+    if (result == -1) {
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+        return TRUE;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      printf ("Send error - 0x%x\n", errno);
+      return FALSE;
+    }
+    connection->send_offset += result;
+  }
+  connection->send_offset = 0;
+  connection->send_size = 0;
+  return TRUE;
+}
+
+/**
+  Dispatch one received frame of a connection.
+
+  @param  connection                    The connection.
+
+  @retval TRUE  The frame is processed.
+  @retval FALSE The connection must be closed.
+**/
+boolean
+spdm_connection_dispatch_frame (
+  IN spdm_connection_t  *connection
+  )
+{
+  return_status                 status;
+  doe_discovery_request_mine_t  *doe_request;
+  doe_discovery_response_mine_t doe_response;
+  boolean                       result;
+
+  //
+  // m_spdm_context is the context of the connection being dispatched,
+  // so that the common responder callbacks work in the same way as the single connection mode.
+  //
+  m_spdm_context = connection->spdm_context;
+  m_current_connection = connection;
+  connection->frame_ready = TRUE;
+  status = spdm_responder_dispatch_message (connection->spdm_context);
+  connection->frame_ready = FALSE;
+  m_current_connection = NULL;
+
+  if (status == RETURN_DEVICE_ERROR) {
+    printf ("Connection %d Critical Error - CLOSE\n", connection->socket);
+    return FALSE;
+  }
+  if (status != RETURN_UNSUPPORTED) {
+    return TRUE;
+  }
+
+  switch (connection->command) {
+  case SOCKET_SPDM_COMMAND_TEST:
+    result = spdm_connection_queue_frame (
+               connection,
+               SOCKET_SPDM_COMMAND_TEST,
+               (uint8 *)"Server Hello!",
+               sizeof("Server Hello!")
+               );
+    break;
+
+  case SOCKET_SPDM_COMMAND_OOB_ENCAP_KEY_UPDATE:
+    spdm_init_key_update_encap_state (connection->spdm_context);
+    result = spdm_connection_queue_frame (connection, SOCKET_SPDM_COMMAND_OOB_ENCAP_KEY_UPDATE, NULL, 0);
+    break;
+
+  case SOCKET_SPDM_COMMAND_SHUTDOWN:
+    //
+    // Stop accepting new connections. The server stops when all connections are closed.
+    //
+    result = spdm_connection_queue_frame (connection, SOCKET_SPDM_COMMAND_SHUTDOWN, NULL, 0);
+    connection->closing = TRUE;
+    m_epoll_shutdown = TRUE;
+    break;
+
+  case SOCKET_SPDM_COMMAND_CONTINUE:
+    result = spdm_connection_queue_frame (connection, SOCKET_SPDM_COMMAND_CONTINUE, NULL, 0);
+    connection->closing = TRUE;
+    break;
+
+  case SOCKET_SPDM_COMMAND_NORMAL:
+    if (m_use_transport_layer != SOCKET_TRANSPORT_TYPE_PCI_DOE) {
+      // unknown message
+      return TRUE;
+    }
+    doe_request = (void *)connection->payload;
+    if ((connection->payload_size != sizeof(doe_discovery_request_mine_t)) ||
+        (doe_request->doe_header.vendor_id != PCI_DOE_VENDOR_ID_PCISIG) ||
+        (doe_request->doe_header.data_object_type != PCI_DOE_DATA_OBJECT_TYPE_DOE_DISCOVERY)) {
+      // unknown message
+      return TRUE;
+    }
+
+    copy_mem (&doe_response, &m_doe_response, sizeof(doe_response));
+    switch (doe_request->doe_discovery_request.index) {
+    case 0:
+      doe_response.doe_discovery_response.data_object_type = PCI_DOE_DATA_OBJECT_TYPE_DOE_DISCOVERY;
+      doe_response.doe_discovery_response.next_index = 1;
+      break;
+    case 1:
+      doe_response.doe_discovery_response.data_object_type = PCI_DOE_DATA_OBJECT_TYPE_SPDM;
+      doe_response.doe_discovery_response.next_index = 2;
+      break;
+    case 2:
+    default:
+      doe_response.doe_discovery_response.data_object_type = PCI_DOE_DATA_OBJECT_TYPE_SECURED_SPDM;
+      doe_response.doe_discovery_response.next_index = 0;
+      break;
+    }
+    result = spdm_connection_queue_frame (
+               connection,
+               SOCKET_SPDM_COMMAND_NORMAL,
+               (uint8 *)&doe_response,
+               sizeof(doe_response)
+               );
+    break;
+
+  default:
+    printf ("Unrecognized platform interface command %x\n", connection->command);
+    result = spdm_connection_queue_frame (connection, SOCKET_SPDM_COMMAND_UNKOWN, NULL, 0);
+    break;
+  }
+
+  return result;
+}
+
+/**
+  Dispatch the next complete frame in the receive buffer of a connection.
+
+  @param  connection                    The connection.
+  @param  dispatched                    TRUE if a frame is dispatched.
+
+  @retval TRUE  No error.
+  @retval FALSE The connection must be closed.
+**/
+boolean
+spdm_connection_dispatch_next_frame (
+  IN  spdm_connection_t  *connection,
+  OUT boolean            *dispatched
+  )
+{
+  socket_buffer_header_t  *socket_buffer_header;
+  uintn                   frame_size;
+  boolean                 result;
+
+  *dispatched = FALSE;
+  if (connection->receive_size < sizeof(socket_buffer_header_t)) {
+    return TRUE;
+  }
+
+  socket_buffer_header = (void *)connection->receive_buffer;
+  if (ntohl(socket_buffer_header->transport_type) != m_use_transport_layer) {
+    printf ("transport_type mismatch\n");
+    return FALSE;
+  }
+  connection->payload_size = ntohl(socket_buffer_header->payload_size);
+  if (connection->payload_size > MAX_SPDM_MESSAGE_BUFFER_SIZE) {
+    printf ("buffer too small (0x%x). Expected - 0x%x\n", MAX_SPDM_MESSAGE_BUFFER_SIZE, (uint32)connection->payload_size);
+    return FALSE;
+  }
+  frame_size = sizeof(socket_buffer_header_t) + connection->payload_size;
+  if (connection->receive_size < frame_size) {
+    return TRUE;
+  }
+  connection->command = ntohl(socket_buffer_header->command);
+  connection->payload = (uint8 *)(socket_buffer_header + 1);
+
+  result = spdm_connection_dispatch_frame (connection);
+  *dispatched = TRUE;
+
+  //
+  // Keep the data of the next frame, if the requester has already sent it.
+  //
+  connection->receive_size -= frame_size;
+  if (connection->receive_size != 0) {
+    copy_mem (connection->receive_buffer, connection->receive_buffer + frame_size, connection->receive_size);
+  }
+  return result;
+}
+
+/**
+  Process the events of a connection.
+
+  @param  connection                    The connection.
+  @param  readable                      TRUE if the socket is readable.
+
+  @retval TRUE  The connection is still open.
+  @retval FALSE The connection must be closed.
+**/
+boolean
+spdm_connection_process (
+  IN spdm_connection_t  *connection,
+  IN boolean            readable
+  )
+{
+  ssize_t  result;
+  boolean  dispatched;
+
+  if (readable && (connection->receive_size < sizeof(connection->receive_buffer))) {
+    result = recv (connection->socket,
+                   (char8 *)(connection->receive_buffer + connection->receive_size),
+                   sizeof(connection->receive_buffer) - connection->receive_size,
+                   0);
+    if (result == 0) {
+      return FALSE;
+    }
+    if (result == -1) {
+      if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+        printf ("Receive error - 0x%x\n", errno);
+        return FALSE;
+      }
+    } else {
+      connection->receive_size += result;
+    }
+  }
+
+  while (TRUE) {
+    if (!spdm_connection_flush (connection)) {
+      return FALSE;
+    }
+    if (connection->send_size != 0) {
+      break;
+    }
+    if (connection->closing) {
+      return FALSE;
+    }
+    if (!spdm_connection_dispatch_next_frame (connection, &dispatched)) {
+      //
+      // Try to send the last response before the connection is closed.
+      //
+      spdm_connection_flush (connection);
+      return FALSE;
+    }
+    if (!dispatched) {
+      break;
+    }
+  }
+
+  return spdm_connection_update_events (connection);
+}
+
+/**
+  Enable or disable the listen socket in the epoll set.
+
+  @param  enable                        TRUE to accept new connections.
+**/
+void
+spdm_epoll_enable_listen (
+  IN boolean  enable
+  )
+{
+  struct epoll_event  event;
+
+  if (m_epoll_listen_socket == INVALID_SOCKET) {
+    return ;
+  }
+  zero_mem (&event, sizeof(event));
+  event.events = enable ? EPOLLIN : 0;
+  event.data.ptr = NULL;
+  epoll_ctl (m_epoll_fd, EPOLL_CTL_MOD, m_epoll_listen_socket, &event);
+}
+
+/**
+  Close a connection and free its SPDM context.
+
+  @param  connection                    The connection.
+**/
+void
+spdm_connection_close (
+  IN spdm_connection_t  *connection
+  )
+{
+  epoll_ctl (m_epoll_fd, EPOLL_CTL_DEL, connection->socket, NULL);
+  closesocket (connection->socket);
+  printf ("Client %d closed\n", connection->socket);
+
+  if (m_spdm_context == connection->spdm_context) {
+    m_spdm_context = NULL;
+  }
+  spdm_deinit_context (connection->spdm_context);
+  free (connection->spdm_context);
+  free (connection);
+
+  ASSERT (m_connection_count > 0);
+  if ((m_connection_count == m_max_connection_count) && !m_epoll_shutdown) {
+    spdm_epoll_enable_listen (TRUE);
+  }
+  m_connection_count--;
+}
+
+/**
+  Accept the pending connections, until the max connection count is reached.
+**/
+void
+spdm_epoll_accept (
+  void
+  )
+{
+  SOCKET              client_socket;
+  struct sockaddr_in  peer_address;
+  socklen_t           length;
+  spdm_connection_t   *connection;
+  struct epoll_event  event;
+  int                 flag;
+
+  while (m_connection_count < m_max_connection_count) {
+    length = sizeof(peer_address);
+    client_socket = accept (m_epoll_listen_socket, (struct sockaddr*) &peer_address, &length);
+    if (client_socket == INVALID_SOCKET) {
+      if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+        printf ("Accept error.  Error is 0x%x\n", errno);
+      }
+      return ;
+    }
+
+    flag = 1;
+    setsockopt (client_socket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    if (fcntl (client_socket, F_SETFL, fcntl (client_socket, F_GETFL, 0) | O_NONBLOCK) != 0) {
+      printf ("fcntl error - 0x%x\n", errno);
+      closesocket (client_socket);
+      continue;
+    }
+
+    connection = (void *)malloc (sizeof(spdm_connection_t));
+    if (connection == NULL) {
+      closesocket (client_socket);
+      continue;
+    }
+    zero_mem (connection, sizeof(spdm_connection_t));
+    connection->socket = client_socket;
+    connection->spdm_context = spdm_server_init ();
+    if (connection->spdm_context == NULL) {
+      free (connection);
+      closesocket (client_socket);
+      continue;
+    }
+    spdm_register_device_io_func (connection->spdm_context, spdm_connection_send_message, spdm_connection_receive_message);
+
+    zero_mem (&event, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = connection;
+    if (epoll_ctl (m_epoll_fd, EPOLL_CTL_ADD, client_socket, &event) != 0) {
+      printf ("epoll_ctl error - 0x%x\n", errno);
+      m_spdm_context = NULL;
+      spdm_deinit_context (connection->spdm_context);
+      free (connection->spdm_context);
+      free (connection);
+      closesocket (client_socket);
+      continue;
+    }
+    connection->events = EPOLLIN;
+    m_connection_count++;
+    printf ("Client %d accepted (%d/%d)\n", client_socket, m_connection_count, m_max_connection_count);
+  }
+
+  //
+  // Leave the pending connections in the listen backlog until a connection is closed.
+  //
+  if (m_connection_count >= m_max_connection_count) {
+    spdm_epoll_enable_listen (FALSE);
+  }
+}
+
+/**
+  The multi-connection responder.
+
+  Each requester connection has its own SPDM context. The requests of all connections are
+  dispatched by one epoll event loop.
+  The server stops accepting new connections after a SHUTDOWN command, and stops when all
+  connections are closed.
+
+  @param  port_number                   The TCP port to listen.
+
+  @retval TRUE  The server is stopped.
+  @retval FALSE The server cannot be started.
+**/
+boolean
+platform_server_epoll_routine (
+  IN  uint16           port_number
+  )
+{
+  struct epoll_event  event;
+  struct epoll_event  events[MAX_SPDM_EPOLL_EVENT_COUNT];
+  spdm_connection_t   *connection;
+  int                 event_count;
+  int                 index;
+  boolean             readable;
+
+  if (!create_socket (port_number, &m_epoll_listen_socket)) {
+    printf ("Create platform service socket fail\n");
+    return FALSE;
+  }
+  if (fcntl (m_epoll_listen_socket, F_SETFL, fcntl (m_epoll_listen_socket, F_GETFL, 0) | O_NONBLOCK) != 0) {
+    printf ("fcntl error - 0x%x\n", errno);
+    closesocket (m_epoll_listen_socket);
+    return FALSE;
+  }
+
+  m_epoll_fd = epoll_create1 (0);
+  if (m_epoll_fd == -1) {
+    printf ("epoll_create1 error - 0x%x\n", errno);
+    closesocket (m_epoll_listen_socket);
+    return FALSE;
+  }
+  zero_mem (&event, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.ptr = NULL;
+  if (epoll_ctl (m_epoll_fd, EPOLL_CTL_ADD, m_epoll_listen_socket, &event) != 0) {
+    printf ("epoll_ctl error - 0x%x\n", errno);
+    close (m_epoll_fd);
+    closesocket (m_epoll_listen_socket);
+    return FALSE;
+  }
+
+  printf ("Platform server listening on port %d (max connections %d)\n", port_number, m_max_connection_count);
+
+  m_connection_count = 0;
+  m_epoll_shutdown = FALSE;
+  while (!m_epoll_shutdown || (m_connection_count != 0)) {
+    event_count = epoll_wait (m_epoll_fd, events, MAX_SPDM_EPOLL_EVENT_COUNT, -1);
+    if (event_count == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      printf ("epoll_wait error - 0x%x\n", errno);
+      break;
+    }
+
+    for (index = 0; index < event_count; index++) {
+      connection = events[index].data.ptr;
+      if (connection == NULL) {
+        if (!m_epoll_shutdown) {
+          spdm_epoll_accept ();
+        }
+        continue;
+      }
+      if ((events[index].events & (EPOLLERR | EPOLLHUP)) != 0) {
+        //
+        // Read the data still in the socket. recv() reports the error.
+        //
+        readable = TRUE;
+      } else {
+        readable = (boolean)((events[index].events & EPOLLIN) != 0);
+      }
+      if (!spdm_connection_process (connection, readable)) {
+        spdm_connection_close (connection);
+      }
+    }
+
+    if (m_epoll_shutdown && (m_epoll_listen_socket != INVALID_SOCKET)) {
+      epoll_ctl (m_epoll_fd, EPOLL_CTL_DEL, m_epoll_listen_socket, NULL);
+      closesocket (m_epoll_listen_socket);
+      m_epoll_listen_socket = INVALID_SOCKET;
+    }
+  }
+
+  close (m_epoll_fd);
+  m_epoll_fd = -1;
+  if (m_epoll_listen_socket != INVALID_SOCKET) {
+    closesocket (m_epoll_listen_socket);
+    m_epoll_listen_socket = INVALID_SOCKET;
+  }
+  return TRUE;
+}
+
+#endif
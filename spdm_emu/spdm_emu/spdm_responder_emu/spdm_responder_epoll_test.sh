@@ -0,0 +1,91 @@
+#!/bin/bash
+#
+# Test the multi-connection (--max_conn) mode of spdm_responder_emu.
+#
+# Run it in the bin directory of the build, where the emulators and the sample keys are:
+#   spdm_responder_epoll_test.sh [<connection count>] [<worker thread count>]
+#
+# 1) <connection count> spdm_requester_emu run concurrently against one spdm_responder_emu,
+#    each with its own connection and SPDM context.
+# 2) spdm_fleet_emu attests <connection count> devices over the sockets of the same responder.
+# 3) The last spdm_requester_emu asks the responder to stop.
+# The test fails if any requester reports an error, or if the responder does not stop.
+#
+
+CONN_COUNT=${1:-4}
+WORKER_COUNT=${2:-0}
+TIMEOUT=120
+RESULT=0
+
+if [ ! -x ./spdm_responder_emu ] || [ ! -x ./spdm_requester_emu ]; then
+  echo "spdm_responder_emu and spdm_requester_emu are not found in $(pwd)"
+  exit 1
+fi
+
+check_requester_log () {
+  if ! grep -q "^Client stopped" "$1"; then
+    echo "FAIL: $1 - requester is not stopped"
+    return 1
+  fi
+  if grep -E -q "^(do_|spdm_)[a-z_ -]* - (0x)?[0-9a-f]+$" "$1"; then
+    echo "FAIL: $1 - requester reports an error"
+    grep -E "^(do_|spdm_)[a-z_ -]* - (0x)?[0-9a-f]+$" "$1"
+    return 1
+  fi
+  return 0
+}
+
+./spdm_responder_emu --max_conn "$CONN_COUNT" --worker_thread "$WORKER_COUNT" > epoll_responder.log 2>&1 &
+RESPONDER_PID=$!
+sleep 1
+
+#
+# The requesters keep the responder running with CONTINUE.
+#
+REQUESTER_PIDS=""
+for index in $(seq 1 "$CONN_COUNT"); do
+  timeout $TIMEOUT ./spdm_requester_emu --exe_mode CONTINUE > "epoll_requester_$index.log" 2>&1 &
+  REQUESTER_PIDS="$REQUESTER_PIDS $!"
+done
+for pid in $REQUESTER_PIDS; do
+  wait "$pid"
+done
+for index in $(seq 1 "$CONN_COUNT"); do
+  check_requester_log "epoll_requester_$index.log" || RESULT=1
+done
+
+if [ -x ./spdm_fleet_emu ]; then
+  timeout $TIMEOUT ./spdm_fleet_emu --fleet_io SOCKET --fleet_dev "$CONN_COUNT" --fleet_round 2 --exe_mode CONTINUE > epoll_fleet.log 2>&1
+  #
+  # One line for each algorithm combination:
+  # | Security Level | Configuration | Devices | Attestations | Failures | ...
+  #
+  FAILURES=$(grep "^|" epoll_fleet.log | awk -F'|' '{gsub(/ /, "", $6); sum += $6; count++} END {if (count > 0) print sum}')
+  if [ "$FAILURES" != "0" ]; then
+    echo "FAIL: epoll_fleet.log - failures: ${FAILURES:-unknown}"
+    RESULT=1
+  fi
+fi
+
+timeout $TIMEOUT ./spdm_requester_emu --exe_mode SHUTDOWN > epoll_requester_shutdown.log 2>&1
+check_requester_log epoll_requester_shutdown.log || RESULT=1
+
+for second in $(seq 1 $TIMEOUT); do
+  if ! kill -0 $RESPONDER_PID 2> /dev/null; then
+    break
+  fi
+  sleep 1
+done
+if kill -0 $RESPONDER_PID 2> /dev/null; then
+  echo "FAIL: epoll_responder.log - responder is not stopped"
+  kill $RESPONDER_PID
+  RESULT=1
+elif ! grep -q "^Server stopped" epoll_responder.log; then
+  echo "FAIL: epoll_responder.log - responder is not stopped normally"
+  RESULT=1
+fi
+
+if [ $RESULT -eq 0 ]; then
+  echo "PASS: $CONN_COUNT connections, $WORKER_COUNT worker threads"
+fi
+exit $RESULT